@@ -0,0 +1,24 @@
+set(CPACK_PACKAGE_NAME "MADARA")
+set(CPACK_PACKAGE_VENDOR "madara.ai")
+set(CPACK_PACKAGE_DESCRIPTION_SUMMARY "A distributed operating system and knowledge sharing middleware for robotics")
+set(CPACK_PACKAGE_INSTALL_DIRECTORY "madara")
+set(CPACK_RESOURCE_FILE_LICENSE "/root/repo/LICENSE.txt")
+set(CPACK_RESOURCE_FILE_README "/root/repo/README.md")
+set(CPACK_PACKAGE_DESCRIPTION_FILE "/root/repo/README.md")
+set(CPACK_PACKAGE_MAINTAINER "James Edmondson <jedmondson@gmail.com>")
+set(CPACK_PACKAGE_CONTACT "James Edmondson <jedmondson@gmail.com>")
+
+set(CPACK_DEBIAN_PACKAGE_ARCHITECTURE "")
+set(CPACK_DEBIAN_PACKAGE_DEPENDS "libboost-all-dev")
+set(CPACK_DEBIAN_PACKAGE_SECTION "devel")
+set(CPACK_DEBIAN_PACKAGE_PRIORITY "optional")
+set(CPACK_DEBIAN_PACKAGE_SHLIBDEPS ON)
+set(CPACK_DEBIAN_PACKAGE_DESCRIPTION "A distributed operating system and knowledge sharing middleware for robotics")
+
+set(CPACK_RPM_PACKAGE_ARCHITECTURE "")
+set(CPACK_RPM_PACKAGE_REQUIRES "libboost-all-dev")
+set(CPACK_RPM_PACKAGE_DESCRIPTION "A distributed operating system and knowledge sharing middleware for robotics")
+
+
+set(CPACK_PACKAGE_FILE_NAME "madara-3.4.2")
+set(CPACK_SOURCE_PACKAGE_FILE_NAME "madara-3.4.2")
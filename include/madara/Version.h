@@ -0,0 +1 @@
+std::string version ("3.4.2 (783c35f4889a807a5eed11d3e9ba7e68cf9be600)");
@@ -20,6 +20,35 @@ madara::expression::CompositeArrayReference::CompositeArrayReference(
   VariableExpander expander;
   ref_ = expander.expand(key, "CompositeArrayReference", context, logger_,
       key_expansion_necessary_, splitters_, tokens_, pivot_list_);
+
+  if (key_expansion_necessary_)
+  {
+    expansion_.init(key);
+  }
+}
+
+madara::knowledge::KnowledgeRecord
+madara::expression::CompositeArrayReference::get_expanded(void) const
+{
+  // repeated evaluations with the same index values skip the expansion
+  knowledge::VariableReference ref = expansion_.resolve(context_, false);
+
+  if (ref.is_valid())
+    return context_.get(ref);
+  else
+    return context_.get(expand_key());
+}
+
+madara::knowledge::VariableReference
+madara::expression::CompositeArrayReference::expanded_ref(
+    const madara::knowledge::KnowledgeReferenceSettings& settings) const
+{
+  knowledge::VariableReference ref = expansion_.resolve(context_, true);
+
+  if (!ref.is_valid())
+    ref = context_.get_ref(expand_key(), settings);
+
+  return ref;
 }
 
 std::string madara::expression::CompositeArrayReference::expand_key(void) const
@@ -77,7 +106,7 @@ madara::expression::CompositeArrayReference::item() const
   }
   else
   {
-    return context_.get(expand_key()).retrieve_index(index);
+    return get_expanded().retrieve_index(index);
   }
 }
 
@@ -127,7 +156,7 @@ madara::expression::CompositeArrayReference::prune(bool& can_change)
   if (ref_.is_valid())
     return *ref_.get_record_unsafe();
   else
-    return context_.get(expand_key());
+    return get_expanded();
 }
 
 /// Evaluates the node and its children. This does not prune any of
@@ -155,7 +184,7 @@ madara::expression::CompositeArrayReference::evaluate(
   }
   else
   {
-    auto ret = context_.get(expand_key()).retrieve_index(index);
+    auto ret = get_expanded().retrieve_index(index);
 
     if (settings.exception_on_unitialized && !ret.exists ())
     {
@@ -204,14 +233,16 @@ madara::expression::CompositeArrayReference::dec(
   }
   else
   {
+    knowledge::VariableReference ref = expanded_ref(settings);
+
     knowledge::KnowledgeRecord result(
-        context_.retrieve_index(expand_key(), index, settings) -
+        context_.retrieve_index(ref, index, settings) -
         knowledge::KnowledgeRecord(1));
 
     if (result.type() == knowledge::KnowledgeRecord::INTEGER)
-      context_.set_index(expand_key(), index, result.to_integer(), settings);
+      context_.set_index(ref, index, result.to_integer(), settings);
     else if (result.type() == knowledge::KnowledgeRecord::DOUBLE)
-      context_.set_index(expand_key(), index, result.to_double(), settings);
+      context_.set_index(ref, index, result.to_double(), settings);
 
     return result;
   }
@@ -246,14 +277,16 @@ madara::expression::CompositeArrayReference::inc(
   }
   else
   {
+    knowledge::VariableReference ref = expanded_ref(settings);
+
     knowledge::KnowledgeRecord result =
-        context_.retrieve_index(expand_key(), index, settings) +
+        context_.retrieve_index(ref, index, settings) +
         knowledge::KnowledgeRecord(1);
 
     if (result.type() == knowledge::KnowledgeRecord::INTEGER)
-      context_.set_index(expand_key(), index, result.to_integer(), settings);
+      context_.set_index(ref, index, result.to_integer(), settings);
     else if (result.type() == knowledge::KnowledgeRecord::DOUBLE)
-      context_.set_index(expand_key(), index, result.to_double(), settings);
+      context_.set_index(ref, index, result.to_double(), settings);
 
     return result;
   }
@@ -300,7 +333,7 @@ int madara::expression::CompositeArrayReference::set(
     return 0;
   }
   else
-    return context_.set_index(expand_key(), index, value, settings);
+    return context_.set_index(expanded_ref(settings), index, value, settings);
 }
 
 int madara::expression::CompositeArrayReference::set(
@@ -329,7 +362,7 @@ int madara::expression::CompositeArrayReference::set(
     return 0;
   }
   else
-    return context_.set_index(expand_key(), index, value, settings);
+    return context_.set_index(expanded_ref(settings), index, value, settings);
 }
 
 #endif  // _MADARA_NO_KARL_
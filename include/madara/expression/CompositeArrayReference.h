@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "madara/expression/CompositeUnaryNode.h"
+#include "madara/expression/KeyExpansionCache.h"
 #include "madara/knowledge/ThreadSafeContext.h"
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/knowledge/KnowledgeUpdateSettings.h"
@@ -96,10 +97,20 @@ public:
     if (ref_.is_valid())
       return ref_.get_record_unsafe();
     else
-      return context_.get_record(expand_key());
+      return expanded_ref().get_record_unsafe();
   }
 
 private:
+  /// Reads the variable of an expandable key, through the expansion cache
+  /// if possible
+  madara::knowledge::KnowledgeRecord get_expanded(void) const;
+
+  /// Returns the variable of an expandable key, creating it if needed,
+  /// through the expansion cache if possible
+  madara::knowledge::VariableReference expanded_ref(
+      const madara::knowledge::KnowledgeReferenceSettings& settings =
+          knowledge::KnowledgeReferenceSettings()) const;
+
   madara::knowledge::ThreadSafeContext& context_;
 
   /// Key for retrieving value of this variable.
@@ -114,6 +125,9 @@ private:
   std::vector<std::string> tokens_;
   std::vector<std::string> pivot_list_;
 
+  /// The variable the key last expanded to, for the same index values
+  mutable KeyExpansionCache expansion_;
+
   /// Reference to context for variable retrieval
 };
 }
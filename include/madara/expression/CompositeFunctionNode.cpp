@@ -20,6 +20,7 @@
 #ifdef _MADARA_PYTHON_CALLBACKS_
 
 #include <boost/python/call.hpp>
+#include "madara/python/Acquire_GIL.h"
 
 #endif
 
@@ -196,9 +197,15 @@ madara::expression::CompositeFunctionNode::evaluate(
 
 #ifdef _MADARA_PYTHON_CALLBACKS_
   else if (function_->is_python_callable())
+  {
+    // the caller may have released the interpreter lock (e.g., evaluate
+    // and wait from the Python port), so reacquire it for the callback
+    madara::python::Acquire_GIL acquire_gil;
+
     return boost::python::call<madara::knowledge::KnowledgeRecord>(
         function_->python_function.ptr(), boost::ref(args),
         boost::ref(variables));
+  }
 #endif
 
   else if (function_->is_uninitialized())
@@ -0,0 +1,275 @@
+#ifndef _MADARA_EXPRESSION_EXPRESSION_CACHE_H_
+#define _MADARA_EXPRESSION_EXPRESSION_CACHE_H_
+
+#ifndef _MADARA_NO_KARL_
+
+/**
+ * @file ExpressionCache.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the ExpressionCache class, a thread-safe,
+ * size-bounded cache of compiled KaRL expressions, keyed by source text.
+ **/
+
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "madara/utility/StdInt.h"
+#include "madara/expression/ExpressionTree.h"
+
+namespace madara
+{
+namespace expression
+{
+/**
+ * Statistics of a compiled expression cache
+ **/
+struct ExpressionCacheStats
+{
+  /// lookups that found a compiled expression
+  uint64_t hits = 0;
+
+  /// lookups that had to compile the expression
+  uint64_t misses = 0;
+
+  /// expressions dropped to stay within capacity
+  uint64_t evictions = 0;
+
+  /// the number of expressions in the cache
+  size_t size = 0;
+
+  /// the maximum number of expressions in the cache
+  size_t capacity = 0;
+};
+
+/**
+ * A thread-safe cache of compiled expressions. Entries are indexed by a
+ * hash of their source text, and the least recently used entry is
+ * dropped when the cache is full. The cache lock is only held for
+ * lookups and inserts, never during a compile.
+ **/
+class ExpressionCache
+{
+public:
+  /// the default maximum number of cached expressions
+  static const size_t default_capacity = 1000;
+
+  /**
+   * Constructor
+   * @param  capacity  the maximum number of cached expressions
+   **/
+  ExpressionCache(size_t capacity = default_capacity) : capacity_(capacity)
+  {
+  }
+
+  /**
+   * Looks up a compiled expression
+   * @param  source  the KaRL source of the expression
+   * @param  tree    set to the compiled expression, if found
+   * @return true if the expression was found
+   **/
+  bool find(const std::string& source, ExpressionTree& tree)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto entry = locate(source, std::hash<std::string>()(source));
+
+    if (entry == lru_.end())
+    {
+      ++stats_.misses;
+      return false;
+    }
+
+    // move the entry to the front of the use list
+    lru_.splice(lru_.begin(), lru_, entry);
+
+    ++stats_.hits;
+    tree = entry->tree;
+
+    return true;
+  }
+
+  /**
+   * Inserts a compiled expression. If another thread already inserted
+   * the same source, the existing entry is kept.
+   * @param  source  the KaRL source of the expression
+   * @param  tree    the compiled expression
+   **/
+  void insert(const std::string& source, const ExpressionTree& tree)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (capacity_ == 0)
+    {
+      return;
+    }
+
+    size_t hash = std::hash<std::string>()(source);
+
+    if (locate(source, hash) != lru_.end())
+    {
+      return;
+    }
+
+    lru_.push_front(Entry{source, hash, tree});
+    index_.emplace(hash, lru_.begin());
+
+    shrink(capacity_);
+  }
+
+  /**
+   * Removes a compiled expression
+   * @param  source  the KaRL source of the expression
+   * @return true if the expression was removed
+   **/
+  bool erase(const std::string& source)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto entry = locate(source, std::hash<std::string>()(source));
+
+    if (entry == lru_.end())
+    {
+      return false;
+    }
+
+    remove(entry);
+
+    return true;
+  }
+
+  /**
+   * Removes all compiled expressions
+   **/
+  void clear(void)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    index_.clear();
+    lru_.clear();
+  }
+
+  /**
+   * Changes the maximum number of cached expressions, dropping the least
+   * recently used ones as needed. A capacity of 0 disables caching.
+   * @param  capacity  the maximum number of cached expressions
+   **/
+  void set_capacity(size_t capacity)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    capacity_ = capacity;
+    shrink(capacity_);
+  }
+
+  /**
+   * Returns the cache statistics
+   **/
+  ExpressionCacheStats get_stats(void) const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    ExpressionCacheStats result(stats_);
+    result.size = lru_.size();
+    result.capacity = capacity_;
+
+    return result;
+  }
+
+  /**
+   * Resets the hit, miss and eviction counters
+   **/
+  void reset_stats(void)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    stats_ = ExpressionCacheStats();
+  }
+
+private:
+  /// a cached expression
+  struct Entry
+  {
+    std::string source;
+    size_t hash;
+    ExpressionTree tree;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  /**
+   * Finds the entry for a source. The cache lock must be held.
+   **/
+  EntryList::iterator locate(const std::string& source, size_t hash)
+  {
+    auto range = index_.equal_range(hash);
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+      if (i->second->source == source)
+      {
+        return i->second;
+      }
+    }
+
+    return lru_.end();
+  }
+
+  /**
+   * Removes an entry. The cache lock must be held.
+   **/
+  void remove(EntryList::iterator entry)
+  {
+    auto range = index_.equal_range(entry->hash);
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+      if (i->second == entry)
+      {
+        index_.erase(i);
+        break;
+      }
+    }
+
+    lru_.erase(entry);
+  }
+
+  /**
+   * Drops the least recently used entries until at most size remain.
+   * The cache lock must be held.
+   **/
+  void shrink(size_t size)
+  {
+    while (lru_.size() > size)
+    {
+      remove(std::prev(lru_.end()));
+      ++stats_.evictions;
+    }
+  }
+
+  /// protects the entries and statistics
+  mutable std::mutex mutex_;
+
+  /// entries, from most to least recently used
+  EntryList lru_;
+
+  /// entries indexed by the hash of their source
+  std::unordered_multimap<size_t, EntryList::iterator> index_;
+
+  /// the maximum number of entries
+  size_t capacity_;
+
+  /// hit, miss and eviction counters
+  ExpressionCacheStats stats_;
+};
+}
+}
+
+#endif  // _MADARA_NO_KARL_
+
+#endif  // _MADARA_EXPRESSION_EXPRESSION_CACHE_H_
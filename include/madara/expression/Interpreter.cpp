@@ -86,6 +86,7 @@
 #include "madara/expression/Interpreter.h"
 
 #include "madara/expression/Visitor.h"
+#include "madara/knowledge/ContextGuard.h"
 
 typedef madara::knowledge::KnowledgeRecord::Integer Integer;
 
@@ -6614,9 +6615,9 @@ madara::expression::ExpressionTree madara::expression::Interpreter::interpret(
     knowledge::ThreadSafeContext& context, const std::string& input)
 {
   // return the cached expression tree if it exists
-  ExpressionTreeMap::const_iterator found = cache_.find(input);
-  if (found != cache_.end())
-    return found->second;
+  ExpressionTree cached;
+  if (cache_.find(input, cached))
+    return cached;
 
   ::std::list<Symbol*> list;
   // list.clear ();
@@ -6667,12 +6668,17 @@ madara::expression::ExpressionTree madara::expression::Interpreter::interpret(
 
     ExpressionTree tree(context.get_logger(), list.back()->build(), false);
 
-    // optimize the tree
-    tree.prune();
+    // optimize the tree. Pruning reads the current values of variables,
+    // so it needs the context lock that the parse itself does without
+    {
+      knowledge::ContextGuard guard(context);
+      tree.prune();
+    }
+
     delete list.back();
 
     // store this optimized tree into cached memory
-    cache_[input] = tree;
+    cache_.insert(input, tree);
 
     return tree;
   }
@@ -19,6 +19,7 @@
 
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/expression/ExpressionTree.h"
+#include "madara/expression/ExpressionCache.h"
 #include "madara/knowledge/ThreadSafeContext.h"
 
 namespace madara
@@ -118,6 +119,12 @@ public:
    **/
   inline bool delete_expression(const std::string& expression);
 
+  /**
+   * Returns the cache of compiled expressions
+   * @return   the thread-safe cache of compiled expressions
+   **/
+  inline ExpressionCache& get_cache(void);
+
 private:
   /**
    * extracts precondition, condition, postcondition, and body from input
@@ -252,7 +259,7 @@ private:
   /**
    * Cache of expressions that have been previously compiled
    **/
-  ExpressionTreeMap cache_;
+  ExpressionCache cache_;
 };
 }
 }
@@ -70,7 +70,13 @@ inline bool madara::expression::Interpreter::is_whitespace(char input)
 inline bool madara::expression::Interpreter::delete_expression(
     const std::string& expression)
 {
-  return cache_.erase(expression) == 1;
+  return cache_.erase(expression);
+}
+
+inline madara::expression::ExpressionCache&
+madara::expression::Interpreter::get_cache(void)
+{
+  return cache_;
 }
 
 #endif  // _MADARA_NO_KARL_
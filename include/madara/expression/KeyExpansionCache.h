@@ -0,0 +1,239 @@
+/* -*- C++ -*- */
+#ifndef _MADARA_EXPRESSION_KEY_EXPANSION_CACHE_H_
+#define _MADARA_EXPRESSION_KEY_EXPANSION_CACHE_H_
+
+#ifndef _MADARA_NO_KARL_
+
+/**
+ * @file KeyExpansionCache.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the KeyExpansionCache class, which remembers the
+ * variable an expandable key (e.g., agent.{.id}.pos) resolved to for the
+ * current values of its index variables.
+ **/
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+#include "madara/knowledge/VariableReference.h"
+
+namespace madara
+{
+namespace expression
+{
+/**
+ * A cache of the expansions of a key with single-level index variables,
+ * e.g., agent.{.id}.pos or a{.i}. Resolved references are remembered by
+ * the integer values of the index variables, so repeated evaluations with
+ * the same indices, including each pass of a for loop, skip building a
+ * string and searching the context. Keys with nested expansions, or index
+ * variables that are not integers, are not cached. The cache is protected
+ * by the context lock, which resolve acquires.
+ **/
+class KeyExpansionCache
+{
+public:
+  /// the maximum number of index values remembered per key
+  static const size_t max_entries = 1024;
+
+  /**
+   * Prepares the cache for a key
+   * @param  key   the key, with expansions in braces
+   **/
+  void init(const std::string& key)
+  {
+    literals_.clear();
+    names_.clear();
+
+    size_t start = 0;
+    cacheable_ = true;
+
+    for (size_t opener = key.find('{'); opener != key.npos;
+         opener = key.find('{', start))
+    {
+      size_t closer = key.find('}', opener + 1);
+
+      // nested or unmatched braces are left to the full expansion
+      if (closer == key.npos ||
+          key.find('{', opener + 1) < closer || closer == opener + 1)
+      {
+        cacheable_ = false;
+        break;
+      }
+
+      literals_.push_back(key.substr(start, opener - start));
+      names_.push_back(key.substr(opener + 1, closer - opener - 1));
+
+      start = closer + 1;
+    }
+
+    if (start < key.size() && key.find('}', start) != key.npos)
+    {
+      cacheable_ = false;
+    }
+
+    literals_.push_back(key.substr(start));
+
+    cacheable_ = cacheable_ && names_.size() > 0;
+
+    clear();
+  }
+
+  /**
+   * Forgets the resolved variable and index variables
+   **/
+  void clear(void)
+  {
+    indices_.clear();
+    values_.clear();
+    refs_.clear();
+    ref_ = knowledge::VariableReference();
+  }
+
+  /**
+   * Checks if expansions of the key can be cached
+   * @return true if lookups may be served by the cache
+   **/
+  bool cacheable(void) const
+  {
+    return cacheable_;
+  }
+
+  /**
+   * Resolves the key for the current values of its index variables
+   * @param  context   the context that holds the variables
+   * @param  create    if true, create the expanded variable if missing
+   * @return the expanded variable, or an invalid reference if the key
+   *         has to be expanded the slow way, or if the variable does not
+   *         exist and create is false
+   **/
+  knowledge::VariableReference resolve(
+      knowledge::ThreadSafeContext& context, bool create)
+  {
+    if (!cacheable_)
+    {
+      return knowledge::VariableReference();
+    }
+
+    std::lock_guard<knowledge::ThreadSafeContext> guard(context);
+
+    // erasures may have invalidated the references we hold
+    if (indices_.size() != names_.size() ||
+        generation_ != context.get_erase_generation())
+    {
+      clear();
+      generation_ = context.get_erase_generation();
+
+      const knowledge::KnowledgeReferenceSettings raw(false);
+
+      for (auto& name : names_)
+      {
+        indices_.push_back(context.get_ref(name, raw));
+      }
+
+      values_.resize(names_.size());
+    }
+
+    for (size_t i = 0; i < indices_.size(); ++i)
+    {
+      const knowledge::KnowledgeRecord& index =
+          *indices_[i].get_record_unsafe();
+
+      if (index.type() != knowledge::KnowledgeRecord::INTEGER)
+      {
+        return knowledge::VariableReference();
+      }
+
+      knowledge::KnowledgeRecord::Integer value = index.to_integer();
+
+      if (value != values_[i])
+      {
+        values_[i] = value;
+        ref_ = knowledge::VariableReference();
+      }
+    }
+
+    if (ref_.is_valid())
+    {
+      return ref_;
+    }
+
+    auto found = refs_.find(values_);
+
+    if (found != refs_.end())
+    {
+      ref_ = found->second;
+      return ref_;
+    }
+
+    std::string key(literals_[0]);
+
+    for (size_t i = 0; i < values_.size(); ++i)
+    {
+      key += std::to_string(values_[i]);
+      key += literals_[i + 1];
+    }
+
+    const knowledge::KnowledgeReferenceSettings raw(false);
+
+    if (create)
+    {
+      ref_ = context.get_ref(key, raw);
+    }
+    else
+    {
+      ref_ = static_cast<const knowledge::ThreadSafeContext&>(context).get_ref(
+          key, raw);
+    }
+
+    if (ref_.is_valid())
+    {
+      if (refs_.size() >= max_entries)
+      {
+        refs_.clear();
+      }
+
+      refs_.emplace(values_, ref_);
+    }
+
+    return ref_;
+  }
+
+private:
+  /// true if the key has only single-level expansions
+  bool cacheable_ = false;
+
+  /// the text before, between and after the expansions
+  std::vector<std::string> literals_;
+
+  /// the names of the index variables
+  std::vector<std::string> names_;
+
+  /// references to the index variables
+  std::vector<knowledge::VariableReference> indices_;
+
+  /// the index values that ref_ was resolved with
+  std::vector<knowledge::KnowledgeRecord::Integer> values_;
+
+  /// resolved variables, keyed by index values
+  std::map<std::vector<knowledge::KnowledgeRecord::Integer>,
+      knowledge::VariableReference>
+      refs_;
+
+  /// the erase generation of the context when indices_ were resolved
+  uint64_t generation_ = 0;
+
+  /// the resolved variable
+  knowledge::VariableReference ref_;
+};
+}
+}
+
+#endif  // _MADARA_NO_KARL_
+
+#endif  // _MADARA_EXPRESSION_KEY_EXPANSION_CACHE_H_
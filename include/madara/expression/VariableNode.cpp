@@ -77,6 +77,8 @@ madara::expression::VariableNode::VariableNode(
 
       throw exceptions::KarlException(buffer.str());
     }
+
+    expansion_.init(key);
   }
   // no variable expansion necessary. Create a hard link to the ref_->
   // this will save us lots of clock cycles each variable access or
@@ -217,6 +219,19 @@ std::string madara::expression::VariableNode::expand_key(void) const
     return key_;
 }
 
+madara::knowledge::KnowledgeRecord
+madara::expression::VariableNode::get_expanded(
+    const madara::knowledge::KnowledgeReferenceSettings& settings) const
+{
+  // repeated evaluations with the same index values skip the expansion
+  knowledge::VariableReference ref = expansion_.resolve(context_, false);
+
+  if (ref.is_valid())
+    return context_.get(ref, settings);
+  else
+    return context_.get(expand_key(), settings);
+}
+
 void madara::expression::VariableNode::accept(Visitor& visitor) const
 {
   visitor.visit(*this);
@@ -228,7 +243,7 @@ madara::knowledge::KnowledgeRecord madara::expression::VariableNode::item()
   if (ref_.is_valid())
     return *ref_.get_record_unsafe();
   else
-    return context_.get(expand_key());
+    return get_expanded();
 }
 
 /// Prune the tree of unnecessary nodes.
@@ -246,7 +261,7 @@ madara::knowledge::KnowledgeRecord madara::expression::VariableNode::prune(
   if (ref_.is_valid())
     return *ref_.get_record_unsafe();
   else
-    return context_.get(expand_key());
+    return get_expanded();
 }
 
 /// Evaluates the node and its children.
@@ -275,7 +290,7 @@ madara::knowledge::KnowledgeRecord madara::expression::VariableNode::evaluate(
   }
   else
   {
-    auto ret = context_.get(expand_key(), settings);
+    auto ret = get_expanded(settings);
 
     if (settings.exception_on_unitialized && !ret.exists ())
     {
@@ -308,6 +323,11 @@ int madara::expression::VariableNode::set(
       "Attempting to set variable %s to a KnowledgeRecord parameter (%s).\n",
       key_.c_str(), value.to_string().c_str());
 
+  if (!ref.is_valid() && settings.expand_variables)
+  {
+    ref = expansion_.resolve(context_, true);
+  }
+
   if (!ref.is_valid())
   {
     ref = context_.get_ref(key_, settings);
@@ -402,6 +422,11 @@ madara::knowledge::KnowledgeRecord madara::expression::VariableNode::dec(
 
     return *record;
   }
+
+  knowledge::VariableReference ref = expansion_.resolve(context_, true);
+
+  if (ref.is_valid())
+    return context_.dec(ref, settings);
   else
     return context_.dec(expand_key(), settings);
 }
@@ -430,6 +455,11 @@ madara::knowledge::KnowledgeRecord madara::expression::VariableNode::inc(
 
     return *record;
   }
+
+  knowledge::VariableReference ref = expansion_.resolve(context_, true);
+
+  if (ref.is_valid())
+    return context_.inc(ref, settings);
   else
     return context_.inc(expand_key(), settings);
 }
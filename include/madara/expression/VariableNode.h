@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "madara/expression/ComponentNode.h"
+#include "madara/expression/KeyExpansionCache.h"
 #include "madara/knowledge/ThreadSafeContext.h"
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/knowledge/KnowledgeUpdateSettings.h"
@@ -95,6 +96,12 @@ public:
   {
     if (ref_.is_valid())
       return ref_.get_record_unsafe();
+
+    madara::knowledge::VariableReference ref =
+        expansion_.resolve(context_, true);
+
+    if (ref.is_valid())
+      return ref.get_record_unsafe();
     else
       return context_.get_record(expand_key());
   }
@@ -102,6 +109,12 @@ public:
 private:
   std::string expand_opener(size_t opener, size_t& closer) const;
 
+  /// Reads the variable of an expandable key, through the expansion cache
+  /// if possible
+  madara::knowledge::KnowledgeRecord get_expanded(
+      const madara::knowledge::KnowledgeReferenceSettings& settings =
+          knowledge::KnowledgeReferenceSettings()) const;
+
   /// Key for retrieving value of this variable.
   const std::string key_;
   madara::knowledge::VariableReference ref_;
@@ -113,6 +126,9 @@ private:
 
   std::vector<size_t> markers_;
 
+  /// The variable the key last expanded to, for the same index values
+  mutable KeyExpansionCache expansion_;
+
   /// Reference to context for variable retrieval
 };
 }
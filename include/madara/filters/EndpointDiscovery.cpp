@@ -5,12 +5,15 @@
 namespace utility = madara::utility;
 typedef madara::knowledge::KnowledgeRecord::Integer Integer;
 
-madara::filters::EndpointDiscovery::EndpointDiscovery(
-    const std::string& prefix, knowledge::KnowledgeRecord::Integer heart_beat)
+madara::filters::EndpointDiscovery::EndpointDiscovery(const std::string& prefix,
+    knowledge::KnowledgeRecord::Integer heart_beat, double publish_interval)
   : initialized_(false),
     prefix_(prefix),
     heart_beat_(heart_beat * 1000000000),
-    last_clear_(0)
+    last_clear_(0),
+    publish_interval_((Integer)(publish_interval * 1000000000)),
+    last_publish_(0),
+    table_(heart_beat_)
 {
 }
 
@@ -21,6 +24,8 @@ void madara::filters::EndpointDiscovery::filter(
     const transport::TransportContext& transport_context,
     knowledge::Variables& vars)
 {
+  MADARA_GUARD_TYPE guard(mutex_);
+
   if (!initialized_)
   {
     endpoints_.set_name(prefix_, vars);
@@ -35,29 +40,41 @@ void madara::filters::EndpointDiscovery::filter(
   std::string endpoint(transport_context.get_endpoint());
   Integer cur_time = (Integer)transport_context.get_current_time();
 
-  endpoints_.set(endpoint, cur_time);
+  // only joining endpoints and the publish interval touch the knowledge
+  // base, since every received message passes through here
+  if (table_.touch(endpoint, cur_time) || publish_interval_ == 0)
+  {
+    endpoints_.set(endpoint, cur_time);
+  }
 
   if (heart_beat_ > 0 && last_clear_ != cur_time)
   {
-    std::vector<std::string> keys;
-    endpoints_.sync_keys();
+    std::vector<std::string> expired;
+    table_.expire(cur_time, expired);
 
-    endpoints_.keys(keys);
-
-    for (size_t i = 0; i < keys.size(); ++i)
+    for (size_t i = 0; i < expired.size(); ++i)
     {
-      // if the current endpoint is old, erase it
-      if (cur_time - endpoints_[keys[i]].to_integer() > heart_beat_)
-      {
-        madara_logger_log(vars.get_context()->get_logger(), logger::LOG_MINOR,
-            "EndpointDiscovery::filter:"
-            " Erasing endpoint %s\n",
-            keys[i].c_str());
-
-        endpoints_.erase(keys[i]);
-      }
+      madara_logger_log(vars.get_context()->get_logger(), logger::LOG_MINOR,
+          "EndpointDiscovery::filter:"
+          " Erasing endpoint %s\n",
+          expired[i].c_str());
+
+      endpoints_.erase(expired[i]);
     }
 
     last_clear_ = cur_time;
   }
+
+  if (publish_interval_ > 0 && cur_time - last_publish_ >= publish_interval_)
+  {
+    std::vector<std::pair<std::string, Integer>> endpoints;
+    table_.get_peers(endpoints);
+
+    for (size_t i = 0; i < endpoints.size(); ++i)
+    {
+      endpoints_.set(endpoints[i].first, endpoints[i].second);
+    }
+
+    last_publish_ = cur_time;
+  }
 }
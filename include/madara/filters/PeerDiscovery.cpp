@@ -4,12 +4,15 @@
 namespace utility = madara::utility;
 typedef madara::knowledge::KnowledgeRecord::Integer Integer;
 
-madara::filters::PeerDiscovery::PeerDiscovery(
-    const std::string& prefix, knowledge::KnowledgeRecord::Integer heart_beat)
+madara::filters::PeerDiscovery::PeerDiscovery(const std::string& prefix,
+    knowledge::KnowledgeRecord::Integer heart_beat, double publish_interval)
   : initialized_(false),
     prefix_(prefix),
     heart_beat_(heart_beat * 1000000000),
-    last_clear_(0)
+    last_clear_(0),
+    publish_interval_((Integer)(publish_interval * 1000000000)),
+    last_publish_(0),
+    table_(heart_beat_)
 {
 }
 
@@ -20,6 +23,8 @@ void madara::filters::PeerDiscovery::filter(
     const transport::TransportContext& transport_context,
     knowledge::Variables& vars)
 {
+  MADARA_GUARD_TYPE guard(mutex_);
+
   if (!initialized_)
   {
     peers_.set_name(prefix_, vars);
@@ -29,22 +34,36 @@ void madara::filters::PeerDiscovery::filter(
   std::string originator(transport_context.get_originator());
   Integer cur_time = (Integer)transport_context.get_current_time();
 
-  peers_.set(originator, cur_time);
+  // only joining peers and the publish interval touch the knowledge
+  // base, since every received message passes through here
+  if (table_.touch(originator, cur_time) || publish_interval_ == 0)
+  {
+    peers_.set(originator, cur_time);
+  }
 
   if (heart_beat_ > 0 && last_clear_ != cur_time)
   {
-    std::vector<std::string> keys;
-    peers_.sync_keys();
+    std::vector<std::string> expired;
+    table_.expire(cur_time, expired);
+
+    for (size_t i = 0; i < expired.size(); ++i)
+    {
+      peers_.erase(expired[i]);
+    }
 
-    peers_.keys(keys);
+    last_clear_ = cur_time;
+  }
 
-    for (size_t i = 0; i < keys.size(); ++i)
+  if (publish_interval_ > 0 && cur_time - last_publish_ >= publish_interval_)
+  {
+    std::vector<std::pair<std::string, Integer>> peers;
+    table_.get_peers(peers);
+
+    for (size_t i = 0; i < peers.size(); ++i)
     {
-      // if the current originator is old, erase it
-      if (cur_time - peers_[keys[i]].to_integer() > heart_beat_)
-      {
-        peers_.erase(keys[i]);
-      }
+      peers_.set(peers[i].first, peers[i].second);
     }
+
+    last_publish_ = cur_time;
   }
 }
@@ -14,6 +14,7 @@
 #include <vector>
 #include <map>
 #include <list>
+#include "madara/LockType.h"
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/knowledge/Functions.h"
 #include "madara/utility/StdInt.h"
@@ -23,6 +24,7 @@
 #include "madara/knowledge/containers/Map.h"
 
 #include "AggregateFilter.h"
+#include "PeerTable.h"
 
 namespace madara
 {
@@ -41,9 +43,17 @@ public:
    * @param  heart_beat  the time, in seconds, before dropping a peer from
    *                     discovery. Negative values indicate that peers
    *                     should never be erased.
+   * @param  publish_interval  the time, in seconds, between copies of the
+   *                     last time each peer was heard from into the
+   *                     knowledge base. Peers are also copied when they
+   *                     join. 0, the default, copies the sender of every
+   *                     message as before, and negative values only copy
+   *                     joining peers. A positive interval saves a write
+   *                     to the knowledge base for most messages.
    **/
   PeerDiscovery(const std::string& prefix = ".peers",
-      knowledge::KnowledgeRecord::Integer heart_beat = -1);
+      knowledge::KnowledgeRecord::Integer heart_beat = -1,
+      double publish_interval = 0.0);
 
   /**
    * Destructor
@@ -87,6 +97,26 @@ protected:
    * The time of the last clear of the peer_list
    **/
   knowledge::KnowledgeRecord::Integer last_clear_;
+
+  /**
+   * The time between copies of the peer table into the knowledge base
+   **/
+  knowledge::KnowledgeRecord::Integer publish_interval_;
+
+  /**
+   * The time of the last copy of the peer table into the knowledge base
+   **/
+  knowledge::KnowledgeRecord::Integer last_publish_;
+
+  /**
+   * The last time each peer was heard from
+   **/
+  PeerTable table_;
+
+  /**
+   * Guards the table, since receive threads may filter concurrently
+   **/
+  MADARA_LOCK_TYPE mutex_;
 };
 }
 }
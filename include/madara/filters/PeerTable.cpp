@@ -0,0 +1,85 @@
+#include "PeerTable.h"
+
+madara::filters::PeerTable::PeerTable(Integer heart_beat)
+  : heart_beat_(heart_beat)
+{
+}
+
+bool madara::filters::PeerTable::touch(const std::string& peer, Integer time)
+{
+  auto result = last_seen_.emplace(peer, time);
+
+  if (!result.second)
+  {
+    // the heap entry is checked against this time when it comes up
+    result.first->second = time;
+    return false;
+  }
+
+  if (heart_beat_ > 0)
+  {
+    expiries_.push(Expiry{time + heart_beat_, peer});
+  }
+
+  return true;
+}
+
+size_t madara::filters::PeerTable::expire(
+    Integer time, std::vector<std::string>& expired)
+{
+  size_t removed = 0;
+
+  while (!expiries_.empty() && expiries_.top().time < time)
+  {
+    Expiry expiry = expiries_.top();
+    expiries_.pop();
+
+    auto found = last_seen_.find(expiry.peer);
+
+    if (found == last_seen_.end())
+    {
+      continue;
+    }
+
+    if (time - found->second > heart_beat_)
+    {
+      last_seen_.erase(found);
+      expired.push_back(std::move(expiry.peer));
+      ++removed;
+    }
+    else
+    {
+      // the peer was heard from since the entry was made
+      expiry.time = found->second + heart_beat_;
+      expiries_.push(std::move(expiry));
+    }
+  }
+
+  return removed;
+}
+
+madara::filters::PeerTable::Integer
+madara::filters::PeerTable::get_last_seen(const std::string& peer) const
+{
+  auto found = last_seen_.find(peer);
+
+  return found != last_seen_.end() ? found->second : -1;
+}
+
+void madara::filters::PeerTable::get_peers(
+    std::vector<std::pair<std::string, Integer>>& peers) const
+{
+  peers.reserve(peers.size() + last_seen_.size());
+  peers.insert(peers.end(), last_seen_.begin(), last_seen_.end());
+}
+
+size_t madara::filters::PeerTable::size(void) const
+{
+  return last_seen_.size();
+}
+
+void madara::filters::PeerTable::clear(void)
+{
+  last_seen_.clear();
+  expiries_ = decltype(expiries_)();
+}
@@ -0,0 +1,120 @@
+
+
+#ifndef _MADARA_FILTERS_PEER_TABLE_H_
+#define _MADARA_FILTERS_PEER_TABLE_H_
+
+/**
+ * @file PeerTable.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a table of the last times peers were heard from,
+ * which is used by the discovery filters
+ **/
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include "madara/knowledge/KnowledgeRecord.h"
+#include "madara/MadaraExport.h"
+
+namespace madara
+{
+namespace filters
+{
+/**
+ * @class PeerTable
+ * @brief Tracks the last time each peer was heard from and expires peers
+ *        that have been silent longer than a heart beat. Hearing from a
+ *        peer is a hash table update, and expiring peers only visits
+ *        peers that may have expired, via a min-heap ordered by the time
+ *        each peer could expire. Each peer has one entry in the heap,
+ *        which is pushed back with a later time when the peer was heard
+ *        from since the entry was made. The table is not thread-safe.
+ **/
+class MADARA_EXPORT PeerTable
+{
+public:
+  /// the type of times in the table
+  typedef knowledge::KnowledgeRecord::Integer Integer;
+
+  /**
+   * Constructor
+   * @param  heart_beat  the time, in nanoseconds, before dropping a peer.
+   *                     Non-positive values indicate that peers should
+   *                     never expire.
+   **/
+  PeerTable(Integer heart_beat = -1);
+
+  /**
+   * Records that a peer was heard from
+   * @param  peer    the peer
+   * @param  time    the current time in nanoseconds
+   * @return true if the peer was not in the table
+   **/
+  bool touch(const std::string& peer, Integer time);
+
+  /**
+   * Removes peers that have not been heard from within the heart beat
+   * @param  time     the current time in nanoseconds
+   * @param  expired  the removed peers are appended here
+   * @return the number of removed peers
+   **/
+  size_t expire(Integer time, std::vector<std::string>& expired);
+
+  /**
+   * Returns the last time a peer was heard from
+   * @param  peer    the peer
+   * @return the time in nanoseconds, or -1 if the peer is not in the table
+   **/
+  Integer get_last_seen(const std::string& peer) const;
+
+  /**
+   * Returns every peer with the last time it was heard from
+   * @param  peers   the peers and times are appended here
+   **/
+  void get_peers(std::vector<std::pair<std::string, Integer>>& peers) const;
+
+  /**
+   * Returns the number of peers
+   * @return the number of peers in the table
+   **/
+  size_t size(void) const;
+
+  /**
+   * Removes all peers
+   **/
+  void clear(void);
+
+private:
+  /**
+   * An entry in the expiry heap
+   **/
+  struct Expiry
+  {
+    /// the earliest time the peer could expire
+    Integer time;
+
+    /// the peer
+    std::string peer;
+
+    bool operator>(const Expiry& rhs) const
+    {
+      return time > rhs.time;
+    }
+  };
+
+  /// the time before dropping a peer
+  Integer heart_beat_;
+
+  /// the last time each peer was heard from
+  std::unordered_map<std::string, Integer> last_seen_;
+
+  /// the peers, ordered by the earliest time they could expire
+  std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>>
+      expiries_;
+};
+}
+}
+
+#endif  // _MADARA_FILTERS_PEER_TABLE_H_
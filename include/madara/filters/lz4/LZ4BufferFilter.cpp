@@ -2,49 +2,293 @@
 #ifdef _USE_LZ4_
 
 #include <string.h>
+#include "boost/crc.hpp"
 #include "LZ4BufferFilter.h"
 #include "lz4.h"
 #include "madara/utility/Utility.h"
 #include "madara/logger/GlobalLogger.h"
 
+namespace
+{
+/// the size of the mode byte and dictionary id
+const int dictionary_header_size = 5;
+
+/// LZ4 only uses the last 64 KB of a dictionary
+const size_t max_dictionary_size = 64 * 1024;
+
+/// writes a dictionary id in network byte order
+void write_dictionary_id(char* buffer, uint32_t id)
+{
+  for (int i = 3; i >= 0; --i, id >>= 8)
+  {
+    buffer[i] = (char)(id & 0xFF);
+  }
+}
+
+/// reads a dictionary id in network byte order
+uint32_t read_dictionary_id(const char* buffer)
+{
+  uint32_t id = 0;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    id = (id << 8) | (unsigned char)buffer[i];
+  }
+
+  return id;
+}
+}
+
+madara::filters::LZ4BufferFilter::LZ4BufferFilter()
+  : incompressible_(0), raw_count_(0)
+{
+}
+
+madara::filters::LZ4BufferFilter::LZ4BufferFilter(const LZ4BufferFilter& input)
+  : acceleration(input.acceleration),
+    min_size(input.min_size),
+    skip_after(input.skip_after),
+    skip_count(input.skip_count),
+    dictionary_(input.dictionary_),
+    dictionary_id_(input.dictionary_id_),
+    incompressible_(0),
+    raw_count_(0)
+{
+}
+
+madara::filters::LZ4BufferFilter::~LZ4BufferFilter() {}
+
+void madara::filters::LZ4BufferFilter::set_dictionary(
+    const std::string& dictionary)
+{
+  if (dictionary.size() > max_dictionary_size)
+  {
+    dictionary_ = dictionary.substr(dictionary.size() - max_dictionary_size);
+  }
+  else
+  {
+    dictionary_ = dictionary;
+  }
+
+  boost::crc_32_type crc;
+  crc.process_bytes(dictionary_.data(), dictionary_.size());
+  dictionary_id_ = crc.checksum();
+}
+
+std::string madara::filters::LZ4BufferFilter::get_dictionary(void) const
+{
+  return dictionary_;
+}
+
+std::unique_ptr<madara::filters::LZ4BufferFilter::Scratch>
+madara::filters::LZ4BufferFilter::acquire(void) const
+{
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if (scratch_.size() > 0)
+    {
+      std::unique_ptr<Scratch> result(std::move(scratch_.back()));
+      scratch_.pop_back();
+      return result;
+    }
+  }
+
+  std::unique_ptr<Scratch> result(new Scratch());
+  result->state.resize(LZ4_sizeofState());
+
+  return result;
+}
+
+void madara::filters::LZ4BufferFilter::release(
+    std::unique_ptr<Scratch> scratch) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  scratch_.push_back(std::move(scratch));
+}
+
 int madara::filters::LZ4BufferFilter::encode(
     char* source, int size, int max_size) const
 {
-  char* source_copy = new char[buffer_size];
-  memcpy(source_copy, source, size);
+  bool compress = size >= min_size && size <= LZ4_MAX_INPUT_SIZE;
 
-  madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
-      "LZ4BufferFilter::encode: calling LZ4_compress_default(%d,%d).\n", size,
-      max_size);
+  // while skipping, count the skip down instead of compressing
+  if (compress && skip_after > 0)
+  {
+    int incompressible = incompressible_.load();
 
-  int new_size =
-      LZ4_compress_default(source_copy, (char*)source, size, max_size);
-  delete[] source_copy;
+    while (incompressible < 0 && !incompressible_.compare_exchange_weak(
+                                     incompressible, incompressible + 1))
+    {
+    }
 
-  madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
-      "LZ4BufferFilter::encode: new_size=%d.\n", new_size);
+    compress = incompressible >= 0;
+  }
 
-  // error codes are negative and appear to point to where in the buffer
-  // bad things happened
-  return new_size > 0 ? new_size : 0;
+  if (compress)
+  {
+    std::unique_ptr<Scratch> scratch(acquire());
+
+    int header_size = dictionary_.size() > 0 ? dictionary_header_size : 1;
+    int bound = LZ4_compressBound(size);
+
+    if ((int)scratch->buffer.size() < header_size + bound)
+    {
+      scratch->buffer.resize(header_size + bound);
+    }
+
+    char* compressed = scratch->buffer.data() + header_size;
+    int new_size = 0;
+
+    if (dictionary_.size() > 0)
+    {
+      LZ4_stream_t* stream = (LZ4_stream_t*)scratch->state.data();
+
+      LZ4_loadDict(stream, dictionary_.data(), (int)dictionary_.size());
+
+      new_size = LZ4_compress_fast_continue(
+          stream, source, compressed, size, bound, acceleration);
+    }
+    else
+    {
+      new_size = LZ4_compress_fast_extState(scratch->state.data(), source,
+          compressed, size, bound, acceleration);
+    }
+
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
+        "LZ4BufferFilter::encode: compressed %d bytes to %d.\n", size,
+        new_size);
+
+    // only keep the compressed payload if it is smaller than the raw one
+    if (new_size > 0 && new_size + header_size <= max_size &&
+        new_size + header_size < size + 1)
+    {
+      incompressible_ = 0;
+
+      if (dictionary_.size() > 0)
+      {
+        scratch->buffer[0] = (char)DICTIONARY;
+        write_dictionary_id(scratch->buffer.data() + 1, dictionary_id_);
+      }
+      else
+      {
+        scratch->buffer[0] = (char)COMPRESSED;
+      }
+
+      memcpy(source, scratch->buffer.data(), new_size + header_size);
+
+      release(std::move(scratch));
+
+      return new_size + header_size;
+    }
+
+    release(std::move(scratch));
+
+    if (skip_after > 0 && ++incompressible_ >= skip_after)
+    {
+      madara_logger_ptr_log(logger::global_logger.get_ptr(),
+          logger::LOG_MAJOR,
+          "LZ4BufferFilter::encode: payloads are not compressing. "
+          "Sending the next %d raw.\n",
+          skip_count);
+
+      incompressible_ = -skip_count;
+    }
+  }
+
+  if (size + 1 > max_size)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "LZ4BufferFilter::encode: %d bytes cannot fit in %d byte buffer.\n",
+        size + 1, max_size);
+
+    return 0;
+  }
+
+  ++raw_count_;
+
+  memmove(source + 1, source, size);
+  source[0] = (char)RAW;
+
+  return size + 1;
 }
 
 int madara::filters::LZ4BufferFilter::decode(
     char* source, int size, int max_size) const
 {
-  char* source_copy = new char[buffer_size];
-  memcpy(source_copy, source, size);
+  if (size < 1)
+  {
+    return 0;
+  }
 
-  madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
-      "LZ4BufferFilter::decode: calling LZ4_decompress_safe(%d,%d).\n", size,
-      max_size);
+  char mode = source[0];
+
+  if (mode == (char)RAW)
+  {
+    memmove(source, source + 1, size - 1);
+
+    return size - 1;
+  }
+
+  int header_size = mode == (char)DICTIONARY ? dictionary_header_size : 1;
+
+  if (size < header_size ||
+      (mode != (char)COMPRESSED && mode != (char)DICTIONARY))
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "LZ4BufferFilter::decode: invalid mode %d in %d byte buffer.\n",
+        (int)mode, size);
+
+    return 0;
+  }
+
+  if (mode == (char)DICTIONARY)
+  {
+    uint32_t id = read_dictionary_id(source + 1);
+
+    if (dictionary_.size() == 0 || id != dictionary_id_)
+    {
+      madara_logger_ptr_log(logger::global_logger.get_ptr(),
+          logger::LOG_ERROR,
+          "LZ4BufferFilter::decode: the buffer was compressed with a "
+          "different dictionary (%u instead of %u).\n",
+          id, dictionary_id_);
+
+      return 0;
+    }
+  }
 
-  int new_size =
-      LZ4_decompress_safe(source_copy, (char*)source, size, max_size);
-  delete[] source_copy;
+  // LZ4 cannot decompress in place, so move the payload aside
+  std::unique_ptr<Scratch> scratch(acquire());
+
+  int compressed_size = size - header_size;
+
+  if ((int)scratch->buffer.size() < compressed_size)
+  {
+    scratch->buffer.resize(compressed_size);
+  }
+
+  memcpy(scratch->buffer.data(), source + header_size, compressed_size);
+
+  int new_size = 0;
+
+  if (mode == (char)DICTIONARY)
+  {
+    new_size = LZ4_decompress_safe_usingDict(scratch->buffer.data(), source,
+        compressed_size, max_size, dictionary_.data(), (int)dictionary_.size());
+  }
+  else
+  {
+    new_size = LZ4_decompress_safe(
+        scratch->buffer.data(), source, compressed_size, max_size);
+  }
+
+  release(std::move(scratch));
 
   madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
-      "LZ4BufferFilter::decode: new_size=%d.\n", new_size);
+      "LZ4BufferFilter::decode: decompressed %d bytes to %d.\n", size,
+      new_size);
 
   // error codes are negative and appear to point to where in the buffer
   // bad things happened
@@ -58,7 +302,12 @@ std::string madara::filters::LZ4BufferFilter::get_id(void)
 
 uint32_t madara::filters::LZ4BufferFilter::get_version(void)
 {
-  return madara::utility::get_uint_version("1.0.0");
+  return madara::utility::get_uint_version("1.1.0");
+}
+
+uint64_t madara::filters::LZ4BufferFilter::get_raw_count(void) const
+{
+  return raw_count_;
 }
 
-#endif  // _USE_SSL_
+#endif  // _USE_LZ4_
@@ -6,13 +6,18 @@
  * @file LZ4BufferFilter.h
  * @author James Edmondson <jedmondson@gmail.com>
  *
- * This file contains a filter functor for 256 bit AES encryption
+ * This file contains a filter functor for LZ4 compression
  **/
 
 #ifdef _USE_LZ4_
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "madara/LockType.h"
+#include "madara/utility/StdInt.h"
 #include "madara/MadaraExport.h"
 #include "../BufferFilter.h"
 
@@ -22,15 +27,71 @@ namespace filters
 {
 /**
  * @class LZ4BufferFilter
- * @brief Compresses with LZ4
+ * @brief Compresses with LZ4. Encoded buffers start with a mode byte,
+ *        and payloads that do not compress are sent raw behind it, so
+ *        decoding never expands them. With a dictionary, e.g., the
+ *        names of the variables a sender usually sends, small messages
+ *        compress well because LZ4 can refer to the dictionary. Both
+ *        sides of a transport must set the same dictionary.
+ *
+ *        Compression and decompression use scratch buffers that are
+ *        reused across calls, one set per concurrent caller, so encoding
+ *        and decoding do not allocate once the buffers have grown.
+ *
+ *        Format:
+ *
+ *        [8 bit mode, @see Modes]<br />
+ *        [32 bit dictionary id, network byte order] (only if mode is
+ *        DICTIONARY)<br />
+ *        [raw or compressed payload]
  */
 class MADARA_EXPORT LZ4BufferFilter : public BufferFilter
 {
 public:
+  /**
+   * The ways a payload can be encoded
+   **/
+  enum Modes
+  {
+    /// the payload is not compressed
+    RAW = 0,
+
+    /// the payload is compressed without a dictionary
+    COMPRESSED = 1,
+
+    /// the payload is compressed with the dictionary
+    DICTIONARY = 2
+  };
+
+  /**
+   * Constructor
+   **/
+  LZ4BufferFilter();
+
+  /**
+   * Copy constructor, which copies the settings and dictionary
+   * @param  input   the buffer filter to copy
+   **/
+  LZ4BufferFilter(const LZ4BufferFilter& input);
+
   /**
    * Destructor
    **/
-  virtual ~LZ4BufferFilter() = default;
+  virtual ~LZ4BufferFilter();
+
+  /**
+   * Sets the dictionary to compress and decompress with. Only the last
+   * 64 KB of the dictionary are used.
+   * @param  dictionary   the dictionary. An empty dictionary disables
+   *                      dictionary compression.
+   **/
+  void set_dictionary(const std::string& dictionary);
+
+  /**
+   * Returns the dictionary
+   * @return  the dictionary
+   **/
+  std::string get_dictionary(void) const;
 
   /**
    * Encodes the buffer in place using LZ4 compression
@@ -62,8 +123,71 @@ public:
    **/
   virtual uint32_t get_version(void);
 
-  /// the size of the decompress buffer (max size)
-  int buffer_size = 10000000;
+  /**
+   * Returns the number of payloads sent raw because they did not
+   * compress or compression was being skipped
+   * @return  the number of raw payloads
+   **/
+  uint64_t get_raw_count(void) const;
+
+  /// the LZ4 acceleration. Higher values compress faster but less.
+  int acceleration = 1;
+
+  /// payloads smaller than this are sent raw without trying to compress
+  int min_size = 64;
+
+  /**
+   * after this many payloads in a row fail to compress, the next
+   * skip_count payloads are sent raw without trying, e.g., when
+   * sending encrypted or already compressed data. 0 always tries.
+   **/
+  int skip_after = 4;
+
+  /// the number of payloads to send raw once skipping starts
+  int skip_count = 16;
+
+private:
+  /**
+   * Buffers used by one call to encode or decode
+   **/
+  struct Scratch
+  {
+    /// the compressed payload
+    std::vector<char> buffer;
+
+    /// the LZ4 compression state
+    std::vector<char> state;
+  };
+
+  /**
+   * Takes scratch buffers that no other call is using
+   * @return  the scratch buffers
+   **/
+  std::unique_ptr<Scratch> acquire(void) const;
+
+  /**
+   * Returns scratch buffers for reuse
+   * @param  scratch   the scratch buffers
+   **/
+  void release(std::unique_ptr<Scratch> scratch) const;
+
+  /// the dictionary
+  std::string dictionary_;
+
+  /// the id of the dictionary, which the decoder checks
+  uint32_t dictionary_id_ = 0;
+
+  /// scratch buffers not in use
+  mutable std::vector<std::unique_ptr<Scratch>> scratch_;
+
+  /// payloads that failed to compress in a row, or skips remaining if < 0
+  mutable std::atomic<int> incompressible_;
+
+  /// the number of raw payloads
+  mutable std::atomic<uint64_t> raw_count_;
+
+  /// guards the scratch buffers
+  mutable MADARA_LOCK_TYPE mutex_;
 };
 }
 }
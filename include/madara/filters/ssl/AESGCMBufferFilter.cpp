@@ -0,0 +1,362 @@
+
+#ifdef _USE_SSL_
+
+#include <algorithm>
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include "AESGCMBufferFilter.h"
+
+#include "madara/utility/Utility.h"
+
+#include "madara/logger/GlobalLogger.h"
+
+namespace
+{
+/**
+ * Seeds the nonce of a filter. The prefix tells filters that share a key
+ * apart, and the counter starts at a random value so filters that do get
+ * the same prefix are unlikely to reach the same nonces.
+ **/
+void seed_nonce(unsigned char* prefix, std::atomic<uint64_t>& counter)
+{
+  uint64_t start = 0;
+
+  if (RAND_bytes(prefix, 4) != 1 ||
+      RAND_bytes((unsigned char*)&start, sizeof(start)) != 1)
+  {
+    madara_logger_ptr_log(madara::logger::global_logger.get_ptr(),
+        madara::logger::LOG_ERROR,
+        "AESGCMBufferFilter: Unable to seed nonces from RAND_bytes. "
+        "Using the clock instead.\n");
+
+    start = (uint64_t)madara::utility::get_time();
+    memcpy(prefix, &start, 4);
+  }
+
+  counter = start;
+}
+}
+
+madara::filters::AESGCMBufferFilter::AESGCMBufferFilter()
+  : generation_(0), nonce_counter_(0)
+{
+  memset(key_, 0, sizeof(key_));
+  seed_nonce(nonce_prefix_, nonce_counter_);
+}
+
+madara::filters::AESGCMBufferFilter::AESGCMBufferFilter(
+    const AESGCMBufferFilter& input)
+  : generation_(0), nonce_counter_(0)
+{
+  MADARA_GUARD_TYPE guard(input.mutex_);
+
+  memcpy(key_, input.key_, sizeof(key_));
+  seed_nonce(nonce_prefix_, nonce_counter_);
+}
+
+madara::filters::AESGCMBufferFilter::AESGCMBufferFilter(
+    unsigned char* key, int key_length)
+  : generation_(0), nonce_counter_(0)
+{
+  memset(key_, 0, sizeof(key_));
+  memcpy(key_, key, std::min((int)sizeof(key_), key_length));
+  seed_nonce(nonce_prefix_, nonce_counter_);
+}
+
+madara::filters::AESGCMBufferFilter::~AESGCMBufferFilter()
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  clear_contexts();
+}
+
+void madara::filters::AESGCMBufferFilter::clear_contexts(void)
+{
+  for (auto context : encrypt_contexts_)
+  {
+    EVP_CIPHER_CTX_free(context);
+  }
+
+  for (auto context : decrypt_contexts_)
+  {
+    EVP_CIPHER_CTX_free(context);
+  }
+
+  encrypt_contexts_.clear();
+  decrypt_contexts_.clear();
+}
+
+int madara::filters::AESGCMBufferFilter::generate_key(
+    const std::string& password)
+{
+  int i, rounds = 10000;
+
+  // the salt is fixed, so that peers derive the same key from the same
+  // password. The IV is not needed, since each message has a nonce
+  int64_t salt = 0x70e4ed2d19a447ef;
+  unsigned char key[32];
+  unsigned char iv[16];
+
+  i = EVP_BytesToKey(EVP_aes_256_gcm(), EVP_sha256(), (unsigned char*)&salt,
+      (unsigned char*)password.c_str(), (int)password.length(), rounds, key,
+      iv);
+
+  if (i != 32)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        " Unable to initialize 256 bit AES-GCM. Only received %d bytes.\n", i);
+
+    return -1;
+  }
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  memcpy(key_, key, sizeof(key_));
+
+  // contexts initialized with the old key cannot be reused, including
+  // those that are in use now and released later
+  ++generation_;
+  clear_contexts();
+
+  return 0;
+}
+
+EVP_CIPHER_CTX* madara::filters::AESGCMBufferFilter::acquire(
+    std::vector<EVP_CIPHER_CTX*>& contexts, bool encrypt,
+    uint64_t& generation) const
+{
+  unsigned char key[32];
+
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    generation = generation_;
+
+    if (contexts.size() > 0)
+    {
+      EVP_CIPHER_CTX* context = contexts.back();
+      contexts.pop_back();
+      return context;
+    }
+
+    memcpy(key, key_, sizeof(key));
+  }
+
+  EVP_CIPHER_CTX* context = EVP_CIPHER_CTX_new();
+
+  // the cipher and key are set once, so each message only sets its nonce
+  int result = 0;
+
+  if (context != 0)
+  {
+    if (encrypt)
+    {
+      result = EVP_EncryptInit_ex(context, EVP_aes_256_gcm(), NULL, key, NULL);
+    }
+    else
+    {
+      result = EVP_DecryptInit_ex(context, EVP_aes_256_gcm(), NULL, key, NULL);
+    }
+  }
+
+  if (result != 1)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "AESGCMBufferFilter::acquire: Cannot init cipher context. "
+        "Result=%d.\n",
+        result);
+
+    EVP_CIPHER_CTX_free(context);
+
+    return 0;
+  }
+
+  return context;
+}
+
+void madara::filters::AESGCMBufferFilter::release(
+    std::vector<EVP_CIPHER_CTX*>& contexts, EVP_CIPHER_CTX* context,
+    uint64_t generation) const
+{
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if (generation == generation_)
+    {
+      contexts.push_back(context);
+      return;
+    }
+  }
+
+  EVP_CIPHER_CTX_free(context);
+}
+
+int madara::filters::AESGCMBufferFilter::encode(
+    char* source, int size, int max_size) const
+{
+  if (size < 0 || size + nonce_size + tag_size > max_size)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "AESGCMBufferFilter::encode: %d bytes cannot fit in %d byte "
+        "buffer.\n",
+        size + nonce_size + tag_size, max_size);
+
+    return 0;
+  }
+
+  uint64_t generation = 0;
+  EVP_CIPHER_CTX* context = acquire(encrypt_contexts_, true, generation);
+
+  if (context == 0)
+  {
+    return 0;
+  }
+
+  unsigned char* nonce = (unsigned char*)source;
+  unsigned char* text = nonce + nonce_size;
+  uint64_t counter = nonce_counter_++;
+
+  memmove(text, source, size);
+  memcpy(nonce, nonce_prefix_, 4);
+  memcpy(nonce + 4, &counter, sizeof(counter));
+
+  int len = 0;
+  int ciphertext_len = 0;
+
+  int result = EVP_EncryptInit_ex(context, NULL, NULL, NULL, nonce);
+
+  if (result == 1)
+  {
+    result = EVP_EncryptUpdate(context, text, &len, text, size);
+    ciphertext_len = len;
+  }
+
+  if (result == 1)
+  {
+    result = EVP_EncryptFinal_ex(context, text + ciphertext_len, &len);
+    ciphertext_len += len;
+  }
+
+  if (result == 1)
+  {
+    result = EVP_CIPHER_CTX_ctrl(
+        context, EVP_CTRL_GCM_GET_TAG, tag_size, text + ciphertext_len);
+  }
+
+  if (result != 1)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "AESGCMBufferFilter::encode: Cannot perform encrypt. Result=%d.\n",
+        result);
+
+    // the context may be in an unknown state, so do not reuse it
+    EVP_CIPHER_CTX_free(context);
+
+    return 0;
+  }
+
+  release(encrypt_contexts_, context, generation);
+
+  madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
+      "AESGCMBufferFilter::encode: size=%d, ciphertext_len=%d.\n", size,
+      ciphertext_len);
+
+  return nonce_size + ciphertext_len + tag_size;
+}
+
+int madara::filters::AESGCMBufferFilter::decode(
+    char* source, int size, int max_size) const
+{
+  size = std::min(size, max_size);
+
+  if (size < nonce_size + tag_size)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "AESGCMBufferFilter::decode: %d bytes is too short for a nonce "
+        "and tag.\n",
+        size);
+
+    return 0;
+  }
+
+  uint64_t generation = 0;
+  EVP_CIPHER_CTX* context = acquire(decrypt_contexts_, false, generation);
+
+  if (context == 0)
+  {
+    return 0;
+  }
+
+  unsigned char* nonce = (unsigned char*)source;
+  unsigned char* text = nonce + nonce_size;
+  int ciphertext_len = size - nonce_size - tag_size;
+
+  int len = 0;
+  int plaintext_len = 0;
+
+  int result = EVP_DecryptInit_ex(context, NULL, NULL, NULL, nonce);
+
+  if (result == 1)
+  {
+    result = EVP_DecryptUpdate(context, text, &len, text, ciphertext_len);
+    plaintext_len = len;
+  }
+
+  if (result == 1)
+  {
+    result = EVP_CIPHER_CTX_ctrl(
+        context, EVP_CTRL_GCM_SET_TAG, tag_size, text + ciphertext_len);
+  }
+
+  if (result != 1)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_ERROR,
+        "AESGCMBufferFilter::decode: Cannot perform decrypt. Result=%d.\n",
+        result);
+
+    EVP_CIPHER_CTX_free(context);
+
+    return 0;
+  }
+
+  // the final step checks the tag, failing if the message was modified
+  result = EVP_DecryptFinal_ex(context, text + plaintext_len, &len);
+
+  release(decrypt_contexts_, context, generation);
+
+  if (result != 1)
+  {
+    madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MAJOR,
+        "AESGCMBufferFilter::decode: Message failed authentication. "
+        "Dropping it.\n");
+
+    return 0;
+  }
+
+  plaintext_len += len;
+
+  memmove(source, text, plaintext_len);
+
+  madara_logger_ptr_log(logger::global_logger.get_ptr(), logger::LOG_MINOR,
+      "AESGCMBufferFilter::decode: size=%d, plaintext_len=%d.\n", size,
+      plaintext_len);
+
+  return plaintext_len;
+}
+
+std::string madara::filters::AESGCMBufferFilter::get_id(void)
+{
+  return "aesgcm";
+}
+
+/**
+ * Gets the version of the filter. @see madara::utility::get_uint_version
+ * for one way to get this from a string version
+ **/
+uint32_t madara::filters::AESGCMBufferFilter::get_version(void)
+{
+  return madara::utility::get_uint_version("1.0.0");
+}
+
+#endif  // _USE_SSL_
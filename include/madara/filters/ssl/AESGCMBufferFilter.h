@@ -0,0 +1,171 @@
+
+#ifndef _MADARA_FILTERS_SSL_AES_GCM_H_
+#define _MADARA_FILTERS_SSL_AES_GCM_H_
+
+/**
+ * @file AESGCMBufferFilter.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a filter functor for authenticated 256 bit AES-GCM
+ * encryption
+ **/
+
+#ifdef _USE_SSL_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "madara/LockType.h"
+#include "madara/utility/StdInt.h"
+#include "madara/MadaraExport.h"
+#include "../BufferFilter.h"
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace madara
+{
+namespace filters
+{
+/**
+ * @class AESGCMBufferFilter
+ * @brief Encrypts and authenticates a buffer with 256 bit AES in GCM
+ *        mode via OpenSSL. Every message has its own nonce, and messages
+ *        that were modified or encrypted with another key fail to decode.
+ *        Cipher contexts are initialized with the key once and reused
+ *        across messages, one per concurrent caller.
+ *
+ *        Format:
+ *
+ *        [12 byte nonce]<br />
+ *        [ciphertext, the same size as the plaintext]<br />
+ *        [16 byte authentication tag]
+ */
+class MADARA_EXPORT AESGCMBufferFilter : public BufferFilter
+{
+public:
+  /// the size of the nonce
+  static const int nonce_size = 12;
+
+  /// the size of the authentication tag
+  static const int tag_size = 16;
+
+  /**
+   * Constructor
+   **/
+  AESGCMBufferFilter();
+
+  /**
+   * Copy constructor
+   * @param  input   the buffer filter to copy
+   **/
+  AESGCMBufferFilter(const AESGCMBufferFilter& input);
+
+  /**
+   * 256 bit key constructor
+   * @param  key         the key to use for encryption
+   * @param  key_length  the length of the key
+   **/
+  AESGCMBufferFilter(unsigned char* key, int key_length);
+
+  /**
+   * Destructor
+   **/
+  virtual ~AESGCMBufferFilter();
+
+  /**
+   * Generates a 256 bit key from a password. Messages that other threads
+   * are encoding or decoding meanwhile may use the old key, but no
+   * message after this returns does.
+   * @param  password   a password to seed the key with
+   * @return  0 on success, -1 on error
+   **/
+  int generate_key(const std::string& password);
+
+  /**
+   * Encodes the buffer in place using AES-GCM encryption
+   * @param   source           the source and destination buffer
+   * @param   size             the amount of data in the buffer in bytes
+   * @param   max_size         the amount of bytes the buffer can hold
+   * @return  the new size after encoding, which is 28 bytes more than
+   *          size, or 0 on error
+   **/
+  virtual int encode(char* source, int size, int max_size) const;
+
+  /**
+   * Decodes the buffer in place using AES-GCM decryption
+   * @param   source           the source and destination buffer
+   * @param   size             the amount of data in the buffer in bytes
+   * @param   max_size         the amount of bytes the buffer can hold
+   * @return  the new size after decoding, or 0 if the buffer could not
+   *          be authenticated
+   **/
+  virtual int decode(char* source, int size, int max_size) const;
+
+  /**
+   * Gets the id of the filter. This is used in the serialization process
+   * for transports and checkpoints to identify which filter is used.
+   **/
+  virtual std::string get_id(void);
+
+  /**
+   * Gets the version of the filter. @see madara::utility::get_uint_version
+   * for one way to get this from a string version
+   **/
+  virtual uint32_t get_version(void);
+
+private:
+  /**
+   * Takes a cipher context that no other call is using, initializing
+   * it with the key if needed
+   * @param  contexts   the encrypt or decrypt contexts
+   * @param  encrypt    true to take an encryption context
+   * @param  generation set to the key generation of the context
+   * @return  the context, or 0 on error
+   **/
+  EVP_CIPHER_CTX* acquire(std::vector<EVP_CIPHER_CTX*>& contexts,
+      bool encrypt, uint64_t& generation) const;
+
+  /**
+   * Returns a cipher context for reuse, or frees it if the key changed
+   * since it was acquired
+   * @param  contexts   the encrypt or decrypt contexts
+   * @param  context    the context
+   * @param  generation the key generation of the context
+   **/
+  void release(std::vector<EVP_CIPHER_CTX*>& contexts,
+      EVP_CIPHER_CTX* context, uint64_t generation) const;
+
+  /**
+   * Frees the cached cipher contexts, e.g., after the key changes. The
+   * mutex must be held.
+   **/
+  void clear_contexts(void);
+
+  /// the user's cypher key, guarded by the mutex
+  unsigned char key_[32];
+
+  /// the number of times the key was set, guarded by the mutex
+  uint64_t generation_;
+
+  /// the random first bytes of every nonce of this filter
+  unsigned char nonce_prefix_[4];
+
+  /// the count of messages, which makes up the rest of the nonce
+  mutable std::atomic<uint64_t> nonce_counter_;
+
+  /// encryption contexts not in use
+  mutable std::vector<EVP_CIPHER_CTX*> encrypt_contexts_;
+
+  /// decryption contexts not in use
+  mutable std::vector<EVP_CIPHER_CTX*> decrypt_contexts_;
+
+  /// guards the key and the contexts
+  mutable MADARA_LOCK_TYPE mutex_;
+};
+}
+}
+
+#endif  // _USE_SSL_
+
+#endif  // _MADARA_FILTERS_SSL_AES_GCM_H_
@@ -0,0 +1,51 @@
+#include "ArrayDelta.h"
+#include "KnowledgeRecord.h"
+
+namespace madara
+{
+namespace knowledge
+{
+namespace
+{
+template<typename T>
+std::vector<T> patch(std::vector<T> array,
+    const std::vector<DirtyRanges::Range>& ranges, const std::vector<T>& values)
+{
+  auto value = values.begin();
+
+  for (auto& range : ranges)
+  {
+    for (uint32_t i = range.first; i < range.second; ++i)
+    {
+      array[i] = *value++;
+    }
+  }
+
+  return array;
+}
+}  // namespace
+
+bool ArrayDelta::apply(
+    const KnowledgeRecord& base, KnowledgeRecord& record) const
+{
+  if (base.type() != type || base.size() != size ||
+      base.clock != base_clock)
+  {
+    return false;
+  }
+
+  if (type == KnowledgeRecord::INTEGER_ARRAY)
+  {
+    record.emplace_integers(patch(base.to_integers(), ranges, integers));
+  }
+  else
+  {
+    record.emplace_doubles(patch(base.to_doubles(), ranges, doubles));
+  }
+
+  record.set_toi(toi);
+
+  return true;
+}
+}
+}
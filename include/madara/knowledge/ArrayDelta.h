@@ -0,0 +1,91 @@
+#ifndef _MADARA_KNOWLEDGE_ARRAY_DELTA_H_
+#define _MADARA_KNOWLEDGE_ARRAY_DELTA_H_
+
+/**
+ * @file ArrayDelta.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the ArrayDelta class, a received array delta that
+ * is kept apart from the array it patches until the message holding it
+ * is applied.
+ */
+
+#include <vector>
+
+#include "madara/MadaraExport.h"
+#include "madara/knowledge/DirtyRanges.h"
+#include "madara/utility/StdInt.h"
+
+namespace madara
+{
+namespace knowledge
+{
+class KnowledgeRecord;
+
+/**
+ * The changed ranges of an array and their new values, as read from an
+ * array delta (@see KnowledgeRecord::write_delta). Decoding a delta does
+ * not need the receiver's array, so messages can be decoded in parallel
+ * and the delta patched onto the array when its message is applied.
+ **/
+class MADARA_EXPORT ArrayDelta
+{
+public:
+  /**
+   * Checks if a delta has been read
+   * @return  true if this holds a delta
+   **/
+  bool exists(void) const
+  {
+    return type != 0;
+  }
+
+  /**
+   * Clears the delta
+   **/
+  void clear(void)
+  {
+    type = 0;
+    size = 0;
+    base_clock = 0;
+    toi = 0;
+    ranges.clear();
+    integers.clear();
+    doubles.clear();
+  }
+
+  /**
+   * Patches a copy of the array the delta was encoded against
+   * @param  base    the receiver's current value of the array, which must
+   *                 have the type, size and clock of the delta's base
+   * @param  record  set to the patched array and the delta's toi. The
+   *                 clock and quality are unchanged.
+   * @return  true if the base matched and record was set
+   **/
+  bool apply(const KnowledgeRecord& base, KnowledgeRecord& record) const;
+
+  /// INTEGER_ARRAY or DOUBLE_ARRAY, or 0 if no delta has been read
+  uint32_t type = 0;
+
+  /// the number of elements in the array
+  uint32_t size = 0;
+
+  /// the clock of the array the delta was encoded against
+  uint64_t base_clock = 0;
+
+  /// the toi of the patched array on the sender
+  uint64_t toi = 0;
+
+  /// the changed ranges, which lie within the array
+  std::vector<DirtyRanges::Range> ranges;
+
+  /// the values of the ranges of an INTEGER_ARRAY, in order
+  std::vector<int64_t> integers;
+
+  /// the values of the ranges of a DOUBLE_ARRAY, in order
+  std::vector<double> doubles;
+};
+}
+}
+
+#endif  // _MADARA_KNOWLEDGE_ARRAY_DELTA_H_
@@ -1,5 +1,7 @@
 #include <fstream>
 #include <chrono>
+#include <vector>
+#include <algorithm>
 
 #include "madara/logger/GlobalLogger.h"
 #include "madara/exceptions/MemoryException.h"
@@ -160,6 +162,104 @@ void CheckpointReader::start()
 
   stage = 1;
   state = 0;
+  first_state = checkpoint_settings.initial_state;
+
+  if (checkpoint_settings.seek_keyframe && first_state > 0)
+  {
+    seek_keyframe(first_state);
+  }
+}
+
+bool CheckpointReader::read_state_header(
+    size_t offset, uint64_t size, transport::MessageHeader& header)
+{
+  // without buffer filters, the header is readable in place
+  size_t bytes = checkpoint_settings.buffer_filters.size() == 0
+                     ? (size_t)transport::MessageHeader::static_encoded_size()
+                     : (size_t)size;
+
+  if (bytes > size)
+  {
+    return false;
+  }
+
+  std::vector<char> contents(std::max(bytes, (size_t)max_buffer));
+
+  file.seekg(offset, file.beg);
+
+  if (!file.read(contents.data(), bytes))
+  {
+    file.clear();
+    return false;
+  }
+
+  int64_t remaining = (int64_t)bytes;
+
+  if (checkpoint_settings.buffer_filters.size() > 0)
+  {
+    remaining = (int64_t)checkpoint_settings.decode(
+        contents.data(), (int)bytes, (int)contents.size());
+  }
+
+  if (remaining < (int64_t)transport::MessageHeader::static_encoded_size())
+  {
+    return false;
+  }
+
+  header.read(contents.data(), remaining);
+
+  return true;
+}
+
+void CheckpointReader::seek_keyframe(uint64_t target)
+{
+  size_t offset = checkpoint_start;
+  size_t keyframe_offset = checkpoint_start;
+  uint64_t keyframe_state = 0;
+
+  for (uint64_t i = 0; i <= target && i < meta.states; ++i)
+  {
+    uint64_t size;
+
+    file.seekg(offset, file.beg);
+
+    if (!file.read((char*)&size, sizeof(size)))
+    {
+      file.clear();
+      break;
+    }
+
+    size = utility::endian_swap(size);
+
+    if (checkpoint_settings.buffer_filters.size() > 0)
+    {
+      size += filters::BufferFilterHeader::encoded_size();
+    }
+
+    transport::MessageHeader header;
+
+    if (!read_state_header(offset, size, header))
+    {
+      break;
+    }
+
+    if (header.type == KEYFRAME)
+    {
+      keyframe_offset = offset;
+      keyframe_state = i;
+    }
+
+    offset += (size_t)size;
+  }
+
+  madara_logger_ptr_log(logger_, logger::LOG_MINOR,
+      "CheckpointReader::seek_keyframe:"
+      " starting at keyframe state %d for state %d\n",
+      (int)keyframe_state, (int)target);
+
+  checkpoint_start = keyframe_offset;
+  state = keyframe_state;
+  first_state = keyframe_state;
 }
 
 std::pair<std::string, KnowledgeRecord> CheckpointReader::next()
@@ -367,11 +467,10 @@ std::pair<std::string, KnowledgeRecord> CheckpointReader::next()
       madara_logger_ptr_log(logger_, logger::LOG_MINOR,
           "CheckpointReader::next:"
           " state=%d, initial_state=%d, last_state=%d\n",
-          (int)state, (int)checkpoint_settings.initial_state,
+          (int)state, (int)first_state,
           (int)checkpoint_settings.last_state);
 
-      if (state <= checkpoint_settings.last_state &&
-          state >= checkpoint_settings.initial_state)
+      if (state <= checkpoint_settings.last_state && state >= first_state)
       {
         stage = 2;
         update = 0;
@@ -10,6 +10,7 @@
 #include "madara/knowledge/CheckpointSettings.h"
 #include "madara/knowledge/FileHeader.h"
 #include "madara/transport/MessageHeader.h"
+#include "madara/transport/TransportSettings.h"
 #include "madara/utility/StlHelper.h"
 
 /**
@@ -53,6 +54,25 @@ public:
    **/
   std::pair<std::string, KnowledgeRecord> next();
 
+  /**
+   * Get the index of the state that held the record last returned by
+   * next. Only valid after next has returned a record.
+   **/
+  uint64_t get_state() const
+  {
+    return state - 1;
+  }
+
+  /**
+   * Check if the state that held the record last returned by next is a
+   * keyframe, i.e., holds every variable saved as of that state. Only
+   * valid after next has returned a record.
+   **/
+  bool is_keyframe() const
+  {
+    return checkpoint_header.type == KEYFRAME;
+  }
+
   /**
    * Get total number of bytes read so far during iteration.
    **/
@@ -93,6 +113,22 @@ public:
   }
 
 private:
+  /**
+   * Moves the reader to the last keyframe at or before a state
+   * @param target  the state of interest
+   **/
+  void seek_keyframe(uint64_t target);
+
+  /**
+   * Reads the header of the state at a file offset
+   * @param offset  the file offset of the state
+   * @param size    the encoded size of the state
+   * @param header  the header to fill in
+   * @return  true if the header could be read
+   **/
+  bool read_state_header(
+      size_t offset, uint64_t size, transport::MessageHeader& header);
+
   CheckpointSettings& checkpoint_settings;
 
   logger::Logger* logger_;
@@ -106,6 +142,7 @@ private:
   char* current;
   size_t checkpoint_start;
   uint64_t state;
+  uint64_t first_state;
   uint64_t checkpoint_size;
   transport::MessageHeader checkpoint_header;
   uint64_t update;
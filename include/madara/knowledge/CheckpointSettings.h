@@ -26,6 +26,17 @@ namespace knowledge
 class ThreadSafeContext;
 class VariablesLister;
 
+/**
+ * Types of checkpoint states, stored in the type of the state header.
+ * States of changes keep the transport::MULTIASSIGN type of the message
+ * header, so these types must not overlap transport::Messages.
+ **/
+enum CheckpointStateTypes
+{
+  /// a state holding every variable saved as of that state
+  KEYFRAME = 4
+};
+
 /**
  * @class CheckpointSettings
  * @brief Holds settings for checkpoints to load or save. Most of the
@@ -347,7 +358,10 @@ public:
   }
 
   /**
-   * the size of the buffer needed for the checkpoint
+   * the size of the buffer needed for the checkpoint. Without buffer
+   * filters, saves stream through a buffer of this size, so it only
+   * needs to hold the largest single record. Buffer filters encode a
+   * whole state at once, so with filters it must hold the whole state.
    **/
   size_t buffer_size;
 
@@ -457,6 +471,40 @@ public:
    **/
   bool playback_simtime = false;
 
+  /**
+   * If non-zero, save_checkpoint writes a keyframe, i.e., a state with
+   * every variable in the context, as every keyframe_interval-th state
+   * of the file. The states in between hold only the changes since the
+   * previous state. Readers with seek_keyframe can then rebuild any
+   * state from the nearest keyframe rather than from the first state.
+   **/
+  uint64_t keyframe_interval = 0;
+
+  /**
+   * If true, loads and reads begin at the last keyframe at or before
+   * initial_state instead of at initial_state itself, so that the
+   * knowledge as of initial_state is fully reconstructed. To rebuild
+   * only state N, set initial_state and last_state to N.
+   **/
+  bool seek_keyframe = false;
+
+  /**
+   * If true, saves copy the records to write out of the context while
+   * holding its lock and encode and write them after releasing it. The
+   * copies share array and string values with the context, so the lock
+   * is held only for the copy rather than for the file I/O.
+   **/
+  bool snapshot = false;
+
+  /**
+   * If greater than one, save_as_karl and save_as_json take a snapshot
+   * (@see snapshot) and format it on this many threads, each formatting
+   * a shard of the key space. Shards are written to the file in key
+   * order as they complete, so the output is identical to a sequential
+   * save and only a few shards are held in memory at a time.
+   **/
+  uint32_t format_threads = 0;
+
   /**
    * Object which will be used to extract variables for checkpoint saving.
    * By default (if left nullptr), use a default implementation which uses
@@ -0,0 +1,156 @@
+#ifndef _MADARA_KNOWLEDGE_DIRTY_RANGES_H_
+#define _MADARA_KNOWLEDGE_DIRTY_RANGES_H_
+
+/**
+ * @file DirtyRanges.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the DirtyRanges class, which tracks the index ranges
+ * of an array record that have changed since it was last sent, so that
+ * transports can send array deltas instead of whole arrays.
+ */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "madara/utility/StdInt.h"
+
+namespace madara
+{
+namespace knowledge
+{
+/**
+ * A sorted, coalesced list of half-open index ranges [start, end). The
+ * number of ranges is bounded by max_ranges: past that, the two ranges
+ * separated by the smallest gap are merged, trading a few unchanged
+ * elements on the wire for bounded tracking cost.
+ **/
+class DirtyRanges
+{
+public:
+  /// a half-open range of indices [first, second)
+  typedef std::pair<uint32_t, uint32_t> Range;
+
+  /// the maximum number of disjoint ranges tracked
+  static const size_t max_ranges = 32;
+
+  /**
+   * Adds a range of modified indices
+   * @param  start   the first modified index
+   * @param  count   the number of modified indices
+   **/
+  void add(size_t start, size_t count = 1)
+  {
+    if (count == 0)
+      return;
+
+    Range added((uint32_t)start, (uint32_t)(start + count));
+
+    // find the first range that could touch the new one
+    auto cur = ranges_.begin();
+    while (cur != ranges_.end() && cur->second < added.first)
+      ++cur;
+
+    // absorb all ranges that overlap or abut the new range
+    auto last = cur;
+    while (last != ranges_.end() && last->first <= added.second)
+    {
+      added.first = std::min(added.first, last->first);
+      added.second = std::max(added.second, last->second);
+      ++last;
+    }
+
+    cur = ranges_.erase(cur, last);
+    ranges_.insert(cur, added);
+
+    if (ranges_.size() > max_ranges)
+    {
+      merge_closest();
+    }
+  }
+
+  /**
+   * Clears all ranges
+   **/
+  void clear(void)
+  {
+    ranges_.clear();
+  }
+
+  /**
+   * Checks if no ranges are dirty
+   **/
+  bool empty(void) const
+  {
+    return ranges_.empty();
+  }
+
+  /**
+   * Returns the total number of dirty indices
+   **/
+  size_t count(void) const
+  {
+    size_t result = 0;
+
+    for (auto& range : ranges_)
+      result += range.second - range.first;
+
+    return result;
+  }
+
+  /**
+   * Returns one past the highest dirty index
+   **/
+  size_t end(void) const
+  {
+    return ranges_.empty() ? 0 : ranges_.back().second;
+  }
+
+  /**
+   * Returns the sorted, disjoint ranges
+   **/
+  const std::vector<Range>& ranges(void) const
+  {
+    return ranges_;
+  }
+
+  /// the time of last update of the record when the ranges were taken
+  uint64_t toi = 0;
+
+private:
+  /**
+   * Merges the two neighboring ranges with the smallest gap
+   **/
+  void merge_closest(void)
+  {
+    size_t best = 0;
+    uint32_t best_gap = (uint32_t)-1;
+
+    for (size_t i = 0; i + 1 < ranges_.size(); ++i)
+    {
+      uint32_t gap = ranges_[i + 1].first - ranges_[i].second;
+
+      if (gap < best_gap)
+      {
+        best_gap = gap;
+        best = i;
+      }
+    }
+
+    ranges_[best].second = ranges_[best + 1].second;
+    ranges_.erase(ranges_.begin() + best + 1);
+  }
+
+  /// sorted, disjoint, non-adjacent ranges
+  std::vector<Range> ranges_;
+};
+
+/// dirty ranges of array records, keyed by variable name
+typedef std::map<std::string, DirtyRanges> DirtyRangesMap;
+}
+}
+
+#endif  // _MADARA_KNOWLEDGE_DIRTY_RANGES_H_
@@ -134,6 +134,12 @@ struct MADARA_EXPORT EvalSettings : public KnowledgeUpdateSettings
   {
   }
 
+  /**
+   * Assignment operator
+   * @param   rhs   Eval settings instance to copy
+   **/
+  EvalSettings& operator=(const EvalSettings& rhs) = default;
+
   /**
    * Toggle for sending modifieds in a single update event
    * after each evaluation.
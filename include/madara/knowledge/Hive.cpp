@@ -46,16 +46,28 @@
 
 
 #include "Hive.h"
+#include "madara/knowledge/ContextGuard.h"
 #include "madara/transport/QoSTransportSettings.h"
 #include "madara/transport/SharedMemoryPush.h"
+#include "madara/utility/Utility.h"
 
 
 madara::knowledge::Hive::Hive()
+  : mode_(PUSH), threads_(1), steps_(0), task_size_(0), next_task_(0),
+    busy_(0), generation_(0), terminated_(false)
 {
 }
 
+madara::knowledge::Hive::Hive(Modes mode, size_t threads)
+  : mode_(mode), threads_(1), steps_(0), task_size_(0), next_task_(0),
+    busy_(0), generation_(0), terminated_(false)
+{
+  set_threads(threads);
+}
+
 madara::knowledge::Hive::~Hive()
 {
+  stop_workers();
 }
 
 void
@@ -67,6 +79,16 @@ madara::knowledge::Hive::resize(size_t new_size)
   {
     kbs_.resize(new_size);
 
+    if (neighbors_.size() > 0)
+    {
+      neighbors_.resize(new_size);
+    }
+
+    if (mode_ == STEPPED)
+    {
+      return;
+    }
+
     for (auto transport : transports_)
     {
       if (transport != 0)
@@ -93,3 +115,296 @@ madara::knowledge::Hive::resize(size_t new_size)
     } // if old < new
   } // if new != old
 }
+
+void
+madara::knowledge::Hive::set_threads(size_t threads)
+{
+  stop_workers();
+
+  if (threads == 0)
+  {
+    threads = std::thread::hardware_concurrency();
+  }
+
+  threads_ = threads > 0 ? threads : 1;
+}
+
+void
+madara::knowledge::Hive::set_neighbors(
+  size_t agent, const std::vector<size_t>& neighbors)
+{
+  if (neighbors_.size() < kbs_.size())
+  {
+    neighbors_.resize(kbs_.size());
+  }
+
+  if (agent < neighbors_.size())
+  {
+    neighbors_[agent] = neighbors;
+  }
+}
+
+void
+madara::knowledge::Hive::clear_neighbors(void)
+{
+  neighbors_.clear();
+}
+
+void
+madara::knowledge::Hive::step(const AgentLogic& logic)
+{
+  if (mode_ == PUSH)
+  {
+    for (size_t i = 0; i < kbs_.size(); ++i)
+    {
+      logic(kbs_[i], i);
+      kbs_[i].send_modifieds("Hive::step");
+    }
+  }
+  else
+  {
+    std::shared_ptr<UpdateLog> log = std::make_shared<UpdateLog>(kbs_.size());
+    std::exception_ptr error;
+
+    // 1. run the logic of each agent and take its modifications
+    try
+    {
+      run_parallel(kbs_.size(), [&](size_t agent) {
+        static const std::map<std::string, bool> send_all;
+
+        logic(kbs_[agent], agent);
+
+        ThreadSafeContext& context = kbs_[agent].get_context();
+        (*log)[agent] = context.get_modifieds_current(send_all, true);
+
+        if ((*log)[agent].size() > 0)
+        {
+          context.inc_clock();
+        }
+      });
+    }
+    catch (...)
+    {
+      // the modifications of the other agents were already taken, so
+      // they must still be applied or they would be lost
+      error = std::current_exception();
+    }
+
+    std::shared_ptr<const UpdateLog> updates(log);
+
+    // 2. apply the now immutable log to each agent
+    run_parallel(kbs_.size(), [&](size_t agent) {
+      apply_updates(agent, *updates);
+    });
+
+    {
+      MADARA_GUARD_TYPE guard(pool_mutex_);
+      last_updates_ = updates;
+    }
+
+    if (error)
+    {
+      ++steps_;
+      std::rethrow_exception(error);
+    }
+  }
+
+  ++steps_;
+}
+
+std::shared_ptr<const madara::knowledge::Hive::UpdateLog>
+madara::knowledge::Hive::get_last_updates(void) const
+{
+  MADARA_GUARD_TYPE guard(pool_mutex_);
+  return last_updates_;
+}
+
+void
+madara::knowledge::Hive::apply_updates(size_t agent, const UpdateLog& updates)
+{
+  const std::vector<size_t>* neighbors = 0;
+
+  if (agent < neighbors_.size() && neighbors_[agent].size() > 0)
+  {
+    neighbors = &neighbors_[agent];
+  }
+
+  size_t senders = neighbors ? neighbors->size() : updates.size();
+
+  ThreadSafeContext& context = kbs_[agent].get_context();
+  bool changed = false;
+
+  {
+    ContextGuard guard(kbs_[agent]);
+
+    uint64_t now = utility::get_time();
+
+    for (size_t i = 0; i < senders; ++i)
+    {
+      size_t sender = neighbors ? (*neighbors)[i] : i;
+
+      // agents do not receive their own updates
+      if (sender == agent || sender >= updates.size())
+      {
+        continue;
+      }
+
+      for (auto& update : updates[sender])
+      {
+        KnowledgeRecord record(update.second);
+
+        record.set_toi(now);
+        record.apply(context, update.first, update.second.quality,
+          update.second.clock, false);
+
+        changed = true;
+      }
+    }
+  }
+
+  // wake up waiters, as a transport does after applying a message
+  if (changed)
+  {
+    context.set_changed();
+  }
+}
+
+void
+madara::knowledge::Hive::run_parallel(
+  size_t count, const std::function<void(size_t)>& task)
+{
+  if (threads_ <= 1 || count < 2)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      task(i);
+    }
+
+    return;
+  }
+
+  start_workers();
+
+  {
+    MADARA_GUARD_TYPE guard(pool_mutex_);
+
+    task_ = task;
+    task_size_ = count;
+    next_task_ = 0;
+    busy_ = workers_.size();
+    error_ = nullptr;
+    ++generation_;
+  }
+
+  work_ready_.MADARA_CONDITION_NOTIFY_ALL();
+
+  // the caller works on the task too
+  run_tasks();
+
+  std::exception_ptr error;
+
+  {
+    std::unique_lock<MADARA_LOCK_TYPE> lock(pool_mutex_);
+
+    work_done_.wait(lock, [this] { return busy_ == 0; });
+
+    task_ = nullptr;
+    error = error_;
+    error_ = nullptr;
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+void
+madara::knowledge::Hive::run_tasks(void)
+{
+  for (size_t i = next_task_++; i < task_size_; i = next_task_++)
+  {
+    try
+    {
+      task_(i);
+    }
+    catch (...)
+    {
+      MADARA_GUARD_TYPE guard(pool_mutex_);
+
+      if (!error_)
+      {
+        error_ = std::current_exception();
+      }
+    }
+  }
+}
+
+void
+madara::knowledge::Hive::run_worker(uint64_t seen)
+{
+  for (;;)
+  {
+    {
+      std::unique_lock<MADARA_LOCK_TYPE> lock(pool_mutex_);
+
+      work_ready_.wait(
+        lock, [&] { return terminated_ || generation_ != seen; });
+
+      if (terminated_)
+      {
+        return;
+      }
+
+      seen = generation_;
+    }
+
+    run_tasks();
+
+    MADARA_GUARD_TYPE guard(pool_mutex_);
+
+    if (--busy_ == 0)
+    {
+      work_done_.MADARA_CONDITION_NOTIFY_ONE();
+    }
+  }
+}
+
+void
+madara::knowledge::Hive::start_workers(void)
+{
+  if (workers_.size() == 0 && threads_ > 1)
+  {
+    uint64_t generation;
+
+    {
+      MADARA_GUARD_TYPE guard(pool_mutex_);
+      terminated_ = false;
+      generation = generation_;
+    }
+
+    for (size_t i = 1; i < threads_; ++i)
+    {
+      workers_.push_back(
+        std::thread([this, generation] { run_worker(generation); }));
+    }
+  }
+}
+
+void
+madara::knowledge::Hive::stop_workers(void)
+{
+  {
+    MADARA_GUARD_TYPE guard(pool_mutex_);
+    terminated_ = true;
+  }
+
+  work_ready_.MADARA_CONDITION_NOTIFY_ALL();
+
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+
+  workers_.clear();
+}
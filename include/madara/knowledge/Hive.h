@@ -45,7 +45,15 @@
  *      distribution.
  **/
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "KnowledgeBase.h"
+#include "madara/LockType.h"
 #include "madara/transport/SharedMemoryPush.h"
 #include "madara/MadaraExport.h"
 
@@ -61,16 +69,52 @@ namespace madara
   namespace knowledge
   {
     /**
-     * Knowledge bases linked with shared memory to a central hive concept
+     * Knowledge bases linked with shared memory to a central hive concept.
+     * In the default PUSH mode, each knowledge base is linked to all others
+     * with a SharedMemoryPush transport that copies every send into every
+     * other knowledge base in the sender's thread. In STEPPED mode, the
+     * knowledge bases are not linked by transports. Instead, step runs the
+     * logic of all agents in parallel on a pool of threads, gathers the
+     * modifications of each agent into an immutable update log, and then
+     * applies the log to each knowledge base in parallel, optionally
+     * limited to the neighborhood of each agent.
      **/
     class MADARA_EXPORT Hive
     {
     public:
+      /**
+       * Ways that the knowledge bases of the hive exchange updates
+       **/
+      enum Modes
+      {
+        PUSH = 0,
+        STEPPED = 1
+      };
+
+      /**
+       * Logic for one agent in a step, which receives the knowledge base
+       * and index of the agent
+       **/
+      typedef std::function<void(KnowledgeBase&, size_t)> AgentLogic;
+
+      /**
+       * The modifications of each agent in a step, indexed by agent
+       **/
+      typedef std::vector<KnowledgeMap> UpdateLog;
+
       /**
        * Default constructor
        **/
       Hive();
 
+      /**
+       * Constructor
+       * @param  mode     how the knowledge bases exchange updates
+       * @param  threads  threads used by step in STEPPED mode. 0 uses
+       *                  the hardware concurrency of the host.
+       **/
+      Hive(Modes mode, size_t threads = 0);
+
       /**
        * Destructor
        **/
@@ -104,18 +148,174 @@ namespace madara
         return kbs_.size();
       }
 
+      /**
+       * Returns the mode of the hive
+       * @return how the knowledge bases exchange updates
+       **/
+      inline Modes get_mode(void) const
+      {
+        return mode_;
+      }
+
+      /**
+       * Returns the number of threads used by step
+       * @return the number of threads, including the caller of step
+       **/
+      inline size_t get_threads(void) const
+      {
+        return threads_;
+      }
+
+      /**
+       * Returns the number of steps taken
+       * @return the number of calls to step
+       **/
+      inline uint64_t get_steps(void) const
+      {
+        return steps_;
+      }
+
       /**
        * Resizes the hive to a certain number of shared knowledge bases
        * @param  new_size  the number of linked knowledge bases to create
        **/
       void resize(size_t new_size);
 
+      /**
+       * Sets the number of threads used by step. Must not be called
+       * during a step.
+       * @param  threads  the number of threads. 0 uses the hardware
+       *                  concurrency of the host.
+       **/
+      void set_threads(size_t threads);
+
+      /**
+       * Limits the agents that an agent receives updates from in STEPPED
+       * mode, e.g., to the agents within communication range. An agent
+       * without a neighborhood, the default, receives updates from every
+       * agent.
+       * @param  agent      the index of the receiving agent
+       * @param  neighbors  the indices of the agents it receives from
+       **/
+      void set_neighbors(size_t agent, const std::vector<size_t>& neighbors);
+
+      /**
+       * Removes all neighborhoods, so every agent receives updates from
+       * every other agent
+       **/
+      void clear_neighbors(void);
+
+      /**
+       * Runs the logic of every agent once. In PUSH mode, the agents run
+       * in order on the calling thread and send their modifications after
+       * their logic. In STEPPED mode, the agents run in parallel, and then
+       * their modifications are applied to the other knowledge bases in
+       * parallel, so the updates of a step are seen by all agents in the
+       * next step. Exceptions thrown by the logic are rethrown to the
+       * caller after the agents of the phase have finished. In STEPPED
+       * mode, the modifications of the other agents are still applied
+       * and the step is counted before the exception is rethrown.
+       * @param  logic  the logic of each agent
+       **/
+      void step(const AgentLogic& logic);
+
+      /**
+       * Returns the update log of the most recent step in STEPPED mode
+       * @return the modifications of each agent, or null before a step
+       **/
+      std::shared_ptr<const UpdateLog> get_last_updates(void) const;
+
     private:
+      /**
+       * Runs a task for each index in [0, count) on the thread pool and
+       * the calling thread, and waits for all of them to finish
+       * @param  count  the number of indices
+       * @param  task   the task to run for each index
+       **/
+      void run_parallel(size_t count, const std::function<void(size_t)>& task);
+
+      /**
+       * Runs tasks of the current run_parallel until none are left
+       **/
+      void run_tasks(void);
+
+      /**
+       * The loop of a thread in the pool
+       * @param  seen  the generation of the last task before the thread
+       *               started
+       **/
+      void run_worker(uint64_t seen);
+
+      /**
+       * Starts the threads of the pool, if not started
+       **/
+      void start_workers(void);
+
+      /**
+       * Stops and joins the threads of the pool
+       **/
+      void stop_workers(void);
+
+      /**
+       * Applies the updates of the other agents to an agent
+       * @param  agent    the index of the receiving agent
+       * @param  updates  the update log of the step
+       **/
+      void apply_updates(size_t agent, const UpdateLog& updates);
+
       /// Knowledge base
       std::vector<madara::knowledge::KnowledgeBase> kbs_;
 
       /// transports meant for fast memory transport within the controller
       std::vector<madara::transport::SharedMemoryPush*> transports_;
+
+      /// how the knowledge bases exchange updates
+      Modes mode_;
+
+      /// threads used by step, including the caller
+      size_t threads_;
+
+      /// the number of steps taken
+      uint64_t steps_;
+
+      /// the agents each agent receives from. Empty means all agents.
+      std::vector<std::vector<size_t>> neighbors_;
+
+      /// the update log of the most recent step
+      std::shared_ptr<const UpdateLog> last_updates_;
+
+      /// threads of the pool, not including the caller of step
+      std::vector<std::thread> workers_;
+
+      /// guards the state of the pool
+      mutable MADARA_LOCK_TYPE pool_mutex_;
+
+      /// signaled when a new task is ready or the pool terminates
+      MADARA_CONDITION_TYPE work_ready_;
+
+      /// signaled when the last worker finishes a task
+      MADARA_CONDITION_TYPE work_done_;
+
+      /// the task of the current run_parallel
+      std::function<void(size_t)> task_;
+
+      /// the number of indices of the current task
+      size_t task_size_;
+
+      /// the next index of the current task to run
+      std::atomic<size_t> next_task_;
+
+      /// the number of workers that have not finished the current task
+      size_t busy_;
+
+      /// incremented for each task, so workers can tell new tasks apart
+      uint64_t generation_;
+
+      /// true if the workers should exit
+      bool terminated_;
+
+      /// the first exception thrown by the current task
+      std::exception_ptr error_;
     };
   }  // namespace knowledge
-}  // namespace madara
\ No newline at end of file
+}  // namespace madara
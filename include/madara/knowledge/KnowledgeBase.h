@@ -192,6 +192,133 @@ public:
       const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
           false));
 
+  /**
+   * Atomically gets the current value of a variable as a native type,
+   * e.g., get_as<double>, without copying its KnowledgeRecord.
+   * @param key              knowledge location
+   * @param settings         settings for referring to knowledge variables
+   * @return                 value at knowledge location
+   **/
+  template<typename T>
+  T get_as(const std::string& key,
+      const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
+          false));
+
+  /**
+   * Atomically gets the current value of a variable as a native type,
+   * e.g., get_as<double>, without copying its KnowledgeRecord.
+   * @param   variable  reference to a variable (@see get_ref)
+   * @param   settings  the settings for referring to variables
+   * @return            the value of the variable
+   **/
+  template<typename T>
+  T get_as(const VariableReference& variable,
+      const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
+          false));
+
+  /**
+   * Atomically reads several variables into native values under one lock
+   * of the context, e.g., get_many (x_ref, x, y_ref, y, z_ref, z)
+   * @param   variable  reference to the first variable (@see get_ref)
+   * @param   value     the value to read the first variable into
+   * @param   rest      further pairs of references and values
+   **/
+  template<typename T, typename... Args>
+  void get_many(const VariableReference& variable, T& value, Args&&... rest);
+
+  /**
+   * Atomically sets the value of a variable from a native type, e.g.,
+   * set_as<int64_t>. Integral types are stored as Integer and floating
+   * point types as double.
+   * @param   key       the variable name
+   * @param   value     new value of the variable
+   * @param   settings  settings for applying the update
+   * @return   0 if the value was set. -1 if null key
+   **/
+  template<typename T>
+  int set_as(const std::string& key, const T& value,
+      const EvalSettings& settings = EvalSettings(
+          true, false, true, false, false));
+
+  /**
+   * Atomically sets the value of a variable from a native type, e.g.,
+   * set_as<int64_t>. Integral types are stored as Integer and floating
+   * point types as double.
+   * @param   variable  reference to a variable (@see get_ref)
+   * @param   value     new value of the variable
+   * @param   settings  settings for applying the update
+   * @return   0 if the value was set. -1 if null key
+   **/
+  template<typename T>
+  int set_as(const VariableReference& variable, const T& value,
+      const EvalSettings& settings = EvalSettings(
+          true, false, true, false, false));
+
+  /**
+   * Atomically returns references to several variables, e.g., to read
+   * or write them together with get_all and set_all
+   * @param   keys      unique identifiers of the variables
+   * @param   settings  the settings for referring to variables
+   * @return  references in the order of the keys
+   **/
+  VariableReferences get_refs(const std::vector<std::string>& keys,
+      const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
+          false));
+
+  /**
+   * Atomically reads the values of several variables while the context
+   * is locked once. The values are a consistent snapshot.
+   * @param   variables references to the variables (@see get_refs)
+   * @param   values    the values, in the order of the references
+   * @param   settings  the settings for referring to variables
+   **/
+  void get_all(const VariableReferences& variables,
+      std::vector<KnowledgeRecord>& values,
+      const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
+          false));
+
+  /**
+   * Atomically reads the values of several variables while the context
+   * is locked once. Variables that do not exist are read as empty records
+   * and are not created.
+   * @param   keys      unique identifiers of the variables
+   * @param   values    the values, in the order of the keys
+   * @param   settings  the settings for referring to variables
+   **/
+  void get_all(const std::vector<std::string>& keys,
+      std::vector<KnowledgeRecord>& values,
+      const KnowledgeReferenceSettings& settings = KnowledgeReferenceSettings(
+          false));
+
+  /**
+   * Atomically sets the values of several variables while the context is
+   * locked once, then sends the modifications once
+   * @param   variables references to the variables (@see get_refs)
+   * @param   values    the new values, in the order of the references
+   * @param   settings  settings for applying the update
+   * @return   0 if all values were set. -1 if the number of values does
+   *           not match or a reference is invalid. -2 if the quality of
+   *           a variable is too low.
+   **/
+  int set_all(const VariableReferences& variables,
+      const std::vector<KnowledgeRecord>& values,
+      const EvalSettings& settings = EvalSettings(
+          true, false, true, false, false));
+
+  /**
+   * Atomically sets the values of several variables while the context is
+   * locked once, then sends the modifications once
+   * @param   keys      unique identifiers of the variables
+   * @param   values    the new values, in the order of the keys
+   * @param   settings  settings for applying the update
+   * @return   0 if all values were set, or the error of set_all with
+   *           references
+   **/
+  int set_all(const std::vector<std::string>& keys,
+      const std::vector<KnowledgeRecord>& values,
+      const EvalSettings& settings = EvalSettings(
+          true, false, true, false, false));
+
   /**
    * @return a shared_ptr, sharing with the internal one.
    * If this record is not a string, returns NULL shared_ptr
@@ -1442,6 +1569,36 @@ public:
       const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
           true, true, true, false));
 
+  /**
+   * Loads a JSON file, e.g., from save_as_json, without evaluating it
+   * as KaRL. Nested objects become dotted variable names, arrays of
+   * numbers become native arrays and other arrays become name.0 to
+   * name.N-1 plus name.size.
+   * @param   filename    name of the file to open
+   * @param   settings    settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   **/
+  int64_t load_as_json(const std::string& filename,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
+  /**
+   * Loads a JSON file, e.g., from save_as_json, without evaluating it
+   * as KaRL
+   * @param   checkpoint_settings  the filename, buffer filters and
+   *                               clear_knowledge setting to load with
+   * @param   update_settings      settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   * @throw exceptions::FilterException  a buffer filter failed
+   **/
+  int64_t load_as_json(CheckpointSettings& checkpoint_settings,
+      const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
   /**
    * Loads and evaluates a karl script from a file
    * @param   checkpoint_settings  checkpoint settings to load
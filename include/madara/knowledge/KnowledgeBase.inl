@@ -286,6 +286,122 @@ inline VariableReference KnowledgeBase::get_ref(
   return var;
 }
 
+template<typename T>
+inline T KnowledgeBase::get_as(
+    const std::string& key, const KnowledgeReferenceSettings& settings)
+{
+  return get_context().get_as<T>(key, settings);
+}
+
+template<typename T>
+inline T KnowledgeBase::get_as(const VariableReference& variable,
+    const KnowledgeReferenceSettings& settings)
+{
+  return get_context().get_as<T>(variable, settings);
+}
+
+template<typename T, typename... Args>
+inline void KnowledgeBase::get_many(
+    const VariableReference& variable, T& value, Args&&... rest)
+{
+  get_context().get_many(variable, value, std::forward<Args>(rest)...);
+}
+
+template<typename T>
+inline int KnowledgeBase::set_as(
+    const std::string& key, const T& value, const EvalSettings& settings)
+{
+  int result = 0;
+
+  if (impl_.get())
+  {
+    result = impl_->set(key,
+        static_cast<typename impl::storage_type<T>::type>(value), settings);
+  }
+  else if (context_)
+  {
+    result = context_->set_as(key, value, settings);
+  }
+
+  return result;
+}
+
+template<typename T>
+inline int KnowledgeBase::set_as(const VariableReference& variable,
+    const T& value, const EvalSettings& settings)
+{
+  int result = 0;
+
+  if (impl_.get())
+  {
+    result = impl_->set(variable,
+        static_cast<typename impl::storage_type<T>::type>(value), settings);
+  }
+  else if (context_)
+  {
+    result = context_->set_as(variable, value, settings);
+  }
+
+  return result;
+}
+
+inline VariableReferences KnowledgeBase::get_refs(
+    const std::vector<std::string>& keys,
+    const KnowledgeReferenceSettings& settings)
+{
+  return get_context().get_refs(keys, settings);
+}
+
+inline void KnowledgeBase::get_all(const VariableReferences& variables,
+    std::vector<KnowledgeRecord>& values,
+    const KnowledgeReferenceSettings& settings)
+{
+  get_context().get_all(variables, values, settings);
+}
+
+inline void KnowledgeBase::get_all(const std::vector<std::string>& keys,
+    std::vector<KnowledgeRecord>& values,
+    const KnowledgeReferenceSettings& settings)
+{
+  get_context().get_all(keys, values, settings);
+}
+
+inline int KnowledgeBase::set_all(const VariableReferences& variables,
+    const std::vector<KnowledgeRecord>& values, const EvalSettings& settings)
+{
+  int result = 0;
+
+  if (impl_.get())
+  {
+    result = impl_->get_context().set_all(variables, values, settings);
+    impl_->send_modifieds("KnowledgeBase::set_all", settings);
+  }
+  else if (context_)
+  {
+    result = context_->set_all(variables, values, settings);
+  }
+
+  return result;
+}
+
+inline int KnowledgeBase::set_all(const std::vector<std::string>& keys,
+    const std::vector<KnowledgeRecord>& values, const EvalSettings& settings)
+{
+  int result = 0;
+
+  if (impl_.get())
+  {
+    result = impl_->get_context().set_all(keys, values, settings);
+    impl_->send_modifieds("KnowledgeBase::set_all", settings);
+  }
+  else if (context_)
+  {
+    result = context_->set_all(keys, values, settings);
+  }
+
+  return result;
+}
+
 inline KnowledgeRecord KnowledgeBase::get(const VariableReference& variable,
     const KnowledgeReferenceSettings& settings)
 {
@@ -1723,6 +1839,41 @@ inline int64_t KnowledgeBase::load_context(
   return result;
 }
 
+inline int64_t KnowledgeBase::load_as_json(
+    const std::string& filename, const KnowledgeUpdateSettings& settings)
+{
+  int64_t result = 0;
+
+  if (context_)
+  {
+    result = context_->load_as_json(filename, settings);
+  }
+  else if (impl_.get())
+  {
+    result = impl_->load_as_json(filename, settings);
+  }
+
+  return result;
+}
+
+inline int64_t KnowledgeBase::load_as_json(
+    CheckpointSettings& checkpoint_settings,
+    const KnowledgeUpdateSettings& update_settings)
+{
+  int64_t result = 0;
+
+  if (context_)
+  {
+    result = context_->load_as_json(checkpoint_settings, update_settings);
+  }
+  else if (impl_.get())
+  {
+    result = impl_->load_as_json(checkpoint_settings, update_settings);
+  }
+
+  return result;
+}
+
 inline madara::knowledge::KnowledgeRecord KnowledgeBase::evaluate_file(
     CheckpointSettings& checkpoint_settings,
     const KnowledgeUpdateSettings& update_settings)
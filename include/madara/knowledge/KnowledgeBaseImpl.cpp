@@ -462,8 +462,23 @@ int KnowledgeBaseImpl::send_modifieds(
 
       if (modified.size() == 0)
       {
-        madara_logger_log(map_.get_logger(), logger::LOG_DETAILED,
-            "%s: no modifications to send\n", prefix.c_str());
+        // updates delayed by a send bandwidth limit still need a send
+        bool delayed = false;
+
+        for (auto& transport : transports)
+        {
+          if (transport->has_delayed_sends())
+          {
+            delayed = true;
+            transport->send_data(modified);
+          }
+        }
+
+        if (!delayed)
+        {
+          madara_logger_log(map_.get_logger(), logger::LOG_DETAILED,
+              "%s: no modifications to send\n", prefix.c_str());
+        }
 
         return -1;
       }
@@ -941,6 +941,36 @@ public:
       const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
           true, true, true, false));
 
+  /**
+   * Loads a JSON file, e.g., from save_as_json, without evaluating it
+   * as KaRL. Nested objects become dotted variable names, arrays of
+   * numbers become native arrays and other arrays become name.0 to
+   * name.N-1 plus name.size.
+   * @param   filename    name of the file to open
+   * @param   settings    settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   **/
+  int64_t load_as_json(const std::string& filename,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
+  /**
+   * Loads a JSON file, e.g., from save_as_json, without evaluating it
+   * as KaRL
+   * @param   checkpoint_settings  the filename, buffer filters and
+   *                               clear_knowledge setting to load with
+   * @param   update_settings      settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   * @throw exceptions::FilterException  a buffer filter failed
+   **/
+  int64_t load_as_json(CheckpointSettings& checkpoint_settings,
+      const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
   /**
    * Loads and evaluates a karl script from a file
    * @param   checkpoint_settings  checkpoint settings to load
@@ -620,6 +620,19 @@ inline int64_t KnowledgeBaseImpl::load_context(
   return result;
 }
 
+inline int64_t KnowledgeBaseImpl::load_as_json(
+    const std::string& filename, const KnowledgeUpdateSettings& settings)
+{
+  return map_.load_as_json(filename, settings);
+}
+
+inline int64_t KnowledgeBaseImpl::load_as_json(
+    CheckpointSettings& checkpoint_settings,
+    const KnowledgeUpdateSettings& update_settings)
+{
+  return map_.load_as_json(checkpoint_settings, update_settings);
+}
+
 inline madara::knowledge::KnowledgeRecord KnowledgeBaseImpl::evaluate_file(
     CheckpointSettings& checkpoint_settings,
     const KnowledgeUpdateSettings& update_settings)
@@ -239,6 +239,28 @@ simple_span<T> make_span(T* ptr, size_t size)
   return {ptr, size};
 }
 
+/// The type a value is passed to KnowledgeRecord::set_value as. Integral
+/// types and enums are stored as Integer, floating point types as double,
+/// and other types, e.g., std::string, are passed by reference.
+template<typename T, typename = void>
+struct storage_type
+{
+  using type = const T&;
+};
+
+template<typename T>
+struct storage_type<T,
+    utility::enable_if_<std::is_integral<T>::value || std::is_enum<T>::value>>
+{
+  using type = KnowledgeRecord::Integer;
+};
+
+template<typename T>
+struct storage_type<T, utility::enable_if_<std::is_floating_point<T>::value>>
+{
+  using type = double;
+};
+
 template<typename T>
 struct is_basic_string : std::false_type
 {
@@ -2,6 +2,7 @@
 #define _KNOWLEDGE_RECORD_CPP_
 
 #include "madara/knowledge/KnowledgeRecord.h"
+#include "madara/knowledge/ArrayDelta.h"
 #include "madara/knowledge/ThreadSafeContext.h"
 
 #include "madara/utility/Utility.h"
@@ -1378,6 +1379,322 @@ int KnowledgeRecord::apply(ThreadSafeContext& context, const std::string& key,
   return result;
 }
 
+namespace
+{
+/**
+ * Copies a 32 bit value to the buffer in network byte order
+ **/
+inline void write_uint32(char*& buffer, uint32_t value)
+{
+  value = utility::endian_swap(value);
+  memcpy(buffer, &value, sizeof(value));
+  buffer += sizeof(value);
+}
+
+/**
+ * Copies a 32 bit value in network byte order from the buffer
+ **/
+inline uint32_t read_uint32(const char*& buffer)
+{
+  uint32_t value;
+  memcpy(&value, buffer, sizeof(value));
+  buffer += sizeof(value);
+  return utility::endian_swap(value);
+}
+
+/**
+ * Writes the elements of each range of an array
+ **/
+template<typename T>
+inline void write_ranges(
+    char*& buffer, const std::vector<T>& array, const DirtyRanges& ranges)
+{
+  for (auto& range : ranges.ranges())
+  {
+    for (uint32_t i = range.first; i < range.second; ++i)
+    {
+      T value = utility::endian_swap(array[i]);
+      memcpy(buffer, &value, sizeof(value));
+      buffer += sizeof(value);
+    }
+  }
+}
+
+/**
+ * Reads the values of the ranges of an array delta from a buffer
+ **/
+template<typename T>
+inline void read_ranges(const char* buffer,
+    const std::vector<DirtyRanges::Range>& ranges, std::vector<T>& values)
+{
+  for (auto& range : ranges)
+  {
+    for (uint32_t i = range.first; i < range.second; ++i)
+    {
+      T value;
+      memcpy(&value, buffer, sizeof(value));
+      buffer += sizeof(value);
+      values.push_back(utility::endian_swap(value));
+    }
+  }
+}
+}  // namespace
+
+int64_t KnowledgeRecord::get_encoded_delta_size(
+    const std::string& key, const DirtyRanges& ranges) const
+{
+  // key_size, key, type, ranges, toi, base_clock and total
+  int64_t buffer_size = sizeof(uint32_t) + key.size() + 1 + sizeof(type_) +
+                        sizeof(uint32_t) + sizeof(toi_) + sizeof(uint64_t) +
+                        sizeof(uint32_t);
+
+  buffer_size += ranges.ranges().size() * 2 * sizeof(uint32_t);
+  buffer_size += ranges.count() * sizeof(double);
+
+  return buffer_size;
+}
+
+char* KnowledgeRecord::write_delta(char* buffer, const std::string& key,
+    const DirtyRanges& ranges, uint64_t base_clock,
+    int64_t& buffer_remaining) const
+{
+  if (has_history() && !buf_->empty())
+  {
+    return ref_newest().write_delta(
+        buffer, key, ranges, base_clock, buffer_remaining);
+  }
+
+  int64_t encoded_size = get_encoded_delta_size(key, ranges);
+
+  if (!is_array_type(type_) || ranges.end() > size())
+  {
+    std::stringstream local_buffer;
+    local_buffer << "KnowledgeRecord::write_delta: ";
+    local_buffer << key << " of type " << type_ << " and size " << size();
+    local_buffer << " cannot hold ranges ending at " << ranges.end() << "\n";
+
+    madara_logger_ptr_log(
+        logger_, logger::LOG_ERROR, local_buffer.str().c_str());
+
+    throw exceptions::MemoryException(local_buffer.str());
+  }
+
+  if (buffer_remaining < encoded_size)
+  {
+    std::stringstream local_buffer;
+    local_buffer << "KnowledgeRecord::write_delta: ";
+    local_buffer << encoded_size << " byte encoding cannot fit in ";
+    local_buffer << buffer_remaining << " byte buffer\n";
+
+    madara_logger_ptr_log(
+        logger_, logger::LOG_ERROR, local_buffer.str().c_str());
+
+    throw exceptions::MemoryException(local_buffer.str());
+  }
+
+  madara_logger_ptr_log(logger_, logger::LOG_MINOR,
+      "KnowledgeRecord::write_delta:"
+      " encoding %" PRId64 " byte delta of %s (%zu of %" PRIu32
+      " elements)\n",
+      encoded_size, key.c_str(), ranges.count(), size());
+
+  // format is [key_size | key | type | ranges | toi | base_clock | total |
+  //            ranges | values]
+  uint32_t key_size = uint32_t(key.size() + 1);
+
+  write_uint32(buffer, key_size);
+  utility::strncpy_safe(buffer, key.c_str(), key_size);
+  buffer += key_size;
+
+  write_uint32(buffer, type_ | ARRAY_DELTA);
+  write_uint32(buffer, (uint32_t)ranges.ranges().size());
+
+  decltype(toi_) toi_temp = utility::endian_swap(toi_);
+  memcpy(buffer, &toi_temp, sizeof(toi_temp));
+  buffer += sizeof(toi_temp);
+
+  base_clock = utility::endian_swap(base_clock);
+  memcpy(buffer, &base_clock, sizeof(base_clock));
+  buffer += sizeof(base_clock);
+
+  write_uint32(buffer, size());
+
+  for (auto& range : ranges.ranges())
+  {
+    write_uint32(buffer, range.first);
+    write_uint32(buffer, range.second - range.first);
+  }
+
+  if (type_ == INTEGER_ARRAY)
+  {
+    write_ranges(buffer, *int_array_, ranges);
+  }
+  else
+  {
+    write_ranges(buffer, *double_array_, ranges);
+  }
+
+  buffer_remaining -= encoded_size;
+
+  return buffer;
+}
+
+const char* KnowledgeRecord::read(const char* buffer, std::string& key,
+    int64_t& buffer_remaining, const ThreadSafeContext& context)
+{
+  ArrayDelta delta;
+
+  buffer = read(buffer, key, buffer_remaining, delta);
+
+  if (delta.exists())
+  {
+    KnowledgeRecord base =
+        context.get(key, KnowledgeReferenceSettings(false));
+
+    if (!delta.apply(base, *this))
+    {
+      madara_logger_ptr_log(logger_, logger::LOG_MAJOR,
+          "KnowledgeRecord::read:"
+          " unable to apply delta to %s (type %" PRIu32 ", %" PRIu32
+          " elements, clock %" PRIu64 "). Base has type %" PRIu32
+          ", %" PRIu32 " elements and clock %" PRIu64 ".\n",
+          key.c_str(), delta.type, delta.size, delta.base_clock, base.type(),
+          base.size(), base.clock);
+    }
+  }
+
+  return buffer;
+}
+
+const char* KnowledgeRecord::read(const char* buffer, std::string& key,
+    int64_t& buffer_remaining, ArrayDelta& delta)
+{
+  const char* start = buffer;
+
+  delta.clear();
+
+  // peek at the type, which follows the key, to find array deltas
+  uint32_t key_size = 0;
+  uint32_t type = 0;
+
+  if (buffer_remaining >= (int64_t)sizeof(key_size))
+  {
+    key_size = read_uint32(buffer);
+
+    if (buffer_remaining >= (int64_t)(sizeof(key_size) + sizeof(type)) +
+                                key_size)
+    {
+      buffer += key_size;
+      type = read_uint32(buffer);
+    }
+  }
+
+  if ((type & ARRAY_DELTA) == 0)
+  {
+    return read(start, key, buffer_remaining);
+  }
+
+  key.assign(start + sizeof(key_size), key_size > 0 ? key_size - 1 : 0);
+  buffer_remaining -= sizeof(key_size) + key_size + sizeof(type);
+
+  type &= ~(uint32_t)ARRAY_DELTA;
+
+  clear_value();
+
+  uint64_t base_clock = 0;
+  uint64_t toi = 0;
+
+  // the fixed part of the delta is [ranges | toi | base_clock | total]
+  if (buffer_remaining < (int64_t)(sizeof(uint32_t) * 2 + sizeof(toi) +
+                                   sizeof(base_clock)))
+  {
+    buffer_remaining = -1;
+    return buffer;
+  }
+
+  uint32_t num_ranges = read_uint32(buffer);
+
+  memcpy(&toi, buffer, sizeof(toi));
+  toi = utility::endian_swap(toi);
+  buffer += sizeof(toi);
+
+  memcpy(&base_clock, buffer, sizeof(base_clock));
+  base_clock = utility::endian_swap(base_clock);
+  buffer += sizeof(base_clock);
+
+  uint32_t total = read_uint32(buffer);
+
+  buffer_remaining -=
+      sizeof(uint32_t) * 2 + sizeof(toi) + sizeof(base_clock);
+
+  if (buffer_remaining < (int64_t)num_ranges * 2 * (int64_t)sizeof(uint32_t))
+  {
+    buffer_remaining = -1;
+    return buffer;
+  }
+
+  std::vector<DirtyRanges::Range> ranges;
+  ranges.reserve(num_ranges);
+
+  uint64_t count = 0;
+  bool valid = type == INTEGER_ARRAY || type == DOUBLE_ARRAY;
+
+  for (uint32_t i = 0; i < num_ranges; ++i)
+  {
+    uint32_t first = read_uint32(buffer);
+    uint32_t length = read_uint32(buffer);
+
+    if ((uint64_t)first + length > total)
+      valid = false;
+
+    ranges.emplace_back(first, first + length);
+    count += length;
+  }
+
+  buffer_remaining -= num_ranges * 2 * sizeof(uint32_t);
+
+  int64_t values_size = (int64_t)count * (int64_t)sizeof(double);
+
+  if (buffer_remaining < values_size)
+  {
+    buffer_remaining = -1;
+    return buffer;
+  }
+
+  if (!valid)
+  {
+    madara_logger_ptr_log(logger_, logger::LOG_MAJOR,
+        "KnowledgeRecord::read:"
+        " dropping malformed delta of %s (type %" PRIu32 ", %" PRIu32
+        " elements).\n",
+        key.c_str(), type, total);
+  }
+  else
+  {
+    delta.type = type;
+    delta.size = total;
+    delta.base_clock = base_clock;
+    delta.toi = toi;
+    delta.ranges = std::move(ranges);
+
+    if (type == INTEGER_ARRAY)
+    {
+      delta.integers.reserve((size_t)count);
+      read_ranges(buffer, delta.ranges, delta.integers);
+    }
+    else
+    {
+      delta.doubles.reserve((size_t)count);
+      read_ranges(buffer, delta.ranges, delta.doubles);
+    }
+  }
+
+  buffer += values_size;
+  buffer_remaining -= values_size;
+
+  return buffer;
+}
+
 bool KnowledgeRecord::is_true(void) const
 {
   madara_logger_ptr_log(logger_, logger::LOG_MAJOR,
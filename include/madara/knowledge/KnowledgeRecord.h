@@ -22,6 +22,7 @@
 #include "madara/logger/GlobalLogger.h"
 #include "madara/utility/IntTypes.h"
 #include "madara/utility/CircularBuffer.h"
+#include "madara/knowledge/DirtyRanges.h"
 #include "madara/exceptions/IndexException.h"
 
 namespace madara
@@ -29,6 +30,7 @@ namespace madara
 namespace knowledge
 {
 class ThreadSafeContext;
+class ArrayDelta;
 
 /**
  * Tags to specify what type to construct in KnowledgeRecord forwarding
@@ -125,6 +127,9 @@ public:
     ALL_TEXT_FORMATS = XML | TEXT_FILE | STRING,
     ALL_TYPES = ALL_PRIMITIVE_TYPES | ALL_FILE_TYPES,
     ALL_CLEARABLES = ALL_ARRAYS | ALL_TEXT_FORMATS | ALL_FILE_TYPES,
+    // wire-only flag combined with INTEGER_ARRAY or DOUBLE_ARRAY to
+    // mark an encoding of changed index ranges (@see write_delta)
+    ARRAY_DELTA = (1UL << 30),
     BUFFER = (1UL << 31),
   };
 
@@ -200,6 +205,13 @@ private:
    **/
   mutable bool shared_ = OWNED;
 
+  /**
+   * modification flags owned by the ThreadSafeContext holding this record
+   * (e.g., whether the record is queued to send or checkpoint). These are
+   * never copied or moved between records.
+   **/
+  uint8_t context_flags_ = 0;
+
 public:
   /* default constructor */
   KnowledgeRecord() noexcept : KnowledgeRecord(*logger::global_logger.get()) {}
@@ -560,6 +572,15 @@ public:
    **/
   void unshare(void);
 
+  /**
+   * Marks the value of this record as shared, so that it is copied before
+   * it is next changed in place. Copies of a record only mark themselves
+   * shared, so call this before copying a record that is read after the
+   * lock guarding the original is released. For records with history,
+   * the newest value is marked.
+   **/
+  void share(void) const;
+
   /**
    * clones the record. Caller must ensure returned pointer is deleted.
    **/
@@ -1253,6 +1274,40 @@ public:
   const char* read(
       const char* buffer, uint32_t& key_id, int64_t& buffer_remaining);
 
+  /**
+   * Reads a KnowledgeRecord instance from a buffer and updates
+   * the amount of buffer room remaining. Unlike the other read methods,
+   * this method also accepts array deltas (@see write_delta), which are
+   * applied to a copy of the current value of the key in the context. A
+   * delta whose base array is missing, of a different type or size, or
+   * at a different clock than the base the sender encoded against
+   * cannot be applied, and the record is left EMPTY.
+   * @param     buffer     the readable buffer where data is stored
+   * @param     key        the name of the variable
+   * @param     buffer_remaining  the count of bytes remaining in the
+   *                              buffer to read
+   * @param     context    the context holding the base of array deltas
+   * @return    current buffer position for next read
+   **/
+  const char* read(const char* buffer, std::string& key,
+      int64_t& buffer_remaining, const ThreadSafeContext& context);
+
+  /**
+   * Reads a KnowledgeRecord instance or an array delta (@see write_delta)
+   * from a buffer and updates the amount of buffer room remaining. A
+   * delta is read into delta and the record is left EMPTY, so that the
+   * delta can be applied to its base when the message is applied
+   * (@see ArrayDelta::apply). Otherwise, delta is cleared.
+   * @param     buffer     the readable buffer where data is stored
+   * @param     key        the name of the variable
+   * @param     buffer_remaining  the count of bytes remaining in the
+   *                              buffer to read
+   * @param     delta      the array delta that was read, if any
+   * @return    current buffer position for next read
+   **/
+  const char* read(const char* buffer, std::string& key,
+      int64_t& buffer_remaining, ArrayDelta& delta);
+
   /**
    * Writes a KnowledgeRecord instance to a buffer and updates
    * the amount of buffer room remaining.
@@ -1316,6 +1371,45 @@ public:
    **/
   char* write(char* buffer, uint32_t key_id, int64_t& buffer_remaining) const;
 
+  /**
+   * Writes the changed ranges of an array record to a buffer and updates
+   * the amount of buffer room remaining. Receivers rebuild the full array
+   * by patching their current value of the key (@see read).
+   *
+   * Output Format:
+   *
+   * [key_size | key | type | ranges | toi | base_clock | total |
+   *  (start | count)* | values]<br />
+   * type = the array type, combined with ARRAY_DELTA<br />
+   * ranges = 32 bit unsigned integer, number of changed ranges<br />
+   * base_clock = 64 bit unsigned integer, clock of the base array<br />
+   * total = 32 bit unsigned integer, number of elements in the array<br />
+   * start, count = 32 bit unsigned integers, one pair per range<br />
+   * values = the elements of each range, in order
+   *
+   * @param     buffer     the readable buffer where data is stored
+   * @param     key        the name of the variable
+   * @param     ranges     the changed ranges. Must lie within the array
+   * @param     base_clock the clock receivers hold for the array the
+   *                       ranges patch, i.e., the clock of the message
+   *                       that last carried the key
+   * @param     buffer_remaining  the count of bytes remaining in the
+   *                              buffer to read
+   * @return    current buffer position for next write
+   * @throw exceptions::MemoryException  the delta does not fit the buffer
+   **/
+  char* write_delta(char* buffer, const std::string& key,
+      const DirtyRanges& ranges, uint64_t base_clock,
+      int64_t& buffer_remaining) const;
+
+  /**
+   * Returns the size of the encoding produced by write_delta
+   * @param     key        the name of the variable
+   * @param     ranges     the changed ranges
+   **/
+  int64_t get_encoded_delta_size(
+      const std::string& key, const DirtyRanges& ranges) const;
+
   /**
    * Apply the knowledge record to a context, given some quality and clock
    **/
@@ -704,6 +704,21 @@ inline void KnowledgeRecord::unshare(void)
   shared_ = OWNED;
 }
 
+inline void KnowledgeRecord::share(void) const
+{
+  if (has_history())
+  {
+    if (!buf_->empty())
+    {
+      ref_newest().share();
+    }
+  }
+  else if (is_ref_counted())
+  {
+    shared_ = SHARED;
+  }
+}
+
 inline KnowledgeRecord* KnowledgeRecord::clone(void) const
 {
   knowledge::KnowledgeRecord* result = new knowledge::KnowledgeRecord(*this);
@@ -0,0 +1,198 @@
+#include "RecordAggregate.h"
+#include "ThreadSafeContext.h"
+
+madara::knowledge::RecordAggregate::RecordAggregate(
+    Operation operation, size_t contributors)
+  : operation_(operation), values_(contributors)
+{
+}
+
+madara::knowledge::RecordAggregate::~RecordAggregate()
+{
+  if (context_ != nullptr)
+  {
+    context_->detach_aggregate(*this);
+  }
+}
+
+madara::knowledge::RecordAggregate::Operation
+madara::knowledge::RecordAggregate::get_operation(void) const
+{
+  return operation_;
+}
+
+size_t madara::knowledge::RecordAggregate::size(void) const
+{
+  return values_.size();
+}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::RecordAggregate::get_context(void) const
+{
+  return context_;
+}
+
+void madara::knowledge::RecordAggregate::apply(const Value& value, bool add)
+{
+  if (!value.exists)
+  {
+    return;
+  }
+
+  if (value.is_double)
+  {
+    doubles_ += add ? 1 : -1;
+  }
+
+  if (operation_ == SUM)
+  {
+    if (value.is_double)
+    {
+      double_sum_ += add ? value.real : -value.real;
+    }
+    else
+    {
+      integer_sum_ += add ? value.integer : -value.integer;
+    }
+  }
+  else
+  {
+    double real = value.is_double ? value.real : (double)value.integer;
+
+    if (add)
+    {
+      ordered_.insert(real);
+    }
+    else
+    {
+      ordered_.erase(ordered_.find(real));
+    }
+  }
+}
+
+void madara::knowledge::RecordAggregate::resum_doubles(void)
+{
+  double_sum_ = 0;
+
+  for (auto& value : values_)
+  {
+    if (value.exists && value.is_double)
+    {
+      double_sum_ += value.real;
+    }
+  }
+
+  double_updates_ = 0;
+}
+
+void madara::knowledge::RecordAggregate::update(
+    size_t index, const KnowledgeRecord& record)
+{
+  if (index >= values_.size())
+  {
+    return;
+  }
+
+  // records with history are rare, so copying their newest value is fine
+  KnowledgeRecord history_newest;
+
+  if (record.has_history())
+  {
+    history_newest = record.get_newest();
+  }
+
+  const KnowledgeRecord& newest =
+      record.has_history() ? history_newest : record;
+
+  Value value;
+  value.exists = newest.exists();
+
+  if (value.exists)
+  {
+    uint32_t type = newest.type();
+
+    value.is_double =
+        type == KnowledgeRecord::DOUBLE || type == KnowledgeRecord::DOUBLE_ARRAY;
+
+    if (value.is_double)
+    {
+      value.real = newest.to_double();
+    }
+    else
+    {
+      value.integer = newest.to_integer();
+    }
+  }
+
+  apply(values_[index], false);
+  apply(value, true);
+
+  values_[index] = value;
+
+  // subtracting old doubles accumulates rounding, so the double sum is
+  // recomputed after as many updates as there are contributors, which
+  // keeps updates O(1) amortized
+  if (operation_ == SUM && value.is_double &&
+      ++double_updates_ >= values_.size())
+  {
+    resum_doubles();
+  }
+}
+
+void madara::knowledge::RecordAggregate::reset(void)
+{
+  for (auto& value : values_)
+  {
+    value = Value();
+  }
+
+  integer_sum_ = 0;
+  double_sum_ = 0;
+  double_updates_ = 0;
+  doubles_ = 0;
+  ordered_.clear();
+}
+
+madara::knowledge::KnowledgeRecord madara::knowledge::RecordAggregate::get(
+    void) const
+{
+  if (operation_ == SUM)
+  {
+    if (doubles_ > 0)
+    {
+      return KnowledgeRecord((double)integer_sum_ + double_sum_);
+    }
+
+    return KnowledgeRecord(integer_sum_);
+  }
+
+  if (ordered_.empty())
+  {
+    return KnowledgeRecord();
+  }
+
+  double result = operation_ == MIN ? *ordered_.begin() : *ordered_.rbegin();
+
+  if (doubles_ > 0)
+  {
+    return KnowledgeRecord(result);
+  }
+
+  return KnowledgeRecord((KnowledgeRecord::Integer)result);
+}
+
+madara::knowledge::KnowledgeRecord::Integer
+madara::knowledge::RecordAggregate::get_integer(void) const
+{
+  if (operation_ == SUM && doubles_ == 0)
+  {
+    return integer_sum_;
+  }
+
+  return get().to_integer();
+}
+
+double madara::knowledge::RecordAggregate::get_double(void) const
+{
+  return get().to_double();
+}
@@ -0,0 +1,180 @@
+#ifndef _MADARA_KNOWLEDGE_RECORD_AGGREGATE_H_
+#define _MADARA_KNOWLEDGE_RECORD_AGGREGATE_H_
+
+/**
+ * @file RecordAggregate.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the RecordAggregate class, which maintains a sum,
+ * minimum or maximum of records as they change
+ **/
+
+#include <set>
+#include <vector>
+
+#include "madara/MadaraExport.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace madara
+{
+namespace knowledge
+{
+class ThreadSafeContext;
+
+/**
+ * @class RecordAggregate
+ * @brief Maintains the sum, minimum or maximum of a set of contributor
+ *        records. The ThreadSafeContext the aggregate is attached to
+ *        updates it whenever a contributor changes, whether locally or
+ *        from the network, so reading the result is O(1) instead of
+ *        evaluating every contributor. Contributors that do not exist
+ *        count as 0 in sums and are ignored by minimums and maximums.
+ *        The result is an integer unless a contributor is a double.
+ *
+ *        Other than the constructor and destructor, methods must be
+ *        called with the context locked.
+ **/
+class MADARA_EXPORT RecordAggregate
+{
+public:
+  /**
+   * The ways to aggregate contributors
+   **/
+  enum Operation
+  {
+    SUM = 0,
+    MIN = 1,
+    MAX = 2
+  };
+
+  /**
+   * Constructor
+   * @param  operation     the way to aggregate contributors
+   * @param  contributors  the number of contributors
+   **/
+  RecordAggregate(Operation operation = SUM, size_t contributors = 0);
+
+  /**
+   * Destructor, which detaches the aggregate from its context
+   **/
+  ~RecordAggregate();
+
+  /// aggregates are attached by address, so they are not copied
+  RecordAggregate(const RecordAggregate&) = delete;
+  RecordAggregate& operator=(const RecordAggregate&) = delete;
+
+  /**
+   * Returns the way contributors are aggregated
+   * @return  the operation
+   **/
+  Operation get_operation(void) const;
+
+  /**
+   * Returns the number of contributors
+   * @return  the number of contributors
+   **/
+  size_t size(void) const;
+
+  /**
+   * Updates the value of a contributor
+   * @param  index    the index of the contributor
+   * @param  record   the new value, or an empty record if the contributor
+   *                  no longer exists
+   **/
+  void update(size_t index, const KnowledgeRecord& record);
+
+  /**
+   * Forgets the values of all contributors, e.g., when the context is
+   * cleared
+   **/
+  void reset(void);
+
+  /**
+   * Returns the aggregate of the contributors
+   * @return  the aggregate, which is empty for the minimum or maximum of
+   *          no existing contributors
+   **/
+  KnowledgeRecord get(void) const;
+
+  /**
+   * Returns the aggregate of the contributors as an integer
+   * @return  the aggregate
+   **/
+  KnowledgeRecord::Integer get_integer(void) const;
+
+  /**
+   * Returns the aggregate of the contributors as a double
+   * @return  the aggregate
+   **/
+  double get_double(void) const;
+
+  /**
+   * Returns the context the aggregate is attached to
+   * @return  the context, or 0 if the aggregate is not attached
+   **/
+  ThreadSafeContext* get_context(void) const;
+
+private:
+  friend class ThreadSafeContext;
+
+  /**
+   * The value of a contributor
+   **/
+  struct Value
+  {
+    /// true if the contributor exists
+    bool exists = false;
+
+    /// true if the value is a double
+    bool is_double = false;
+
+    /// the value, if it is an integer
+    KnowledgeRecord::Integer integer = 0;
+
+    /// the value, if it is a double
+    double real = 0;
+  };
+
+  /**
+   * Adds or removes a value from the running aggregate
+   * @param  value    the value
+   * @param  add      true to add the value, false to remove it
+   **/
+  void apply(const Value& value, bool add);
+
+  /**
+   * Recomputes the double part of the sum, to drop accumulated rounding
+   **/
+  void resum_doubles(void);
+
+  /// the way to aggregate contributors
+  Operation operation_;
+
+  /// the values of the contributors
+  std::vector<Value> values_;
+
+  /// the integer part of the sum
+  KnowledgeRecord::Integer integer_sum_ = 0;
+
+  /// the double part of the sum
+  double double_sum_ = 0;
+
+  /// double updates since the double sum was recomputed
+  size_t double_updates_ = 0;
+
+  /// the number of contributors that are doubles
+  size_t doubles_ = 0;
+
+  /// the existing values, ordered for minimums and maximums
+  std::multiset<double> ordered_;
+
+  /// the context that updates the aggregate
+  ThreadSafeContext* context_ = 0;
+
+  /// the records of the contributors, kept by the context
+  std::vector<KnowledgeRecord*> records_;
+};
+}
+}
+
+#endif  // _MADARA_KNOWLEDGE_RECORD_AGGREGATE_H_
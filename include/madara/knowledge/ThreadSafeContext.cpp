@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iterator>
 #include <memory>
+#include <deque>
+#include <future>
 
 #include <string.h>
 
@@ -48,6 +52,13 @@ ThreadSafeContext::ThreadSafeContext()
 // destructor
 ThreadSafeContext::~ThreadSafeContext(void)
 {
+  // aggregates may outlive the context, so they no longer refer to it
+  for (auto aggregate : attached_aggregates_)
+  {
+    aggregate->context_ = nullptr;
+    aggregate->records_.clear();
+  }
+
 #ifndef _MADARA_NO_KARL_
   delete interpreter_;
 #endif  // _MADARA_NO_KARL_
@@ -134,6 +145,12 @@ VariableReference ThreadSafeContext::get_ref(
   }
 
   KnowledgeMap::const_iterator found = map_.find(*key_ptr);
+
+  if (found == map_.end())
+  {
+    return {};
+  }
+
   return {const_cast<VariableReference::pair_ptr>(&*found)};
 }
 
@@ -763,6 +780,114 @@ int ThreadSafeContext::update_record_from_external(
   return result;
 }
 
+void ThreadSafeContext::attach_aggregate(RecordAggregate& aggregate,
+    const std::vector<VariableReference>& contributors)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  if (aggregate.context_ != nullptr)
+  {
+    aggregate.context_->detach_aggregate(aggregate);
+  }
+
+  aggregate.values_.resize(contributors.size());
+  aggregate.reset();
+  aggregate.records_.assign(contributors.size(), nullptr);
+
+  for (size_t i = 0; i < contributors.size(); ++i)
+  {
+    if (contributors[i].is_valid())
+    {
+      KnowledgeRecord* record = contributors[i].get_record_unsafe();
+
+      record->context_flags_ |= AGGREGATED;
+      aggregates_[record].emplace_back(&aggregate, i);
+      aggregate.records_[i] = record;
+
+      aggregate.update(i, *record);
+    }
+  }
+
+  aggregate.context_ = this;
+  attached_aggregates_.push_back(&aggregate);
+}
+
+void ThreadSafeContext::detach_aggregate(RecordAggregate& aggregate)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  if (aggregate.context_ != this)
+  {
+    return;
+  }
+
+  for (auto record : aggregate.records_)
+  {
+    if (record == nullptr)
+    {
+      continue;
+    }
+
+    auto found = aggregates_.find(record);
+
+    if (found != aggregates_.end())
+    {
+      auto& entries = found->second;
+
+      entries.erase(std::remove_if(entries.begin(), entries.end(),
+                        [&aggregate](const std::pair<RecordAggregate*,
+                            size_t>& entry) {
+                          return entry.first == &aggregate;
+                        }),
+          entries.end());
+
+      if (entries.empty())
+      {
+        record->context_flags_ &= ~AGGREGATED;
+        aggregates_.erase(found);
+      }
+    }
+  }
+
+  aggregate.records_.clear();
+  aggregate.context_ = nullptr;
+
+  attached_aggregates_.erase(std::remove(attached_aggregates_.begin(),
+                                 attached_aggregates_.end(), &aggregate),
+      attached_aggregates_.end());
+}
+
+void ThreadSafeContext::update_aggregates_unsafe(const KnowledgeRecord& record)
+{
+  auto found = aggregates_.find(&record);
+
+  if (found != aggregates_.end())
+  {
+    for (auto& entry : found->second)
+    {
+      entry.first->update(entry.second, record);
+    }
+  }
+}
+
+void ThreadSafeContext::remove_aggregated_unsafe(KnowledgeRecord& record)
+{
+  auto found = aggregates_.find(&record);
+
+  if (found != aggregates_.end())
+  {
+    for (auto& entry : found->second)
+    {
+      entry.first->update(entry.second, KnowledgeRecord());
+      entry.first->records_[entry.second] = nullptr;
+    }
+
+    aggregates_.erase(found);
+  }
+
+  record.context_flags_ &= ~AGGREGATED;
+}
+
 /// Indicate that a status change has occurred. This could be a message
 /// from the transport to let the knowledge engine know that new agents
 /// are available to send knowledge to.
@@ -1061,7 +1186,8 @@ CompiledExpression ThreadSafeContext::compile(const std::string& expression)
       " compiling %s\n",
       expression.c_str());
 
-  MADARA_GUARD_TYPE guard(mutex_);
+  // the parse only locks the context to resolve variables and functions,
+  // and the interpreter's expression cache has its own lock
   CompiledExpression ce;
   ce.logic = expression;
   ce.expression = interpreter_->interpret(*this, expression);
@@ -1069,6 +1195,17 @@ CompiledExpression ThreadSafeContext::compile(const std::string& expression)
   return ce;
 }
 
+expression::ExpressionCacheStats ThreadSafeContext::get_expression_cache_stats(
+    void) const
+{
+  return interpreter_->get_cache().get_stats();
+}
+
+void ThreadSafeContext::set_expression_cache_capacity(size_t capacity)
+{
+  interpreter_->get_cache().set_capacity(capacity);
+}
+
 KnowledgeRecord ThreadSafeContext::evaluate(
     CompiledExpression expression, const KnowledgeUpdateSettings& settings)
 {
@@ -1159,6 +1296,138 @@ size_t ThreadSafeContext::to_map(const std::string& expression,
   return target.size();
 }
 
+VariableReferences ThreadSafeContext::get_refs(
+    const std::vector<std::string>& keys,
+    const KnowledgeReferenceSettings& settings)
+{
+  VariableReferences result;
+  result.reserve(keys.size());
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (auto& key : keys)
+  {
+    result.push_back(get_ref(key, settings));
+  }
+
+  return result;
+}
+
+void ThreadSafeContext::get_all(const VariableReferences& variables,
+    std::vector<KnowledgeRecord>& values,
+    const KnowledgeReferenceSettings& settings) const
+{
+  values.resize(variables.size());
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (size_t i = 0; i < variables.size(); ++i)
+  {
+    const KnowledgeRecord* record = variables[i].get_record_unsafe();
+
+    if (!record)
+    {
+      values[i] = KnowledgeRecord();
+      continue;
+    }
+
+    if (settings.exception_on_unitialized && !record->exists())
+    {
+      std::stringstream buffer;
+      buffer << "ERROR: settings do not allow reads of unset vars and ";
+      buffer << variables[i].get_name() << " is uninitialized";
+      throw exceptions::UninitializedException(buffer.str());
+    }
+
+    values[i] = record->has_history() ? record->ref_newest() : *record;
+  }
+}
+
+void ThreadSafeContext::get_all(const std::vector<std::string>& keys,
+    std::vector<KnowledgeRecord>& values,
+    const KnowledgeReferenceSettings& settings) const
+{
+  values.resize(keys.size());
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    const KnowledgeRecord* record = with(keys[i], settings);
+
+    if (!record)
+    {
+      if (settings.exception_on_unitialized)
+      {
+        std::stringstream buffer;
+        buffer << "ERROR: settings do not allow reads of unset vars and ";
+        buffer << keys[i] << " is uninitialized";
+        throw exceptions::UninitializedException(buffer.str());
+      }
+
+      values[i] = KnowledgeRecord();
+    }
+    else
+    {
+      values[i] = record->has_history() ? record->ref_newest() : *record;
+    }
+  }
+}
+
+int ThreadSafeContext::set_all(const VariableReferences& variables,
+    const std::vector<KnowledgeRecord>& values,
+    const KnowledgeUpdateSettings& settings)
+{
+  if (variables.size() != values.size())
+  {
+    return -1;
+  }
+
+  int result = 0;
+
+  // waiters are signaled once, after every value is in place
+  KnowledgeUpdateSettings quiet(settings);
+  quiet.signal_changes = false;
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (size_t i = 0; i < variables.size(); ++i)
+  {
+    if (!variables[i].is_valid())
+    {
+      result = -1;
+      continue;
+    }
+
+    int ret = set_unsafe_impl(variables[i], quiet, values[i]);
+
+    if (ret == 0)
+    {
+      mark_and_signal(variables[i], quiet);
+    }
+    else
+    {
+      result = ret;
+    }
+  }
+
+  if (settings.signal_changes && waiters_ > 0)
+  {
+    changed_.MADARA_CONDITION_NOTIFY_ALL();
+  }
+
+  return result;
+}
+
+int ThreadSafeContext::set_all(const std::vector<std::string>& keys,
+    const std::vector<KnowledgeRecord>& values,
+    const KnowledgeUpdateSettings& settings)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return set_all(get_refs(keys, settings), values, settings);
+}
+
 void ThreadSafeContext::get_matches(const std::string& prefix,
     const std::string& suffix, VariableReferences& matches)
 {
@@ -1306,55 +1575,8 @@ void ThreadSafeContext::delete_prefix(
   std::pair<KnowledgeMap::iterator, KnowledgeMap::iterator> iters(
       get_prefix_range(prefix));
 
-  map_.erase(iters.first, iters.second);
-
-  {
-    // check the changed map
-    std::pair<VariableReferenceMap::iterator, VariableReferenceMap::iterator>
-        changed(changed_map_.lower_bound(prefix.c_str()), changed_map_.end());
-
-    // does our lower bound actually contain the prefix?
-    if (prefix.compare(0, prefix.size(), changed.first->first, prefix.size()) ==
-        0)
-    {
-      changed.second = changed.first;
-
-      // until we find an entry that does not begin with prefix, loop
-      for (++changed.second; (prefix.compare(0, prefix.size(),
-                                  changed.second->first, prefix.size()) == 0) &&
-                             changed.second != changed_map_.end();
-           ++changed.second)
-      {
-      }
-
-      changed_map_.erase(changed.first, changed.second);
-    }
-  }
-
-  {
-    // check the local changed map
-    std::pair<VariableReferenceMap::iterator, VariableReferenceMap::iterator>
-        local_changed(local_changed_map_.lower_bound(prefix.c_str()),
-            local_changed_map_.end());
-
-    // does our lower bound actually contain the prefix?
-    if (prefix.compare(
-            0, prefix.size(), local_changed.first->first, prefix.size()) == 0)
-    {
-      local_changed.second = local_changed.first;
-
-      // until we find an entry that does not begin with prefix, loop
-      for (++local_changed.second;
-           (prefix.compare(0, prefix.size(), local_changed.second->first,
-                prefix.size()) == 0) &&
-           local_changed.second != local_changed_map_.end();
-           ++local_changed.second)
-      {
-      }
-
-      local_changed_map_.erase(local_changed.first, local_changed.second);
-    }
-  }
+  // drop the erased records from the changed and local changed lists
+  delete_variables(iters.first, iters.second);
 }
 
 std::pair<KnowledgeMap::iterator, KnowledgeMap::iterator>
@@ -1444,7 +1666,7 @@ void ThreadSafeContext::copy(const ThreadSafeContext& source,
         "ThreadSafeContext::copy:"
         " clearing knowledge in target context\n");
 
-    map_.clear();
+    clear(true);
   }
 
   if (reqs.predicates.size() != 0)
@@ -1559,7 +1781,7 @@ void ThreadSafeContext::copy(const ThreadSafeContext& source,
 {
   // if we need to clean first, clear the map
   if (clean_copy)
-    map_.clear();
+    clear(true);
 
   // if the copy set is empty, copy everything
   if (copy_set.size() == 0)
@@ -1590,171 +1812,1249 @@ void ThreadSafeContext::copy(const ThreadSafeContext& source,
   }
 }
 
-int64_t ThreadSafeContext::save_context(
-    const std::string& filename, const std::string& id) const
+static uint64_t update_checkpoint_header(logger::Logger* logger_,
+    uint64_t clock_, const CheckpointSettings& settings, std::fstream& file,
+    FileHeader& meta, transport::MessageHeader& checkpoint_header)
 {
-  CheckpointSettings settings;
-  settings.filename = filename;
-  settings.originator = id;
+  int64_t buffer_remaining((int64_t)FileHeader::encoded_size());
+  utility::ScopedArray<char> buffer = new char[FileHeader::encoded_size()];
 
-  return save_context(settings);
-}
+  const char* meta_reader = buffer.get_ptr();
 
-int64_t ThreadSafeContext::save_context(
-    const CheckpointSettings& settings) const
-{
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MAJOR,
-      "ThreadSafeContext::save_context:"
-      " opening file %s\n",
-      settings.filename.c_str());
+  // read the meta data at the front
+  file.seekg(0, file.beg);
+
+  if (!file.read(buffer.get(), FileHeader::encoded_size()))
+  {
+    madara_logger_checked_ptr_log(logger_, logger::LOG_ERROR,
+        "ThreadSafeContext::save_checkpoint:"
+        " failed to read existing file header: size=%d\n",
+        (int)meta.encoded_size());
 
-  // int64_t total_written (0);
-  FILE* file = fopen(settings.filename.c_str(), "wb");
+    throw exceptions::MemoryException(
+        "ThreadSafeContext::save_checkpoint:"
+        "Checkpoint file appears to have been corrupted. Bad header.");
+  }
 
-  FileHeader meta;
-  meta.states = 1;
-  utility::strncpy_safe(meta.originator, settings.originator.c_str(),
-      sizeof(meta.originator) < settings.originator.size() + 1
-          ? sizeof(meta.originator)
-          : settings.originator.size() + 1);
+  meta_reader = meta.read(meta_reader, buffer_remaining);
 
-  transport::MessageHeader checkpoint_header;
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save_checkpoint:"
+      " init file meta: size=%d, states=%d\n",
+      (int)meta.size, (int)meta.states);
 
-  if (file)
+  if (settings.originator != "")
   {
-    int64_t max_buffer(settings.buffer_size);
-    int64_t buffer_remaining(max_buffer);
-
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_context:"
-        " allocating %d byte buffer\n",
-        (int)max_buffer);
+        "ThreadSafeContext::save_checkpoint:"
+        " setting file meta id to %s\n",
+        settings.originator.c_str());
 
-    utility::ScopedArray<char> buffer = new char[max_buffer];
+    utility::strncpy_safe(meta.originator, settings.originator.c_str(),
+        sizeof(meta.originator) < settings.originator.size() + 1
+            ? sizeof(meta.originator)
+            : settings.originator.size() + 1);
+  }
 
-    char* current = buffer.get_ptr();
+  // save the spot where the file ends
+  uint64_t checkpoint_start = meta.size + (uint64_t)FileHeader::encoded_size();
 
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_context:"
-        " generating file meta\n");
+  checkpoint_header.size = checkpoint_header.encoded_size();
 
-    meta.size += checkpoint_header.encoded_size();
-    checkpoint_header.size = checkpoint_header.encoded_size();
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save_checkpoint:"
+      " meta.size=%d, chkpt.header.size=%d \n",
+      (int)meta.size, (int)checkpoint_header.size);
 
-    if (settings.override_timestamp)
-    {
-      meta.initial_timestamp = settings.initial_timestamp;
-      meta.last_timestamp = settings.last_timestamp;
-    }
+  if (settings.override_timestamp)
+  {
+    meta.initial_timestamp = settings.initial_timestamp;
+    meta.last_timestamp = settings.last_timestamp;
+  }
 
-    current = meta.write(current, buffer_remaining);
+  if (settings.override_lamport)
+  {
+    checkpoint_header.clock = settings.initial_lamport_clock;
+  }
+  else
+  {
+    checkpoint_header.clock = clock_;
+  }
 
-    if (settings.override_lamport)
-    {
-      checkpoint_header.clock = settings.initial_lamport_clock;
-    }
-    else
-    {
-      checkpoint_header.clock = clock_;
-    }
+  return checkpoint_start;
+}
 
-    current = checkpoint_header.write(current, buffer_remaining);
+static void init_checkpoint_header(logger::Logger* logger_, uint64_t clock_,
+    const CheckpointSettings& settings, FileHeader& meta,
+    transport::MessageHeader& checkpoint_header)
+{
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save:"
+      " creating file meta. file.meta.size=%d, state.size=%d\n",
+      (int)meta.size, (int)checkpoint_header.encoded_size());
+
+  if (settings.override_timestamp)
+  {
+    meta.initial_timestamp = settings.initial_timestamp;
+    meta.last_timestamp = settings.last_timestamp;
+  }
+
+  if (settings.override_lamport)
+  {
+    checkpoint_header.clock = settings.initial_lamport_clock;
+  }
+  else
+  {
+    checkpoint_header.clock = clock_;
+  }
+}
+
+/**
+ * Writes the file header at the front of a checkpoint file
+ **/
+static void checkpoint_write_file_header(std::ostream& file, FileHeader& meta)
+{
+  int64_t buffer_remaining((int64_t)FileHeader::encoded_size());
+  utility::ScopedArray<char> buffer = new char[FileHeader::encoded_size()];
+
+  meta.write(buffer.get_ptr(), buffer_remaining);
+
+  file.seekp(0, file.beg);
+  file.write(buffer.get_ptr(), FileHeader::encoded_size());
+}
+
+/**
+ * Checks if a record name matches the prefixes of the settings, if any
+ **/
+static bool checkpoint_has_prefix(logger::Logger* logger_,
+    const CheckpointSettings& settings, const char* name)
+{
+  if (settings.prefixes.size() == 0)
+  {
+    return true;
+  }
+
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save:"
+      " we have %d prefixes to check against.\n",
+      (int)settings.prefixes.size());
+
+  for (size_t j = 0; j < settings.prefixes.size(); ++j)
+  {
+    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+        "ThreadSafeContext::save:"
+        " checking record %s against prefix %s.\n",
+        name, settings.prefixes[j].c_str());
+
+    if (madara::utility::begins_with(name, settings.prefixes[j]))
+    {
+      return true;
+    }
+  }
+
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save:"
+      " record has the wrong prefix. Rejected.\n");
+
+  return false;
+}
+
+namespace
+{
+class ContextLocalModifiedsLister : public VariablesLister
+{
+public:
+  ContextLocalModifiedsLister(const ThreadSafeContext& context)
+    : context_(&context)
+  {
+  }
+
+  void start(const CheckpointSettings& settings) override
+  {
+    guard_.reset(new ContextGuard(*context_));
+    map_ = context_->get_local_modified();
+    iter_ = map_.begin();
+
+    if (settings.reset_checkpoint)
+    {
+      clear_modifieds_ = true;
+    }
+  }
+
+  std::pair<const char*, const KnowledgeRecord*> next() override
+  {
+    std::pair<const char*, const KnowledgeRecord*> ret{nullptr, nullptr};
+
+    if (iter_ == map_.end())
+    {
+      guard_.reset();
+      if (clear_modifieds_)
+      {
+        context_->reset_checkpoint();
+      }
+      return ret;
+    }
+
+    ret.first = iter_->first;
+    ret.second = iter_->second.get_record_unsafe();
+
+    ++iter_;
+
+    return ret;
+  }
+
+private:
+  const ThreadSafeContext* context_;
+  std::unique_ptr<ContextGuard> guard_;
+  VariableReferenceMap map_;
+  VariableReferenceMap::iterator iter_;
+  bool clear_modifieds_ = false;
+};
+
+/**
+ * Lists every variable in the context, for keyframes and whole context
+ * saves
+ **/
+class ContextAllLister : public VariablesLister
+{
+public:
+  /**
+   * Constructor
+   * @param  context  the context to list
+   * @param  reset    if true, the listing may reset the checkpoint
+   *                  modifieds, which a keyframe covers
+   **/
+  ContextAllLister(const ThreadSafeContext& context, bool reset)
+    : context_(&context), reset_(reset)
+  {
+  }
+
+  void start(const CheckpointSettings& settings) override
+  {
+    guard_.reset(new ContextGuard(*context_));
+    iter_ = context_->get_map_unsafe().begin();
+
+    // only the default lister's diff is covered by the keyframe
+    if (reset_ && settings.reset_checkpoint &&
+        settings.variables_lister == nullptr)
+    {
+      clear_modifieds_ = true;
+    }
+  }
+
+  std::pair<const char*, const KnowledgeRecord*> next() override
+  {
+    std::pair<const char*, const KnowledgeRecord*> ret{nullptr, nullptr};
+
+    if (iter_ == context_->get_map_unsafe().end())
+    {
+      guard_.reset();
+      if (clear_modifieds_)
+      {
+        context_->reset_checkpoint();
+      }
+      return ret;
+    }
+
+    ret.first = iter_->first.c_str();
+    ret.second = &iter_->second;
+
+    ++iter_;
+
+    return ret;
+  }
+
+private:
+  const ThreadSafeContext* context_;
+  bool reset_;
+  std::unique_ptr<ContextGuard> guard_;
+  KnowledgeMap::const_iterator iter_;
+  bool clear_modifieds_ = false;
+};
+
+/**
+ * Copies the existing records of a lister that match the prefixes of the
+ * settings while the lister holds the context lock
+ **/
+static void checkpoint_snapshot_records(logger::Logger* logger_,
+    const CheckpointSettings& settings, VariablesLister& lister,
+    std::vector<std::pair<std::string, KnowledgeRecord>>& records)
+{
+  for (auto e = lister.next(); e.second != nullptr; e = lister.next())
+  {
+    if (e.second->exists() &&
+        checkpoint_has_prefix(logger_, settings, e.first))
+    {
+      // copies share array and string values with the context, which
+      // must copy them before changing them once the lock is released.
+      // History buffers are changed in place, so take only the newest.
+      e.second->share();
+      records.emplace_back(e.first,
+          e.second->has_history() ? e.second->get_newest() : *e.second);
+    }
+  }
+
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save:"
+      " snapshot of %d records taken\n",
+      (int)records.size());
+}
+
+/**
+ * Visits the existing records of a lister that match the prefixes of the
+ * settings. In snapshot mode, the records are copied out while the lister
+ * holds the context lock and are visited after it has been released.
+ **/
+template<typename Visitor>
+void checkpoint_visit_records(logger::Logger* logger_,
+    const CheckpointSettings& settings, VariablesLister& lister,
+    Visitor visit)
+{
+  lister.start(settings);
+
+  if (settings.snapshot)
+  {
+    std::vector<std::pair<std::string, KnowledgeRecord>> records;
+
+    checkpoint_snapshot_records(logger_, settings, lister, records);
+
+    for (auto& record : records)
+    {
+      visit(record.first.c_str(), record.second);
+    }
+  }
+  else
+  {
+    for (auto e = lister.next(); e.second != nullptr; e = lister.next())
+    {
+      if (e.second->exists() &&
+          checkpoint_has_prefix(logger_, settings, e.first))
+      {
+        visit(e.first, *e.second);
+      }
+    }
+  }
+}
+
+/**
+ * Encodes a checkpoint state through a buffer of settings.buffer_size
+ * bytes. Without buffer filters, the buffer is written to the file each
+ * time it fills, so it only needs to hold the largest record. Buffer
+ * filters encode a whole state at once, so with filters the buffer must
+ * hold the whole state.
+ **/
+class CheckpointStateWriter
+{
+public:
+  /**
+   * Constructor. Starts the state with its header.
+   * @param  logger    the logger of the context
+   * @param  settings  the settings with the buffer size and filters
+   * @param  file      the file to write the state to
+   * @param  offset    the offset of the state in the file
+   * @param  header    the state header, which is updated with each record
+   **/
+  CheckpointStateWriter(logger::Logger* logger,
+      const CheckpointSettings& settings, std::ostream& file,
+      uint64_t offset, transport::MessageHeader& header)
+    : logger_(logger),
+      settings_(settings),
+      file_(file),
+      offset_(offset),
+      header_(header),
+      streaming_(settings.buffer_filters.size() == 0),
+      max_buffer_((int64_t)settings.buffer_size),
+      buffer_remaining_(max_buffer_),
+      buffer_(new char[settings.buffer_size])
+  {
+    header_.size = header_.encoded_size();
+    current_ = header_.write(buffer_.get_ptr(), buffer_remaining_);
+
+    file_.seekp(offset_);
+  }
+
+  /**
+   * Adds a record to the state
+   * @param  name    the name of the record
+   * @param  record  the record to encode
+   **/
+  void write(const char* name, const KnowledgeRecord& record)
+  {
+    // get the encoded size of the record for checking buffer boundaries
+    int64_t encoded_size = record.get_encoded_size(name);
+
+    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+        "ThreadSafeContext::save:"
+        " estimated encoded size of update=%d bytes\n",
+        (int)encoded_size);
+
+    if (encoded_size > buffer_remaining_ && streaming_)
+    {
+      flush();
+    }
+
+    if (encoded_size > buffer_remaining_)
+    {
+      throw exceptions::MemoryException(
+          "ThreadSafeContext::save: "
+          "buffer size is not big enough for the encoded records. "
+          "CheckpointSettings.buffer_size needs to be larger.");
+    }
+
+    char* pre_write = current_;
+    current_ = record.write(current_, name, buffer_remaining_);
+
+    ++header_.updates;
+    header_.size += (uint64_t)(current_ - pre_write);
+  }
+
+  /**
+   * Writes out the rest of the state and its final header
+   * @return the size of the state in the file, after any encoding
+   **/
+  uint64_t finish(void)
+  {
+    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+        "ThreadSafeContext::save:"
+        " state header: size=%d, updates=%d, offset=%d\n",
+        (int)header_.size, (int)header_.updates, (int)offset_);
+
+    if (streaming_)
+    {
+      flush();
+
+      // patch the final sizes into the header at the front of the state
+      char* end = header_.write(buffer_.get_ptr(), buffer_remaining_);
+
+      file_.seekp(offset_);
+      file_.write(buffer_.get_ptr(), end - buffer_.get_ptr());
+
+      return header_.size;
+    }
+
+    // write the final sizes and encode the whole state with the filters
+    int64_t header_remaining(max_buffer_);
+    header_.write(buffer_.get_ptr(), header_remaining);
+
+    int total = settings_.encode(
+        buffer_.get_ptr(), (int)header_.size, (int)max_buffer_);
+
+    if (total < 0)
+    {
+      throw exceptions::FilterException(
+          "ThreadSafeContext::save: "
+          "encode () returned a negative encoding size. Bad filter/encode.");
+    }
+
+    file_.write(buffer_.get_ptr(), total);
+
+    return (uint64_t)total;
+  }
+
+private:
+  /**
+   * Writes the buffered bytes to the file and empties the buffer
+   **/
+  void flush(void)
+  {
+    file_.write(buffer_.get_ptr(), current_ - buffer_.get_ptr());
+
+    current_ = buffer_.get_ptr();
+    buffer_remaining_ = max_buffer_;
+  }
+
+  logger::Logger* logger_;
+  const CheckpointSettings& settings_;
+  std::ostream& file_;
+  uint64_t offset_;
+  transport::MessageHeader& header_;
+  bool streaming_;
+  int64_t max_buffer_;
+  int64_t buffer_remaining_;
+  utility::ScopedArray<char> buffer_;
+  char* current_;
+};
+}
+
+/**
+ * Writes a string as a quoted JSON string, escaping quotes, backslashes
+ * and control characters
+ **/
+static void save_json_string(std::ostream& out, const std::string& text)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  out << "\"";
+
+  size_t start = 0;
+
+  for (size_t i = 0; i < text.size(); ++i)
+  {
+    unsigned char c = (unsigned char)text[i];
+
+    if (c != '"' && c != '\\' && c >= 0x20)
+    {
+      continue;
+    }
+
+    out.write(text.data() + start, i - start);
+    start = i + 1;
+
+    switch (c)
+    {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\r':
+      out << "\\r";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+    }
+  }
+
+  out.write(text.data() + start, text.size() - start);
+
+  out << "\"";
+}
+
+/**
+ * Writes a double as JSON, which has no NaN or infinity, so they are
+ * written as null
+ **/
+static void save_json_double(std::ostream& out, double value)
+{
+  if (std::isfinite(value))
+  {
+    out << KnowledgeRecord(value);
+  }
+  else
+  {
+    out << "null";
+  }
+}
+
+/**
+ * Writes a record in KaRL syntax, minus its name, e.g., for save_as_karl
+ * and save_as_json. Binary files are saved next to the output file. For
+ * JSON, strings are escaped.
+ **/
+static void save_karl_value(std::ostream& out,
+    const CheckpointSettings& settings, const char* name,
+    const KnowledgeRecord& record, bool json = false)
+{
+  if (json && record.is_string_type())
+  {
+    save_json_string(out, record.to_string());
+  }
+  else if (json && record.type() == KnowledgeRecord::DOUBLE)
+  {
+    save_json_double(out, record.to_double());
+  }
+  else if (json && record.type() == KnowledgeRecord::DOUBLE_ARRAY)
+  {
+    std::vector<double> values = record.to_doubles();
+
+    out << "[";
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (i > 0)
+        out << ", ";
+
+      save_json_double(out, values[i]);
+    }
+
+    out << "]";
+  }
+  else if (!record.is_binary_file_type())
+  {
+    bool is_array = record.type() == KnowledgeRecord::INTEGER_ARRAY ||
+                    record.type() == KnowledgeRecord::DOUBLE_ARRAY;
+
+    // strings require quotation marks and arrays require brackets
+    if (record.is_string_type())
+    {
+      out << "\"";
+    }
+    else if (is_array)
+    {
+      out << "[";
+    }
+
+    out << record;
+
+    if (record.is_string_type())
+    {
+      out << "\"";
+    }
+    else if (is_array)
+    {
+      out << "]";
+    }
+  }
+  else
+  {
+    out << "#read_file ('";
+
+    std::string path = utility::extract_path(settings.filename);
+
+    if (path == "")
+      path = ".";
+
+    path += "/";
+    path += name;
+
+    if (record.type() == KnowledgeRecord::IMAGE_JPEG)
+    {
+      path += ".jpg";
+    }
+    else
+    {
+      path += ".dat";
+    }
+
+    utility::write_file(
+        path, (void*)record.share_binary()->data(), record.size());
+    out << path;
+
+    out << "')";
+  }
+}
+
+/// records formatted by each task of a parallel text save
+static const size_t checkpoint_shard_records = 4096;
+
+/**
+ * Formats the records of a lister to a stream for the text saves. The
+ * format function is called with the stream, the name, the record and
+ * whether the record is the first one written. If
+ * settings.format_threads is greater than one, a snapshot is formatted
+ * in shards on that many threads, and finished shards are written in
+ * key order while later shards are still being formatted.
+ **/
+template<typename Format>
+void checkpoint_format_records(logger::Logger* logger_,
+    const CheckpointSettings& settings, VariablesLister& lister,
+    std::ostream& out, Format format)
+{
+  if (settings.format_threads <= 1)
+  {
+    bool first = true;
+
+    checkpoint_visit_records(logger_, settings, lister,
+        [&out, &format, &first](
+            const char* name, const KnowledgeRecord& record) {
+          format(out, name, record, first);
+          first = false;
+        });
+
+    return;
+  }
+
+  std::vector<std::pair<std::string, KnowledgeRecord>> records;
+
+  lister.start(settings);
+  checkpoint_snapshot_records(logger_, settings, lister, records);
+
+  std::deque<std::future<std::string>> shards;
+  size_t next = 0;
+
+  auto launch = [&]() {
+    size_t begin = next;
+    size_t end = std::min(records.size(), begin + checkpoint_shard_records);
+    next = end;
+
+    shards.push_back(std::async(std::launch::async,
+        [&records, &format, begin, end]() {
+          std::ostringstream shard;
+
+          for (size_t i = begin; i < end; ++i)
+          {
+            format(shard, records[i].first.c_str(), records[i].second,
+                i == 0);
+          }
+
+          return shard.str();
+        }));
+  };
+
+  while (next < records.size() && shards.size() < settings.format_threads)
+  {
+    launch();
+  }
+
+  while (shards.size() > 0)
+  {
+    std::string shard = shards.front().get();
+    shards.pop_front();
+
+    if (next < records.size())
+    {
+      launch();
+    }
+
+    out.write(shard.data(), shard.size());
+  }
+
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::save:"
+      " formatted %d records on %d threads\n",
+      (int)records.size(), (int)settings.format_threads);
+}
+
+namespace
+{
+/**
+ * Parses JSON, e.g., from save_as_json, into records without compiling
+ * it as KaRL. Nested objects become dotted names, arrays of numbers
+ * become native arrays, other arrays become name.0 to name.N-1 plus
+ * name.size (the layout of containers::Vector), booleans become
+ * integers and nulls are skipped. The #read_file ('path') values that
+ * save_as_json writes for binary records read the file.
+ **/
+class JsonRecordParser
+{
+public:
+  typedef std::vector<std::pair<std::string, KnowledgeRecord>> Records;
+
+  /**
+   * Constructor
+   * @param  json   the text to parse, which must outlive the parser
+   **/
+  JsonRecordParser(const std::string& json)
+    : begin_(json.c_str()), pos_(json.c_str()), end_(begin_ + json.size())
+  {
+  }
+
+  /**
+   * Parses the text, which must be one object
+   * @param  records   the parsed records, in document order
+   * @return true if the text was valid
+   **/
+  bool parse(Records& records)
+  {
+    if (!expect('{') || !parse_object("", records))
+    {
+      return false;
+    }
+
+    skip_space();
+
+    return pos_ == end_ || fail("unexpected text after the object");
+  }
+
+  /**
+   * Returns why parsing failed
+   **/
+  const char* error(void) const
+  {
+    return error_;
+  }
+
+  /**
+   * Returns the offset where parsing stopped
+   **/
+  size_t offset(void) const
+  {
+    return pos_ - begin_;
+  }
+
+private:
+  bool fail(const char* error)
+  {
+    error_ = error;
+    return false;
+  }
+
+  void skip_space(void)
+  {
+    while (pos_ < end_ && isspace((unsigned char)*pos_))
+    {
+      ++pos_;
+    }
+  }
+
+  bool peek(char c)
+  {
+    skip_space();
+    return pos_ < end_ && *pos_ == c;
+  }
+
+  bool expect(char c)
+  {
+    if (!peek(c))
+    {
+      return fail("unexpected character");
+    }
+
+    ++pos_;
+    return true;
+  }
+
+  bool match(const char* word)
+  {
+    size_t length = strlen(word);
+
+    if ((size_t)(end_ - pos_) >= length && strncmp(pos_, word, length) == 0)
+    {
+      pos_ += length;
+      return true;
+    }
+
+    return false;
+  }
+
+  bool parse_object(const std::string& prefix, Records& records)
+  {
+    if (peek('}'))
+    {
+      ++pos_;
+      return true;
+    }
+
+    std::string name;
+
+    do
+    {
+      name.clear();
+
+      if (!expect('"') || !parse_string(name) || !expect(':') ||
+          !parse_value(prefix + name, records))
+      {
+        return false;
+      }
+    } while (peek(',') && ++pos_);
+
+    return expect('}');
+  }
+
+  bool parse_value(const std::string& name, Records& records)
+  {
+    skip_space();
+
+    if (pos_ == end_)
+    {
+      return fail("unexpected end of text");
+    }
+
+    switch (*pos_)
+    {
+    case '{':
+      ++pos_;
+      return parse_object(name + ".", records);
+    case '[':
+      ++pos_;
+      return parse_array(name, records);
+    case '"':
+    {
+      ++pos_;
+
+      std::string value;
+
+      if (!parse_string(value))
+      {
+        return false;
+      }
+
+      records.emplace_back(name, KnowledgeRecord(value));
+      return true;
+    }
+    case '#':
+      return parse_read_file(name, records);
+    }
+
+    if (match("true"))
+    {
+      records.emplace_back(name, KnowledgeRecord(KnowledgeRecord::Integer(1)));
+      return true;
+    }
+    else if (match("false"))
+    {
+      records.emplace_back(name, KnowledgeRecord(KnowledgeRecord::Integer(0)));
+      return true;
+    }
+    else if (match("null"))
+    {
+      return true;
+    }
+
+    KnowledgeRecord::Integer integer;
+    double real;
+    bool is_integer;
+
+    if (!parse_number(integer, real, is_integer))
+    {
+      return false;
+    }
+
+    records.emplace_back(
+        name, is_integer ? KnowledgeRecord(integer) : KnowledgeRecord(real));
+    return true;
+  }
+
+  bool parse_number(KnowledgeRecord::Integer& integer, double& real,
+      bool& is_integer)
+  {
+    // the text is null terminated, so conversions stop at the end
+    char* integer_end = nullptr;
+    char* real_end = nullptr;
+
+    integer = strtoll(pos_, &integer_end, 10);
+    real = strtod(pos_, &real_end);
+
+    if (real_end == pos_)
+    {
+      return fail("expected a value");
+    }
+
+    is_integer = integer_end == real_end;
+    pos_ = real_end;
+
+    return true;
+  }
+
+  bool parse_array(const std::string& name, Records& records)
+  {
+    const char* start = pos_;
+
+    // arrays of numbers, e.g., from save_as_json, become native arrays
+    std::vector<KnowledgeRecord::Integer> integers;
+    std::vector<double> reals;
+    bool is_reals = false;
+    bool numbers = true;
+
+    if (!peek(']'))
+    {
+      do
+      {
+        skip_space();
+
+        if (pos_ == end_ || strchr("{[\"#tfn", *pos_))
+        {
+          numbers = false;
+          break;
+        }
+
+        KnowledgeRecord::Integer integer;
+        double real;
+        bool is_integer;
+
+        if (!parse_number(integer, real, is_integer))
+        {
+          return false;
+        }
 
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_context:"
-        " writing records\n");
+        integers.push_back(integer);
+        reals.push_back(real);
+        is_reals = is_reals || !is_integer;
+      } while (peek(',') && ++pos_);
+    }
+
+    if (numbers)
+    {
+      if (is_reals)
+      {
+        records.emplace_back(name, KnowledgeRecord(reals));
+      }
+      else
+      {
+        records.emplace_back(name, KnowledgeRecord(integers));
+      }
 
-    // lock the context
-    MADARA_GUARD_TYPE guard(mutex_);
+      return expect(']');
+    }
+
+    // anything else is parsed again as separate variables
+    pos_ = start;
 
-    for (KnowledgeMap::const_iterator i = map_.begin(); i != map_.end(); ++i)
+    KnowledgeRecord::Integer size = 0;
+
+    if (!peek(']'))
     {
-      if (i->second.exists())
+      do
       {
-        // check if the prefix is allowed
-        if (settings.prefixes.size() > 0)
+        if (!parse_value(name + "." + std::to_string(size), records))
         {
-          madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-              "ThreadSafeContext::save_context:"
-              " we have %d prefixes to check against.\n",
-              (int)settings.prefixes.size());
+          return false;
+        }
 
-          bool prefix_found = false;
-          for (size_t j = 0; j < settings.prefixes.size() && !prefix_found; ++j)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_context:"
-                " checking record %s against prefix %s.\n",
-                i->first.c_str(), settings.prefixes[j].c_str());
+        ++size;
+      } while (peek(',') && ++pos_);
+    }
 
-            if (madara::utility::begins_with(i->first, settings.prefixes[j]))
-            {
-              madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                  "ThreadSafeContext::save_context:"
-                  " record has the correct prefix.\n");
+    records.emplace_back(name + ".size", KnowledgeRecord(size));
 
-              prefix_found = true;
-            }
-          }
+    return expect(']');
+  }
 
-          if (!prefix_found)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_context:"
-                " record has the wrong prefix. Rejected.\n");
+  bool parse_read_file(const std::string& name, Records& records)
+  {
+    if (!match("#read_file") || !expect('('))
+    {
+      return fail("expected a value");
+    }
 
-            continue;
-          }
-        }
+    skip_space();
 
-        auto pre_write = current;
-        current = i->second.write(current, i->first, buffer_remaining);
-        size_t encoded_size = current - pre_write;
+    if (pos_ == end_ || (*pos_ != '\'' && *pos_ != '"'))
+    {
+      return fail("expected a quoted file name");
+    }
+
+    const char* path_end = (const char*)memchr(pos_ + 1, *pos_, end_ - pos_ - 1);
+
+    if (!path_end)
+    {
+      return fail("unterminated file name");
+    }
+
+    std::string path(pos_ + 1, path_end);
+    pos_ = path_end + 1;
+
+    KnowledgeRecord record;
+
+    if (record.read_file(path) < 0)
+    {
+      madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_MAJOR,
+          "ThreadSafeContext::load_as_json:"
+          " unable to read %s for %s\n",
+          path.c_str(), name.c_str());
+    }
+    else
+    {
+      records.emplace_back(name, std::move(record));
+    }
+
+    return expect(')');
+  }
+
+  bool parse_string(std::string& value)
+  {
+    while (pos_ < end_)
+    {
+      const char* start = pos_;
+
+      while (pos_ < end_ && *pos_ != '"' && *pos_ != '\\')
+      {
+        ++pos_;
+      }
+
+      value.append(start, pos_);
+
+      if (pos_ == end_)
+      {
+        break;
+      }
+      else if (*pos_ == '"')
+      {
+        ++pos_;
+        return true;
+      }
+
+      // an escape sequence
+      if (++pos_ == end_)
+      {
+        break;
+      }
 
-        ++checkpoint_header.updates;
-        // meta.size += encoded_size;
-        checkpoint_header.size += encoded_size;
+      switch (*pos_++)
+      {
+      case '"':
+        value += '"';
+        break;
+      case '\\':
+        value += '\\';
+        break;
+      case '/':
+        value += '/';
+        break;
+      case 'b':
+        value += '\b';
+        break;
+      case 'f':
+        value += '\f';
+        break;
+      case 'n':
+        value += '\n';
+        break;
+      case 'r':
+        value += '\r';
+        break;
+      case 't':
+        value += '\t';
+        break;
+      case 'u':
+        if (!parse_unicode(value))
+        {
+          return false;
+        }
+        break;
+      default:
+        return fail("invalid escape sequence");
       }
     }
 
-    // write the final sizes
-    current = checkpoint_header.write(
-        buffer.get_ptr() + (int)FileHeader::encoded_size(), max_buffer);
+    return fail("unterminated string");
+  }
 
-    // call decode with any buffer filters
-    int total =
-        settings.encode(buffer.get_ptr() + (int)FileHeader::encoded_size(),
-            (int)checkpoint_header.size, (int)max_buffer);
+  bool parse_hex(uint32_t& code)
+  {
+    if (end_ - pos_ < 4)
+    {
+      return fail("invalid unicode escape");
+    }
 
-    if (total < 0)
+    code = 0;
+
+    for (int i = 0; i < 4; ++i, ++pos_)
+    {
+      char c = *pos_;
+      code <<= 4;
+
+      if (c >= '0' && c <= '9')
+        code |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        code |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        code |= c - 'A' + 10;
+      else
+        return fail("invalid unicode escape");
+    }
+
+    return true;
+  }
+
+  bool parse_unicode(std::string& value)
+  {
+    uint32_t code;
+
+    if (!parse_hex(code))
     {
-      throw exceptions::FilterException("ThreadSafeContext::save_context: "
-                                        "encode() returned -1 size. Cannot "
-                                        "save a negative sized checkpoint.");
+      return false;
     }
 
-    // if (settings.buffer_filters.size () > 0)
-    // {
-    //   total += (int)filters::BufferFilterHeader::encoded_size ();
-    // }
+    // a high surrogate is followed by the low surrogate of the pair
+    if (code >= 0xd800 && code < 0xdc00)
+    {
+      uint32_t low;
 
-    meta.size = (uint64_t)total;
+      if (!match("\\u") || !parse_hex(low) || low < 0xdc00 || low >= 0xe000)
+      {
+        return fail("invalid surrogate pair");
+      }
 
-    current = meta.write(buffer.get_ptr(), max_buffer);
+      code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+    }
 
-    // update the meta data at the front
-    fseek(file, 0, SEEK_SET);
+    // encode as UTF-8
+    if (code < 0x80)
+    {
+      value += (char)code;
+    }
+    else if (code < 0x800)
+    {
+      value += (char)(0xc0 | (code >> 6));
+      value += (char)(0x80 | (code & 0x3f));
+    }
+    else if (code < 0x10000)
+    {
+      value += (char)(0xe0 | (code >> 12));
+      value += (char)(0x80 | ((code >> 6) & 0x3f));
+      value += (char)(0x80 | (code & 0x3f));
+    }
+    else
+    {
+      value += (char)(0xf0 | (code >> 18));
+      value += (char)(0x80 | ((code >> 12) & 0x3f));
+      value += (char)(0x80 | ((code >> 6) & 0x3f));
+      value += (char)(0x80 | (code & 0x3f));
+    }
+
+    return true;
+  }
+
+  const char* begin_;
+  const char* pos_;
+  const char* end_;
+  const char* error_ = "";
+};
+}
+
+int64_t ThreadSafeContext::save_context(
+    const std::string& filename, const std::string& id) const
+{
+  CheckpointSettings settings;
+  settings.filename = filename;
+  settings.originator = id;
+
+  return save_context(settings);
+}
+
+int64_t ThreadSafeContext::save_context(
+    const CheckpointSettings& settings) const
+{
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MAJOR,
+      "ThreadSafeContext::save_context:"
+      " opening file %s\n",
+      settings.filename.c_str());
+
+  std::ofstream file(settings.filename.c_str(), std::ios::binary);
+
+  FileHeader meta;
+  meta.states = 1;
+  utility::strncpy_safe(meta.originator, settings.originator.c_str(),
+      sizeof(meta.originator) < settings.originator.size() + 1
+          ? sizeof(meta.originator)
+          : settings.originator.size() + 1);
+
+  transport::MessageHeader checkpoint_header;
+
+  if (file)
+  {
+    init_checkpoint_header(logger_, clock_, settings, meta, checkpoint_header);
+
+    // a context save holds every variable, so it is a keyframe
+    checkpoint_header.type = KEYFRAME;
+
+    // reserve the file meta, which is rewritten once the state size is known
+    checkpoint_write_file_header(file, meta);
+
+    CheckpointStateWriter writer(logger_, settings, file,
+        FileHeader::encoded_size(), checkpoint_header);
 
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
         "ThreadSafeContext::save_context:"
-        " encoding with buffer filters: %d:%d bytes written to offset %d.\n",
+        " writing records\n");
+
+    ContextAllLister lister(*this, false);
+
+    checkpoint_visit_records(logger_, settings, lister,
+        [&writer](const char* name, const KnowledgeRecord& record) {
+          writer.write(name, record);
+        });
+
+    meta.size = writer.finish();
+
+    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+        "ThreadSafeContext::save_context:"
+        " %d:%d bytes written to offset %d.\n",
         (int)meta.size, (int)checkpoint_header.size,
         (int)FileHeader::encoded_size());
 
-    fwrite(buffer.get_ptr(), (size_t)total + (size_t)FileHeader::encoded_size(),
-        1, file);
+    // update the meta data at the front
+    checkpoint_write_file_header(file, meta);
 
-    fclose(file);
+    file.close();
   }
   else
   {
@@ -1792,123 +3092,40 @@ int64_t ThreadSafeContext::save_as_karl(
 
   if (file.is_open())
   {
-    // lock the context
-    MADARA_GUARD_TYPE guard(mutex_);
-
-    for (KnowledgeMap::const_iterator i = map_.begin(); i != map_.end(); ++i)
-    {
-      if (i->second.exists())
-      {
-        // check if the prefix is allowed
-        if (settings.prefixes.size() > 0)
-        {
-          madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-              "ThreadSafeContext::save_as_karl:"
-              " we have %d prefixes to check against.\n",
-              (int)settings.prefixes.size());
-
-          bool prefix_found = false;
-          for (size_t j = 0; j < settings.prefixes.size() && !prefix_found; ++j)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_as_karl:"
-                " checking record %s against prefix %s.\n",
-                i->first.c_str(), settings.prefixes[j].c_str());
-
-            if (madara::utility::begins_with(i->first, settings.prefixes[j]))
-            {
-              madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                  "ThreadSafeContext::save_as_karl:"
-                  " the record has the correct prefix.\n");
-
-              prefix_found = true;
-            }
-          }
-
-          if (!prefix_found)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_as_karl:"
-                " the record does not have a correct prefix.\n");
-
-            continue;
-          }
-        }
-
-        buffer << i->first;
-        buffer << "=";
-
-        if (!i->second.is_binary_file_type())
-        {
-          // record is a non binary file type
-          if (i->second.is_string_type())
-          {
-            // strings require quotation marks
-            buffer << "\"";
-          }
-          else if (i->second.type() ==
-                       knowledge::KnowledgeRecord::INTEGER_ARRAY ||
-                   i->second.type() == knowledge::KnowledgeRecord::DOUBLE_ARRAY)
-          {
-            // arrays require brackets
-            buffer << "[";
-          }
-
-          buffer << i->second;
-          if (i->second.is_string_type())
-          {
-            // strings require quotation marks
-            buffer << "\"";
-          }
-          else if (i->second.type() ==
-                       knowledge::KnowledgeRecord::INTEGER_ARRAY ||
-                   i->second.type() == knowledge::KnowledgeRecord::DOUBLE_ARRAY)
-          {
-            // arrays require brackets
-            buffer << "]";
-          }
-        }
-        else
-        {
-          buffer << "#read_file ('";
+    // buffer filters encode the whole result, so only unfiltered saves
+    // can stream straight to the file
+    bool filtered = settings.buffer_filters.size() > 0;
+    std::ostream& out =
+        filtered ? (std::ostream&)buffer : (std::ostream&)file;
 
-          std::string path = utility::extract_path(settings.filename);
-
-          if (path == "")
-            path = ".";
-
-          path += "/";
-          path += i->first;
-
-          if (i->second.type() == knowledge::KnowledgeRecord::IMAGE_JPEG)
-          {
-            path += ".jpg";
-          }
-          else
-          {
-            path += ".dat";
-          }
+    ContextAllLister lister(*this, false);
 
-          utility::write_file(
-              path, (void*)&(*i->second.file_value_)[0], i->second.size());
-          buffer << path;
+    checkpoint_format_records(logger_, settings, lister, out,
+        [&settings](std::ostream& out, const char* name,
+            const KnowledgeRecord& record, bool) {
+          out << name;
+          out << "=";
+          save_karl_value(out, settings, name, record);
+          out << ";\n";
+        });
 
-          buffer << "')";
-        }
+    if (filtered)
+    {
+      std::string result = buffer.str();
 
-        buffer << ";\n";
+      if (result.size() + 1 > settings.buffer_size)
+      {
+        throw exceptions::MemoryException(
+            "ThreadSafeContext::save_as_karl: "
+            "CheckpointSettings.buffer_size is too small to hold the "
+            "result for the buffer filters.");
       }
-    }
-
-    std::string result = buffer.str();
 
-    if (settings.buffer_filters.size() > 0)
-    {
-      char* result_copy = new char[settings.buffer_size];
-      memcpy(result_copy, result.c_str(), result.size() + 1);
+      utility::ScopedArray<char> result_copy = new char[settings.buffer_size];
+      memcpy(result_copy.get_ptr(), result.c_str(), result.size() + 1);
 
-      int size = settings.encode(
-        result_copy, (int)result.size(), (int)settings.buffer_size);
+      int size = settings.encode(result_copy.get_ptr(), (int)result.size(),
+          (int)settings.buffer_size);
 
       if (size < 0)
       {
@@ -1917,13 +3134,12 @@ int64_t ThreadSafeContext::save_as_karl(
             "encode() returned -1. Incorrect filter.");
       }
 
-      file.write(result_copy, size);
+      file.write(result_copy.get_ptr(), size);
       bytes_written = (int64_t)size;
     }
     else
     {
-      file.write(result.c_str(), result.size());
-      bytes_written = (int64_t)result.size();
+      bytes_written = (int64_t)file.tellp();
     }
 
     file.close();
@@ -1957,134 +3173,32 @@ int64_t ThreadSafeContext::save_as_json(
       " opening file %s\n",
       settings.filename.c_str());
 
-  int64_t bytes_written(0);
-
-  std::stringstream buffer;
-  std::ofstream file;
-  file.open(settings.filename.c_str());
-
-  if (file.is_open())
-  {
-    // lock the context
-    MADARA_GUARD_TYPE guard(mutex_);
-
-    buffer << "{\n";
-
-    for (KnowledgeMap::const_iterator i = map_.begin(); i != map_.end(); ++i)
-    {
-      if (i->second.exists())
-      {
-        // check if the prefix is allowed
-        if (settings.prefixes.size() > 0)
-        {
-          madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-              "ThreadSafeContext::save_as_json:"
-              " we have %d prefixes to check against.\n",
-              (int)settings.prefixes.size());
-
-          bool prefix_found = false;
-          for (size_t j = 0; j < settings.prefixes.size() && !prefix_found; ++j)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_as_json:"
-                " checking record %s against prefix %s.\n",
-                i->first.c_str(), settings.prefixes[j].c_str());
-
-            if (madara::utility::begins_with(i->first, settings.prefixes[j]))
-            {
-              madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                  "ThreadSafeContext::save_as_json:"
-                  " the record has the correct prefix.\n");
-
-              prefix_found = true;
-            }
-          }
-
-          if (!prefix_found)
-          {
-            madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-                "ThreadSafeContext::save_as_json:"
-                " the record does not have a correct prefix.\n");
-
-            continue;
-          }
-        }
-
-        buffer << "  \"";
-        buffer << i->first;
-        buffer << "\" : ";
-
-        if (!i->second.is_binary_file_type())
-        {
-          // record is a non binary file type
-          if (i->second.is_string_type())
-          {
-            // strings require quotation marks
-            buffer << "\"";
-          }
-          else if (i->second.type() ==
-                       knowledge::KnowledgeRecord::INTEGER_ARRAY ||
-                   i->second.type() == knowledge::KnowledgeRecord::DOUBLE_ARRAY)
-          {
-            // arrays require brackets
-            buffer << "[";
-          }
-
-          buffer << i->second;
-          if (i->second.is_string_type())
-          {
-            // strings require quotation marks
-            buffer << "\"";
-          }
-          else if (i->second.type() ==
-                       knowledge::KnowledgeRecord::INTEGER_ARRAY ||
-                   i->second.type() == knowledge::KnowledgeRecord::DOUBLE_ARRAY)
-          {
-            // arrays require brackets
-            buffer << "]";
-          }
-        }
-        else
-        {
-          buffer << "#read_file ('";
-
-          std::string path = utility::extract_path(settings.filename);
-
-          if (path == "")
-            path = ".";
-
-          path += "/";
-          path += i->first;
-
-          if (i->second.type() == knowledge::KnowledgeRecord::IMAGE_JPEG)
-          {
-            path += ".jpg";
-          }
-          else
-          {
-            path += ".dat";
-          }
-
-          utility::write_file(
-              path, (void*)&(*i->second.file_value_)[0], i->second.size());
-          buffer << path;
+  int64_t bytes_written(0);
 
-          buffer << "')";
-        }
+  std::ofstream file;
+  file.open(settings.filename.c_str());
 
-        KnowledgeMap::const_iterator j(i);
+  if (file.is_open())
+  {
+    file << "{\n";
 
-        if (++j != map_.end())
-          buffer << ",\n";
-      }
-    }
+    ContextAllLister lister(*this, false);
 
-    buffer << "\n}\n";
+    checkpoint_format_records(logger_, settings, lister, file,
+        [&settings](std::ostream& out, const char* name,
+            const KnowledgeRecord& record, bool first) {
+          if (!first)
+            out << ",\n";
 
-    std::string result = buffer.str();
-    file << result;
+          out << "  ";
+          save_json_string(out, name);
+          out << " : ";
+          save_karl_value(out, settings, name, record, true);
+        });
 
-    bytes_written = (int64_t)result.size();
+    file << "\n}\n";
+
+    bytes_written = (int64_t)file.tellp();
 
     file.close();
   }
@@ -2288,268 +3402,122 @@ int64_t ThreadSafeContext::load_context(CheckpointSettings& checkpoint_settings,
   }
 }
 
-static uint64_t update_checkpoint_header(logger::Logger* logger_,
-    uint64_t clock_, const CheckpointSettings& settings, std::fstream& file,
-    FileHeader& meta, transport::MessageHeader& checkpoint_header,
-    int64_t& buffer_remaining, utility::ScopedArray<char>& buffer)
+int64_t ThreadSafeContext::load_as_json(
+    const std::string& filename, const KnowledgeUpdateSettings& settings)
 {
-  char* current = buffer.get_ptr();
-  const char* meta_reader = current;
-
-  // read the meta data at the front
-  // fseek (file, 0, SEEK_SET);
-  file.seekg(0, file.beg);
-  // size_t ret = fread (current, meta.encoded_size (), 1, file);
-
-  if (!file.read(buffer.get(), FileHeader::encoded_size()))
-  {
-    madara_logger_checked_ptr_log(logger_, logger::LOG_ERROR,
-        "ThreadSafeContext::save_checkpoint:"
-        " failed to read existing file header: size=%d\n",
-        (int)meta.encoded_size());
-
-    throw exceptions::MemoryException(
-        "ThreadSafeContext::save_checkpoint:"
-        "Checkpoint file appears to have been corrupted. Bad header.");
-  }
-
-  meta_reader = meta.read(meta_reader, buffer_remaining);
-
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-      "ThreadSafeContext::save_checkpoint:"
-      " init file meta: size=%d, states=%d\n",
-      (int)meta.size, (int)meta.states);
-
-  if (settings.originator != "")
-  {
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " setting file meta id to %s\n",
-        settings.originator.c_str());
-
-    utility::strncpy_safe(meta.originator, settings.originator.c_str(),
-        sizeof(meta.originator) < settings.originator.size() + 1
-            ? sizeof(meta.originator)
-            : settings.originator.size() + 1);
-  }
-
-  // save the spot where the file ends
-  uint64_t checkpoint_start = meta.size + (uint64_t)FileHeader::encoded_size();
-
-  checkpoint_header.size = checkpoint_header.encoded_size();
-
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-      "ThreadSafeContext::save_checkpoint:"
-      " meta.size=%d, chkpt.header.size=%d \n",
-      (int)meta.size, (int)checkpoint_header.size);
-
-  if (settings.override_timestamp)
-  {
-    meta.initial_timestamp = settings.initial_timestamp;
-    meta.last_timestamp = settings.last_timestamp;
-  }
-
-  if (settings.override_lamport)
-  {
-    checkpoint_header.clock = settings.initial_lamport_clock;
-  }
-  else
-  {
-    checkpoint_header.clock = clock_;
-  }
+  CheckpointSettings checkpoint_settings;
+  checkpoint_settings.filename = filename;
 
-  return checkpoint_start;
+  return load_as_json(checkpoint_settings, settings);
 }
 
-static char* init_checkpoint_header(logger::Logger* logger_, uint64_t clock_,
-    const CheckpointSettings& settings, FileHeader& meta,
-    transport::MessageHeader& checkpoint_header, int64_t& buffer_remaining,
-    utility::ScopedArray<char>& buffer)
+int64_t ThreadSafeContext::load_as_json(CheckpointSettings& checkpoint_settings,
+    const KnowledgeUpdateSettings& update_settings)
 {
-  char* current = buffer.get_ptr();
-
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-      "ThreadSafeContext::save_checkpoint:"
-      " creating file meta. file.meta.size=%d, state.size=%d\n",
-      (int)meta.size, (int)checkpoint_header.encoded_size());
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MAJOR,
+      "ThreadSafeContext::load_as_json:"
+      " opening file %s\n",
+      checkpoint_settings.filename.c_str());
 
-  meta.size += checkpoint_header.encoded_size();
-  checkpoint_header.size = checkpoint_header.encoded_size();
+  std::string json;
 
-  if (settings.override_timestamp)
+  // buffer filters decode the whole file at once
+  if (checkpoint_settings.buffer_filters.size() > 0)
   {
-    meta.initial_timestamp = settings.initial_timestamp;
-    meta.last_timestamp = settings.last_timestamp;
-  }
+    json = file_to_string(checkpoint_settings);
 
-  current = meta.write(current, buffer_remaining);
-
-  if (settings.override_lamport)
-  {
-    checkpoint_header.clock = settings.initial_lamport_clock;
+    if (json.size() == 0)
+    {
+      return -2;
+    }
   }
   else
   {
-    checkpoint_header.clock = clock_;
-  }
-
-  current = checkpoint_header.write(current, buffer_remaining);
+    std::ifstream file(checkpoint_settings.filename, std::ios::binary);
 
-  return current;
-}
-
-static void checkpoint_write_record(logger::Logger* logger_,
-    const std::string& name, const KnowledgeRecord* record,
-    const CheckpointSettings& settings,
-    transport::MessageHeader& checkpoint_header, char*& current,
-    utility::ScopedArray<char>& buffer, int64_t& buffer_remaining)
-{
-  if (record->exists())
-  {
-    // check if the prefix is allowed
-    if (settings.prefixes.size() > 0)
+    if (!file)
     {
       madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-          "ThreadSafeContext::save_checkpoint:"
-          " we have %d prefixes to check against.\n",
-          (int)settings.prefixes.size());
-
-      bool prefix_found = false;
-      for (size_t j = 0; j < settings.prefixes.size() && !prefix_found; ++j)
-      {
-        madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-            "ThreadSafeContext::save_checkpoint:"
-            " checking record %s against prefix %s.\n",
-            name.c_str(), settings.prefixes[j].c_str());
-
-        if (madara::utility::begins_with(name, settings.prefixes[j]))
-        {
-          prefix_found = true;
-        }
-      }  // end for j->prefixes.size
+          "ThreadSafeContext::load_as_json:"
+          " couldn't open json file: %s.\n",
+          checkpoint_settings.filename.c_str());
 
-      if (!prefix_found)
-      {
-        madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-            "ThreadSafeContext::save_checkpoint:"
-            " record has the wrong prefix. Rejected.\n");
-
-        return;
-      }
-    }  // end if prefixes exists
+      return -1;
+    }
 
-    // get the encoded size of the record for checking buffer boundaries
-    int64_t encoded_size = record->get_encoded_size(name);
+    json.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+  }
 
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " estimated encoded size of update=%d bytes\n",
-        (int)encoded_size);
+  // parse without the lock, and then clear and apply everything under it
+  // once, so an invalid file leaves the context as it was
+  JsonRecordParser::Records records;
+  JsonRecordParser parser(json);
 
-    if (encoded_size > buffer_remaining)
-    {
-      throw exceptions::MemoryException(
-          "ThreadSafeContext::save_checkpoint: "
-          "%d buffer size is not big enough. Partial encoded size "
-          "already hit %d bytes. CheckpointSettings.buffer_size is "
-          "needs to be larger.");
-    }  // end if larger than buffer remaining
+  if (!parser.parse(records))
+  {
+    madara_logger_checked_ptr_log(logger_, logger::LOG_ERROR,
+        "ThreadSafeContext::load_as_json:"
+        " %s at offset %d of %s.\n",
+        parser.error(), (int)parser.offset(),
+        checkpoint_settings.filename.c_str());
 
-    auto pre_write = current;
-    current = record->write(current, name, buffer_remaining);
-    encoded_size = current - pre_write;
+    return -2;
+  }
 
-    ++checkpoint_header.updates;
-    checkpoint_header.size += (uint64_t)encoded_size;
+  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
+      "ThreadSafeContext::load_as_json:"
+      " parsed %d records from %d bytes\n",
+      (int)records.size(), (int)json.size());
 
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " chkpt.header.size=%d, current->buffer delta=%d\n",
-        (int)checkpoint_header.size, (int)(current - buffer.get_ptr()));
-  }  // if record exists
-}
+  MADARA_GUARD_TYPE guard(mutex_);
 
-namespace
-{
-class ContextLocalModifiedsLister : public VariablesLister
-{
-public:
-  ContextLocalModifiedsLister(const ThreadSafeContext& context)
-    : context_(&context)
+  if (checkpoint_settings.clear_knowledge)
   {
+    this->clear();
   }
 
-  void start(const CheckpointSettings& settings) override
+  for (auto& record : records)
   {
-    guard_.reset(new ContextGuard(*context_));
-    map_ = context_->get_local_modified();
-    iter_ = map_.begin();
-
-    if (settings.reset_checkpoint)
-    {
-      clear_modifieds_ = true;
-    }
+    record.second.clock = clock_;
+    update_record_from_external(record.first, record.second, update_settings);
   }
 
-  std::pair<const char*, const KnowledgeRecord*> next() override
-  {
-    std::pair<const char*, const KnowledgeRecord*> ret{nullptr, nullptr};
-
-    if (iter_ == map_.end())
-    {
-      guard_.reset();
-      if (clear_modifieds_)
-      {
-        context_->reset_checkpoint();
-      }
-      return ret;
-    }
-
-    ret.first = iter_->first;
-    ret.second = iter_->second.get_record_unsafe();
-
-    ++iter_;
-
-    return ret;
-  }
+  return (int64_t)json.size();
+}
 
-private:
-  const ThreadSafeContext* context_;
-  std::unique_ptr<ContextGuard> guard_;
-  VariableReferenceMap map_;
-  VariableReferenceMap::iterator iter_;
-  bool clear_modifieds_ = false;
-};
+/**
+ * Checks if a checkpoint state should be written as a keyframe
+ **/
+static bool checkpoint_is_keyframe(
+    const CheckpointSettings& settings, uint64_t state)
+{
+  return settings.keyframe_interval > 0 &&
+         state % settings.keyframe_interval == 0;
 }
 
 static void checkpoint_write_records(const ThreadSafeContext& context,
     logger::Logger* logger_, const CheckpointSettings& settings,
-    transport::MessageHeader& checkpoint_header, char*& current,
-    utility::ScopedArray<char>& buffer, int64_t& buffer_remaining)
+    transport::MessageHeader& checkpoint_header, CheckpointStateWriter& writer)
 {
   ContextLocalModifiedsLister default_lister(context);
+  ContextAllLister keyframe_lister(context, true);
 
   VariablesLister* lister = settings.variables_lister;
 
-  if (!lister)
+  if (checkpoint_header.type == KEYFRAME)
   {
-    lister = &default_lister;
+    lister = &keyframe_lister;
   }
-
-  lister->start(settings);
-  for (;;)
+  else if (!lister)
   {
-    auto e = lister->next();
-    if (e.second == nullptr)
-    {
-      break;
-    }
-
-    auto record = e.second;
-
-    checkpoint_write_record(logger_, e.first, record, settings,
-        checkpoint_header, current, buffer, buffer_remaining);
+    lister = &default_lister;
   }
+
+  checkpoint_visit_records(logger_, settings, *lister,
+      [&writer](const char* name, const KnowledgeRecord& record) {
+        writer.write(name, record);
+      });
 }
 
 static void checkpoint_do_incremental(const ThreadSafeContext& context,
@@ -2557,101 +3525,40 @@ static void checkpoint_do_incremental(const ThreadSafeContext& context,
     const CheckpointSettings& settings, std::fstream& file, FileHeader& meta,
     transport::MessageHeader& checkpoint_header)
 {
-  int64_t total_written(0);
+  uint64_t checkpoint_start = update_checkpoint_header(
+      logger_, clock_, settings, file, meta, checkpoint_header);
 
-  int64_t max_buffer(settings.buffer_size);
-  int64_t buffer_remaining(max_buffer);
-  utility::ScopedArray<char> buffer = new char[max_buffer];
+  bool keyframe = checkpoint_is_keyframe(settings, meta.states);
 
-  uint64_t checkpoint_start = update_checkpoint_header(logger_, clock_,
-      settings, file, meta, checkpoint_header, buffer_remaining, buffer);
-
-  if (settings.variables_lister != nullptr ||
-      context.get_local_modified().size() != 0)
+  if (keyframe)
   {
-    // skip over the checkpoint header. We'll write this later with the records
-
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " fseek set to %d\n",
-        (int)(checkpoint_start));
-
-    // set the file pointer to the checkpoint header start
-    // fseek (file, (long)checkpoint_start, SEEK_SET);
-    file.seekp(checkpoint_start);
-
-    // start updates just past the checkpoint header's buffer location
-    char* current = checkpoint_header.write(buffer.get_ptr(), buffer_remaining);
-
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " chkpt.header.size=%d, current->buffer delta=%d\n",
-        (int)checkpoint_header.encoded_size(),
-        (int)(current - buffer.get_ptr()));
-
-    checkpoint_write_records(context, logger_, settings, checkpoint_header,
-        current, buffer, buffer_remaining);
-
-    ++meta.states;
-
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
         "ThreadSafeContext::save_checkpoint:"
-        " writing final data to checkpoint for state #%d\n",
+        " writing state #%d as a keyframe\n",
         (int)meta.states);
 
+    checkpoint_header.type = KEYFRAME;
+  }
+
+  if (keyframe || settings.variables_lister != nullptr ||
+      context.get_local_modified().size() != 0)
+  {
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
         "ThreadSafeContext::save_checkpoint:"
-        " chkpt.header: size=%d, updates=%d\n",
-        (int)checkpoint_header.size, (int)checkpoint_header.updates);
-
-    int total_encoded = 0;
-
-    if (buffer_remaining != max_buffer)
-    {
-      total_written = (int64_t)(current - buffer.get_ptr());
-
-      madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-          "ThreadSafeContext::save_checkpoint:"
-          " encoding %d bytes in checkpoint\n",
-          (int)total_written);
-
-      current = checkpoint_header.write(buffer.get_ptr(), buffer_remaining);
-
-      // call decode with any buffer filters
-      total_encoded = settings.encode(
-          buffer.get_ptr(), (int)total_written, (int)max_buffer);
-
-      if (total_encoded < 0)
-      {
-        throw exceptions::FilterException(
-            "ThreadSafeContext::save_context: "
-            "encode () returned a negative encoding size. Bad filter/encode.");
-      }
-
-      madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-          "ThreadSafeContext::save_checkpoint:"
-          " encoded %d bytes in buffer. Writing to disk at offset %d bytes\n",
-          (int)total_encoded, (int)checkpoint_start);
+        " appending state at offset %d\n",
+        (int)(checkpoint_start));
 
-      // if (settings.buffer_filters.size () > 0)
-      // {
-      //   total_encoded += (int)filters::BufferFilterHeader::encoded_size ();
-      // }
+    CheckpointStateWriter writer(
+        logger_, settings, file, checkpoint_start, checkpoint_header);
 
-      file.write(buffer.get_ptr(), total_encoded);
-      // fwrite (buffer.get_ptr (), (size_t)(total_encoded), 1, file);
+    checkpoint_write_records(
+        context, logger_, settings, checkpoint_header, writer);
 
-      meta.size += (uint64_t)total_encoded;
+    ++meta.states;
 
-      madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-          "ThreadSafeContext::save_checkpoint:"
-          " meta.size updated to %d bytes\n",
-          total_encoded, (int)meta.size);
-    }
+    uint64_t total_encoded = writer.finish();
 
-    buffer_remaining = max_buffer;
-    // fseek (file, (long)checkpoint_start, SEEK_SET);
-    file.seekp(0, file.beg);
+    meta.size += total_encoded;
 
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
         "ThreadSafeContext::save_checkpoint:"
@@ -2661,20 +3568,10 @@ static void checkpoint_do_incremental(const ThreadSafeContext& context,
         (int)checkpoint_header.size, (int)total_encoded);
 
     // update the meta data at the front
-    // fseek (file, 0, SEEK_SET);
-
-    madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-        "ThreadSafeContext::save_checkpoint:"
-        " updating file meta data at beginning in the file\n");
-    buffer_remaining = max_buffer;
-    current = meta.write(buffer.get_ptr(), buffer_remaining);
-
-    // fwrite (buffer.get_ptr (), current - buffer.get_ptr (), 1, file);
-    file.write(buffer.get(), FileHeader::encoded_size());
+    checkpoint_write_file_header(file, meta);
 
   }  // if there are local checkpointing records
 
-  // fclose (file);
   file.close();
 }
 
@@ -2683,72 +3580,36 @@ static void checkpoint_do_initial(const ThreadSafeContext& context,
     const CheckpointSettings& settings, std::fstream& file, FileHeader& meta,
     transport::MessageHeader& checkpoint_header)
 {
-  int file_header_size = (int)FileHeader::encoded_size();
+  if (checkpoint_is_keyframe(settings, 0))
+  {
+    checkpoint_header.type = KEYFRAME;
+  }
+
+  init_checkpoint_header(logger_, clock_, settings, meta, checkpoint_header);
 
-  int64_t max_buffer(settings.buffer_size);
-  int64_t buffer_remaining(max_buffer);
-  utility::ScopedArray<char> buffer = new char[max_buffer];
+  // reserve the file meta, which is rewritten once the state size is known
+  checkpoint_write_file_header(file, meta);
 
-  char* current = init_checkpoint_header(logger_, clock_, settings, meta,
-      checkpoint_header, buffer_remaining, buffer);
+  CheckpointStateWriter writer(logger_, settings, file,
+      FileHeader::encoded_size(), checkpoint_header);
 
   madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
       "ThreadSafeContext::save_checkpoint:"
       " writing diff records\n");
 
-  checkpoint_write_records(context, logger_, settings, checkpoint_header,
-      current, buffer, buffer_remaining);
+  checkpoint_write_records(
+      context, logger_, settings, checkpoint_header, writer);
 
-  char* final_position = current;
-  int full_buffer = final_position - buffer.get_ptr();
+  meta.size = writer.finish();
 
   madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
       "ThreadSafeContext::save_checkpoint:"
-      " final_position indicates a buffer of %d bytes,"
-      " encode buffer is %d bytes\n",
-      full_buffer, full_buffer - file_header_size);
-
-  // write the final sizes for the checkpoint at [108]
-  current =
-      checkpoint_header.write(buffer.get_ptr() + file_header_size, max_buffer);
-
-  // call decode with any buffer filters on [108]
-  int total =
-      settings.encode(buffer.get_ptr() + (int)FileHeader::encoded_size(),
-          (int)(full_buffer - file_header_size), (int)max_buffer);
-
-  if (total < 0)
-  {
-    throw exceptions::FilterException(
-        "ThreadSafeContext::save_checkpoint: "
-        "encode () returned a negative encoding size. Bad filter/encode.");
-  }
-
-  meta.size = (uint64_t)total;
-
-  current = meta.write(buffer.get_ptr(), max_buffer);
+      " meta.size=%d, chkpt.size=%d\n",
+      (int)meta.size, (int)checkpoint_header.size);
 
   // update the meta data at the front
-  // fseek (file, 0, SEEK_SET);
-  file.seekp(0, file.beg);
-
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-      "ThreadSafeContext::save_checkpoint:"
-      " encoding with buffer filters: meta.size=%d, chkpt.size=%d, "
-      "encoded=%d, chkpt.offset=%d.\n",
-      (int)meta.size, (int)checkpoint_header.size, (int)total,
-      file_header_size);
-
-  // fwrite (buffer.get_ptr (),
-  //   (size_t)total + (size_t)FileHeader::encoded_size (), 1, file);
-  file.write(buffer.get(), (size_t)total + (size_t)file_header_size);
-
-  madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
-      "ThreadSafeContext::save_checkpoint:"
-      " wrote: %d bytes to file from beginning.\n",
-      (int)total + (int)FileHeader::encoded_size());
+  checkpoint_write_file_header(file, meta);
 
-  // fclose (file);
   file.close();
 }
 
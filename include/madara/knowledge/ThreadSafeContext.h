@@ -11,21 +11,27 @@
 #include "madara/knowledge/FileHeader.h"
 #include "madara/logger/Logger.h"
 
+#include <algorithm>
 #include <string>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
 #include "madara/utility/IntTypes.h"
 
 #include "madara/MadaraExport.h"
 #include "madara/LockType.h"
 #include "madara/knowledge/KnowledgeRecord.h"
+#include "madara/knowledge/DirtyRanges.h"
+#include "madara/knowledge/RecordAggregate.h"
 #include "madara/knowledge/KnowledgeRequirements.h"
 #include "madara/knowledge/VariableReference.h"
 #include "madara/knowledge/FunctionMap.h"
 #include "madara/knowledge/KnowledgeUpdateSettings.h"
 #include "madara/knowledge/KnowledgeReferenceSettings.h"
 #include "madara/knowledge/CompiledExpression.h"
+#include "madara/expression/ExpressionCache.h"
 #include "madara/knowledge/CheckpointSettings.h"
 #include "madara/knowledge/BaseStreamer.h"
 #include "madara/transport/MessageHeader.h"
@@ -136,7 +142,163 @@ public:
       const KnowledgeReferenceSettings& settings =
           KnowledgeReferenceSettings()) const;
 
+  /**
+   * Atomically returns the current value of a variable as a native type,
+   * e.g., get_as<double>. The value is converted from the stored record
+   * while the context is locked, without copying the record.
+   * @param   key       unique identifier of the variable
+   * @param   settings  the settings for referring to variables
+   * @return  the value, or the conversion of an empty record if the
+   *          variable does not exist
+   * @throw exceptions::UninitializedException  if
+   *          settings.exception_on_unitialized is set and the variable
+   *          is unset or does not exist
+   **/
+  template<typename T>
+  T get_as(const std::string& key, const KnowledgeReferenceSettings& settings =
+                                       KnowledgeReferenceSettings()) const;
+
+  /**
+   * Atomically returns the current value of a variable as a native type,
+   * e.g., get_as<double>. The value is converted from the stored record
+   * while the context is locked, without copying the record.
+   * @param   variable  reference to a variable (@see get_ref)
+   * @param   settings  the settings for referring to variables
+   * @return  the value of the variable, or the conversion of an empty
+   *          record if the reference is invalid
+   * @throw exceptions::UninitializedException  if
+   *          settings.exception_on_unitialized is set and the variable
+   *          is unset or the reference is invalid
+   **/
+  template<typename T>
+  T get_as(const VariableReference& variable,
+      const KnowledgeReferenceSettings& settings =
+          KnowledgeReferenceSettings()) const;
+
+  /**
+   * Atomically reads several variables into native values while the
+   * context is locked once, e.g., get_many (x_ref, x, y_ref, y). Each
+   * value is converted as with get_as and the default settings.
+   * @param   variable  reference to the first variable (@see get_ref)
+   * @param   value     the value to read the first variable into
+   * @param   rest      further pairs of references and values
+   **/
+  template<typename T, typename... Args>
+  void get_many(
+      const VariableReference& variable, T& value, Args&&... rest) const;
+
+  /**
+   * Atomically sets the value of a variable from a native type, e.g.,
+   * set_as<int64_t>. Integral types are stored as Integer, floating
+   * point types as double, and other types as their record type.
+   * @param   key       unique identifier of the variable
+   * @param   value     new value of the variable
+   * @param   settings  settings for applying the update
+   * @return   0 if the value was set. -1 if null key
+   **/
+  template<typename T>
+  int set_as(const std::string& key, const T& value,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Atomically sets the value of a variable from a native type, e.g.,
+   * set_as<int64_t>. Integral types are stored as Integer, floating
+   * point types as double, and other types as their record type.
+   * @param   variable  reference to a variable (@see get_ref)
+   * @param   value     new value of the variable
+   * @param   settings  settings for applying the update
+   * @return   0 if the value was set. -1 if null key
+   **/
+  template<typename T>
+  int set_as(const VariableReference& variable, const T& value,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Atomically returns references to several variables, e.g., to read
+   * or write them together with get_all and set_all
+   * @param   keys      unique identifiers of the variables
+   * @param   settings  the settings for referring to variables
+   * @return  references in the order of the keys
+   **/
+  VariableReferences get_refs(const std::vector<std::string>& keys,
+      const KnowledgeReferenceSettings& settings =
+          KnowledgeReferenceSettings());
+
+  /**
+   * Atomically reads several variables while the context is locked once.
+   * The values are a consistent snapshot: no local write or message from
+   * the network is applied between the reads.
+   * @param   variables references to the variables (@see get_refs)
+   * @param   values    the values, in the order of the references
+   * @param   settings  the settings for referring to variables
+   **/
+  void get_all(const VariableReferences& variables,
+      std::vector<KnowledgeRecord>& values,
+      const KnowledgeReferenceSettings& settings =
+          KnowledgeReferenceSettings()) const;
+
+  /**
+   * Atomically reads several variables while the context is locked once.
+   * Variables that do not exist are read as empty records and are not
+   * created.
+   * @param   keys      unique identifiers of the variables
+   * @param   values    the values, in the order of the keys
+   * @param   settings  the settings for referring to variables
+   **/
+  void get_all(const std::vector<std::string>& keys,
+      std::vector<KnowledgeRecord>& values,
+      const KnowledgeReferenceSettings& settings =
+          KnowledgeReferenceSettings()) const;
+
+  /**
+   * Atomically sets several variables while the context is locked once.
+   * Waiters are signaled once, after all of the values are set.
+   * @param   variables references to the variables (@see get_refs)
+   * @param   values    the new values, in the order of the references
+   * @param   settings  settings for applying the update
+   * @return   0 if all values were set. -1 if the number of values does
+   *           not match or a reference is invalid. -2 if the quality of
+   *           a variable was higher than the write quality.
+   **/
+  int set_all(const VariableReferences& variables,
+      const std::vector<KnowledgeRecord>& values,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Atomically sets several variables while the context is locked once.
+   * Waiters are signaled once, after all of the values are set.
+   * @param   keys      unique identifiers of the variables
+   * @param   values    the new values, in the order of the keys
+   * @param   settings  settings for applying the update
+   * @return   0 if all values were set, or the error of set_all with
+   *           references
+   **/
+  int set_all(const std::vector<std::string>& keys,
+      const std::vector<KnowledgeRecord>& values,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
 private:
+  /**
+   * Converts the value of a variable as get_as does, with the same checks
+   * as get. The context must be locked.
+   **/
+  template<typename T>
+  T get_as_unsafe(const VariableReference& variable,
+      const KnowledgeReferenceSettings& settings) const;
+
+  /**
+   * Reads pairs of references and values for get_many with the default
+   * settings. The context must be locked.
+   **/
+  template<typename T, typename... Args>
+  void get_many_unsafe(
+      const VariableReference& variable, T& value, Args&&... rest) const;
+
+  /**
+   * Ends the recursion of get_many_unsafe
+   **/
+  void get_many_unsafe(void) const {}
+
   /**
    * Atomically returns a reference to the variable
    * @param   key       unique identifier of the variable
@@ -706,10 +868,11 @@ public:
 
   /**
    * Retrieves a list of modified variables. Useful for building a
-   * disseminatable knowledge update.
-   * @return  the modified knowledge records
+   * disseminatable knowledge update. The sorted map is built on each
+   * call, so prefer get_modifieds_current or save_modifieds in hot paths.
+   * @return  a snapshot of the modified knowledge records
    **/
-  const VariableReferenceMap& get_modifieds(void) const;
+  VariableReferenceMap get_modifieds(void) const;
 
   /**
    * Retrieves the current modifieds map
@@ -720,6 +883,26 @@ public:
   KnowledgeMap get_modifieds_current(
       const std::map<std::string, bool> & send_list, bool reset = true);
 
+  /**
+   * Returns the dirty ranges of the array records returned by the most
+   * recent get_modifieds_current call, for records whose changes since
+   * their previous send were all ranged. Each entry holds the toi of the
+   * record when the ranges were taken, so that stale entries can be
+   * detected by callers.
+   * @return  the dirty ranges of sent array records, keyed by name
+   **/
+  std::shared_ptr<const DirtyRangesMap> share_sent_ranges(void) const;
+
+  /**
+   * Returns a counter that changes whenever variables are erased from the
+   * context, e.g., by delete_variable or clear(true). Erasures invalidate
+   * VariableReferences to the erased variables, so holders of cached
+   * references can compare this counter to detect stale references. The
+   * caller should hold the context lock.
+   * @return  the number of erasures so far
+   **/
+  uint64_t get_erase_generation(void) const;
+
   /**
    * Adds a list of VariableReferences to the current modified list.
    * @param  modifieds  a list of variables to add to modified list
@@ -745,10 +928,10 @@ public:
 
   /**
    * Retrieves a list of modified local variables. Useful for building a
-   * comprehensive checkpoint.
-   * @return  the modified knowledge records
+   * comprehensive checkpoint. The sorted map is built on each call.
+   * @return  a snapshot of the modified knowledge records
    **/
-  const VariableReferenceMap& get_local_modified(void) const;
+  VariableReferenceMap get_local_modified(void) const;
 
   /**
    * Reset all variables to be unmodified. This will clear all global
@@ -776,6 +959,20 @@ public:
   void mark_modified(const VariableReference& variable,
       const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
 
+  /**
+   * Marks a range of an array variable as updated for the purposes of
+   * sending or checkpointing knowledge. If every change to the variable
+   * since it was last sent was ranged (including set_index), transports
+   * with send_array_deltas enabled send only the changed ranges.
+   * @param   variable  reference to an array variable (@see get_ref)
+   * @param   index     the first modified index
+   * @param   count     the number of modified indices
+   * @param  settings  the settings for referring to variables
+   **/
+  void mark_modified(const VariableReference& variable, size_t index,
+      size_t count,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
   /**
    * Changes global variables to modified at current clock for the purposes
    * of sending or checkpointing knowledge (globals and locals respectively)
@@ -821,6 +1018,24 @@ public:
   void mark_to_checkpoint(const std::string& key,
       const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
 
+  /**
+   * Attaches an aggregate to its contributor records, so it is updated
+   * whenever one of them changes, locally or from the network. An
+   * aggregate attached elsewhere is detached first. If a contributor is
+   * deleted, it no longer contributes to the aggregate.
+   * @param  aggregate     the aggregate, which detaches itself when it
+   *                       is destroyed
+   * @param  contributors  references to the contributors, in order
+   **/
+  void attach_aggregate(RecordAggregate& aggregate,
+      const std::vector<VariableReference>& contributors);
+
+  /**
+   * Stops updating an aggregate
+   * @param  aggregate     the aggregate
+   **/
+  void detach_aggregate(RecordAggregate& aggregate);
+
   /**
    * Resets a variable to unmodified
    * @param   key            unique identifier of the variable
@@ -1146,6 +1361,21 @@ public:
    **/
   CompiledExpression compile(const std::string& expression);
 
+  /**
+   * Returns the hit, miss and eviction statistics of the cache of
+   * compiled expressions
+   * @return                   the expression cache statistics
+   **/
+  expression::ExpressionCacheStats get_expression_cache_stats(void) const;
+
+  /**
+   * Changes the maximum number of compiled expressions that are cached.
+   * The least recently used expressions are dropped first.
+   * @param  capacity          the maximum number of cached expressions.
+   *                           0 disables the cache.
+   **/
+  void set_expression_cache_capacity(size_t capacity);
+
   /**
    * Defines an external function
    * @param  name       name of the function
@@ -1483,6 +1713,37 @@ public:
       const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
           true, true, true, false));
 
+  /**
+   * Loads a JSON file, e.g., from save_as_json, into the context. The
+   * file is parsed directly rather than evaluated as KaRL, and the
+   * parsed records are applied under one lock. Nested objects become
+   * dotted variable names, arrays of numbers become native arrays and
+   * other arrays become name.0 to name.N-1 plus name.size.
+   * @param   filename    name of the file to open
+   * @param   settings    settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   **/
+  int64_t load_as_json(const std::string& filename,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
+  /**
+   * Loads a JSON file, e.g., from save_as_json, into the context
+   * @see load_as_json (const std::string&, const KnowledgeUpdateSettings&)
+   * @param   checkpoint_settings  the filename, buffer filters and
+   *                               clear_knowledge setting to load with
+   * @param   update_settings      settings for applying the updates
+   * @return              -1 if file open failed<br />
+   *                      -2 if file read or parse failed<br />
+   *                      >0 if successful (number of bytes read)
+   * @throw exceptions::FilterException  a buffer filter failed
+   **/
+  int64_t load_as_json(CheckpointSettings& checkpoint_settings,
+      const KnowledgeUpdateSettings& update_settings = KnowledgeUpdateSettings(
+          true, true, true, false));
+
   /**
    * Loads and evaluates a karl script from a file
    * @param   checkpoint_settings  checkpoint settings to load
@@ -1665,6 +1926,57 @@ public:
 
 protected:
 private:
+  /**
+   * Flags kept in each record's context_flags_ to track which modified
+   * lists the record is in, so that marking a record is O(1)
+   **/
+  enum ModifiedFlags : uint8_t
+  {
+    /// the record is in changed_list_
+    MODIFIED_TO_SEND = 1,
+
+    /// the record is in local_changed_list_
+    MODIFIED_TO_CHECKPOINT = 2,
+
+    /// the record contributes to an aggregate in aggregates_
+    AGGREGATED = 4
+  };
+
+  /**
+   * Unmarks every record in a modified list and empties the list
+   * @param  list   the modified list
+   * @param  flag   the flag that marks records in the list
+   **/
+  void clear_modifieds_unsafe(VariableReferences& list, uint8_t flag) const;
+
+  /**
+   * Removes the records that are no longer marked from a modified list.
+   * Records must be unmarked with this before being erased from the map.
+   * @param  list   the modified list
+   * @param  flag   the flag that marks records in the list
+   **/
+  void compact_modifieds_unsafe(VariableReferences& list, uint8_t flag) const;
+
+  /**
+   * Unmarks a record that is about to be erased from the map, and
+   * removes it from any aggregates it contributes to
+   * @param  record   the record
+   * @return true if the record was in either modified list
+   **/
+  bool unmark_unsafe(KnowledgeRecord& record);
+
+  /**
+   * Updates the aggregates a changed record contributes to
+   * @param  record   the record
+   **/
+  void update_aggregates_unsafe(const KnowledgeRecord& record);
+
+  /**
+   * Removes a record that is about to be erased from its aggregates
+   * @param  record   the record
+   **/
+  void remove_aggregated_unsafe(KnowledgeRecord& record);
+
   /**
    * Changes variable to modified at current clock, and queues it to send,
    * even if it is a local that would not ordinarily be sent. Skips all
@@ -1692,6 +2004,27 @@ private:
   void mark_and_signal(VariableReference ref,
       const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
 
+  /**
+   * method for marking a range of an array record modified and signaling
+   * changes
+   * @param  ref       a reference to a variable in the knowledge base
+   * @param  index     the first modified index
+   * @param  count     the number of modified indices
+   * @param  settings  settings for applying modification and signalling
+   **/
+  void mark_range_and_signal(VariableReference ref, size_t index,
+      size_t count,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Signals changes and handles checkpointing and streaming of a modified
+   * record. Shared by mark_and_signal and mark_range_and_signal.
+   * @param  ref       a reference to a variable in the knowledge base
+   * @param  settings  settings for applying modification and signalling
+   **/
+  void checkpoint_and_signal(VariableReference ref,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
   template<typename... Args>
   int set_unsafe_impl(const VariableReference& variable,
       const KnowledgeUpdateSettings& settings, Args&&... args);
@@ -1713,8 +2046,33 @@ private:
   mutable MADARA_CONDITION_TYPE changed_;
   std::vector<std::string> expansion_splitters_;
   mutable uint64_t clock_;
-  mutable VariableReferenceMap changed_map_;
-  mutable VariableReferenceMap local_changed_map_;
+
+  /// records queued to send, each marked with MODIFIED_TO_SEND
+  mutable VariableReferences changed_list_;
+
+  /// records queued to checkpoint, each marked with MODIFIED_TO_CHECKPOINT
+  mutable VariableReferences local_changed_list_;
+
+  /// threads blocked in wait_for_change, so sets only signal when needed
+  mutable size_t waiters_ = 0;
+
+  /// incremented whenever variables are erased from map_
+  uint64_t erase_generation_ = 0;
+
+  /// dirty ranges of modified arrays whose changes have all been ranged
+  mutable std::map<std::string, DirtyRanges, std::less<>> dirty_ranges_;
+
+  /// dirty ranges taken by the most recent get_modifieds_current
+  std::shared_ptr<const DirtyRangesMap> sent_ranges_;
+
+  /// the aggregates each record marked AGGREGATED contributes to, with the
+  /// index of the record among the contributors of the aggregate
+  std::unordered_map<const KnowledgeRecord*,
+      std::vector<std::pair<RecordAggregate*, size_t>>>
+      aggregates_;
+
+  /// every attached aggregate, including ones whose records were erased
+  std::vector<RecordAggregate*> attached_aggregates_;
 
   /// map of function names to functions
   FunctionMap functions_;
@@ -135,6 +135,111 @@ inline KnowledgeRecord ThreadSafeContext::get_actual(
   return KnowledgeRecord();
 }
 
+template<typename T>
+inline T ThreadSafeContext::get_as(
+    const std::string& key, const KnowledgeReferenceSettings& settings) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  const KnowledgeRecord* ret = with(key, settings);
+  if (ret)
+  {
+    if (settings.exception_on_unitialized && !ret->exists())
+    {
+      std::stringstream buffer;
+      buffer << "ERROR: settings do not allow reads of unset vars and ";
+      buffer << key << " is uninitialized";
+      throw exceptions::UninitializedException (buffer.str ());
+    }
+
+    return knowledge_cast<T>(*ret);
+  }
+  else if (settings.exception_on_unitialized)
+  {
+    std::stringstream buffer;
+    buffer << "ERROR: settings do not allow reads of unset vars and ";
+    buffer << key << " is uninitialized";
+    throw exceptions::UninitializedException (buffer.str ());
+  }
+
+  const KnowledgeRecord empty;
+  return knowledge_cast<T>(empty);
+}
+
+template<typename T>
+inline T ThreadSafeContext::get_as(const VariableReference& variable,
+    const KnowledgeReferenceSettings& settings) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return get_as_unsafe<T>(variable, settings);
+}
+
+template<typename T, typename... Args>
+inline void ThreadSafeContext::get_many(
+    const VariableReference& variable, T& value, Args&&... rest) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  get_many_unsafe(variable, value, std::forward<Args>(rest)...);
+}
+
+template<typename T>
+inline T ThreadSafeContext::get_as_unsafe(const VariableReference& variable,
+    const KnowledgeReferenceSettings& settings) const
+{
+  if (variable.is_valid())
+  {
+    const KnowledgeRecord* ret = with(variable, settings);
+
+    if (settings.exception_on_unitialized && !ret->exists())
+    {
+      std::stringstream buffer;
+      buffer << "ERROR: settings do not allow reads of unset vars and ";
+      buffer << variable.get_name() << " is uninitialized";
+      throw exceptions::UninitializedException (buffer.str ());
+    }
+
+    return knowledge_cast<T>(*ret);
+  }
+  else if (settings.exception_on_unitialized)
+  {
+    throw exceptions::UninitializedException (
+        "ERROR: settings do not allow reads of unset vars and "
+        "the variable reference is invalid");
+  }
+
+  const KnowledgeRecord empty;
+  return knowledge_cast<T>(empty);
+}
+
+template<typename T, typename... Args>
+inline void ThreadSafeContext::get_many_unsafe(
+    const VariableReference& variable, T& value, Args&&... rest) const
+{
+  const KnowledgeReferenceSettings settings;
+
+  value = get_as_unsafe<T>(variable, settings);
+
+  get_many_unsafe(std::forward<Args>(rest)...);
+}
+
+template<typename T>
+inline int ThreadSafeContext::set_as(const std::string& key, const T& value,
+    const KnowledgeUpdateSettings& settings)
+{
+  return set(key, static_cast<typename impl::storage_type<T>::type>(value),
+      settings);
+}
+
+template<typename T>
+inline int ThreadSafeContext::set_as(const VariableReference& variable,
+    const T& value, const KnowledgeUpdateSettings& settings)
+{
+  return set(variable,
+      static_cast<typename impl::storage_type<T>::type>(value), settings);
+}
+
 inline KnowledgeRecord* ThreadSafeContext::with(
     const std::string& key, const KnowledgeReferenceSettings& settings)
 {
@@ -445,11 +550,22 @@ inline int ThreadSafeContext::set_index_unsafe(
     const VariableReference& variable, size_t index, T&& value,
     const KnowledgeUpdateSettings& settings)
 {
+  auto record = variable.get_record_unsafe();
+  uint32_t type = record->type();
+  uint32_t size = record->size();
+
   int ret =
       set_index_unsafe_impl(variable, index, std::forward<T>(value), settings);
 
   if (ret == 0)
-    mark_and_signal(variable, settings);
+  {
+    // a resize or type conversion changes the whole array
+    if (record->type() == type && record->size() == size &&
+        !record->has_history())
+      mark_range_and_signal(variable, index, 1, settings);
+    else
+      mark_and_signal(variable, settings);
+  }
 
   return ret;
 }
@@ -571,12 +687,21 @@ inline bool ThreadSafeContext::delete_variable(
   else
     key_ptr = &key;
 
-  // erase any changed or local changed map entries
-  changed_map_.erase(key_ptr->c_str());
-  local_changed_map_.erase(key_ptr->c_str());
+  auto found = map_.find(*key_ptr);
 
-  // erase the map
-  result = map_.erase(*key_ptr) == 1;
+  if (found != map_.end())
+  {
+    // drop the record from the changed and local changed lists
+    if (unmark_unsafe(found->second))
+    {
+      compact_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+      compact_modifieds_unsafe(local_changed_list_, MODIFIED_TO_CHECKPOINT);
+    }
+
+    map_.erase(found);
+    ++erase_generation_;
+    result = true;
+  }
 
   return result;
 }
@@ -588,23 +713,45 @@ inline bool ThreadSafeContext::delete_variable(
   // enter the mutex
   MADARA_GUARD_TYPE guard(mutex_);
 
-  // erase any changed or local changed map entries
-  changed_map_.erase(var.entry_->first.c_str());
-  local_changed_map_.erase(var.entry_->first.c_str());
+  auto found = map_.find(var.entry_->first);
+
+  if (found == map_.end())
+    return false;
+
+  // drop the record from the changed and local changed lists
+  if (unmark_unsafe(found->second))
+  {
+    compact_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+    compact_modifieds_unsafe(local_changed_list_, MODIFIED_TO_CHECKPOINT);
+  }
+
+  map_.erase(found);
+  ++erase_generation_;
 
-  // erase the map
-  return map_.erase(var.entry_->first.c_str()) == 1;
+  return true;
 }
 
 inline void ThreadSafeContext::delete_variables(KnowledgeMap::iterator begin,
     KnowledgeMap::iterator end, const KnowledgeReferenceSettings&)
 {
+  bool marked = false;
+
   for (auto cur = begin; cur != end; ++cur)
   {
-    changed_map_.erase(cur->first.c_str());
-    local_changed_map_.erase(cur->first.c_str());
+    marked = unmark_unsafe(cur->second) || marked;
+  }
+
+  if (marked)
+  {
+    compact_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+    compact_modifieds_unsafe(local_changed_list_, MODIFIED_TO_CHECKPOINT);
+  }
+
+  if (begin != end)
+  {
+    map_.erase(begin, end);
+    ++erase_generation_;
   }
-  map_.erase(begin, end);
 }
 
 // return whether or not the key exists
@@ -840,12 +987,27 @@ inline void ThreadSafeContext::clear(bool erase)
   // enter the mutex
   MADARA_GUARD_TYPE guard(mutex_);
 
-  changed_map_.clear();
-  local_changed_map_.clear();
+  clear_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+  clear_modifieds_unsafe(local_changed_list_, MODIFIED_TO_CHECKPOINT);
+  dirty_ranges_.clear();
+
+  // the contributors of aggregates are erased or reset below
+  for (auto aggregate : attached_aggregates_)
+  {
+    aggregate->reset();
+  }
 
   if (erase)
   {
+    for (auto aggregate : attached_aggregates_)
+    {
+      aggregate->records_.assign(aggregate->records_.size(), nullptr);
+    }
+
+    aggregates_.clear();
+
     map_.clear();
+    ++erase_generation_;
   }
   else
   {
@@ -872,7 +1034,9 @@ inline void ThreadSafeContext::wait_for_change(bool extra_release)
   if (extra_release)
     mutex_.MADARA_LOCK_UNLOCK();
 
+  ++waiters_;
   changed_.wait(mutex_);
+  --waiters_;
 
   // if (extra_release)
   //  mutex_.MADARA_LOCK_LOCK ();
@@ -899,9 +1063,22 @@ inline void ThreadSafeContext::mark_to_send(
 inline void ThreadSafeContext::mark_to_send_unsafe(
     VariableReference ref, const KnowledgeUpdateSettings&)
 {
-  changed_map_[ref.get_name()] = std::move(ref);
+  // a whole-record change invalidates any ranged changes
+  if (!dirty_ranges_.empty())
+  {
+    auto found = dirty_ranges_.find(ref.get_name());
+    if (found != dirty_ranges_.end())
+      dirty_ranges_.erase(found);
+  }
 
   KnowledgeRecord& record = *ref.get_record_unsafe();
+
+  if (!(record.context_flags_ & MODIFIED_TO_SEND))
+  {
+    record.context_flags_ |= MODIFIED_TO_SEND;
+    changed_list_.push_back(std::move(ref));
+  }
+
   if (record.status() != KnowledgeRecord::MODIFIED)
     record.set_modified();
 }
@@ -927,9 +1104,14 @@ inline void ThreadSafeContext::mark_to_checkpoint(
 inline void ThreadSafeContext::mark_to_checkpoint_unsafe(
     VariableReference ref, const KnowledgeUpdateSettings&)
 {
-  local_changed_map_[ref.get_name()] = std::move(ref);
-
   KnowledgeRecord& record = *ref.get_record_unsafe();
+
+  if (!(record.context_flags_ & MODIFIED_TO_CHECKPOINT))
+  {
+    record.context_flags_ |= MODIFIED_TO_CHECKPOINT;
+    local_changed_list_.push_back(std::move(ref));
+  }
+
   if (record.status() != KnowledgeRecord::MODIFIED)
     record.set_modified();
 }
@@ -942,8 +1124,57 @@ inline void ThreadSafeContext::mark_and_signal(
   {
     if (!settings.treat_globals_as_locals)
     {
-      mark_to_send_unsafe(std::move(ref));
+      mark_to_send_unsafe(ref);
+    }
+  }
+
+  checkpoint_and_signal(std::move(ref), settings);
+}
+
+inline void ThreadSafeContext::mark_range_and_signal(VariableReference ref,
+    size_t index, size_t count, const KnowledgeUpdateSettings& settings)
+{
+  const char* name = ref.get_name();
+
+  if ((name[0] != '.' || settings.treat_locals_as_globals) &&
+      !settings.treat_globals_as_locals)
+  {
+    KnowledgeRecord& record = *ref.get_record_unsafe();
+
+    if (!(record.context_flags_ & MODIFIED_TO_SEND))
+    {
+      // first change since the last send, so start tracking ranges
+      DirtyRanges& ranges = dirty_ranges_[name];
+      ranges.clear();
+      ranges.add(index, count);
+
+      if (record.status() != KnowledgeRecord::MODIFIED)
+        record.set_modified();
+
+      record.context_flags_ |= MODIFIED_TO_SEND;
+      changed_list_.push_back(ref);
     }
+    else
+    {
+      // ranges are only tracked if all changes since the last send were
+      // ranged. Otherwise, the whole record is sent.
+      auto found = dirty_ranges_.find(name);
+      if (found != dirty_ranges_.end())
+        found->second.add(index, count);
+    }
+  }
+
+  checkpoint_and_signal(std::move(ref), settings);
+}
+
+inline void ThreadSafeContext::checkpoint_and_signal(
+    VariableReference ref, const KnowledgeUpdateSettings& settings)
+{
+  // every change of a record passes through here, so aggregates of the
+  // record are kept current without scanning their contributors
+  if (ref.get_record_unsafe()->context_flags_ & AGGREGATED)
+  {
+    update_aggregates_unsafe(*ref.get_record_unsafe());
   }
 
   // track local changes now checkpoints all state, not just local
@@ -963,7 +1194,9 @@ inline void ThreadSafeContext::mark_and_signal(
     streamer_->enqueue(ref.get_name(), *rec_ptr);
   }
 
-  if (settings.signal_changes)
+  // only wake waiters when there are any. Sets are frequent and waiters
+  // are rare, so this saves a broadcast on nearly every set.
+  if (settings.signal_changes && waiters_ > 0)
     changed_.MADARA_CONDITION_NOTIFY_ALL();
 }
 
@@ -988,16 +1221,33 @@ inline void ThreadSafeContext::mark_modified(
   mark_and_signal(ref, settings);
 }
 
+inline void ThreadSafeContext::mark_modified(const VariableReference& ref,
+    size_t index, size_t count, const KnowledgeUpdateSettings& settings)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  auto record = ref.get_record_unsafe();
+
+  record->clock = clock_;
+  record->set_toi(utility::get_time());
+
+  if (record->is_array_type() && !record->has_history() &&
+      index + count <= record->size())
+    mark_range_and_signal(ref, index, count, settings);
+  else
+    mark_and_signal(ref, settings);
+}
+
 inline std::string ThreadSafeContext::debug_modifieds(void) const
 {
   MADARA_GUARD_TYPE guard(mutex_);
   std::stringstream result;
 
-  result << changed_map_.size() << " modifications ready to send:\n";
+  result << changed_list_.size() << " modifications ready to send:\n";
 
-  for (auto& entry : changed_map_)
+  for (auto& entry : changed_list_)
   {
-    KnowledgeRecord& record = *entry.second.get_record_unsafe();
+    KnowledgeRecord& record = *entry.get_record_unsafe();
     if (record.is_binary_file_type())
     {
       result << "File: ";
@@ -1027,18 +1277,25 @@ inline std::string ThreadSafeContext::debug_modifieds(void) const
       result << "Unknown: ";
     }
 
-    result << entry.first << " = " << record.to_string() << "\n";
+    result << entry.get_name() << " = " << record.to_string() << "\n";
   }
 
   return result.str();
 }
 
 /// Return list of variables that have been modified
-inline const VariableReferenceMap& ThreadSafeContext::get_modifieds(void) const
+inline VariableReferenceMap ThreadSafeContext::get_modifieds(void) const
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
-  return changed_map_;
+  VariableReferenceMap changed_map;
+
+  for (auto& entry : changed_list_)
+  {
+    changed_map.emplace(entry.get_name(), entry);
+  }
+
+  return changed_map;
 }
 
 inline KnowledgeMap ThreadSafeContext::get_modifieds_current(
@@ -1047,83 +1304,126 @@ inline KnowledgeMap ThreadSafeContext::get_modifieds_current(
   MADARA_GUARD_TYPE guard(mutex_);
 
   KnowledgeMap map;
+  std::shared_ptr<DirtyRangesMap> sent_ranges;
 
-  // if there are no limiting prefixes, iterate through and reset
-  if (send_list.size() == 0)
-  {
-    for (auto i = changed_map_.begin();
-         i != changed_map_.end(); )
+  bool taken = false;
+
+  // copies a modified record and hands over its ranges, if tracked. The
+  // copy may be read after the lock is released, so the record must copy
+  // its value before changing it again.
+  auto take = [&](const char* name, KnowledgeRecord& record) {
+    record.share();
+    map.emplace(name, record);
+
+    if (!dirty_ranges_.empty())
     {
-      map.emplace_hint (map.end(),
-        i->first, *i->second.get_record_unsafe());
+      auto found = dirty_ranges_.find(name);
 
-      if (reset)
+      if (found != dirty_ranges_.end())
       {
-        i = changed_map_.erase(i);
+        if (!sent_ranges)
+          sent_ranges = std::make_shared<DirtyRangesMap>();
+
+        DirtyRanges& ranges = (*sent_ranges)[found->first];
+        ranges = found->second;
+        ranges.toi = record.toi();
+
+        if (reset)
+          dirty_ranges_.erase(found);
       }
     }
+
+    if (reset)
+    {
+      record.context_flags_ &= ~MODIFIED_TO_SEND;
+      taken = true;
+    }
+  };
+
+  // if there are no limiting prefixes, take everything
+  if (send_list.size() == 0)
+  {
+    for (auto& entry : changed_list_)
+    {
+      take(entry.get_name(), *entry.get_record_unsafe());
+    }
+
+    if (reset)
+    {
+      changed_list_.clear();
+      taken = false;
+    }
   }
-  // if there are limiting prefixes, only copy over the prefixes
-  else
+  // if the send list is smaller than the changed list, look up its entries
+  else if (send_list.size() < changed_list_.size())
   {
-    // if the prefixes list is smaller than the changed_map_
-    if (send_list.size() < changed_map_.size())
+    for (auto& var : send_list)
     {
-      for (auto var : send_list)
-      {
-        auto found = changed_map_.find(var.first.c_str());
+      auto found = map_.find(var.first);
 
-        if (found != changed_map_.end())
-        {
-          map.emplace_hint(
-            map.end(), found->first, *found->second.get_record_unsafe());
-          changed_map_.erase(found);
-        }
+      if (found != map_.end() &&
+          (found->second.context_flags_ & MODIFIED_TO_SEND))
+      {
+        take(found->first.c_str(), found->second);
       }
     }
-    // else if the changed_map_ is smaller than the prefixes list
-    else
+  }
+  // else walk the changed list and filter by the send list
+  else
+  {
+    for (auto& entry : changed_list_)
     {
-      for (auto i = changed_map_.begin(); i != changed_map_.end();)
+      if (send_list.find(entry.get_name()) != send_list.end())
       {
-        if (send_list.find (i->first) != send_list.end())
-        {
-          map.emplace_hint (map.end(),
-            i->first, *i->second.get_record_unsafe());
-
-          if (reset)
-          {
-            i = changed_map_.erase (i);
-          }
-        }
+        take(entry.get_name(), *entry.get_record_unsafe());
       }
     }
   }
 
+  if (taken)
+  {
+    compact_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+  }
+
+  sent_ranges_ = std::move(sent_ranges);
+
   return map;
 }
 
+inline uint64_t ThreadSafeContext::get_erase_generation(void) const
+{
+  return erase_generation_;
+}
+
+inline std::shared_ptr<const DirtyRangesMap>
+ThreadSafeContext::share_sent_ranges(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return sent_ranges_;
+}
+
 inline VariableReferences ThreadSafeContext::save_modifieds(void) const
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
   VariableReferences snapshot;
-  snapshot.reserve(changed_map_.size());
+  snapshot.reserve(changed_list_.size());
   int cur = 0;
 
   madara_logger_checked_ptr_log(logger_, logger::LOG_MAJOR,
       "ThreadSafeContext::save_modifieds:"
-      " changed_map.size=%d, snapshot.size=%d\n",
-      (int)changed_map_.size(), (int)snapshot.size());
+      " changed_list.size=%d, snapshot.size=%d\n",
+      (int)changed_list_.size(), (int)snapshot.size());
 
-  for (auto& entry : changed_map_)
+  for (auto& entry : changed_list_)
   {
     madara_logger_checked_ptr_log(logger_, logger::LOG_MINOR,
         "ThreadSafeContext::save_modifieds:"
         " snapshot[%d].name=%s\n",
-        cur, entry.first);
+        cur, entry.get_name());
 
-    snapshot.emplace_back(entry.second);
+    snapshot.emplace_back(entry);
   }
 
   return snapshot;
@@ -1136,17 +1436,35 @@ inline void ThreadSafeContext::add_modifieds(
 
   for (auto& entry : modifieds)
   {
-    changed_map_.insert(std::make_pair(entry.get_name(), entry));
+    KnowledgeRecord& record = *entry.get_record_unsafe();
+
+    // resent records are sent whole
+    if (!(record.context_flags_ & MODIFIED_TO_SEND))
+    {
+      record.context_flags_ |= MODIFIED_TO_SEND;
+      changed_list_.push_back(entry);
+
+      auto found = dirty_ranges_.find(entry.get_name());
+      if (found != dirty_ranges_.end())
+        dirty_ranges_.erase(found);
+    }
   }
 }
 
 /// Return list of variables that have been modified
-inline const VariableReferenceMap& ThreadSafeContext::get_local_modified(
+inline VariableReferenceMap ThreadSafeContext::get_local_modified(
     void) const
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
-  return local_changed_map_;
+  VariableReferenceMap local_changed_map;
+
+  for (auto& entry : local_changed_list_)
+  {
+    local_changed_map.emplace(entry.get_name(), entry);
+  }
+
+  return local_changed_map;
 }
 
 /// Reset all variables to unmodified
@@ -1154,7 +1472,8 @@ inline void ThreadSafeContext::reset_modified(void)
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
-  changed_map_.clear();
+  clear_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+  dirty_ranges_.clear();
 }
 
 /// Changes all global variables to modified at current time
@@ -1195,14 +1514,55 @@ inline void ThreadSafeContext::reset_modified(const std::string& variable)
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
-  changed_map_.erase(variable.c_str());
+  auto found = map_.find(variable);
+
+  if (found != map_.end() &&
+      (found->second.context_flags_ & MODIFIED_TO_SEND))
+  {
+    found->second.context_flags_ &= ~MODIFIED_TO_SEND;
+    compact_modifieds_unsafe(changed_list_, MODIFIED_TO_SEND);
+  }
 }
 
 inline void ThreadSafeContext::reset_checkpoint(void) const
 {
   MADARA_GUARD_TYPE guard(mutex_);
 
-  local_changed_map_.clear();
+  clear_modifieds_unsafe(local_changed_list_, MODIFIED_TO_CHECKPOINT);
+}
+
+inline void ThreadSafeContext::clear_modifieds_unsafe(
+    VariableReferences& list, uint8_t flag) const
+{
+  for (auto& entry : list)
+  {
+    entry.get_record_unsafe()->context_flags_ &= ~flag;
+  }
+
+  list.clear();
+}
+
+inline void ThreadSafeContext::compact_modifieds_unsafe(
+    VariableReferences& list, uint8_t flag) const
+{
+  list.erase(std::remove_if(list.begin(), list.end(),
+                 [flag](const VariableReference& entry) {
+                   return !(entry.get_record_unsafe()->context_flags_ & flag);
+                 }),
+      list.end());
+}
+
+inline bool ThreadSafeContext::unmark_unsafe(KnowledgeRecord& record)
+{
+  if (record.context_flags_ & AGGREGATED)
+    remove_aggregated_unsafe(record);
+
+  bool marked =
+      (record.context_flags_ & (MODIFIED_TO_SEND | MODIFIED_TO_CHECKPOINT)) != 0;
+
+  record.context_flags_ = 0;
+
+  return marked;
 }
 
 /// Signal the condition that it can wake up someone else on changed data.
@@ -0,0 +1,287 @@
+
+#ifndef _MADARA_NO_KARL_
+
+#include <sstream>
+
+#include "Aggregate.h"
+#include "madara/knowledge/ContextGuard.h"
+
+madara::knowledge::containers::Aggregate::Aggregate(
+    Operation operation, const KnowledgeUpdateSettings& settings)
+  : BaseContainer("", settings), context_(0), operation_(operation), size_(0)
+{
+}
+
+madara::knowledge::containers::Aggregate::Aggregate(const std::string& name,
+    KnowledgeBase& knowledge, int size, Operation operation,
+    const KnowledgeUpdateSettings& settings)
+  : BaseContainer(name, settings),
+    context_(&(knowledge.get_context())),
+    operation_(operation),
+    size_(size)
+{
+  build_aggregate();
+}
+
+madara::knowledge::containers::Aggregate::Aggregate(const std::string& name,
+    Variables& knowledge, int size, Operation operation,
+    const KnowledgeUpdateSettings& settings)
+  : BaseContainer(name, settings),
+    context_(knowledge.get_context()),
+    operation_(operation),
+    size_(size)
+{
+  build_aggregate();
+}
+
+madara::knowledge::containers::Aggregate::Aggregate(const Aggregate& rhs)
+  : BaseContainer(rhs),
+    context_(rhs.context_),
+    variables_(rhs.variables_),
+    operation_(rhs.operation_),
+    size_(rhs.size_),
+    aggregate_(rhs.aggregate_)
+{
+}
+
+madara::knowledge::containers::Aggregate::~Aggregate() {}
+
+void madara::knowledge::containers::Aggregate::operator=(const Aggregate& rhs)
+{
+  if (this != &rhs)
+  {
+    MADARA_GUARD_TYPE guard(mutex_), guard2(rhs.mutex_);
+
+    this->context_ = rhs.context_;
+    this->name_ = rhs.name_;
+    this->settings_ = rhs.settings_;
+    this->variables_ = rhs.variables_;
+    this->operation_ = rhs.operation_;
+    this->size_ = rhs.size_;
+    this->aggregate_ = rhs.aggregate_;
+  }
+}
+
+void madara::knowledge::containers::Aggregate::build_aggregate(void)
+{
+  if (context_ && name_ != "")
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    KnowledgeUpdateSettings keep_local(true);
+
+    variables_.clear();
+    variables_.reserve(size_ > 0 ? size_ : 0);
+
+    for (int i = 0; i < size_; ++i)
+    {
+      std::stringstream buffer;
+      buffer << name_;
+      buffer << ".";
+      buffer << i;
+
+      variables_.push_back(context_->get_ref(buffer.str(), keep_local));
+    }
+
+    // copies share the old aggregate, so a new one is attached
+    aggregate_ = std::make_shared<RecordAggregate>(operation_);
+    context_->attach_aggregate(*aggregate_, variables_);
+  }
+  else if (name_ == "")
+  {
+    if (context_)
+    {
+      context_->print("ERROR: containers::Aggregate needs a name.\n", 0);
+    }
+  }
+  else if (!context_)
+  {
+    logger::global_logger->log(
+        logger::LOG_ERROR, "ERROR: containers::Aggregate needs a context.\n");
+  }
+}
+
+madara::knowledge::containers::Aggregate::Operation
+madara::knowledge::containers::Aggregate::get_operation(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return operation_;
+}
+
+int madara::knowledge::containers::Aggregate::size(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return size_;
+}
+
+void madara::knowledge::containers::Aggregate::set_name(
+    const std::string& var_name, KnowledgeBase& knowledge)
+{
+  context_ = &(knowledge.get_context());
+
+  ContextGuard context_guard(*context_);
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  name_ = var_name;
+
+  this->build_aggregate();
+}
+
+void madara::knowledge::containers::Aggregate::set_name(
+    const std::string& var_name, Variables& knowledge)
+{
+  context_ = knowledge.get_context();
+
+  ContextGuard context_guard(*context_);
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  name_ = var_name;
+
+  this->build_aggregate();
+}
+
+void madara::knowledge::containers::Aggregate::resize(int size)
+{
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    size_ = size;
+
+    this->build_aggregate();
+  }
+}
+
+void madara::knowledge::containers::Aggregate::modify(void)
+{
+  if (context_ && name_ != "")
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    for (auto& variable : variables_)
+    {
+      context_->mark_modified(variable);
+    }
+  }
+}
+
+std::string madara::knowledge::containers::Aggregate::get_debug_info(void)
+{
+  std::stringstream result;
+
+  result << "Aggregate: ";
+
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    result << this->name_;
+    result << " [" << size_ << "]";
+    result << " = " << to_string();
+  }
+
+  return result.str();
+}
+
+void madara::knowledge::containers::Aggregate::modify_(void)
+{
+  modify();
+}
+
+std::string madara::knowledge::containers::Aggregate::get_debug_info_(void)
+{
+  return get_debug_info();
+}
+
+madara::knowledge::containers::BaseContainer*
+madara::knowledge::containers::Aggregate::clone(void) const
+{
+  return new Aggregate(*this);
+}
+
+madara::knowledge::KnowledgeRecord
+madara::knowledge::containers::Aggregate::to_record(void) const
+{
+  madara::knowledge::KnowledgeRecord result;
+
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if (aggregate_)
+    {
+      result = aggregate_->get();
+    }
+  }
+
+  return result;
+}
+
+madara::knowledge::KnowledgeRecord::Integer
+madara::knowledge::containers::Aggregate::to_integer(void) const
+{
+  madara::knowledge::KnowledgeRecord::Integer result(0);
+
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if (aggregate_)
+    {
+      result = aggregate_->get_integer();
+    }
+  }
+
+  return result;
+}
+
+double madara::knowledge::containers::Aggregate::to_double(void) const
+{
+  double result(0.0);
+
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if (aggregate_)
+    {
+      result = aggregate_->get_double();
+    }
+  }
+
+  return result;
+}
+
+std::string madara::knowledge::containers::Aggregate::to_string(void) const
+{
+  return to_record().to_string();
+}
+
+bool madara::knowledge::containers::Aggregate::is_true(void) const
+{
+  return to_record().is_true();
+}
+
+bool madara::knowledge::containers::Aggregate::is_false(void) const
+{
+  return !is_true();
+}
+
+bool madara::knowledge::containers::Aggregate::is_true_(void) const
+{
+  return is_true();
+}
+
+bool madara::knowledge::containers::Aggregate::is_false_(void) const
+{
+  return is_false();
+}
+
+#endif  // _MADARA_NO_KARL_
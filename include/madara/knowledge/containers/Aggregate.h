@@ -0,0 +1,255 @@
+
+#ifndef _MADARA_CONTAINERS_AGGREGATE_H_
+#define _MADARA_CONTAINERS_AGGREGATE_H_
+
+#ifndef _MADARA_NO_KARL_
+
+#include <memory>
+#include <vector>
+#include <string>
+#include "madara/LockType.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/knowledge/KnowledgeUpdateSettings.h"
+#include "madara/knowledge/RecordAggregate.h"
+#include "BaseContainer.h"
+
+/**
+ * @file Aggregate.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a read-only sum, minimum or maximum of variables
+ * that may be updated by many nodes
+ **/
+
+namespace madara
+{
+namespace knowledge
+{
+namespace containers
+{
+/**
+ * @class Aggregate
+ * @brief This class provides the sum, minimum or maximum of the
+ *        variables {name}.0 through {name}.{size - 1}, e.g., values
+ *        published by each agent in a swarm. The result is maintained
+ *        as the variables change, locally or from the network, so
+ *        reading it does not visit every variable.
+ */
+class MADARA_EXPORT Aggregate : public BaseContainer
+{
+public:
+  /// the ways to aggregate variables
+  typedef RecordAggregate::Operation Operation;
+
+  /**
+   * Default constructor
+   * @param  operation  the way to aggregate the variables
+   * @param  settings   settings for evaluating the aggregate
+   **/
+  Aggregate(Operation operation = RecordAggregate::SUM,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Constructor
+   * @param  name       prefix of the variables in the knowledge base
+   * @param  knowledge  the knowledge base that contains the variables
+   * @param  size       the number of variables
+   * @param  operation  the way to aggregate the variables
+   * @param  settings   settings for evaluating the aggregate
+   **/
+  Aggregate(const std::string& name, KnowledgeBase& knowledge, int size,
+      Operation operation = RecordAggregate::SUM,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Constructor
+   * @param  name       prefix of the variables in the knowledge base
+   * @param  knowledge  the variable context
+   * @param  size       the number of variables
+   * @param  operation  the way to aggregate the variables
+   * @param  settings   settings for evaluating the aggregate
+   **/
+  Aggregate(const std::string& name, Variables& knowledge, int size,
+      Operation operation = RecordAggregate::SUM,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Copy constructor
+   **/
+  Aggregate(const Aggregate& rhs);
+
+  /**
+   * Destructor
+   **/
+  ~Aggregate();
+
+  /**
+   * Assignment operator
+   * @param  rhs    value to copy
+   **/
+  void operator=(const Aggregate& rhs);
+
+  /**
+   * Returns the way the variables are aggregated
+   * @return the operation
+   **/
+  Operation get_operation(void) const;
+
+  /**
+   * Returns the number of variables
+   * @return the number of variables
+   **/
+  int size(void) const;
+
+  /**
+   * Sets the prefix of the variables
+   * @param var_name  the prefix of the variables in the knowledge base
+   * @param knowledge  the knowledge base the variables are housed in
+   **/
+  void set_name(const std::string& var_name, KnowledgeBase& knowledge);
+
+  /**
+   * Sets the prefix of the variables
+   * @param var_name  the prefix of the variables in the knowledge base
+   * @param knowledge  the variable context
+   **/
+  void set_name(const std::string& var_name, Variables& knowledge);
+
+  /**
+   * Changes the number of variables, e.g., when agents join a swarm
+   * @param size     the number of variables
+   **/
+  void resize(int size);
+
+  /**
+   * Mark the variables as modified, so they are resent
+   **/
+  void modify(void);
+
+  /**
+   * Returns the aggregate
+   * @return the aggregate, which is empty for the minimum or maximum
+   *         of no existing variables
+   **/
+  knowledge::KnowledgeRecord to_record(void) const;
+
+  /**
+   * Returns the aggregate as a double
+   * @return the aggregate as a double
+   **/
+  double to_double(void) const;
+
+  /**
+   * Returns the aggregate as an integer
+   * @return the aggregate as an integer
+   **/
+  knowledge::KnowledgeRecord::Integer to_integer(void) const;
+
+  /**
+   * Returns the aggregate as a string
+   * @return the aggregate as a string
+   **/
+  std::string to_string(void) const;
+
+  /**
+   * Returns the type of the container along with name and any other
+   * useful information. The provided information should be useful
+   * for developers wishing to debug container operations, especially
+   * as it pertains to pending network operations (i.e., when used
+   * in conjunction with modify)
+   *
+   * @return info in format {container}: {name}{ = value, if appropriate}
+   **/
+  std::string get_debug_info(void);
+
+  /**
+   * Clones this container
+   * @return  a deep copy of the container that must be managed
+   *          by the user (i.e., you have to delete the return value)
+   **/
+  virtual BaseContainer* clone(void) const;
+
+  /**
+   * Determines if the aggregate is not zero
+   * @return true if the aggregate is not zero
+   **/
+  bool is_true(void) const;
+
+  /**
+   * Determines if the aggregate is zero
+   * @return true if the aggregate is zero
+   **/
+  bool is_false(void) const;
+
+private:
+  /**
+   * Polymorphic is true method which can be used to determine if
+   * all values in the container are true
+   **/
+  virtual bool is_true_(void) const;
+
+  /**
+   * Polymorphic is false method which can be used to determine if
+   * at least one value in the container is false
+   **/
+  virtual bool is_false_(void) const;
+
+  /**
+   * Polymorphic modify method used by collection containers. This
+   * method calls the modify method for this class. We separate the
+   * faster version (modify) from this version (modify_) to allow
+   * users the opportunity to have a fastery version that does not
+   * use polymorphic functions (generally virtual functions are half
+   * as efficient as normal function calls)
+   **/
+  virtual void modify_(void);
+
+  /**
+   * Returns the type of the container along with name and any other
+   * useful information. The provided information should be useful
+   * for developers wishing to debug container operations, especially
+   * as it pertains to pending network operations (i.e., when used
+   * in conjunction with modify)
+   *
+   * @return info in format {container}: {name}{ = value, if appropriate}
+   **/
+  virtual std::string get_debug_info_(void);
+
+  /**
+   * Builds the variable references and attaches a new aggregate
+   **/
+  void build_aggregate(void);
+
+  /**
+   * Variable context that we are modifying
+   **/
+  mutable ThreadSafeContext* context_;
+
+  /**
+   * References to the aggregated variables
+   **/
+  std::vector<VariableReference> variables_;
+
+  /**
+   * the way the variables are aggregated
+   **/
+  Operation operation_;
+
+  /**
+   * the number of variables
+   **/
+  int size_;
+
+  /**
+   * The aggregate, maintained by the context and shared by copies
+   **/
+  std::shared_ptr<RecordAggregate> aggregate_;
+};
+}
+}
+}
+
+#endif  // _MADARA_NO_KARL_
+
+#endif  // _MADARA_CONTAINERS_AGGREGATE_H_
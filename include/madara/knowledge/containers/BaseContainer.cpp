@@ -71,3 +71,16 @@ bool madara::knowledge::containers::BaseContainer::modify_if_false(
 
   return result;
 }
+
+void madara::knowledge::containers::BaseContainer::read_(void) {}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::containers::BaseContainer::get_context_(void) const
+{
+  return 0;
+}
+
+void madara::knowledge::containers::BaseContainer::write_(
+    const KnowledgeUpdateSettings&)
+{
+}
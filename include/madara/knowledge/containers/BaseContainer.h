@@ -26,6 +26,9 @@ namespace containers
 /// forward declare Collection class for friending
 class Collection;
 
+/// forward declare Transaction class for friending
+class Transaction;
+
 /**
  * @class BaseContainer
  * @brief This class is an abstract base class for all containers
@@ -36,6 +39,9 @@ public:
   /// Allow Collection class to access protected/private areas
   friend class Collection;
 
+  /// Allow Transaction class to read and write staged values
+  friend class Transaction;
+
   /**
    * Constructor
    * @param  name       prefix of the variable in the knowledge base
@@ -128,6 +134,29 @@ protected:
    **/
   virtual std::string get_debug_info_(void) = 0;
 
+  /**
+   * Polymorphic read method used by transactions to refresh staged
+   * values from the knowledge base. Containers without staged values
+   * always read the knowledge base, so by default this does nothing.
+   **/
+  virtual void read_(void);
+
+  /**
+   * Polymorphic write method used by transactions to write changed
+   * staged values to the knowledge base, which is locked by the caller.
+   * By default this does nothing.
+   * @param  settings  settings for updating knowledge
+   **/
+  virtual void write_(const KnowledgeUpdateSettings& settings);
+
+  /**
+   * Polymorphic method used by transactions to check that the container
+   * refers to their knowledge base. Containers that do not stage values
+   * do not take part in transactions, so by default this returns 0.
+   * @return  the context read_ and write_ use, or 0 if none
+   **/
+  virtual ThreadSafeContext* get_context_(void) const;
+
   /// guard for access and changes
 
   /**
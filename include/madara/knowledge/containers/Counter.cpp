@@ -71,7 +71,7 @@ madara::knowledge::containers::Counter::Counter(const Counter& rhs)
     variable_(rhs.variable_),
     id_(rhs.id_),
     counters_(rhs.counters_),
-    aggregate_count_(rhs.aggregate_count_)
+    aggregate_(rhs.aggregate_)
 {
 }
 
@@ -89,7 +89,7 @@ void madara::knowledge::containers::Counter::operator=(const Counter& rhs)
     this->counters_ = rhs.counters_;
     this->settings_ = rhs.settings_;
     this->variable_ = rhs.variable_;
-    this->aggregate_count_ = rhs.aggregate_count_;
+    this->aggregate_ = rhs.aggregate_;
   }
 }
 
@@ -100,24 +100,24 @@ void madara::knowledge::containers::Counter::build_aggregate_count(void)
     ContextGuard context_guard(*context_);
     MADARA_GUARD_TYPE guard(mutex_);
 
-    std::stringstream buffer;
-    if (counters_ > 0)
+    std::vector<VariableReference> contributors;
+    contributors.reserve(counters_ > 0 ? counters_ : 0);
+
+    for (int i = 0; i < counters_; ++i)
     {
-      // add the first counter variable
+      std::stringstream buffer;
       buffer << name_;
-      buffer << ".0";
-
-      // add all other counter variables
-      for (int i = 1; i < counters_; ++i)
-      {
-        buffer << "+";
-        buffer << name_;
-        buffer << ".";
-        buffer << i;
-      }
+      buffer << ".";
+      buffer << i;
+
+      contributors.push_back(context_->get_ref(buffer.str(), no_harm));
     }
 
-    aggregate_count_ = context_->compile(buffer.str());
+    // the context keeps the total current as contributors change, so
+    // reading the count does not evaluate every contributor. Copies of
+    // this counter share the total, so a new one is made here.
+    aggregate_ = std::make_shared<RecordAggregate>(RecordAggregate::SUM);
+    context_->attach_aggregate(*aggregate_, contributors);
   }
   else if (name_ == "")
   {
@@ -4,6 +4,7 @@
 
 #ifndef _MADARA_NO_KARL_
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "madara/LockType.h"
@@ -352,12 +353,13 @@ private:
   void init_noharm(void);
 
   /**
-   * Counts all counter variables
+   * Counts all counter variables. The total is maintained as the
+   * variables change, so this does not visit each of them.
    * @return  total count
    **/
   inline type get_count(void) const
   {
-    return context_->evaluate(aggregate_count_, no_harm).to_integer();
+    return aggregate_ ? aggregate_->get_integer() : 0;
   }
 
   /**
@@ -366,7 +368,7 @@ private:
    **/
   inline std::string get_count_string(void) const
   {
-    return context_->evaluate(aggregate_count_, no_harm).to_string();
+    return aggregate_ ? aggregate_->get().to_string() : "0";
   }
 
   /**
@@ -375,7 +377,7 @@ private:
    **/
   inline double get_count_double(void) const
   {
-    return context_->evaluate(aggregate_count_, no_harm).to_double();
+    return aggregate_ ? aggregate_->get_double() : 0.0;
   }
 
   /**
@@ -384,7 +386,7 @@ private:
    **/
   inline knowledge::KnowledgeRecord get_count_record(void) const
   {
-    return context_->evaluate(aggregate_count_, no_harm);
+    return aggregate_ ? aggregate_->get() : knowledge::KnowledgeRecord(0);
   }
 
   /**
@@ -408,9 +410,9 @@ private:
   int counters_;
 
   /**
-   * Expression for aggregating count in one atomic operation
+   * Total of the counter ring, maintained by the context
    **/
-  CompiledExpression aggregate_count_;
+  std::shared_ptr<RecordAggregate> aggregate_;
 
   /**
    * Settings we'll use for all evaluations
@@ -72,6 +72,25 @@ void madara::knowledge::containers::DoubleStaged::modify_(void)
   modify();
 }
 
+void madara::knowledge::containers::DoubleStaged::read_(void)
+{
+  read();
+}
+
+void madara::knowledge::containers::DoubleStaged::write_(
+    const KnowledgeUpdateSettings& settings)
+{
+  if (has_changed_)
+    context_->set(variable_, value_, settings);
+}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::containers::DoubleStaged::get_context_(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return context_;
+}
+
 std::string madara::knowledge::containers::DoubleStaged::get_debug_info_(void)
 {
   return get_debug_info();
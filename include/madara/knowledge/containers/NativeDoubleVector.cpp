@@ -72,6 +72,15 @@ void madara::knowledge::containers::NativeDoubleVector::modify(void)
   }
 }
 
+void madara::knowledge::containers::NativeDoubleVector::modify(size_t index)
+{
+  if (context_ && name_ != "")
+  {
+    ContextGuard context_guard(*context_);
+    context_->mark_modified(vector_, index, 1, settings_);
+  }
+}
+
 std::string madara::knowledge::containers::NativeDoubleVector::get_debug_info(
     void)
 {
@@ -160,7 +169,16 @@ void madara::knowledge::containers::NativeDoubleVector::resize(size_t size)
 
     knowledge::KnowledgeRecord value = context_->get(vector_, settings_);
 
-    value.resize(size);
+    // start new vectors with the native array type, so that element sets
+    // do not have to convert (and resend) the whole array
+    if (!value.exists() && size > 0)
+    {
+      value.set_value(std::vector<double>(size));
+    }
+    else
+    {
+      value.resize(size);
+    }
 
     context_->set(vector_, value, settings_);
   }
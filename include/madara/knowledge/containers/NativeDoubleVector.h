@@ -26,7 +26,11 @@ namespace containers
 {
 /**
  * @class NativeDoubleVector
- * @brief This class stores a vector of doubles inside of KaRL
+ * @brief This class stores a vector of doubles inside of KaRL as a
+ *        single contiguous array record. Unlike the one variable per
+ *        element storage of DoubleVector, element changes are
+ *        tracked as dirty index ranges that transports can send as
+ *        deltas (@see TransportSettings::send_array_deltas)
  */
 class MADARA_EXPORT NativeDoubleVector : public BaseContainer
 {
@@ -79,6 +83,15 @@ public:
    **/
   void modify(void);
 
+  /**
+   * Mark the value as modified. The vector element retains its value
+   * but will resend its value as if it had been modified. Like set
+   * (index, value), this only marks the element's range dirty, so
+   * transports with send_array_deltas send only the changed ranges.
+   * @param  index  the index to modify
+   **/
+  void modify(size_t index);
+
   /**
    * Assignment operator
    * @param  rhs    value to copy
@@ -88,3 +88,22 @@ void madara::knowledge::containers::NativeDoubleVectorStaged::modify_(void)
 {
   modify();
 }
+
+void madara::knowledge::containers::NativeDoubleVectorStaged::read_(void)
+{
+  read();
+}
+
+void madara::knowledge::containers::NativeDoubleVectorStaged::write_(
+    const KnowledgeUpdateSettings& settings)
+{
+  if (has_changed_)
+    context_->set(vector_, value_, settings);
+}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::containers::NativeDoubleVectorStaged::get_context_(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return context_;
+}
@@ -259,7 +259,7 @@ inline madara::knowledge::containers::NativeDoubleVectorStaged::type
 {
   knowledge::KnowledgeRecord result;
 
-  result = result.retrieve_index(index);
+  result = value_.retrieve_index(index);
 
   return result.to_double();
 }
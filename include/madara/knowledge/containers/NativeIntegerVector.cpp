@@ -48,6 +48,15 @@ void madara::knowledge::containers::NativeIntegerVector::modify(void)
   }
 }
 
+void madara::knowledge::containers::NativeIntegerVector::modify(size_t index)
+{
+  if (context_ && name_ != "")
+  {
+    ContextGuard context_guard(*context_);
+    context_->mark_modified(vector_, index, 1, settings_);
+  }
+}
+
 std::string madara::knowledge::containers::NativeIntegerVector::get_debug_info(
     void)
 {
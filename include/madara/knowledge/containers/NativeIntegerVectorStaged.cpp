@@ -90,3 +90,22 @@ inline void madara::knowledge::containers::NativeIntegerVectorStaged::modify_(
 {
   modify();
 }
+
+void madara::knowledge::containers::NativeIntegerVectorStaged::read_(void)
+{
+  read();
+}
+
+void madara::knowledge::containers::NativeIntegerVectorStaged::write_(
+    const KnowledgeUpdateSettings& settings)
+{
+  if (has_changed_)
+    context_->set(vector_, value_, settings);
+}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::containers::NativeIntegerVectorStaged::get_context_(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return context_;
+}
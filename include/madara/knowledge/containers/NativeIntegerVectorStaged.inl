@@ -229,7 +229,7 @@ inline madara::knowledge::containers::NativeIntegerVectorStaged::type
 {
   knowledge::KnowledgeRecord result;
 
-  result = result.retrieve_index(index);
+  result = value_.retrieve_index(index);
 
   return result.to_integer();
 }
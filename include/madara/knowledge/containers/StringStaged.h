@@ -342,6 +342,24 @@ private:
    **/
   virtual std::string get_debug_info_(void);
 
+  /**
+   * Polymorphic read method used by transactions, which calls read
+   **/
+  virtual void read_(void);
+
+  /**
+   * Polymorphic write method used by transactions, which writes the
+   * value if it has changed
+   * @param  settings  settings for updating knowledge
+   **/
+  virtual void write_(const KnowledgeUpdateSettings& settings);
+
+  /**
+   * Returns the context used by read_ and write_
+   * @return  the context, or 0 if no name has been set
+   **/
+  virtual ThreadSafeContext* get_context_(void) const;
+
   /**
    * Variable context that we are modifying
    **/
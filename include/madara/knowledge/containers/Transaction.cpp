@@ -0,0 +1,110 @@
+#include "Transaction.h"
+#include "madara/knowledge/ContextGuard.h"
+#include "madara/exceptions/ContextException.h"
+
+madara::knowledge::containers::Transaction::Transaction(
+    KnowledgeBase& knowledge, const EvalSettings& settings)
+  : knowledge_(knowledge), settings_(settings)
+{
+}
+
+void madara::knowledge::containers::Transaction::check_context(
+    const BaseContainer& container, const char* func) const
+{
+  ThreadSafeContext* context = container.get_context_();
+
+  // a container of another knowledge base would be read and written
+  // without its lock, and its writes would not be sent by commit
+  if (context != 0 && context != &knowledge_.get_context())
+  {
+    throw exceptions::ContextException(std::string("Transaction::") + func +
+                                       ": container " + container.name_ +
+                                       " refers to another knowledge base.");
+  }
+}
+
+void madara::knowledge::containers::Transaction::add(BaseContainer& container)
+{
+  check_context(container, "add");
+
+  MADARA_GUARD_TYPE guard(mutex_);
+  containers_.push_back(&container);
+}
+
+size_t madara::knowledge::containers::Transaction::size(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return containers_.size();
+}
+
+void madara::knowledge::containers::Transaction::clear(void)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  containers_.clear();
+}
+
+void madara::knowledge::containers::Transaction::read(void)
+{
+  ContextGuard context_guard(knowledge_);
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (auto container : containers_)
+  {
+    check_context(*container, "read");
+  }
+
+  for (auto container : containers_)
+  {
+    container->read_();
+  }
+}
+
+void madara::knowledge::containers::Transaction::commit(void)
+{
+  EvalSettings settings;
+
+  {
+    ContextGuard context_guard(knowledge_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    settings = settings_;
+
+    // waiters are signaled once, after every write is in place
+    KnowledgeUpdateSettings quiet(settings);
+    quiet.signal_changes = false;
+
+    for (auto container : containers_)
+    {
+      check_context(*container, "commit");
+    }
+
+    for (auto container : containers_)
+    {
+      container->write_(quiet);
+    }
+
+    if (settings.signal_changes)
+    {
+      knowledge_.get_context().signal(false);
+    }
+  }
+
+  if (!settings.delay_sending_modifieds)
+  {
+    knowledge_.send_modifieds("Transaction::commit", settings);
+  }
+}
+
+madara::knowledge::EvalSettings
+madara::knowledge::containers::Transaction::get_settings(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return settings_;
+}
+
+void madara::knowledge::containers::Transaction::set_settings(
+    const EvalSettings& settings)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  settings_ = settings;
+}
@@ -0,0 +1,125 @@
+
+#ifndef _MADARA_CONTAINERS_TRANSACTION_H_
+#define _MADARA_CONTAINERS_TRANSACTION_H_
+
+#include <vector>
+#include <string>
+#include "madara/LockType.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/EvalSettings.h"
+#include "BaseContainer.h"
+
+/**
+ * @file Transaction.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a C++ object that reads and writes a set of staged
+ * containers together
+ **/
+
+namespace madara
+{
+namespace knowledge
+{
+namespace containers
+{
+/**
+ * @class Transaction
+ * @brief Reads and writes a set of containers in one lock of the
+ *        knowledge base. Staged containers, e.g., IntegerStaged and
+ *        NativeDoubleVectorStaged, are snapshotted together by read and
+ *        their changed values are written together by commit, so a
+ *        concurrent send_modifieds sees all of the writes or none of
+ *        them. Other containers already read and write the knowledge
+ *        base directly and are unaffected. Containers are enlisted by
+ *        reference, must outlive the transaction, and must refer to the
+ *        transaction's knowledge base.
+ */
+class MADARA_EXPORT Transaction
+{
+public:
+  /**
+   * Constructor
+   * @param  knowledge  the knowledge base the containers refer to
+   * @param  settings   settings for the writes of commit. Modifieds are
+   *                    sent once after the commit, unless the settings
+   *                    delay sending modifieds.
+   **/
+  Transaction(KnowledgeBase& knowledge,
+      const EvalSettings& settings = EvalSettings());
+
+  /**
+   * Enlists a container in the transaction
+   * @param  container  the container
+   * @throw exceptions::ContextException  if the container refers to
+   *                    another knowledge base
+   **/
+  void add(BaseContainer& container);
+
+  /**
+   * Returns the number of enlisted containers
+   * @return the number of containers
+   **/
+  size_t size(void) const;
+
+  /**
+   * Removes all containers from the transaction
+   **/
+  void clear(void);
+
+  /**
+   * Reads the values of all containers from the knowledge base while it
+   * is locked once
+   * @throw exceptions::ContextException  if a container has been renamed
+   *                    into another knowledge base. No container is read.
+   **/
+  void read(void);
+
+  /**
+   * Writes the changed values of all containers to the knowledge base
+   * while it is locked once, then signals and sends the changes once
+   * @throw exceptions::ContextException  if a container has been renamed
+   *                    into another knowledge base. No container is
+   *                    written.
+   **/
+  void commit(void);
+
+  /**
+   * Gets the update settings for commits
+   * @return  the current settings
+   **/
+  EvalSettings get_settings(void) const;
+
+  /**
+   * Sets the update settings for commits
+   * @param  settings  the new settings to use
+   **/
+  void set_settings(const EvalSettings& settings);
+
+private:
+  /**
+   * Checks that a container refers to the knowledge base of the
+   * transaction, if it takes part in transactions at all
+   * @param  container  the container
+   * @param  func       the calling method, for the exception message
+   * @throw exceptions::ContextException  if it refers to another
+   **/
+  void check_context(const BaseContainer& container, const char* func) const;
+
+  /// the knowledge base the containers refer to
+  KnowledgeBase knowledge_;
+
+  /// the enlisted containers
+  std::vector<BaseContainer*> containers_;
+
+  /// settings for commits
+  EvalSettings settings_;
+
+  /// guards the enlisted containers
+  mutable MADARA_LOCK_TYPE mutex_;
+};
+}
+}
+}
+
+#endif  // _MADARA_CONTAINERS_TRANSACTION_H_
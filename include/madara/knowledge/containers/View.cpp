@@ -0,0 +1,270 @@
+#include <sstream>
+
+#include "View.h"
+#include "madara/knowledge/ContextGuard.h"
+
+madara::knowledge::containers::View::View(
+    const KnowledgeUpdateSettings& settings)
+  : BaseContainer("", settings), context_(0), has_changed_(false)
+{
+}
+
+madara::knowledge::containers::View::View(
+    const std::vector<std::string>& names, KnowledgeBase& knowledge,
+    const KnowledgeUpdateSettings& settings)
+  : BaseContainer("", settings),
+    context_(&(knowledge.get_context())),
+    names_(names),
+    has_changed_(false)
+{
+  build_view();
+}
+
+madara::knowledge::containers::View::View(
+    const std::vector<std::string>& names, Variables& knowledge,
+    const KnowledgeUpdateSettings& settings)
+  : BaseContainer("", settings),
+    context_(knowledge.get_context()),
+    names_(names),
+    has_changed_(false)
+{
+  build_view();
+}
+
+madara::knowledge::containers::View::View(const View& rhs)
+  : BaseContainer(rhs),
+    context_(rhs.context_),
+    names_(rhs.names_),
+    variables_(rhs.variables_),
+    values_(rhs.values_),
+    has_changed_(rhs.has_changed_)
+{
+}
+
+madara::knowledge::containers::View::~View() {}
+
+void madara::knowledge::containers::View::operator=(const View& rhs)
+{
+  if (this != &rhs)
+  {
+    MADARA_GUARD_TYPE guard(mutex_), guard2(rhs.mutex_);
+
+    this->context_ = rhs.context_;
+    this->name_ = rhs.name_;
+    this->settings_ = rhs.settings_;
+    this->names_ = rhs.names_;
+    this->variables_ = rhs.variables_;
+    this->values_ = rhs.values_;
+    this->has_changed_ = rhs.has_changed_;
+  }
+}
+
+void madara::knowledge::containers::View::build_view(void)
+{
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    variables_ = context_->get_refs(names_, settings_);
+    context_->get_all(variables_, values_, settings_);
+    has_changed_ = false;
+  }
+}
+
+void madara::knowledge::containers::View::set_names(
+    const std::vector<std::string>& names, KnowledgeBase& knowledge)
+{
+  context_ = &(knowledge.get_context());
+
+  ContextGuard context_guard(*context_);
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  names_ = names;
+
+  this->build_view();
+}
+
+void madara::knowledge::containers::View::set_names(
+    const std::vector<std::string>& names, Variables& knowledge)
+{
+  context_ = knowledge.get_context();
+
+  ContextGuard context_guard(*context_);
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  names_ = names;
+
+  this->build_view();
+}
+
+std::vector<std::string> madara::knowledge::containers::View::get_names(
+    void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return names_;
+}
+
+size_t madara::knowledge::containers::View::size(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return names_.size();
+}
+
+void madara::knowledge::containers::View::read(void)
+{
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    context_->get_all(variables_, values_, settings_);
+    has_changed_ = false;
+  }
+}
+
+void madara::knowledge::containers::View::write(void)
+{
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    write_(settings_);
+  }
+}
+
+madara::knowledge::KnowledgeRecord
+    madara::knowledge::containers::View::operator[](size_t index) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  if (index < values_.size())
+  {
+    return values_[index];
+  }
+
+  return KnowledgeRecord();
+}
+
+void madara::knowledge::containers::View::set(
+    size_t index, const knowledge::KnowledgeRecord& value)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  if (index < values_.size())
+  {
+    values_[index] = value;
+    has_changed_ = true;
+  }
+}
+
+void madara::knowledge::containers::View::copy_to(
+    std::vector<knowledge::KnowledgeRecord>& values) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  values = values_;
+}
+
+void madara::knowledge::containers::View::modify(void)
+{
+  if (context_)
+  {
+    ContextGuard context_guard(*context_);
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    for (auto& variable : variables_)
+    {
+      context_->mark_modified(variable, settings_);
+    }
+  }
+}
+
+std::string madara::knowledge::containers::View::get_debug_info(void)
+{
+  std::stringstream result;
+
+  result << "View: ";
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (size_t i = 0; i < names_.size(); ++i)
+  {
+    if (i > 0)
+    {
+      result << ", ";
+    }
+
+    result << names_[i] << " = " << values_[i].to_string();
+  }
+
+  return result.str();
+}
+
+void madara::knowledge::containers::View::modify_(void)
+{
+  modify();
+}
+
+std::string madara::knowledge::containers::View::get_debug_info_(void)
+{
+  return get_debug_info();
+}
+
+void madara::knowledge::containers::View::read_(void)
+{
+  read();
+}
+
+void madara::knowledge::containers::View::write_(
+    const KnowledgeUpdateSettings& settings)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  if (context_ && has_changed_)
+  {
+    context_->set_all(variables_, values_, settings);
+    has_changed_ = false;
+  }
+}
+
+madara::knowledge::ThreadSafeContext*
+madara::knowledge::containers::View::get_context_(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+  return context_;
+}
+
+madara::knowledge::containers::BaseContainer*
+madara::knowledge::containers::View::clone(void) const
+{
+  return new View(*this);
+}
+
+bool madara::knowledge::containers::View::is_true(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  for (auto& value : values_)
+  {
+    if (!value.is_true())
+    {
+      return false;
+    }
+  }
+
+  return values_.size() > 0;
+}
+
+bool madara::knowledge::containers::View::is_false(void) const
+{
+  return !is_true();
+}
+
+bool madara::knowledge::containers::View::is_true_(void) const
+{
+  return is_true();
+}
+
+bool madara::knowledge::containers::View::is_false_(void) const
+{
+  return is_false();
+}
@@ -0,0 +1,259 @@
+
+#ifndef _MADARA_CONTAINERS_VIEW_H_
+#define _MADARA_CONTAINERS_VIEW_H_
+
+#include <vector>
+#include <string>
+#include "madara/LockType.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/knowledge/KnowledgeUpdateSettings.h"
+#include "BaseContainer.h"
+
+/**
+ * @file View.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains a C++ object that reads and writes a fixed list of
+ * related variables in one lock of the knowledge base
+ **/
+
+namespace madara
+{
+namespace knowledge
+{
+namespace containers
+{
+/**
+ * @class View
+ * @brief Compiles a list of variable names, e.g., the pose, velocity and
+ *        battery of an agent, into references once, and then reads or
+ *        writes all of the variables while the knowledge base is locked
+ *        once. Each read is a consistent snapshot: no local write or
+ *        message from the network is applied between the reads of the
+ *        variables. Values are staged in the view, like the staged
+ *        containers, so a view may also be enlisted in a Transaction.
+ */
+class MADARA_EXPORT View : public BaseContainer
+{
+public:
+  /**
+   * Default constructor
+   * @param  settings   settings for updating knowledge
+   **/
+  View(const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Constructor
+   * @param  names      names of the variables in the knowledge base
+   * @param  knowledge  the knowledge base that contains the variables
+   * @param  settings   settings for updating knowledge
+   **/
+  View(const std::vector<std::string>& names, KnowledgeBase& knowledge,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Constructor
+   * @param  names      names of the variables in the knowledge base
+   * @param  knowledge  the variable context
+   * @param  settings   settings for updating knowledge
+   **/
+  View(const std::vector<std::string>& names, Variables& knowledge,
+      const KnowledgeUpdateSettings& settings = KnowledgeUpdateSettings());
+
+  /**
+   * Copy constructor
+   **/
+  View(const View& rhs);
+
+  /**
+   * Destructor
+   **/
+  ~View();
+
+  /**
+   * Assignment operator
+   * @param  rhs    value to copy
+   **/
+  void operator=(const View& rhs);
+
+  /**
+   * Sets the variables of the view and reads their values
+   * @param names      names of the variables in the knowledge base
+   * @param knowledge  the knowledge base the variables are housed in
+   **/
+  void set_names(
+      const std::vector<std::string>& names, KnowledgeBase& knowledge);
+
+  /**
+   * Sets the variables of the view and reads their values
+   * @param names      names of the variables in the knowledge base
+   * @param knowledge  the variable context
+   **/
+  void set_names(const std::vector<std::string>& names, Variables& knowledge);
+
+  /**
+   * Returns the names of the variables
+   * @return the names of the variables
+   **/
+  std::vector<std::string> get_names(void) const;
+
+  /**
+   * Returns the number of variables in the view
+   * @return the number of variables
+   **/
+  size_t size(void) const;
+
+  /**
+   * Reads a snapshot of all variables into the view, discarding any
+   * staged values that have not been written
+   **/
+  void read(void);
+
+  /**
+   * Writes the values of the view to the knowledge base, if any have been
+   * set since the last read or write
+   **/
+  void write(void);
+
+  /**
+   * Returns the staged value of a variable
+   * @param  index  the index of the variable in the view
+   * @return the value, or an empty record if the index is out of range
+   **/
+  knowledge::KnowledgeRecord operator[](size_t index) const;
+
+  /**
+   * Stages a new value for a variable. The value is written on write.
+   * @param  index  the index of the variable in the view
+   * @param  value  the new value
+   **/
+  void set(size_t index, const knowledge::KnowledgeRecord& value);
+
+  /**
+   * Copies the staged values of all variables
+   * @param  values  the values, in the order of the names
+   **/
+  void copy_to(std::vector<knowledge::KnowledgeRecord>& values) const;
+
+  /**
+   * Mark all variables as modified
+   **/
+  void modify(void);
+
+  /**
+   * Returns the type of the container along with name and any other
+   * useful information. The provided information should be useful
+   * for developers wishing to debug container operations, especially
+   * as it pertains to pending network operations (i.e., when used
+   * in conjunction with modify)
+   *
+   * @return info in format {container}: {name}{ = value, if appropriate}
+   **/
+  std::string get_debug_info(void);
+
+  /**
+   * Clones this container
+   * @return  a deep copy of the container that must be managed
+   *          by the user (i.e., you have to delete the return value)
+   **/
+  virtual BaseContainer* clone(void) const;
+
+  /**
+   * Determines if all staged values are true
+   * @return true if all values are true
+   **/
+  bool is_true(void) const;
+
+  /**
+   * Determines if at least one staged value is false
+   * @return true if at least one value is false
+   **/
+  bool is_false(void) const;
+
+private:
+  /**
+   * Polymorphic is true method which can be used to determine if
+   * all values in the container are true
+   **/
+  virtual bool is_true_(void) const;
+
+  /**
+   * Polymorphic is false method which can be used to determine if
+   * at least one value in the container is false
+   **/
+  virtual bool is_false_(void) const;
+
+  /**
+   * Polymorphic modify method used by collection containers. This
+   * method calls the modify method for this class. We separate the
+   * faster version (modify) from this version (modify_) to allow
+   * users the opportunity to have a fastery version that does not
+   * use polymorphic functions (generally virtual functions are half
+   * as efficient as normal function calls)
+   **/
+  virtual void modify_(void);
+
+  /**
+   * Returns the type of the container along with name and any other
+   * useful information. The provided information should be useful
+   * for developers wishing to debug container operations, especially
+   * as it pertains to pending network operations (i.e., when used
+   * in conjunction with modify)
+   *
+   * @return info in format {container}: {name}{ = value, if appropriate}
+   **/
+  virtual std::string get_debug_info_(void);
+
+  /**
+   * Reads the values while a Transaction holds the context lock
+   **/
+  virtual void read_(void);
+
+  /**
+   * Writes changed values while a Transaction holds the context lock
+   * @param  settings  settings for the writes
+   **/
+  virtual void write_(const KnowledgeUpdateSettings& settings);
+
+  /**
+   * Returns the context used by read_ and write_
+   * @return  the context, or 0 if no name has been set
+   **/
+  virtual ThreadSafeContext* get_context_(void) const;
+
+  /**
+   * Compiles the names into variable references
+   **/
+  void build_view(void);
+
+  /**
+   * Variable context that we are modifying
+   **/
+  mutable ThreadSafeContext* context_;
+
+  /**
+   * Names of the variables
+   **/
+  std::vector<std::string> names_;
+
+  /**
+   * References to the variables, in the order of the names
+   **/
+  VariableReferences variables_;
+
+  /**
+   * The staged values, in the order of the names
+   **/
+  std::vector<knowledge::KnowledgeRecord> values_;
+
+  /**
+   * Tracks if a value has been set since the last read or write
+   **/
+  bool has_changed_;
+};
+}
+}
+}
+
+#endif  // _MADARA_CONTAINERS_VIEW_H_
@@ -0,0 +1,727 @@
+#include "CompactEncoding.h"
+
+#include <sstream>
+#include <string.h>
+
+#include "madara/exceptions/MemoryException.h"
+#include "madara/logger/GlobalLogger.h"
+#include "madara/knowledge/ArrayDelta.h"
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/utility/Utility.h"
+
+namespace madara
+{
+namespace transport
+{
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+namespace
+{
+inline char* write_double(char* buffer, double value)
+{
+  value = utility::endian_swap(value);
+  memcpy(buffer, &value, sizeof(value));
+  return buffer + sizeof(value);
+}
+
+inline double read_double(const char* buffer)
+{
+  double value;
+  memcpy(&value, buffer, sizeof(value));
+  return utility::endian_swap(value);
+}
+
+inline uint32_t value_tag(const knowledge::KnowledgeRecord& record,
+    const knowledge::DirtyRanges* ranges)
+{
+  switch (record.type())
+  {
+    case knowledge::KnowledgeRecord::INTEGER:
+      return CompactEncoder::INTEGER;
+    case knowledge::KnowledgeRecord::DOUBLE:
+      return CompactEncoder::DOUBLE;
+    case knowledge::KnowledgeRecord::STRING:
+      return CompactEncoder::STRING;
+    case knowledge::KnowledgeRecord::INTEGER_ARRAY:
+      return ranges ? CompactEncoder::INTEGER_ARRAY_DELTA
+                    : CompactEncoder::INTEGER_ARRAY;
+    case knowledge::KnowledgeRecord::DOUBLE_ARRAY:
+      return ranges ? CompactEncoder::DOUBLE_ARRAY_DELTA
+                    : CompactEncoder::DOUBLE_ARRAY;
+    default:
+      return CompactEncoder::RECORD;
+  }
+}
+
+/**
+ * Returns the size of the tag, toi and value of an update
+ **/
+int64_t value_encoded_size(const knowledge::KnowledgeRecord& record,
+    const knowledge::DirtyRanges* ranges, uint64_t base_clock,
+    uint64_t timestamp)
+{
+  uint32_t tag = value_tag(record, ranges);
+
+  if (tag == CompactEncoder::RECORD)
+  {
+    return 1 + record.get_encoded_size();
+  }
+
+  int64_t size =
+      1 + varint_size(zigzag_encode((int64_t)(record.toi() - timestamp)));
+
+  switch (tag)
+  {
+    case CompactEncoder::INTEGER:
+      size += varint_size(zigzag_encode(record.to_integer()));
+      break;
+    case CompactEncoder::DOUBLE:
+      size += sizeof(double);
+      break;
+    case CompactEncoder::STRING:
+    {
+      auto value = record.share_string();
+      size += varint_size(value->size()) + value->size();
+      break;
+    }
+    case CompactEncoder::INTEGER_ARRAY:
+    {
+      auto values = record.share_integers();
+      size += varint_size(values->size());
+      for (auto value : *values)
+      {
+        size += varint_size(zigzag_encode(value));
+      }
+      break;
+    }
+    case CompactEncoder::DOUBLE_ARRAY:
+      size += varint_size(record.size()) + sizeof(double) * record.size();
+      break;
+    default:
+    {
+      size += varint_size(base_clock) + varint_size(record.size()) +
+              varint_size(ranges->ranges().size());
+
+      for (auto& range : ranges->ranges())
+      {
+        size += varint_size(range.first) +
+                varint_size(range.second - range.first);
+      }
+
+      if (tag == CompactEncoder::INTEGER_ARRAY_DELTA)
+      {
+        auto values = record.share_integers();
+        for (auto& range : ranges->ranges())
+        {
+          for (uint32_t i = range.first; i < range.second; ++i)
+          {
+            size += varint_size(zigzag_encode((*values)[i]));
+          }
+        }
+      }
+      else
+      {
+        size += sizeof(double) * ranges->count();
+      }
+    }
+  }
+
+  return size;
+}
+}
+
+CompactEncoder::CompactEncoder() : epoch_((uint64_t)utility::get_time()) {}
+
+void CompactEncoder::start(
+    uint64_t timestamp, uint64_t refresh, uint32_t max_keys)
+{
+  timestamp_ = timestamp;
+  refresh_ = refresh;
+  max_keys_ =
+      max_keys < CompactDecoder::max_id ? max_keys : CompactDecoder::max_id;
+  pending_.clear();
+}
+
+void CompactEncoder::confirm(void)
+{
+  for (auto& key : pending_)
+  {
+    ids_[key].announced = timestamp_;
+  }
+
+  pending_.clear();
+}
+
+uint64_t CompactEncoder::get_epoch(void) const
+{
+  return epoch_;
+}
+
+size_t CompactEncoder::size(void) const
+{
+  return ids_.size();
+}
+
+void CompactEncoder::lookup(
+    const std::string& key, uint32_t& id, bool& announce) const
+{
+  auto found = ids_.find(key);
+
+  if (found != ids_.end())
+  {
+    const Entry& entry = found->second;
+
+    id = entry.id;
+    announce = entry.announced == 0 ||
+               (refresh_ > 0 && timestamp_ >= entry.announced + refresh_);
+  }
+  else
+  {
+    id = ids_.size() < max_keys_ ? next_id_ : 0;
+    announce = true;
+  }
+}
+
+int64_t CompactEncoder::encoded_size(const std::string& key,
+    const knowledge::KnowledgeRecord& record,
+    const knowledge::DirtyRanges* ranges, uint64_t base_clock) const
+{
+  if (record.has_history())
+  {
+    return encoded_size(key, record.get_newest(), ranges, base_clock);
+  }
+
+  if (ranges && (!record.is_array_type() || ranges->end() > record.size()))
+  {
+    ranges = nullptr;
+  }
+
+  uint32_t id;
+  bool announce;
+
+  lookup(key, id, announce);
+
+  int64_t size = varint_size(((uint64_t)id << 1) | (announce ? 1 : 0));
+
+  if (announce)
+  {
+    size += varint_size(key.size()) + key.size();
+  }
+
+  return size + value_encoded_size(record, ranges, base_clock, timestamp_);
+}
+
+char* CompactEncoder::write(char* buffer, const std::string& key,
+    const knowledge::KnowledgeRecord& record, int64_t& buffer_remaining,
+    const knowledge::DirtyRanges* ranges, uint64_t base_clock)
+{
+  if (record.has_history())
+  {
+    return write(buffer, key, record.get_newest(), buffer_remaining, ranges,
+        base_clock);
+  }
+
+  if (ranges && (!record.is_array_type() || ranges->end() > record.size()))
+  {
+    ranges = nullptr;
+  }
+
+  uint32_t id;
+  bool announce;
+
+  lookup(key, id, announce);
+
+  int64_t size = varint_size(((uint64_t)id << 1) | (announce ? 1 : 0));
+
+  if (announce)
+  {
+    size += varint_size(key.size()) + key.size();
+  }
+
+  size += value_encoded_size(record, ranges, base_clock, timestamp_);
+
+  if (buffer_remaining < size)
+  {
+    std::stringstream local_buffer;
+    local_buffer << "CompactEncoder::write: ";
+    local_buffer << size << " byte encoding cannot fit in ";
+    local_buffer << buffer_remaining << " byte buffer\n";
+
+    throw exceptions::MemoryException(local_buffer.str());
+  }
+
+  // only remember ids that made it into the buffer, and announcements
+  // once the message is confirmed to have been sent
+  if (announce && id != 0)
+  {
+    Entry& entry = ids_[key];
+
+    if (entry.id == 0)
+    {
+      ++next_id_;
+    }
+
+    entry.id = id;
+    pending_.push_back(key);
+  }
+
+  buffer = write_varint(buffer, ((uint64_t)id << 1) | (announce ? 1 : 0));
+
+  if (announce)
+  {
+    buffer = write_varint(buffer, key.size());
+    memcpy(buffer, key.c_str(), key.size());
+    buffer += key.size();
+  }
+
+  uint32_t tag = value_tag(record, ranges);
+
+  buffer = write_varint(buffer, tag);
+
+  if (tag == RECORD)
+  {
+    int64_t remaining = buffer_remaining;
+    buffer = record.write(buffer, remaining);
+    buffer_remaining -= size;
+    return buffer;
+  }
+
+  buffer =
+      write_varint(buffer, zigzag_encode((int64_t)(record.toi() - timestamp_)));
+
+  switch (tag)
+  {
+    case INTEGER:
+      buffer = write_varint(buffer, zigzag_encode(record.to_integer()));
+      break;
+    case DOUBLE:
+      buffer = write_double(buffer, record.to_double());
+      break;
+    case STRING:
+    {
+      auto value = record.share_string();
+      buffer = write_varint(buffer, value->size());
+      memcpy(buffer, value->c_str(), value->size());
+      buffer += value->size();
+      break;
+    }
+    case INTEGER_ARRAY:
+    {
+      auto values = record.share_integers();
+      buffer = write_varint(buffer, values->size());
+      for (auto value : *values)
+      {
+        buffer = write_varint(buffer, zigzag_encode(value));
+      }
+      break;
+    }
+    case DOUBLE_ARRAY:
+    {
+      auto values = record.share_doubles();
+      buffer = write_varint(buffer, values->size());
+      for (auto value : *values)
+      {
+        buffer = write_double(buffer, value);
+      }
+      break;
+    }
+    default:
+    {
+      buffer = write_varint(buffer, base_clock);
+      buffer = write_varint(buffer, record.size());
+      buffer = write_varint(buffer, ranges->ranges().size());
+
+      for (auto& range : ranges->ranges())
+      {
+        buffer = write_varint(buffer, range.first);
+        buffer = write_varint(buffer, range.second - range.first);
+      }
+
+      if (tag == INTEGER_ARRAY_DELTA)
+      {
+        auto values = record.share_integers();
+        for (auto& range : ranges->ranges())
+        {
+          for (uint32_t i = range.first; i < range.second; ++i)
+          {
+            buffer = write_varint(buffer, zigzag_encode((*values)[i]));
+          }
+        }
+      }
+      else
+      {
+        auto values = record.share_doubles();
+        for (auto& range : ranges->ranges())
+        {
+          for (uint32_t i = range.first; i < range.second; ++i)
+          {
+            buffer = write_double(buffer, (*values)[i]);
+          }
+        }
+      }
+    }
+  }
+
+  buffer_remaining -= size;
+
+  return buffer;
+}
+
+const char* CompactDecoder::read(const char* buffer,
+    int64_t& buffer_remaining, const char* originator, uint64_t epoch,
+    uint64_t timestamp, std::string& key, knowledge::KnowledgeRecord& record,
+    const knowledge::ThreadSafeContext& context)
+{
+  knowledge::ArrayDelta delta;
+
+  buffer = read(buffer, buffer_remaining, originator, epoch, timestamp, key,
+      record, delta);
+
+  if (delta.exists() && !key.empty())
+  {
+    knowledge::KnowledgeRecord base =
+        context.get(key, knowledge::KnowledgeReferenceSettings(false));
+
+    if (!delta.apply(base, record))
+    {
+      madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_MAJOR,
+          "CompactDecoder::read:"
+          " unable to apply delta to %s (%" PRIu32 " elements, clock"
+          " %" PRIu64 "). Base has type %" PRIu32 ", %" PRIu32
+          " elements and clock %" PRIu64 ".\n",
+          key.c_str(), delta.size, delta.base_clock, base.type(),
+          base.size(), base.clock);
+    }
+  }
+
+  return buffer;
+}
+
+const char* CompactDecoder::read(const char* buffer,
+    int64_t& buffer_remaining, const char* originator, uint64_t epoch,
+    uint64_t timestamp, std::string& key, knowledge::KnowledgeRecord& record,
+    knowledge::ArrayDelta& delta)
+{
+  key.clear();
+  delta.clear();
+
+  uint64_t reference = 0;
+  buffer = read_varint(buffer, buffer_remaining, reference);
+
+  if (buffer_remaining < 0)
+  {
+    return buffer;
+  }
+
+  uint64_t id = reference >> 1;
+
+  if (reference & 1)
+  {
+    uint64_t length = 0;
+    buffer = read_varint(buffer, buffer_remaining, length);
+
+    if (buffer_remaining < 0 || (uint64_t)buffer_remaining < length)
+    {
+      buffer_remaining = -1;
+      return buffer;
+    }
+
+    key.assign(buffer, (size_t)length);
+    buffer += length;
+    buffer_remaining -= length;
+
+    if (id != 0 && id <= max_id)
+    {
+      MADARA_GUARD_TYPE guard(mutex_);
+
+      auto& epochs = dictionaries_[originator];
+      auto dictionary = epochs.find(epoch);
+
+      if (dictionary == epochs.end())
+      {
+        // forget the oldest epochs, unless this one is older still
+        if (epochs.size() < max_epochs || epoch > epochs.begin()->first)
+        {
+          dictionary = epochs.emplace(epoch, Dictionary()).first;
+
+          while (epochs.size() > max_epochs)
+          {
+            epochs.erase(epochs.begin());
+          }
+        }
+      }
+
+      if (dictionary != epochs.end())
+      {
+        if (dictionary->second.size() <= id)
+        {
+          dictionary->second.resize(id + 1);
+        }
+
+        dictionary->second[id] = key;
+      }
+    }
+  }
+  else
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    auto epochs = dictionaries_.find(originator);
+
+    if (epochs != dictionaries_.end())
+    {
+      auto dictionary = epochs->second.find(epoch);
+
+      if (dictionary != epochs->second.end() &&
+          id < dictionary->second.size())
+      {
+        key = dictionary->second[id];
+      }
+    }
+
+    if (key.empty())
+    {
+      ++unknown_;
+    }
+  }
+
+  uint64_t tag = 0;
+  buffer = read_varint(buffer, buffer_remaining, tag);
+
+  if (buffer_remaining < 0)
+  {
+    return buffer;
+  }
+
+  if (tag == CompactEncoder::RECORD)
+  {
+    return record.read(buffer, buffer_remaining);
+  }
+
+  uint64_t toi = 0;
+  buffer = read_varint(buffer, buffer_remaining, toi);
+
+  if (buffer_remaining < 0)
+  {
+    return buffer;
+  }
+
+  toi = timestamp + (uint64_t)zigzag_decode(toi);
+
+  switch (tag)
+  {
+    case CompactEncoder::INTEGER:
+    {
+      uint64_t value = 0;
+      buffer = read_varint(buffer, buffer_remaining, value);
+      record.set_value((Integer)zigzag_decode(value));
+      break;
+    }
+    case CompactEncoder::DOUBLE:
+    {
+      if (buffer_remaining < (int64_t)sizeof(double))
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      record.set_value(read_double(buffer));
+      buffer += sizeof(double);
+      buffer_remaining -= sizeof(double);
+      break;
+    }
+    case CompactEncoder::STRING:
+    {
+      uint64_t length = 0;
+      buffer = read_varint(buffer, buffer_remaining, length);
+
+      if (buffer_remaining < 0 || (uint64_t)buffer_remaining < length)
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      record.set_value(std::string(buffer, (size_t)length));
+      buffer += length;
+      buffer_remaining -= length;
+      break;
+    }
+    case CompactEncoder::INTEGER_ARRAY:
+    {
+      uint64_t count = 0;
+      buffer = read_varint(buffer, buffer_remaining, count);
+
+      // each element takes at least one byte
+      if (buffer_remaining < 0 || (uint64_t)buffer_remaining < count)
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      std::vector<Integer> values;
+      values.reserve((size_t)count);
+
+      for (uint64_t i = 0; i < count && buffer_remaining >= 0; ++i)
+      {
+        uint64_t value = 0;
+        buffer = read_varint(buffer, buffer_remaining, value);
+        values.push_back((Integer)zigzag_decode(value));
+      }
+
+      record.set_value(std::move(values));
+      break;
+    }
+    case CompactEncoder::DOUBLE_ARRAY:
+    {
+      uint64_t count = 0;
+      buffer = read_varint(buffer, buffer_remaining, count);
+
+      if (buffer_remaining < 0 ||
+          (uint64_t)buffer_remaining / sizeof(double) < count)
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      std::vector<double> values;
+      values.reserve((size_t)count);
+
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        values.push_back(read_double(buffer));
+        buffer += sizeof(double);
+      }
+
+      buffer_remaining -= count * sizeof(double);
+
+      record.set_value(std::move(values));
+      break;
+    }
+    case CompactEncoder::INTEGER_ARRAY_DELTA:
+    case CompactEncoder::DOUBLE_ARRAY_DELTA:
+    {
+      uint64_t base_clock = 0, total = 0, num_ranges = 0;
+      buffer = read_varint(buffer, buffer_remaining, base_clock);
+      buffer = read_varint(buffer, buffer_remaining, total);
+      buffer = read_varint(buffer, buffer_remaining, num_ranges);
+
+      // array sizes and ranges are 32 bit
+      if (buffer_remaining < 0 || total > UINT32_MAX ||
+          (uint64_t)buffer_remaining / 2 < num_ranges)
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      std::vector<knowledge::DirtyRanges::Range> ranges;
+      ranges.reserve((size_t)num_ranges);
+      bool valid = true;
+
+      for (uint64_t i = 0; i < num_ranges && buffer_remaining >= 0; ++i)
+      {
+        uint64_t first = 0, length = 0;
+        buffer = read_varint(buffer, buffer_remaining, first);
+        buffer = read_varint(buffer, buffer_remaining, length);
+
+        if (first + length > total || first + length < first)
+        {
+          valid = false;
+          length = 0;
+        }
+
+        ranges.emplace_back((uint32_t)first, (uint32_t)(first + length));
+      }
+
+      if (buffer_remaining < 0 || !valid)
+      {
+        buffer_remaining = -1;
+        return buffer;
+      }
+
+      bool integers = tag == CompactEncoder::INTEGER_ARRAY_DELTA;
+
+      // the values are kept apart from the array they patch, which is
+      // only known when the message is applied
+      record.clear_value();
+
+      delta.type = integers ? knowledge::KnowledgeRecord::INTEGER_ARRAY
+                            : knowledge::KnowledgeRecord::DOUBLE_ARRAY;
+      delta.size = (uint32_t)total;
+      delta.base_clock = base_clock;
+      delta.toi = toi;
+      delta.ranges = std::move(ranges);
+
+      if (integers)
+      {
+        for (auto& range : delta.ranges)
+        {
+          for (uint32_t i = range.first;
+               i < range.second && buffer_remaining >= 0; ++i)
+          {
+            uint64_t value = 0;
+            buffer = read_varint(buffer, buffer_remaining, value);
+            delta.integers.push_back((Integer)zigzag_decode(value));
+          }
+        }
+      }
+      else
+      {
+        int64_t count = 0;
+
+        for (auto& range : delta.ranges)
+        {
+          count += range.second - range.first;
+        }
+
+        if (buffer_remaining / (int64_t)sizeof(double) < count)
+        {
+          delta.clear();
+          buffer_remaining = -1;
+          return buffer;
+        }
+
+        delta.doubles.reserve((size_t)count);
+
+        for (auto& range : delta.ranges)
+        {
+          for (uint32_t i = range.first; i < range.second; ++i)
+          {
+            delta.doubles.push_back(read_double(buffer));
+            buffer += sizeof(double);
+          }
+        }
+
+        buffer_remaining -= count * sizeof(double);
+      }
+
+      if (buffer_remaining < 0 || key.empty())
+      {
+        delta.clear();
+      }
+      break;
+    }
+    default:
+      buffer_remaining = -1;
+      return buffer;
+  }
+
+  record.set_toi(toi);
+
+  return buffer;
+}
+
+uint64_t CompactDecoder::get_unknown(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return unknown_;
+}
+
+void CompactDecoder::clear(void)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  dictionaries_.clear();
+}
+}
+}
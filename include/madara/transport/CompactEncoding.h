@@ -0,0 +1,380 @@
+#ifndef _MADARA_COMPACT_ENCODING_H_
+#define _MADARA_COMPACT_ENCODING_H_
+
+/**
+ * @file CompactEncoding.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the encoder and decoder of knowledge updates in the
+ * compact wire encoding, @see TransportSettings::send_compact_encoding
+ **/
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "madara/LockType.h"
+#include "madara/utility/StdInt.h"
+#include "madara/MadaraExport.h"
+#include "madara/knowledge/DirtyRanges.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace madara
+{
+namespace knowledge
+{
+class ThreadSafeContext;
+}
+
+namespace transport
+{
+/// the most bytes a 64 bit varint can take
+static const int64_t max_varint_size = 10;
+
+/**
+ * Returns the number of bytes needed to encode a varint
+ * @param  value    the value to encode
+ * @return the size of the encoded value
+ **/
+inline int64_t varint_size(uint64_t value)
+{
+  int64_t size = 1;
+
+  for (; value >= 0x80; value >>= 7)
+  {
+    ++size;
+  }
+
+  return size;
+}
+
+/**
+ * Writes a varint: 7 bits per byte, least significant first, with the
+ * high bit set on every byte but the last. The caller must ensure the
+ * buffer has varint_size (value) bytes.
+ * @param  buffer   the buffer to write to
+ * @param  value    the value to write
+ * @return the buffer position after the varint
+ **/
+inline char* write_varint(char* buffer, uint64_t value)
+{
+  for (; value >= 0x80; value >>= 7)
+  {
+    *buffer++ = (char)(value | 0x80);
+  }
+
+  *buffer++ = (char)value;
+
+  return buffer;
+}
+
+/**
+ * Reads a varint
+ * @param  buffer            the buffer to read from
+ * @param  buffer_remaining  bytes remaining in the buffer, which becomes
+ *                           negative if the varint does not fit
+ * @param  value             the value read
+ * @return the buffer position after the varint
+ **/
+inline const char* read_varint(
+    const char* buffer, int64_t& buffer_remaining, uint64_t& value)
+{
+  value = 0;
+
+  for (int shift = 0; shift < 64 && buffer_remaining > 0; shift += 7)
+  {
+    unsigned char byte = (unsigned char)*buffer++;
+    --buffer_remaining;
+
+    value |= (uint64_t)(byte & 0x7f) << shift;
+
+    if ((byte & 0x80) == 0)
+    {
+      return buffer;
+    }
+  }
+
+  buffer_remaining = -1;
+
+  return buffer;
+}
+
+/**
+ * Maps signed integers to unsigned ones, so small negative values also
+ * have short varints (0, -1, 1, -2 become 0, 1, 2, 3)
+ * @param  value    the signed value
+ * @return the zigzag encoded value
+ **/
+inline uint64_t zigzag_encode(int64_t value)
+{
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/**
+ * Reverses zigzag_encode
+ * @param  value    the zigzag encoded value
+ * @return the signed value
+ **/
+inline int64_t zigzag_decode(uint64_t value)
+{
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * @class CompactEncoder
+ * @brief Encodes knowledge updates for one sender. Each variable gets a
+ *        small integer id that is announced with its name the first time
+ *        the variable is sent and again every refresh interval, so peers
+ *        that joined late or lost the announcement learn it. Other updates
+ *        refer to the variable by id only. Integers, sizes and times of
+ *        last update are varints, and times are relative to the message.
+ *
+ *        Update format:
+ *
+ *        [varint id << 1 | 1 if the name follows]<br />
+ *        [varint name length | name] (only if the name follows)<br />
+ *        [varint tag] (@see Tags)<br />
+ *        [zigzag varint toi - message timestamp] (all tags but RECORD)<br />
+ *        [value in the format of the tag]
+ *
+ *        An id of 0 always comes with the name and is not remembered,
+ *        which is used once the dictionary is full.
+ **/
+class MADARA_EXPORT CompactEncoder
+{
+public:
+  /**
+   * The encodings of values
+   **/
+  enum Tags
+  {
+    /// any other type, written by KnowledgeRecord::write without a key
+    RECORD = 0,
+
+    /// zigzag varint
+    INTEGER = 1,
+
+    /// 8 byte double
+    DOUBLE = 2,
+
+    /// varint length and characters
+    STRING = 3,
+
+    /// varint count and zigzag varints
+    INTEGER_ARRAY = 4,
+
+    /// varint count and 8 byte doubles
+    DOUBLE_ARRAY = 5,
+
+    /// varint clock of the base array, varint size, varint ranges, varint
+    /// first and length of each range, and the zigzag varints in the ranges
+    INTEGER_ARRAY_DELTA = 6,
+
+    /// like INTEGER_ARRAY_DELTA, with 8 byte doubles in the ranges
+    DOUBLE_ARRAY_DELTA = 7
+  };
+
+  /**
+   * Constructor, which starts a new epoch
+   **/
+  CompactEncoder();
+
+  /**
+   * Prepares to encode the updates of a message. Names announced in the
+   * previous message are announced again unless it was confirmed.
+   * @param  timestamp    the timestamp of the message header
+   * @param  refresh      nanoseconds between announcements of a name.
+   *                      0 announces each name only once.
+   * @param  max_keys     the most ids to assign in this epoch, which is
+   *                      at most CompactDecoder::max_id
+   **/
+  void start(uint64_t timestamp, uint64_t refresh, uint32_t max_keys);
+
+  /**
+   * Confirms that the current message was sent, so the names it announced
+   * are not announced again until the refresh interval passes
+   **/
+  void confirm(void);
+
+  /**
+   * Returns the epoch of the ids, which is sent in the message header
+   * @return  the time the epoch started
+   **/
+  uint64_t get_epoch(void) const;
+
+  /**
+   * Returns the number of assigned ids
+   * @return  the number of variables in the dictionary
+   **/
+  size_t size(void) const;
+
+  /**
+   * Returns the encoded size of an update
+   * @param  key      the name of the variable
+   * @param  record   the value of the variable
+   * @param  ranges   if not null, the ranges of an array delta
+   * @param  base_clock  the clock of the array an array delta patches
+   * @return  the number of bytes write would use
+   **/
+  int64_t encoded_size(const std::string& key,
+      const knowledge::KnowledgeRecord& record,
+      const knowledge::DirtyRanges* ranges = nullptr,
+      uint64_t base_clock = 0) const;
+
+  /**
+   * Writes an update to a buffer and updates the amount of buffer room
+   * remaining. Only the newest value of a record with history is written.
+   * @param  buffer            the buffer to write to
+   * @param  key               the name of the variable
+   * @param  record            the value of the variable
+   * @param  buffer_remaining  the count of bytes remaining in the buffer
+   * @param  ranges            if not null, the changed ranges of an array
+   *                           to send as a delta
+   * @param  base_clock        the clock receivers hold for the array an
+   *                           array delta patches (@see
+   *                           KnowledgeRecord::write_delta)
+   * @return  the buffer position for the next write
+   * @throw exceptions::MemoryException  not enough buffer to encode
+   **/
+  char* write(char* buffer, const std::string& key,
+      const knowledge::KnowledgeRecord& record, int64_t& buffer_remaining,
+      const knowledge::DirtyRanges* ranges = nullptr,
+      uint64_t base_clock = 0);
+
+private:
+  /**
+   * A variable in the dictionary
+   **/
+  struct Entry
+  {
+    /// the id of the variable
+    uint32_t id = 0;
+
+    /// the timestamp of the last sent message that announced the name,
+    /// or 0 if no such message has been sent
+    uint64_t announced = 0;
+  };
+
+  /**
+   * Finds the id of a variable and whether its name must be sent
+   * @param  key        the name of the variable
+   * @param  id         the id, which is 0 if the dictionary is full
+   * @param  announce   true if the name must be sent
+   **/
+  void lookup(const std::string& key, uint32_t& id, bool& announce) const;
+
+  /// ids of the variables sent in this epoch
+  std::unordered_map<std::string, Entry> ids_;
+
+  /// names announced in the current message, until it is confirmed
+  std::vector<std::string> pending_;
+
+  /// the time the epoch started
+  uint64_t epoch_;
+
+  /// the next id to assign
+  uint32_t next_id_ = 1;
+
+  /// the timestamp of the current message
+  uint64_t timestamp_ = 0;
+
+  /// nanoseconds between announcements of a name
+  uint64_t refresh_ = 0;
+
+  /// the most ids to assign in this epoch
+  uint32_t max_keys_ = 0;
+};
+
+/**
+ * @class CompactDecoder
+ * @brief Decodes knowledge updates in the compact encoding, keeping the
+ *        dictionary of ids announced by each originator in each epoch.
+ *        Transports of one knowledge base share an originator but each
+ *        have their own epoch, so the latest max_epochs epochs of an
+ *        originator are kept. Updates that refer to an id that has not
+ *        been announced yet are skipped. The decoder is safe to use from
+ *        multiple decode threads.
+ **/
+class MADARA_EXPORT CompactDecoder
+{
+public:
+  /// the largest id accepted in announcements, which bounds the size of
+  /// each dictionary. Encoders assign no larger ids.
+  static const uint32_t max_id = 1 << 16;
+
+  /// the most epochs whose dictionaries are kept for each originator
+  static const size_t max_epochs = 4;
+
+  /**
+   * Reads an update from a buffer and updates the amount of buffer room
+   * remaining
+   * @param  buffer            the buffer to read from
+   * @param  buffer_remaining  the count of bytes remaining in the buffer,
+   *                           which becomes negative if the update is
+   *                           malformed
+   * @param  originator        the originator of the message
+   * @param  epoch             the epoch of the message header
+   * @param  timestamp         the timestamp of the message header
+   * @param  key               the name of the variable, which is empty if
+   *                           the id of the update is unknown
+   * @param  record            the value of the variable
+   * @param  context           the context to read array delta bases from
+   * @return  the buffer position for the next read
+   **/
+  const char* read(const char* buffer, int64_t& buffer_remaining,
+      const char* originator, uint64_t epoch, uint64_t timestamp,
+      std::string& key, knowledge::KnowledgeRecord& record,
+      const knowledge::ThreadSafeContext& context);
+
+  /**
+   * Reads an update from a buffer and updates the amount of buffer room
+   * remaining. An array delta is read into delta and the record is left
+   * EMPTY, so that the delta can be applied to its base when the message
+   * is applied (@see knowledge::ArrayDelta::apply).
+   * @param  buffer            the buffer to read from
+   * @param  buffer_remaining  the count of bytes remaining in the buffer,
+   *                           which becomes negative if the update is
+   *                           malformed
+   * @param  originator        the originator of the message
+   * @param  epoch             the epoch of the message header
+   * @param  timestamp         the timestamp of the message header
+   * @param  key               the name of the variable, which is empty if
+   *                           the id of the update is unknown
+   * @param  record            the value of the variable
+   * @param  delta             the array delta that was read, if any
+   * @return  the buffer position for the next read
+   **/
+  const char* read(const char* buffer, int64_t& buffer_remaining,
+      const char* originator, uint64_t epoch, uint64_t timestamp,
+      std::string& key, knowledge::KnowledgeRecord& record,
+      knowledge::ArrayDelta& delta);
+
+  /**
+   * Returns the number of updates skipped because of unknown ids
+   * @return  the number of skipped updates
+   **/
+  uint64_t get_unknown(void) const;
+
+  /**
+   * Forgets the dictionaries of all originators
+   **/
+  void clear(void);
+
+private:
+  /// the names of the variables announced in an epoch, by id
+  typedef std::vector<std::string> Dictionary;
+
+  /// dictionaries by originator and then epoch
+  std::map<std::string, std::map<uint64_t, Dictionary>> dictionaries_;
+
+  /// updates skipped because of unknown ids
+  uint64_t unknown_ = 0;
+
+  /// guards the dictionaries
+  mutable MADARA_LOCK_TYPE mutex_;
+};
+}
+}
+
+#endif  // _MADARA_COMPACT_ENCODING_H_
@@ -0,0 +1,226 @@
+
+#include <algorithm>
+#include <string.h>
+#include <sstream>
+
+#include "madara/exceptions/MemoryException.h"
+#include "CompactMessageHeader.h"
+#include "CompactEncoding.h"
+#include "madara/utility/Utility.h"
+
+namespace
+{
+/**
+ * Reads a varint length and string into a fixed size field, failing if
+ * the string does not fit
+ **/
+const char* read_string(const char* buffer, int64_t& buffer_remaining,
+    char* target, size_t target_size)
+{
+  uint64_t length = 0;
+  buffer = madara::transport::read_varint(buffer, buffer_remaining, length);
+
+  if (buffer_remaining < 0 || (uint64_t)buffer_remaining < length ||
+      length >= target_size)
+  {
+    buffer_remaining = -1;
+    return buffer;
+  }
+
+  memcpy(target, buffer, (size_t)length);
+  target[length] = 0;
+
+  buffer_remaining -= length;
+
+  return buffer + length;
+}
+}
+
+madara::transport::CompactMessageHeader::CompactMessageHeader()
+  : MessageHeader(), epoch(0)
+{
+  memcpy(madara_id, COMPACT_MADARA_ID, 7);
+  madara_id[7] = 0;
+}
+
+madara::transport::CompactMessageHeader::~CompactMessageHeader() {}
+
+uint32_t madara::transport::CompactMessageHeader::encoded_size(void) const
+{
+  size_t domain_size = strnlen(domain, sizeof(domain) - 1);
+  size_t originator_size = strnlen(originator, sizeof(originator) - 1);
+
+  return (uint32_t)(sizeof(uint64_t) * 2  // size, timestamp
+                    + sizeof(char) * (MADARA_IDENTIFIER_LENGTH + 1)  // id, ttl
+                    + sizeof(uint32_t)  // updates
+                    + varint_size(epoch) + varint_size(type) +
+                    varint_size(quality) + varint_size(clock) +
+                    varint_size(domain_size) + domain_size +
+                    varint_size(originator_size) + originator_size);
+}
+
+uint32_t madara::transport::CompactMessageHeader::static_encoded_size(void)
+{
+  // the fixed fields and six one byte varints
+  return sizeof(uint64_t) * 2 + sizeof(char) * (MADARA_IDENTIFIER_LENGTH + 1) +
+         sizeof(uint32_t) + 6;
+}
+
+const char* madara::transport::CompactMessageHeader::read(
+    const char* buffer, int64_t& buffer_remaining)
+{
+  // the fixed fields come first
+  if (buffer_remaining < (int64_t)(sizeof(size) + MADARA_IDENTIFIER_LENGTH +
+                                   sizeof(updates) + sizeof(timestamp) + 1))
+  {
+    buffer_remaining = -1;
+    return buffer;
+  }
+
+  memcpy(&size, buffer, sizeof(size));
+  size = madara::utility::endian_swap(size);
+  buffer += sizeof(size);
+
+  utility::strncpy_safe(madara_id, buffer, MADARA_IDENTIFIER_LENGTH);
+  buffer += sizeof(char) * MADARA_IDENTIFIER_LENGTH;
+
+  memcpy(&updates, buffer, sizeof(updates));
+  updates = madara::utility::endian_swap(updates);
+  buffer += sizeof(updates);
+
+  memcpy(&timestamp, buffer, sizeof(timestamp));
+  timestamp = madara::utility::endian_swap(timestamp);
+  buffer += sizeof(timestamp);
+
+  memcpy(&ttl, buffer, 1);
+  buffer += 1;
+
+  buffer_remaining -= sizeof(size) + MADARA_IDENTIFIER_LENGTH +
+                      sizeof(updates) + sizeof(timestamp) + 1;
+
+  uint64_t value = 0;
+
+  buffer = read_varint(buffer, buffer_remaining, epoch);
+
+  buffer = read_varint(buffer, buffer_remaining, value);
+  type = (uint32_t)value;
+
+  buffer = read_varint(buffer, buffer_remaining, value);
+  quality = (uint32_t)value;
+
+  buffer = read_varint(buffer, buffer_remaining, clock);
+
+  if (buffer_remaining >= 0)
+  {
+    buffer = read_string(buffer, buffer_remaining, domain, sizeof(domain));
+  }
+
+  if (buffer_remaining >= 0)
+  {
+    buffer =
+        read_string(buffer, buffer_remaining, originator, sizeof(originator));
+  }
+
+  return buffer;
+}
+
+char* madara::transport::CompactMessageHeader::write(
+    char* buffer, int64_t& buffer_remaining)
+{
+  size_t domain_size = strnlen(domain, sizeof(domain) - 1);
+  size_t originator_size = strnlen(originator, sizeof(originator) - 1);
+  int64_t needed = encoded_size();
+
+  if (buffer_remaining < needed)
+  {
+    std::stringstream buffer;
+    buffer << "CompactMessageHeader::write: ";
+    buffer << needed << " byte header encoding cannot";
+    buffer << " fit in ";
+    buffer << buffer_remaining << " byte buffer\n";
+
+    throw exceptions::MemoryException(buffer.str());
+  }
+
+  *(uint64_t*)buffer = madara::utility::endian_swap(size);
+  buffer += sizeof(size);
+
+  utility::strncpy_safe(buffer, madara_id, MADARA_IDENTIFIER_LENGTH);
+  buffer += sizeof(char) * MADARA_IDENTIFIER_LENGTH;
+
+  *(uint32_t*)buffer = madara::utility::endian_swap(updates);
+  buffer += sizeof(updates);
+
+  *(uint64_t*)buffer = madara::utility::endian_swap(timestamp);
+  buffer += sizeof(timestamp);
+
+  memcpy(buffer, &ttl, 1);
+  buffer += 1;
+
+  buffer = write_varint(buffer, epoch);
+  buffer = write_varint(buffer, type);
+  buffer = write_varint(buffer, quality);
+  buffer = write_varint(buffer, clock);
+
+  buffer = write_varint(buffer, domain_size);
+  memcpy(buffer, domain, domain_size);
+  buffer += domain_size;
+
+  buffer = write_varint(buffer, originator_size);
+  memcpy(buffer, originator, originator_size);
+  buffer += originator_size;
+
+  buffer_remaining -= needed;
+
+  return buffer;
+}
+
+std::string madara::transport::CompactMessageHeader::to_string(void)
+{
+  std::stringstream buffer;
+  buffer << encoded_size() << ": size (8:" << size << "), ";
+  buffer << "encoding (8:" << madara_id << "), ";
+  buffer << "numupdates (4:" << updates << "), ";
+  buffer << "timestamp (8:" << timestamp << "), ";
+  buffer << "ttl (1:" << (int)ttl << "), ";
+  buffer << "epoch (" << epoch << "), ";
+  buffer << "type (" << type << "), ";
+  buffer << "quality (" << quality << "), ";
+  buffer << "clock (" << clock << "), ";
+  buffer << "domain (" << domain << "), ";
+  buffer << "originator (" << originator << ")";
+
+  return buffer.str();
+}
+
+bool madara::transport::CompactMessageHeader::equals(const MessageHeader& other)
+{
+  const CompactMessageHeader* compact =
+      dynamic_cast<const CompactMessageHeader*>(&other);
+
+  return size == other.size && updates == other.updates &&
+         type == other.type && quality == other.quality &&
+         clock == other.clock && timestamp == other.timestamp &&
+         ttl == other.ttl &&
+         strncmp(domain, other.domain, sizeof(domain)) == 0 &&
+         strncmp(originator, other.originator, sizeof(originator)) == 0 &&
+         compact && epoch == compact->epoch;
+}
+
+madara::transport::MessageHeader*
+madara::transport::CompactMessageHeader::to_message_header(void) const
+{
+  MessageHeader* header = new MessageHeader();
+
+  memcpy(header->domain, domain, sizeof(domain));
+  memcpy(header->originator, originator, sizeof(originator));
+  header->type = type;
+  header->updates = updates;
+  header->quality = quality;
+  header->clock = clock;
+  header->timestamp = timestamp;
+  header->ttl = ttl;
+  header->size = size;
+
+  return header;
+}
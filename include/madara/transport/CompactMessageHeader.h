@@ -0,0 +1,130 @@
+#ifndef _MADARA_COMPACT_MESSAGE_HEADER_H_
+#define _MADARA_COMPACT_MESSAGE_HEADER_H_
+
+/**
+ * @file CompactMessageHeader.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the message header of the compact wire encoding,
+ * @see TransportSettings::send_compact_encoding
+ **/
+
+#include <string.h>
+#include "madara/utility/StdInt.h"
+#include "madara/MadaraExport.h"
+#include "madara/transport/MessageHeader.h"
+
+namespace madara
+{
+namespace transport
+{
+#define COMPACT_MADARA_ID "KCMP1.5"
+
+/**
+ * @class CompactMessageHeader
+ * @brief Defines the header of messages in the compact encoding, where
+ *        updates refer to variables through a dictionary of the
+ *        originator and integers are varints. The domain and originator
+ *        take only as many bytes as they have characters.
+ *
+ *        Format:
+ *
+ *        [0] [64 bit unsigned size]<br />
+ *        [8] [8 byte transport id]<br />
+ *        [16] [32 bit unsigned num updates]<br />
+ *        [20] [64 bit unsigned wall clock timestamp]<br />
+ *        [28] [8 bit unsigned ttl--for rebroadcasts]<br />
+ *        [29] [varint dictionary epoch]<br />
+ *        [..] [varint type]<br />
+ *        [..] [varint quality]<br />
+ *        [..] [varint Lamport clock]<br />
+ *        [..] [varint domain length | domain]<br />
+ *        [..] [varint originator length | originator]<br />
+ *        [..] [knowledge updates start here]
+ */
+class MADARA_EXPORT CompactMessageHeader : public MessageHeader
+{
+public:
+  /**
+   * Constructor
+   **/
+  CompactMessageHeader();
+
+  /**
+   * Destructor
+   **/
+  virtual ~CompactMessageHeader();
+
+  /**
+   * Returns the size of the encoded header, which depends on the
+   * values of its fields
+   **/
+  virtual uint32_t encoded_size(void) const;
+
+  /**
+   * Returns the smallest possible size of an encoded header
+   **/
+  static uint32_t static_encoded_size(void);
+
+  /**
+   * Reads a CompactMessageHeader instance from a buffer and updates
+   * the amount of buffer room remaining. Unlike the other headers,
+   * a truncated header does not throw, since its size is not known
+   * before reading it. Instead, buffer_remaining becomes negative.
+   * @param     buffer     the readable buffer where data is stored
+   * @param     buffer_remaining  the count of bytes remaining in the
+   *                              buffer to read
+   * @return    current buffer position for next read
+   **/
+  virtual const char* read(const char* buffer, int64_t& buffer_remaining);
+
+  /**
+   * Writes a CompactMessageHeader instance to a buffer and updates
+   * the amount of buffer room remaining.
+   * @param     buffer     the readable buffer where data is stored
+   * @param     buffer_remaining  the count of bytes remaining in the
+   *                              buffer to read
+   * @return    current buffer position for next write
+   * @throw exceptions::MemoryException  not enough buffer to encode
+   **/
+  virtual char* write(char* buffer, int64_t& buffer_remaining);
+
+  /**
+   * Converts the relevant fields to a printable string
+   * @return  the printable string of fields in the header
+   **/
+  virtual std::string to_string(void);
+
+  /**
+   * Compares the fields of this instance to another instance
+   * @param     other      the other instance to compare against
+   * @return    true if equal, false otherwise
+   **/
+  virtual bool equals(const MessageHeader& other);
+
+  /**
+   * Creates a normal header with the same fields, e.g., for
+   * rebroadcasting updates that have been decoded
+   * @return   a new header, which the caller owns
+   **/
+  MessageHeader* to_message_header(void) const;
+
+  /**
+   * Tests the buffer for a compact message identifier
+   * @return   true if identifier indicates compact message header
+   **/
+  static inline bool compact_message_header_test(const char* buffer)
+  {
+    return strncmp(&(buffer[8]), COMPACT_MADARA_ID, 7) == 0;
+  }
+
+  /**
+   * the epoch of the originator's key dictionary. Ids are only valid
+   * within one epoch.
+   **/
+  uint64_t epoch;
+};
+}
+}
+
+#endif  // _MADARA_COMPACT_MESSAGE_HEADER_H_
@@ -843,8 +843,11 @@ void madara::transport::frag(
     uint64_t clock,
     uint64_t timestamp,
     uint32_t quality, unsigned char ttl,
-    uint64_t fragment_size, FragmentMap& map)
+    uint64_t fragment_size, FragmentSlices& slices)
 {
+  slices.headers.clear();
+  slices.payloads.clear();
+
   if(fragment_size > 0)
   {
     madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_MAJOR,
@@ -853,7 +856,7 @@ void madara::transport::frag(
         fragment_size);
 
     uint64_t data_per_packet = fragment_size;
-//        fragment_size - FragmentMessageHeader::static_encoded_size();
+    uint32_t header_size = FragmentSlices::header_size();
 
     const char* buffer = source;
     FragmentMessageHeader header;
@@ -866,31 +869,6 @@ void madara::transport::frag(
     header.quality = quality;
     header.ttl = ttl;
 
-    // if(MessageHeader::message_header_test(source))
-    // {
-    //   madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_DETAILED,
-    //       "transport::frag:"
-    //       " regular message header detected\n",
-    //       fragment_size);
-
-    //   MessageHeader contents_header;
-    //   int64_t buffer_remaining = contents_header.encoded_size();
-    //   contents_header.read(source, buffer_remaining);
-    //   header = contents_header;
-    // }
-    // else if(ReducedMessageHeader::message_header_test(source))
-    // {
-    //   madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_DETAILED,
-    //       "transport::frag:"
-    //       " reduced message header detected\n");
-
-    //   ReducedMessageHeader contents_header;
-    //   int64_t buffer_remaining = contents_header.encoded_size();
-    //   contents_header.read(source, buffer_remaining);
-    //   header = contents_header;
-    // }
-
-//    total_size = header.size;
     header.updates =(uint32_t)(total_size / data_per_packet);
     uint64_t last_size = total_size % data_per_packet;
 
@@ -908,50 +886,68 @@ void madara::transport::frag(
         " iterating over %d updates. last_size=%d\n",
         (int)header.updates, (int)last_size);
 
+    slices.headers.resize((size_t)header.updates * header_size);
+    slices.payloads.reserve(header.updates);
+
     for(uint32_t i = 0; i < header.updates; ++i)
     {
-      char* new_frag;
-      size_t cur_size;
-      int64_t buffer_remaining;
       uint64_t actual_data_size;
 
       if(i == header.updates - 1 && last_size != 0)
       {
-        cur_size = (size_t)last_size + FragmentMessageHeader::static_encoded_size();
+        actual_data_size = last_size;
       }
       else
       {
-        cur_size = (size_t)fragment_size + FragmentMessageHeader::static_encoded_size();
+        actual_data_size = fragment_size;
       }
 
-      buffer_remaining = cur_size;
-      actual_data_size =
-          cur_size - FragmentMessageHeader::static_encoded_size();
-      new_frag = new char[cur_size];
-
-      map[i] = new_frag;
-
-      madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_DETAILED,
-          "transport::frag:"
-          " writing %d packet of size %d (non-header:%d).\n",
-          (int)i, (int)cur_size, (int)actual_data_size);
+      int64_t buffer_remaining = header_size;
 
       header.update_number = i;
-      header.size = cur_size;
+      header.size = actual_data_size + header_size;
 
       madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_DETAILED,
           "transport::frag:"
-          " inspecting frag: %s\n", header.to_string().c_str());
+          " writing %d packet of size %d (non-header:%d).\n",
+          (int)i, (int)header.size, (int)actual_data_size);
 
+      header.write(slices.headers.data() + (size_t)i * header_size,
+          buffer_remaining);
+      slices.payloads.emplace_back(buffer, (size_t)actual_data_size);
 
-      new_frag = header.write(new_frag, buffer_remaining);
-      memcpy(new_frag, buffer, (size_t)actual_data_size);
       buffer += actual_data_size;
-      total_size -= actual_data_size;
     }
   }
 }
 
+void madara::transport::frag(
+    const char* source, uint64_t total_size,
+    const char* originator, const char* domain,
+    uint64_t clock,
+    uint64_t timestamp,
+    uint32_t quality, unsigned char ttl,
+    uint64_t fragment_size, FragmentMap& map)
+{
+  FragmentSlices slices;
+
+  frag(source, total_size, originator, domain, clock, timestamp, quality,
+      ttl, fragment_size, slices);
+
+  // copy each header and slice into a standalone fragment
+  for(size_t i = 0; i < slices.size(); ++i)
+  {
+    size_t payload_size = slices.payloads[i].second;
+    char* new_frag = new char[slices.header_size() + payload_size];
+
+    memcpy(new_frag, slices.header(i), slices.header_size());
+    memcpy(new_frag + slices.header_size(), slices.payloads[i].first,
+        payload_size);
+
+    map[(uint32_t)i] = new_frag;
+  }
+}
+
 bool madara::transport::is_complete(
     const char* originator, uint64_t clock, OriginatorFragmentMap& map)
 {
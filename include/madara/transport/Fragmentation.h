@@ -13,6 +13,8 @@
 #include <map>
 #include <string>
 #include <string.h>
+#include <utility>
+#include <vector>
 #include "madara/utility/StdInt.h"
 #include "madara/utility/ScopedArray.h"
 #include "madara/MadaraExport.h"
@@ -137,6 +139,45 @@ public:
  **/
 typedef std::map<uint32_t, utility::ScopedArray<const char>> FragmentMap;
 
+/**
+ * Fragments of a large packet that refer to the packet instead of
+ * copying it. Each fragment is an encoded FragmentMessageHeader followed
+ * by a slice of the source buffer, ready for a scatter/gather send.
+ **/
+struct MADARA_EXPORT FragmentSlices
+{
+  /**
+   * Returns the number of fragments
+   **/
+  size_t size(void) const
+  {
+    return payloads.size();
+  }
+
+  /**
+   * Returns the encoded header of a fragment
+   * @param  i   the fragment number
+   **/
+  const char* header(size_t i) const
+  {
+    return headers.data() + i * FragmentMessageHeader::static_encoded_size();
+  }
+
+  /**
+   * Returns the size of every encoded fragment header
+   **/
+  static uint32_t header_size(void)
+  {
+    return FragmentMessageHeader::static_encoded_size();
+  }
+
+  /// encoded fragment headers, header_size () bytes per fragment
+  std::vector<char> headers;
+
+  /// start and size of each fragment's data within the source buffer
+  std::vector<std::pair<const char*, size_t>> payloads;
+};
+
 /**
  * Map of clocks to fragments
  **/
@@ -202,6 +243,28 @@ MADARA_EXPORT void frag(
     uint32_t quality, unsigned char ttl,
     uint64_t fragment_size, FragmentMap& map);
 
+/**
+ * Breaks a large packet into fragment headers and slices of the packet.
+ * The slices point into source, which must outlive them.
+ * @param  source         large packet that needs to be fragmented
+ * @param  total_size     total size of the source buffer
+ * @param  originator     the originator id of the agent
+ * @param  domain         the transport knowledge domain
+ * @param  clock          the lamport clock for fragments to use
+ * @param  timestamp      the ns timestamp of the message
+ * @param  quality        the quality of the sender
+ * @param  ttl            the time-to-live of the message for rebroadcasting
+ * @param  fragment_size  maximum fragment size
+ * @param  slices         the resulting fragment headers and slices
+ **/
+MADARA_EXPORT void frag(
+    const char* source, uint64_t total_size,
+    const char* originator, const char* domain,
+    uint64_t clock,
+    uint64_t timestamp,
+    uint32_t quality, unsigned char ttl,
+    uint64_t fragment_size, FragmentSlices& slices);
+
 /**
  * Breaks a large packet into smaller packets
  * @param   originator   the originator of the message
@@ -8,6 +8,11 @@ namespace logger = madara::logger;
 namespace containers = madara::knowledge::containers;
 typedef madara::knowledge::KnowledgeRecord::Integer Integer;
 
+const uint32_t
+    madara::transport::QoSTransportSettings::default_critical_send_priority;
+const uint64_t
+    madara::transport::QoSTransportSettings::default_max_delayed_sends;
+
 madara::transport::QoSTransportSettings::QoSTransportSettings()
   : TransportSettings(),
     rebroadcast_ttl_(0),
@@ -18,6 +23,9 @@ madara::transport::QoSTransportSettings::QoSTransportSettings()
     packet_drop_burst_(1),
     max_send_bandwidth_(-1),
     max_total_bandwidth_(-1),
+    send_bandwidth_burst_(-1),
+    critical_send_priority_(default_critical_send_priority),
+    max_delayed_sends_(default_max_delayed_sends),
     deadline_(-1)
 {
 }
@@ -38,6 +46,10 @@ madara::transport::QoSTransportSettings::QoSTransportSettings(
     packet_drop_burst_(settings.packet_drop_burst_),
     max_send_bandwidth_(settings.max_send_bandwidth_),
     max_total_bandwidth_(settings.max_total_bandwidth_),
+    send_bandwidth_burst_(settings.send_bandwidth_burst_),
+    send_priorities_(settings.send_priorities_),
+    critical_send_priority_(settings.critical_send_priority_),
+    max_delayed_sends_(settings.max_delayed_sends_),
     deadline_(settings.deadline_)
 {
 }
@@ -52,6 +64,9 @@ madara::transport::QoSTransportSettings::QoSTransportSettings(
     packet_drop_rate_(0.0),
     max_send_bandwidth_(-1),
     max_total_bandwidth_(-1),
+    send_bandwidth_burst_(-1),
+    critical_send_priority_(default_critical_send_priority),
+    max_delayed_sends_(default_max_delayed_sends),
     deadline_(-1)
 {
   const QoSTransportSettings* rhs =
@@ -71,6 +86,10 @@ madara::transport::QoSTransportSettings::QoSTransportSettings(
     packet_drop_burst_ = rhs->packet_drop_burst_;
     max_send_bandwidth_ = rhs->max_send_bandwidth_;
     max_total_bandwidth_ = rhs->max_total_bandwidth_;
+    send_bandwidth_burst_ = rhs->send_bandwidth_burst_;
+    send_priorities_ = rhs->send_priorities_;
+    critical_send_priority_ = rhs->critical_send_priority_;
+    max_delayed_sends_ = rhs->max_delayed_sends_;
     deadline_ = rhs->deadline_;
   }
   else
@@ -108,6 +127,10 @@ void madara::transport::QoSTransportSettings::operator=(
     packet_drop_burst_ = rhs.packet_drop_burst_;
     max_send_bandwidth_ = rhs.max_send_bandwidth_;
     max_total_bandwidth_ = rhs.max_total_bandwidth_;
+    send_bandwidth_burst_ = rhs.send_bandwidth_burst_;
+    send_priorities_ = rhs.send_priorities_;
+    critical_send_priority_ = rhs.critical_send_priority_;
+    max_delayed_sends_ = rhs.max_delayed_sends_;
     deadline_ = rhs.deadline_;
   }
 }
@@ -129,6 +152,10 @@ void madara::transport::QoSTransportSettings::operator=(
     packet_drop_burst_ = 1;
     max_send_bandwidth_ = -1;
     max_total_bandwidth_ = -1;
+    send_bandwidth_burst_ = -1;
+    send_priorities_.clear();
+    critical_send_priority_ = default_critical_send_priority;
+    max_delayed_sends_ = default_max_delayed_sends;
     deadline_ = -1;
 
     TransportSettings* lhs_base = (TransportSettings*)this;
@@ -533,9 +560,10 @@ int madara::transport::QoSTransportSettings::filter_decode(
 
   if(buffer_filters_.size() == 0)
   {
-    // id is either karl or KaRL. If it's anything else, then error
+    // id is either karl, KaRL or KCMP. If it's anything else, then error
     if(utility::begins_with (header.id, "karl") ||
-       utility::begins_with (header.id, "KaRL"))
+       utility::begins_with (header.id, "KaRL") ||
+       utility::begins_with (header.id, "KCMP"))
     {
       madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_MAJOR,
           "QoSTransportSettings::filter_decode: header: "
@@ -782,6 +810,83 @@ int64_t madara::transport::QoSTransportSettings::get_total_bandwidth_limit(
   return max_total_bandwidth_;
 }
 
+void madara::transport::QoSTransportSettings::set_send_bandwidth_burst(
+    int64_t bytes)
+{
+  send_bandwidth_burst_ = bytes;
+}
+
+int64_t madara::transport::QoSTransportSettings::get_send_bandwidth_burst(
+    void) const
+{
+  return send_bandwidth_burst_;
+}
+
+void madara::transport::QoSTransportSettings::set_send_priority(
+    const std::string& prefix, uint32_t priority)
+{
+  send_priorities_[prefix] = priority;
+}
+
+void madara::transport::QoSTransportSettings::remove_send_priority(
+    const std::string& prefix)
+{
+  send_priorities_.erase(prefix);
+}
+
+void madara::transport::QoSTransportSettings::clear_send_priorities(void)
+{
+  send_priorities_.clear();
+}
+
+uint32_t madara::transport::QoSTransportSettings::get_send_priority(
+    const std::string& key, const knowledge::KnowledgeRecord& record) const
+{
+  const std::string* longest = nullptr;
+  uint32_t priority = 0;
+
+  for(auto& rule : send_priorities_)
+  {
+    if((!longest || rule.first.size() > longest->size()) &&
+        utility::begins_with(key, rule.first))
+    {
+      longest = &rule.first;
+      priority = rule.second;
+    }
+  }
+
+  if(longest)
+  {
+    return priority;
+  }
+
+  return std::max(record.quality, record.write_quality);
+}
+
+void madara::transport::QoSTransportSettings::set_critical_send_priority(
+    uint32_t priority)
+{
+  critical_send_priority_ = priority;
+}
+
+uint32_t madara::transport::QoSTransportSettings::get_critical_send_priority(
+    void) const
+{
+  return critical_send_priority_;
+}
+
+void madara::transport::QoSTransportSettings::set_max_delayed_sends(
+    uint64_t size)
+{
+  max_delayed_sends_ = size;
+}
+
+uint64_t madara::transport::QoSTransportSettings::get_max_delayed_sends(
+    void) const
+{
+  return max_delayed_sends_;
+}
+
 void madara::transport::QoSTransportSettings::set_deadline(double deadline)
 {
   deadline_ = deadline;
@@ -802,6 +907,7 @@ void madara::transport::QoSTransportSettings::load(
 
   containers::Map trusted_peers(prefix + ".trusted_peers", knowledge);
   containers::Map banned_peers(prefix + ".banned_peers", knowledge);
+  containers::Map send_priorities(prefix + ".send_priorities", knowledge);
 
   rebroadcast_ttl_ =
       (unsigned char)knowledge.get(prefix + ".rebroadcast_ttl").to_integer();
@@ -861,6 +967,33 @@ void madara::transport::QoSTransportSettings::load(
   {
     deadline_ = value.to_double();
   }
+
+  value = knowledge.get(prefix + ".send_bandwidth_burst");
+  if (value.exists())
+  {
+    send_bandwidth_burst_ = (int64_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".critical_send_priority");
+  if (value.exists())
+  {
+    critical_send_priority_ = (uint32_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".max_delayed_sends");
+  if (value.exists())
+  {
+    max_delayed_sends_ = (uint64_t)value.to_integer();
+  }
+
+  std::vector<std::string> priority_keys;
+  send_priorities.keys(priority_keys);
+
+  for(size_t i = 0; i < priority_keys.size(); ++i)
+  {
+    send_priorities_[priority_keys[i]] =
+        (uint32_t)send_priorities[priority_keys[i]].to_integer();
+  }
 }
 
 void madara::transport::QoSTransportSettings::load_text(
@@ -879,6 +1012,7 @@ void madara::transport::QoSTransportSettings::load_text(
 
   containers::Map trusted_peers(prefix + ".trusted_peers", knowledge);
   containers::Map banned_peers(prefix + ".banned_peers", knowledge);
+  containers::Map send_priorities(prefix + ".send_priorities", knowledge);
 
   rebroadcast_ttl_ =
       (unsigned char)knowledge.get(prefix + ".rebroadcast_ttl").to_integer();
@@ -938,6 +1072,33 @@ void madara::transport::QoSTransportSettings::load_text(
   {
     deadline_ = value.to_double();
   }
+
+  value = knowledge.get(prefix + ".send_bandwidth_burst");
+  if (value.exists())
+  {
+    send_bandwidth_burst_ = (int64_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".critical_send_priority");
+  if (value.exists())
+  {
+    critical_send_priority_ = (uint32_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".max_delayed_sends");
+  if (value.exists())
+  {
+    max_delayed_sends_ = (uint64_t)value.to_integer();
+  }
+
+  std::vector<std::string> priority_keys;
+  send_priorities.keys(priority_keys);
+
+  for(size_t i = 0; i < priority_keys.size(); ++i)
+  {
+    send_priorities_[priority_keys[i]] =
+        (uint32_t)send_priorities[priority_keys[i]].to_integer();
+  }
 }
 
 void madara::transport::QoSTransportSettings::save(
@@ -952,6 +1113,7 @@ void madara::transport::QoSTransportSettings::save(
 
   containers::Map trusted_peers(prefix + ".trusted_peers", knowledge);
   containers::Map banned_peers(prefix + ".banned_peers", knowledge);
+  containers::Map send_priorities(prefix + ".send_priorities", knowledge);
 
   knowledge.set(prefix + ".rebroadcast_ttl", Integer(rebroadcast_ttl_));
   knowledge.set(prefix + ".participant_rebroadcast_ttl",
@@ -977,6 +1139,17 @@ void madara::transport::QoSTransportSettings::save(
   knowledge.set(prefix + ".max_total_bandwidth", Integer(max_total_bandwidth_));
   knowledge.set(prefix + ".deadline", deadline_);
 
+  knowledge.set(
+      prefix + ".send_bandwidth_burst", Integer(send_bandwidth_burst_));
+  knowledge.set(
+      prefix + ".critical_send_priority", Integer(critical_send_priority_));
+  knowledge.set(prefix + ".max_delayed_sends", Integer(max_delayed_sends_));
+
+  for(auto& priority : send_priorities_)
+  {
+    send_priorities.set(priority.first, Integer(priority.second));
+  }
+
   knowledge.save_context(filename);
 }
 
@@ -998,6 +1171,7 @@ void madara::transport::QoSTransportSettings::save_text(
 
   containers::Map trusted_peers(prefix + ".trusted_peers", knowledge);
   containers::Map banned_peers(prefix + ".banned_peers", knowledge);
+  containers::Map send_priorities(prefix + ".send_priorities", knowledge);
 
   knowledge.set(prefix + ".rebroadcast_ttl", Integer(rebroadcast_ttl_));
   knowledge.set(prefix + ".participant_rebroadcast_ttl",
@@ -1023,5 +1197,16 @@ void madara::transport::QoSTransportSettings::save_text(
   knowledge.set(prefix + ".max_total_bandwidth", Integer(max_total_bandwidth_));
   knowledge.set(prefix + ".deadline", deadline_);
 
+  knowledge.set(
+      prefix + ".send_bandwidth_burst", Integer(send_bandwidth_burst_));
+  knowledge.set(
+      prefix + ".critical_send_priority", Integer(critical_send_priority_));
+  knowledge.set(prefix + ".max_delayed_sends", Integer(max_delayed_sends_));
+
+  for(auto& priority : send_priorities_)
+  {
+    send_priorities.set(priority.first, Integer(priority.second));
+  }
+
   knowledge.save_as_karl(filename);
 }
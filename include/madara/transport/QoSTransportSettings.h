@@ -49,6 +49,12 @@ enum PacketDropType
 class MADARA_EXPORT QoSTransportSettings : public TransportSettings
 {
 public:
+  /// by default, no priority is exempt from the send bandwidth limit
+  static const uint32_t default_critical_send_priority = 0xFFFFFFFF;
+
+  /// the default maximum number of updates delayed by the send limit
+  static const uint64_t default_max_delayed_sends = 1000;
+
   /**
    * Default constructor
    **/
@@ -619,6 +625,82 @@ public:
    **/
   int64_t get_total_bandwidth_limit(void) const;
 
+  /**
+   * Sets the burst size of the send bandwidth limit. Sends are shaped
+   * by a token bucket that refills at the send bandwidth limit and holds
+   * at most this many bytes. -1 means one second of the send limit.
+   * @param   bytes   the largest burst of bytes sent at once
+   **/
+  void set_send_bandwidth_burst(int64_t bytes);
+
+  /**
+   * Returns the burst size of the send bandwidth limit. -1 means one
+   * second of the send limit.
+   * @return the largest burst of bytes sent at once
+   **/
+  int64_t get_send_bandwidth_burst(void) const;
+
+  /**
+   * Sets the send priority of variables starting with a prefix. When
+   * the send bandwidth limit is exceeded, higher priority updates are
+   * sent first and lower priority updates are delayed. Variables that
+   * match no prefix have the priority of their quality or write quality,
+   * whichever is higher. The longest matching prefix wins.
+   * @param   prefix     the variable prefix, e.g., "agent.0.location"
+   * @param   priority   the send priority of matching variables
+   **/
+  void set_send_priority(const std::string& prefix, uint32_t priority);
+
+  /**
+   * Removes the send priority of a prefix
+   * @param   prefix     the variable prefix
+   **/
+  void remove_send_priority(const std::string& prefix);
+
+  /**
+   * Removes all send priorities of prefixes
+   **/
+  void clear_send_priorities(void);
+
+  /**
+   * Returns the send priority of an update
+   * @param   key       the name of the variable
+   * @param   record    the value of the variable
+   * @return the priority from the longest matching prefix, or the
+   *         quality or write quality of the record, whichever is higher
+   **/
+  uint32_t get_send_priority(
+      const std::string& key, const knowledge::KnowledgeRecord& record) const;
+
+  /**
+   * Sets the priority at which updates are never delayed by the send
+   * bandwidth limit. Such updates are sent even if they exceed the limit.
+   * @param   priority   the lowest priority that is always sent
+   **/
+  void set_critical_send_priority(uint32_t priority);
+
+  /**
+   * Returns the priority at which updates are never delayed by the send
+   * bandwidth limit
+   * @return the lowest priority that is always sent
+   **/
+  uint32_t get_critical_send_priority(void) const;
+
+  /**
+   * Sets the maximum number of updates delayed by the send bandwidth
+   * limit. When more variables are waiting, the lowest priority updates
+   * are dropped.
+   * @param   size   the maximum number of delayed variables
+   **/
+  void set_max_delayed_sends(uint64_t size);
+
+  /**
+   * Returns the maximum number of updates delayed by the send bandwidth
+   * limit
+   * @return the maximum number of delayed variables
+   **/
+  uint64_t get_max_delayed_sends(void) const;
+
   /**
    * Sets the packet deadline in seconds. Note that most transports only
    * enforce deadline in seconds. However, future transports may allow
@@ -743,6 +825,26 @@ private:
    **/
   int64_t max_total_bandwidth_;
 
+  /**
+   * Largest burst of bytes sent before the send bandwidth limit applies
+   **/
+  int64_t send_bandwidth_burst_;
+
+  /**
+   * Send priorities of variable prefixes
+   **/
+  std::map<std::string, uint32_t> send_priorities_;
+
+  /**
+   * Lowest priority that the send bandwidth limit never delays
+   **/
+  uint32_t critical_send_priority_;
+
+  /**
+   * Maximum number of updates delayed by the send bandwidth limit
+   **/
+  uint64_t max_delayed_sends_;
+
   /**
    * Deadline for packets at which packets drop
    **/
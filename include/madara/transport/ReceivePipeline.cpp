@@ -0,0 +1,367 @@
+#include "ReceivePipeline.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace madara
+{
+namespace transport
+{
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+ReceivePipeline::ReceivePipeline(const std::string& id,
+    knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings, BandwidthMonitor& send_monitor,
+    BandwidthMonitor& receive_monitor)
+  : id_(id),
+    context_(context),
+    settings_(settings),
+    send_monitor_(send_monitor),
+    receive_monitor_(receive_monitor)
+{
+}
+
+ReceivePipeline::~ReceivePipeline()
+{
+  stop();
+}
+
+void ReceivePipeline::start(uint32_t decode_threads,
+    RebroadcastHandler rebroadcast)
+{
+  stop();
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  rebroadcast_ = rebroadcast;
+
+#ifndef _MADARA_NO_KARL_
+  if(settings_.on_data_received_logic.length() != 0)
+  {
+    on_data_received_ = context_.compile(settings_.on_data_received_logic);
+  }
+#endif  // _MADARA_NO_KARL_
+
+  running_ = true;
+
+  for(uint32_t i = 0; i < std::max(decode_threads, (uint32_t)1); ++i)
+  {
+    decoders_.emplace_back(&ReceivePipeline::decode_loop, this);
+  }
+
+  applier_ = std::thread(&ReceivePipeline::apply_loop, this);
+}
+
+void ReceivePipeline::stop(void)
+{
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    running_ = false;
+  }
+
+  decode_ready_.MADARA_CONDITION_NOTIFY_ALL();
+  apply_ready_.MADARA_CONDITION_NOTIFY_ALL();
+
+  for(auto& decoder : decoders_)
+  {
+    decoder.join();
+  }
+
+  if(applier_.joinable())
+  {
+    applier_.join();
+  }
+
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  decoders_.clear();
+  decode_queue_.clear();
+  apply_queue_.clear();
+  next_apply_ = next_push_;
+  stats_.decode_queue = 0;
+  stats_.apply_queue = 0;
+}
+
+void ReceivePipeline::set_max_pending(size_t max_pending)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  max_pending_ = max_pending;
+}
+
+void ReceivePipeline::debug_to_kb(const std::string& prefix)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  debug_.enabled = true;
+  debug_.decode_queue = context_.get_ref(prefix + ".pipeline_decode_queue");
+  debug_.apply_queue = context_.get_ref(prefix + ".pipeline_apply_queue");
+  debug_.max_decode_queue =
+      context_.get_ref(prefix + ".pipeline_max_decode_queue");
+  debug_.max_apply_queue =
+      context_.get_ref(prefix + ".pipeline_max_apply_queue");
+  debug_.dropped = context_.get_ref(prefix + ".pipeline_dropped");
+  debug_.batches = context_.get_ref(prefix + ".pipeline_batches");
+  debug_.coalesced = context_.get_ref(prefix + ".pipeline_coalesced");
+}
+
+std::vector<char> ReceivePipeline::acquire(void)
+{
+  std::vector<char> buffer;
+
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    if(pool_.size() > 0)
+    {
+      buffer = std::move(pool_.back());
+      pool_.pop_back();
+    }
+  }
+
+  buffer.resize(settings_.queue_length);
+
+  return buffer;
+}
+
+void ReceivePipeline::recycle(std::vector<char>&& buffer)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  // keep enough buffers for a full pipeline and each read thread
+  if(pool_.size() < max_pending_ + settings_.read_threads)
+  {
+    pool_.push_back(std::move(buffer));
+  }
+}
+
+bool ReceivePipeline::push(std::vector<char>&& buffer, uint32_t size,
+    const std::string& remote_host)
+{
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    ++stats_.received;
+
+    if(running_ &&
+        decode_queue_.size() + stats_.apply_queue < max_pending_)
+    {
+      std::unique_ptr<Message> message(new Message());
+      message->sequence = next_push_++;
+      message->buffer = std::move(buffer);
+      message->size = size;
+      message->remote_host = remote_host;
+
+      decode_queue_.push_back(std::move(message));
+
+      stats_.decode_queue = decode_queue_.size();
+      stats_.max_decode_queue =
+          std::max(stats_.max_decode_queue, stats_.decode_queue);
+    }
+    else
+    {
+      ++stats_.dropped;
+
+      madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+          "ReceivePipeline::push:"
+          " dropping message from %s. Pipeline is full or stopped.\n",
+          remote_host.c_str());
+
+      if(pool_.size() < max_pending_ + settings_.read_threads)
+      {
+        pool_.push_back(std::move(buffer));
+      }
+
+      return false;
+    }
+  }
+
+  decode_ready_.MADARA_CONDITION_NOTIFY_ONE();
+
+  return true;
+}
+
+ReceivePipelineStats ReceivePipeline::get_stats(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return stats_;
+}
+
+void ReceivePipeline::decode_loop(void)
+{
+  static const char print_prefix[] = "ReceivePipeline::decode";
+
+  std::unique_lock<MADARA_LOCK_TYPE> lock(mutex_);
+
+  while(true)
+  {
+    decode_ready_.wait(
+        lock, [this] { return !running_ || decode_queue_.size() > 0; });
+
+    if(!running_)
+    {
+      return;
+    }
+
+    std::unique_ptr<Message> message(std::move(decode_queue_.front()));
+    decode_queue_.pop_front();
+    stats_.decode_queue = decode_queue_.size();
+
+    lock.unlock();
+
+    message->result = decode_received_update(message->buffer.data(),
+        message->size, id_, context_, settings_, send_monitor_,
+        receive_monitor_, print_prefix, message->remote_host.c_str(),
+        message->received);
+
+    lock.lock();
+
+    // decoded records do not refer to the buffer
+    recycle(std::move(message->buffer));
+
+    bool next = message->sequence == next_apply_;
+
+    apply_queue_[message->sequence] = std::move(message);
+    stats_.apply_queue = apply_queue_.size();
+    stats_.max_apply_queue =
+        std::max(stats_.max_apply_queue, stats_.apply_queue);
+
+    if(next)
+    {
+      apply_ready_.MADARA_CONDITION_NOTIFY_ONE();
+    }
+  }
+}
+
+void ReceivePipeline::apply_loop(void)
+{
+  std::vector<std::unique_ptr<Message>> batch;
+
+  std::unique_lock<MADARA_LOCK_TYPE> lock(mutex_);
+
+  while(true)
+  {
+    apply_ready_.wait(lock, [this] {
+      return !running_ || (apply_queue_.size() > 0 &&
+                              apply_queue_.begin()->first == next_apply_);
+    });
+
+    if(!running_)
+    {
+      return;
+    }
+
+    // take every message that is ready in arrival order
+    for(auto i = apply_queue_.begin();
+         i != apply_queue_.end() && i->first == next_apply_;
+         i = apply_queue_.erase(i))
+    {
+      batch.push_back(std::move(i->second));
+      ++next_apply_;
+    }
+
+    stats_.apply_queue = apply_queue_.size();
+
+    lock.unlock();
+
+    size_t coalesced = apply(batch);
+
+    lock.lock();
+
+    stats_.coalesced += coalesced;
+
+    for(auto& message : batch)
+    {
+      if(message->result < 0)
+      {
+        ++stats_.rejected;
+      }
+      else if(message->result > 0)
+      {
+        ++stats_.applied;
+      }
+    }
+
+    ++stats_.batches;
+    stats_.max_batch = std::max(stats_.max_batch, (uint64_t)batch.size());
+    batch.clear();
+
+    if(debug_.enabled)
+    {
+      DebugVariables debug = debug_;
+      ReceivePipelineStats stats = stats_;
+
+      lock.unlock();
+
+      publish(debug, stats);
+
+      lock.lock();
+    }
+  }
+}
+
+size_t ReceivePipeline::apply(std::vector<std::unique_ptr<Message>>& batch)
+{
+  static const char print_prefix[] = "ReceivePipeline::apply";
+
+  std::vector<ReceivedUpdate*> decoded;
+  size_t coalesced = 0;
+
+  for(auto& message : batch)
+  {
+    if(message->result > 0)
+    {
+      decoded.push_back(&message->received);
+    }
+  }
+
+  if(decoded.size() == 0)
+  {
+    return 0;
+  }
+
+  std::vector<knowledge::KnowledgeMap> rebroadcast_records;
+
+  apply_received_batch(context_, settings_, decoded, rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+      on_data_received_,
+#endif  // _MADARA_NO_KARL_
+      print_prefix, &coalesced);
+
+  for(size_t i = 0; i < decoded.size(); ++i)
+  {
+    MessageHeader* header = decoded[i]->header;
+
+    if(rebroadcast_ && header->ttl > 0 && rebroadcast_records[i].size() > 0 &&
+        settings_.get_participant_ttl() > 0)
+    {
+      --header->ttl;
+      header->ttl = std::min(settings_.get_participant_ttl(), header->ttl);
+
+      rebroadcast_(header, rebroadcast_records[i]);
+    }
+  }
+
+  return coalesced;
+}
+
+void ReceivePipeline::publish(
+    const DebugVariables& debug, const ReceivePipelineStats& stats)
+{
+  // statistics are local to this process, even with a global prefix
+  knowledge::KnowledgeUpdateSettings locals(true);
+
+  context_.set(debug.decode_queue, (Integer)stats.decode_queue, locals);
+  context_.set(debug.apply_queue, (Integer)stats.apply_queue, locals);
+  context_.set(
+      debug.max_decode_queue, (Integer)stats.max_decode_queue, locals);
+  context_.set(
+      debug.max_apply_queue, (Integer)stats.max_apply_queue, locals);
+  context_.set(debug.dropped, (Integer)stats.dropped, locals);
+  context_.set(debug.batches, (Integer)stats.batches, locals);
+  context_.set(debug.coalesced, (Integer)stats.coalesced, locals);
+}
+}
+}
@@ -0,0 +1,302 @@
+
+
+#ifndef _MADARA_RECEIVE_PIPELINE_H_
+#define _MADARA_RECEIVE_PIPELINE_H_
+
+/**
+ * @file ReceivePipeline.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the ReceivePipeline class, which decodes received
+ * messages on a pool of threads and applies them on a single thread
+ **/
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "madara/LockType.h"
+#include "madara/MadaraExport.h"
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/knowledge/VariableReference.h"
+#include "madara/transport/Transport.h"
+
+namespace madara
+{
+namespace transport
+{
+/**
+ * Statistics of a receive pipeline
+ **/
+struct ReceivePipelineStats
+{
+  /// messages pushed into the pipeline
+  uint64_t received = 0;
+
+  /// messages dropped because the pipeline was full
+  uint64_t dropped = 0;
+
+  /// messages that were rejected while decoding
+  uint64_t rejected = 0;
+
+  /// messages applied to the context
+  uint64_t applied = 0;
+
+  /// batches of messages applied under one context lock
+  uint64_t batches = 0;
+
+  /// stale values dropped by coalescing (@see coalesce_receives)
+  uint64_t coalesced = 0;
+
+  /// the largest batch applied
+  uint64_t max_batch = 0;
+
+  /// messages waiting to be decoded
+  uint64_t decode_queue = 0;
+
+  /// decoded messages waiting to be applied
+  uint64_t apply_queue = 0;
+
+  /// the most messages that ever waited to be decoded
+  uint64_t max_decode_queue = 0;
+
+  /// the most messages that ever waited to be applied
+  uint64_t max_apply_queue = 0;
+};
+
+/**
+ * @class ReceivePipeline
+ * @brief Separates receiving messages from decoding and applying them.
+ *        Read threads push received buffers, decode threads run the
+ *        buffer filters, record decoding and record receive filters in
+ *        parallel, and a single apply thread commits decoded messages to
+ *        the context in the order they were pushed, so updates from an
+ *        originator are never reordered. Decoded messages that are ready
+ *        together are applied as a batch under one context lock, which
+ *        is also when the aggregate receive filters run.
+ **/
+class MADARA_EXPORT ReceivePipeline
+{
+public:
+  /// the default number of messages that may wait in the pipeline
+  static const size_t default_max_pending = 1000;
+
+  /**
+   * Handler of records to rebroadcast, called on the apply thread
+   **/
+  typedef std::function<void(MessageHeader*, const knowledge::KnowledgeMap&)>
+      RebroadcastHandler;
+
+  /**
+   * Constructor
+   * @param  id               unique identifier of the transport
+   * @param  context          the context to apply updates to
+   * @param  settings         the transport settings, which must outlive
+   *                          the pipeline
+   * @param  send_monitor     monitor of send traffic
+   * @param  receive_monitor  monitor of receive traffic
+   **/
+  ReceivePipeline(const std::string& id,
+      knowledge::ThreadSafeContext& context,
+      const QoSTransportSettings& settings, BandwidthMonitor& send_monitor,
+      BandwidthMonitor& receive_monitor);
+
+  /**
+   * Destructor, which stops the pipeline
+   **/
+  ~ReceivePipeline();
+
+  /**
+   * Starts the decode threads and the apply thread
+   * @param  decode_threads   the number of decode threads
+   * @param  rebroadcast      handler of rebroadcast records, if any
+   **/
+  void start(uint32_t decode_threads, RebroadcastHandler rebroadcast = nullptr);
+
+  /**
+   * Stops all threads. Messages still in the pipeline are discarded.
+   **/
+  void stop(void);
+
+  /**
+   * Sets the number of messages that may wait in the pipeline before
+   * pushed messages are dropped
+   * @param  max_pending   the maximum number of waiting messages
+   **/
+  void set_max_pending(size_t max_pending);
+
+  /**
+   * Publishes the statistics of the pipeline to its context after each
+   * applied batch, as prefix.pipeline_decode_queue,
+   * prefix.pipeline_apply_queue, prefix.pipeline_max_decode_queue,
+   * prefix.pipeline_max_apply_queue, prefix.pipeline_dropped,
+   * prefix.pipeline_batches and prefix.pipeline_coalesced
+   * @param  prefix     the prefix of the statistics variables
+   **/
+  void debug_to_kb(const std::string& prefix);
+
+  /**
+   * Takes a buffer of settings.queue_length bytes from the pool
+   * @return  a buffer to receive a message into
+   **/
+  std::vector<char> acquire(void);
+
+  /**
+   * Returns an unused buffer to the pool
+   * @param  buffer     a buffer from acquire
+   **/
+  void recycle(std::vector<char>&& buffer);
+
+  /**
+   * Queues a received message for decoding
+   * @param  buffer       a buffer from acquire holding the message
+   * @param  size         the number of bytes received
+   * @param  remote_host  ip:port who sent the message
+   * @return  true if queued, false if the pipeline was full or stopped
+   **/
+  bool push(std::vector<char>&& buffer, uint32_t size,
+      const std::string& remote_host);
+
+  /**
+   * Returns the statistics of the pipeline
+   * @return  the message counts and queue depths
+   **/
+  ReceivePipelineStats get_stats(void) const;
+
+protected:
+  /**
+   * A message moving through the pipeline
+   **/
+  struct Message
+  {
+    /// the position of the message in arrival order
+    uint64_t sequence = 0;
+
+    /// the received bytes
+    std::vector<char> buffer;
+
+    /// the number of bytes received
+    uint32_t size = 0;
+
+    /// ip:port who sent the message
+    std::string remote_host;
+
+    /// the result of decoding
+    int result = 0;
+
+    /// the decoded message
+    ReceivedUpdate received;
+  };
+
+  /**
+   * Main loop of a decode thread
+   **/
+  void decode_loop(void);
+
+  /**
+   * Main loop of the apply thread
+   **/
+  void apply_loop(void);
+
+  /**
+   * Applies a batch of decoded messages
+   * @param  batch   the messages, in arrival order
+   * @return the number of stale values coalesced away
+   **/
+  size_t apply(std::vector<std::unique_ptr<Message>>& batch);
+
+  /**
+   * The statistics variables in the context
+   **/
+  struct DebugVariables
+  {
+    /// true if statistics are published to the context
+    bool enabled = false;
+
+    /// statistics variables in the context
+    knowledge::VariableReference decode_queue, apply_queue, max_decode_queue,
+        max_apply_queue, dropped, batches, coalesced;
+  };
+
+  /**
+   * Publishes statistics to the context. The mutex must not be held, since
+   * setting the variables locks the context, and callers holding the
+   * context lock may take the mutex, e.g., in get_stats or push.
+   * @param  debug    the variables to publish to
+   * @param  stats    the statistics to publish
+   **/
+  void publish(const DebugVariables& debug, const ReceivePipelineStats& stats);
+
+  /// unique identifier of the transport
+  const std::string id_;
+
+  /// the context updates are applied to
+  knowledge::ThreadSafeContext& context_;
+
+  /// the transport settings
+  const QoSTransportSettings& settings_;
+
+  /// monitor of send traffic
+  BandwidthMonitor& send_monitor_;
+
+  /// monitor of receive traffic
+  BandwidthMonitor& receive_monitor_;
+
+  /// handler of rebroadcast records
+  RebroadcastHandler rebroadcast_;
+
+#ifndef _MADARA_NO_KARL_
+  /// data received rules, defined in transport settings
+  knowledge::CompiledExpression on_data_received_;
+#endif  // _MADARA_NO_KARL_
+
+  /// guards the queues, pool and statistics
+  mutable MADARA_LOCK_TYPE mutex_;
+
+  /// signaled when a message is pushed or the pipeline stops
+  MADARA_CONDITION_TYPE decode_ready_;
+
+  /// signaled when the next message in order is decoded or on stop
+  MADARA_CONDITION_TYPE apply_ready_;
+
+  /// messages waiting to be decoded
+  std::deque<std::unique_ptr<Message>> decode_queue_;
+
+  /// decoded messages waiting for earlier messages, by sequence
+  std::map<uint64_t, std::unique_ptr<Message>> apply_queue_;
+
+  /// buffers available for receiving
+  std::vector<std::vector<char>> pool_;
+
+  /// the sequence of the next pushed message
+  uint64_t next_push_ = 0;
+
+  /// the sequence of the next message to apply
+  uint64_t next_apply_ = 0;
+
+  /// the maximum number of messages waiting in the pipeline
+  size_t max_pending_ = default_max_pending;
+
+  /// true while the threads should run
+  bool running_ = false;
+
+  /// the decode threads
+  std::vector<std::thread> decoders_;
+
+  /// the apply thread
+  std::thread applier_;
+
+  /// counts and queue depths
+  ReceivePipelineStats stats_;
+
+  /// the statistics variables in the context
+  DebugVariables debug_;
+};
+}
+}
+
+#endif  // _MADARA_RECEIVE_PIPELINE_H_
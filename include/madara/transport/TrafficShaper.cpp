@@ -0,0 +1,248 @@
+#include "TrafficShaper.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace madara
+{
+namespace transport
+{
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+TrafficShaper::TrafficShaper(const QoSTransportSettings* settings)
+  : settings_(settings), tokens_(0), last_refill_(0)
+{
+}
+
+void TrafficShaper::attach(const QoSTransportSettings* settings)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  settings_ = settings;
+}
+
+void TrafficShaper::debug_to_kb(
+    knowledge::ThreadSafeContext& context, const std::string& prefix)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  debug_.context = &context;
+  debug_.sent = context.get_ref(prefix + ".shaper_sent");
+  debug_.delayed = context.get_ref(prefix + ".shaper_delayed");
+  debug_.coalesced = context.get_ref(prefix + ".shaper_coalesced");
+  debug_.dropped = context.get_ref(prefix + ".shaper_dropped");
+  debug_.queued = context.get_ref(prefix + ".shaper_queued");
+  debug_.tokens = context.get_ref(prefix + ".shaper_tokens");
+}
+
+bool TrafficShaper::enabled(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return settings_ && settings_->get_send_bandwidth_limit() > 0;
+}
+
+void TrafficShaper::refill(uint64_t now, int64_t rate, int64_t burst)
+{
+  if(last_refill_ == 0 || now < last_refill_)
+  {
+    tokens_ = burst;
+  }
+  else
+  {
+    tokens_ += (int64_t)((double)(now - last_refill_) * rate / 1000000000);
+
+    if(tokens_ > burst)
+    {
+      tokens_ = burst;
+    }
+  }
+
+  last_refill_ = now;
+}
+
+size_t TrafficShaper::shape(knowledge::KnowledgeMap& updates, uint64_t now,
+    const std::function<bool(const std::string&)>& accept)
+{
+  size_t result;
+  DebugVariables debug;
+  TrafficShaperStats stats;
+
+  {
+    MADARA_GUARD_TYPE guard(mutex_);
+
+    result = delay(updates, now, accept);
+    debug = debug_;
+    stats = stats_;
+  }
+
+  publish(debug, stats);
+
+  return result;
+}
+
+size_t TrafficShaper::delay(knowledge::KnowledgeMap& updates, uint64_t now,
+    const std::function<bool(const std::string&)>& accept)
+{
+  resent_.clear();
+
+  // the newest value of a delayed variable replaces the delayed one
+  for(auto update = delayed_.begin(); update != delayed_.end();)
+  {
+    if(accept && !accept(update->first))
+    {
+      ++update;
+      continue;
+    }
+
+    resent_.insert(update->first);
+
+    if(!updates.emplace(update->first, std::move(update->second)).second)
+    {
+      ++stats_.coalesced;
+    }
+
+    update = delayed_.erase(update);
+  }
+
+  int64_t rate = settings_ ? settings_->get_send_bandwidth_limit() : -1;
+
+  // without a limit, everything that was waiting goes out now
+  if(rate <= 0)
+  {
+    last_refill_ = 0;
+    stats_.sent += updates.size();
+    stats_.queued = delayed_.size();
+
+    return 0;
+  }
+
+  int64_t burst = settings_->get_send_bandwidth_burst();
+
+  if(burst <= 0)
+  {
+    burst = rate;
+  }
+
+  refill(now, rate, burst);
+
+  struct Candidate
+  {
+    uint32_t priority;
+    int64_t size;
+    knowledge::KnowledgeMap::iterator update;
+  };
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(updates.size());
+
+  for(auto i = updates.begin(); i != updates.end(); ++i)
+  {
+    candidates.push_back(Candidate{
+        settings_->get_send_priority(i->first, i->second),
+        i->second.get_encoded_size(i->first), i});
+  }
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.priority > rhs.priority;
+      });
+
+  uint32_t critical = settings_->get_critical_send_priority();
+  bool blocked = false;
+  std::vector<const std::string*> order;
+
+  for(auto& candidate : candidates)
+  {
+    // a full bucket lets an update larger than the burst through, and
+    // once an update waits, lower priorities wait behind it
+    if(candidate.priority >= critical ||
+        (!blocked && (candidate.size <= tokens_ || tokens_ >= burst)))
+    {
+      tokens_ -= candidate.size;
+      ++stats_.sent;
+    }
+    else
+    {
+      blocked = true;
+
+      auto inserted = delayed_.emplace(
+          candidate.update->first, std::move(candidate.update->second));
+      order.push_back(&inserted.first->first);
+
+      updates.erase(candidate.update);
+      ++stats_.delayed;
+    }
+  }
+
+  size_t result = order.size();
+
+  // drop the lowest priority updates beyond the queue bound
+  uint64_t max_delayed = settings_->get_max_delayed_sends();
+
+  while(delayed_.size() > max_delayed && order.size() > 0)
+  {
+    delayed_.erase(*order.back());
+    order.pop_back();
+    ++stats_.dropped;
+  }
+
+  stats_.queued = delayed_.size();
+  stats_.tokens = tokens_;
+
+  return result;
+}
+
+bool TrafficShaper::has_delayed(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return delayed_.size() > 0;
+}
+
+bool TrafficShaper::was_delayed(const std::string& key) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  return resent_.find(key) != resent_.end();
+}
+
+TrafficShaperStats TrafficShaper::get_stats(void) const
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  TrafficShaperStats result(stats_);
+  result.queued = delayed_.size();
+  result.tokens = tokens_;
+
+  return result;
+}
+
+void TrafficShaper::clear(void)
+{
+  MADARA_GUARD_TYPE guard(mutex_);
+
+  delayed_.clear();
+  resent_.clear();
+  last_refill_ = 0;
+  stats_ = TrafficShaperStats();
+}
+
+void TrafficShaper::publish(
+    const DebugVariables& debug, const TrafficShaperStats& stats)
+{
+  if(debug.context)
+  {
+    // statistics are local to this process, even with a global prefix
+    knowledge::KnowledgeUpdateSettings locals(true);
+
+    debug.context->set(debug.sent, (Integer)stats.sent, locals);
+    debug.context->set(debug.delayed, (Integer)stats.delayed, locals);
+    debug.context->set(debug.coalesced, (Integer)stats.coalesced, locals);
+    debug.context->set(debug.dropped, (Integer)stats.dropped, locals);
+    debug.context->set(debug.queued, (Integer)stats.queued, locals);
+    debug.context->set(debug.tokens, (Integer)stats.tokens, locals);
+  }
+}
+}
+}
@@ -0,0 +1,217 @@
+
+
+#ifndef _MADARA_TRAFFIC_SHAPER_H_
+#define _MADARA_TRAFFIC_SHAPER_H_
+
+/**
+ * @file TrafficShaper.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains the TrafficShaper class, which enforces the send
+ * bandwidth limit of a transport by delaying low priority updates
+ **/
+
+#include <functional>
+#include <set>
+#include <string>
+
+#include "madara/LockType.h"
+#include "madara/utility/StdInt.h"
+#include "madara/MadaraExport.h"
+#include "madara/knowledge/KnowledgeRecord.h"
+#include "madara/knowledge/ThreadSafeContext.h"
+#include "madara/knowledge/VariableReference.h"
+#include "madara/transport/QoSTransportSettings.h"
+
+namespace madara
+{
+namespace transport
+{
+/**
+ * Statistics of a traffic shaper
+ **/
+struct TrafficShaperStats
+{
+  /// updates that were sent
+  uint64_t sent = 0;
+
+  /// times an update was delayed to a later send
+  uint64_t delayed = 0;
+
+  /// delayed updates that were replaced by a newer value
+  uint64_t coalesced = 0;
+
+  /// delayed updates dropped because too many updates were waiting
+  uint64_t dropped = 0;
+
+  /// updates currently waiting to be sent
+  uint64_t queued = 0;
+
+  /// bytes that may currently be sent (negative after critical sends)
+  int64_t tokens = 0;
+};
+
+/**
+ * @class TrafficShaper
+ * @brief Shapes sends to the send bandwidth limit with a token bucket.
+ *        The bucket refills at the send bandwidth limit and holds up to
+ *        the send bandwidth burst. Updates are sent in order of priority
+ *        while their encoded size fits in the bucket, and the rest are
+ *        delayed and merged into the next send, where a newer value of
+ *        the same variable replaces the delayed one. Updates at the
+ *        critical send priority are always sent.
+ **/
+class MADARA_EXPORT TrafficShaper
+{
+public:
+  /**
+   * Default constructor
+   * @param  settings   the settings with the limit and priorities
+   **/
+  TrafficShaper(const QoSTransportSettings* settings = 0);
+
+  /**
+   * Attaches settings
+   * @param   settings   Settings to attach to this shaper
+   **/
+  void attach(const QoSTransportSettings* settings);
+
+  /**
+   * Publishes the statistics of the shaper to a context after each
+   * shaped send, as prefix.shaper_sent, prefix.shaper_delayed,
+   * prefix.shaper_coalesced, prefix.shaper_dropped, prefix.shaper_queued
+   * and prefix.shaper_tokens
+   * @param   context    the context to publish to
+   * @param   prefix     the prefix of the statistics variables
+   **/
+  void debug_to_kb(
+      knowledge::ThreadSafeContext& context, const std::string& prefix);
+
+  /**
+   * Checks if the attached settings limit send bandwidth
+   * @return  true if sends are shaped
+   **/
+  bool enabled(void) const;
+
+  /**
+   * Shapes a send. Delayed updates are merged into the updates, and
+   * updates that do not fit the send bandwidth limit are removed from
+   * them and delayed.
+   * @param   updates   the filtered updates to send
+   * @param   now       the current time in nanoseconds
+   * @param   accept    if set, only delayed updates of variables it
+   *                    accepts are merged into this send
+   * @return  the number of updates delayed by this send
+   **/
+  size_t shape(knowledge::KnowledgeMap& updates, uint64_t now,
+      const std::function<bool(const std::string&)>& accept = nullptr);
+
+  /**
+   * Checks if updates are waiting to be sent
+   * @return  true if a send is needed even without new updates
+   **/
+  bool has_delayed(void) const;
+
+  /**
+   * Checks if the last shaped send merged a delayed update of a variable.
+   * Such updates must be sent in full because the changes recorded for
+   * the variable may not cover everything since it was last sent.
+   * @param   key    the name of the variable
+   * @return  true if the variable was delayed before the last send
+   **/
+  bool was_delayed(const std::string& key) const;
+
+  /**
+   * Returns the statistics of the shaper
+   * @return  the counts of sent, delayed and dropped updates
+   **/
+  TrafficShaperStats get_stats(void) const;
+
+  /**
+   * Drops delayed updates and refills the bucket
+   **/
+  void clear(void);
+
+protected:
+  /**
+   * Adds tokens for the time since the last refill. The mutex must be held.
+   * @param   now     the current time in nanoseconds
+   * @param   rate    the send bandwidth limit in bytes per second
+   * @param   burst   the size of the bucket in bytes
+   **/
+  void refill(uint64_t now, int64_t rate, int64_t burst);
+
+  /**
+   * The context and variables that statistics are published to
+   **/
+  struct DebugVariables
+  {
+    /// context that statistics are published to, if any
+    knowledge::ThreadSafeContext* context = 0;
+
+    /// statistics variables in the context
+    knowledge::VariableReference sent, delayed, coalesced, dropped, queued,
+        tokens;
+  };
+
+  /**
+   * Delays the updates that do not fit the bandwidth limit. The mutex must
+   * be held. @see shape
+   **/
+  size_t delay(knowledge::KnowledgeMap& updates, uint64_t now,
+      const std::function<bool(const std::string&)>& accept);
+
+  /**
+   * Publishes statistics to a debug context. The mutex must not be held,
+   * since setting the variables locks the context, and transports may
+   * shape sends while holding the context lock.
+   * @param   debug    the context and variables to publish to
+   * @param   stats    the statistics to publish
+   **/
+  static void publish(
+      const DebugVariables& debug, const TrafficShaperStats& stats);
+
+  /**
+   * Mutex for supporting multithreaded shaper calls
+   **/
+  mutable MADARA_LOCK_TYPE mutex_;
+
+  /**
+   * Transport settings
+   **/
+  const QoSTransportSettings* settings_;
+
+  /**
+   * Bytes that may currently be sent
+   **/
+  int64_t tokens_;
+
+  /**
+   * Time of the last refill in nanoseconds, or 0 if the bucket is unused
+   **/
+  uint64_t last_refill_;
+
+  /**
+   * Updates waiting for the next send, latest value per variable
+   **/
+  knowledge::KnowledgeMap delayed_;
+
+  /**
+   * Variables whose delayed updates were merged into the last send
+   **/
+  std::set<std::string> resent_;
+
+  /**
+   * Counts of shaped updates
+   **/
+  TrafficShaperStats stats_;
+
+  /**
+   * Context and variables that statistics are published to
+   **/
+  DebugVariables debug_;
+};
+}
+}
+
+#endif  // _MADARA_TRAFFIC_SHAPER_H_
@@ -5,6 +5,8 @@
 #include "madara/knowledge/ContextGuard.h"
 
 #include <algorithm>
+#include <mutex>
+#include <set>
 
 namespace madara
 {
@@ -25,6 +27,12 @@ Base::Base(const std::string& id, TransportSettings& new_settings,
 {
   settings_.attach(&context_);
   packet_scheduler_.attach(&settings_);
+  traffic_shaper_.attach(&settings_);
+
+  if(settings_.debug_to_kb_prefix != "")
+  {
+    traffic_shaper_.debug_to_kb(context_, settings_.debug_to_kb_prefix);
+  }
 }
 
 Base::~Base() {}
@@ -106,18 +114,32 @@ void Base::close(void)
   invalidate_transport();
 }
 
-int process_received_update(const char* buffer, uint32_t bytes_read,
+/**
+ * Replaces a compact header with a standard header of the same fields,
+ * which is what rebroadcasts of the decoded updates use
+ * @return the epoch of the ids in the compact header
+ **/
+static uint64_t to_standard_header(MessageHeader*& header)
+{
+  CompactMessageHeader* compact = (CompactMessageHeader*)header;
+  uint64_t epoch = compact->epoch;
+
+  header = compact->to_message_header();
+  delete compact;
+
+  return epoch;
+}
+
+int decode_received_update(const char* buffer, uint32_t bytes_read,
     const std::string& id, knowledge::ThreadSafeContext& context,
     const QoSTransportSettings& settings, BandwidthMonitor& send_monitor,
-    BandwidthMonitor& receive_monitor,
-    knowledge::KnowledgeMap& rebroadcast_records,
-#ifndef _MADARA_NO_KARL_
-    knowledge::CompiledExpression& on_data_received,
-#endif  // _MADARA_NO_KARL_
-
-    const char* print_prefix, const char* remote_host, MessageHeader*& header)
+    BandwidthMonitor& receive_monitor, const char* print_prefix,
+    const char* remote_host, ReceivedUpdate& received)
 {
+  MessageHeader*& header = received.header;
+
   // reset header to 0, so it is safe to delete
+  delete header;
   header = 0;
 
   int max_buffer_size = (int)bytes_read;
@@ -132,6 +154,8 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
 
   bool is_reduced = false;
   bool is_fragment = false;
+  bool is_compact = false;
+  uint64_t compact_epoch = 0;
 
   madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
       "%s:"
@@ -150,14 +174,14 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
   // setup buffer remaining, used by the knowledge record read method
   int64_t buffer_remaining = (int64_t)bytes_read;
 
-  // clear the rebroadcast records
-  rebroadcast_records.clear();
-
   // receive records will be what we pass to the aggregate filter
-  knowledge::KnowledgeMap updates;
+  knowledge::KnowledgeMap& updates = received.updates;
+  updates.clear();
 
   // if a key appears multiple times, keep to add to buffer history
-  std::map<std::string, std::vector<knowledge::KnowledgeRecord>> past_updates;
+  std::map<std::string, std::vector<knowledge::KnowledgeRecord>>&
+      past_updates = received.past_updates;
+  past_updates.clear();
 
   // check the buffer for a reduced message header
   if(bytes_read >= ReducedMessageHeader::static_encoded_size() &&
@@ -171,6 +195,17 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
     header = new ReducedMessageHeader();
     is_reduced = true;
   }
+  else if(bytes_read >= CompactMessageHeader::static_encoded_size() &&
+           CompactMessageHeader::compact_message_header_test(buffer))
+  {
+    madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+        "%s:"
+        " processing compact KaRL message from %s\n",
+        print_prefix, remote_host);
+
+    header = new CompactMessageHeader();
+    is_compact = true;
+  }
   else if(bytes_read >= MessageHeader::static_encoded_size() &&
            MessageHeader::message_header_test(buffer))
   {
@@ -222,6 +257,21 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
       " header info: %s\n",
       print_prefix, header->to_string().c_str());
 
+  if(buffer_remaining < 0)
+  {
+    madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+        "%s:"
+        " Message header is truncated. Dropping message.\n",
+        print_prefix);
+
+    return -1;
+  }
+
+  if(is_compact)
+  {
+    compact_epoch = to_standard_header(header);
+  }
+
   if(header->size < bytes_read)
   {
     madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
@@ -233,6 +283,15 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
     return -1;
   }
 
+  // decode threads and read threads may share the fragment map
+  std::unique_lock<MADARA_LOCK_TYPE> fragment_guard(
+      settings.fragment_mutex, std::defer_lock);
+
+  if(is_fragment)
+  {
+    fragment_guard.lock();
+  }
+
   if(is_fragment && exists(header->originator, header->clock,
                          ((FragmentMessageHeader*)header)->update_number,
                          settings.fragment_map))
@@ -354,6 +413,8 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
     // cleanup the old buffer. We should really have a zero-copy 
     delete[] message;
 
+    fragment_guard.unlock();
+
     int decode_result = (uint32_t)settings.filter_decode(
         (char*)buffer, total_size, settings.queue_length);
 
@@ -396,6 +457,29 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
           is_reduced = true;
           update = header->read(buffer, buffer_remaining);
         }
+        else if(CompactMessageHeader::compact_message_header_test(buffer))
+        {
+          madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+              "%s:"
+              " processing compact KaRL message from %s\n",
+              print_prefix, remote_host);
+
+          header = new CompactMessageHeader();
+          is_compact = true;
+          update = header->read(buffer, buffer_remaining);
+
+          if(buffer_remaining < 0)
+          {
+            madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+                "%s:"
+                " ERROR: defrag resulted in a truncated header.\n",
+                print_prefix);
+
+            return 0;
+          }
+
+          compact_epoch = to_standard_header(header);
+        }
         else if(MessageHeader::message_header_test(buffer))
         {
           madara_logger_log(context.get_logger(), logger::LOG_MINOR,
@@ -425,7 +509,11 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
   } // end if is fragment
 
 
-  int actual_updates = 0;
+  if(fragment_guard.owns_lock())
+  {
+    fragment_guard.unlock();
+  }
+
   uint64_t current_time = utility::get_time();
   double deadline = settings.get_deadline();
 
@@ -436,7 +524,8 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
       print_prefix, header->originator, header->domain, remote_host,
       header->timestamp);
 
-  TransportContext transport_context(TransportContext::RECEIVING_OPERATION,
+  TransportContext& transport_context = received.transport_context;
+  transport_context = TransportContext(TransportContext::RECEIVING_OPERATION,
       receive_monitor.get_bytes_per_second(),
       send_monitor.get_bytes_per_second(), header->timestamp, current_time,
       header->domain, header->originator, remote_host);
@@ -486,7 +575,8 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
   record.clock = header->clock;
   std::string key;
 
-  bool dropped = false;
+  bool& dropped = received.dropped;
+  dropped = false;
 
   if(send_monitor.is_bandwidth_violated(settings.get_send_bandwidth_limit()))
   {
@@ -539,11 +629,24 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
     }
   };
 
+  knowledge::ArrayDelta delta;
+
   // iterate over the updates
   for(uint32_t i = 0; i < header->updates; ++i)
   {
-    // read converts everything into host format from the update stream
-    update = record.read(update, key, buffer_remaining);
+    // read converts everything into host format from the update stream.
+    // Array deltas are kept apart, since the arrays they patch may change
+    // before this message is applied.
+    if(is_compact)
+    {
+      update = settings.compact_decoder.read(update, buffer_remaining,
+          header->originator, compact_epoch, header->timestamp, key, record,
+          delta);
+    }
+    else
+    {
+      update = record.read(update, key, buffer_remaining, delta);
+    }
 
     if(buffer_remaining < 0)
     {
@@ -556,6 +659,23 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
       // we do not delete the header as this will be cleaned up later
       break;
     }
+    else if(is_compact && key.empty())
+    {
+      madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+          "%s:"
+          " skipping update with an id that %s has not announced yet\n",
+          print_prefix, header->originator);
+    }
+    else if(delta.exists())
+    {
+      madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+          "%s:"
+          " keeping delta of %s (%" PRIu32 " elements, base clock %" PRIu64
+          ") until the message is applied\n",
+          print_prefix, key.c_str(), delta.size, delta.base_clock);
+
+      received.deltas.emplace_back(key, std::move(delta));
+    }
     else
     {
       madara_logger_log(context.get_logger(), logger::LOG_MINOR,
@@ -609,16 +729,102 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
     utility::strncpy_safe(header->originator, id.c_str(), sizeof(header->originator));
   }
 
+  return 1;
+}
+
+void resolve_received_deltas(knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings, ReceivedUpdate& received,
+    const char* print_prefix)
+{
+  const knowledge::ThreadSafeContext& lookup = context;
+  const knowledge::KnowledgeReferenceSettings raw(false);
+  const knowledge::KnowledgeRecord empty;
+
+  for(auto& entry : received.deltas)
+  {
+    const std::string& key = entry.first;
+    const knowledge::ArrayDelta& delta = entry.second;
+
+    // the base is the newest value, i.e., from this message or else from
+    // the context, which is current since earlier messages were applied
+    const knowledge::KnowledgeRecord* base = &empty;
+    auto pending = received.updates.find(key);
+
+    if(pending != received.updates.end())
+    {
+      base = &pending->second;
+    }
+    else
+    {
+      knowledge::VariableReference ref = lookup.get_ref(key, raw);
+
+      if(ref.is_valid())
+      {
+        base = ref.get_record_unsafe();
+      }
+    }
+
+    knowledge::KnowledgeRecord record;
+    record.quality = received.header->quality;
+    record.clock = received.header->clock;
+
+    if(!delta.apply(*base, record))
+    {
+      madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+          "%s:"
+          " unable to apply delta to %s (type %" PRIu32 ", %" PRIu32
+          " elements, clock %" PRIu64 "). Base has type %" PRIu32
+          ", %" PRIu32 " elements and clock %" PRIu64 ".\n",
+          print_prefix, key.c_str(), delta.type, delta.size,
+          delta.base_clock, base->type(), base->size(), base->clock);
+
+      continue;
+    }
+
+    record = settings.filter_receive(record, key, received.transport_context);
+
+    if(!record.exists())
+    {
+      madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+          "%s:"
+          " Filter resulted in dropping %s\n",
+          print_prefix, key.c_str());
+
+      continue;
+    }
+
+    if(pending != received.updates.end())
+    {
+      using std::swap;
+
+      swap(record, pending->second);
+
+      received.past_updates[key].emplace_back(std::move(record));
+    }
+    else
+    {
+      received.updates.emplace(key, std::move(record));
+    }
+  }
+
+  received.deltas.clear();
+}
+
+void filter_received_update(knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings, ReceivedUpdate& received,
+    const char* print_prefix)
+{
   // apply aggregate receive filters
   if(settings.get_number_of_receive_aggregate_filters() > 0 &&
-      (updates.size() > 0 || header->type == transport::REGISTER))
+      (received.updates.size() > 0 ||
+          received.header->type == transport::REGISTER))
   {
     madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
         "%s:"
         " Applying aggregate receive filters.\n",
         print_prefix);
 
-    settings.filter_receive(updates, transport_context);
+    settings.filter_receive(received.updates, received.transport_context);
   }
   else
   {
@@ -627,68 +833,78 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
         " No aggregate receive filters were applied...\n",
         print_prefix);
   }
+}
+
+int apply_received_update(knowledge::ThreadSafeContext& context,
+    ReceivedUpdate& received, const char* print_prefix)
+{
+  const MessageHeader* header = received.header;
+  int actual_updates = 0;
 
   madara_logger_log(context.get_logger(), logger::LOG_MINOR,
       "%s:"
-      " Locking the context to apply updates.\n",
+      " Applying updates to context.\n",
       print_prefix);
 
+  uint64_t now = utility::get_time();
+  // apply updates from the update list
+  for(knowledge::KnowledgeMap::iterator i = received.updates.begin();
+       i != received.updates.end(); ++i)
   {
-    knowledge::ContextGuard guard(context);
+    const auto apply = [&](knowledge::KnowledgeRecord& record) {
+      int result = 0;
 
-    madara_logger_log(context.get_logger(), logger::LOG_MINOR,
-        "%s:"
-        " Applying updates to context.\n",
-        print_prefix);
+      record.set_toi(now);
+      result = record.apply(
+          context, i->first, header->quality, header->clock, false);
+      ++actual_updates;
 
-    uint64_t now = utility::get_time();
-    // apply updates from the update list
-    for(knowledge::KnowledgeMap::iterator i = updates.begin();
-         i != updates.end(); ++i)
-    {
-      const auto apply = [&](knowledge::KnowledgeRecord& record) {
-        int result = 0;
-
-        record.set_toi(now);
-        result = record.apply(
-            context, i->first, header->quality, header->clock, false);
-        ++actual_updates;
-
-        if(result != 1)
-        {
-          madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
-              "%s:"
-              " update %s=%s was rejected\n",
-              print_prefix, key.c_str(), record.to_string().c_str());
-        }
-        else
-        {
-          madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
-              "%s:"
-              " update %s=%s was accepted\n",
-              print_prefix, key.c_str(), record.to_string().c_str());
-        }
-      };
+      if(result != 1)
+      {
+        madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+            "%s:"
+            " update %s=%s was rejected\n",
+            print_prefix, i->first.c_str(), record.to_string().c_str());
+      }
+      else
+      {
+        madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+            "%s:"
+            " update %s=%s was accepted\n",
+            print_prefix, i->first.c_str(), record.to_string().c_str());
+      }
+    };
 
-      auto iter = past_updates.find(i->first);
-      if(iter != past_updates.end())
+    auto iter = received.past_updates.find(i->first);
+    if(iter != received.past_updates.end())
+    {
+      for(auto& cur : iter->second)
       {
-        for(auto& cur : iter->second)
+        if(cur.exists())
         {
-          if(cur.exists())
-          {
-            apply(cur);
-          }
+          apply(cur);
         }
       }
-
-      apply(i->second);
     }
+
+    apply(i->second);
   }
 
-  context.set_changed();
+  return actual_updates;
+}
 
-  if(!dropped)
+void finish_received_update(knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings, ReceivedUpdate& received,
+    knowledge::KnowledgeMap& rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression& on_data_received,
+#endif  // _MADARA_NO_KARL_
+    const char* print_prefix, bool evaluate_rules)
+{
+  knowledge::KnowledgeMap& updates = received.updates;
+  TransportContext& transport_context = received.transport_context;
+
+  if(!received.dropped)
   {
     transport_context.set_operation(TransportContext::REBROADCASTING_OPERATION);
 
@@ -766,7 +982,11 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
   }
 
   // before we send to others, we first execute rules
-  if(settings.on_data_received_logic.length() != 0)
+  if(!evaluate_rules)
+  {
+    return;
+  }
+  else if(settings.on_data_received_logic.length() != 0)
   {
 #ifndef _MADARA_NO_KARL_
     madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
@@ -784,10 +1004,226 @@ int process_received_update(const char* buffer, uint32_t bytes_read,
         " no permanent rules were set\n",
         print_prefix);
   }
+}
+
+size_t coalesce_received_updates(knowledge::ThreadSafeContext& context,
+    const std::vector<ReceivedUpdate*>& batch)
+{
+  const knowledge::ThreadSafeContext& lookup = context;
+  const knowledge::KnowledgeReferenceSettings raw(false);
+
+  // the message holding the newest value of each variable
+  std::map<std::string, ReceivedUpdate*> newest;
+
+  // variables whose every value is kept for their history
+  std::set<std::string> histories;
+
+  // deltas patch the value before them, which must not be dropped
+  for(ReceivedUpdate* received : batch)
+  {
+    for(auto& delta : received->deltas)
+    {
+      histories.insert(delta.first);
+    }
+  }
+
+  size_t coalesced = 0;
+
+  // drops the values of a variable in a message, including the values
+  // that appeared earlier in the same message
+  const auto drop = [&coalesced](ReceivedUpdate& received,
+                        knowledge::KnowledgeMap::iterator update) {
+    auto past = received.past_updates.find(update->first);
+
+    if(past != received.past_updates.end())
+    {
+      coalesced += past->second.size();
+      received.past_updates.erase(past);
+    }
+
+    ++coalesced;
+    return received.updates.erase(update);
+  };
+
+  for(ReceivedUpdate* received : batch)
+  {
+    for(auto update = received->updates.begin();
+         update != received->updates.end();)
+    {
+      if(histories.count(update->first) > 0)
+      {
+        ++update;
+        continue;
+      }
+
+      auto found = newest.find(update->first);
+
+      if(found == newest.end())
+      {
+        knowledge::VariableReference ref = lookup.get_ref(update->first, raw);
+
+        if(ref.is_valid() && ref.get_record_unsafe()->has_history())
+        {
+          histories.insert(update->first);
+        }
+        else
+        {
+          newest[update->first] = received;
+        }
+
+        ++update;
+        continue;
+      }
+
+      auto previous = found->second->updates.find(update->first);
+      const knowledge::KnowledgeRecord& current = update->second;
+      const knowledge::KnowledgeRecord& older = previous->second;
+
+      // quality wins first and then the clock, as in
+      // update_record_from_external, and later arrivals win ties, as they
+      // would if applied in turn
+      if(current.quality > older.quality ||
+          (current.quality == older.quality && current.clock >= older.clock))
+      {
+        drop(*found->second, previous);
+        found->second = received;
+        ++update;
+      }
+      else
+      {
+        update = drop(*received, update);
+      }
+    }
+  }
+
+  return coalesced;
+}
+
+int apply_received_batch(knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings,
+    const std::vector<ReceivedUpdate*>& batch,
+    std::vector<knowledge::KnowledgeMap>& rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression& on_data_received,
+#endif  // _MADARA_NO_KARL_
+    const char* print_prefix, size_t* coalesced)
+{
+  int actual_updates = 0;
+  bool coalesce = settings.coalesce_receives;
+
+  rebroadcast_records.clear();
+  rebroadcast_records.resize(batch.size());
+
+  if(batch.size() == 0)
+  {
+    return 0;
+  }
+
+  {
+    knowledge::ContextGuard guard(context);
+
+    if(coalesce)
+    {
+      size_t dropped = coalesce_received_updates(context, batch);
+
+      madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+          "%s:"
+          " coalesced %d stale values in a batch of %d messages\n",
+          print_prefix, (int)dropped, (int)batch.size());
+
+      if(coalesced)
+      {
+        *coalesced += dropped;
+      }
+    }
+
+    for(ReceivedUpdate* received : batch)
+    {
+      resolve_received_deltas(context, settings, *received, print_prefix);
+      filter_received_update(context, settings, *received, print_prefix);
+      actual_updates += apply_received_update(context, *received, print_prefix);
+    }
+  }
+
+  context.set_changed();
+
+  for(size_t i = 0; i < batch.size(); ++i)
+  {
+    finish_received_update(context, settings, *batch[i],
+        rebroadcast_records[i],
+#ifndef _MADARA_NO_KARL_
+        on_data_received,
+#endif  // _MADARA_NO_KARL_
+        print_prefix, !coalesce);
+  }
+
+#ifndef _MADARA_NO_KARL_
+  // coalesced batches trigger the rules once
+  if(coalesce && settings.on_data_received_logic.length() != 0)
+  {
+    madara_logger_log(context.get_logger(), logger::LOG_MAJOR,
+        "%s:"
+        " evaluating rules in %s once for the batch\n",
+        print_prefix, settings.on_data_received_logic.c_str());
+
+    context.evaluate(on_data_received);
+  }
+#endif  // _MADARA_NO_KARL_
 
   return actual_updates;
 }
 
+int process_received_update(const char* buffer, uint32_t bytes_read,
+    const std::string& id, knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings, BandwidthMonitor& send_monitor,
+    BandwidthMonitor& receive_monitor,
+    knowledge::KnowledgeMap& rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression& on_data_received,
+#endif  // _MADARA_NO_KARL_
+
+    const char* print_prefix, const char* remote_host, MessageHeader*& header)
+{
+  ReceivedUpdate received;
+
+  // clear the rebroadcast records
+  rebroadcast_records.clear();
+
+  int result = decode_received_update(buffer, bytes_read, id, context,
+      settings, send_monitor, receive_monitor, print_prefix, remote_host,
+      received);
+
+  if(result > 0)
+  {
+    madara_logger_log(context.get_logger(), logger::LOG_MINOR,
+        "%s:"
+        " Locking the context to apply updates.\n",
+        print_prefix);
+
+    {
+      knowledge::ContextGuard guard(context);
+
+      resolve_received_deltas(context, settings, received, print_prefix);
+      filter_received_update(context, settings, received, print_prefix);
+      result = apply_received_update(context, received, print_prefix);
+    }
+
+    context.set_changed();
+
+    finish_received_update(context, settings, received, rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+        on_data_received,
+#endif  // _MADARA_NO_KARL_
+        print_prefix);
+  }
+
+  // the caller cleans up the header
+  header = received.header;
+  received.header = 0;
+
+  return result;
+}
+
 int prep_rebroadcast(knowledge::ThreadSafeContext& context, char* buffer,
     int64_t& buffer_remaining, const QoSTransportSettings& settings,
     const char* print_prefix, MessageHeader* header,
@@ -881,6 +1317,7 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
   uint32_t quality = knowledge::max_quality(orig_updates);
   uint64_t latest_toi = 0;
   bool reduced = false;
+  bool compact = false;
 
   knowledge::KnowledgeMap filtered_updates;
 
@@ -896,17 +1333,9 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
 
   bool dropped = false;
 
-  if(send_monitor_.is_bandwidth_violated(settings_.get_send_bandwidth_limit()))
-  {
-    dropped = true;
-    madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
-        "%s:"
-        " Send monitor has detected violation of bandwidth limit."
-        " Dropping packet...\n",
-        print_prefix);
-  }
-  else if(receive_monitor_.is_bandwidth_violated(
-               settings_.get_total_bandwidth_limit()))
+  // the send bandwidth limit is enforced by the traffic shaper below
+  if(receive_monitor_.is_bandwidth_violated(
+          settings_.get_total_bandwidth_limit()))
   {
     dropped = true;
     madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
@@ -1056,6 +1485,20 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
       " Finished applying filters before sending...\n",
       print_prefix);
 
+  bool shaped = false;
+
+  if(traffic_shaper_.enabled() || traffic_shaper_.has_delayed())
+  {
+    size_t delayed = traffic_shaper_.shape(
+        filtered_updates, (uint64_t)utility::get_time(), delayed_filter_);
+    shaped = true;
+
+    madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
+        "%s:"
+        " Send bandwidth limit delayed %zu updates, sending %zu...\n",
+        print_prefix, delayed, filtered_updates.size());
+  }
+
   if(filtered_updates.size() == 0)
   {
     madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
@@ -1093,6 +1536,23 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
     header = new ReducedMessageHeader();
     reduced = true;
   }
+  else if(settings_.send_compact_encoding)
+  {
+    madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
+        "%s:"
+        " Preparing message with compact encoding.\n",
+        print_prefix);
+
+    CompactMessageHeader* compact_header = new CompactMessageHeader();
+
+    compact_header->epoch = compact_encoder_.get_epoch();
+    compact_encoder_.start(compact_header->timestamp,
+        (uint64_t)(settings_.compact_dictionary_refresh * 1000000000),
+        settings_.compact_dictionary_size);
+
+    header = compact_header;
+    compact = true;
+  }
   else
   {
     madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
@@ -1138,7 +1598,10 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
   // set the update to the end of the header
   char* update = header->write(buffer, buffer_remaining);
   uint64_t* message_size = (uint64_t*)buffer;
-  uint32_t* message_updates = (uint32_t*)(buffer + 116);
+
+  // reduced and compact headers have the updates right after the id
+  uint32_t* message_updates =
+      (uint32_t*)(buffer + (reduced || compact ? 16 : 116));
 
   // Message header format
   // [size|id|domain|originator|type|updates|quality|clock|list of updates]
@@ -1162,6 +1625,17 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
   // Message update format
   // [key|value]
 
+  // array deltas are only valid if no filter could have changed the records
+  bool send_deltas = settings_.send_array_deltas &&
+                     settings_.get_number_of_send_filtered_types() == 0 &&
+                     settings_.get_number_of_send_aggregate_filters() == 0;
+  std::shared_ptr<const knowledge::DirtyRangesMap> sent_ranges;
+
+  if(send_deltas)
+  {
+    sent_ranges = context_.share_sent_ranges();
+  }
+
   int j = 0;
   uint32_t actual_updates = 0;
   for(knowledge::KnowledgeMap::const_iterator i = filtered_updates.begin();
@@ -1179,7 +1653,56 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
         return;
       }
 
-      update = rec.write(update, key, buffer_remaining);
+      const knowledge::DirtyRanges* ranges = nullptr;
+      uint64_t base_clock = 0;
+
+      if(sent_ranges && rec.is_array_type())
+      {
+        auto found = sent_ranges->find(key);
+        auto base = delta_bases_.find(key);
+
+        // the ranges must describe this exact version of the record, the
+        // array must have been sent before and not be due for a keyframe,
+        // and the delta must be smaller than the whole record
+        if(found != sent_ranges->end() && found->second.toi == rec.toi() &&
+            base != delta_bases_.end() &&
+            base->second.deltas + 1 <
+                settings_.array_delta_keyframe_interval &&
+            !(shaped && traffic_shaper_.was_delayed(key)) &&
+            found->second.end() <= rec.size() &&
+            (compact ? compact_encoder_.encoded_size(key, rec,
+                           &found->second, base->second.clock) <
+                           compact_encoder_.encoded_size(key, rec)
+                     : rec.get_encoded_delta_size(key, found->second) <
+                           rec.get_encoded_size(key)))
+        {
+          ranges = &found->second;
+          base_clock = base->second.clock;
+        }
+      }
+
+      if(ranges)
+      {
+        madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
+            "%s:"
+            " update[%d] => sending %zu of %" PRIu32 " elements of %s\n",
+            print_prefix, j, ranges->count(), rec.size(), key.c_str());
+      }
+
+      if(compact)
+      {
+        update = compact_encoder_.write(
+            update, key, rec, buffer_remaining, ranges, base_clock);
+      }
+      else if(ranges)
+      {
+        update = rec.write_delta(
+            update, key, *ranges, base_clock, buffer_remaining);
+      }
+      else
+      {
+        update = rec.write(update, key, buffer_remaining);
+      }
 
       if(buffer_remaining > 0)
       {
@@ -1190,6 +1713,14 @@ long Base::prep_send(const knowledge::KnowledgeMap& orig_updates,
             print_prefix, j, key.c_str(), rec.type(), rec.size(), rec.toi());
         ++actual_updates;
         ++j;
+
+        // receivers that apply this message hold the array at its clock
+        if(send_deltas && rec.is_array_type())
+        {
+          auto& base = delta_bases_[key];
+          base.clock = header->clock;
+          base.deltas = ranges ? base.deltas + 1 : 0;
+        }
       }
       else
       {
@@ -13,6 +13,8 @@
  * madara::transport::MulticastTransport.
  **/
 
+#include <functional>
+#include <map>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -23,9 +25,13 @@
 #include "madara/transport/QoSTransportSettings.h"
 
 #include "ReducedMessageHeader.h"
+#include "CompactMessageHeader.h"
 #include "madara/transport/BandwidthMonitor.h"
 #include "madara/transport/PacketScheduler.h"
+#include "madara/transport/TrafficShaper.h"
+#include "madara/transport/TransportContext.h"
 
+#include "madara/knowledge/ArrayDelta.h"
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/knowledge/ThreadSafeContext.h"
 #include "madara/expression/ExpressionTree.h"
@@ -99,6 +105,14 @@ public:
   long prep_send(const knowledge::KnowledgeMap& orig_updates,
       const char* print_prefix);
 
+  /**
+   * Confirms that the message last prepped by prep_send was sent. With
+   * the compact encoding, names are only remembered as announced once
+   * their message is confirmed, so transports that do not confirm their
+   * sends announce every name in every message.
+   **/
+  void confirm_sent(void);
+
   /**
    * Sends a list of updates to the domain. This function must be
    * implemented by your transport
@@ -107,10 +121,31 @@ public:
    * calls the deprecated version of send_data. This is expensive,
    * so override this version instead.
    *
+   * The updates may be empty when has_delayed_sends is true, in which
+   * case implementations must still call prep_send so that the updates
+   * delayed by the send bandwidth limit are sent.
+   *
    * @return  result of operation or -1 if we are shutting down
    **/
   virtual long send_data(const knowledge::KnowledgeMap&) = 0;
 
+  /**
+   * Checks if updates delayed by the send bandwidth limit are waiting
+   * to be sent, in which case send_data should be called even without
+   * new updates. Delayed updates are only sent by a later send_data,
+   * e.g., from send_modifieds, and not on a timer, so an application
+   * that stops sending should keep calling send_modifieds until this
+   * returns false.
+   * @return  true if delayed updates are waiting
+   **/
+  bool has_delayed_sends(void) const;
+
+  /**
+   * Returns the statistics of the shaper of the send bandwidth limit
+   * @return  the counts of sent, delayed and dropped updates
+   **/
+  TrafficShaperStats get_shaper_stats(void) const;
+
   /**
    * Invalidates a transport to indicate it is shutting down
    **/
@@ -149,13 +184,209 @@ protected:
   /// scheduler for dropping packets to simulate network issues
   PacketScheduler packet_scheduler_;
 
+  /// shaper of sends to the send bandwidth limit
+  TrafficShaper traffic_shaper_;
+
+  /// ids of the variables sent in the compact encoding
+  CompactEncoder compact_encoder_;
+
+  /**
+   * If set, prep_send only merges updates delayed by the send bandwidth
+   * limit whose keys this accepts, e.g., to keep topic partitions apart
+   **/
+  std::function<bool(const std::string&)> delayed_filter_;
+
   /// buffer for sending
   madara::utility::ScopedArray<char> buffer_;
 
   /// Latest TOI the previous send operation included
   uint64_t last_toi_sent_ = 0;
+
+  /**
+   * The version of an array that receivers hold, which array deltas are
+   * encoded against
+   **/
+  struct DeltaBase
+  {
+    /// the clock of the last message that carried the array
+    uint64_t clock = 0;
+
+    /// the deltas sent since the array was last sent in full
+    uint32_t deltas = 0;
+  };
+
+  /// the arrays sent with send_array_deltas enabled
+  std::map<std::string, DeltaBase> delta_bases_;
+};
+
+/**
+ * A received message that has been decoded and filtered, but not yet
+ * applied to the context
+ **/
+struct MADARA_EXPORT ReceivedUpdate
+{
+  ReceivedUpdate() = default;
+
+  ReceivedUpdate(const ReceivedUpdate&) = delete;
+
+  ReceivedUpdate& operator=(const ReceivedUpdate&) = delete;
+
+  ~ReceivedUpdate()
+  {
+    delete header;
+  }
+
+  /// the header of the message, owned by this update
+  MessageHeader* header = 0;
+
+  /// the filtered updates, latest value per variable
+  knowledge::KnowledgeMap updates;
+
+  /// earlier values of variables that appeared more than once
+  std::map<std::string, std::vector<knowledge::KnowledgeRecord>> past_updates;
+
+  /// array deltas, in message order, which are applied to their bases
+  /// and filtered when the message is applied
+  std::vector<std::pair<std::string, knowledge::ArrayDelta>> deltas;
+
+  /// the context that receive filters ran with
+  TransportContext transport_context;
+
+  /// true if the updates must not be rebroadcast
+  bool dropped = false;
 };
 
+/**
+ * Decodes a received message: runs the buffer filters, reads the header
+ * and updates, reassembles fragments, and runs the receive filters of
+ * each record. This does not lock the context, so messages may be decoded
+ * in parallel. Array deltas are kept in received.deltas, since the arrays
+ * they patch are only known when the message is applied. The aggregate
+ * receive filters therefore run when the message is applied
+ * (@see filter_received_update).
+ *
+ * @param  buffer           buffer containing all serialized updates
+ * @param  bytes_read       bytes in the buffer
+ * @param  id               unique identifier for originator strings
+ * @param  context          variable context of the knowledge base
+ * @param  settings         transport settings
+ * @param  send_monitor     monitor of send traffic
+ * @param  receive_monitor  monitor of receive traffice
+ * @param  print_prefix     prefix to include before every log message
+ * @param  remote_host      ip:port who actually sent this message
+ * @param  received         the decoded message
+ * @return       1 if the message should be applied, 0 if it is a fragment
+ *               of an incomplete message, or the negative codes of
+ *               process_received_update
+ **/
+int MADARA_EXPORT decode_received_update(const char* buffer,
+    uint32_t bytes_read, const std::string& id,
+    knowledge::ThreadSafeContext& context, const QoSTransportSettings& settings,
+    BandwidthMonitor& send_monitor, BandwidthMonitor& receive_monitor,
+    const char* print_prefix, const char* remote_host,
+    ReceivedUpdate& received);
+
+/**
+ * Patches the arrays of the array deltas of a decoded message, and adds
+ * the filtered results to its updates. A delta applies to the value of
+ * its array in the message, or else in the context, which must be the
+ * version the sender encoded against. Other deltas are dropped. This must
+ * be called right before the message is applied, with the context lock
+ * held, so that earlier messages have already been applied.
+ * @param  context          variable context of the knowledge base
+ * @param  settings         transport settings
+ * @param  received         the decoded message
+ * @param  print_prefix     prefix to include before every log message
+ **/
+void MADARA_EXPORT resolve_received_deltas(
+    knowledge::ThreadSafeContext& context, const QoSTransportSettings& settings,
+    ReceivedUpdate& received, const char* print_prefix);
+
+/**
+ * Runs the aggregate receive filters on the updates of a decoded message,
+ * which must be called after its array deltas are resolved, so that the
+ * patched arrays are filtered as whole arrays would be. The caller must
+ * hold the context lock.
+ * @param  context          variable context of the knowledge base
+ * @param  settings         transport settings
+ * @param  received         the decoded message
+ * @param  print_prefix     prefix to include before every log message
+ **/
+void MADARA_EXPORT filter_received_update(
+    knowledge::ThreadSafeContext& context, const QoSTransportSettings& settings,
+    ReceivedUpdate& received, const char* print_prefix);
+
+/**
+ * Applies a decoded message to the context. The caller must hold the
+ * context lock and call set_changed on the context afterwards. Array
+ * deltas must be resolved and the aggregate receive filters run first
+ * (@see resolve_received_deltas and filter_received_update).
+ * @param  context          variable context of the knowledge base
+ * @param  received         the decoded message
+ * @param  print_prefix     prefix to include before every log message
+ * @return the number of updates applied
+ **/
+int MADARA_EXPORT apply_received_update(knowledge::ThreadSafeContext& context,
+    ReceivedUpdate& received, const char* print_prefix);
+
+/**
+ * Finishes an applied message: fills the rebroadcast records according to
+ * the rebroadcast filters and evaluates the on_data_received logic
+ * @param  context          variable context of the knowledge base
+ * @param  settings         transport settings
+ * @param  received         the applied message
+ * @param  rebroadcast_records  filled with the records to rebroadcast
+ * @param  on_data_received compiled settings.on_data_received_logic
+ * @param  print_prefix     prefix to include before every log message
+ * @param  evaluate_rules   if false, on_data_received is not evaluated
+ **/
+void MADARA_EXPORT finish_received_update(
+    knowledge::ThreadSafeContext& context, const QoSTransportSettings& settings,
+    ReceivedUpdate& received, knowledge::KnowledgeMap& rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression& on_data_received,
+#endif  // _MADARA_NO_KARL_
+    const char* print_prefix, bool evaluate_rules = true);
+
+/**
+ * Removes stale values from a batch of decoded messages, keeping only the
+ * newest value of each variable by quality, then clock, then arrival.
+ * Variables whose records in the context keep history, or that have array
+ * deltas in the batch, are left alone.
+ * The caller must hold the context lock.
+ * @param  context          variable context of the knowledge base
+ * @param  batch            the decoded messages, in arrival order
+ * @return the number of values removed
+ **/
+size_t MADARA_EXPORT coalesce_received_updates(
+    knowledge::ThreadSafeContext& context,
+    const std::vector<ReceivedUpdate*>& batch);
+
+/**
+ * Applies a batch of decoded messages under one context lock, and then
+ * finishes each of them. If settings.coalesce_receives is true, stale
+ * values are removed first (@see coalesce_received_updates) and the
+ * on_data_received logic is evaluated once for the batch instead of once
+ * per message.
+ * @param  context          variable context of the knowledge base
+ * @param  settings         transport settings
+ * @param  batch            the decoded messages, in arrival order
+ * @param  rebroadcast_records  filled with the records to rebroadcast for
+ *                              each message in the batch
+ * @param  on_data_received compiled settings.on_data_received_logic
+ * @param  print_prefix     prefix to include before every log message
+ * @param  coalesced        if set, incremented by the values removed
+ * @return the number of updates applied
+ **/
+int MADARA_EXPORT apply_received_batch(knowledge::ThreadSafeContext& context,
+    const QoSTransportSettings& settings,
+    const std::vector<ReceivedUpdate*>& batch,
+    std::vector<knowledge::KnowledgeMap>& rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression& on_data_received,
+#endif  // _MADARA_NO_KARL_
+    const char* print_prefix, size_t* coalesced = 0);
+
 /**
  * Processes a received update, updates monitors, fills
  * rebroadcast records according to settings filters, and
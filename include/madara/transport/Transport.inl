@@ -43,4 +43,20 @@ inline madara::transport::TransportSettings& madara::transport::Base::settings(
   return settings_;
 }
 
+inline bool madara::transport::Base::has_delayed_sends(void) const
+{
+  return traffic_shaper_.has_delayed();
+}
+
+inline madara::transport::TrafficShaperStats
+madara::transport::Base::get_shaper_stats(void) const
+{
+  return traffic_shaper_.get_stats();
+}
+
+inline void madara::transport::Base::confirm_sent(void)
+{
+  compact_encoder_.confirm();
+}
+
 #endif
@@ -58,6 +58,8 @@ madara::transport::TransportSettings::TransportSettings(
     const TransportSettings& settings)
   : write_domain(settings.write_domain),
     read_threads(settings.read_threads),
+    decode_threads(settings.decode_threads),
+    coalesce_receives(settings.coalesce_receives),
     queue_length(settings.queue_length),
     type(settings.type),
     max_fragment_size(settings.max_fragment_size),
@@ -70,6 +72,9 @@ madara::transport::TransportSettings::TransportSettings(
     delay_launch(settings.delay_launch),
     never_exit(settings.never_exit),
     send_reduced_message_header(settings.send_reduced_message_header),
+    send_compact_encoding(settings.send_compact_encoding),
+    compact_dictionary_refresh(settings.compact_dictionary_refresh),
+    compact_dictionary_size(settings.compact_dictionary_size),
     slack_time(settings.slack_time),
     read_thread_hertz(settings.read_thread_hertz),
     max_send_hertz(settings.max_send_hertz),
@@ -77,6 +82,10 @@ madara::transport::TransportSettings::TransportSettings(
     no_sending(settings.no_sending),
     no_receiving(settings.no_receiving),
     send_history(settings.send_history),
+    send_array_deltas(settings.send_array_deltas),
+    array_delta_keyframe_interval(settings.array_delta_keyframe_interval),
+    use_topics(settings.use_topics),
+    topic_prefixes(settings.topic_prefixes),
     debug_to_kb_prefix(settings.debug_to_kb_prefix),
     read_domains_(settings.read_domains_)
 {
@@ -89,6 +98,8 @@ void madara::transport::TransportSettings::operator=(
     const TransportSettings& settings)
 {
   read_threads = settings.read_threads;
+  decode_threads = settings.decode_threads;
+  coalesce_receives = settings.coalesce_receives;
   write_domain = settings.write_domain;
   read_domains_ = settings.read_domains_;
   queue_length = settings.queue_length;
@@ -105,6 +116,9 @@ void madara::transport::TransportSettings::operator=(
   never_exit = settings.never_exit;
 
   send_reduced_message_header = settings.send_reduced_message_header;
+  send_compact_encoding = settings.send_compact_encoding;
+  compact_dictionary_refresh = settings.compact_dictionary_refresh;
+  compact_dictionary_size = settings.compact_dictionary_size;
   slack_time = settings.slack_time;
   read_thread_hertz = settings.read_thread_hertz;
   max_send_hertz = settings.max_send_hertz;
@@ -117,6 +131,11 @@ void madara::transport::TransportSettings::operator=(
   no_receiving = settings.no_receiving;
 
   send_history = settings.send_history;
+  send_array_deltas = settings.send_array_deltas;
+  array_delta_keyframe_interval = settings.array_delta_keyframe_interval;
+
+  use_topics = settings.use_topics;
+  topic_prefixes = settings.topic_prefixes;
 
   debug_to_kb_prefix = settings.debug_to_kb_prefix;
 }
@@ -161,6 +180,18 @@ void madara::transport::TransportSettings::load(
     read_threads = (uint32_t)value.to_integer();
   }
   
+  value = knowledge.get(prefix + ".decode_threads");
+  if (value.exists())
+  {
+    decode_threads = (uint32_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".coalesce_receives");
+  if (value.exists())
+  {
+    coalesce_receives = value.is_true();
+  }
+
   value = knowledge.get(prefix + ".write_domain");
   if (value.exists())
   {
@@ -238,6 +269,24 @@ void madara::transport::TransportSettings::load(
   {
     send_reduced_message_header = value.is_true();
   }
+
+  value = knowledge.get(prefix + ".send_compact_encoding");
+  if (value.exists())
+  {
+    send_compact_encoding = value.is_true();
+  }
+
+  value = knowledge.get(prefix + ".compact_dictionary_refresh");
+  if (value.exists())
+  {
+    compact_dictionary_refresh = value.to_double();
+  }
+
+  value = knowledge.get(prefix + ".compact_dictionary_size");
+  if (value.exists())
+  {
+    compact_dictionary_size = (uint32_t)value.to_integer();
+  }
   
   value = knowledge.get(prefix + ".slack_time");
   if (value.exists())
@@ -310,6 +359,18 @@ void madara::transport::TransportSettings::load_text(
     read_threads = (uint32_t)value.to_integer();
   }
   
+  value = knowledge.get(prefix + ".decode_threads");
+  if (value.exists())
+  {
+    decode_threads = (uint32_t)value.to_integer();
+  }
+
+  value = knowledge.get(prefix + ".coalesce_receives");
+  if (value.exists())
+  {
+    coalesce_receives = value.is_true();
+  }
+
   value = knowledge.get(prefix + ".write_domain");
   if (value.exists())
   {
@@ -387,6 +448,24 @@ void madara::transport::TransportSettings::load_text(
   {
     send_reduced_message_header = value.is_true();
   }
+
+  value = knowledge.get(prefix + ".send_compact_encoding");
+  if (value.exists())
+  {
+    send_compact_encoding = value.is_true();
+  }
+
+  value = knowledge.get(prefix + ".compact_dictionary_refresh");
+  if (value.exists())
+  {
+    compact_dictionary_refresh = value.to_double();
+  }
+
+  value = knowledge.get(prefix + ".compact_dictionary_size");
+  if (value.exists())
+  {
+    compact_dictionary_size = (uint32_t)value.to_integer();
+  }
   
   value = knowledge.get(prefix + ".slack_time");
   if (value.exists())
@@ -458,6 +537,8 @@ void madara::transport::TransportSettings::save(
       prefix + ".hosts", knowledge, (int)hosts.size());
 
   knowledge.set(prefix + ".read_threads", Integer(read_threads));
+  knowledge.set(prefix + ".decode_threads", Integer(decode_threads));
+  knowledge.set(prefix + ".coalesce_receives", Integer(coalesce_receives));
   knowledge.set(prefix + ".write_domain", write_domain);
   knowledge.set(prefix + ".queue_length", Integer(queue_length));
   knowledge.set(prefix + ".type", Integer(type));
@@ -475,6 +556,12 @@ void madara::transport::TransportSettings::save(
 
   knowledge.set(prefix + ".send_reduced_message_header",
       Integer(send_reduced_message_header));
+  knowledge.set(prefix + ".send_compact_encoding",
+      Integer(send_compact_encoding));
+  knowledge.set(
+      prefix + ".compact_dictionary_refresh", compact_dictionary_refresh);
+  knowledge.set(
+      prefix + ".compact_dictionary_size", Integer(compact_dictionary_size));
   knowledge.set(prefix + ".slack_time", slack_time);
   knowledge.set(prefix + ".read_thread_hertz", read_thread_hertz);
   knowledge.set(prefix + ".max_send_hertz", max_send_hertz);
@@ -515,6 +602,8 @@ void madara::transport::TransportSettings::save_text(
       prefix + ".hosts", knowledge, (int)hosts.size());
 
   knowledge.set(prefix + ".read_threads", Integer(read_threads));
+  knowledge.set(prefix + ".decode_threads", Integer(decode_threads));
+  knowledge.set(prefix + ".coalesce_receives", Integer(coalesce_receives));
   knowledge.set(prefix + ".write_domain", write_domain);
   knowledge.set(prefix + ".queue_length", Integer(queue_length));
   knowledge.set(prefix + ".type", Integer(type));
@@ -532,6 +621,12 @@ void madara::transport::TransportSettings::save_text(
 
   knowledge.set(prefix + ".send_reduced_message_header",
       Integer(send_reduced_message_header));
+  knowledge.set(prefix + ".send_compact_encoding",
+      Integer(send_compact_encoding));
+  knowledge.set(
+      prefix + ".compact_dictionary_refresh", compact_dictionary_refresh);
+  knowledge.set(
+      prefix + ".compact_dictionary_size", Integer(compact_dictionary_size));
   knowledge.set(prefix + ".slack_time", slack_time);
   knowledge.set(prefix + ".read_thread_hertz", read_thread_hertz);
   knowledge.set(prefix + ".max_send_hertz", max_send_hertz);
@@ -26,6 +26,7 @@
 #include "madara/expression/Interpreter.h"
 #include "madara/MadaraExport.h"
 #include "madara/transport/Fragmentation.h"
+#include "madara/transport/CompactEncoding.h"
 
 namespace madara
 {
@@ -226,6 +227,27 @@ public:
   /// the number of read threads to start
   uint32_t read_threads = 1;
 
+  /**
+   * the number of threads that decode received messages. If 0, each read
+   * thread decodes and applies the messages it receives. Otherwise, read
+   * threads only drain the socket into pooled buffers, these threads run
+   * the buffer filters (e.g., decompression and decryption), record
+   * decoding and receive filters in parallel, and a single apply thread
+   * commits decoded messages to the context in the order they arrived.
+   * Currently supported by the UDP, multicast and broadcast transports.
+   **/
+  uint32_t decode_threads = 0;
+
+  /**
+   * if true, messages that are received together are applied as a batch:
+   * only the newest value of each variable in the batch is applied,
+   * unless its record keeps history, the batch is applied under one
+   * context lock, and on_data_received_logic is evaluated once per batch.
+   * Batches are what a read thread can drain from the socket at once, or
+   * what the apply thread finds decoded if decode_threads > 0.
+   **/
+  bool coalesce_receives = false;
+
   /**
    * Length of the buffer used to store history of events. For almost
    * all transports, this is the buffer size used by the operating
@@ -281,6 +303,36 @@ public:
   /// Map of fragments received by originator
   mutable OriginatorFragmentMap fragment_map;
 
+  /// Guards fragment_map for concurrent read and decode threads
+  mutable MADARA_LOCK_TYPE fragment_mutex;
+
+  /**
+   * if true, messages are sent in the compact encoding: a header whose
+   * integers are varints, and updates that refer to variables by ids
+   * that are announced with their names once and then every
+   * compact_dictionary_refresh seconds. Integers and times of last
+   * update are varints. Receivers decode both encodings, but
+   * rebroadcast in the standard one.
+   **/
+  bool send_compact_encoding = false;
+
+  /**
+   * seconds between announcements of the name of each id in the compact
+   * encoding, so peers that join late or lose a message learn the ids.
+   * Until then, they skip updates with unknown ids. 0 announces each
+   * name only once.
+   **/
+  double compact_dictionary_refresh = 1.0;
+
+  /**
+   * the most variables given ids in the compact encoding. Names of
+   * other variables are sent in every update.
+   **/
+  uint32_t compact_dictionary_size = 4096;
+
+  /// Ids announced by each originator in the compact encoding
+  mutable CompactDecoder compact_decoder;
+
   /// Time to sleep between sends and rebroadcasts
   double slack_time = 0;
 
@@ -324,6 +376,44 @@ public:
    **/
   bool send_history = false;
 
+  /**
+   * if true, array records whose changes since the last send were all
+   * indexed sets (e.g., NativeDoubleVector::set (index, value)) are sent
+   * as deltas of the changed index ranges instead of the whole array.
+   * Receivers only apply a delta to the exact array it was encoded
+   * against (same type, size and clock) and drop it otherwise, so late
+   * joiners and peers that dropped a packet wait for the next full
+   * update (@see array_delta_keyframe_interval).
+   * Deltas are not used if any send filters are configured.
+   **/
+  bool send_array_deltas = false;
+
+  /**
+   * with send_array_deltas, every Nth send of an array is a full update
+   * (a keyframe), which resynchronizes receivers whose base was lost.
+   * 0 or 1 sends every update in full.
+   **/
+  uint32_t array_delta_keyframe_interval = 10;
+
+  /**
+   * if true, transports with publish/subscribe topics (currently ZMQ)
+   * publish each message on a topic of the write domain, and receivers
+   * subscribe only to the topics of their read domains, so messages of
+   * other domains are discarded before they are read or decoded
+   **/
+  bool use_topics = false;
+
+  /**
+   * variable prefixes that partition updates into topics if use_topics
+   * is true. Updates under each prefix are sent in their own message on
+   * a topic of the write domain and the prefix, and a receiver with
+   * prefixes subscribes only to those partitions. Updates outside all
+   * prefixes are sent on the topic of the domain alone, which receivers
+   * with prefixes do not see, so senders and receivers should agree on
+   * the prefixes.
+   **/
+  std::vector<std::string> topic_prefixes;
+
   /**
    * if not empty, save debug information to knowledge base at prefix
    **/
@@ -315,6 +315,11 @@ long madara::transport::NddsTransport::send_data(
   DDS_InstanceHandle_t handle = update_writer_->register_instance(data);
   rc = update_writer_->write(data, handle);
 
+  if (rc == DDS_RETCODE_OK)
+  {
+    confirm_sent();
+  }
+
   Ndds_Knowledge_Update_finalize(&data);
 
   return rc;
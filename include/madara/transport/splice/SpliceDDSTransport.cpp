@@ -434,6 +434,11 @@ long madara::transport::SpliceDDSTransport::send_data(
     handle = update_writer_->register_instance(data);
     dds_result = update_writer_->write(data, handle);
     result = (long)dds_result;
+
+    if (dds_result == DDS::RETCODE_OK)
+    {
+      confirm_sent();
+    }
     // update_writer_->unregister_instance (data, handle);
   }
 
@@ -6,8 +6,16 @@
 #include "madara/transport/ReducedMessageHeader.h"
 #include "madara/utility/Utility.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
 namespace madara
 {
 namespace transport
@@ -34,6 +42,22 @@ UdpTransport::UdpTransport(const std::string& id,
   }
 }
 
+UdpTransport::~UdpTransport()
+{
+  // read threads push into the pipeline, so they must stop first
+  UdpTransport::close();
+}
+
+void UdpTransport::close(void)
+{
+  BasicASIOTransport::close();
+
+  if(receive_pipeline_)
+  {
+    receive_pipeline_->stop();
+  }
+}
+
 int UdpTransport::reliability(void) const
 {
   return BEST_EFFORT;
@@ -55,6 +79,102 @@ int UdpTransport::setup_read_thread(double hertz, const std::string& name)
   return 0;
 }
 
+int UdpTransport::setup_read_threads(void)
+{
+  if(!settings_.no_receiving && settings_.decode_threads > 0)
+  {
+    madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+        "UdpTransport::setup_read_threads:"
+        " starting receive pipeline with %d decode threads\n",
+        (int)settings_.decode_threads);
+
+    if(!receive_pipeline_)
+    {
+      receive_pipeline_.reset(new ReceivePipeline(
+          id_, context_, settings_, send_monitor_, receive_monitor_));
+
+      if(settings_.debug_to_kb_prefix != "")
+      {
+        receive_pipeline_->debug_to_kb(settings_.debug_to_kb_prefix);
+      }
+    }
+
+    if(settings_.queue_length > 0)
+    {
+      rebroadcast_buffer_ = new char[settings_.queue_length];
+    }
+
+    receive_pipeline_->start(settings_.decode_threads,
+        [this](MessageHeader* header, const knowledge::KnowledgeMap& records) {
+          rebroadcast(rebroadcast_buffer_.get_ptr(), "ReceivePipeline::apply",
+              header, records);
+        });
+  }
+
+  return BasicASIOTransport::setup_read_threads();
+}
+
+long UdpTransport::rebroadcast(char* buffer, const char* print_prefix,
+    MessageHeader* header, const knowledge::KnowledgeMap& records)
+{
+  int64_t buffer_remaining = (int64_t)settings_.queue_length;
+  long result(0);
+
+  if (buffer && !settings_.no_sending && records.size () > 0)
+  {
+    result = prep_rebroadcast(context_, buffer, buffer_remaining, settings_,
+        print_prefix, header, records, packet_scheduler_);
+
+    if (result > 0)
+    {
+      uint64_t clock = records.begin()->second.clock;
+      result = send_message(buffer, result, clock);
+
+      if (result > 0)
+      {
+        send_monitor_.add(result);
+        if (settings_.debug_to_kb_prefix != "")
+        {
+          sent_data += result;
+          ++sent_packets;
+          if (sent_data_max < result)
+          {
+            sent_data_max = result;
+          }
+          if (sent_data_min > result || sent_data_min == 0)
+          {
+            sent_data_min = result;
+          }
+        }
+      }
+      else
+      {
+        if (settings_.debug_to_kb_prefix != "")
+        {
+          ++failed_sends;
+        }
+      }
+
+      madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+          "%s:"
+          " Send bandwidth = %" PRIu64 " B/s\n",
+          print_prefix, send_monitor_.get_bytes_per_second());
+    }
+  }
+
+  return result;
+}
+
+ReceivePipelineStats UdpTransport::get_receive_pipeline_stats(void) const
+{
+  if(receive_pipeline_)
+  {
+    return receive_pipeline_->get_stats();
+  }
+
+  return ReceivePipelineStats();
+}
+
 int UdpTransport::setup_read_socket(void)
 {
   if(BasicASIOTransport::setup_read_socket() < 0)
@@ -129,12 +249,21 @@ long UdpTransport::receive_buffer(
 
 long UdpTransport::send_buffer(
     const udp::endpoint& target, const char* buf, size_t size)
+{
+  return send_buffer(target, 0, 0, buf, size);
+}
+
+long UdpTransport::send_buffer(const udp::endpoint& target,
+    const char* header, size_t header_size, const char* buf, size_t size)
 {
   uint64_t bytes_sent = 0;
 
   int send_attempts = -1;
   ssize_t actual_sent = -1;
 
+  const Datagram datagram = {
+      asio::buffer(header, header_size), asio::buffer(buf, size)};
+
   while (actual_sent < 0 && (settings_.resend_attempts < 0 ||
                                 send_attempts < settings_.resend_attempts))
   {
@@ -146,7 +275,7 @@ long UdpTransport::send_buffer(
     // send the fragment
     try
     {
-      actual_sent = socket_.send_to(asio::buffer(buf, size), target);
+      actual_sent = socket_.send_to(datagram, target);
     }
     catch (const boost::system::system_error& e)
     {
@@ -160,10 +289,6 @@ long UdpTransport::send_buffer(
     }
 
     ++send_attempts;
-    if(settings_.debug_to_kb_prefix != "")
-    {
-      ++sent_packets;
-    }
 
     if(actual_sent > 0)
     {
@@ -173,27 +298,127 @@ long UdpTransport::send_buffer(
           (int)target.port());
 
       bytes_sent += actual_sent;
+    }
 
-      if(settings_.debug_to_kb_prefix != "")
+    record_send(actual_sent);
+  }
+
+  return (long)bytes_sent;
+}
+
+void UdpTransport::record_send(ssize_t actual_sent)
+{
+  if(settings_.debug_to_kb_prefix != "")
+  {
+    ++sent_packets;
+
+    if(actual_sent > 0)
+    {
+      sent_data += actual_sent;
+      if(sent_data_max < actual_sent)
       {
-        sent_data += actual_sent;
-        if(sent_data_max < actual_sent)
-        {
-          sent_data_max = actual_sent;
-        }
-        if(sent_data_min > actual_sent || sent_data_min == 0)
-        {
-          sent_data_min = actual_sent;
-        }
+        sent_data_max = actual_sent;
+      }
+      if(sent_data_min > actual_sent || sent_data_min == 0)
+      {
+        sent_data_min = actual_sent;
       }
     }
     else
     {
-      if(settings_.debug_to_kb_prefix != "")
+      ++failed_sends;
+    }
+  }
+}
+
+long UdpTransport::send_datagrams(const std::vector<Datagram>& datagrams)
+{
+  uint64_t bytes_sent = 0;
+
+  std::vector<const udp::endpoint*> targets;
+
+  for(const auto& address : addresses_)
+  {
+    if(pre_send_buffer(&address - &*addresses_.begin()))
+    {
+      targets.push_back(&address);
+    }
+  }
+
+  size_t count = datagrams.size() * targets.size();
+  size_t sent = 0;
+
+#ifdef __linux__
+  // a send rate limit needs a sleep between datagrams, so only batch
+  // when there is none
+  if(settings_.max_send_hertz <= 0 && count > 1)
+  {
+    std::vector<struct mmsghdr> messages(count);
+    std::vector<struct iovec> iovecs(count * 2);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      const Datagram& datagram = datagrams[i / targets.size()];
+      const udp::endpoint& target = *targets[i % targets.size()];
+
+      for(size_t j = 0; j < 2; ++j)
       {
-        ++failed_sends;
+        iovecs[i * 2 + j].iov_base =
+            const_cast<void*>(datagram[j].data());
+        iovecs[i * 2 + j].iov_len = datagram[j].size();
       }
+
+      struct msghdr& header = messages[i].msg_hdr;
+      memset(&header, 0, sizeof(header));
+      header.msg_name = const_cast<sockaddr*>(target.data());
+      header.msg_namelen = (socklen_t)target.size();
+      header.msg_iov = &iovecs[i * 2];
+      header.msg_iovlen = 2;
     }
+
+    // sendmmsg accepts at most UIO_MAXIOV messages per call
+    const size_t max_batch = 1024;
+
+    while(sent < count)
+    {
+      int result = ::sendmmsg(socket_.native_handle(), &messages[sent],
+          (unsigned int)std::min(count - sent, max_batch), 0);
+
+      if(result <= 0)
+      {
+        madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+            "UdpTransport::send_datagrams:"
+            " sendmmsg stopped after %d of %d datagrams: %s\n",
+            (int)sent, (int)count, strerror(errno));
+
+        break;
+      }
+
+      for(size_t i = sent; i < sent + (size_t)result; ++i)
+      {
+        bytes_sent += messages[i].msg_len;
+        record_send((ssize_t)messages[i].msg_len);
+      }
+
+      sent += (size_t)result;
+    }
+
+    madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+        "UdpTransport::send_datagrams:"
+        " sent %d datagrams to %d hosts in batches\n",
+        (int)sent, (int)targets.size());
+  }
+#endif
+
+  // anything that was not batched goes out one datagram at a time, with
+  // the usual resend attempts
+  for(size_t i = sent; i < count; ++i)
+  {
+    const Datagram& datagram = datagrams[i / targets.size()];
+
+    bytes_sent += send_buffer(*targets[i % targets.size()],
+        (const char*)datagram[0].data(), datagram[0].size(),
+        (const char*)datagram[1].data(), datagram[1].size());
   }
 
   return (long)bytes_sent;
@@ -208,7 +433,7 @@ long UdpTransport::send_message(const char* buf, size_t packet_size,
 
   if(packet_size > settings_.max_fragment_size)
   {
-    FragmentMap map;
+    FragmentSlices slices;
 
     madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
         "%s:"
@@ -216,40 +441,46 @@ long UdpTransport::send_message(const char* buf, size_t packet_size,
         " bytes is max fragment size)\n",
         print_prefix, packet_size, settings_.max_fragment_size);
 
-    // fragment the message
+    // fragment the message without copying it
     frag(buf, packet_size, id_.c_str (), settings_.write_domain.c_str(),
       clock, utility::get_time(), 0, 0,
-      settings_.max_fragment_size, map);
+      settings_.max_fragment_size, slices);
 
-    int j(0);
-    for(FragmentMap::iterator i = map.begin(); i != map.end(); ++i, ++j)
+    std::vector<Datagram> datagrams;
+    datagrams.reserve(slices.size());
+
+    for(size_t i = 0; i < slices.size(); ++i)
     {
-      madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
-          "%s:"
-          " Sending fragment %d\n",
-          print_prefix, j);
+      datagrams.push_back(Datagram{
+          asio::buffer(slices.header(i), slices.header_size()),
+          asio::buffer(slices.payloads[i].first, slices.payloads[i].second)});
+    }
 
-      for(const auto& address : addresses_)
+    if(settings_.slack_time > 0)
+    {
+      // sleep between fragments, if such a slack time is specified
+      for(size_t i = 0; i < datagrams.size(); ++i)
       {
-        if(pre_send_buffer(&address - &*addresses_.begin()))
-        {
-          bytes_sent += send_buffer(
-              address, i->second.get(),
-              (size_t)MessageHeader::get_size(i->second.get()));
-        }
-      }
+        madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+            "%s:"
+            " Sending fragment %d\n",
+            print_prefix, (int)i);
+
+        bytes_sent += send_datagrams(
+            std::vector<Datagram>(1, datagrams[i]));
 
-      // sleep between fragments, if such a slack time is specified
-      if(settings_.slack_time > 0)
         utility::sleep(settings_.slack_time);
+      }
+    }
+    else
+    {
+      bytes_sent += send_datagrams(datagrams);
     }
 
     madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
         "%s:"
         " Sent fragments totalling %" PRIu64 " bytes\n",
         print_prefix, bytes_sent);
-
-    delete_fragments(map);
   }
   else
   {
@@ -258,22 +489,8 @@ long UdpTransport::send_message(const char* buf, size_t packet_size,
         " Sending packet of size %ld\n",
         print_prefix, packet_size);
 
-    for(const auto& address : addresses_)
-    {
-      size_t addr_index = &address - &*addresses_.begin();
-      bool should_send = pre_send_buffer(addr_index);
-
-      madara_logger_log(context_.get_logger(), logger::LOG_MINOR,
-          "%s:"
-          " Deciding to send to %s:%d (index %d): %d\n",
-          print_prefix, address.address().to_string().c_str(),
-          (int)address.port(), addr_index, should_send);
-
-      if(should_send)
-      {
-        bytes_sent += send_buffer(address, buf, (size_t)packet_size);
-      }
-    }
+    bytes_sent += send_datagrams(std::vector<Datagram>(1,
+        Datagram{asio::const_buffer(), asio::buffer(buf, packet_size)}));
   }
 
   if(bytes_sent > 0)
@@ -295,14 +512,24 @@ long UdpTransport::send_data(
   long result(0);
   const char* print_prefix = "UdpTransport::send_data";
 
-  if(!settings_.no_sending && orig_updates.size() != 0)
+  if(!settings_.no_sending &&
+      (orig_updates.size() != 0 || has_delayed_sends()))
   {
     result = prep_send(orig_updates, print_prefix);
 
     if(addresses_.size() > 0 && result > 0)
     {
-      result = send_message(
-          buffer_.get_ptr(), result, orig_updates.begin()->second.clock);
+      // a send of only delayed updates has no new update to take a clock from
+      uint64_t clock = orig_updates.size() != 0
+                           ? orig_updates.begin()->second.clock
+                           : context_.get_clock();
+
+      result = send_message(buffer_.get_ptr(), result, clock);
+
+      if(result > 0)
+      {
+        confirm_sent();
+      }
     }
   }
 
@@ -5,13 +5,17 @@
 
 #include "madara/MadaraExport.h"
 #include "madara/transport/BasicASIOTransport.h"
+#include "madara/transport/ReceivePipeline.h"
 #include "madara/transport/Transport.h"
 #include "madara/threads/Threader.h"
 #include "madara/utility/EpochEnforcer.h"
 #include "madara/knowledge/containers/Integer.h"
 
+#include <array>
+#include <memory>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "madara/Boost.h"
 
@@ -42,6 +46,16 @@ public:
       madara::knowledge::ThreadSafeContext& context, TransportSettings& config,
       bool launch_transport);
 
+  /**
+   * Destructor, which stops the read and decode threads
+   **/
+  virtual ~UdpTransport();
+
+  /**
+   * Closes the transport
+   **/
+  void close(void) override;
+
   /**
    * Accesses reliability setting
    * @return  whether we are using reliable dissemination or not
@@ -97,12 +111,61 @@ public:
   long send_buffer(const udp::endpoint& target,
     const char* buf, size_t size);
 
+  /**
+   * Sends a header and a buffer as one datagram to a host endpoint,
+   * without copying them together
+   * @param target      remote endpoint to send to
+   * @param header      header to send first
+   * @param header_size number of header bytes to send
+   * @param buf         buffer to send after the header
+   * @param size        number of bytes to send from the buffer
+   * @return the number of bytes sent
+   **/
+  long send_buffer(const udp::endpoint& target, const char* header,
+    size_t header_size, const char* buf, size_t size);
+
+  /**
+   * Sends records that passed the rebroadcast filters
+   * @param buffer       buffer of settings.queue_length bytes to prep the
+   *                     message in
+   * @param print_prefix prefix to include before every log message
+   * @param header       header of the received message
+   * @param records      records to rebroadcast
+   * @return the number of bytes sent
+   **/
+  long rebroadcast(char* buffer, const char* print_prefix,
+    MessageHeader* header, const knowledge::KnowledgeMap& records);
+
+  /**
+   * Returns the statistics of the receive pipeline
+   * @return the pipeline statistics, or zeros if decode_threads is 0
+   **/
+  ReceivePipelineStats get_receive_pipeline_stats(void) const;
+
 protected:
   int setup_read_socket() override;
   int setup_write_socket() override;
+  int setup_read_threads() override;
   int setup_read_thread(double hertz, const std::string& name) override;
 
   long send_message(const char* buf, size_t size, uint64_t clock);
+
+  /// the header and data buffers of a datagram
+  typedef std::array<asio::const_buffer, 2> Datagram;
+
+  /**
+   * Sends datagrams to every address that pre_send_buffer accepts,
+   * batching them into as few system calls as the platform allows
+   * @param datagrams   the datagrams to send
+   * @return the number of bytes sent
+   **/
+  long send_datagrams(const std::vector<Datagram>& datagrams);
+
+  /**
+   * Updates the debug statistics after a send attempt
+   * @param actual_sent  bytes sent, or a negative number on failure
+   **/
+  void record_send(ssize_t actual_sent);
   virtual bool pre_send_buffer(size_t addr_index)
   {
     return addr_index != 0;
@@ -111,6 +174,12 @@ protected:
   /// enforces epochs when user specifies a max_send_hertz
   utility::EpochEnforcer<utility::Clock> enforcer_;
 
+  /// decodes and applies received messages if decode_threads > 0
+  std::unique_ptr<ReceivePipeline> receive_pipeline_;
+
+  /// buffer for rebroadcasts from the receive pipeline
+  utility::ScopedArray<char> rebroadcast_buffer_;
+
   friend class UdpTransportReadThread;
 };
 }
@@ -4,6 +4,9 @@
 #include "madara/transport/ReducedMessageHeader.h"
 
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
 
 namespace madara
 {
@@ -74,90 +77,20 @@ void UdpTransportReadThread::cleanup(void) {}
 void UdpTransportReadThread::rebroadcast(const char* print_prefix,
     MessageHeader* header, const knowledge::KnowledgeMap& records)
 {
-  const QoSTransportSettings& settings_ = transport_.settings_;
-
-  int64_t buffer_remaining = (int64_t)settings_.queue_length;
-  char* buffer = buffer_.get_ptr();
-  int result(0);
-
-  if (!settings_.no_sending && records.size () > 0)
-  {
-    result = prep_rebroadcast(*context_, buffer, buffer_remaining, settings_,
-        print_prefix, header, records, transport_.packet_scheduler_);
-
-    if (result > 0)
-    {
-      uint64_t clock = records.begin()->second.clock;
-      result = transport_.send_message(buffer, result, clock);
-
-      if (result > 0)
-      {
-        transport_.send_monitor_.add(result);
-        if (settings_.debug_to_kb_prefix != "")
-        {
-          transport_.sent_data += result;
-          ++transport_.sent_packets;
-          if (transport_.sent_data_max < result)
-          {
-            transport_.sent_data_max = result;
-          }
-          if (transport_.sent_data_min > result ||
-              transport_.sent_data_min == 0)
-          {
-            transport_.sent_data_min = result;
-          }
-        }
-      }
-      else
-      {
-        if (settings_.debug_to_kb_prefix != "")
-        {
-          ++transport_.failed_sends;
-        }
-      }
-
-      madara_logger_log(this->context_->get_logger(), logger::LOG_MAJOR,
-          "%s:"
-          " Send bandwidth = %" PRIu64 " B/s\n",
-          print_prefix, transport_.send_monitor_.get_bytes_per_second());
-    }
-  }
+  transport_.rebroadcast(buffer_.get_ptr(), print_prefix, header, records);
 }
 
-void UdpTransportReadThread::run(void)
+bool UdpTransportReadThread::receive(char* buffer, size_t& bytes_read,
+    std::string& remote_host, const char* print_prefix, bool count_empty)
 {
   const QoSTransportSettings& settings_ = transport_.settings_;
 
-  if (settings_.no_receiving)
-  {
-    return;
-  }
-
-  // allocate a buffer to send
-  char* buffer = buffer_.get_ptr();
-  static const char print_prefix[] = "UdpTransportReadThread::run";
-
-  madara_logger_log(this->context_->get_logger(), logger::LOG_MINOR,
-      "%s:"
-      " entering main service loop.\n",
-      print_prefix);
-
-  if (buffer == 0)
-  {
-    madara_logger_log(this->context_->get_logger(), logger::LOG_EMERGENCY,
-        "%s:"
-        " Unable to allocate buffer of size %" PRIu32 ". Exiting thread.\n",
-        print_prefix, settings_.queue_length);
-
-    return;
-  }
-
   madara_logger_log(this->context_->get_logger(), logger::LOG_MINOR,
       "%s: entering a recv on the socket.\n", print_prefix);
 
   udp::endpoint remote;
   boost::system::error_code err;
-  size_t bytes_read = transport_.socket_.receive_from(
+  bytes_read = transport_.socket_.receive_from(
       asio::buffer((void*)buffer, settings_.queue_length), remote,
       udp::socket::message_flags{}, err);
 
@@ -166,12 +99,12 @@ void UdpTransportReadThread::run(void)
     madara_logger_log(this->context_->get_logger(), logger::LOG_MINOR,
         "%s: no bytes to read. Proceeding to next wait\n", print_prefix);
 
-    if (settings_.debug_to_kb_prefix != "")
+    if (count_empty && settings_.debug_to_kb_prefix != "")
     {
       ++failed_receives_;
     }
 
-    return;
+    return false;
   }
   else if (err)
   {
@@ -184,7 +117,7 @@ void UdpTransportReadThread::run(void)
       ++failed_receives_;
     }
 
-    return;
+    return false;
   }
 
   if (settings_.debug_to_kb_prefix != "")
@@ -218,13 +151,142 @@ void UdpTransportReadThread::run(void)
         print_prefix, (long long)bytes_read);
   }
 
-  MessageHeader* header = 0;
+  std::stringstream host;
+  host << remote.address().to_string();
+  host << ":";
+  host << remote.port();
+
+  remote_host = host.str();
+
+  return true;
+}
+
+void UdpTransportReadThread::run_batch(char* buffer, const char* print_prefix)
+{
+  const QoSTransportSettings& settings_ = transport_.settings_;
+
+  std::vector<std::unique_ptr<ReceivedUpdate>> received;
+  std::vector<ReceivedUpdate*> batch;
+  size_t bytes_read = 0;
+  size_t reads = 0;
+  std::string remote_host;
+
+  // decode everything already waiting on the socket, without the context
+  // lock, since decoded records do not refer to the receive buffer. Only
+  // an empty first read is a failed receive, since later reads stop at
+  // the end of the waiting messages.
+  while (received.size() < max_batch &&
+         receive(buffer, bytes_read, remote_host, print_prefix, reads++ == 0))
+  {
+    std::unique_ptr<ReceivedUpdate> update(new ReceivedUpdate());
+
+    if (decode_received_update(buffer, (uint32_t)bytes_read, transport_.id_,
+            *context_, settings_, transport_.send_monitor_,
+            transport_.receive_monitor_, print_prefix, remote_host.c_str(),
+            *update) > 0)
+    {
+      batch.push_back(update.get());
+      received.push_back(std::move(update));
+    }
+  }
+
+  if (batch.size() == 0)
+  {
+    return;
+  }
+
+  std::vector<knowledge::KnowledgeMap> rebroadcast_records;
+  size_t coalesced = 0;
+
+  apply_received_batch(*context_, settings_, batch, rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+      on_data_received_,
+#endif  // _MADARA_NO_KARL_
+      print_prefix, &coalesced);
+
+  madara_logger_log(this->context_->get_logger(), logger::LOG_MAJOR,
+      "%s:"
+      " applied %d messages under one lock, coalescing %d stale values.\n",
+      print_prefix, (int)batch.size(), (int)coalesced);
+
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    MessageHeader* header = batch[i]->header;
+
+    if (header->ttl > 0 && rebroadcast_records[i].size() > 0 &&
+        settings_.get_participant_ttl() > 0)
+    {
+      --header->ttl;
+      header->ttl = std::min(settings_.get_participant_ttl(), header->ttl);
+
+      rebroadcast(print_prefix, header, rebroadcast_records[i]);
+    }
+  }
+}
+
+void UdpTransportReadThread::run(void)
+{
+  const QoSTransportSettings& settings_ = transport_.settings_;
+
+  if (settings_.no_receiving)
+  {
+    return;
+  }
+
+  // allocate a buffer to send
+  char* buffer = buffer_.get_ptr();
+  static const char print_prefix[] = "UdpTransportReadThread::run";
+
+  madara_logger_log(this->context_->get_logger(), logger::LOG_MINOR,
+      "%s:"
+      " entering main service loop.\n",
+      print_prefix);
 
-  std::stringstream remote_host;
-  remote_host << remote.address().to_string();
-  remote_host << ":";
-  remote_host << remote.port();
+  if (buffer == 0)
+  {
+    madara_logger_log(this->context_->get_logger(), logger::LOG_EMERGENCY,
+        "%s:"
+        " Unable to allocate buffer of size %" PRIu32 ". Exiting thread.\n",
+        print_prefix, settings_.queue_length);
+
+    return;
+  }
+
+  ReceivePipeline* pipeline = transport_.receive_pipeline_.get();
+  size_t bytes_read = 0;
+  std::string remote_host;
+
+  // with a pipeline, receive straight into a buffer it decodes from, and
+  // decoding and applying happen on the pipeline threads
+  if (pipeline)
+  {
+    std::vector<char> pooled = pipeline->acquire();
 
+    if (receive(pooled.data(), bytes_read, remote_host, print_prefix))
+    {
+      pipeline->push(std::move(pooled), (uint32_t)bytes_read, remote_host);
+    }
+    else
+    {
+      pipeline->recycle(std::move(pooled));
+    }
+
+    return;
+  }
+
+  if (settings_.coalesce_receives)
+  {
+    run_batch(buffer, print_prefix);
+
+    return;
+  }
+
+  if (!receive(buffer, bytes_read, remote_host, print_prefix))
+  {
+    return;
+  }
+
+  MessageHeader* header = 0;
   knowledge::KnowledgeMap rebroadcast_records;
 
   process_received_update(buffer, (uint32_t)bytes_read, transport_.id_,
@@ -233,7 +295,7 @@ void UdpTransportReadThread::run(void)
 #ifndef _MADARA_NO_KARL_
       on_data_received_,
 #endif  // _MADARA_NO_KARL_
-      print_prefix, remote_host.str().c_str(), header);
+      print_prefix, remote_host.c_str(), header);
 
   if (header)
   {
@@ -29,6 +29,9 @@ using udp = boost::asio::ip::udp;
 class UdpTransportReadThread : public threads::BaseThread
 {
 public:
+  /// the most messages decoded and applied together when coalescing
+  static const size_t max_batch = 64;
+
   UdpTransportReadThread(UdpTransport& transport);
 
   /**
@@ -59,6 +62,28 @@ public:
       const knowledge::KnowledgeMap& records);
 
 protected:
+  /**
+   * Receives a message from the socket and updates receive statistics
+   * @param  buffer        buffer of settings.queue_length bytes
+   * @param  bytes_read    the number of bytes received
+   * @param  remote_host   ip:port who sent the message
+   * @param  print_prefix  prefix to include before every log message
+   * @param  count_empty   if false, finding no message waiting is not
+   *                       counted as a failed receive, e.g., after the
+   *                       messages of a batch have been drained
+   * @return true if a message was received
+   **/
+  bool receive(char* buffer, size_t& bytes_read, std::string& remote_host,
+      const char* print_prefix, bool count_empty = true);
+
+  /**
+   * Decodes every message waiting on the socket, up to max_batch, and
+   * applies them under one context lock (@see coalesce_receives)
+   * @param  buffer        buffer of settings.queue_length bytes
+   * @param  print_prefix  prefix to include before every log message
+   **/
+  void run_batch(char* buffer, const char* print_prefix);
+
   UdpTransport& transport_;
 
   knowledge::ThreadSafeContext* context_ = nullptr;
@@ -10,7 +10,10 @@
  **/
 
 #include "madara/MadaraExport.h"
+#include "madara/utility/Utility.h"
 #include <atomic>
+#include <string>
+#include <vector>
 
 namespace madara
 {
@@ -77,6 +80,46 @@ private:
 };
 
 extern MADARA_EXPORT ZMQContext zmq_context;
+
+/**
+ * Builds the topic that messages of a domain, or of a variable prefix
+ * within a domain, are published on. ZMQ subscriptions match topics by
+ * prefix, so a subscription to the topic of a domain receives all of its
+ * prefixes, and the separator keeps one domain from matching another
+ * that it begins.
+ * @param   domain   the domain of the messages
+ * @param   prefix   the variable prefix of the updates, if partitioned
+ * @return  the topic
+ **/
+inline std::string zmq_topic(
+    const std::string& domain, const std::string& prefix = "")
+{
+  return domain + "/" + prefix;
+}
+
+/**
+ * Finds the topic prefix that a variable is published under, i.e., the
+ * longest of the prefixes that the variable begins with
+ * @param   key       the name of the variable
+ * @param   prefixes  the topic prefixes of the transport
+ * @return  the longest matching prefix, or "" for the domain topic
+ **/
+inline std::string zmq_topic_prefix(
+    const std::string& key, const std::vector<std::string>& prefixes)
+{
+  const std::string* match = 0;
+
+  for (auto& prefix : prefixes)
+  {
+    if (utility::begins_with(key, prefix) &&
+        (!match || prefix.size() > match->size()))
+    {
+      match = &prefix;
+    }
+  }
+
+  return match ? *match : "";
+}
 }
 }
 
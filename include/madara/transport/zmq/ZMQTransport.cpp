@@ -10,6 +10,7 @@
 #include "madara/transport/Fragmentation.h"
 
 #include <iostream>
+#include <map>
 #include "madara/utility/IntTypes.h"
 #include "ZMQContext.h"
 
@@ -250,57 +251,146 @@ int madara::transport::ZMQTransport::setup(void)
   return this->validate_transport();
 }
 
+long madara::transport::ZMQTransport::send_buffer(
+    const std::string& topic, long size)
+{
+  long result(0);
+
+  madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+      "ZMQTransport::send:"
+      " sending %d bytes on socket\n",
+      (int)size);
+
+  // subscribers filter on the topic frame before reading the payload
+  if (settings_.use_topics &&
+      zmq_send(write_socket_, topic.c_str(), topic.size(), ZMQ_SNDMORE) < 0)
+  {
+    result = -1;
+  }
+  else
+  {
+    // send the prepped buffer over ZeroMQ with timeout of 300ms
+    result =
+        (long)zmq_send(write_socket_, (void*)buffer_.get_ptr(), (size_t)size, 0);
+  }
+
+  if (result > 0)
+  {
+    if (settings_.debug_to_kb_prefix != "")
+    {
+      sent_data_ += result;
+      ++sent_packets_;
+      if (sent_data_max_ < result)
+      {
+        sent_data_max_ = result;
+      }
+      if (sent_data_min_ > result || sent_data_min_ == 0)
+      {
+        sent_data_min_ = result;
+      }
+    }
+
+    madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+        "ZMQTransport::send:"
+        " sent %d bytes on socket\n",
+        (int)result);
+  }
+  else
+  {
+    madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
+        "ZMQTransport::send:"
+        " failed to send message. Error code %d\n",
+        (int)result);
+  }
+
+  return result;
+}
+
 long madara::transport::ZMQTransport::send_data(
     const madara::knowledge::KnowledgeMap& orig_updates)
 {
   long result(0);
   const char* print_prefix = "ZMQTransport::send_data";
 
-  if (!settings_.no_sending)
+  if (settings_.no_sending)
+  {
+    return result;
+  }
+
+  if (!settings_.use_topics || settings_.topic_prefixes.size() == 0)
   {
     result = prep_send(orig_updates, print_prefix);
 
     if (settings_.hosts.size() > 0 && result > 0)
     {
-      madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
-          "ZMQTransport::send:"
-          " sending %d bytes on socket\n",
-          (int)result);
-
-      // send the prepped buffer over ZeroMQ with timeout of 300ms
-      result = (long)zmq_send(
-          write_socket_, (void*)buffer_.get_ptr(), (size_t)result, 0);
+      result = send_buffer(zmq_topic(settings_.write_domain), result);
 
       if (result > 0)
       {
-        if (settings_.debug_to_kb_prefix != "")
-        {
-          sent_data_ += result;
-          ++sent_packets_;
-          if (sent_data_max_ < result)
-          {
-            sent_data_max_ = result;
-          }
-          if (sent_data_min_ > result || sent_data_min_ == 0)
-          {
-            sent_data_min_ = result;
-          }
-        }
-
-        madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
-            "ZMQTransport::send:"
-            " sent %d bytes on socket\n",
-            (int)result);
+        confirm_sent();
       }
-      else
+    }
+
+    return result;
+  }
+
+  long error(0);
+
+  // partition the updates by the longest topic prefix they fall under,
+  // with updates outside all prefixes published on the domain topic
+  std::map<std::string, knowledge::KnowledgeMap> partitions;
+
+  for (auto& update : orig_updates)
+  {
+    partitions[zmq_topic_prefix(update.first, settings_.topic_prefixes)]
+        .insert(update);
+  }
+
+  // updates delayed by the bandwidth limit may belong to any partition
+  if (has_delayed_sends())
+  {
+    partitions[""];
+
+    for (auto& prefix : settings_.topic_prefixes)
+    {
+      partitions[prefix];
+    }
+  }
+
+  for (auto& partition : partitions)
+  {
+    const std::string& topic_prefix = partition.first;
+    const std::vector<std::string>& prefixes = settings_.topic_prefixes;
+
+    // only merge delayed updates that belong to this partition
+    delayed_filter_ = [&topic_prefix, &prefixes](const std::string& key) {
+      return zmq_topic_prefix(key, prefixes) == topic_prefix;
+    };
+
+    long prepped = prep_send(partition.second, print_prefix);
+
+    if (settings_.hosts.size() > 0 && prepped > 0)
+    {
+      prepped = send_buffer(
+          zmq_topic(settings_.write_domain, topic_prefix), prepped);
+
+      if (prepped > 0)
       {
-        madara_logger_log(context_.get_logger(), logger::LOG_MAJOR,
-            "ZMQTransport::send:"
-            " failed to send message. Error code %d\n",
-            (int)result);
+        confirm_sent();
       }
     }
+
+    if (prepped > 0)
+    {
+      result += prepped;
+    }
+    else if (prepped < 0)
+    {
+      error = prepped;
+    }
   }
 
-  return result;
+  delayed_filter_ = nullptr;
+
+  return result > 0 ? result : error;
 }
@@ -91,6 +91,14 @@ public:
   virtual int setup(void) override;
 
 private:
+  /**
+   * Sends the prepped buffer, preceded by a topic frame if topics are used
+   * @param   topic   the topic to publish on
+   * @param   size    the number of bytes in the buffer to send
+   * @return  bytes sent or a negative error code
+   **/
+  long send_buffer(const std::string& topic, long size);
+
   /// knowledge base for threads to use
   knowledge::KnowledgeBase knowledge_;
 
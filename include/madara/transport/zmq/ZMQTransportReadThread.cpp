@@ -6,7 +6,9 @@
 #include "ZMQContext.h"
 
 #include <iostream>
+#include <map>
 #include <algorithm>
+#include <vector>
 
 madara::transport::ZMQTransportReadThread::ZMQTransportReadThread(
     const TransportSettings& settings, const std::string& id,
@@ -73,21 +75,52 @@ void madara::transport::ZMQTransportReadThread::init(
           zmq_strerror(zmq_errno()));
     }
 
-    // subscribe to all messages
-    result = zmq_setsockopt(read_socket_, ZMQ_SUBSCRIBE, 0, 0);
+    std::vector<std::string> topics;
 
-    if (result == 0)
+    if (settings_.use_topics)
     {
-      madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
-          "ZMQTransportReadThread::init:"
-          " successfully set sockopt for ZMQ_SUBSCRIBE\n");
+      std::vector<std::string> domains;
+      settings_.get_read_domains(domains);
+
+      for (auto& domain : domains)
+      {
+        if (settings_.topic_prefixes.size() == 0)
+        {
+          topics.push_back(zmq_topic(domain));
+        }
+
+        for (auto& prefix : settings_.topic_prefixes)
+        {
+          topics.push_back(zmq_topic(domain, prefix));
+        }
+      }
     }
-    else
+
+    // without topics, subscribe to all messages
+    if (topics.size() == 0)
     {
-      madara_logger_log(context_->get_logger(), logger::LOG_ERROR,
-          "ZMQTransportReadThread::init:"
-          " ERROR: errno = %s\n",
-          zmq_strerror(zmq_errno()));
+      topics.push_back("");
+    }
+
+    for (auto& topic : topics)
+    {
+      result = zmq_setsockopt(
+          read_socket_, ZMQ_SUBSCRIBE, topic.c_str(), topic.size());
+
+      if (result == 0)
+      {
+        madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
+            "ZMQTransportReadThread::init:"
+            " successfully set sockopt for ZMQ_SUBSCRIBE to \"%s\"\n",
+            topic.c_str());
+      }
+      else
+      {
+        madara_logger_log(context_->get_logger(), logger::LOG_ERROR,
+            "ZMQTransportReadThread::init:"
+            " ERROR: errno = %s\n",
+            zmq_strerror(zmq_errno()));
+      }
     }
 
     // if you don't do this, ZMQ waits forever for no reason. Super smart.
@@ -246,33 +279,67 @@ void madara::transport::ZMQTransportReadThread::rebroadcast(
     const char* print_prefix, MessageHeader* header,
     const knowledge::KnowledgeMap& records)
 {
-  int64_t buffer_remaining = (int64_t)settings_.queue_length;
-  char* buffer = buffer_.get_ptr();
-  int result(0);
+  if (settings_.no_sending)
+  {
+    return;
+  }
+
+  // subscribers with topics only read messages that start with a topic
+  // frame, so partition the records by topic as ZMQTransport::send_data does
+  std::map<std::string, knowledge::KnowledgeMap> partitions;
+
+  if (settings_.use_topics)
+  {
+    for (auto& record : records)
+    {
+      partitions[zmq_topic_prefix(record.first, settings_.topic_prefixes)]
+          .insert(record);
+    }
+  }
+  else
+  {
+    partitions[""] = records;
+  }
 
-  if (!settings_.no_sending)
+  for (auto& partition : partitions)
   {
-    result = prep_rebroadcast(*context_, buffer, buffer_remaining, settings_,
-        print_prefix, header, records, packet_scheduler_);
+    int64_t buffer_remaining = (int64_t)settings_.queue_length;
+    char* buffer = buffer_.get_ptr();
 
-    if (result > 0)
+    int result = prep_rebroadcast(*context_, buffer, buffer_remaining,
+        settings_, print_prefix, header, partition.second, packet_scheduler_);
+
+    if (result > 0 && settings_.hosts.size() > 0)
     {
-      if (settings_.hosts.size() > 0 && result > 0)
+      madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
+          "ZMQTransportReadThread::send:"
+          " sending %d bytes on socket\n",
+          result);
+
+      if (settings_.use_topics)
       {
-        madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
-            "ZMQTransportReadThread::send:"
-            " sending %d bytes on socket\n",
-            result);
+        std::string topic = zmq_topic(header->domain, partition.first);
 
-        // send the prepped buffer over ZeroMQ
-        result = zmq_send(write_socket_, (void*)buffer_.get_ptr(),
-            (size_t)result, ZMQ_DONTWAIT);
+        if (zmq_send(write_socket_, topic.c_str(), topic.size(),
+                ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0)
+        {
+          madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
+              "ZMQTransportReadThread::send:"
+              " failed to send the topic frame of %s\n",
+              topic.c_str());
 
-        madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
-            "ZMQTransportReadThread::send:"
-            " sent %d bytes on socket\n",
-            result);
+          continue;
+        }
       }
+
+      // send the prepped buffer over ZeroMQ
+      result = zmq_send(write_socket_, (void*)buffer_.get_ptr(),
+          (size_t)result, ZMQ_DONTWAIT);
+
+      madara_logger_log(context_->get_logger(), logger::LOG_MAJOR,
+          "ZMQTransportReadThread::send:"
+          " sent %d bytes on socket\n",
+          result);
     }
   }
 }
@@ -313,6 +380,19 @@ void madara::transport::ZMQTransportReadThread::run(void)
     buffer_remaining =
         (int64_t)zmq_recv(read_socket_, (void*)buffer, zmq_buffer_size, 0);
 
+    int more = 0;
+    size_t more_size = sizeof(more);
+
+    // a message published on a topic starts with a topic frame that the
+    // subscription already matched, so read the payload that follows it
+    while (buffer_remaining >= 0 &&
+           zmq_getsockopt(read_socket_, ZMQ_RCVMORE, &more, &more_size) == 0 &&
+           more)
+    {
+      buffer_remaining =
+          (int64_t)zmq_recv(read_socket_, (void*)buffer, zmq_buffer_size, 0);
+    }
+
     madara_logger_log(context_->get_logger(), logger::LOG_MINOR,
         "%s:"
         " past recv on the socket.\n",
@@ -125,8 +125,7 @@ void madara::utility::Refcounter<T>::decrement(void)
 {
   if (ptr_)
   {
-    --ptr_->refcount_;
-    if (ptr_->refcount_ <= 0)
+    if (--ptr_->refcount_ <= 0)
     {
       delete ptr_;
       ptr_ = 0;
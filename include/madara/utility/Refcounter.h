@@ -2,6 +2,8 @@
 #ifndef _MADARA_UTILITY_REFCOUNTER_H_
 #define _MADARA_UTILITY_REFCOUNTER_H_
 
+#include <atomic>
+
 namespace madara
 {
 namespace utility
@@ -84,8 +86,9 @@ private:
     /// Pointer to the object that's being reference counted.
     T* t_;
 
-    /// Current value of the reference count.
-    int refcount_;
+    /// Current value of the reference count. Atomic, since shared trees
+    /// are copied by threads that do not hold the context lock.
+    std::atomic<int> refcount_;
   };
 
   /// Pointer to the @a Shim.
@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <cmath>
+#include <thread>
 
 namespace madara
 {
@@ -13,11 +14,53 @@ const double minrate = 0.0000000001;
 
 std::mutex SimTime::mutex_{};
 
-sim_time_callback_fn SimTime::callback_ = nullptr;
+std::atomic<sim_time_callback_fn> SimTime::callback_{nullptr};
 
-uint64_t SimTime::last_realtime_ = SimTime::realtime();
-uint64_t SimTime::last_simtime_ = -1;
-double SimTime::last_rate_ = 1.0;
+std::atomic<uint64_t> SimTime::sequence_{0};
+
+std::atomic<uint64_t> SimTime::last_realtime_{SimTime::realtime()};
+std::atomic<uint64_t> SimTime::last_simtime_{(uint64_t)-1};
+std::atomic<double> SimTime::last_rate_{1.0};
+
+void SimTime::store(uint64_t realtime, uint64_t simtime, double rate)
+{
+  uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+
+  // an odd sequence tells readers the parameters are changing
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  last_realtime_.store(realtime, std::memory_order_relaxed);
+  last_simtime_.store(simtime, std::memory_order_relaxed);
+  last_rate_.store(rate, std::memory_order_relaxed);
+
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void SimTime::snapshot(uint64_t& realtime, uint64_t& simtime, double& rate)
+{
+  for (;;)
+  {
+    uint64_t before = sequence_.load(std::memory_order_acquire);
+
+    if (before & 1)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    realtime = last_realtime_.load(std::memory_order_relaxed);
+    simtime = last_simtime_.load(std::memory_order_relaxed);
+    rate = last_rate_.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (sequence_.load(std::memory_order_relaxed) == before)
+    {
+      return;
+    }
+  }
+}
 
 uint64_t SimTime::realtime()
 {
@@ -32,30 +75,29 @@ uint64_t SimTime::realtime(uint64_t simtime)
   uint64_t prt;
   uint64_t pst;
   double pr;
-  sim_time_callback_fn callback;
+  bool queried = false;
 
+  // callbacks may not be thread-safe, so they are still called under lock
+  if (callback_.load(std::memory_order_acquire))
   {
     std::lock_guard<std::mutex> guard{mutex_};
-    callback = callback_;
+    sim_time_callback_fn callback = callback_.load(std::memory_order_relaxed);
+
     if (callback)
     {
-      uint64_t st;
-      double r;
-
-      callback_(&st, &r);
+      callback(&pst, &pr);
+      prt = realtime();
 
-      prt = last_realtime_ = realtime();
-      pst = last_simtime_ = st;
-      pr = last_rate_ = r;
-    }
-    else
-    {
-      prt = last_realtime_;
-      pst = last_simtime_;
-      pr = last_rate_;
+      store(prt, pst, pr);
+      queried = true;
     }
   }
 
+  if (!queried)
+  {
+    snapshot(prt, pst, pr);
+  }
+
   if (pst == (uint64_t)-1)
   {
     return simtime;
@@ -74,75 +116,65 @@ uint64_t SimTime::time()
   uint64_t prt;
   uint64_t pst;
   double pr;
-  uint64_t st;
-  double r;
-  sim_time_callback_fn callback;
 
   int64_t now = realtime();
+
+  if (callback_.load(std::memory_order_acquire))
   {
     std::lock_guard<std::mutex> guard{mutex_};
-    callback = callback_;
+    sim_time_callback_fn callback = callback_.load(std::memory_order_relaxed);
+
     if (callback)
     {
-      callback_(&st, &r);
+      uint64_t st;
+      double r;
 
-      last_realtime_ = now;
-      last_simtime_ = st;
-      last_rate_ = r;
-    }
-    else
-    {
-      prt = last_realtime_;
-      pst = last_simtime_;
-      pr = last_rate_;
+      callback(&st, &r);
+
+      store(now, st, r);
+
+      return st;
     }
   }
 
-  if (!callback)
-  {
-    if (pst == (uint64_t)-1)
-    {
-      return now;
-    }
-    if (pr == 0)
-    {
-      return pst;
-    }
+  snapshot(prt, pst, pr);
 
-    int64_t offset = now - prt;
+  if (pst == (uint64_t)-1)
+  {
+    return now;
+  }
+  if (pr == 0)
+  {
+    return pst;
+  }
 
-    if (pr < minrate)
-    {
-      pr = minrate;
-    }
+  int64_t offset = now - prt;
 
-    double delta = offset * pr;
-    st = pst + (int64_t)delta;
+  if (pr < minrate)
+  {
+    pr = minrate;
   }
 
-  return st;
+  double delta = offset * pr;
+  return pst + (int64_t)delta;
 }
 
 double SimTime::rate()
 {
-  double r;
-  sim_time_callback_fn callback;
-
+  if (callback_.load(std::memory_order_acquire))
   {
     std::lock_guard<std::mutex> guard{mutex_};
-    callback = callback_;
+    sim_time_callback_fn callback = callback_.load(std::memory_order_relaxed);
 
     if (callback)
     {
+      double r;
       callback(nullptr, &r);
-    }
-    else
-    {
-      r = last_rate_;
+      return r;
     }
   }
 
-  return r;
+  return last_rate_.load(std::memory_order_acquire);
 }
 
 uint64_t SimTime::duration(uint64_t sim_duration)
@@ -173,9 +205,7 @@ uint64_t SimTime::future(uint64_t sim_offset)
 sim_time_callback_fn set_sim_time_callback(sim_time_callback_fn fn)
 {
   std::lock_guard<std::mutex> guard{SimTime::mutex_};
-  using std::swap;
-  swap(fn, SimTime::callback_);
-  return fn;
+  return SimTime::callback_.exchange(fn, std::memory_order_acq_rel);
 }
 
 void sim_time_notify(uint64_t time, double rate)
@@ -191,21 +221,30 @@ void sim_time_notify(uint64_t time, double rate)
   uint64_t now = SimTime::realtime();
   std::lock_guard<std::mutex> guard{SimTime::mutex_};
 
+  // writers hold the mutex, so these loads cannot be torn
+  uint64_t last_realtime =
+      SimTime::last_realtime_.load(std::memory_order_relaxed);
+  uint64_t last_simtime =
+      SimTime::last_simtime_.load(std::memory_order_relaxed);
+  double last_rate = SimTime::last_rate_.load(std::memory_order_relaxed);
+
   if (update_time)
   {
-    SimTime::last_realtime_ = now;
-    SimTime::last_simtime_ = time;
+    last_realtime = now;
+    last_simtime = time;
   }
-  else if (SimTime::last_simtime_ == (uint64_t)-1)
+  else if (last_simtime == (uint64_t)-1)
   {
-    SimTime::last_realtime_ = now;
-    SimTime::last_simtime_ = now;
+    last_realtime = now;
+    last_simtime = now;
   }
 
   if (update_rate)
   {
-    SimTime::last_rate_ = rate;
+    last_rate = rate;
   }
+
+  SimTime::store(last_realtime, last_simtime, last_rate);
 }
 }
 }
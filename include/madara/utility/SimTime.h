@@ -2,6 +2,7 @@
 #define MADARA_UTILITY_SIMTIME_H_
 
 #ifdef __cplusplus
+#include <atomic>
 #include <mutex>
 #include <madara/MadaraExport.h>
 
@@ -45,27 +46,54 @@ MADARA_EXTERN_C const double minrate;
 #ifdef __cplusplus
 constexpr bool simtime = true;
 
+/**
+ * Sim time is read far more often than it is changed, e.g., on every
+ * packet and worker thread iteration, so readers take a consistent
+ * snapshot of the last parameters through a sequence lock instead of a
+ * mutex. Writers, which are notifications and callback queries, still
+ * serialize on a mutex, and bump the sequence to an odd number while
+ * they change the parameters. Readers retry if the sequence was odd or
+ * changed while they read.
+ **/
 class MADARA_EXPORT SimTime
 {
 private:
+  /// serializes writers and callback queries
   static std::mutex mutex_;
-  static sim_time_callback_fn callback_;
+  static std::atomic<sim_time_callback_fn> callback_;
+
+  /// odd while a writer is changing the parameters below
+  static std::atomic<uint64_t> sequence_;
 
-  static uint64_t last_realtime_;
-  static uint64_t last_simtime_;
-  static double last_rate_;
+  static std::atomic<uint64_t> last_realtime_;
+  static std::atomic<uint64_t> last_simtime_;
+  static std::atomic<double> last_rate_;
+
+  /**
+   * Changes the parameters. Must be called with mutex_ locked.
+   **/
+  static void store(uint64_t realtime, uint64_t simtime, double rate);
 
 public:
   SimTime() = delete;
 
+  /**
+   * Get a consistent snapshot of the last simtime parameters, without
+   * locking or calling the callback
+   * @param  realtime   the real time of the last update
+   * @param  simtime    the simtime of the last update, or -1 if simtime
+   *                    has not been set
+   * @param  rate       the last known rate
+   **/
+  static void snapshot(uint64_t& realtime, uint64_t& simtime, double& rate);
+
   /**
    * Get real time of last time simtime parameters were updated, either by a
    * notification, or by callback.
    **/
   static uint64_t last_realtime()
   {
-    std::lock_guard<std::mutex> guard(mutex_);
-    return last_realtime_;
+    return last_realtime_.load(std::memory_order_acquire);
   }
 
   /**
@@ -74,8 +102,7 @@ public:
    **/
   static uint64_t last_simtime()
   {
-    std::lock_guard<std::mutex> guard(mutex_);
-    return last_simtime_;
+    return last_simtime_.load(std::memory_order_acquire);
   }
 
   /**
@@ -83,8 +110,7 @@ public:
    **/
   static double last_rate()
   {
-    std::lock_guard<std::mutex> guard(mutex_);
-    return last_rate_;
+    return last_rate_.load(std::memory_order_acquire);
   }
 
   /**
@@ -1409,6 +1409,112 @@ jlongArray JNICALL Java_ai_madara_knowledge_KnowledgeBase_jni_1toKnowledgeList(
   return ret;
 }
 
+/**
+ * Copies a Java array of strings into a vector of names
+ **/
+static std::vector<std::string> to_names(JNIEnv* env, jobjectArray names)
+{
+  jsize len = env->GetArrayLength(names);
+  std::vector<std::string> result;
+  result.reserve(len);
+
+  for (jsize i = 0; i < len; ++i)
+  {
+    jstring name = (jstring)env->GetObjectArrayElement(names, i);
+    const char* nativeName = env->GetStringUTFChars(name, 0);
+
+    result.push_back(nativeName);
+
+    env->ReleaseStringUTFChars(name, nativeName);
+    env->DeleteLocalRef(name);
+  }
+
+  return result;
+}
+
+/*
+ * Class:   ai_madara_knowledge_KnowledgeBase
+ * Method:  jni_getAll
+ * Signature: (J[Ljava/lang/String;)[J
+ */
+jlongArray JNICALL Java_ai_madara_knowledge_KnowledgeBase_jni_1getAll(
+    JNIEnv* env, jobject, jlong cptr, jobjectArray names)
+{
+  KnowledgeBase* knowledge = (KnowledgeBase*)cptr;
+  jlongArray ret(0);
+
+  if (knowledge)
+  {
+    std::vector<madara::knowledge::KnowledgeRecord> values;
+
+    // all records are read in one lock of the context
+    knowledge->get_all(to_names(env, names), values);
+
+    ret = env->NewLongArray((jsize)values.size());
+    std::vector<jlong> records(values.size());
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      records[i] = (jlong) new madara::knowledge::KnowledgeRecord(
+          std::move(values[i]));
+    }
+
+    env->SetLongArrayRegion(ret, 0, (jsize)records.size(), records.data());
+  }
+  else
+  {
+    // user has tried to use a deleted object. Clean up and throw
+    madara::utility::java::throw_dead_obj_exception(env,
+        "KnowledgeBase::getAll: "
+        "KB object is released already");
+  }
+
+  return ret;
+}
+
+/*
+ * Class:   ai_madara_knowledge_KnowledgeBase
+ * Method:  jni_setAll
+ * Signature: (J[Ljava/lang/String;[JJ)V
+ */
+void JNICALL Java_ai_madara_knowledge_KnowledgeBase_jni_1setAll(JNIEnv* env,
+    jclass, jlong cptr, jobjectArray names, jlongArray records,
+    jlong settings_ptr)
+{
+  KnowledgeBase* knowledge = (KnowledgeBase*)cptr;
+  knowledge::EvalSettings* settings = (knowledge::EvalSettings*)settings_ptr;
+
+  if (knowledge && settings)
+  {
+    jsize len = env->GetArrayLength(records);
+    jlong* pointers = env->GetLongArrayElements(records, 0);
+
+    std::vector<madara::knowledge::KnowledgeRecord> values;
+    values.reserve(len);
+
+    for (jsize i = 0; i < len; ++i)
+    {
+      madara::knowledge::KnowledgeRecord* record =
+          (madara::knowledge::KnowledgeRecord*)pointers[i];
+
+      values.push_back(
+          record ? *record : madara::knowledge::KnowledgeRecord());
+    }
+
+    env->ReleaseLongArrayElements(records, pointers, JNI_ABORT);
+
+    // all records are set in one lock and sent once
+    knowledge->set_all(to_names(env, names), values, *settings);
+  }
+  else
+  {
+    // user has tried to use a deleted object. Clean up and throw
+    madara::utility::java::throw_dead_obj_exception(env,
+        "KnowledgeBase::setAll: "
+        "KB or settings objects are released already");
+  }
+}
+
 /*
  * Class:   ai_madara_knowledge_KnowledgeBase
  * Method:  jni_toKnowledgeMap
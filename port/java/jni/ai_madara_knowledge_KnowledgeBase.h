@@ -483,6 +483,23 @@ MADARA_EXPORT jlongArray JNICALL
 Java_ai_madara_knowledge_KnowledgeBase_jni_1toKnowledgeList(
     JNIEnv*, jobject, jlong, jstring, jint, jint);
 
+/*
+ * Class:     ai_madara_knowledge_KnowledgeBase
+ * Method:    jni_getAll
+ * Signature: (J[Ljava/lang/String;)[J
+ */
+MADARA_EXPORT jlongArray JNICALL
+Java_ai_madara_knowledge_KnowledgeBase_jni_1getAll(
+    JNIEnv*, jobject, jlong, jobjectArray);
+
+/*
+ * Class:     ai_madara_knowledge_KnowledgeBase
+ * Method:    jni_setAll
+ * Signature: (J[Ljava/lang/String;[JJ)V
+ */
+MADARA_EXPORT void JNICALL Java_ai_madara_knowledge_KnowledgeBase_jni_1setAll(
+    JNIEnv*, jclass, jlong, jobjectArray, jlongArray, jlong);
+
 /*
  * Class:     ai_madara_knowledge_KnowledgeBase
  * Method:    jni_saveContext
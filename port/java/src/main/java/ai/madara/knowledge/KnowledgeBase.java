@@ -149,6 +149,10 @@ public class KnowledgeBase extends MadaraJNI {
 
     private native long[] jni_toKnowledgeList(long cptr, String subject, int start, int end);
 
+    private native long[] jni_getAll(long cptr, String[] names);
+
+    private static native void jni_setAll(long cptr, String[] names, long[] records, long settings);
+
     private native void jni_toKnowledgeMap(long cptr, String expression, MapReturn ret);
 
     private native void jni_toMap(long cptr, String prefix, String suffix, MapReturn ret);
@@ -914,6 +918,60 @@ public class KnowledgeBase extends MadaraJNI {
       return new KnowledgeList(jni_toKnowledgeList(getCPtr(), subject, start, end));
     }
 
+    /**
+     * Retrieves several knowledge values in one lock of the knowledge base,
+     * so no update from the network lands between the reads.
+     * <br>
+     * <br>
+     * The returned {@link ai.madara.knowledge.KnowledgeList KnowledgeList}
+     * <b>must</b> be freed using {@link ai.madara.knowledge.KnowledgeList#free
+     * KnowledgeList.free ()} before the object goes out of scope.
+     *
+     * @param names knowledge names
+     * @return {@link ai.madara.knowledge.KnowledgeList KnowledgeList} containing
+     *         the values in the order of the names
+     * @throws MadaraDeadObjectException throws exception if object is already
+     *                                   released
+     **/
+    public KnowledgeList getAll(String[] names) throws MadaraDeadObjectException {
+      return new KnowledgeList(jni_getAll(getCPtr(), names));
+    }
+
+    /**
+     * Sets several knowledge values in one lock of the knowledge base and
+     * sends them together.
+     *
+     * @param names  knowledge names
+     * @param values values to set, in the order of the names
+     * @throws MadaraDeadObjectException throws exception if object is already
+     *                                   released
+     **/
+    public void setAll(String[] names, KnowledgeRecord[] values)
+        throws MadaraDeadObjectException {
+      setAll(names, values, EvalSettings.DEFAULT_EVAL_SETTINGS);
+    }
+
+    /**
+     * Sets several knowledge values in one lock of the knowledge base and
+     * sends them together.
+     *
+     * @param names    knowledge names
+     * @param values   values to set, in the order of the names
+     * @param settings settings for applying the update
+     * @throws MadaraDeadObjectException throws exception if object is already
+     *                                   released
+     **/
+    public void setAll(String[] names, KnowledgeRecord[] values,
+        EvalSettings settings) throws MadaraDeadObjectException {
+      long[] records = new long[values.length];
+
+      for (int i = 0; i < values.length; ++i) {
+        records[i] = values[i].getCPtr();
+      }
+
+      jni_setAll(getCPtr(), names, records, settings.getCPtr());
+    }
+
     /**
      * Saves the knowledge base to a file
      * 
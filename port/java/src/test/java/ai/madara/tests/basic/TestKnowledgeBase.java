@@ -52,7 +52,9 @@ import org.junit.Test;
 
 import ai.madara.exceptions.MadaraDeadObjectException;
 import ai.madara.knowledge.KnowledgeBase;
+import ai.madara.knowledge.KnowledgeList;
 import ai.madara.knowledge.KnowledgeMap;
+import ai.madara.knowledge.KnowledgeRecord;
 import ai.madara.knowledge.containers.Integer;
 import ai.madara.knowledge.containers.String;
 import ai.madara.tests.BaseTest;
@@ -109,4 +111,29 @@ public class TestKnowledgeBase extends BaseTest {
 		Assert.assertEquals(clonedKb.get("age").toLong(), defaultKb.get("age").toLong());
 	}
 
+	@Test
+	public void testKBGetSetMany() throws MadaraDeadObjectException {
+		KnowledgeBase knowledge = initKnowledgeBase();
+
+		java.lang.String[] names = { "pose.x", "pose.y", "battery", "mission" };
+		KnowledgeRecord[] values = { new KnowledgeRecord(1.5), new KnowledgeRecord(2.5),
+				new KnowledgeRecord(87), new KnowledgeRecord("patrol") };
+
+		knowledge.setAll(names, values);
+
+		for (KnowledgeRecord value : values) {
+			value.free();
+		}
+
+		KnowledgeList results = knowledge.getAll(names);
+
+		Assert.assertEquals(4, results.size());
+		Assert.assertEquals(1.5, results.get(0).toDouble(), 0.0);
+		Assert.assertEquals(2.5, results.get(1).toDouble(), 0.0);
+		Assert.assertEquals(87, results.get(2).toLong());
+		Assert.assertEquals("patrol", results.get(3).toString());
+
+		results.free();
+	}
+
 }
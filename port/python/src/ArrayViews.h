@@ -0,0 +1,369 @@
+#ifndef _MADARA_PYTHON_PORT_ARRAY_VIEWS_H_
+#define _MADARA_PYTHON_PORT_ARRAY_VIEWS_H_
+
+/**
+ * @file ArrayViews.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains zero-copy Python buffer views over the shared
+ * integer and double arrays held by KnowledgeRecords, and helpers for
+ * bulk-setting records from contiguous Python buffers (e.g., NumPy arrays).
+ * Views implement the Python buffer protocol, so numpy.asarray (view)
+ * produces a read-only ndarray that references the KB's memory directly.
+ **/
+
+#include <boost/python/detail/wrap_python.hpp>
+#include <boost/python/class.hpp>
+#include <boost/python/errors.hpp>
+#include <boost/python/extract.hpp>
+
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "madara/knowledge/KnowledgeRecord.h"
+
+namespace madara
+{
+namespace python
+{
+/**
+ * @class ArrayView
+ * @brief A read-only view of an array shared from a KnowledgeRecord. The
+ *        view holds the shared_ptr, so the underlying memory stays valid
+ *        for as long as any Python object (e.g., an ndarray) references it,
+ *        even if the record is later overwritten in the knowledge base.
+ **/
+template<typename T>
+class ArrayView
+{
+public:
+  /**
+   * Default constructor creates an empty view
+   **/
+  ArrayView() : shape_(0), stride_(sizeof(T)) {}
+
+  /**
+   * Constructor
+   * @param  data   the shared array to view
+   **/
+  explicit ArrayView(std::shared_ptr<const std::vector<T>> data)
+    : data_(std::move(data)),
+      shape_(data_ ? (Py_ssize_t)data_->size() : 0),
+      stride_(sizeof(T))
+  {
+  }
+
+  /**
+   * Returns the number of elements in the view
+   **/
+  size_t size(void) const
+  {
+    return (size_t)shape_;
+  }
+
+  /**
+   * Returns an element of the view
+   * @param  index   the element index. Negative indices count from the end
+   **/
+  T get(Py_ssize_t index) const
+  {
+    if (index < 0)
+      index += shape_;
+
+    if (index < 0 || index >= shape_)
+    {
+      PyErr_SetString(PyExc_IndexError, "ArrayView index out of range");
+      boost::python::throw_error_already_set();
+    }
+
+    return (*data_)[(size_t)index];
+  }
+
+  /**
+   * Returns the shared_ptr backing this view
+   **/
+  const std::shared_ptr<const std::vector<T>>& share(void) const
+  {
+    return data_;
+  }
+
+  /**
+   * Implementation of the Python buffer protocol (bf_getbuffer)
+   **/
+  static int get_buffer(PyObject* self, Py_buffer* view, int flags);
+
+  /**
+   * Python buffer format character for the element type
+   **/
+  static const char* format(void);
+
+  /**
+   * Registers the view class with Boost.Python and installs the buffer
+   * protocol on the resulting Python type
+   * @param  name   the Python class name
+   * @param  doc    the Python class documentation
+   **/
+  static void define(const char* name, const char* doc);
+
+private:
+  /// the array that is being viewed
+  std::shared_ptr<const std::vector<T>> data_;
+
+  /// the buffer shape (number of elements)
+  Py_ssize_t shape_;
+
+  /// the buffer stride (size of an element)
+  Py_ssize_t stride_;
+};
+
+template<>
+inline const char* ArrayView<double>::format(void)
+{
+  return "d";
+}
+
+template<>
+inline const char* ArrayView<knowledge::KnowledgeRecord::Integer>::format(
+    void)
+{
+  return "q";
+}
+
+template<typename T>
+inline int ArrayView<T>::get_buffer(PyObject* self, Py_buffer* view, int flags)
+{
+  if (view == nullptr)
+  {
+    PyErr_SetString(PyExc_BufferError, "ArrayView: null Py_buffer");
+    return -1;
+  }
+
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+  {
+    PyErr_SetString(PyExc_BufferError,
+        "ArrayView is read-only. Copy the array (e.g., numpy.array (view)) "
+        "to modify it and write it back with set_array");
+    view->obj = nullptr;
+    return -1;
+  }
+
+  boost::python::extract<ArrayView<T>&> extractor(self);
+
+  if (!extractor.check())
+  {
+    PyErr_SetString(PyExc_BufferError, "ArrayView: invalid object");
+    view->obj = nullptr;
+    return -1;
+  }
+
+  ArrayView<T>& source = extractor();
+
+  static const T empty = T();
+
+  view->obj = self;
+  view->buf = source.data_ && source.shape_ > 0 ?
+                  (void*)source.data_->data() :
+                  (void*)&empty;
+  view->len = source.shape_ * (Py_ssize_t)sizeof(T);
+  view->readonly = 1;
+  view->itemsize = sizeof(T);
+  view->format = (flags & PyBUF_FORMAT) ? (char*)format() : nullptr;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) ? &source.shape_ : nullptr;
+  view->strides =
+      (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &source.stride_ : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  Py_INCREF(self);
+
+  return 0;
+}
+
+template<typename T>
+inline void ArrayView<T>::define(const char* name, const char* doc)
+{
+  using namespace boost::python;
+
+  static PyBufferProcs procs = {&ArrayView<T>::get_buffer, nullptr};
+
+  class_<ArrayView<T>> view_class(name, doc, init<>());
+
+  view_class
+      .def("__len__", &ArrayView<T>::size,
+          "Returns the number of elements in the view")
+
+      .def("__getitem__", &ArrayView<T>::get,
+          "Returns an element of the view")
+
+      .def("size", &ArrayView<T>::size,
+          "Returns the number of elements in the view");
+
+  // Boost.Python does not expose the buffer protocol, so install it on the
+  // generated heap type directly
+  PyTypeObject* type = reinterpret_cast<PyTypeObject*>(view_class.ptr());
+  type->tp_as_buffer = &procs;
+}
+
+/**
+ * RAII wrapper around a contiguous Python buffer
+ **/
+class ContiguousBuffer
+{
+public:
+  /**
+   * Acquires a C-contiguous, formatted buffer from a Python object
+   * @param  source   any object supporting the buffer protocol
+   **/
+  explicit ContiguousBuffer(PyObject* source)
+  {
+    if (PyObject_GetBuffer(
+            source, &buffer_, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
+    {
+      boost::python::throw_error_already_set();
+    }
+  }
+
+  ~ContiguousBuffer()
+  {
+    PyBuffer_Release(&buffer_);
+  }
+
+  /**
+   * Returns the number of elements in the buffer
+   **/
+  size_t size(void) const
+  {
+    return buffer_.itemsize > 0 ? (size_t)(buffer_.len / buffer_.itemsize) :
+                                  0;
+  }
+
+  /**
+   * Checks if the buffer holds native 8-byte floating point elements
+   **/
+  bool is_doubles(void) const
+  {
+    return buffer_.itemsize == sizeof(double) && type_code() == 'd';
+  }
+
+  /**
+   * Checks if the buffer holds native 8-byte signed integer elements
+   **/
+  bool is_integers(void) const
+  {
+    char code = type_code();
+    return buffer_.itemsize == sizeof(knowledge::KnowledgeRecord::Integer) &&
+           (code == 'q' || code == 'l');
+  }
+
+  /**
+   * Returns a pointer to the first element
+   **/
+  template<typename T>
+  const T* data(void) const
+  {
+    return static_cast<const T*>(buffer_.buf);
+  }
+
+private:
+  /**
+   * Returns the struct-module type code, ignoring native byte order marks
+   **/
+  char type_code(void) const
+  {
+    const char* format = buffer_.format ? buffer_.format : "B";
+
+    if (*format == '@' || *format == '=' ||
+        (*format == '<' && is_little_endian()) ||
+        (*format == '>' && !is_little_endian()))
+    {
+      ++format;
+    }
+
+    return format[1] == 0 ? format[0] : 0;
+  }
+
+  static bool is_little_endian(void)
+  {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+  }
+
+  /// the acquired buffer
+  Py_buffer buffer_;
+};
+
+/**
+ * Copies a contiguous Python buffer of int64 or float64 elements into a
+ * record with a single bulk copy (no per-element Python conversion)
+ * @param  record   the record to set
+ * @param  source   an object supporting the buffer protocol
+ **/
+inline void set_record_from_buffer(
+    knowledge::KnowledgeRecord& record, boost::python::object source)
+{
+  ContiguousBuffer buffer(source.ptr());
+  size_t size = buffer.size();
+
+  if (buffer.is_doubles())
+  {
+    const double* data = buffer.data<double>();
+    record.set_value(std::vector<double>(data, data + size));
+  }
+  else if (buffer.is_integers())
+  {
+    typedef knowledge::KnowledgeRecord::Integer Integer;
+
+    const Integer* data = buffer.data<Integer>();
+    record.set_value(std::vector<Integer>(data, data + size));
+  }
+  else
+  {
+    PyErr_SetString(PyExc_TypeError,
+        "set_array requires a contiguous float64 or int64 buffer. "
+        "Convert with numpy.ascontiguousarray (array, dtype=...) first");
+    boost::python::throw_error_already_set();
+  }
+}
+
+/**
+ * Returns a view of a record's doubles. If the record is not a double
+ * array, the view holds a converted copy instead of the record's memory.
+ * @param  record   the record to view
+ **/
+inline ArrayView<double> view_doubles(const knowledge::KnowledgeRecord& record)
+{
+  std::shared_ptr<const std::vector<double>> data = record.share_doubles();
+
+  if (!data)
+  {
+    data = std::make_shared<const std::vector<double>>(record.to_doubles());
+  }
+
+  return ArrayView<double>(std::move(data));
+}
+
+/**
+ * Returns a view of a record's integers. If the record is not an integer
+ * array, the view holds a converted copy instead of the record's memory.
+ * @param  record   the record to view
+ **/
+inline ArrayView<knowledge::KnowledgeRecord::Integer> view_integers(
+    const knowledge::KnowledgeRecord& record)
+{
+  typedef knowledge::KnowledgeRecord::Integer Integer;
+
+  std::shared_ptr<const std::vector<Integer>> data = record.share_integers();
+
+  if (!data)
+  {
+    data = std::make_shared<const std::vector<Integer>>(record.to_integers());
+  }
+
+  return ArrayView<Integer>(std::move(data));
+}
+}
+}
+
+#endif  // _MADARA_PYTHON_PORT_ARRAY_VIEWS_H_
@@ -33,7 +33,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_to_string_0_of_1, to_string, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_get_1_of_2, get, 1, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(
-    m_send_modifieds_0_of_2, send_modifieds, 0, 2)
+    m_load_as_json_1_of_2, load_as_json, 1, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(
     m_load_context_1_of_2, load_context, 1, 2)
@@ -47,8 +47,6 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_set_index_2_of_3, set_index, 3, 4)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_eval_1_of_2, evaluate, 1, 2)
 
-BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_wait_1_of_2, wait, 1, 2)
-
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_print_1_of_2, print, 1, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(m_print_0_of_1, print, 0, 1)
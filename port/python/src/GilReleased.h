@@ -0,0 +1,94 @@
+#ifndef _MADARA_PYTHON_PORT_GIL_RELEASED_H_
+#define _MADARA_PYTHON_PORT_GIL_RELEASED_H_
+
+/**
+ * @file GilReleased.h
+ * @author James Edmondson <jedmondson@gmail.com>
+ *
+ * This file contains helpers for binding C++ methods that lock a
+ * knowledge context. MADARA threads that call into Python (functions,
+ * filters) hold the context lock and then acquire the GIL, so every
+ * binding that locks a context must release the GIL before it does.
+ * Otherwise, a Python thread holding the GIL and waiting on the context
+ * lock deadlocks against a MADARA thread holding the context lock and
+ * waiting on the GIL.
+ **/
+
+#include <utility>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/python/Release_GIL.h"
+
+/**
+ * Wraps a member function so that the Python GIL is released for the
+ * duration of the C++ call. Arguments are converted from Python before
+ * the GIL is released and the result is converted after it is reacquired.
+ **/
+template<typename Method, Method method>
+struct GilReleased;
+
+template<typename R, typename C, typename... Args, R (C::*method)(Args...)>
+struct GilReleased<R (C::*)(Args...), method>
+{
+  static R call(C& self, Args... args)
+  {
+    madara::python::Release_GIL release_gil;
+    return (self.*method)(std::forward<Args>(args)...);
+  }
+};
+
+template<typename R, typename C, typename... Args,
+    R (C::*method)(Args...) const>
+struct GilReleased<R (C::*)(Args...) const, method>
+{
+  static R call(const C& self, Args... args)
+  {
+    madara::python::Release_GIL release_gil;
+    return (self.*method)(std::forward<Args>(args)...);
+  }
+};
+
+/**
+ * Shorthand for the GilReleased wrapper of a member function that is not
+ * overloaded. Overloaded members name their signature explicitly:
+ * &GilReleased<signature, &Class::method>::call
+ **/
+#define MADARA_GIL_RELEASED(method) \
+  &GilReleased<decltype(&method), &method>::call
+
+/**
+ * Calls a function with the Python GIL released
+ **/
+template<typename Callable>
+auto call_without_gil(Callable callable) -> decltype(callable())
+{
+  madara::python::Release_GIL release_gil;
+  return callable();
+}
+
+/**
+ * Calls a function that must touch Python objects (e.g., copy a Python
+ * callable into the context) while holding the context lock. The GIL is
+ * released while waiting for the context lock and reacquired afterwards,
+ * which keeps the context-then-GIL order used by MADARA threads.
+ **/
+template<typename Callable>
+auto call_with_context_locked(
+    madara::knowledge::KnowledgeBase& kb, Callable callable)
+    -> decltype(callable())
+{
+  call_without_gil([&] { kb.lock(); });
+
+  struct Unlocker
+  {
+    madara::knowledge::KnowledgeBase& kb;
+    ~Unlocker()
+    {
+      kb.unlock();
+    }
+  } unlocker{kb};
+
+  return callable();
+}
+
+#endif  // _MADARA_PYTHON_PORT_GIL_RELEASED_H_
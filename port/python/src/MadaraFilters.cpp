@@ -16,6 +16,7 @@
 
 #ifdef _USE_SSL_
 #include "madara/filters/ssl/AESBufferFilter.h"
+#include "madara/filters/ssl/AESGCMBufferFilter.h"
 #endif
 
 #ifdef _USE_LZ4_
@@ -135,12 +136,37 @@ void define_filters(void)
       // Clears the rebroadcast filters for a specified type
       .def("generate_key", &madara::filters::AESBufferFilter::generate_key,
           "Generates a new key for AES 256 bit encryption based on a password");
+
+  class_<madara::filters::AESGCMBufferFilter,
+      bases<madara::filters::BufferFilter> >("AESGCMBufferFilter",
+      "Filter for encrypting, decrypting and authenticating buffers using "
+      "AES-256-GCM",
+      init<>())
+      .def("generate_key", &madara::filters::AESGCMBufferFilter::generate_key,
+          "Generates a new key for AES-256-GCM based on a password");
 #endif
 
 #ifdef _USE_LZ4_
   class_<madara::filters::LZ4BufferFilter,
       bases<madara::filters::BufferFilter> >("LZ4BufferFilter",
-      "Filter for compressing and decompressing buffers using LZ4 ", init<>());
+      "Filter for compressing and decompressing buffers using LZ4 ", init<>())
+      .def("set_dictionary", &madara::filters::LZ4BufferFilter::set_dictionary,
+          "Sets the dictionary to compress and decompress with")
+      .def("get_dictionary", &madara::filters::LZ4BufferFilter::get_dictionary,
+          "Gets the dictionary to compress and decompress with")
+      .def("get_raw_count", &madara::filters::LZ4BufferFilter::get_raw_count,
+          "Gets the number of payloads that were sent uncompressed")
+      .def_readwrite("acceleration",
+          &madara::filters::LZ4BufferFilter::acceleration,
+          "LZ4 acceleration. Higher values compress faster but less")
+      .def_readwrite("min_size", &madara::filters::LZ4BufferFilter::min_size,
+          "Payloads smaller than this are sent uncompressed")
+      .def_readwrite("skip_after",
+          &madara::filters::LZ4BufferFilter::skip_after,
+          "Incompressible payloads in a row before skipping compression")
+      .def_readwrite("skip_count",
+          &madara::filters::LZ4BufferFilter::skip_count,
+          "Payloads to send uncompressed once skipping starts");
 #endif
 }
 
@@ -14,6 +14,8 @@
 #include "madara/knowledge/CheckpointPlayer.h"
 #include "madara/filters/GenericFilters.h"
 #include "FunctionDefaults.h"
+#include "GilReleased.h"
+#include "ArrayViews.h"
 #include "MadaraKnowledgeContainers.h"
 #include "MadaraKnowledge.h"
 
@@ -73,6 +75,38 @@ struct DontDestruct
   }
 };
 
+/**
+ * Sets a KB variable from a contiguous float64 or int64 buffer with a
+ * single bulk copy (no per-element Python conversion). The buffer is
+ * held while the GIL is released for the copy into the context.
+ **/
+static int kb_set_array(madara::knowledge::KnowledgeBase& kb,
+    const std::string& key, object source,
+    const madara::knowledge::EvalSettings& settings)
+{
+  madara::python::ContiguousBuffer buffer(source.ptr());
+  uint32_t size = (uint32_t)buffer.size();
+
+  if (buffer.is_doubles())
+  {
+    const double* data = buffer.data<double>();
+    return call_without_gil([&] { return kb.set(key, data, size, settings); });
+  }
+  else if (buffer.is_integers())
+  {
+    const madara::knowledge::KnowledgeRecord::Integer* data =
+        buffer.data<madara::knowledge::KnowledgeRecord::Integer>();
+    return call_without_gil([&] { return kb.set(key, data, size, settings); });
+  }
+
+  PyErr_SetString(PyExc_TypeError,
+      "set_array requires a contiguous float64 or int64 buffer. "
+      "Convert with numpy.ascontiguousarray (array, dtype=...) first");
+  throw_error_already_set();
+
+  return -1;
+}
+
 void define_knowledge(void)
 {
   object ke = object(handle<>(PyModule_New("madara.knowledge")));
@@ -116,6 +150,11 @@ void define_knowledge(void)
           &madara::knowledge::CheckpointSettings::filename,
           "the path and name of the file to load/save")
 
+      .def_readwrite("format_threads",
+          &madara::knowledge::CheckpointSettings::format_threads,
+          "if greater than one, save_as_karl and save_as_json format a "
+          "snapshot in shards on this many threads")
+
       .def_readwrite("ignore_header_check",
           &madara::knowledge::CheckpointSettings::ignore_header_check,
           "If true, do not perform a header check. This is useful if you are"
@@ -141,6 +180,11 @@ void define_knowledge(void)
           "attempt to keep the file open for later usage (not really "
           "recommended)")
 
+      .def_readwrite("keyframe_interval",
+          &madara::knowledge::CheckpointSettings::keyframe_interval,
+          "if non-zero, save_checkpoint writes every variable as every "
+          "keyframe_interval-th state and only changes in between")
+
       .def_readwrite("last_lamport_clock",
           &madara::knowledge::CheckpointSettings::last_lamport_clock,
           "final lamport clock in the checkpoint")
@@ -184,6 +228,16 @@ void define_knowledge(void)
           "if true, resets the checkpoint to start a new diff from this point "
           "on")
 
+      .def_readwrite("seek_keyframe",
+          &madara::knowledge::CheckpointSettings::seek_keyframe,
+          "if true, loads begin at the last keyframe at or before "
+          "initial_state, reconstructing the knowledge of initial_state")
+
+      .def_readwrite("snapshot",
+          &madara::knowledge::CheckpointSettings::snapshot,
+          "if true, saves copy records out under the context lock and "
+          "encode and write them after releasing it")
+
       .def_readwrite("states", &madara::knowledge::CheckpointSettings::states,
           "the number of states checkpointed in the file stream")
 
@@ -278,6 +332,15 @@ void define_knowledge(void)
 
       ;
 
+  madara::python::ArrayView<double>::define("DoublesView",
+      "Read-only, zero-copy view of a shared double array. Supports the "
+      "buffer protocol, so numpy.asarray (view) does not copy the data");
+
+  madara::python::ArrayView<madara::knowledge::KnowledgeRecord::Integer>::
+      define("IntegersView",
+          "Read-only, zero-copy view of a shared integer array. Supports the "
+          "buffer protocol, so numpy.asarray (view) does not copy the data");
+
   class_<madara::knowledge::KnowledgeRecord>(
       "KnowledgeRecord", "Basic unit of knowledge", init<>())
 
@@ -373,6 +436,11 @@ void define_knowledge(void)
       .def("is_true", &madara::knowledge::KnowledgeRecord::is_true,
           "Checks if the record is true")
 
+      // sets the value from a contiguous buffer (e.g., numpy array)
+      .def("set_array", &madara::python::set_record_from_buffer,
+          "Sets the value to an array from a contiguous float64 or int64 "
+          "buffer (e.g., a numpy array) with one bulk copy")
+
       // sets the contents of the record as a file
       .def("read_file", &madara::knowledge::KnowledgeRecord::read_file,
           m_read_file_1_of_2(args("filename", "read_as_type"),
@@ -599,6 +667,19 @@ void define_knowledge(void)
           "If this record holds a shared_ptr, make a copy of the underlying"
           "value so it has an exclusive copy")
 
+      // zero-copy view of a double array
+      .def("view_doubles", &madara::python::view_doubles,
+          "Returns a read-only DoublesView sharing the record's double array. "
+          "Use numpy.asarray on the result for a zero-copy ndarray. If the "
+          "record is not a double array, the view holds a converted copy")
+
+      // zero-copy view of an integer array
+      .def("view_integers", &madara::python::view_integers,
+          "Returns a read-only IntegersView sharing the record's integer "
+          "array. Use numpy.asarray on the result for a zero-copy ndarray. If "
+          "the record is not an integer array, the view holds a converted "
+          "copy")
+
       // overloaded operators
       .def(self < self)
       .def(self <= self)
@@ -842,15 +923,18 @@ void define_knowledge(void)
   class_<madara::knowledge::Variables>("Variables", init<>())
 
       // add list of current modified list
-      .def("add_modifieds", &madara::knowledge::KnowledgeBase::add_modifieds,
+      .def("add_modifieds",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::add_modifieds),
           "Adds a list of VariableReferences to the current modified list")
 
       // modifies all global variables
-      .def("apply_modified", &madara::knowledge::Variables::apply_modified,
+      .def("apply_modified",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::apply_modified),
           "Applies modified to all global variables")
 
       // compile prototype
-      .def("compile", &madara::knowledge::Variables::compile,
+      .def("compile",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::compile),
           "Compiles a KaRL expression into an expression tree. Always do this"
           "before calling evaluate because it puts the expression into an"
           "optimized format. Best practice is to save the CompiledExpression"
@@ -862,207 +946,227 @@ void define_knowledge(void)
 
       // decrements the value of a variable
       .def("dec",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const std::string&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::dec),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::dec>::call,
           "Atomically decrements the value of the variable")
 
       // decrements the value of a variable
       .def("dec",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::dec),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::dec>::call,
           "Atomically decrements the value of the variable")
 
       // evaluate an expression
       .def("evaluate",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const std::string&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::evaluate),
-          m_eval_1_of_2(
-              args("expression", "settings"), "Evaluates an expression"))
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::evaluate>::call,
+          (arg("self"), arg("expression"),
+              arg("settings") = KnowledgeUpdateSettings()),
+          "Evaluates an expression")
 
       // evaluate an expression
       .def("evaluate",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(
               madara::knowledge::CompiledExpression&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::evaluate),
-          m_eval_1_of_2(
-              args("expression", "settings"), "Evaluates an expression"))
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::evaluate>::call,
+          (arg("self"), arg("expression"),
+              arg("settings") = KnowledgeUpdateSettings()),
+          "Evaluates an expression")
 
       // check to see if variable exists
       .def("exists",
-          static_cast<bool (madara::knowledge::Variables::*)(const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::Variables::exists),
+          &GilReleased<bool (madara::knowledge::Variables::*)(
+                           const std::string&,
+                           const madara::knowledge::KnowledgeReferenceSettings&)
+                           const,
+              &madara::knowledge::Variables::exists>::call,
           "Checks if a knowledge location exists in the context")
 
       // check to see if variable exists
       .def("exists",
-          static_cast<bool (madara::knowledge::Variables::*)(
+          &GilReleased<bool (madara::knowledge::Variables::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::Variables::exists),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::Variables::exists>::call,
           "Checks if a knowledge variable exists in the context")
 
       // prints all knowledge variables
-      .def("expand_statement", &madara::knowledge::Variables::expand_statement,
+      .def("expand_statement",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::expand_statement),
           "Expand a statement")
 
       // get a knowledge record
       .def("get",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::Variables::get),
-          m_get_1_of_2(
-              args("key", "settings"), "Retrieves the value of a variable"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::Variables::get>::call,
+          (arg("self"), arg("key"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves the value of a variable")
 
       // get a knowledge record
       .def("get",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::Variables::get),
-          m_get_1_of_2(args("variable", "settings"),
-              "Retrieves the value of a variable"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::Variables::get>::call,
+          (arg("self"), arg("variable"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves the value of a variable")
 
       // converts to a string
-      .def("get_ref", &madara::knowledge::Variables::get_ref,
+      .def("get_ref",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::get_ref),
           "Retrieves the value of a variable")
 
       // get matches in an iterable form
-      .def("get_matches", &madara::knowledge::Variables::get_matches,
+      .def("get_matches",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::get_matches),
           "Creates an iteration of VariableReferences to all keys matching"
           "the prefix and suffix")
 
       // increments the value of a variable
       .def("inc",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const std::string&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::inc),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::inc>::call,
           "Atomically increments the value of the variable")
 
       // increments the value of a variable
       .def("inc",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::inc),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::inc>::call,
           "Atomically increments the value of the variable")
 
       // Loads the context from a file
-      .def("load_context", &madara::knowledge::Variables::load_context,
+      .def("load_context",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::load_context),
           "Loads the context from a file")
 
       // print statement
       .def("print",
-          static_cast<void (madara::knowledge::Variables::*)(unsigned int)
-                  const>(&madara::knowledge::Variables::print),
+          &GilReleased<void (madara::knowledge::Variables::*)(unsigned int)
+                  const,
+              &madara::knowledge::Variables::print>::call,
           "Prints all knowledge in the context")
 
       // print statement
       .def("print",
-          static_cast<void (madara::knowledge::Variables::*)(const std::string&,
-              unsigned int) const>(&madara::knowledge::Variables::print),
+          &GilReleased<void (madara::knowledge::Variables::*)(
+                           const std::string&, unsigned int) const,
+              &madara::knowledge::Variables::print>::call,
           "Prints a statement")
 
       // get a knowledge record at an index
       .def("retrieve_index",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const std::string&, size_t,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::Variables::retrieve_index),
-          m_retrieve_index_2_of_3(args("key", "index", "settings"),
-              "Retrieves a knowledge record from an index"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::Variables::retrieve_index>::call,
+          (arg("self"), arg("key"), arg("index"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves a knowledge record from an index")
 
       // get a knowledge record at an index
       .def("retrieve_index",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::Variables::*)(const VariableReference&, size_t,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::Variables::retrieve_index),
-          m_retrieve_index_2_of_3(args("key", "index", "settings"),
-              "Retrieves a knowledge record from an index"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::Variables::retrieve_index>::call,
+          (arg("self"), arg("variable"), arg("index"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves a knowledge record from an index")
 
       // save context file to karl
-      .def("save_as_karl", &madara::knowledge::Variables::save_as_karl,
+      .def("save_as_karl",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::save_as_karl),
           "Saves the context to a file as karl assignments, rather than binary")
 
       // save a checkpoint to a file
-      .def("save_checkpoint", &madara::knowledge::Variables::save_checkpoint,
+      .def("save_checkpoint",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::save_checkpoint),
           "Saves a checkpoint of a list of changes to a file")
 
       // save context to a file
-      .def("save_context", &madara::knowledge::Variables::save_context,
+      .def("save_context",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::save_context),
           "Saves the context to a file")
 
       // sets a knowledge record to a double
       .def("set",
-          static_cast<int (madara::knowledge::Variables::*)(const std::string&,
-              double, const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::set),
+          &GilReleased<int (madara::knowledge::Variables::*)(const std::string&,
+              double, const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::set>::call,
           "sets a knowledge record to a double")
 
       // sets a knowledge record to an array of doubles
       .def("set",
-          static_cast<int (madara::knowledge::Variables::*)(const std::string&,
+          &GilReleased<int (madara::knowledge::Variables::*)(const std::string&,
               const std::vector<double>&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::set),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::set>::call,
           "sets a knowledge record to an array of doubles")
 
       // sets a knowledge record to an integer
       .def("set",
-          static_cast<int (madara::knowledge::Variables::*)(const std::string&,
+          &GilReleased<int (madara::knowledge::Variables::*)(const std::string&,
               madara::knowledge::KnowledgeRecord::Integer,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::set),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::set>::call,
           "sets a knowledge record to a integer")
 
       // sets a knowledge record to an array of integer
       .def("set",
-          static_cast<int (madara::knowledge::Variables::*)(const std::string&,
+          &GilReleased<int (madara::knowledge::Variables::*)(const std::string&,
               const std::vector<madara::knowledge::KnowledgeRecord::Integer>&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::set),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::set>::call,
           "sets a knowledge record to an array of integers")
 
       // sets a knowledge record to a string
       .def("set",
-          static_cast<int (madara::knowledge::Variables::*)(const std::string&,
+          &GilReleased<int (madara::knowledge::Variables::*)(const std::string&,
               const std::string&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::Variables::set),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::Variables::set>::call,
           "sets a knowledge record to a string")
 
       // fill a variable map with knowledge records
-      .def("to_map", &madara::knowledge::Variables::to_map,
+      .def("to_map", MADARA_GIL_RELEASED(madara::knowledge::Variables::to_map),
           "Fills a variable map with Knowledge Records that match an "
           "expression."
           "At the moment, this expression must be of the form 'subject'")
 
       // converts to a string
-      .def("to_string", &madara::knowledge::Variables::to_string,
+      .def("to_string",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::to_string),
           "Converts to string")
 
       // fill a vector with knowledge records
-      .def("to_vector", &madara::knowledge::Variables::to_vector,
+      .def("to_vector",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::to_vector),
           "Fills a vector with Knowledge Records that begin with a common "
           "subject"
           "and have a finite range of integer values")
 
       // write a file to a location
-      .def("write_file", &madara::knowledge::Variables::write_file,
+      .def("write_file",
+          MADARA_GIL_RELEASED(madara::knowledge::Variables::write_file),
           "Write a file from the context to a specified location")
 
       ;
@@ -1079,30 +1183,36 @@ void define_knowledge(void)
 
       // builds a fragment request vector
       .def("build_fragment_request",
-          &madara::knowledge::FileRequester::build_fragment_request,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::FileRequester::build_fragment_request),
           "Builds an arry of the request that is necessary under "
           "the current max_fragments")
 
       // clears the fragments on the file system
       .def("clear_fragments",
-          &madara::knowledge::FileRequester::clear_fragments,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::FileRequester::clear_fragments),
           "Clears any lingering fragments on the file system.")
 
       // gets the crc
-      .def("get_crc", &madara::knowledge::FileRequester::get_crc,
+      .def("get_crc",
+          MADARA_GIL_RELEASED(madara::knowledge::FileRequester::get_crc),
           "Retrieves the file CRC from the KB")
 
       // gets the filename
-      .def("get_filename", &madara::knowledge::FileRequester::get_filename,
+      .def("get_filename",
+          MADARA_GIL_RELEASED(madara::knowledge::FileRequester::get_filename),
           "Returns the name of the file being reconstructed")
 
       // gets the percentage of completion
       .def("get_percent_complete",
-          &madara::knowledge::FileRequester::get_percent_complete,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::FileRequester::get_percent_complete),
           "Returns the percentage of completion")
 
       // gets the size
-      .def("get_size", &madara::knowledge::FileRequester::get_size,
+      .def("get_size",
+          MADARA_GIL_RELEASED(madara::knowledge::FileRequester::get_size),
           "Retrieves the file size from the KB")
 
       // initializes the object
@@ -1113,20 +1223,22 @@ void define_knowledge(void)
       //     "max_fragment_requests"), "Initialize the requester object"))
 
       .def("init",
-          static_cast<void (madara::knowledge::FileRequester::*)(
+          &GilReleased<void (madara::knowledge::FileRequester::*)(
               const std::string&, const std::string&, const std::string&,
-              madara::knowledge::KnowledgeBase, int)>(
-              &madara::knowledge::FileRequester::init),
-          m_init_4_of_5(args("prefix", "sync_key", "filename", "kb",
-                            "max_fragment_requests"),
-              "Initialize the requester object"))
+              madara::knowledge::KnowledgeBase, int),
+              &madara::knowledge::FileRequester::init>::call,
+          (arg("self"), arg("prefix"), arg("sync_key"), arg("filename"),
+              arg("kb"), arg("max_fragment_requests") = -1),
+          "Initialize the requester object")
 
       // modifies the file sync key
-      .def("modify", &madara::knowledge::FileRequester::modify,
+      .def("modify",
+          MADARA_GIL_RELEASED(madara::knowledge::FileRequester::modify),
           "Modifies the current sync key to mark the request ready to resend")
 
       // checks if a request is needed and builds the request
-      .def("needs_request", &madara::knowledge::FileRequester::needs_request,
+      .def("needs_request",
+          MADARA_GIL_RELEASED(madara::knowledge::FileRequester::needs_request),
           "Checks if a new request is necessary and builds the sync request. "
           "Note that the caller must call kb.send_modifieds to send the "
           "request.")
@@ -1148,47 +1260,54 @@ void define_knowledge(void)
       .def(init<const madara::knowledge::KnowledgeBase&>())
 
       // acquire recursive lock on KB
-      .def("acquire", &madara::knowledge::KnowledgeBase::acquire,
+      .def("acquire",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::acquire),
           "Acquires the recursive lock on the knowledge base. This will"
           "block any other thread from updating or using the knowledge"
           "base until you call @ release")
 
       // starts the transport mechanism
       .def("activate_transport",
-          &madara::knowledge::KnowledgeBase::activate_transport,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::activate_transport),
           "Starts the transport mechanism for dissemination if it is closed")
 
       // apply current time to all global variables
-      .def("apply_modified", &madara::knowledge::KnowledgeBase::apply_modified,
+      .def("apply_modified",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::apply_modified),
           "Applies current time and modified to all global variables and tries"
           "to send them")
 
       // attach logger for printing
-      .def("attach_logger", &madara::knowledge::KnowledgeBase::attach_logger,
+      .def("attach_logger",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::attach_logger),
           "Attaches a logger to be used for printing")
 
       // attach a transport to knowledge engine
       .def("attach_transport",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
-              madara::transport::Base * transport)>(
-              &madara::knowledge::KnowledgeBase::attach_transport),
+          &GilReleased<size_t (madara::knowledge::KnowledgeBase::*)(
+              madara::transport::Base * transport),
+              &madara::knowledge::KnowledgeBase::attach_transport>::call,
           "Attaches a transport to the Knowledge Engine. Note that the"
           "transport should use the same ThreadSafeContext as the"
           "Knowledge Engine")
 
-      // attach a transport to knowledge engine with specific setting
+      // attach a transport to knowledge engine with specific setting. The
+      // settings may hold Python filters, which are copied with the GIL
       .def("attach_transport",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, madara::transport::TransportSettings&)>(
-              &madara::knowledge::KnowledgeBase::attach_transport),
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& id,
+               madara::transport::TransportSettings& settings) {
+            return call_with_context_locked(
+                kb, [&] { return kb.attach_transport(id, settings); });
+          },
           "Adds a built-in transport with the specified settings")
 
       // clear a variable
       .def("clear",
-          static_cast<bool (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<bool (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::KnowledgeBase::clear),
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::KnowledgeBase::clear>::call,
           "Clears a variable. This is safer than erasing the variable."
           "It clears the memory used in the variable and marks it as UNCREATED,"
           "meaning that it is effectively deleted, will not show up in"
@@ -1196,32 +1315,34 @@ void define_knowledge(void)
 
       // Clears the whole knowledge base
       .def("clear",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(bool erase)>(
-              &madara::knowledge::KnowledgeBase::clear),
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(bool erase),
+              &madara::knowledge::KnowledgeBase::clear>::call,
           "Clears the knowledge base")
 
       // clear history record
       .def("clear_history",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::clear_history),
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
+              const std::string&, const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::clear_history>::call,
           "Clear all history for this record, keeping the current value")
 
       // clear history record
       .def("clear_history",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::clear_history),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::clear_history>::call,
           "Clear all history for this record, keeping the current value")
 
       // clear the KB
-      .def("clear_map", &madara::knowledge::KnowledgeBase::clear_map,
+      .def("clear_map",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::clear_map),
           "Clears the knowledge base")
 
       // clear all modifications to KB
       .def("clear_modifieds",
-          &madara::knowledge::KnowledgeBase::clear_modifieds,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::clear_modifieds),
           "Clear all modifications to the knowledge base. This action may"
           "be useful if you are wanting to keep local changes but not"
           "inform other agents (possibly due to a need to further process"
@@ -1230,16 +1351,18 @@ void define_knowledge(void)
 
       // close the transport mechanism
       .def("close_transport",
-          &madara::knowledge::KnowledgeBase::close_transport,
-          "Closes the transport mechanism so no dissemination is possible")
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(void),
+              &madara::knowledge::KnowledgeBase::close_transport>::call,
+          "Closes the transport mechanism so no dissemination is possible. "
+          "Releases the GIL while transport threads are joined")
 
       // copy variables and values to a context
       .def("copy",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::KnowledgeBase&,
               const madara::knowledge::KnowledgeRequirements&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::copy),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::copy>::call,
           "Copies variables and values from source to this context."
           "PERFORMANCE NOTES: predicates with prefixes can limit"
           "copying to O(log n). predices with suffixes and no prefix"
@@ -1247,11 +1370,11 @@ void define_knowledge(void)
 
       // copy variables and values to a context
       .def("copy",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::KnowledgeBase&,
               const madara::knowledge::CopySet&, bool clean_copy,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::copy),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::copy>::call,
           "Copies variables and values from source to this context. PERFORMANCE"
           "NOTES: worst case depends on size of copy_set. If empty, performance"
           "is always O (n), where n is number of variables in the source "
@@ -1261,308 +1384,374 @@ void define_knowledge(void)
           "the source context")
 
       // compile KaRL expression
-      .def("compile", &madara::knowledge::KnowledgeBase::compile,
+      .def("compile",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::compile),
           "Compiles a KaRL expression into an expression tree")
 
       // expands a statement with variable expansion
       .def("debug_modifieds",
-          &madara::knowledge::KnowledgeBase::debug_modifieds,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::debug_modifieds),
           "Retrieves a stringified list of all modified variables that are "
           "ready"
           "to send over transport on next send_modifieds call")
 
-      // defines a python function
+      // defines a python function. The callable is copied with the GIL
       .def("define_function",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, object)>(
-              &madara::knowledge::KnowledgeBase::define_function),
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& name,
+               object callable) {
+            call_with_context_locked(
+                kb, [&] { kb.define_function(name, callable); });
+          },
           "defines a named function that can be called within evaluates")
 
       // defines a python function
       .def("define_function",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, const std::string&)>(
-              &madara::knowledge::KnowledgeBase::define_function),
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
+              const std::string&, const std::string&),
+              &madara::knowledge::KnowledgeBase::define_function>::call,
           "Defines a MADARA KaRL function")
 
       // defines a python function
       .def("define_function",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::CompiledExpression&)>(
-              &madara::knowledge::KnowledgeBase::define_function),
+              const madara::knowledge::CompiledExpression&),
+              &madara::knowledge::KnowledgeBase::define_function>::call,
           "Defines a MADARA KaRL function")
 
-      // evaluate an expression
+      // evaluate an expression (GIL released during evaluation)
       .def("evaluate",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::KnowledgeBase::*)(
-              const std::string&, const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::evaluate),
-          m_eval_1_of_2(
-              args("expression", "settings"), "Evaluates an expression"))
+          +[](madara::knowledge::KnowledgeBase& kb,
+               const std::string& expression) {
+            return call_without_gil([&] { return kb.evaluate(expression); });
+          },
+          "Evaluates an expression")
 
-      // evaluate an expression
+      // evaluate an expression (GIL released during evaluation)
       .def("evaluate",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::KnowledgeBase::*)(
-              madara::knowledge::CompiledExpression&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::evaluate),
-          m_eval_1_of_2(
-              args("expression", "settings"), "Evaluates an expression"))
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           const std::string&,
+                           const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::evaluate>::call,
+          (arg("self"), arg("expression"), arg("settings")),
+          "Evaluates an expression")
+
+      // evaluate an expression (GIL released during evaluation)
+      .def("evaluate",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               madara::knowledge::CompiledExpression& expression) {
+            return call_without_gil([&] { return kb.evaluate(expression); });
+          },
+          "Evaluates an expression")
 
-      // Evaluates a root-based tree
+      // evaluate an expression (GIL released during evaluation)
       .def("evaluate",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::KnowledgeBase::*)(
-              madara::expression::ComponentNode * root,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::evaluate),
-          m_eval_1_of_2(args("expression", "settings"),
-              "Evaluates a root-based tree (result of compile)"))
-
-      // load and evaluate KaRL file
-      .def("evaluate_file", &madara::knowledge::KnowledgeBase::evaluate_file,
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           madara::knowledge::CompiledExpression&,
+                           const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::evaluate>::call,
+          (arg("self"), arg("expression"), arg("settings")),
+          "Evaluates an expression")
+
+      // Evaluates a root-based tree (GIL released during evaluation)
+      .def("evaluate",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               madara::expression::ComponentNode* root) {
+            return call_without_gil([&] { return kb.evaluate(root); });
+          },
+          "Evaluates a root-based tree (result of compile)")
+
+      // Evaluates a root-based tree (GIL released during evaluation)
+      .def("evaluate",
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           madara::expression::ComponentNode*,
+                           const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::evaluate>::call,
+          (arg("self"), arg("expression"), arg("settings")),
+          "Evaluates a root-based tree (result of compile)")
+
+      // load and evaluate KaRL file (GIL released during evaluation)
+      .def("evaluate_file",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               madara::knowledge::CheckpointSettings& settings) {
+            return call_without_gil(
+                [&] { return kb.evaluate_file(settings); });
+          },
+          "Loads and evaluates a karl script from a file")
+
+      // load and evaluate KaRL file (GIL released during evaluation)
+      .def("evaluate_file",
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           madara::knowledge::CheckpointSettings&,
+                           const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::evaluate_file>::call,
           "Loads and evaluates a karl script from a file")
 
       // check if a knowledge location exists
       .def("exists",
-          static_cast<bool (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<bool (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::exists),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::exists>::call,
           "Checks if a knowledge location exists in the context")
 
       // check if a knowledge location exists
       .def("exists",
-          static_cast<bool (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<bool (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::exists),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::exists>::call,
           "Checks if a knowledge location exists in the context")
 
       // expands a statement with variable expansion
       .def("expand_statement",
-          &madara::knowledge::KnowledgeBase::expand_statement,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::expand_statement),
           "Expand a statement")
 
       // wait for a change to happen
-      .def("facade_for", &madara::knowledge::KnowledgeBase::facade_for,
+      .def("facade_for",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::facade_for),
           "Change the knowledge base to become a facade for another context."
           "It is extremely important that the context stays within scope for"
           "the duration of the life of this Knowledge Base. Otherwise, the"
           "Knowledge Base will eventually point to invalid memory")
 
       // convert file to string
-      .def("file_to_string", &madara::knowledge::KnowledgeBase::file_to_string,
+      .def("file_to_string",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::file_to_string),
           "Loads and returns a karl script from a file with encode/decode")
 
       // Retrieve a knowledge value
       .def("get",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::KnowledgeBase::*)(const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::KnowledgeBase::get),
-          m_get_1_of_2(args("key", "settings"), "Retrieves a knowledge value"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::KnowledgeBase::get>::call,
+          (arg("self"), arg("key"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves a knowledge value")
 
       // get a knowledge record
       .def("get",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::KnowledgeBase::get),
-          m_get_1_of_2(args("variable", "settings"),
-              "Atomically returns the value of a variable."))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::KnowledgeBase::get>::call,
+          (arg("self"), arg("variable"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Atomically returns the value of a variable.")
+
+      // read several variables in one lock
+      .def("get_all",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               const std::vector<std::string>& keys) {
+            std::vector<madara::knowledge::KnowledgeRecord> values;
+            call_without_gil([&] { kb.get_all(keys, values); });
+            return values;
+          },
+          "Atomically reads several variables in one lock of the context, "
+          "so no update lands between the reads. Returns a "
+          "KnowledgeRecordVector in the order of the keys")
 
       // get entire stored history
       .def("get_history",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Get a copy of the entire stored history of this record")
 
       // get range of history
       .def("get_history",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(const std::string&,
               size_t index, size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Return a copy of the given range of history in a vector. Indexing"
           "starts from oldest history entry in the buffer at index 0. Negative"
           "indices count from newest entries (-1 is newest)")
 
       // get history at certain index
       .def("get_history",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const std::string&, size_t index,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Return the given entry in this record's history. Indexing"
           "starts from oldest history entry in the buffer at index 0. Negative"
           "indices count from newest entries (-1 is newest)")
 
       // get entire history
       .def("get_history",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Get a copy of the entire stored history of this record")
 
       // get history within a range
       .def("get_history",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, size_t index,
               size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Return a copy of the given range of history in a vector. Indexing"
           "starts from oldest history entry in the buffer at index 0. Negative"
           "indices count from newest entries (-1 is newest)")
 
       // get history at a given entry
       .def("get_history",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, size_t index,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history>::call,
           "Return the given entry in this record's history. Indexing"
           "starts from oldest history entry in the buffer at index 0. Negative"
           "indices count from newest entries (-1 is newest)")
 
       // get history size
       .def("get_history_size",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<size_t (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history_size),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history_size>::call,
           "Return the amount of history this record holds")
 
       // get history size
       .def("get_history_size",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<size_t (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history_size),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history_size>::call,
           "Return the amount of history this record holds")
 
       // get history capacity
       .def("get_history_capacity",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<size_t (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history_capacity),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history_capacity>::call,
           "Return the maximum amount of history this record can hold. Use"
           "set_history_capacity to adjust this")
 
       // get history capacity
       .def("get_history_capacity",
-          static_cast<size_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<size_t (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_history_capacity),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_history_capacity>::call,
           "Return the maximum amount of history this record can hold. Use"
           "set_history_capacity to adjust this")
 
       // return unique host
-      .def("get_id", &madara::knowledge::KnowledgeBase::get_id,
+      .def("get_id",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::get_id),
           "Returns the unique host and ephemeral binding for this Knowlede "
           "Base")
 
       // get log level
-      .def("get_log_level", &madara::knowledge::KnowledgeBase::get_log_level,
+      .def("get_log_level",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::get_log_level),
           "Gets the log level")
 
       // get matching variables
-      .def("get_matches", &madara::knowledge::KnowledgeBase::get_matches,
+      .def("get_matches",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::get_matches),
           "Creates an iteration of VariableReferences to all keys matching"
           "the prefix and suffix")
 
       // get newest history entry for record
       .def("get_newest",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_newest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_newest>::call,
           "Return the newest stored history entry of this record")
 
       // get newest history entry for record
       .def("get_newest",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(const std::string&,
               size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_newest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_newest>::call,
           "Return the @a count newest stored history entries of this record in"
           "a vector")
 
       // get newest history entry for record
       .def("get_newest",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_newest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_newest>::call,
           "Return the newest stored history entry of this record")
 
       // get newest history entry for record
       .def("get_newest",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_newest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_newest>::call,
           "Return the @a count newest stored history entries of this record in"
           "a vector")
 
       // get the number of transports
       .def("get_num_transports",
-          &madara::knowledge::KnowledgeBase::get_num_transports,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::get_num_transports),
           "Gets the number of transports")
 
       // get oldest history entry for record
       .def("get_oldest",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_oldest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_oldest>::call,
           "Return the oldest stored history entry of this record")
 
       // get oldest history entry for record
       .def("get_oldest",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(const std::string&,
               size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_oldest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_oldest>::call,
           "Return the @a count oldest stored history entries of this record in"
           "a vector")
 
       // get oldest history entry for record
       .def("get_oldest",
-          static_cast<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<KnowledgeRecord (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_oldest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_oldest>::call,
           "Return the oldest stored history entry of this record")
 
       // get oldest history entry for record
       .def("get_oldest",
-          static_cast<std::vector<KnowledgeRecord> (
+          &GilReleased<std::vector<KnowledgeRecord> (
               madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, size_t count,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::get_oldest),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::get_oldest>::call,
           "Return the @a count oldest stored history entries of this record in"
           "a vector")
 
       // return a reference to a variable
-      .def("get_ref", &madara::knowledge::KnowledgeBase::get_ref,
+      .def("get_ref",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::get_ref),
           "Atomically returns a reference to the variable. Variable references "
           "are"
           "efficient mechanisms for reference variables individually--similar "
@@ -1571,207 +1760,249 @@ void define_knowledge(void)
 
       // see if there is history in KB
       .def("has_history",
-          static_cast<bool (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<bool (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::has_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::has_history>::call,
           "Return true if this record has a circular buffer history. Use"
           "set_history_capacity to add a buffer")
 
       // see if there is history in KB
       .def("has_history",
-          static_cast<bool (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<bool (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeReferenceSettings&) const>(
-              &madara::knowledge::KnowledgeBase::has_history),
+              const madara::knowledge::KnowledgeReferenceSettings&) const,
+              &madara::knowledge::KnowledgeBase::has_history>::call,
           "Return true if this record has a circular buffer history. Use"
           "set_history_capacity to add a buffer")
 
       // expands and prints a statement
       .def("load_context",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
               const std::string&, bool,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::KnowledgeBase::load_context),
-          m_load_context_1_of_3(args("filename", "use_id", "settings"),
-              "Loads a variable context from a file"))
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::load_context>::call,
+          (arg("self"), arg("filename"), arg("use_id") = true,
+              arg("settings") =
+                  KnowledgeUpdateSettings(true, true, true, false)),
+          "Loads a variable context from a file")
 
       // expands and prints a statement
       .def("load_context",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
               const std::string&, FileHeader&, bool use_id,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::KnowledgeBase::load_context),
-          m_load_context_1_of_3(args("filename", "use_id", "settings"),
-              "Loads a variable context from a file"))
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::load_context>::call,
+          (arg("self"), arg("filename"), arg("meta"), arg("use_id") = true,
+              arg("settings") =
+                  KnowledgeUpdateSettings(true, true, true, false)),
+          "Loads a variable context from a file")
 
       // expands and prints a statement
       .def("load_context",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
               madara::knowledge::CheckpointSettings&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::KnowledgeBase::load_context),
-          m_load_context_1_of_2(args("checkpoint_settings", "update_settings"),
-              "Loads a variable context from a file with settings "
-              "for checkpoint and knowledge updates"))
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::load_context>::call,
+          (arg("self"), arg("checkpoint_settings"),
+              arg("update_settings") =
+                  KnowledgeUpdateSettings(true, true, true, false)),
+          "Loads a variable context from a file with settings "
+          "for checkpoint and knowledge updates")
+
+      // loads json without evaluating it as karl
+      .def("load_as_json",
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const std::string&,
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::load_as_json>::call,
+          (arg("self"), arg("filename"),
+              arg("settings") =
+                  KnowledgeUpdateSettings(true, true, true, false)),
+          "Loads a JSON file, e.g., from save_as_json")
+
+      // loads json without evaluating it as karl
+      .def("load_as_json",
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              madara::knowledge::CheckpointSettings&,
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::load_as_json>::call,
+          (arg("self"), arg("checkpoint_settings"),
+              arg("update_settings") =
+                  KnowledgeUpdateSettings(true, true, true, false)),
+          "Loads a JSON file with settings for the file and for "
+          "knowledge updates")
 
       // locks the knowledge base from updates from other threads
-      .def("lock", &madara::knowledge::KnowledgeBase::lock,
+      .def("lock", MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::lock),
           "Locks the knowledge base from updates from other threads")
 
       // mark a variable as modified
       .def("mark_modified",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::KnowledgeBase::mark_modified),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::mark_modified>::call,
           "Marks the variable reference as updated")
 
       // mark a variable as modified
       .def("mark_modified",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
-              const madara::knowledge::KnowledgeUpdateSettings&)>(
-              &madara::knowledge::KnowledgeBase::mark_modified),
+              const madara::knowledge::KnowledgeUpdateSettings&),
+              &madara::knowledge::KnowledgeBase::mark_modified>::call,
           "Marks the variable as updated")
 
       // same as apply_modified
-      .def("modify", &madara::knowledge::KnowledgeBase::modify,
+      .def("modify",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::modify),
           "Alias for apply_modified. @see apply_modified")
 
       // evaluate an expression
       .def("print",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(unsigned int)
-                  const>(&madara::knowledge::KnowledgeBase::print),
-          m_print_0_of_1(
-              args("level"), "Prints all variables in the knowledge base"))
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(unsigned int)
+                  const,
+              &madara::knowledge::KnowledgeBase::print>::call,
+          (arg("self"), arg("level") = 0),
+          "Prints all variables in the knowledge base")
 
       // evaluate an expression
       .def("print",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, unsigned int) const>(
-              &madara::knowledge::KnowledgeBase::print),
-          m_print_1_of_2(
-              args("statement", "level"), "Expands and prints a statement"))
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
+              const std::string&, unsigned int) const,
+              &madara::knowledge::KnowledgeBase::print>::call,
+          (arg("self"), arg("statement"), arg("level") = 0),
+          "Expands and prints a statement")
 
       // prints all knowledge variables
       .def("print_knowledge",
-          &madara::knowledge::KnowledgeBase::print_knowledge,
-          m_print_knowledge_0_of_1(args("level"), "Alias of print(level). "
-                                                  "Prints all variables in the "
-                                                  "knowledge base"))
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::print_knowledge),
+          (arg("self"), arg("level") = 0),
+          "Alias of print(level). "
+          "Prints all variables in the "
+          "knowledge base")
 
       // evaluate an expression
       .def("read_file",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, const std::string&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::read_file),
-          m_read_file_2_of_3(args("knowledge_key", "filename", "settings"),
-              "Read a file into the knowledge base"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::read_file>::call,
+          (arg("self"), arg("knowledge_key"), arg("filename"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Read a file into the knowledge base")
 
       // evaluate an expression
       .def("read_file",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, const std::string&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::read_file),
-          m_read_file_2_of_3(args("variable", "filename", "settings"),
-              "Read a file into the knowledge base"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::read_file>::call,
+          (arg("self"), arg("variable"), arg("filename"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Read a file into the knowledge base")
 
       // releases a recursive lock on KB
-      .def("release", &madara::knowledge::KnowledgeBase::release,
+      .def("release",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::release),
           "Releases a recursive lock on the knowledge base. This will"
           "allow other thread to access the knowledge base if you had"
           "previously called @ acquire")
 
       // removes transport
       .def("remove_transport",
-          &madara::knowledge::KnowledgeBase::remove_transport,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::remove_transport),
           "Removes a transport")
 
       // reset the checkpoint
       .def("reset_checkpoint",
-          &madara::knowledge::KnowledgeBase::reset_checkpoint,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::reset_checkpoint),
           "Resets the local changed map, which tracks checkpointing modifieds")
 
       // get a knowledge record at an index
       .def("retrieve_index",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::KnowledgeBase::*)(const std::string&, size_t,
-              const madara::knowledge::KnowledgeReferenceSettings&)>(
-              &madara::knowledge::KnowledgeBase::retrieve_index),
-          m_retrieve_index_2_of_3(args("key", "index", "settings"),
-              "Retrieves a knowledge record from an index"))
+              const madara::knowledge::KnowledgeReferenceSettings&),
+              &madara::knowledge::KnowledgeBase::retrieve_index>::call,
+          (arg("self"), arg("key"), arg("index"),
+              arg("settings") = KnowledgeReferenceSettings(false)),
+          "Retrieves a knowledge record from an index")
 
       // saves the context as JSON
       .def("save_as_json",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const std::string&) const>(
-              &madara::knowledge::KnowledgeBase::save_as_json),
-          m_save_as_json_1_of_1(
-              args("settings"), "Saves the context to a file as JSON"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const std::string&) const,
+              &madara::knowledge::KnowledgeBase::save_as_json>::call,
+          (arg("self"), arg("filename")),
+          "Saves the context to a file as JSON")
 
       // saves the context as JSON
       .def("save_as_json",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const madara::knowledge::CheckpointSettings&) const>(
-              &madara::knowledge::KnowledgeBase::save_as_json),
-          m_save_as_json_1_of_1(
-              args("settings"), "Saves the context to a file as JSON"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const madara::knowledge::CheckpointSettings&) const,
+              &madara::knowledge::KnowledgeBase::save_as_json>::call,
+          (arg("self"), arg("settings")),
+          "Saves the context to a file as JSON")
 
       // saves the context as karl
       .def("save_as_karl",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const std::string&) const>(
-              &madara::knowledge::KnowledgeBase::save_as_karl),
-          m_save_as_karl_1_of_1(args("settings"), "Saves the context to a file "
-                                                  "as karl assignments, rather "
-                                                  "than binary"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const std::string&) const,
+              &madara::knowledge::KnowledgeBase::save_as_karl>::call,
+          (arg("self"), arg("filename")),
+          "Saves the context to a file "
+          "as karl assignments, rather "
+          "than binary")
 
       // saves the context as karl
       .def("save_as_karl",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const madara::knowledge::CheckpointSettings&) const>(
-              &madara::knowledge::KnowledgeBase::save_as_karl),
-          m_save_as_karl_1_of_1(args("settings"), "Saves the context to a file "
-                                                  "as karl assignments, rather "
-                                                  "than binary"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const madara::knowledge::CheckpointSettings&) const,
+              &madara::knowledge::KnowledgeBase::save_as_karl>::call,
+          (arg("self"), arg("settings")),
+          "Saves the context to a file "
+          "as karl assignments, rather "
+          "than binary")
 
       // saves a diff of the context as binary
       .def("save_checkpoint",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, bool reset_modifieds)>(
-              &madara::knowledge::KnowledgeBase::save_checkpoint),
-          m_save_checkpoint_1_of_1(args("settings"),
-              "Saves a checkpoint of a list of changes to a file"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const std::string&, bool reset_modifieds),
+              &madara::knowledge::KnowledgeBase::save_checkpoint>::call,
+          (arg("self"), arg("filename"), arg("reset_modifieds") = true),
+          "Saves a checkpoint of a list of changes to a file")
 
       // saves a diff of the context as binary
       .def("save_checkpoint",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              madara::knowledge::CheckpointSettings&) const>(
-              &madara::knowledge::KnowledgeBase::save_checkpoint),
-          m_save_checkpoint_1_of_1(args("settings"),
-              "Saves a checkpoint of a list of changes to a file"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              madara::knowledge::CheckpointSettings&) const,
+              &madara::knowledge::KnowledgeBase::save_checkpoint>::call,
+          (arg("self"), arg("settings")),
+          "Saves a checkpoint of a list of changes to a file")
 
       // saves the context as binary
       .def("save_context",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              const std::string&) const>(
-              &madara::knowledge::KnowledgeBase::save_context),
-          m_save_context_1_of_1(
-              args("settings"), "Saves the context to a file"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              const std::string&) const,
+              &madara::knowledge::KnowledgeBase::save_context>::call,
+          (arg("self"), arg("filename")),
+          "Saves the context to a file")
 
       // saves the context as binary
       .def("save_context",
-          static_cast<int64_t (madara::knowledge::KnowledgeBase::*)(
-              madara::knowledge::CheckpointSettings&) const>(
-              &madara::knowledge::KnowledgeBase::save_context),
-          m_save_context_1_of_1(
-              args("settings"), "Saves the context to a file with settings"))
+          &GilReleased<int64_t (madara::knowledge::KnowledgeBase::*)(
+              madara::knowledge::CheckpointSettings&) const,
+              &madara::knowledge::KnowledgeBase::save_context>::call,
+          (arg("self"), arg("settings")),
+          "Saves the context to a file with settings")
 
       // Saves the list of modified records to use later for resending
-      .def("save_modifieds", &madara::knowledge::KnowledgeBase::save_modifieds,
+      .def("save_modifieds",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::save_modifieds),
           "Saves the list of modified records to use later for resending. This"
           "does not clear the modified list. This feature is useful if you"
           "want to remember what has been modified and then resend later, e.g.,"
@@ -1780,111 +2011,172 @@ void define_knowledge(void)
           "Use this function in conjunction with @see add_modifieds to remodify"
           "@return a vector of VariableReferences to the current modified list")
 
-      // Sends all modified variables through the attached transports
+      // set several variables in one lock
+      .def("set_all",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               const std::vector<std::string>& keys,
+               const std::vector<madara::knowledge::KnowledgeRecord>& values) {
+            return call_without_gil([&] { return kb.set_all(keys, values); });
+          },
+          "Atomically sets several variables in one lock of the context and "
+          "sends them together")
+
+      // set several variables in one lock
+      .def("set_all",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               const std::vector<std::string>& keys,
+               const std::vector<madara::knowledge::KnowledgeRecord>& values,
+               const madara::knowledge::EvalSettings& settings) {
+            return call_without_gil(
+                [&] { return kb.set_all(keys, values, settings); });
+          },
+          "Atomically sets several variables in one lock of the context and "
+          "sends them together")
+
+      // Sends all modified variables (GIL released during send)
+      .def("send_modifieds",
+          +[](madara::knowledge::KnowledgeBase& kb) {
+            return call_without_gil([&] { return kb.send_modifieds(); });
+          },
+          "Sends all modified variables through the attached transports.")
+
+      // Sends all modified variables (GIL released during send)
+      .def("send_modifieds",
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& prefix) {
+            return call_without_gil(
+                [&] { return kb.send_modifieds(prefix); });
+          },
+          "Sends all modified variables through the attached transports.")
+
+      // Sends all modified variables (GIL released during send)
       .def("send_modifieds",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
-              const std::string&, const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::send_modifieds),
-          m_send_modifieds_0_of_2(args("prefix", "settings"),
-              "Sends all modified variables through the attached transports."))
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
+                           const std::string&,
+                           const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::send_modifieds>::call,
+          (arg("self"), arg("prefix"), arg("settings")),
+          "Sends all modified variables through the attached transports.")
 
       // sets a knowledge record to a specified value
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const VariableReference &,
               const KnowledgeRecord &,
-              const EvalSettings & )>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Atomically sets the value of a variable to a KnowledgeRecord."))
+              const EvalSettings & ),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Atomically sets the value of a variable to a KnowledgeRecord.")
 
       // sets a knowledge record to a specified value
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string &,
               const KnowledgeRecord &,
-              const EvalSettings & )>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Atomically sets the value of a variable to a KnowledgeRecord."))
+              const EvalSettings & ),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Atomically sets the value of a variable to a KnowledgeRecord.")
 
       // sets a knowledge record to a double
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, double,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Sets a knowledge record to a double"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Sets a knowledge record to a double")
 
       // sets a knowledge record to an array of doubles
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, const std::vector<double>&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Sets a knowledge record to an array of doubles"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Sets a knowledge record to an array of doubles")
 
       // sets a knowledge record to an integer
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, madara::knowledge::KnowledgeRecord::Integer,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Sets a knowledge record to an integer"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Sets a knowledge record to an integer")
 
       // sets a knowledge record to an array of integer
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&,
               const std::vector<madara::knowledge::KnowledgeRecord::Integer>&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Sets a knowledge record to an array of integers"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Sets a knowledge record to an array of integers")
 
       // sets a knowledge record to a string
       .def("set",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, const std::string&,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set),
-          m_set_2_of_3(args("key", "value", "settings"),
-              "Sets a knowledge record to a string"))
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set>::call,
+          (arg("self"), arg("key"), arg("value"),
+              arg("settings") = EvalSettings(true, false, true, false, false)),
+          "Sets a knowledge record to a string")
+
+      // sets a knowledge record from a contiguous buffer
+      .def("set_array",
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& key,
+               object source) {
+            return kb_set_array(kb, key, source, EvalSettings());
+          },
+          "Sets a knowledge record to an array from a contiguous float64 or "
+          "int64 buffer (e.g., a numpy array) with one bulk copy")
+
+      // sets a knowledge record from a contiguous buffer
+      .def("set_array", &kb_set_array,
+          "Sets a knowledge record to an array from a contiguous float64 or "
+          "int64 buffer (e.g., a numpy array) with one bulk copy")
 
       // set the log level
-      .def("set_log_level", &madara::knowledge::KnowledgeBase::set_log_level,
+      .def("set_log_level",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::set_log_level),
           "Sets the log level")
 
       // set quality of writing
-      .def("set_quality", &madara::knowledge::KnowledgeBase::set_quality,
+      .def("set_quality",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::set_quality),
           "Sets the quality of writing to a certain variable from this entity")
 
       // set values of a variable to a string
       .def("set_file",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string& key, const unsigned char* value, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_file),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_file>::call,
           "Atomically sets the value of a variable to an arbitrary string")
 
       // set values of a variable to a string
       .def("set_file",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
               const unsigned char* value, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_file),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_file>::call,
           "Atomically sets the value of a variable to an arbitrary string")
 
       // set history size
       .def("set_history_capacity",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const std::string&, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_history_capacity),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_history_capacity>::call,
           "Set the capacity of this record's history circular buffer. Every"
           "modification to this record will write a new entry in this history."
           "Once the capacity is met, the oldest entry will be discarded as new"
@@ -1892,10 +2184,10 @@ void define_knowledge(void)
 
       // set history size of circular buffer
       .def("set_history_capacity",
-          static_cast<void (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_history_capacity),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_history_capacity>::call,
           "Set the capacity of this record's history circular buffer. Every"
           "modification to this record will write a new entry in this history."
           "Once the capacity is met, the oldest entry will be discarded as new"
@@ -1903,24 +2195,25 @@ void define_knowledge(void)
 
       // set values of a variable to a jpeg image
       .def("set_jpeg",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const std::string&, const unsigned char* value, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_jpeg),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_jpeg>::call,
           "Atomically sets the value of a variable to a JPEG image")
 
       // set values of a variable to a jpeg image
       .def("set_jpeg",
-          static_cast<int (madara::knowledge::KnowledgeBase::*)(
+          &GilReleased<int (madara::knowledge::KnowledgeBase::*)(
               const madara::knowledge::VariableReference&,
               const unsigned char* value, size_t size,
-              const madara::knowledge::EvalSettings&)>(
-              &madara::knowledge::KnowledgeBase::set_jpeg),
+              const madara::knowledge::EvalSettings&),
+              &madara::knowledge::KnowledgeBase::set_jpeg>::call,
           "Atomically sets the value of a variable to a JPEG image")
 
       // set a unique hostport
       .def("setup_unique_hostport",
-          &madara::knowledge::KnowledgeBase::setup_unique_hostport,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::setup_unique_hostport),
           ""
           "Binds to an ephemeral port for unique tie breakers in global "
           "ordering."
@@ -1930,7 +2223,7 @@ void define_knowledge(void)
 
       .def("to_map",
           +[](madara::knowledge::KnowledgeBase& kb, const std::string& prefix) {
-            return kb.to_map(prefix);
+            return call_without_gil([&] { return kb.to_map(prefix); });
           },
           "Get all records starting with the given prefix and return as "
           "KnowledgeRecordMap.")
@@ -1940,7 +2233,9 @@ void define_knowledge(void)
                const std::string& delimiter, const std::string& suffix) {
             std::vector<std::string> next_keys;
             std::map<std::string, madara::knowledge::KnowledgeRecord> result;
-            kb.to_map(prefix, delimiter, suffix, next_keys, result, false);
+            call_without_gil([&] {
+              kb.to_map(prefix, delimiter, suffix, next_keys, result, false);
+            });
             return result;
           },
           "Fills a variable map with list of keys according to a matching "
@@ -1960,13 +2255,15 @@ void define_knowledge(void)
 
       // Write a file from the knowledge base to a specified location
       .def("to_map_stripped",
-          &madara::knowledge::KnowledgeBase::to_map_stripped,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::KnowledgeBase::to_map_stripped),
           "Creates a map with Knowledge Records that begin with the given"
           "prefix. Runs in O(log n + m) time, where n is the size of the"
           "KnowledgeBase, and m is the number of matching records")
 
       // convert a value to a string
-      .def("to_string", &madara::knowledge::KnowledgeBase::to_string,
+      .def("to_string",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::to_string),
           "Saves all keys and values into a string, using the underlying"
           "knowledge::KnowledgeRecord::to_string function. This is an optimized"
           "version that allows the specification of a target string to"
@@ -1979,45 +2276,105 @@ void define_knowledge(void)
           "quotes. Arrays are delineated with array indices")
 
       // sets value of a variable to an XML string
-      .def("to_vector", &madara::knowledge::KnowledgeBase::to_vector,
+      .def("to_vector",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::to_vector),
           "Fills a vector with Knowledge Records that begin with a common "
           "subject"
           "and have a finite range of integer values")
 
+      // zero-copy view of a double array
+      .def("view_doubles",
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& key) {
+            auto shared =
+                call_without_gil([&] { return kb.share_doubles(key); });
+
+            if (!shared)
+            {
+              return madara::python::view_doubles(
+                  call_without_gil([&] { return kb.get(key); }));
+            }
+
+            return madara::python::ArrayView<double>(std::move(shared));
+          },
+          "Returns a read-only DoublesView sharing the variable's double "
+          "array without copying it. Use numpy.asarray on the result for a "
+          "zero-copy ndarray. The view keeps the array alive even if the "
+          "variable is later overwritten")
+
+      // zero-copy view of an integer array
+      .def("view_integers",
+          +[](madara::knowledge::KnowledgeBase& kb, const std::string& key) {
+            auto shared =
+                call_without_gil([&] { return kb.share_integers(key); });
+
+            if (!shared)
+            {
+              return madara::python::view_integers(
+                  call_without_gil([&] { return kb.get(key); }));
+            }
+
+            return madara::python::ArrayView<KnowledgeRecord::Integer>(
+                std::move(shared));
+          },
+          "Returns a read-only IntegersView sharing the variable's integer "
+          "array without copying it. Use numpy.asarray on the result for a "
+          "zero-copy ndarray. The view keeps the array alive even if the "
+          "variable is later overwritten")
+
       // unlocks the knowledge base
-      .def("unlock", &madara::knowledge::KnowledgeBase::unlock,
+      .def("unlock",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::unlock),
           "Unlocks the knowledge base and allows other threads to access")
 
       // refer to another knowledge base
-      .def("use", &madara::knowledge::KnowledgeBase::use,
+      .def("use", MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::use),
           "Refer to and use another knowledge base's context")
 
-      // wait on an expression
+      // wait on an expression (GIL released while waiting)
       .def("wait",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::KnowledgeBase::*)(
-              const std::string&, const madara::knowledge::WaitSettings&)>(
-              &madara::knowledge::KnowledgeBase::wait),
-          m_wait_1_of_2(args("expression", "settings"),
-              "Waits for an expression to evaluate to true"))
+          +[](madara::knowledge::KnowledgeBase& kb,
+               const std::string& expression) {
+            return call_without_gil([&] { return kb.wait(expression); });
+          },
+          "Waits for an expression to evaluate to true")
 
-      // wait on an expression
+      // wait on an expression (GIL released while waiting)
       .def("wait",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::KnowledgeBase::*)(
-              madara::knowledge::CompiledExpression&,
-              const madara::knowledge::WaitSettings&)>(
-              &madara::knowledge::KnowledgeBase::wait),
-          m_wait_1_of_2(args("expression", "settings"),
-              "Waits for an expression to evaluate to true"))
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           const std::string&,
+                           const madara::knowledge::WaitSettings&),
+              &madara::knowledge::KnowledgeBase::wait>::call,
+          (arg("self"), arg("expression"), arg("settings")),
+          "Waits for an expression to evaluate to true")
+
+      // wait on an expression (GIL released while waiting)
+      .def("wait",
+          +[](madara::knowledge::KnowledgeBase& kb,
+               madara::knowledge::CompiledExpression& expression) {
+            return call_without_gil([&] { return kb.wait(expression); });
+          },
+          "Waits for an expression to evaluate to true")
 
-      // wait for a change to happen
+      // wait on an expression (GIL released while waiting)
+      .def("wait",
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+                           madara::knowledge::KnowledgeBase::*)(
+                           madara::knowledge::CompiledExpression&,
+                           const madara::knowledge::WaitSettings&),
+              &madara::knowledge::KnowledgeBase::wait>::call,
+          (arg("self"), arg("expression"), arg("settings")),
+          "Waits for an expression to evaluate to true")
+
+      // wait for a change to happen (GIL released while waiting)
       .def("wait_for_change",
-          &madara::knowledge::KnowledgeBase::wait_for_change,
+          &GilReleased<void (madara::knowledge::KnowledgeBase::*)(void),
+              &madara::knowledge::KnowledgeBase::wait_for_change>::call,
           "Wait for a change to happen to the context (e.g., from transports)")
 
       // Write a file from the knowledge base to a specified location
-      .def("write_file", &madara::knowledge::KnowledgeBase::write_file,
+      .def("write_file",
+          MADARA_GIL_RELEASED(madara::knowledge::KnowledgeBase::write_file),
           "Write a file from the knowledge base to a specified location")
 
       ;
@@ -20,6 +20,7 @@
 #include "madara/knowledge/containers/Vector.h"
 #include "madara/filters/GenericFilters.h"
 #include "FunctionDefaults.h"
+#include "GilReleased.h"
 #include "MadaraKnowledgeContainers.h"
 
 /**
@@ -32,6 +33,57 @@
 
 using namespace boost::python;
 
+/**
+ * Python operators for containers, with the GIL released while the
+ * container locks its context (boost::python's self operators call the
+ * C++ operators with the GIL held)
+ **/
+template<typename Container, typename Value>
+struct GilReleasedOperators
+{
+  static object iadd(back_reference<Container&> self, Value value)
+  {
+    call_without_gil([&] { self.get() += value; });
+    return self.source();
+  }
+
+  static object isub(back_reference<Container&> self, Value value)
+  {
+    call_without_gil([&] { self.get() -= value; });
+    return self.source();
+  }
+
+  static bool lt(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self < value; });
+  }
+
+  static bool le(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self <= value; });
+  }
+
+  static bool ne(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self != value; });
+  }
+
+  static bool eq(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self == value; });
+  }
+
+  static bool ge(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self >= value; });
+  }
+
+  static bool gt(Container& self, Value value)
+  {
+    return call_without_gil([&] { return self > value; });
+  }
+};
+
 /********************************************************
  * Filters namespace definitions
  ********************************************************/
@@ -66,104 +118,118 @@ void define_knowledge_containers(void)
 
       // add a record
       .def("add",
-          static_cast<void (madara::knowledge::containers::CircularBuffer::*)(
-              const madara::knowledge::KnowledgeRecord&)>(
-              &madara::knowledge::containers::CircularBuffer::add),
+          &GilReleased<void (madara::knowledge::containers::CircularBuffer::*)(
+              const madara::knowledge::KnowledgeRecord&),
+              &madara::knowledge::containers::CircularBuffer::add>::call,
           "Adds a record to the end of the buffer")
 
       // add a vector of records
       .def("add",
-          static_cast<void (madara::knowledge::containers::CircularBuffer::*)(
-              const std::vector<madara::knowledge::KnowledgeRecord>&)>(
-              &madara::knowledge::containers::CircularBuffer::add),
+          &GilReleased<void (madara::knowledge::containers::CircularBuffer::*)(
+              const std::vector<madara::knowledge::KnowledgeRecord>&),
+              &madara::knowledge::containers::CircularBuffer::add>::call,
           "Adds a record to the end of the buffer")
 
       // retrieves an index of an array
-      .def("clear", &madara::knowledge::containers::CircularBuffer::clear,
+      .def("clear",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::clear),
           "Clears the buffer of all records")
 
       // retrieves an index of an array
-      .def("count", &madara::knowledge::containers::CircularBuffer::count,
+      .def("count",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::count),
           "Returns the number of records in the buffer")
 
       // get latest
       .def("get",
-          static_cast<madara::knowledge::KnowledgeRecord (
-              madara::knowledge::containers::CircularBuffer::*)(void) const>(
-              &madara::knowledge::containers::CircularBuffer::get),
+          &GilReleased<madara::knowledge::KnowledgeRecord (
+              madara::knowledge::containers::CircularBuffer::*)(void) const,
+              &madara::knowledge::containers::CircularBuffer::get>::call,
           "Gets the latest added record to the buffer")
 
       // gets the earliest n records
       .def("get_earliest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
-              madara::knowledge::containers::CircularBuffer::*)(size_t) const>(
-              &madara::knowledge::containers::CircularBuffer::get_earliest),
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
+              madara::knowledge::containers::CircularBuffer::*)(size_t) const,
+              &madara::knowledge::containers::CircularBuffer::
+                  get_earliest>::call,
           "Gets the oldest n elements in the buffer")
 
       // gets the latest n records
       .def("get_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
-              madara::knowledge::containers::CircularBuffer::*)(size_t) const>(
-              &madara::knowledge::containers::CircularBuffer::get_latest),
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
+              madara::knowledge::containers::CircularBuffer::*)(size_t) const,
+              &madara::knowledge::containers::CircularBuffer::get_latest>::call,
           "Gets the oldest n elements in the buffer")
 
       // gets the underlying prefix/name
-      .def("get_name", &madara::knowledge::containers::CircularBuffer::get_name,
+      .def("get_name",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::get_name),
           "Returns the underlying name of the container")
 
       // get latest
       .def("inspect",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::CircularBuffer::*)(
-              madara::knowledge::KnowledgeRecord::Integer) const>(
-              &madara::knowledge::containers::CircularBuffer::inspect),
+              madara::knowledge::KnowledgeRecord::Integer) const,
+              &madara::knowledge::containers::CircularBuffer::inspect>::call,
           "Inspects the record at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // gets the latest n records
       .def("inspect",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::CircularBuffer::*)(
-              madara::knowledge::KnowledgeRecord::Integer, size_t) const>(
-              &madara::knowledge::containers::CircularBuffer::inspect),
+              madara::knowledge::KnowledgeRecord::Integer, size_t) const,
+              &madara::knowledge::containers::CircularBuffer::inspect>::call,
           "Inspects the records at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // resizes the container
-      .def("resize", &madara::knowledge::containers::CircularBuffer::resize,
+      .def("resize",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::resize),
           "Resizes the container")
 
       // sets the index
       .def("set_index",
-          &madara::knowledge::containers::CircularBuffer::set_index,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::set_index),
           "Sets the buffer index to an arbitrary position")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::CircularBuffer::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
-              &madara::knowledge::containers::CircularBuffer::set_name),
+          &GilReleased<void (madara::knowledge::containers::CircularBuffer::*)(
+              const std::string&, madara::knowledge::KnowledgeBase&),
+              &madara::knowledge::containers::CircularBuffer::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::CircularBuffer::*)(
-              const std::string&, madara::knowledge::Variables&)>(
-              &madara::knowledge::containers::CircularBuffer::set_name),
+          &GilReleased<void (madara::knowledge::containers::CircularBuffer::*)(
+              const std::string&, madara::knowledge::Variables&),
+              &madara::knowledge::containers::CircularBuffer::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the index
       .def("set_quality",
-          &madara::knowledge::containers::CircularBuffer::set_quality,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::set_quality),
           "Sets the write quality of updates")
 
       // sets the index
       .def("set_settings",
-          &madara::knowledge::containers::CircularBuffer::set_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::set_settings),
           "Sets the write quality of updates")
 
       // returns the size of the buffer
-      .def("size", &madara::knowledge::containers::CircularBuffer::size,
+      .def("size",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBuffer::size),
           "Returns the size of the buffer")
 
       ;
@@ -180,115 +246,133 @@ void define_knowledge_containers(void)
 
       // retrieves the number of records
       .def("count",
-          &madara::knowledge::containers::CircularBufferConsumer::count,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::count),
           "Returns the number of records in the buffer")
 
       // get latest
       .def("consume",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::CircularBufferConsumer::*)(void)
-                  const>(
-              &madara::knowledge::containers::CircularBufferConsumer::consume),
+                  const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  consume>::call,
           "Consumes earliest record in the buffer")
 
       // gets the earliest n records
       .def("consume_earliest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::CircularBufferConsumer::*)(size_t)
-                  const>(&madara::knowledge::containers::
-                             CircularBufferConsumer::consume_earliest),
+                  const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  consume_earliest>::call,
           "Consumes the oldest n elements in the buffer")
 
       // gets the latest n records
       .def("consume_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::CircularBufferConsumer::*)(size_t)
-                  const>(&madara::knowledge::containers::
-                             CircularBufferConsumer::consume_latest),
+                  const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  consume_latest>::call,
           "Consumes the oldest n elements in the buffer")
 
       // gets the underlying prefix/name
       .def("get_dropped",
-          &madara::knowledge::containers::CircularBufferConsumer::get_dropped,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  CircularBufferConsumer::get_dropped),
           "Returns the number of records dropped since last consume")
 
       // gets the underlying prefix/name
       .def("get_name",
-          &madara::knowledge::containers::CircularBufferConsumer::get_name,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::get_name),
           "Returns the underlying name of the container")
 
       // get latest
       .def("inspect",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::CircularBufferConsumer::*)(
-              madara::knowledge::KnowledgeRecord::Integer) const>(
-              &madara::knowledge::containers::CircularBufferConsumer::inspect),
+              madara::knowledge::KnowledgeRecord::Integer) const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  inspect>::call,
           "Inspects the record at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // gets the latest n records
       .def("inspect",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::CircularBufferConsumer::*)(
-              madara::knowledge::KnowledgeRecord::Integer, size_t) const>(
-              &madara::knowledge::containers::CircularBufferConsumer::inspect),
+              madara::knowledge::KnowledgeRecord::Integer, size_t) const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  inspect>::call,
           "Inspects the records at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // get latest
       .def("peek_latest",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::CircularBufferConsumer::*)(void)
-                  const>(&madara::knowledge::containers::
-                             CircularBufferConsumer::peek_latest),
+                  const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  peek_latest>::call,
           "Peek at the newest record in the buffer")
 
       // gets the latest n records
       .def("peek_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::CircularBufferConsumer::*)(size_t)
-                  const>(&madara::knowledge::containers::
-                             CircularBufferConsumer::peek_latest),
+                  const,
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  peek_latest>::call,
           "Peek at the newest n elements in the buffer")
 
       // returns the remaining records
       .def("remaining",
-          &madara::knowledge::containers::CircularBufferConsumer::resize,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::resize),
           "Returns the remaining records in the buffer")
 
       // resizes the container
       .def("resize",
-          &madara::knowledge::containers::CircularBufferConsumer::resize,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::resize),
           "Resizes the container")
 
       // resizes the container
       .def("resync",
-          &madara::knowledge::containers::CircularBufferConsumer::resize,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::resize),
           "Resyncs the local index to the producer index in the buffer")
 
       // sets the index
       .def("set_index",
-          &madara::knowledge::containers::CircularBufferConsumer::set_index,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::set_index),
           "Sets the buffer index to an arbitrary position")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::CircularBufferConsumer::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
-              &madara::knowledge::containers::CircularBufferConsumer::set_name),
+              const std::string&, madara::knowledge::KnowledgeBase&),
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::CircularBufferConsumer::*)(
-              const std::string&, madara::knowledge::Variables&)>(
-              &madara::knowledge::containers::CircularBufferConsumer::set_name),
+              const std::string&, madara::knowledge::Variables&),
+              &madara::knowledge::containers::CircularBufferConsumer::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // returns the size of the buffer
-      .def("size", &madara::knowledge::containers::CircularBufferConsumer::size,
+      .def("size",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::CircularBufferConsumer::size),
           "Returns the size of the buffer")
 
       ;
@@ -305,172 +389,181 @@ void define_knowledge_containers(void)
 
       // get latest
       .def("consume",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              void) const>(&madara::knowledge::containers::
-                               NativeCircularBufferConsumer::consume),
+              void) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  consume>::call,
           "Consumes the record at the local index (not the producer index)")
 
       // consume record at local index
       .def("consume",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t&) const>(&madara::knowledge::containers::
-                                  NativeCircularBufferConsumer::consume),
+              size_t&) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  consume>::call,
           "Consumes the record at the local index (not the producer index)")
 
       // get latest
       .def("consume_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t) const>(&madara::knowledge::containers::
-                                 NativeCircularBufferConsumer::consume_latest),
+              size_t) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  consume_latest>::call,
           "Consumes the latest record at the local index (not the producer "
           "index)")
 
       // get latest
       .def("consume_latest",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              void) const>(&madara::knowledge::containers::
-                               NativeCircularBufferConsumer::consume_latest),
+              void) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  consume_latest>::call,
           "Consumes the latest record at the local index (not the producer "
           "index)")
 
       // get latest
       .def("consume_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t, size_t&) const>(
+              size_t, size_t&) const,
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  consume_latest),
+                  consume_latest>::call,
           "Consumes the latest record at the local index (not the producer "
           "index)")
 
       // consumes earliest records
       .def("consume_many",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t) const>(&madara::knowledge::containers::
-                                 NativeCircularBufferConsumer::consume_many),
+              size_t) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  consume_many>::call,
           "Consumes (earliest) records from the local index")
 
       // consumes earliest records
       .def("consume_many",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t, size_t&) const>(
+              size_t, size_t&) const,
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  consume_many),
+                  consume_many>::call,
           "Consumes (earliest) records from the local index")
 
       // retrieves the number of records
       .def("count",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::count,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::count),
           "Returns the number of records in the buffer")
 
       // gets the underlying prefix/name
       .def("get_dropped",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              get_dropped,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::get_dropped),
           "Returns the number of records dropped since last consume")
 
       // gets the underlying prefix/name
       .def("get_name",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              get_name,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::get_name),
           "Returns the underlying name of the container")
 
       // get the local index
       .def("get_index",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              get_index,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::get_index),
           "Gets the local index")
 
       // get latest
       .def("inspect",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              madara::knowledge::KnowledgeRecord::Integer) const>(
+              madara::knowledge::KnowledgeRecord::Integer) const,
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  inspect),
+                  inspect>::call,
           "Inspects the record at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // gets the latest n records
       .def("inspect",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              madara::knowledge::KnowledgeRecord::Integer, size_t) const>(
+              madara::knowledge::KnowledgeRecord::Integer, size_t) const,
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  inspect),
+                  inspect>::call,
           "Inspects the records at the indicated position in the buffer. "
           "This position can be positive or negative from current position")
 
       // get latest
       .def("peek_latest",
-          static_cast<std::vector<madara::knowledge::KnowledgeRecord> (
+          &GilReleased<std::vector<madara::knowledge::KnowledgeRecord> (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              size_t) const>(&madara::knowledge::containers::
-                                 NativeCircularBufferConsumer::peek_latest),
+              size_t) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  peek_latest>::call,
           "Consumes the record at the local index (not the producer index)")
 
       // get latest
       .def("peek_latest",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              void) const>(&madara::knowledge::containers::
-                               NativeCircularBufferConsumer::peek_latest),
+              void) const,
+              &madara::knowledge::containers::NativeCircularBufferConsumer::
+                  peek_latest>::call,
           "Consumes the record at the local index (not the producer index)")
 
       // returns the remaining records
       .def("remaining",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              remaining,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::remaining),
           "Returns the remaining records in the buffer")
 
       // sets the index
       .def("set_index",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              set_index,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::set_index),
           "Sets the buffer index to an arbitrary position")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
+              const std::string&, madara::knowledge::KnowledgeBase&),
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  set_name),
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              const std::string&, madara::knowledge::Variables&)>(
+              const std::string&, madara::knowledge::Variables&),
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  set_name),
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeCircularBufferConsumer::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&)>(
+              const std::string&, madara::knowledge::ThreadSafeContext&),
               &madara::knowledge::containers::NativeCircularBufferConsumer::
-                  set_name),
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // returns the size of the buffer
       .def("size",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::size,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::size),
           "Returns the size of the buffer")
 
       // get a knowledge record
       .def("get_record",
-          &madara::knowledge::containers::NativeCircularBufferConsumer::
-              get_record,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeCircularBufferConsumer::get_record),
           "Get the KnowledgeRecord this container refers to. While this "
           "returns by"
           "copy, it will share the same circular buffer for read operations, "
@@ -500,34 +593,42 @@ void define_knowledge_containers(void)
       // methods
 
       // check for existence
-      .def("exists", &madara::knowledge::containers::Integer::exists,
+      .def("exists",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
-      .def("get_name", &madara::knowledge::containers::Integer::get_name,
+      .def("get_name",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
       .def("get_settings",
-          &madara::knowledge::containers::Integer::get_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::get_settings),
           "Returns the read/write settings of the container")
 
       // returns the remaining records
-      .def("modify", &madara::knowledge::containers::Integer::modify,
+      .def("modify",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::modify),
           "Marks the record/container as modified to send over transport")
 
       // exchange integers
-      .def("exchange", &madara::knowledge::containers::Integer::exchange,
+      .def("exchange",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::exchange),
           "Exchanges the integer at this location with the integer at another"
           "location")
 
       // sets quality
-      .def("set_quality", &madara::knowledge::containers::Integer::set_quality,
+      .def("set_quality",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::set_quality),
           "Sets the quality of writing to the variable")
 
       // gets debugging info
       .def("get_debug_info",
-          &madara::knowledge::containers::Integer::get_debug_info,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::get_debug_info),
           "Returns the type of the container along with name and any other"
           "useful information. The provided information should be useful"
           "for developers wishing to debug container operations, especially"
@@ -535,83 +636,114 @@ void define_knowledge_containers(void)
           "in conjunction with modify")
 
       // find if integer value is present
-      .def("is_true", &madara::knowledge::containers::Integer::is_true,
+      .def("is_true",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::is_true),
           "Determines if the value is true")
 
       // find if integer value is not present
-      .def("is_false", &madara::knowledge::containers::Integer::is_false,
+      .def("is_false",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Integer::is_false),
           "Determines if the value is false")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Integer::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
-              &madara::knowledge::containers::Integer::set_name),
+          &GilReleased<void (madara::knowledge::containers::Integer::*)(
+              const std::string&, madara::knowledge::KnowledgeBase&),
+              &madara::knowledge::containers::Integer::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Integer::*)(
-              const std::string&, madara::knowledge::Variables&)>(
-              &madara::knowledge::containers::Integer::set_name),
+          &GilReleased<void (madara::knowledge::containers::Integer::*)(
+              const std::string&, madara::knowledge::Variables&),
+              &madara::knowledge::containers::Integer::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Integer::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&)>(
-              &madara::knowledge::containers::Integer::set_name),
+          &GilReleased<void (madara::knowledge::containers::Integer::*)(
+              const std::string&, madara::knowledge::ThreadSafeContext&),
+              &madara::knowledge::containers::Integer::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
       .def("set_settings",
-          &madara::knowledge::containers::Integer::set_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::set_settings),
           "Sets the read/write settings for the container")
 
       // returns the double
-      .def("to_double", &madara::knowledge::containers::Integer::to_double,
+      .def("to_double",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::to_double),
           "Returns the double")
 
       // returns the integer
-      .def("to_integer", &madara::knowledge::containers::Integer::to_integer,
+      .def("to_integer",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::to_integer),
           "Returns the integer")
 
       // returns the record
-      .def("to_record", &madara::knowledge::containers::Integer::to_record,
+      .def("to_record",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::to_record),
           "Returns the underlying record")
 
       // returns the container as a string
-      .def("to_string", &madara::knowledge::containers::Integer::to_string,
+      .def("to_string",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::to_string),
           "Returns the container as a string")
 
       // returns the container as a string
       .def("set",
-          static_cast<madara::knowledge::KnowledgeRecord::Integer (
+          &GilReleased<madara::knowledge::KnowledgeRecord::Integer (
               madara::knowledge::containers::Integer::*)(
-              madara::knowledge::KnowledgeRecord::Integer)>(
-              &madara::knowledge::containers::Integer::operator=),
+              madara::knowledge::KnowledgeRecord::Integer),
+              &madara::knowledge::containers::Integer::operator= >::call,
           "Sets the value")
 
-      .def(self += madara::knowledge::KnowledgeRecord::Integer())
+      .def("__iadd__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::iadd)
 
-      .def(self -= madara::knowledge::KnowledgeRecord::Integer())
+      .def("__isub__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::isub)
 
-      .def(self < madara::knowledge::KnowledgeRecord::Integer())
+      .def("__lt__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::lt)
 
-      .def(self <= madara::knowledge::KnowledgeRecord::Integer())
+      .def("__le__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::le)
 
-      .def(self != madara::knowledge::KnowledgeRecord::Integer())
+      .def("__ne__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::ne)
 
-      .def(self == madara::knowledge::KnowledgeRecord::Integer())
+      .def("__eq__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::eq)
 
-      .def(self >= madara::knowledge::KnowledgeRecord::Integer())
+      .def("__ge__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::ge)
 
-      .def(self > madara::knowledge::KnowledgeRecord::Integer())
+      .def("__gt__",
+          &GilReleasedOperators<madara::knowledge::containers::Integer,
+              madara::knowledge::KnowledgeRecord::Integer>::gt)
 
-      .def("operator++", &madara::knowledge::containers::Integer::operator++,
+      .def("operator++",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::operator++),
           "Adds one to the double")
 
-      .def("operator--", &madara::knowledge::containers::Integer::operator--,
+      .def("operator--",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Integer::operator--),
           "Subtracts one from the double");
 
   class_<madara::knowledge::containers::Double>(
@@ -632,33 +764,42 @@ void define_knowledge_containers(void)
       // methods
 
       // check for existence
-      .def("exists", &madara::knowledge::containers::Double::exists,
+      .def("exists",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
-      .def("get_name", &madara::knowledge::containers::Double::get_name,
+      .def("get_name",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
-      .def("get_settings", &madara::knowledge::containers::Double::get_settings,
+      .def("get_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::get_settings),
           "Returns the read/write settings of the container")
 
       // returns the remaining records
-      .def("modify", &madara::knowledge::containers::Double::modify,
+      .def("modify",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::modify),
           "Marks the record/container as modified to send over transport")
 
       // exchange doubles
-      .def("exchange", &madara::knowledge::containers::Double::exchange,
+      .def("exchange",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::exchange),
           "Exchanges the double at this location with the integer at another"
           "location")
 
       // sets quality
-      .def("set_quality", &madara::knowledge::containers::Double::set_quality,
+      .def("set_quality",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::set_quality),
           "Sets the quality of writing to the variable")
 
       // gets debugging info
       .def("get_debug_info",
-          &madara::knowledge::containers::Double::get_debug_info,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::get_debug_info),
           "Returns the type of the container along with name and any other"
           "useful information. The provided information should be useful"
           "for developers wishing to debug container operations, especially"
@@ -666,80 +807,110 @@ void define_knowledge_containers(void)
           "in conjunction with modify")
 
       // find if double value is present
-      .def("is_true", &madara::knowledge::containers::Double::is_true,
+      .def("is_true",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::is_true),
           "Determines if the value is true")
 
       // find if double value is not present
-      .def("is_false", &madara::knowledge::containers::Double::is_false,
+      .def("is_false",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::is_false),
           "Determines if the value is false")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Double::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
-              &madara::knowledge::containers::Double::set_name),
+          &GilReleased<void (madara::knowledge::containers::Double::*)(
+              const std::string&, madara::knowledge::KnowledgeBase&),
+              &madara::knowledge::containers::Double::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Double::*)(
-              const std::string&, madara::knowledge::Variables&)>(
-              &madara::knowledge::containers::Double::set_name),
+          &GilReleased<void (madara::knowledge::containers::Double::*)(
+              const std::string&, madara::knowledge::Variables&),
+              &madara::knowledge::containers::Double::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Double::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&)>(
-              &madara::knowledge::containers::Double::set_name),
+          &GilReleased<void (madara::knowledge::containers::Double::*)(
+              const std::string&, madara::knowledge::ThreadSafeContext&),
+              &madara::knowledge::containers::Double::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
-      .def("set_settings", &madara::knowledge::containers::Double::set_settings,
+      .def("set_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::set_settings),
           "Sets the read/write settings for the container")
 
       // returns the double
-      .def("to_double", &madara::knowledge::containers::Double::to_double,
+      .def("to_double",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::to_double),
           "Returns the double")
 
       // returns the integer
-      .def("to_integer", &madara::knowledge::containers::Double::to_integer,
+      .def("to_integer",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::to_integer),
           "Returns the integer")
 
       // returns the record
-      .def("to_record", &madara::knowledge::containers::Double::to_record,
+      .def("to_record",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::to_record),
           "Returns the underlying record")
 
       // returns the container as a string
-      .def("to_string", &madara::knowledge::containers::Double::to_string,
+      .def("to_string",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Double::to_string),
           "Returns the container as a string")
 
       // returns the container as a string
       .def("set",
-          static_cast<double (madara::knowledge::containers::Double::*)(
-              double)>(&madara::knowledge::containers::Double::operator=),
+          &GilReleased<double (madara::knowledge::containers::Double::*)(
+              double),
+              &madara::knowledge::containers::Double::operator= >::call,
           "Sets the value")
 
-      .def(self += double())
+      .def("__iadd__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::iadd)
 
-      .def(self -= double())
+      .def("__isub__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::isub)
 
-      .def(self < double())
+      .def("__lt__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::lt)
 
-      .def(self <= double())
+      .def("__le__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::le)
 
-      .def(self != double())
+      .def("__ne__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::ne)
 
-      .def(self == double())
+      .def("__eq__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::eq)
 
-      .def(self >= double())
+      .def("__ge__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::ge)
 
-      .def(self > double())
+      .def("__gt__",
+          &GilReleasedOperators<madara::knowledge::containers::Double,
+              double>::gt)
 
-      .def("operator++", &madara::knowledge::containers::Double::operator++,
+      .def("operator++",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::operator++),
           "Adds one to the double")
 
-      .def("operator--", &madara::knowledge::containers::Double::operator--,
+      .def("operator--",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Double::operator--),
           "Subtracts one from the double")
 
       ;
@@ -760,95 +931,125 @@ void define_knowledge_containers(void)
       // methods
 
       // check for existence
-      .def("exists", &madara::knowledge::containers::NativeDoubleVector::exists,
+      .def("exists",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
       .def("get_name",
-          &madara::knowledge::containers::NativeDoubleVector::get_name,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
       .def("get_settings",
-          &madara::knowledge::containers::NativeDoubleVector::get_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::get_settings),
           "Returns the read/write settings of the container")
 
       // returns the remaining records
-      .def("modify", &madara::knowledge::containers::NativeDoubleVector::modify,
+      .def("modify",
+          &GilReleased<void (madara::knowledge::containers::
+                                 NativeDoubleVector::*)(void),
+              &madara::knowledge::containers::NativeDoubleVector::
+                  modify>::call,
           "Marks the record/container as modified to send over transport")
 
+      // modifies an element of the container
+      .def("modify",
+          &GilReleased<void (madara::knowledge::containers::
+                                 NativeDoubleVector::*)(size_t),
+              &madara::knowledge::containers::NativeDoubleVector::
+                  modify>::call,
+          "Marks the index as modified to send over transport")
+
       // pushes a record onto the back of the vector
       .def("push_back",
-          &madara::knowledge::containers::NativeDoubleVector::push_back,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::push_back),
           "Pushes a double onto the back of the vector")
 
       // pushes a record onto the back of the vector
       .def("resize",
-          &madara::knowledge::containers::NativeIntegerVector::resize,
-          m_resize_1_of_1(args("size"), "Resizes the vector to a size"))
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::resize),
+          (arg("self"), arg("size")), "Resizes the vector to a size")
 
       // exchange vectors
       .def("exchange",
-          &madara::knowledge::containers::NativeDoubleVector::exchange,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::exchange),
           "Exchanges the vector at this location with the vector at another"
           "location")
 
       // transfer elements of vector to another
       .def("transfer_to",
-          &madara::knowledge::containers::NativeDoubleVector::transfer_to,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::transfer_to),
           "Transfers elements from this vector to another")
 
       // copy elements to STL vector
       .def("copy_to",
-          &madara::knowledge::containers::NativeDoubleVector::copy_to,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::copy_to),
           "Copies the vector elements to an STL vector of Knowledge Records")
 
       // find size of a vector
-      .def("size", &madara::knowledge::containers::NativeDoubleVector::size,
+      .def("size",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::size),
           "Returns the size of the vector")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&, int)>(
-              &madara::knowledge::containers::NativeDoubleVector::set_name),
+              const std::string&, madara::knowledge::KnowledgeBase&, int),
+              &madara::knowledge::containers::NativeDoubleVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              const std::string&, madara::knowledge::Variables&, int)>(
-              &madara::knowledge::containers::NativeDoubleVector::set_name),
+              const std::string&, madara::knowledge::Variables&, int),
+              &madara::knowledge::containers::NativeDoubleVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&, int)>(
-              &madara::knowledge::containers::NativeDoubleVector::set_name),
+              const std::string&, madara::knowledge::ThreadSafeContext&, int),
+              &madara::knowledge::containers::NativeDoubleVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
       .def("set_settings",
-          &madara::knowledge::containers::NativeDoubleVector::set_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::set_settings),
           "Sets the read/write settings for the container")
 
       // get a copy of the record for the map
       .def("operator[]",
-          &madara::knowledge::containers::NativeDoubleVector::operator[],
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::operator[]),
           "Retrieves a copy of the record from the map")
 
       // set writing quality
       .def("set_quality",
-          &madara::knowledge::containers::NativeDoubleVector::set_quality,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::set_quality),
           "Sets the quality of writing to a certain variable from this entity")
 
       // returns the double
       .def("get_debug_info",
-          &madara::knowledge::containers::NativeDoubleVector::get_debug_info,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeDoubleVector::get_debug_info),
           "Returns the type of the container along with name and any other"
           "useful information. The provided information should be useful"
           "for developers wishing to debug container operations, especially"
@@ -857,66 +1058,71 @@ void define_knowledge_containers(void)
 
       // returns the double
       .def("to_doubles",
-          &madara::knowledge::containers::NativeDoubleVector::to_doubles,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::to_doubles),
           "Returns the double")
 
       // find if double value is present
       .def("is_true",
-          &madara::knowledge::containers::NativeDoubleVector::is_true,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::is_true),
           "Determines if the value is true")
 
       // find if double value is not present
       .def("is_false",
-          &madara::knowledge::containers::NativeDoubleVector::is_false,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::is_false),
           "Determines if the value is false")
 
       // returns the record
       .def("to_record",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeDoubleVector::*)(void)
-                  const>(
-              &madara::knowledge::containers::NativeDoubleVector::to_record),
+                  const,
+              &madara::knowledge::containers::NativeDoubleVector::
+                  to_record>::call,
           "Returns the underlying record")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              size_t index, double value)>(
-              &madara::knowledge::containers::NativeDoubleVector::set),
+              size_t index, double value),
+              &madara::knowledge::containers::NativeDoubleVector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeDoubleVector::*)(
               size_t index, double value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::NativeDoubleVector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::NativeDoubleVector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              const std::vector<double>& value)>(
-              &madara::knowledge::containers::NativeDoubleVector::set),
+              const std::vector<double>& value),
+              &madara::knowledge::containers::NativeDoubleVector::set>::call,
           "Sets the entire vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeDoubleVector::*)(
               const std::vector<double>& value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::NativeDoubleVector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::NativeDoubleVector::set>::call,
           "Sets the entire vector")
 
       .def("__getitem__",
-          &madara::knowledge::containers::NativeDoubleVector::operator[],
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeDoubleVector::operator[]),
           "Gets an index of the vector")
 
       .def("__setitem__",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeDoubleVector::*)(
-              size_t index, double value)>(
-              &madara::knowledge::containers::NativeDoubleVector::set),
+              size_t index, double value),
+              &madara::knowledge::containers::NativeDoubleVector::set>::call,
           "Sets an index in the vector");
 
   class_<madara::knowledge::containers::NativeIntegerVector>(
@@ -936,96 +1142,124 @@ void define_knowledge_containers(void)
 
       // check for existence
       .def("exists",
-          &madara::knowledge::containers::NativeIntegerVector::exists,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
       .def("get_name",
-          &madara::knowledge::containers::NativeIntegerVector::get_name,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
       .def("get_settings",
-          &madara::knowledge::containers::NativeIntegerVector::get_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::get_settings),
           "Returns the read/write settings of the container")
 
       // returns the remaining records
       .def("modify",
-          &madara::knowledge::containers::NativeIntegerVector::modify,
+          &GilReleased<void (madara::knowledge::containers::
+                                 NativeIntegerVector::*)(void),
+              &madara::knowledge::containers::NativeIntegerVector::
+                  modify>::call,
           "Marks the record/container as modified to send over transport")
 
+      // modifies an element of the container
+      .def("modify",
+          &GilReleased<void (madara::knowledge::containers::
+                                 NativeIntegerVector::*)(size_t),
+              &madara::knowledge::containers::NativeIntegerVector::
+                  modify>::call,
+          "Marks the index as modified to send over transport")
+
       // pushes a record onto the back of the vector
       .def("push_back",
-          &madara::knowledge::containers::NativeIntegerVector::push_back,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::push_back),
           "Pushes an integer onto the back of the vector")
 
       // pushes a record onto the back of the vector
       .def("resize",
-          &madara::knowledge::containers::NativeIntegerVector::resize,
-          m_resize_1_of_1(args("size"), "Resizes the vector to a size"))
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::resize),
+          (arg("self"), arg("size")), "Resizes the vector to a size")
 
       // exchange vectors
       .def("exchange",
-          &madara::knowledge::containers::NativeIntegerVector::exchange,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::exchange),
           "Exchanges the vector at this location with the vector at another"
           "location")
 
       // transfer elements of vector to another
       .def("transfer_to",
-          &madara::knowledge::containers::NativeIntegerVector::transfer_to,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::transfer_to),
           "Transfers elements from this vector to another")
 
       // copy elements to STL vector
       .def("copy_to",
-          &madara::knowledge::containers::NativeIntegerVector::copy_to,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::copy_to),
           "Copies the vector elements to an STL vector of Knowledge Records")
 
       // find size of a vector
-      .def("size", &madara::knowledge::containers::NativeIntegerVector::size,
+      .def("size",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::size),
           "Returns the size of the vector")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&, int)>(
-              &madara::knowledge::containers::NativeIntegerVector::set_name),
+              const std::string&, madara::knowledge::KnowledgeBase&, int),
+              &madara::knowledge::containers::NativeIntegerVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              const std::string&, madara::knowledge::Variables&, int)>(
-              &madara::knowledge::containers::NativeIntegerVector::set_name),
+              const std::string&, madara::knowledge::Variables&, int),
+              &madara::knowledge::containers::NativeIntegerVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (
+          &GilReleased<void (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&, int)>(
-              &madara::knowledge::containers::NativeIntegerVector::set_name),
+              const std::string&, madara::knowledge::ThreadSafeContext&, int),
+              &madara::knowledge::containers::NativeIntegerVector::
+                  set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
       .def("set_settings",
-          &madara::knowledge::containers::NativeIntegerVector::set_settings,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::set_settings),
           "Sets the read/write settings for the container")
 
       // get a copy of the record for the map
       .def("operator[]",
-          &madara::knowledge::containers::NativeIntegerVector::operator[],
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::operator[]),
           "Retrieves a copy of the record from the map")
 
       // set writing quality
       .def("set_quality",
-          &madara::knowledge::containers::NativeIntegerVector::set_quality,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::set_quality),
           "Sets the quality of writing to a certain variable from this entity")
 
       // returns the integer
       .def("get_debug_info",
-          &madara::knowledge::containers::NativeIntegerVector::get_debug_info,
+          MADARA_GIL_RELEASED(madara::knowledge::containers::
+                  NativeIntegerVector::get_debug_info),
           "Returns the type of the container along with name and any other"
           "useful information. The provided information should be useful"
           "for developers wishing to debug container operations, especially"
@@ -1034,66 +1268,71 @@ void define_knowledge_containers(void)
 
       // returns the double
       .def("to_integers",
-          &madara::knowledge::containers::NativeIntegerVector::to_integers,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::to_integers),
           "Returns the vector as an iterable vector of integers")
 
       // find if integer value is present
       .def("is_true",
-          &madara::knowledge::containers::NativeIntegerVector::is_true,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::is_true),
           "Determines if the value is true")
 
       // find if integer value is not present
       .def("is_false",
-          &madara::knowledge::containers::NativeIntegerVector::is_false,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::is_false),
           "Determines if the value is false")
 
       // returns the record
       .def("to_record",
-          static_cast<madara::knowledge::KnowledgeRecord (
+          &GilReleased<madara::knowledge::KnowledgeRecord (
               madara::knowledge::containers::NativeIntegerVector::*)(void)
-                  const>(
-              &madara::knowledge::containers::NativeIntegerVector::to_record),
+                  const,
+              &madara::knowledge::containers::NativeIntegerVector::
+                  to_record>::call,
           "Returns the underlying record")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              size_t index, int64_t value)>(
-              &madara::knowledge::containers::NativeIntegerVector::set),
+              size_t index, int64_t value),
+              &madara::knowledge::containers::NativeIntegerVector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeIntegerVector::*)(
               size_t index, int64_t value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::NativeIntegerVector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::NativeIntegerVector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              const std::vector<int64_t>& value)>(
-              &madara::knowledge::containers::NativeIntegerVector::set),
+              const std::vector<int64_t>& value),
+              &madara::knowledge::containers::NativeIntegerVector::set>::call,
           "Sets the entire vector")
 
       .def("set",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeIntegerVector::*)(
               const std::vector<int64_t>& value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::NativeIntegerVector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::NativeIntegerVector::set>::call,
           "Sets the entire vector")
 
       .def("__getitem__",
-          &madara::knowledge::containers::NativeIntegerVector::operator[],
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::NativeIntegerVector::operator[]),
           "Gets an index of the vector")
 
       .def("__setitem__",
-          static_cast<int (
+          &GilReleased<int (
               madara::knowledge::containers::NativeIntegerVector::*)(
-              size_t index, int64_t value)>(
-              &madara::knowledge::containers::NativeIntegerVector::set),
+              size_t index, int64_t value),
+              &madara::knowledge::containers::NativeIntegerVector::set>::call,
           "Sets an index in the vector");
 
   class_<madara::knowledge::containers::String>(
@@ -1112,74 +1351,90 @@ void define_knowledge_containers(void)
       // methods
 
       // check for existence
-      .def("exists", &madara::knowledge::containers::String::exists,
+      .def("exists",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
-      .def("get_name", &madara::knowledge::containers::String::get_name,
+      .def("get_name",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
-      .def("get_settings", &madara::knowledge::containers::String::get_settings,
+      .def("get_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::String::get_settings),
           "Returns the read/write settings of the container")
 
       // returns the remaining records
-      .def("modify", &madara::knowledge::containers::String::modify,
+      .def("modify",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::modify),
           "Marks the record/container as modified to send over transport")
 
       // exchange vectors
-      .def("exchange", &madara::knowledge::containers::String::exchange,
+      .def("exchange",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::exchange),
           "Exchanges the string at this location with the string at another"
           "location")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::String::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&)>(
-              &madara::knowledge::containers::String::set_name),
+          &GilReleased<void (madara::knowledge::containers::String::*)(
+              const std::string&, madara::knowledge::KnowledgeBase&),
+              &madara::knowledge::containers::String::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::String::*)(
-              const std::string&, madara::knowledge::Variables&)>(
-              &madara::knowledge::containers::String::set_name),
+          &GilReleased<void (madara::knowledge::containers::String::*)(
+              const std::string&, madara::knowledge::Variables&),
+              &madara::knowledge::containers::String::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::String::*)(
-              const std::string&, madara::knowledge::ThreadSafeContext&)>(
-              &madara::knowledge::containers::String::set_name),
+          &GilReleased<void (madara::knowledge::containers::String::*)(
+              const std::string&, madara::knowledge::ThreadSafeContext&),
+              &madara::knowledge::containers::String::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
-      .def("set_settings", &madara::knowledge::containers::String::set_settings,
+      .def("set_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::String::set_settings),
           "Sets the read/write settings for the container")
 
       // returns the double
-      .def("to_double", &madara::knowledge::containers::String::to_double,
+      .def("to_double",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::to_double),
           "Returns the double")
 
       // returns the integer
-      .def("to_integer", &madara::knowledge::containers::String::to_integer,
+      .def("to_integer",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::String::to_integer),
           "Returns the integer")
 
       // returns the record
-      .def("to_record", &madara::knowledge::containers::String::to_record,
+      .def("to_record",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::to_record),
           "Returns the underlying record")
 
       // returns the container as a string
-      .def("to_string", &madara::knowledge::containers::String::to_string,
+      .def("to_string",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::to_string),
           "Returns the container as a string")
 
       // set writing quality
-      .def("set_quality", &madara::knowledge::containers::String::set_quality,
+      .def("set_quality",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::String::set_quality),
           "Sets the quality of writing to a certain variable from this entity")
 
       // returns the integer
       .def("get_debug_info",
-          &madara::knowledge::containers::String::get_debug_info,
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::String::get_debug_info),
           "Returns the type of the container along with name and any other"
           "useful information. The provided information should be useful"
           "for developers wishing to debug container operations, especially"
@@ -1187,33 +1442,49 @@ void define_knowledge_containers(void)
           "in conjunction with modify")
 
       // find if  value is present
-      .def("is_true", &madara::knowledge::containers::String::is_true,
+      .def("is_true",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::is_true),
           "Determines if the value is true")
 
       // find if  value is not present
-      .def("is_false", &madara::knowledge::containers::String::is_false,
+      .def("is_false",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::String::is_false),
           "Determines if the value is false")
 
       // returns the container as a string
       .def("set",
-          static_cast<std::string (madara::knowledge::containers::String::*)(
-              const std::string&)>(
-              &madara::knowledge::containers::String::operator=),
+          &GilReleased<std::string (madara::knowledge::containers::String::*)(
+              const std::string&),
+              &madara::knowledge::containers::String::operator= >::call,
           "Sets the value")
 
-      .def(self += std::string())
+      .def("__iadd__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::iadd)
 
-      .def(self < std::string())
+      .def("__lt__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::lt)
 
-      .def(self <= std::string())
+      .def("__le__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::le)
 
-      .def(self != std::string())
+      .def("__ne__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::ne)
 
-      .def(self == std::string())
+      .def("__eq__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::eq)
 
-      .def(self >= std::string())
+      .def("__ge__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::ge)
 
-      .def(self > std::string());
+      .def("__gt__",
+          &GilReleasedOperators<madara::knowledge::containers::String,
+              std::string>::gt);
 
   class_<madara::knowledge::containers::Vector>("Vector",
       "References a vector with O(1) access times for variables in a context",
@@ -1226,105 +1497,117 @@ void define_knowledge_containers(void)
       // methods
 
       // check for existence
-      .def("exists", &madara::knowledge::containers::Vector::exists,
+      .def("exists",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Vector::exists),
           "Checks if the underlying record has ever been modified/created")
 
       // gets the underlying prefix/name
-      .def("get_name", &madara::knowledge::containers::Vector::get_name,
+      .def("get_name",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Vector::get_name),
           "Returns the underlying name of the container")
 
       // gets the underlying prefix/name
-      .def("get_settings", &madara::knowledge::containers::Vector::get_settings,
+      .def("get_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Vector::get_settings),
           "Returns the read/write settings of the container")
 
       // modifies the container
       .def("modify",
-          static_cast<void (madara::knowledge::containers::Vector::*)(void)>(
-              &madara::knowledge::containers::Vector::modify),
+          &GilReleased<void (madara::knowledge::containers::Vector::*)(void),
+              &madara::knowledge::containers::Vector::modify>::call,
           "Marks the record/container as modified to send over transport")
 
       // modifies the container
       .def("modify",
-          static_cast<void (madara::knowledge::containers::Vector::*)(size_t)>(
-              &madara::knowledge::containers::Vector::modify),
+          &GilReleased<void (madara::knowledge::containers::Vector::*)(size_t),
+              &madara::knowledge::containers::Vector::modify>::call,
           "Marks the index as modified to send over transport")
 
       // gets the underlying prefix/name
-      .def("modify_size", &madara::knowledge::containers::Vector::modify_size,
+      .def("modify_size",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Vector::modify_size),
           "Marks the vector size as modified so it can be sent over transport")
 
       // pushes a record onto the back of the vector
-      .def("push_back", &madara::knowledge::containers::Vector::push_back,
+      .def("push_back",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Vector::push_back),
           "Pushes a record onto the back of the vector")
 
       // pushes a record onto the back of the vector
-      .def("resize", &madara::knowledge::containers::Vector::resize,
-          m_resize_0_of_2(args("size", "delete_vars"), "Resizes the vector to "
-                                                       "a size and potentially "
-                                                       "deleting unused vars"))
+      .def("resize",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Vector::resize),
+          (arg("self"), arg("size") = -1, arg("delete_vars") = true),
+          "Resizes the vector to a size and potentially deleting unused vars")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Vector::*)(
-              const std::string&, madara::knowledge::KnowledgeBase&, int)>(
-              &madara::knowledge::containers::Vector::set_name),
+          &GilReleased<void (madara::knowledge::containers::Vector::*)(
+              const std::string&, madara::knowledge::KnowledgeBase&, int),
+              &madara::knowledge::containers::Vector::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // sets the name
       .def("set_name",
-          static_cast<void (madara::knowledge::containers::Vector::*)(
-              const std::string&, madara::knowledge::Variables&, int)>(
-              &madara::knowledge::containers::Vector::set_name),
+          &GilReleased<void (madara::knowledge::containers::Vector::*)(
+              const std::string&, madara::knowledge::Variables&, int),
+              &madara::knowledge::containers::Vector::set_name>::call,
           "Sets the name inside of the Knowledge Base for the container to use")
 
       // gets the underlying prefix/name
-      .def("set_settings", &madara::knowledge::containers::Vector::set_settings,
+      .def("set_settings",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Vector::set_settings),
           "Sets the read/write settings for the container")
 
       // returns the record
-      .def("to_record", &madara::knowledge::containers::Vector::to_record,
+      .def("to_record",
+          MADARA_GIL_RELEASED(madara::knowledge::containers::Vector::to_record),
           "Returns an underlying record")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
-              size_t index, const madara::knowledge::KnowledgeRecord& value)>(
-              &madara::knowledge::containers::Vector::set),
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
+              size_t index, const madara::knowledge::KnowledgeRecord& value),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an index in the vector to a KnowledgeRecord")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
               size_t index, const madara::knowledge::KnowledgeRecord& value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::Vector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an index in the vector to a KnowlegeRecord")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
-              size_t index, const std::vector<double>& value)>(
-              &madara::knowledge::containers::Vector::set),
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
+              size_t index, const std::vector<double>& value),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
               size_t index, const std::vector<double>& value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::Vector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an index in the vector")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
-              size_t index, const std::vector<int64_t>& value)>(
-              &madara::knowledge::containers::Vector::set),
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
+              size_t index, const std::vector<int64_t>& value),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an integer array at an index in the vector")
 
       .def("set",
-          static_cast<int (madara::knowledge::containers::Vector::*)(
+          &GilReleased<int (madara::knowledge::containers::Vector::*)(
               size_t index, const std::vector<int64_t>& value,
-              const madara::knowledge::KnowledgeUpdateSettings& settings)>(
-              &madara::knowledge::containers::Vector::set),
+              const madara::knowledge::KnowledgeUpdateSettings& settings),
+              &madara::knowledge::containers::Vector::set>::call,
           "Sets an integer array at an index in the vector")
 
-      .def("__getitem__", &madara::knowledge::containers::Vector::operator[],
+      .def("__getitem__",
+          MADARA_GIL_RELEASED(
+              madara::knowledge::containers::Vector::operator[]),
           "Gets an index of the vector");
 }
 
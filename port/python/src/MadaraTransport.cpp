@@ -186,10 +186,46 @@ void define_transport(void)
           &madara::transport::TransportSettings::read_thread_hertz,
           "Indicates the read thread hertz rate")
 
+      .def_readwrite("decode_threads",
+          &madara::transport::TransportSettings::decode_threads,
+          "Number of threads that decode received messages (0 for none)")
+
+      .def_readwrite("coalesce_receives",
+          &madara::transport::TransportSettings::coalesce_receives,
+          "Indicates that only the newest values in a receive batch apply")
+
       .def_readwrite("send_reduced_message_header",
           &madara::transport::TransportSettings::send_reduced_message_header,
           "Indicates that a reduced message header should be used for messages")
 
+      .def_readwrite("send_compact_encoding",
+          &madara::transport::TransportSettings::send_compact_encoding,
+          "Indicates that messages should use the compact wire encoding")
+
+      .def_readwrite("compact_dictionary_refresh",
+          &madara::transport::TransportSettings::compact_dictionary_refresh,
+          "Seconds between announcements of compact encoding variable ids")
+
+      .def_readwrite("compact_dictionary_size",
+          &madara::transport::TransportSettings::compact_dictionary_size,
+          "The most variables given ids in the compact encoding")
+
+      .def_readwrite("send_array_deltas",
+          &madara::transport::TransportSettings::send_array_deltas,
+          "Indicates that indexed changes to arrays should be sent as deltas")
+
+      .def_readwrite("array_delta_keyframe_interval",
+          &madara::transport::TransportSettings::array_delta_keyframe_interval,
+          "Every Nth send of an array with deltas enabled is a full update")
+
+      .def_readwrite("use_topics",
+          &madara::transport::TransportSettings::use_topics,
+          "Indicates that messages should be published on domain topics")
+
+      .def_readwrite("topic_prefixes",
+          &madara::transport::TransportSettings::topic_prefixes,
+          "Variable prefixes that partition updates into topics")
+
       .def_readwrite("hosts", &madara::transport::TransportSettings::hosts,
           "List of hosts for the transport layer")
 
@@ -415,6 +451,37 @@ void define_transport(void)
           "Informs the transport of the total bandwidth limit in B/s that"
           " throttles the sending of new updates")
 
+      // the burst size of the send bandwidth limit
+      .add_property("send_bandwidth_burst",
+          &madara::transport::QoSTransportSettings::get_send_bandwidth_burst,
+          &madara::transport::QoSTransportSettings::set_send_bandwidth_burst,
+          "Informs the transport of the largest burst in bytes sent before"
+          " the send bandwidth limit delays low priority updates")
+
+      // the priority that the send bandwidth limit never delays
+      .add_property("critical_send_priority",
+          &madara::transport::QoSTransportSettings::get_critical_send_priority,
+          &madara::transport::QoSTransportSettings::set_critical_send_priority,
+          "Informs the transport of the lowest update priority that is"
+          " sent even when the send bandwidth limit is exceeded")
+
+      // the number of updates delayed by the send bandwidth limit
+      .add_property("max_delayed_sends",
+          &madara::transport::QoSTransportSettings::get_max_delayed_sends,
+          &madara::transport::QoSTransportSettings::set_max_delayed_sends,
+          "Informs the transport of the maximum number of updates that"
+          " may wait for the send bandwidth limit before dropping")
+
+      // sets the send priority of a prefix
+      .def("set_send_priority",
+          &madara::transport::QoSTransportSettings::set_send_priority,
+          "Sets the send priority of variables starting with a prefix")
+
+      // removes the send priority of a prefix
+      .def("remove_send_priority",
+          &madara::transport::QoSTransportSettings::remove_send_priority,
+          "Removes the send priority of a prefix")
+
       // the deadline for messages
       .add_property("deadline",
           &madara::transport::QoSTransportSettings::get_deadline,
@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+
+# Tests and benchmarks reading and writing related variables with one lock
+# (get_all/set_all) versus one get/set per variable.
+#
+# usage: python test_bulk_access.py [num_variables] [iterations]
+
+import sys
+import time
+import madara
+import madara.knowledge as engine
+
+num_variables = 50
+iterations = 1000
+
+if len(sys.argv) > 1:
+  num_variables = int(sys.argv[1])
+
+if len(sys.argv) > 2:
+  iterations = int(sys.argv[2])
+
+madara_fails = 0
+
+def check(name, condition):
+  global madara_fails
+  if condition:
+    print("  " + name + ": SUCCESS")
+  else:
+    print("  " + name + ": FAIL")
+    madara_fails += 1
+
+def time_us(function):
+  start = time.perf_counter()
+  for i in range(iterations):
+    result = function()
+  return (time.perf_counter() - start) * 1000000.0 / iterations, result
+
+kb = engine.KnowledgeBase()
+
+print("\nTesting get_all and set_all...")
+
+names = madara.StringVector()
+records = engine.KnowledgeRecordVector()
+
+for i in range(num_variables):
+  names.append("agent.0.var" + str(i))
+  records.append(engine.KnowledgeRecord(i * 0.5))
+
+check("set_all result", kb.set_all(names, records) == 0)
+
+values = kb.get_all(names)
+
+check("get_all length", len(values) == num_variables)
+check("get_all values",
+  all(values[i].to_double() == i * 0.5 for i in range(num_variables)))
+
+names.append("agent.0.missing")
+check("get_all of missing variable", not kb.get_all(names)[-1].exists())
+check("get_all does not create variables", not kb.exists("agent.0.missing"))
+del names[len(names) - 1]
+
+print("\nBenchmarking %d variables over %d iterations..." %
+  (num_variables, iterations))
+
+each_us, _ = time_us(lambda: [kb.get(name) for name in names])
+all_us, _ = time_us(lambda: kb.get_all(names))
+
+print("  get per variable: %.1f us" % each_us)
+print("  get_all:          %.1f us" % all_us)
+
+if madara_fails > 0:
+  print("OVERALL: FAIL. %d tests failed." % madara_fails)
+else:
+  print("OVERALL: SUCCESS.")
+
+sys.exit(madara_fails)
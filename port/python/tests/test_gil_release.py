@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+
+# Tests that blocking KnowledgeBase calls release the Python GIL so that
+# other Python threads make progress, and that Python functions called
+# from KaRL still work (they reacquire the GIL).
+#
+# usage: python test_gil_release.py
+
+import sys
+import time
+import threading
+import madara.knowledge as engine
+
+madara_fails = 0
+
+def check(name, condition):
+  global madara_fails
+  if condition:
+    print("  " + name + ": SUCCESS")
+  else:
+    print("  " + name + ": FAIL")
+    madara_fails += 1
+
+kb = engine.KnowledgeBase()
+
+print("\nTesting concurrent progress during kb.wait...")
+
+settings = engine.WaitSettings()
+settings.poll_frequency = 0.01
+settings.max_wait_time = 5.0
+
+results = {}
+
+def waiter():
+  start = time.time()
+  results["wait"] = kb.wait("finished", settings).to_integer()
+  results["wait_time"] = time.time() - start
+
+thread = threading.Thread(target=waiter)
+thread.start()
+
+# this loop only makes progress if the waiting thread released the GIL
+iterations = 0
+start = time.time()
+while time.time() - start < 0.5:
+  iterations += 1
+
+kb.set("finished", 1)
+thread.join()
+
+print("  main thread iterations during wait: {0}".format(iterations))
+print("  wait returned after {0:.3f} s".format(results["wait_time"]))
+
+check("main thread progressed during wait", iterations > 1000)
+check("wait saw the update before timeout",
+  results["wait"] == 1 and results["wait_time"] < settings.max_wait_time)
+
+print("\nTesting Python functions called from evaluate in threads...")
+
+def increment(args, variables):
+  return engine.KnowledgeRecord(variables.get("calls").to_integer() + 1)
+
+kb.define_function("increment", increment)
+
+def evaluator():
+  for i in range(100):
+    kb.evaluate("calls = increment ()")
+
+threads = [threading.Thread(target=evaluator) for i in range(4)]
+for t in threads:
+  t.start()
+for t in threads:
+  t.join()
+
+check("python function reacquired GIL",
+  kb.get("calls").to_integer() == 400)
+
+if madara_fails > 0:
+  print("OVERALL: FAIL. {0} tests failed.".format(madara_fails))
+  sys.exit(1)
+else:
+  print("OVERALL: SUCCESS.")
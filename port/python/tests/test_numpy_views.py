@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+
+# Tests and benchmarks zero-copy NumPy views over KB arrays versus the
+# element-by-element to_doubles/from_pydoubles conversions.
+#
+# usage: python test_numpy_views.py [num_elements] [iterations]
+
+import sys
+import time
+import numpy
+import madara
+import madara.knowledge as engine
+
+num_elements = 1000000
+iterations = 10
+
+if len(sys.argv) > 1:
+  num_elements = int(sys.argv[1])
+
+if len(sys.argv) > 2:
+  iterations = int(sys.argv[2])
+
+madara_fails = 0
+
+def check(name, condition):
+  global madara_fails
+  if condition:
+    print("  " + name + ": SUCCESS")
+  else:
+    print("  " + name + ": FAIL")
+    madara_fails += 1
+
+def time_ms(function):
+  start = time.perf_counter()
+  for i in range(iterations):
+    result = function()
+  return (time.perf_counter() - start) * 1000.0 / iterations, result
+
+kb = engine.KnowledgeBase()
+
+print("\nTesting zero-copy views...")
+
+source = numpy.arange(num_elements, dtype=numpy.float64) * 0.5
+kb.set_array("doubles", source)
+
+view = kb.view_doubles("doubles")
+array = numpy.asarray(view)
+
+check("set_array/view_doubles length", len(view) == num_elements)
+check("view_doubles dtype", array.dtype == numpy.float64)
+check("view_doubles values", numpy.array_equal(array, source))
+check("view_doubles is read-only", not array.flags.writeable)
+
+# overwriting the variable must not invalidate an existing view
+kb.set("doubles", 1.0)
+check("view survives overwrite", numpy.array_equal(array, source))
+
+ints = numpy.arange(num_elements, dtype=numpy.int64)
+kb.set_array("integers", ints)
+int_array = numpy.asarray(kb.view_integers("integers"))
+
+check("view_integers dtype", int_array.dtype == numpy.int64)
+check("view_integers values", numpy.array_equal(int_array, ints))
+
+record = engine.KnowledgeRecord()
+record.set_array(source[:10])
+check("KnowledgeRecord.set_array", record.is_array_type() and
+  record.size() == 10)
+check("KnowledgeRecord.view_doubles",
+  numpy.array_equal(numpy.asarray(record.view_doubles()), source[:10]))
+
+try:
+  kb.set_array("bad", numpy.arange(10, dtype=numpy.float32))
+  check("set_array rejects float32", False)
+except TypeError:
+  check("set_array rejects float32", True)
+
+print("\nBenchmarking {0} elements over {1} iterations...".format(
+  num_elements, iterations))
+
+kb.set_array("doubles", source)
+
+list_ms, list_result = time_ms(
+  lambda: numpy.array(madara.to_pydoubles(kb.get("doubles").to_doubles())))
+view_ms, view_result = time_ms(
+  lambda: numpy.asarray(kb.view_doubles("doubles")))
+
+check("get paths agree", numpy.array_equal(list_result, view_result))
+
+print("  get via to_doubles:      {0:10.3f} ms".format(list_ms))
+print("  get via view_doubles:    {0:10.3f} ms".format(view_ms))
+
+as_list = source.tolist()
+from_ms, ignored = time_ms(
+  lambda: kb.set("doubles", madara.from_pydoubles(as_list)))
+bulk_ms, ignored = time_ms(lambda: kb.set_array("doubles", source))
+
+print("  set via from_pydoubles:  {0:10.3f} ms".format(from_ms))
+print("  set via set_array:       {0:10.3f} ms".format(bulk_ms))
+
+if madara_fails > 0:
+  print("OVERALL: FAIL. {0} tests failed.".format(madara_fails))
+  sys.exit(1)
+else:
+  print("OVERALL: SUCCESS.")
@@ -0,0 +1,551 @@
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/ContextGuard.h"
+#include "madara/knowledge/containers/Barrier.h"
+#include "madara/knowledge/containers/CircularBuffer.h"
+#include "madara/knowledge/containers/Counter.h"
+#include "madara/knowledge/containers/FlexMap.h"
+#include "madara/knowledge/containers/Map.h"
+#include "madara/knowledge/containers/Queue.h"
+#include "madara/transport/SharedMemoryPush.h"
+#include "madara/logger/GlobalLogger.h"
+#include "madara/utility/Utility.h"
+
+/**
+ * Profiles the distributed containers as participants and elements grow.
+ * Each participant is a knowledge base linked to all others with a
+ * SharedMemoryPush transport, and each operation sends its modifications.
+ * For every container, participant count and element count, the profile
+ * reports operations per second, latency percentiles of an operation, the
+ * wait of a probe thread that locks the first knowledge base (which bounds
+ * how long operations and pushed updates hold the lock), and the encoded
+ * bytes sent per operation. Results are printed as a table and written as
+ * JSON for regression tracking.
+ **/
+
+namespace logger = madara::logger;
+namespace knowledge = madara::knowledge;
+namespace containers = madara::knowledge::containers;
+namespace transport = madara::transport;
+namespace utility = madara::utility;
+
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+// command line arguments
+std::vector<size_t> participant_counts = {2, 4, 8, 16};
+std::vector<size_t> element_counts = {10, 100, 1000};
+std::vector<std::string> selected;
+size_t operations = 1000;
+std::string json_file = "profile_containers.json";
+
+// encoded bytes of all records sent by any participant
+std::atomic<uint64_t> bytes_sent(0);
+
+/**
+ * Statistics for one profile run
+ **/
+struct Result
+{
+  std::string container;
+  size_t participants;
+  size_t elements;
+  size_t ops;
+  double ops_per_sec;
+  std::vector<int64_t> latencies;
+  std::vector<int64_t> lock_waits;
+  double bytes_per_op;
+};
+
+std::vector<Result> results;
+
+std::vector<size_t> to_sizes(const std::string& list)
+{
+  std::vector<size_t> sizes;
+  std::stringstream buffer(list);
+  std::string token;
+
+  while (std::getline(buffer, token, ','))
+  {
+    sizes.push_back((size_t)std::stoul(token));
+  }
+
+  return sizes;
+}
+
+void handle_arguments(int argc, char** argv)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg1(argv[i]);
+
+    if ((arg1 == "-c" || arg1 == "--containers") && i + 1 < argc)
+    {
+      std::stringstream buffer(argv[i + 1]);
+      std::string token;
+
+      while (std::getline(buffer, token, ','))
+      {
+        selected.push_back(token);
+      }
+
+      ++i;
+    }
+    else if ((arg1 == "-e" || arg1 == "--elements") && i + 1 < argc)
+    {
+      element_counts = to_sizes(argv[i + 1]);
+      ++i;
+    }
+    else if ((arg1 == "-j" || arg1 == "--json") && i + 1 < argc)
+    {
+      json_file = argv[i + 1];
+      ++i;
+    }
+    else if ((arg1 == "-n" || arg1 == "--participants") && i + 1 < argc)
+    {
+      participant_counts = to_sizes(argv[i + 1]);
+      ++i;
+    }
+    else if ((arg1 == "-o" || arg1 == "--ops") && i + 1 < argc)
+    {
+      operations = (size_t)std::stoul(argv[i + 1]);
+      ++i;
+    }
+    else
+    {
+      madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+          "\nProgram arguments for %s:\n"
+          " [-c|--containers list]   containers to profile, e.g., "
+          "Counter,Map.\n"
+          "                          Barrier, CircularBuffer, Counter, "
+          "FlexMap,\n"
+          "                          Map and Queue are profiled by default.\n"
+          " [-e|--elements list]     element counts for Map, FlexMap, Queue "
+          "and\n"
+          "                          CircularBuffer (default 10,100,1000)\n"
+          " [-j|--json file]         file to write JSON results to\n"
+          "                          (default profile_containers.json)\n"
+          " [-n|--participants list] participant counts (default "
+          "2,4,8,16)\n"
+          " [-o|--ops count]         operations per run (default 1000)\n"
+          "\n",
+          argv[0]);
+      exit(0);
+    }
+  }
+}
+
+bool is_selected(const std::string& container)
+{
+  return selected.size() == 0 ||
+         std::find(selected.begin(), selected.end(), container) !=
+             selected.end();
+}
+
+/**
+ * Counts the encoded bytes of each send, before the transport pushes it
+ **/
+void count_bytes(knowledge::KnowledgeMap& records,
+    const transport::TransportContext&, knowledge::Variables&)
+{
+  uint64_t bytes = 0;
+
+  for (auto& record : records)
+  {
+    bytes += (uint64_t)record.second.get_encoded_size(record.first);
+  }
+
+  bytes_sent += bytes;
+}
+
+/**
+ * Participants linked with SharedMemoryPush transports
+ **/
+class Swarm
+{
+public:
+  Swarm(size_t participants) : kbs(participants)
+  {
+    transport::QoSTransportSettings settings;
+    settings.add_send_filter(count_bytes);
+
+    for (auto& kb : kbs)
+    {
+      transport::SharedMemoryPush* push =
+          new transport::SharedMemoryPush(kb.get_id(), settings, kb);
+
+      push->set(kbs);
+
+      kb.attach_transport(push);
+    }
+  }
+
+  ~Swarm()
+  {
+    // the transports refer to every knowledge base, so close them to
+    // release the knowledge bases
+    for (auto& kb : kbs)
+    {
+      kb.close_transport();
+    }
+  }
+
+  std::vector<knowledge::KnowledgeBase> kbs;
+};
+
+/**
+ * Runs an operation and records its statistics. A probe thread locks the
+ * first knowledge base while the operations run.
+ * @param  container     the name of the container
+ * @param  participants  the number of participants
+ * @param  elements      the number of elements, or 0 if not applicable
+ * @param  swarm         the participants
+ * @param  op            the operation, which receives its index
+ **/
+void profile(const std::string& container, size_t participants,
+    size_t elements, Swarm& swarm, const std::function<void(size_t)>& op)
+{
+  Result result;
+  result.container = container;
+  result.participants = participants;
+  result.elements = elements;
+  result.ops = operations;
+  result.latencies.reserve(operations);
+
+  std::atomic<bool> done(false);
+
+  std::thread probe([&]() {
+    while (!done)
+    {
+      int64_t start = utility::get_time();
+
+      {
+        knowledge::ContextGuard guard(swarm.kbs[0]);
+      }
+
+      result.lock_waits.push_back(utility::get_time() - start);
+
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+
+  uint64_t bytes_start = bytes_sent;
+  int64_t start = utility::get_time();
+
+  for (size_t i = 0; i < operations; ++i)
+  {
+    int64_t op_start = utility::get_time();
+    op(i);
+    result.latencies.push_back(utility::get_time() - op_start);
+  }
+
+  int64_t elapsed = utility::get_time() - start;
+
+  done = true;
+  probe.join();
+
+  result.ops_per_sec = operations * 1000000000.0 / (elapsed > 0 ? elapsed : 1);
+  result.bytes_per_op =
+      (double)(bytes_sent - bytes_start) / (operations > 0 ? operations : 1);
+
+  std::sort(result.latencies.begin(), result.latencies.end());
+  std::sort(result.lock_waits.begin(), result.lock_waits.end());
+
+  results.push_back(result);
+}
+
+/**
+ * Returns a percentile of sorted samples
+ **/
+int64_t percentile(const std::vector<int64_t>& samples, double percent)
+{
+  if (samples.size() == 0)
+  {
+    return 0;
+  }
+
+  size_t index = (size_t)(percent / 100.0 * (samples.size() - 1) + 0.5);
+
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+void profile_barrier(size_t participants)
+{
+  Swarm swarm(participants);
+  std::vector<containers::Barrier> barriers(participants);
+
+  for (size_t i = 0; i < participants; ++i)
+  {
+    barriers[i].set_name("swarm.barrier", swarm.kbs[i], (int)i,
+        (int)participants);
+  }
+
+  // one operation is a full round of the barrier
+  profile("Barrier", participants, 0, swarm, [&](size_t) {
+    for (size_t i = 0; i < participants; ++i)
+    {
+      barriers[i].next();
+      swarm.kbs[i].send_modifieds();
+    }
+
+    for (size_t i = 0; i < participants; ++i)
+    {
+      barriers[i].is_done();
+    }
+  });
+}
+
+void profile_counter(size_t participants)
+{
+  Swarm swarm(participants);
+  std::vector<containers::Counter> counters;
+
+  for (size_t i = 0; i < participants; ++i)
+  {
+    counters.push_back(containers::Counter(
+        "swarm.count", swarm.kbs[i], (int)i, (int)participants));
+  }
+
+  profile("Counter", participants, 0, swarm, [&](size_t op) {
+    size_t i = op % participants;
+    ++counters[i];
+    swarm.kbs[i].send_modifieds();
+    counters[(i + 1) % participants].to_integer();
+  });
+}
+
+void profile_queue(size_t participants, size_t elements)
+{
+  Swarm swarm(participants);
+  std::vector<containers::Queue> queues;
+
+  // each participant owns a queue that the others observe
+  for (size_t i = 0; i < participants; ++i)
+  {
+    queues.push_back(containers::Queue("agent." + std::to_string(i) +
+        ".queue", swarm.kbs[i], (int)elements));
+
+    for (size_t j = 0; j < elements / 2; ++j)
+    {
+      queues[i].enqueue(knowledge::KnowledgeRecord(Integer(j)));
+    }
+
+    swarm.kbs[i].send_modifieds();
+  }
+
+  profile("Queue", participants, elements, swarm, [&](size_t op) {
+    size_t i = op % participants;
+    queues[i].enqueue(knowledge::KnowledgeRecord(Integer(op)));
+    queues[i].dequeue(false);
+    swarm.kbs[i].send_modifieds();
+  });
+}
+
+void profile_circular_buffer(size_t participants, size_t elements)
+{
+  Swarm swarm(participants);
+  std::vector<containers::CircularBuffer> buffers;
+
+  // each participant owns a buffer that the others observe
+  for (size_t i = 0; i < participants; ++i)
+  {
+    buffers.push_back(containers::CircularBuffer("agent." +
+        std::to_string(i) + ".buffer", swarm.kbs[i], (int)elements));
+  }
+
+  profile("CircularBuffer", participants, elements, swarm, [&](size_t op) {
+    size_t i = op % participants;
+    buffers[i].add(knowledge::KnowledgeRecord(Integer(op)));
+    swarm.kbs[i].send_modifieds();
+  });
+}
+
+void profile_map(size_t participants, size_t elements)
+{
+  Swarm swarm(participants);
+
+  for (size_t j = 0; j < elements; ++j)
+  {
+    swarm.kbs[0].set("swarm.map.key" + std::to_string(j), Integer(j));
+  }
+  swarm.kbs[0].send_modifieds();
+
+  std::vector<containers::Map> maps;
+
+  for (size_t i = 0; i < participants; ++i)
+  {
+    maps.push_back(containers::Map("swarm.map", swarm.kbs[i]));
+  }
+
+  // a writer sets an element and the next participant refreshes its keys
+  profile("Map", participants, elements, swarm, [&](size_t op) {
+    size_t i = op % participants;
+    maps[i].set("key" + std::to_string(op % elements), Integer(op));
+    swarm.kbs[i].send_modifieds();
+    maps[(i + 1) % participants].sync_keys();
+  });
+}
+
+void profile_flex_map(size_t participants, size_t elements)
+{
+  Swarm swarm(participants);
+
+  for (size_t j = 0; j < elements; ++j)
+  {
+    swarm.kbs[0].set("swarm.flex.key" + std::to_string(j), Integer(j));
+  }
+  swarm.kbs[0].send_modifieds();
+
+  std::vector<containers::FlexMap> maps;
+
+  for (size_t i = 0; i < participants; ++i)
+  {
+    maps.push_back(containers::FlexMap("swarm.flex", swarm.kbs[i]));
+  }
+
+  // a writer sets an element and the next participant lists the keys
+  profile("FlexMap", participants, elements, swarm, [&](size_t op) {
+    size_t i = op % participants;
+    maps[i]["key" + std::to_string(op % elements)] = Integer(op);
+    swarm.kbs[i].send_modifieds();
+
+    std::vector<std::string> keys;
+    maps[(i + 1) % participants].keys(keys);
+  });
+}
+
+void print_results(void)
+{
+  std::stringstream buffer;
+
+  buffer << "\nContainer       Agents Elements     ops/sec   p50 ns   "
+            "p99 ns   max ns  lock p99 ns  bytes/op\n";
+
+  for (auto& result : results)
+  {
+    buffer << std::left << std::setw(16) << result.container << std::right
+           << std::setw(6) << result.participants << std::setw(9)
+           << result.elements << std::setw(12) << std::fixed
+           << std::setprecision(1) << result.ops_per_sec << std::setw(9)
+           << percentile(result.latencies, 50) << std::setw(9)
+           << percentile(result.latencies, 99) << std::setw(9)
+           << percentile(result.latencies, 100) << std::setw(13)
+           << percentile(result.lock_waits, 99) << std::setw(10)
+           << result.bytes_per_op << "\n";
+  }
+
+  std::cerr << buffer.str();
+}
+
+void write_json(void)
+{
+  std::ofstream file(json_file);
+
+  if (!file)
+  {
+    madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ERROR,
+        "Unable to write %s\n", json_file.c_str());
+    return;
+  }
+
+  file << "{\n  \"benchmark\": \"profile_containers\",\n";
+  file << "  \"operations\": " << operations << ",\n";
+  file << "  \"results\": [\n";
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& result = results[i];
+
+    file << "    {\"container\": \"" << result.container << "\""
+         << ", \"participants\": " << result.participants
+         << ", \"elements\": " << result.elements
+         << ", \"ops\": " << result.ops << ", \"ops_per_sec\": "
+         << result.ops_per_sec << ",\n     \"latency_ns\": {\"p50\": "
+         << percentile(result.latencies, 50)
+         << ", \"p90\": " << percentile(result.latencies, 90)
+         << ", \"p99\": " << percentile(result.latencies, 99)
+         << ", \"max\": " << percentile(result.latencies, 100)
+         << "},\n     \"lock_wait_ns\": {\"p50\": "
+         << percentile(result.lock_waits, 50)
+         << ", \"p99\": " << percentile(result.lock_waits, 99)
+         << ", \"max\": " << percentile(result.lock_waits, 100)
+         << ", \"samples\": " << result.lock_waits.size()
+         << "},\n     \"bytes_per_op\": " << result.bytes_per_op << "}"
+         << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  file << "  ]\n}\n";
+
+  std::cerr << "\nWrote " << results.size() << " results to " << json_file
+            << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  handle_arguments(argc, argv);
+
+  for (size_t participants : participant_counts)
+  {
+    if (participants == 0)
+    {
+      continue;
+    }
+
+    std::cerr << "Profiling containers with " << participants
+              << " participants...\n";
+
+    if (is_selected("Barrier"))
+    {
+      profile_barrier(participants);
+    }
+
+    if (is_selected("Counter"))
+    {
+      profile_counter(participants);
+    }
+
+    for (size_t elements : element_counts)
+    {
+      if (elements == 0)
+      {
+        continue;
+      }
+
+      if (is_selected("Queue"))
+      {
+        profile_queue(participants, elements);
+      }
+
+      if (is_selected("CircularBuffer"))
+      {
+        profile_circular_buffer(participants, elements);
+      }
+
+      if (is_selected("Map"))
+      {
+        profile_map(participants, elements);
+      }
+
+      if (is_selected("FlexMap"))
+      {
+        profile_flex_map(participants, elements);
+      }
+    }
+  }
+
+  print_results();
+  write_json();
+
+  return 0;
+}
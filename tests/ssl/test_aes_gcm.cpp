@@ -0,0 +1,285 @@
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "madara/utility/Utility.h"
+#include "madara/filters/ssl/AESBufferFilter.h"
+#include "madara/filters/ssl/AESGCMBufferFilter.h"
+#include "../test.h"
+
+namespace filters = madara::filters;
+namespace utility = madara::utility;
+
+/**
+ * Builds a payload of a given size
+ **/
+std::vector<char> build_payload(size_t size)
+{
+  std::vector<char> payload(size);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    payload[i] = (char)(i * 31 + i / 7);
+  }
+
+  return payload;
+}
+
+/**
+ * Encodes and decodes a payload with a pair of filters, returning the
+ * decoded size, or -1 if the decoded payload differs
+ **/
+int round_trip(const filters::BufferFilter& encoder,
+    const filters::BufferFilter& decoder, const std::vector<char>& payload)
+{
+  std::vector<char> buffer(payload.size() + 64);
+  memcpy(buffer.data(), payload.data(), payload.size());
+
+  int size = encoder.encode(
+      buffer.data(), (int)payload.size(), (int)buffer.size());
+  size = decoder.decode(buffer.data(), size, (int)buffer.size());
+
+  if (size != (int)payload.size() ||
+      memcmp(buffer.data(), payload.data(), payload.size()) != 0)
+  {
+    return -1;
+  }
+
+  return size;
+}
+
+void test_round_trip(void)
+{
+  log("Testing AES-GCM encode and decode\n");
+
+  filters::AESGCMBufferFilter filter, peer;
+  filter.generate_key("testPassword#214");
+  peer.generate_key("testPassword#214");
+
+  for (size_t size : {0, 1, 15, 16, 17, 1000, 60000})
+  {
+    std::vector<char> payload = build_payload(size);
+    TEST_EQ(round_trip(filter, peer, payload), (int)size);
+  }
+
+  // a copy has the key but its own nonces
+  filters::AESGCMBufferFilter copy(filter);
+  TEST_EQ(round_trip(copy, peer, build_payload(100)), 100);
+
+  std::vector<char> payload = build_payload(100);
+  std::vector<char> first(200), second(200);
+  memcpy(first.data(), payload.data(), payload.size());
+  memcpy(second.data(), payload.data(), payload.size());
+
+  int first_size = filter.encode(first.data(), 100, 200);
+  int second_size = filter.encode(second.data(), 100, 200);
+
+  TEST_EQ(first_size,
+      100 + filters::AESGCMBufferFilter::nonce_size +
+          filters::AESGCMBufferFilter::tag_size);
+  TEST_EQ(second_size, first_size);
+
+  // the same plaintext encrypts differently with each nonce
+  TEST_NE(memcmp(first.data(), second.data(), first_size), 0);
+}
+
+void test_authentication(void)
+{
+  log("Testing AES-GCM rejects modified messages\n");
+
+  filters::AESGCMBufferFilter filter, peer, stranger;
+  filter.generate_key("testPassword#214");
+  peer.generate_key("testPassword#214");
+  stranger.generate_key("anotherPassword");
+
+  std::vector<char> payload = build_payload(500);
+  std::vector<char> buffer(600);
+
+  // flip a bit in the nonce, the ciphertext and the tag
+  for (int position : {3, 200, 520})
+  {
+    memcpy(buffer.data(), payload.data(), payload.size());
+    int size = filter.encode(buffer.data(), 500, 600);
+
+    buffer[position] ^= 0x10;
+
+    TEST_EQ(peer.decode(buffer.data(), size, 600), 0);
+  }
+
+  memcpy(buffer.data(), payload.data(), payload.size());
+  int size = filter.encode(buffer.data(), 500, 600);
+
+  TEST_EQ(stranger.decode(buffer.data(), size, 600), 0);
+  TEST_EQ(peer.decode(buffer.data(), size - 1, 600), 0);
+  TEST_EQ(peer.decode(buffer.data(), 10, 600), 0);
+
+  // a payload that does not fit with the nonce and tag is not encoded
+  TEST_EQ(filter.encode(buffer.data(), 500, 520), 0);
+
+  // decode contexts survive failed messages
+  TEST_EQ(round_trip(filter, peer, payload), 500);
+}
+
+void test_threads(void)
+{
+  log("Testing AES-GCM from multiple threads\n");
+
+  filters::AESGCMBufferFilter filter;
+  filter.generate_key("testPassword#214");
+
+  std::atomic<int> fails(0);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 500; ++i)
+      {
+        if (round_trip(filter, filter, build_payload(100 + t * 50 + i)) < 0)
+        {
+          ++fails;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  TEST_EQ(fails.load(), 0);
+}
+
+void test_key_change(void)
+{
+  log("Testing AES-GCM key changes while other threads encode\n");
+
+  filters::AESGCMBufferFilter filter, peer;
+  filter.generate_key("testPassword#214");
+  peer.generate_key("testPassword#214");
+
+  std::atomic<bool> done(false);
+  std::vector<std::thread> threads;
+
+  // messages in flight during a key change may fail, so only the contexts
+  // they leave behind are checked
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&]() {
+      while (!done)
+      {
+        round_trip(filter, filter, build_payload(100));
+      }
+    });
+  }
+
+  // the last key is the peer's
+  for (int i = 0; i < 20; ++i)
+  {
+    filter.generate_key(i % 2 ? "testPassword#214" : "anotherPassword");
+  }
+
+  done = true;
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  // contexts initialized with an old key are not reused
+  int fails = 0;
+
+  for (int i = 0; i < 50; ++i)
+  {
+    if (round_trip(filter, peer, build_payload(100)) < 0 ||
+        round_trip(peer, filter, build_payload(100)) < 0)
+    {
+      ++fails;
+    }
+  }
+
+  TEST_EQ(fails, 0);
+}
+
+void benchmark_filters(void)
+{
+  log("Benchmarking AES-CBC and AES-GCM filters\n");
+
+  filters::AESBufferFilter cbc;
+  filters::AESGCMBufferFilter gcm;
+  cbc.generate_key("testPassword#214");
+  gcm.generate_key("testPassword#214");
+
+  const filters::BufferFilter* filters_list[] = {&cbc, &gcm};
+  const char* names[] = {"AES-256-CBC", "AES-256-GCM"};
+
+  for (size_t size : {1000, 60000})
+  {
+    std::vector<char> payload = build_payload(size);
+    std::vector<char> buffer(size + 64);
+    int iterations = size < 10000 ? 20000 : 1000;
+
+    for (int f = 0; f < 2; ++f)
+    {
+      const filters::BufferFilter& filter = *filters_list[f];
+      int64_t encode_time = 0;
+      int64_t decode_time = 0;
+      bool matches = true;
+
+      for (int i = 0; i < iterations; ++i)
+      {
+        memcpy(buffer.data(), payload.data(), size);
+
+        int64_t start = utility::get_time();
+        int encoded = filter.encode(buffer.data(), (int)size,
+            (int)buffer.size());
+        int64_t middle = utility::get_time();
+        int decoded = filter.decode(buffer.data(), encoded,
+            (int)buffer.size());
+        int64_t end = utility::get_time();
+
+        encode_time += middle - start;
+        decode_time += end - middle;
+
+        matches = matches && decoded == (int)size;
+      }
+
+      double mb = (double)size * iterations / 1000000;
+
+      log("  %s, %d byte packets: encode %.1f MB/s (%.2f us/packet), "
+          "decode %.1f MB/s (%.2f us/packet)\n",
+          names[f], (int)size, mb / (encode_time / 1000000000.0),
+          encode_time / 1000.0 / iterations,
+          mb / (decode_time / 1000000000.0),
+          decode_time / 1000.0 / iterations);
+
+      TEST_EQ(matches, true);
+    }
+  }
+}
+
+int main(int, char**)
+{
+  test_round_trip();
+  test_authentication();
+  test_threads();
+  test_key_change();
+  benchmark_filters();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
@@ -18,9 +18,12 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <fstream>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <string.h>
+#include <limits>
 
 namespace logger = madara::logger;
 namespace knowledge = madara::knowledge;
@@ -1027,6 +1030,664 @@ bool is_sequential(Iter first, Iter last, I counter = 0)
   return true;
 }
 
+void test_keyframes(void)
+{
+  std::cerr << "\n*********** TESTING KEYFRAMES *************.\n";
+
+  knowledge::CheckpointSettings settings;
+  settings.filename = "test_keyframes.stk";
+  settings.keyframe_interval = 4;
+
+  std::remove(settings.filename.c_str());
+
+  knowledge::KnowledgeBase kb;
+  knowledge::EvalSettings track;
+  track.track_local_changes = true;
+
+  // "constant" is only saved in state 0 and in keyframes
+  kb.set("constant", "unchanged", track);
+
+  for (knowledge::KnowledgeRecord::Integer i = 0; i < 10; ++i)
+  {
+    kb.set("counter", i, track);
+
+    if (i % 3 == 0)
+    {
+      kb.set("every_third", i, track);
+    }
+
+    kb.save_checkpoint(settings);
+  }
+
+  std::cerr << "Test 1: keyframes at states 0, 4 and 8: ";
+
+  knowledge::CheckpointSettings read_settings;
+  read_settings.filename = settings.filename;
+
+  std::vector<bool> keyframes(10, false);
+  std::vector<size_t> state_sizes(10, 0);
+
+  {
+    knowledge::CheckpointReader reader(read_settings);
+
+    for (auto cur = reader.next(); cur.first != ""; cur = reader.next())
+    {
+      if (reader.get_state() < 10)
+      {
+        keyframes[reader.get_state()] = reader.is_keyframe();
+        ++state_sizes[reader.get_state()];
+      }
+    }
+  }
+
+  if (read_settings.states == 10 && keyframes[0] && keyframes[4] &&
+      keyframes[8] && !keyframes[1] && !keyframes[7] && state_sizes[4] == 3 &&
+      state_sizes[5] == 1)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL (" << read_settings.states << " states)\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 2: load state 6 from the nearest keyframe: ";
+
+  knowledge::KnowledgeBase loaded;
+  knowledge::CheckpointSettings seek_settings;
+  seek_settings.filename = settings.filename;
+  seek_settings.initial_state = 6;
+  seek_settings.last_state = 6;
+  seek_settings.seek_keyframe = true;
+
+  loaded.load_context(seek_settings);
+
+  if (loaded.get("constant") == "unchanged" && loaded.get("counter") == 6 &&
+      loaded.get("every_third") == 6)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::string dump;
+    loaded.to_string(dump);
+    std::cerr << "FAIL :\n" << dump << "\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 3: load state 5 from the nearest keyframe: ";
+
+  loaded.clear();
+  seek_settings.initial_state = 5;
+  seek_settings.last_state = 5;
+
+  loaded.load_context(seek_settings);
+
+  if (loaded.get("constant") == "unchanged" && loaded.get("counter") == 5 &&
+      loaded.get("every_third") == 3)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::string dump;
+    loaded.to_string(dump);
+    std::cerr << "FAIL :\n" << dump << "\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 4: without seek_keyframe, state 6 is only a delta: ";
+
+  loaded.clear();
+  seek_settings.initial_state = 6;
+  seek_settings.last_state = 6;
+  seek_settings.seek_keyframe = false;
+
+  loaded.load_context(seek_settings);
+
+  if (!loaded.exists("constant") && loaded.get("counter") == 6 &&
+      loaded.get("every_third") == 6)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::string dump;
+    loaded.to_string(dump);
+    std::cerr << "FAIL :\n" << dump << "\n";
+    ++madara_fails;
+  }
+
+#ifdef _USE_LZ4_
+  std::cerr << "Test 5: seek_keyframe through buffer filters: ";
+
+  filters::LZ4BufferFilter lz4_filter;
+
+  settings.filename = "test_keyframes_lz4.stk";
+  settings.buffer_filters.push_back(&lz4_filter);
+  std::remove(settings.filename.c_str());
+
+  for (knowledge::KnowledgeRecord::Integer i = 0; i < 6; ++i)
+  {
+    kb.set("counter", i, track);
+    kb.save_checkpoint(settings);
+  }
+
+  loaded.clear();
+  seek_settings.filename = settings.filename;
+  seek_settings.buffer_filters = settings.buffer_filters;
+  seek_settings.initial_state = 5;
+  seek_settings.last_state = 5;
+  seek_settings.seek_keyframe = true;
+
+  loaded.load_context(seek_settings);
+
+  if (loaded.get("constant") == "unchanged" && loaded.get("counter") == 5)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::string dump;
+    loaded.to_string(dump);
+    std::cerr << "FAIL :\n" << dump << "\n";
+    ++madara_fails;
+  }
+#endif
+}
+
+/**
+ * Lists a single array and changes it in place once the listing is done,
+ * which is after a snapshot save has copied it but before it is written
+ **/
+class ChangingArrayLister : public knowledge::VariablesLister
+{
+public:
+  ChangingArrayLister(knowledge::KnowledgeBase& kb)
+    : kb_(kb), ref_(kb.get_ref("changing"))
+  {
+  }
+
+  void start(const knowledge::CheckpointSettings&) override
+  {
+    listed_ = false;
+  }
+
+  std::pair<const char*, const knowledge::KnowledgeRecord*> next() override
+  {
+    if (!listed_)
+    {
+      listed_ = true;
+      return {"changing", ref_.get_record_unsafe()};
+    }
+
+    kb_.set_index(ref_, 0, (knowledge::KnowledgeRecord::Integer)99);
+    return {nullptr, nullptr};
+  }
+
+private:
+  knowledge::KnowledgeBase& kb_;
+  knowledge::VariableReference ref_;
+  bool listed_ = false;
+};
+
+void test_bounded_buffer(void)
+{
+  std::cerr << "\n*********** TESTING BOUNDED SAVE BUFFERS *************.\n";
+
+  knowledge::KnowledgeBase kb;
+  knowledge::EvalSettings track;
+  track.track_local_changes = true;
+
+  // ~300KB of records, far more than the 4KB buffer used to save them
+  const size_t num_vars = 2000;
+  std::string text(100, 'x');
+  std::vector<knowledge::KnowledgeRecord::Integer> ints(10, 7);
+
+  for (size_t i = 0; i < num_vars; ++i)
+  {
+    std::string index = std::to_string(i);
+    kb.set("text." + index, text + index, track);
+    kb.set("ints." + index, ints, track);
+  }
+
+  knowledge::CheckpointSettings settings;
+  settings.buffer_size = 4096;
+
+  auto matches = [&](knowledge::KnowledgeBase& loaded) {
+    for (size_t i = 0; i < num_vars; ++i)
+    {
+      std::string index = std::to_string(i);
+      if (loaded.get("text." + index) != text + index ||
+          loaded.get("ints." + index).to_integers() != ints)
+      {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  std::cerr << "Test 1: save_context with a 4KB buffer: ";
+
+  settings.filename = "bounded_buffer_context.kb";
+
+  knowledge::KnowledgeBase loaded;
+  knowledge::CheckpointSettings load_settings;
+  load_settings.filename = settings.filename;
+
+  if (kb.save_context(settings) > (int64_t)settings.buffer_size &&
+      loaded.load_context(load_settings) > 0 && matches(loaded))
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 2: save_checkpoint with a 4KB buffer: ";
+
+  settings.filename = "bounded_buffer_checkpoint.stk";
+  std::remove(settings.filename.c_str());
+
+  kb.save_checkpoint(settings);
+  kb.set("text.0", "changed", track);
+  kb.save_checkpoint(settings);
+
+  loaded.clear();
+  load_settings.filename = settings.filename;
+  loaded.load_context(load_settings);
+
+  bool checkpoint_ok = load_settings.states == 2 &&
+                       loaded.get("text.0") == "changed" &&
+                       loaded.get("text.1999") == text + "1999";
+
+  kb.set("text.0", text + "0", track);
+
+  if (checkpoint_ok)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 3: snapshot save_context: ";
+
+  settings.filename = "bounded_buffer_snapshot.kb";
+  settings.snapshot = true;
+
+  loaded.clear();
+  load_settings.filename = settings.filename;
+
+  if (kb.save_context(settings) > 0 &&
+      loaded.load_context(load_settings) > 0 && matches(loaded))
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 4: snapshot save_as_karl and save_as_json: ";
+
+  settings.filename = "bounded_buffer_snapshot.karl";
+  settings.prefixes.push_back("text.");
+
+  int64_t karl_size = kb.save_as_karl(settings);
+
+  loaded.clear();
+  loaded.evaluate(utility::file_to_string(settings.filename),
+      knowledge::EvalSettings::SEND);
+
+  settings.filename = "bounded_buffer_snapshot.json";
+  int64_t json_size = kb.save_as_json(settings);
+  std::string json = utility::file_to_string(settings.filename);
+  std::ifstream json_file(settings.filename, std::ios::ate);
+
+  if (karl_size > 0 && loaded.get("text.5") == text + "5" &&
+      !loaded.exists("ints.5") && json_size == (int64_t)json_file.tellg() &&
+      json.find(",\n}") == std::string::npos)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 5: snapshot save of an array changed after listing: ";
+
+  settings.filename = "bounded_buffer_changing.stk";
+  settings.prefixes.clear();
+  load_settings.filename = settings.filename;
+  std::remove(settings.filename.c_str());
+
+  ChangingArrayLister changing_lister(kb);
+  kb.set("changing", std::vector<knowledge::KnowledgeRecord::Integer>(4, 0));
+  settings.variables_lister = &changing_lister;
+
+  loaded.clear();
+  kb.save_checkpoint(settings);
+  loaded.load_context(load_settings);
+  settings.variables_lister = nullptr;
+
+  if (loaded.get("changing").to_integers() ==
+          std::vector<knowledge::KnowledgeRecord::Integer>(4, 0) &&
+      kb.get("changing").retrieve_index(0).to_integer() == 99)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 6: snapshot saves while an array grows: ";
+
+  // element i of racing is always i, so a snapshot that shares the array
+  // with the context while it is resized or written shows up as a mismatch.
+  // The array is kept small enough for the 4KB buffer.
+  settings.filename = "bounded_buffer_racing.kb";
+  settings.prefixes.push_back("racing");
+  load_settings.filename = settings.filename;
+
+  const size_t max_index = 256;
+  std::vector<knowledge::KnowledgeRecord::Integer> start(1, 0);
+  std::atomic<bool> saving(true);
+
+  kb.set("racing", start);
+
+  std::thread writer([&kb, &start, &saving]() {
+    for (size_t i = 1; saving; ++i)
+    {
+      if (i == max_index)
+      {
+        kb.set("racing", start);
+        i = 1;
+      }
+
+      kb.set_index("racing", i, (knowledge::KnowledgeRecord::Integer)i);
+    }
+  });
+
+  bool racing_ok = true;
+
+  for (int save = 0; save < 500 && racing_ok; ++save)
+  {
+    loaded.clear();
+
+    if (kb.save_context(settings) <= 0 ||
+        loaded.load_context(load_settings) <= 0)
+    {
+      racing_ok = false;
+      break;
+    }
+
+    std::vector<knowledge::KnowledgeRecord::Integer> saved =
+        loaded.get("racing").to_integers();
+
+    for (size_t i = 0; i < saved.size(); ++i)
+    {
+      if (saved[i] != (knowledge::KnowledgeRecord::Integer)i)
+      {
+        racing_ok = false;
+        break;
+      }
+    }
+  }
+
+  saving = false;
+  writer.join();
+
+  if (racing_ok)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::remove("bounded_buffer_context.kb");
+  std::remove("bounded_buffer_checkpoint.stk");
+  std::remove("bounded_buffer_snapshot.kb");
+  std::remove("bounded_buffer_snapshot.karl");
+  std::remove("bounded_buffer_snapshot.json");
+  std::remove("bounded_buffer_changing.stk");
+  std::remove("bounded_buffer_racing.kb");
+}
+
+void test_text_exports(void)
+{
+  std::cerr << "\n*********** TESTING PARALLEL TEXT EXPORTS *************.\n";
+
+  knowledge::KnowledgeBase kb;
+
+  const size_t num_vars = 100000;
+  std::vector<knowledge::KnowledgeRecord::Integer> ints(5, 3);
+  std::vector<double> doubles(5, 1.5);
+
+  for (size_t i = 0; i < num_vars; ++i)
+  {
+    std::string index = std::to_string(i);
+    kb.set("int." + index, (knowledge::KnowledgeRecord::Integer)i);
+    kb.set("double." + index, i + 0.5);
+    kb.set("text." + index, "value " + index);
+
+    if (i % 100 == 0)
+    {
+      kb.set("ints." + index, ints);
+      kb.set("doubles." + index, doubles);
+    }
+  }
+
+  kb.set("quoted", "say \"hi\"\n\tand \\ leave");
+
+  knowledge::CheckpointSettings settings;
+
+  auto seconds_since = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  std::cerr << "Test 1: parallel saves match sequential saves: ";
+
+  auto start = std::chrono::steady_clock::now();
+  settings.filename = "text_export_sequential.json";
+  kb.save_as_json(settings);
+  double json_seconds = seconds_since(start);
+
+  settings.filename = "text_export_sequential.karl";
+  kb.save_as_karl(settings);
+
+  settings.format_threads = 4;
+
+  start = std::chrono::steady_clock::now();
+  settings.filename = "text_export_parallel.json";
+  int64_t json_size = kb.save_as_json(settings);
+  double parallel_json_seconds = seconds_since(start);
+
+  settings.filename = "text_export_parallel.karl";
+  kb.save_as_karl(settings);
+
+  std::ifstream parallel_json(
+      "text_export_parallel.json", std::ios::binary | std::ios::ate);
+
+  if (json_size == (int64_t)parallel_json.tellg() &&
+      utility::file_to_string("text_export_parallel.json") ==
+          utility::file_to_string("text_export_sequential.json") &&
+      utility::file_to_string("text_export_parallel.karl") ==
+          utility::file_to_string("text_export_sequential.karl"))
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 2: load_as_json restores the saved values: ";
+
+  knowledge::KnowledgeBase loaded;
+
+  start = std::chrono::steady_clock::now();
+  int64_t json_read = loaded.load_as_json("text_export_parallel.json");
+  double load_json_seconds = seconds_since(start);
+
+  if (json_read == json_size &&
+      loaded.get("int.99999").to_integer() == 99999 &&
+      loaded.get("double.7").to_double() == 7.5 &&
+      loaded.get("text.42") == "value 42" &&
+      loaded.get("ints.500").to_integers() == ints &&
+      loaded.get("doubles.500").to_doubles() == doubles &&
+      loaded.get("doubles.500").type() ==
+          knowledge::KnowledgeRecord::DOUBLE_ARRAY &&
+      loaded.get("quoted") == kb.get("quoted"))
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 3: load_as_json flattens objects and arrays: ";
+
+  {
+    std::ofstream file("text_export_nested.json");
+    file << "{ \"agent\": { \"name\": \"a\\u00e9\", \"pos\": [1, 2.5],\n"
+            "  \"ok\": true, \"none\": null,\n"
+            "  \"tags\": [\"x\", {\"id\": 7}] } }";
+  }
+
+  knowledge::KnowledgeBase nested;
+  nested.load_as_json("text_export_nested.json");
+
+  knowledge::KnowledgeBase invalid;
+  {
+    std::ofstream file("text_export_invalid.json");
+    file << "{ \"x\": 1, \"y\": }";
+  }
+
+  if (nested.get("agent.name") == "a\xc3\xa9" &&
+      nested.get("agent.pos").to_doubles() == std::vector<double>{1, 2.5} &&
+      nested.get("agent.ok").to_integer() == 1 &&
+      !nested.exists("agent.none") && nested.get("agent.tags.0") == "x" &&
+      nested.get("agent.tags.1.id").to_integer() == 7 &&
+      nested.get("agent.tags.size").to_integer() == 2 &&
+      invalid.load_as_json("text_export_invalid.json") == -2 &&
+      !invalid.exists("x") && invalid.load_as_json("missing.json") == -1)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 4: load_as_json keeps the context on invalid files"
+               " and saves non-finite doubles as null: ";
+
+  knowledge::KnowledgeBase kept;
+  kept.set("kept", (knowledge::KnowledgeRecord::Integer)1);
+
+  knowledge::CheckpointSettings clear_settings;
+  clear_settings.filename = "text_export_invalid.json";
+  clear_settings.clear_knowledge = true;
+
+  int64_t kept_result = kept.load_as_json(clear_settings);
+
+  knowledge::KnowledgeBase special;
+  special.set("real", 1.5);
+  special.set("not_a_number", std::numeric_limits<double>::quiet_NaN());
+  special.set("unbounded", std::numeric_limits<double>::infinity());
+  special.set("values",
+      std::vector<double>{2.5, -std::numeric_limits<double>::infinity()});
+
+  clear_settings.filename = "text_export_special.json";
+  special.save_as_json(clear_settings);
+
+  std::string special_json = utility::file_to_string(clear_settings.filename);
+
+  // reloading clears the context first, now that the file parses
+  special.set("stale", (knowledge::KnowledgeRecord::Integer)1);
+  int64_t special_result = special.load_as_json(clear_settings);
+
+  if (kept_result == -2 && kept.get("kept").to_integer() == 1 &&
+      special_result > 0 && special_json.find("nan") == std::string::npos &&
+      special_json.find("inf") == std::string::npos &&
+      special.get("real").to_double() == 1.5 &&
+      !special.exists("not_a_number") && !special.exists("unbounded") &&
+      !special.exists("stale") &&
+      special.get("values.0").to_double() == 2.5 &&
+      !special.exists("values.1"))
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Test 5: export and import throughput\n";
+
+  // KaRL strings cannot hold quotes, so evaluate a save without them
+  kb.get_context().delete_variable("quoted");
+  settings.filename = "text_export_evaluated.karl";
+  kb.save_as_karl(settings);
+
+  knowledge::KnowledgeBase evaluated;
+
+  start = std::chrono::steady_clock::now();
+  evaluated.evaluate(utility::file_to_string(settings.filename),
+      knowledge::EvalSettings::SEND);
+  double load_karl_seconds = seconds_since(start);
+
+  double records = (double)(num_vars * 3 + num_vars / 50);
+
+  std::cerr << "  " << (size_t)records << " records, " << json_size
+            << " bytes of JSON\n";
+  std::cerr << "  save_as_json: " << (size_t)(records / json_seconds)
+            << " records/s sequential, "
+            << (size_t)(records / parallel_json_seconds)
+            << " records/s on 4 threads\n";
+  std::cerr << "  load: " << (size_t)(records / load_karl_seconds)
+            << " records/s evaluating KaRL, "
+            << (size_t)(records / load_json_seconds)
+            << " records/s with load_as_json\n";
+
+  if (evaluated.get("text.42") != "value 42")
+  {
+    std::cerr << "FAIL: the KaRL save was not evaluated\n";
+    ++madara_fails;
+  }
+
+  std::remove("text_export_sequential.json");
+  std::remove("text_export_sequential.karl");
+  std::remove("text_export_parallel.json");
+  std::remove("text_export_parallel.karl");
+  std::remove("text_export_nested.json");
+  std::remove("text_export_invalid.json");
+  std::remove("text_export_special.json");
+  std::remove("text_export_evaluated.karl");
+}
+
 void test_streaming()
 {
   std::cerr << "\n*********** TESTING STREAMING *************.\n";
@@ -1036,6 +1697,9 @@ void test_streaming()
   knowledge::CheckpointSettings settings;
   settings.filename = "stream_test.stk";
 
+  // streams append to existing checkpoints, so start from an empty file
+  std::remove(settings.filename.c_str());
+
   knowledge::KnowledgeBase kb;
   kb.attach_streamer(
       utility::mk_unique<knowledge::CheckpointStreamer>(settings, kb));
@@ -1261,6 +1925,12 @@ int main(int argc, char* argv[])
 
   test_diff_filter_chains();
 
+  test_keyframes();
+
+  test_bounded_buffer();
+
+  test_text_exports();
+
   logger::global_logger->set_level(log_level);
   test_streaming();
 
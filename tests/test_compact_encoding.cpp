@@ -0,0 +1,532 @@
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "madara/transport/CompactEncoding.h"
+#include "madara/transport/CompactMessageHeader.h"
+#include "madara/transport/Transport.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/logger/GlobalLogger.h"
+#include "test.h"
+
+namespace knowledge = madara::knowledge;
+namespace transport = madara::transport;
+
+typedef knowledge::KnowledgeRecord KnowledgeRecord;
+typedef KnowledgeRecord::Integer Integer;
+
+/**
+ * Transport that only encodes messages, for feeding receivers
+ **/
+class MessageBuilder : public transport::Base
+{
+public:
+  MessageBuilder(knowledge::ThreadSafeContext& context,
+      transport::TransportSettings& settings)
+    : transport::Base("sender", settings, context)
+  {
+    setup();
+  }
+
+  long send_data(const knowledge::KnowledgeMap& updates) override
+  {
+    long size = prep_send(updates, "MessageBuilder::send_data");
+
+    if (size > 0 && drop)
+    {
+      lost.emplace_back(buffer_.get_ptr(), buffer_.get_ptr() + size);
+    }
+    else if (size > 0)
+    {
+      messages.emplace_back(buffer_.get_ptr(), buffer_.get_ptr() + size);
+      confirm_sent();
+    }
+
+    return size;
+  }
+
+  /// if true, messages fail to send and are kept in lost
+  bool drop = false;
+
+  /// the encoded messages
+  std::vector<std::vector<char>> messages;
+
+  /// the encoded messages that failed to send
+  std::vector<std::vector<char>> lost;
+};
+
+/**
+ * Decodes a message into a received update
+ **/
+int decode(knowledge::KnowledgeBase& kb,
+    const transport::QoSTransportSettings& settings,
+    const std::vector<char>& message, transport::ReceivedUpdate& received)
+{
+  transport::BandwidthMonitor send_monitor, receive_monitor;
+  std::vector<char> buffer(message);
+
+  return transport::decode_received_update(buffer.data(),
+      (uint32_t)buffer.size(), "receiver", kb.get_context(), settings,
+      send_monitor, receive_monitor, "test_compact_encoding", "test:1",
+      received);
+}
+
+void test_varints(void)
+{
+  log("Testing varints and zigzag encoding\n");
+
+  std::vector<int64_t> values = {0, 1, -1, 63, -64, 64, 127, 128, 300,
+      -300, 1 << 20, std::numeric_limits<int64_t>::max(),
+      std::numeric_limits<int64_t>::min()};
+
+  char buffer[transport::max_varint_size * 13];
+  char* cur = buffer;
+  int64_t expected_size = 0;
+
+  for (auto value : values)
+  {
+    uint64_t encoded = transport::zigzag_encode(value);
+    expected_size += transport::varint_size(encoded);
+    cur = transport::write_varint(cur, encoded);
+  }
+
+  TEST_EQ((int64_t)(cur - buffer), expected_size);
+  TEST_EQ(transport::varint_size(0), (int64_t)1);
+  TEST_EQ(transport::varint_size(127), (int64_t)1);
+  TEST_EQ(transport::varint_size(128), (int64_t)2);
+  TEST_EQ(transport::varint_size(transport::zigzag_encode(-1)), (int64_t)1);
+  TEST_EQ(transport::varint_size((uint64_t)-1), transport::max_varint_size);
+
+  const char* read = buffer;
+  int64_t remaining = expected_size;
+  bool matches = true;
+
+  for (auto value : values)
+  {
+    uint64_t encoded = 0;
+    read = transport::read_varint(read, remaining, encoded);
+    matches = matches && transport::zigzag_decode(encoded) == value;
+  }
+
+  TEST_EQ(matches, true);
+  TEST_EQ(remaining, (int64_t)0);
+
+  // a varint cut off in the middle is an error
+  uint64_t encoded = 0;
+  remaining = 1;
+  transport::read_varint(buffer + expected_size - 2, remaining, encoded);
+  TEST_LT(remaining, (int64_t)0);
+}
+
+void test_round_trip(void)
+{
+  log("Testing a compact encoding round trip\n");
+
+  knowledge::KnowledgeBase sender;
+  transport::QoSTransportSettings settings;
+  settings.send_compact_encoding = true;
+  MessageBuilder builder(sender.get_context(), settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["agent.0.state"] = KnowledgeRecord(Integer(-42));
+  updates["agent.0.heading"] = KnowledgeRecord(1.5);
+  updates["agent.0.name"] = KnowledgeRecord("alpha");
+  updates["agent.0.waypoints"] =
+      KnowledgeRecord(std::vector<Integer>{1, -2, 300000, 4});
+  updates["agent.0.location"] =
+      KnowledgeRecord(std::vector<double>{1.25, -2.5, 3.75});
+  updates["agent.0.config"].set_xml(std::string("<a>1</a>"));
+
+  for (auto& update : updates)
+  {
+    update.second.set_toi(madara::utility::get_time() - 1000);
+  }
+
+  builder.send_data(updates);
+  builder.send_data(updates);
+
+  TEST_EQ(builder.messages.size(), (size_t)2);
+  TEST_EQ(transport::CompactMessageHeader::compact_message_header_test(
+              builder.messages[0].data()),
+      true);
+
+  // the second message refers to the variables by id only
+  TEST_LT(builder.messages[1].size(), builder.messages[0].size());
+
+  knowledge::KnowledgeBase receiver;
+  transport::QoSTransportSettings receiver_settings;
+  receiver_settings.add_read_domain(settings.write_domain);
+
+  for (auto& message : builder.messages)
+  {
+    transport::ReceivedUpdate received;
+    TEST_GT(decode(receiver, receiver_settings, message, received), 0);
+    TEST_EQ(received.updates.size(), updates.size());
+
+    bool matches = true;
+
+    for (auto& update : updates)
+    {
+      auto found = received.updates.find(update.first);
+
+      matches = matches && found != received.updates.end() &&
+                found->second == update.second &&
+                found->second.type() == update.second.type() &&
+                found->second.toi() == update.second.toi();
+    }
+
+    TEST_EQ(matches, true);
+
+    // rebroadcasts use the standard header
+    TEST_EQ(strncmp(received.header->madara_id, MADARA_IDENTIFIER, 7), 0);
+    TEST_EQ(std::string(received.header->originator), std::string("sender"));
+    TEST_EQ(received.header->updates, (uint32_t)updates.size());
+  }
+}
+
+void test_reduced_header(void)
+{
+  log("Testing the update count of reduced headers\n");
+
+  knowledge::KnowledgeBase sender;
+  transport::QoSTransportSettings settings;
+  settings.send_reduced_message_header = true;
+  MessageBuilder builder(sender.get_context(), settings);
+
+  // the update count used to be written at the offset of the standard
+  // header, which is inside the first update of a reduced message
+  knowledge::KnowledgeMap updates;
+  updates["long"] = KnowledgeRecord(std::string(200, 'x'));
+  updates["short"] = KnowledgeRecord(Integer(1));
+  builder.send_data(updates);
+
+  knowledge::KnowledgeBase receiver;
+  transport::ReceivedUpdate received;
+  decode(receiver, settings, builder.messages[0], received);
+
+  TEST_EQ(received.updates.size(), (size_t)2);
+  TEST_EQ(received.updates["long"].to_string(), std::string(200, 'x'));
+}
+
+void test_dictionary(void)
+{
+  log("Testing dictionary announcements, refreshes and epochs\n");
+
+  knowledge::KnowledgeBase sender;
+  transport::QoSTransportSettings settings;
+  settings.send_compact_encoding = true;
+  settings.compact_dictionary_refresh = 0.05;
+  MessageBuilder builder(sender.get_context(), settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["x"] = KnowledgeRecord(Integer(1));
+  updates["y"] = KnowledgeRecord(Integer(2));
+  builder.send_data(updates);
+  builder.send_data(updates);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  builder.send_data(updates);
+
+  transport::QoSTransportSettings receiver_settings;
+  receiver_settings.add_read_domain(settings.write_domain);
+
+  // a late joiner skips updates until the names are announced again
+  knowledge::KnowledgeBase late;
+  transport::ReceivedUpdate received;
+  decode(late, receiver_settings, builder.messages[1], received);
+  TEST_EQ(received.updates.size(), (size_t)0);
+  TEST_EQ(receiver_settings.compact_decoder.get_unknown(), (uint64_t)2);
+
+  decode(late, receiver_settings, builder.messages[2], received);
+  TEST_EQ(received.updates.size(), (size_t)2);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)2);
+
+  // a restarted sender assigns ids in a new epoch, so the ids of the
+  // old epoch must not be used for them
+  knowledge::KnowledgeBase restarted;
+  transport::QoSTransportSettings restarted_settings;
+  restarted_settings.send_compact_encoding = true;
+  restarted_settings.compact_dictionary_refresh = 0;
+  MessageBuilder restarted_builder(restarted.get_context(),
+      restarted_settings);
+
+  knowledge::KnowledgeMap y_only;
+  y_only["y"] = KnowledgeRecord(Integer(3));
+  restarted_builder.send_data(y_only);
+  restarted_builder.send_data(y_only);
+
+  decode(late, receiver_settings, restarted_builder.messages[1], received);
+  TEST_EQ(received.updates.size(), (size_t)0);
+  TEST_EQ(receiver_settings.compact_decoder.get_unknown(), (uint64_t)3);
+
+  decode(late, receiver_settings, restarted_builder.messages[0], received);
+  decode(late, receiver_settings, restarted_builder.messages[1], received);
+  TEST_EQ(received.updates.size(), (size_t)1);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)3);
+
+  // a full dictionary sends names inline instead of assigning ids
+  knowledge::KnowledgeBase small;
+  transport::QoSTransportSettings small_settings;
+  small_settings.send_compact_encoding = true;
+  small_settings.compact_dictionary_size = 1;
+  MessageBuilder small_builder(small.get_context(), small_settings);
+  small_builder.send_data(updates);
+  small_builder.send_data(updates);
+
+  knowledge::KnowledgeBase small_receiver;
+  decode(small_receiver, receiver_settings, small_builder.messages[1],
+      received);
+  TEST_EQ(received.updates.size(), (size_t)1);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)2);
+}
+
+void test_dictionary_senders(void)
+{
+  log("Testing dictionaries of lost messages and concurrent epochs\n");
+
+  knowledge::KnowledgeBase sender;
+  transport::QoSTransportSettings settings;
+  settings.send_compact_encoding = true;
+  MessageBuilder builder(sender.get_context(), settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["x"] = KnowledgeRecord(Integer(1));
+  updates["y"] = KnowledgeRecord(Integer(2));
+
+  // names announced in a message that failed to send are announced again
+  builder.drop = true;
+  builder.send_data(updates);
+  builder.drop = false;
+  builder.send_data(updates);
+  builder.send_data(updates);
+
+  TEST_EQ(builder.messages[0].size(), builder.lost[0].size());
+  TEST_LT(builder.messages[1].size(), builder.messages[0].size());
+
+  transport::QoSTransportSettings receiver_settings;
+  receiver_settings.add_read_domain(settings.write_domain);
+
+  knowledge::KnowledgeBase receiver;
+  transport::ReceivedUpdate received;
+  decode(receiver, receiver_settings, builder.messages[0], received);
+  TEST_EQ(received.updates.size(), (size_t)2);
+
+  // a second transport of the same knowledge base has the same originator
+  // but its own epoch, and its ids must not replace those of the first
+  transport::QoSTransportSettings other_settings;
+  other_settings.send_compact_encoding = true;
+  MessageBuilder other(sender.get_context(), other_settings);
+
+  knowledge::KnowledgeMap y_only;
+  y_only["y"] = KnowledgeRecord(Integer(3));
+  other.send_data(y_only);
+  other.send_data(y_only);
+
+  decode(receiver, receiver_settings, other.messages[0], received);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)3);
+
+  decode(receiver, receiver_settings, builder.messages[1], received);
+  TEST_EQ(received.updates.size(), (size_t)2);
+  TEST_EQ(received.updates["x"].to_integer(), (Integer)1);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)2);
+
+  decode(receiver, receiver_settings, other.messages[1], received);
+  TEST_EQ(received.updates.size(), (size_t)1);
+  TEST_EQ(received.updates["y"].to_integer(), (Integer)3);
+  TEST_EQ(receiver_settings.compact_decoder.get_unknown(), (uint64_t)0);
+}
+
+void test_array_deltas(void)
+{
+  log("Testing compact array deltas\n");
+
+  knowledge::KnowledgeBase kb;
+  kb.set("doubles", std::vector<double>{0, 1, 2, 3, 4, 5, 6, 7});
+  kb.set("integers", std::vector<Integer>{0, 1, 2, 3, 4, 5, 6, 7});
+
+  KnowledgeRecord doubles(std::vector<double>{0, 1, 2.5, 3.5, 4, 5, 6, 7.5});
+  KnowledgeRecord integers(
+      std::vector<Integer>{0, 1, -20, -30, 4, 5, 6, 70000});
+
+  knowledge::DirtyRanges ranges;
+  ranges.add(2, 2);
+  ranges.add(7);
+
+  transport::CompactEncoder encoder;
+  encoder.start(1000, 0, 10);
+
+  std::vector<char> buffer(1000);
+  int64_t remaining = (int64_t)buffer.size();
+  uint64_t clock = kb.get("doubles").clock;
+  int64_t doubles_size =
+      encoder.encoded_size("doubles", doubles, &ranges, clock);
+  char* cur = encoder.write(buffer.data(), "doubles", doubles, remaining,
+      &ranges, clock);
+
+  TEST_EQ((int64_t)(cur - buffer.data()), doubles_size);
+
+  cur = encoder.write(cur, "integers", integers, remaining, &ranges, clock);
+
+  // a delta that does not match the size of the receiver's array is dropped
+  KnowledgeRecord longer(std::vector<double>(16, 1.0));
+  cur = encoder.write(cur, "doubles", longer, remaining, &ranges, clock);
+
+  // as is a delta encoded against another version of the array
+  cur = encoder.write(
+      cur, "integers", integers, remaining, &ranges, clock + 1);
+
+  transport::CompactDecoder decoder;
+  const char* read = buffer.data();
+  int64_t used = (int64_t)buffer.size() - remaining;
+  std::string key;
+  KnowledgeRecord record;
+
+  read = decoder.read(
+      read, used, "sender", 1, 1000, key, record, kb.get_context());
+  TEST_EQ(key, std::string("doubles"));
+  TEST_EQ(record == doubles, true);
+
+  read = decoder.read(
+      read, used, "sender", 1, 1000, key, record, kb.get_context());
+  TEST_EQ(key, std::string("integers"));
+  TEST_EQ(record == integers, true);
+
+  read = decoder.read(
+      read, used, "sender", 1, 1000, key, record, kb.get_context());
+  TEST_EQ(record.exists(), false);
+
+  read = decoder.read(
+      read, used, "sender", 1, 1000, key, record, kb.get_context());
+  TEST_EQ(key, std::string("integers"));
+  TEST_EQ(record.exists(), false);
+  TEST_EQ(used, (int64_t)0);
+
+  // a message that is cut short is an error
+  used = doubles_size - 1;
+  decoder.read(buffer.data(), used, "sender", 1, 1000, key, record,
+      kb.get_context());
+  TEST_LT(used, (int64_t)0);
+}
+
+/**
+ * Encodes and decodes many messages of scalar updates, the common case
+ * for agents sharing their state
+ **/
+void benchmark_encodings(void)
+{
+  log("Benchmarking standard and compact encodings\n");
+
+  const size_t messages = 2000;
+  const size_t variables = 20;
+
+  std::vector<std::string> keys;
+
+  for (size_t i = 0; i < variables; ++i)
+  {
+    keys.push_back("agent.0.sensors." + std::to_string(i) +
+                   (i % 2 ? ".temperature" : ".count"));
+  }
+
+  size_t sizes[2] = {0, 0};
+
+  for (int compact = 0; compact < 2; ++compact)
+  {
+    knowledge::KnowledgeBase sender;
+    transport::QoSTransportSettings settings;
+    settings.send_compact_encoding = compact == 1;
+    MessageBuilder builder(sender.get_context(), settings);
+
+    std::vector<knowledge::KnowledgeMap> batches(messages);
+
+    for (size_t m = 0; m < messages; ++m)
+    {
+      for (size_t i = 0; i < variables; ++i)
+      {
+        if (i % 2)
+        {
+          batches[m][keys[i]] = KnowledgeRecord(20.0 + (double)m / 100);
+        }
+        else
+        {
+          batches[m][keys[i]] = KnowledgeRecord(Integer(m + i));
+        }
+
+        batches[m][keys[i]].set_toi(madara::utility::get_time());
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto& batch : batches)
+    {
+      builder.send_data(batch);
+    }
+
+    double encode_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+
+    knowledge::KnowledgeBase receiver;
+    transport::QoSTransportSettings receiver_settings;
+    receiver_settings.add_read_domain(settings.write_domain);
+    transport::BandwidthMonitor send_monitor, receive_monitor;
+    transport::ReceivedUpdate received;
+    size_t decoded = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (auto& message : builder.messages)
+    {
+      sizes[compact] += message.size();
+
+      if (transport::decode_received_update(message.data(),
+              (uint32_t)message.size(), "receiver", receiver.get_context(),
+              receiver_settings, send_monitor, receive_monitor, "benchmark",
+              "test:1", received) > 0)
+      {
+        decoded += received.updates.size();
+      }
+    }
+
+    double decode_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double updates = (double)(messages * variables);
+
+    log("  %s: %.1f bytes/update, %.0f ns/update encode,"
+        " %.0f ns/update decode\n",
+        compact ? "compact " : "standard", sizes[compact] / updates,
+        encode_ns / updates, decode_ns / updates);
+
+    TEST_EQ(decoded, messages * variables);
+  }
+
+  TEST_LT(sizes[1] * 2, sizes[0]);
+}
+
+int main(int, char**)
+{
+  test_varints();
+  test_round_trip();
+  test_reduced_header();
+  test_dictionary();
+  test_dictionary_senders();
+  test_array_deltas();
+  benchmark_encodings();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
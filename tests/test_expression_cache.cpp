@@ -0,0 +1,271 @@
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/logger/GlobalLogger.h"
+#include "test.h"
+
+namespace knowledge = madara::knowledge;
+namespace expression = madara::expression;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Builds a corpus of distinct KaRL expressions, like the rules an agent
+ * compiles at startup
+ **/
+std::vector<std::string> build_corpus(size_t size, const std::string& prefix)
+{
+  std::vector<std::string> corpus;
+  corpus.reserve(size);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    std::stringstream buffer;
+    buffer << prefix << "var" << i << " = " << prefix << "var" << i
+           << " + " << i << " * 2;\n";
+    buffer << prefix << "cond" << i << " && " << prefix << "var" << i
+           << " > 10 => (" << prefix << "out" << i << " = 1)";
+    corpus.push_back(buffer.str());
+  }
+
+  return corpus;
+}
+
+double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void test_cache_bounds(void)
+{
+  log("Testing expression cache bounds and statistics\n");
+
+  knowledge::KnowledgeBase kb;
+  knowledge::ThreadSafeContext& context = kb.get_context();
+
+  context.set_expression_cache_capacity(3);
+
+  kb.compile("a = 1");
+  kb.compile("b = 2");
+  kb.compile("c = 3");
+
+  // a becomes the most recently used, so b is evicted for d
+  kb.compile("a = 1");
+  kb.compile("d = 4");
+
+  expression::ExpressionCacheStats stats =
+      context.get_expression_cache_stats();
+
+  TEST_EQ(stats.hits, (uint64_t)1);
+  TEST_EQ(stats.misses, (uint64_t)4);
+  TEST_EQ(stats.evictions, (uint64_t)1);
+  TEST_EQ(stats.size, (size_t)3);
+  TEST_EQ(stats.capacity, (size_t)3);
+
+  kb.compile("a = 1");
+  kb.compile("b = 2");
+
+  stats = context.get_expression_cache_stats();
+
+  TEST_EQ(stats.hits, (uint64_t)2);
+  TEST_EQ(stats.misses, (uint64_t)5);
+
+  TEST_EQ(context.delete_expression("b = 2"), true);
+  TEST_EQ(context.delete_expression("b = 2"), false);
+  TEST_EQ(context.get_expression_cache_stats().size, (size_t)2);
+
+  // a disabled cache still compiles
+  context.set_expression_cache_capacity(0);
+  TEST_EQ(context.get_expression_cache_stats().size, (size_t)0);
+  TEST_EQ(kb.evaluate("e = 5").to_integer(),
+      (knowledge::KnowledgeRecord::Integer)5);
+  TEST_EQ(context.get_expression_cache_stats().size, (size_t)0);
+}
+
+void test_concurrent_compiles(void)
+{
+  log("Testing concurrent compiles\n");
+
+  const size_t num_threads = 4;
+  const size_t per_thread = 500;
+
+  knowledge::KnowledgeBase kb;
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> failures(0);
+
+  for (size_t t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&kb, &failures, t, per_thread]() {
+      std::stringstream prefix;
+      prefix << "t" << t << ".";
+
+      // every thread also compiles a shared corpus to race on inserts
+      std::vector<std::string> own = build_corpus(per_thread, prefix.str());
+      std::vector<std::string> shared = build_corpus(per_thread, "shared.");
+
+      for (size_t i = 0; i < per_thread; ++i)
+      {
+        knowledge::CompiledExpression compiled = kb.compile(own[i]);
+        kb.evaluate(compiled);
+        kb.compile(shared[i]);
+
+        if (kb.get(prefix.str() + "var" + std::to_string(i)).to_integer() !=
+            (knowledge::KnowledgeRecord::Integer)(i * 2))
+        {
+          ++failures;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  TEST_EQ((size_t)failures, (size_t)0);
+  TEST_EQ(kb.get_context().get_expression_cache_stats().size,
+      (size_t)expression::ExpressionCache::default_capacity);
+}
+
+void test_reads_during_compile(void)
+{
+  log("Testing reads while a large expression compiles\n");
+
+  knowledge::KnowledgeBase kb;
+  kb.set("x", (knowledge::KnowledgeRecord::Integer)1);
+
+  std::stringstream buffer;
+  buffer << "sum = 0";
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    buffer << " + term" << (i % 100);
+  }
+
+  std::atomic<bool> compiling(true);
+  double max_read_ms = 0;
+  size_t reads = 0;
+
+  std::thread reader([&]() {
+    while (compiling)
+    {
+      auto start = Clock::now();
+      kb.get("x");
+      double read_ms = elapsed_ms(start);
+
+      if (read_ms > max_read_ms)
+      {
+        max_read_ms = read_ms;
+      }
+
+      ++reads;
+    }
+  });
+
+  auto start = Clock::now();
+  kb.compile(buffer.str());
+  double compile_ms = elapsed_ms(start);
+
+  compiling = false;
+  reader.join();
+
+  log("  compile took %.2f ms, slowest of %d reads took %.3f ms\n",
+      compile_ms, (int)reads, max_read_ms);
+
+  TEST_GT(reads, (size_t)0);
+}
+
+void benchmark_startup(void)
+{
+  log("Benchmarking startup compiles of a KaRL corpus\n");
+
+  const size_t corpus_size = 5000;
+  std::vector<std::string> corpus = build_corpus(corpus_size, "");
+
+  knowledge::KnowledgeBase kb;
+  knowledge::ThreadSafeContext& context = kb.get_context();
+  context.set_expression_cache_capacity(corpus_size);
+
+  auto start = Clock::now();
+  for (auto& logic : corpus)
+  {
+    kb.compile(logic);
+  }
+  double cold_ms = elapsed_ms(start);
+
+  start = Clock::now();
+  for (auto& logic : corpus)
+  {
+    kb.compile(logic);
+  }
+  double warm_ms = elapsed_ms(start);
+
+  knowledge::KnowledgeBase parallel_kb;
+  parallel_kb.get_context().set_expression_cache_capacity(corpus_size);
+
+  const size_t num_threads = 4;
+  std::vector<std::thread> threads;
+
+  start = Clock::now();
+  for (size_t t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < corpus_size; i += num_threads)
+      {
+        parallel_kb.compile(corpus[i]);
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  double parallel_ms = elapsed_ms(start);
+
+  expression::ExpressionCacheStats stats =
+      context.get_expression_cache_stats();
+
+  log("  %d expressions: cold %.2f ms, cached %.2f ms, "
+      "cold with %d threads %.2f ms\n",
+      (int)corpus_size, cold_ms, warm_ms, (int)num_threads, parallel_ms);
+  log("  stats: hits=%d, misses=%d, evictions=%d, size=%d\n",
+      (int)stats.hits, (int)stats.misses, (int)stats.evictions,
+      (int)stats.size);
+
+  TEST_EQ(stats.hits, (uint64_t)corpus_size);
+  TEST_EQ(stats.misses, (uint64_t)corpus_size);
+  TEST_EQ(parallel_kb.get_context().get_expression_cache_stats().size,
+      corpus_size);
+}
+
+int main(int, char**)
+{
+#ifndef _MADARA_NO_KARL_
+  test_cache_bounds();
+  test_concurrent_compiles();
+  test_reads_during_compile();
+  benchmark_startup();
+#else
+  std::cout << "This test is disabled due to karl feature being disabled.\n";
+#endif  // _MADARA_NO_KARL_
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
@@ -1,4 +1,9 @@
+#include <atomic>
 #include <iostream>
+#include <sstream>
+#include <string.h>
+#include <thread>
+#include <vector>
 
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/knowledge/KnowledgeRecordFilters.h"
@@ -14,6 +19,11 @@
 #include "madara/knowledge/FileFragmenter.h"
 #include "madara/knowledge/FileRequester.h"
 
+#ifdef _USE_LZ4_
+#include "boost/crc.hpp"
+#include "madara/filters/lz4/LZ4BufferFilter.h"
+#endif
+
 namespace knowledge = madara::knowledge;
 namespace filters = madara::filters;
 namespace transport = madara::transport;
@@ -460,6 +470,299 @@ void test_variable_map_filter(void)
   }
 }
 
+#ifdef _USE_LZ4_
+
+/**
+ * Builds a payload like a transport message, with the updates of
+ * count variables of an agent
+ **/
+std::string build_message(int agent, int count, int64_t value)
+{
+  std::vector<char> buffer(64000);
+  char* current = buffer.data();
+  int64_t buffer_remaining = (int64_t)buffer.size();
+
+  for (int i = 0; i < count; ++i)
+  {
+    std::stringstream key;
+    key << "agent." << agent << ".sensors.reading" << i;
+
+    KnowledgeRecord record;
+    if (i % 3 == 0)
+    {
+      record.set_value(std::to_string(value + i) + ".state.nominal");
+    }
+    else if (i % 3 == 1)
+    {
+      record.set_value((double)(value + i) / 7.0);
+    }
+    else
+    {
+      record.set_value(KnowledgeRecord::Integer(value * i));
+    }
+
+    current = record.write(current, key.str(), buffer_remaining);
+  }
+
+  return std::string(buffer.data(), current);
+}
+
+/**
+ * Encodes and decodes a payload, returning the encoded size or -1
+ * if the decoded payload differs
+ **/
+int lz4_round_trip(const filters::LZ4BufferFilter& encoder,
+    const filters::LZ4BufferFilter& decoder, const std::string& payload)
+{
+  std::vector<char> buffer(payload.size() + 1000);
+  memcpy(buffer.data(), payload.data(), payload.size());
+
+  int encoded = encoder.encode(
+      buffer.data(), (int)payload.size(), (int)buffer.size());
+  int decoded = decoder.decode(buffer.data(), encoded, (int)buffer.size());
+
+  if (decoded != (int)payload.size() ||
+      memcmp(buffer.data(), payload.data(), payload.size()) != 0)
+  {
+    return -1;
+  }
+
+  return encoded;
+}
+
+void test_lz4_buffer_filter(void)
+{
+  filters::LZ4BufferFilter filter, peer;
+
+  std::string message = build_message(1, 20, 5);
+  std::string small = "agent.1.x=5";
+  std::string random;
+
+  utility::rand_int(0, 255, true);
+  for (int i = 0; i < 2000; ++i)
+  {
+    random.push_back((char)utility::rand_int(0, 255, false));
+  }
+
+  std::cerr << "Testing LZ4 compressible message: ";
+
+  int encoded = lz4_round_trip(filter, peer, message);
+
+  if (encoded > 0 && encoded < (int)message.size())
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL (" << encoded << " of " << message.size() << ")\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Testing LZ4 small and incompressible messages are raw: ";
+
+  int small_size = lz4_round_trip(filter, peer, small);
+  int random_size = lz4_round_trip(filter, peer, random);
+
+  if (small_size == (int)small.size() + 1 &&
+      random_size == (int)random.size() + 1 && filter.get_raw_count() == 2)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL (" << small_size << ", " << random_size << ")\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Testing LZ4 skips compression of incompressible streams: ";
+
+  filters::LZ4BufferFilter skipper;
+  skipper.skip_after = 2;
+  skipper.skip_count = 3;
+
+  // 2 failures start the skipping, so even a compressible message is sent
+  // raw for the next 3 messages, and then compression is tried again
+  bool skip_ok = lz4_round_trip(skipper, peer, random) ==
+                     (int)random.size() + 1 &&
+                 lz4_round_trip(skipper, peer, random) ==
+                     (int)random.size() + 1;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    skip_ok = skip_ok && lz4_round_trip(skipper, peer, message) ==
+                             (int)message.size() + 1;
+  }
+
+  int after_skip = lz4_round_trip(skipper, peer, message);
+
+  if (skip_ok && after_skip > 0 && after_skip < (int)message.size())
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Testing LZ4 dictionary compression: ";
+
+  std::string dictionary = build_message(1, 20, 0);
+
+  filters::LZ4BufferFilter dictionary_filter, dictionary_peer, stranger;
+  dictionary_filter.set_dictionary(dictionary);
+  dictionary_peer.set_dictionary(dictionary);
+  stranger.set_dictionary("some other dictionary");
+
+  int with_dictionary = lz4_round_trip(dictionary_filter, dictionary_peer,
+      message);
+
+  std::vector<char> buffer(message.begin(), message.end());
+  buffer.resize(message.size() + 1000);
+
+  int stranger_size = dictionary_filter.encode(
+      buffer.data(), (int)message.size(), (int)buffer.size());
+
+  // the dictionary id is sent in network byte order
+  boost::crc_32_type crc;
+  crc.process_bytes(dictionary.data(), dictionary.size());
+
+  uint32_t sent_id = 0;
+  for (int i = 1; i <= 4; ++i)
+  {
+    sent_id = (sent_id << 8) | (unsigned char)buffer[i];
+  }
+
+  stranger_size = stranger.decode(buffer.data(), stranger_size,
+      (int)buffer.size());
+
+  if (with_dictionary > 0 && with_dictionary < encoded && stranger_size == 0 &&
+      sent_id == crc.checksum())
+  {
+    std::cerr << "SUCCESS (" << with_dictionary << " vs " << encoded
+              << " bytes)\n";
+  }
+  else
+  {
+    std::cerr << "FAIL (" << with_dictionary << " vs " << encoded
+              << " bytes, stranger decoded " << stranger_size << ")\n";
+    ++madara_fails;
+  }
+
+  std::cerr << "Testing LZ4 filter from multiple threads: ";
+
+  std::atomic<int> thread_fails(0);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 200; ++i)
+      {
+        if (lz4_round_trip(dictionary_filter, dictionary_filter,
+                build_message(t, 10, i)) < 0)
+        {
+          ++thread_fails;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (thread_fails == 0)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL (" << thread_fails << " mismatches)\n";
+    ++madara_fails;
+  }
+}
+
+void benchmark_lz4_buffer_filter(void)
+{
+  std::vector<std::string> messages;
+  size_t total = 0;
+
+  for (int i = 0; i < 500; ++i)
+  {
+    messages.push_back(build_message(i % 4, 20, i));
+    total += messages.back().size();
+  }
+
+  std::vector<char> buffer(128000);
+
+  std::cerr << "Benchmarking LZ4 filter on " << messages.size()
+            << " messages of " << total / messages.size() << " bytes:\n";
+
+  for (int config = 0; config < 3; ++config)
+  {
+    filters::LZ4BufferFilter filter;
+
+    if (config == 1)
+    {
+      filter.acceleration = 8;
+    }
+    else if (config == 2)
+    {
+      filter.set_dictionary(build_message(0, 20, 0));
+    }
+
+    size_t encoded_total = 0;
+    int64_t encode_time = 0;
+    int64_t decode_time = 0;
+    bool matches = true;
+
+    for (int pass = 0; pass < 10; ++pass)
+    {
+      for (auto& message : messages)
+      {
+        memcpy(buffer.data(), message.data(), message.size());
+
+        int64_t start = utility::get_time();
+        int size = filter.encode(
+            buffer.data(), (int)message.size(), (int)buffer.size());
+        int64_t middle = utility::get_time();
+        int decoded = filter.decode(buffer.data(), size, (int)buffer.size());
+        int64_t end = utility::get_time();
+
+        encode_time += middle - start;
+        decode_time += end - middle;
+
+        if (pass == 0)
+        {
+          encoded_total += size;
+          matches = matches && decoded == (int)message.size() &&
+                    memcmp(buffer.data(), message.data(), decoded) == 0;
+        }
+      }
+    }
+
+    double mb = (double)total * 10 / 1000000;
+
+    std::cerr << "  "
+              << (config == 0 ? "default" :
+                                 (config == 1 ? "acceleration 8" :
+                                                "dictionary"))
+              << ": ratio " << (double)total / encoded_total << ", encode "
+              << mb / (encode_time / 1000000000.0) << " MB/s, decode "
+              << mb / (decode_time / 1000000000.0) << " MB/s\n";
+
+    if (!matches)
+    {
+      std::cerr << "  FAIL: decoded messages differ\n";
+      ++madara_fails;
+    }
+  }
+}
+
+#endif  // _USE_LZ4_
+
 int main(int, char**)
 {
   test_dynamic_predicate_filter();
@@ -470,6 +773,11 @@ int main(int, char**)
   test_variable_map_filter();
   test_fragments_to_files_filter();
 
+#ifdef _USE_LZ4_
+  test_lz4_buffer_filter();
+  benchmark_lz4_buffer_filter();
+#endif
+
   madara::knowledge::KnowledgeRecordFilters filters;
 
   std::cerr
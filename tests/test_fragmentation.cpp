@@ -1,12 +1,16 @@
 
 #include "madara/transport/Fragmentation.h"
 #include "madara/transport/MessageHeader.h"
+#include "madara/transport/udp/UdpTransport.h"
+#include "madara/knowledge/KnowledgeBase.h"
 #include "madara/knowledge/KnowledgeRecord.h"
 #include "madara/utility/Utility.h"
 #include <stdio.h>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #ifdef _USE_SSL_
   #include "madara/filters/ssl/AESBufferFilter.h"
@@ -565,6 +569,173 @@ void test_ssl(void)
 #endif // end if SSL
 }
 
+void test_slices(void)
+{
+  std::cerr << "Testing copy-free fragment slices...\n";
+  uint32_t size = 300000 + transport::MessageHeader::static_encoded_size();
+
+  std::vector<char> payload(size);
+  char* buffer = payload.data();
+  int64_t buffer_remaining = size;
+
+  transport::MessageHeader header;
+  header.size = size;
+  header.clock = 7;
+
+  buffer = header.write(buffer, buffer_remaining);
+
+  for (int i = 0; i < 300000; ++i)
+  {
+    buffer[i] = chars[i % 10];
+  }
+
+  transport::FragmentMap map;
+  transport::FragmentSlices slices;
+
+  transport::frag(payload.data(), size, "agent0", "testing", header.clock,
+      1000, 0, 0, 50000, map);
+  transport::frag(payload.data(), size, "agent0", "testing", header.clock,
+      1000, 0, 0, 50000, slices);
+
+  bool matched = slices.size() == map.size();
+
+  for (size_t i = 0; matched && i < slices.size(); ++i)
+  {
+    const char* fragment = map[(uint32_t)i].get();
+
+    matched = transport::MessageHeader::get_size(fragment) ==
+                  slices.header_size() + slices.payloads[i].second &&
+              memcmp(fragment, slices.header(i), slices.header_size()) == 0 &&
+              memcmp(fragment + slices.header_size(), slices.payloads[i].first,
+                  slices.payloads[i].second) == 0;
+  }
+
+  if (matched)
+  {
+    std::cerr << "SUCCESS. slices match copied fragments.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. slices do not match copied fragments.\n";
+    ++madara_fails;
+  }
+
+  // slices refer to the source instead of copying it
+  if (slices.size() > 0 &&
+      slices.payloads[0].first == payload.data() &&
+      slices.payloads.back().first + slices.payloads.back().second ==
+          payload.data() + size)
+  {
+    std::cerr << "SUCCESS. slices point into the source buffer.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. slices do not point into the source buffer.\n";
+    ++madara_fails;
+  }
+
+  transport::delete_fragments(map);
+}
+
+/**
+ * Exposes the send path of the UDP transport
+ **/
+class BenchmarkTransport : public transport::UdpTransport
+{
+public:
+  BenchmarkTransport(const std::string& id,
+      madara::knowledge::ThreadSafeContext& context,
+      transport::TransportSettings& config)
+    : UdpTransport(id, context, config, true)
+  {
+  }
+
+  using transport::UdpTransport::send_message;
+
+  /**
+   * Sends a message the way the transport did before slices: copies of
+   * every fragment, sent to each host with one system call apiece
+   **/
+  long send_copies(const char* buf, size_t size, uint64_t clock)
+  {
+    long bytes_sent = 0;
+    transport::FragmentMap map;
+
+    transport::frag(buf, size, id_.c_str(), settings_.write_domain.c_str(),
+        clock, utility::get_time(), 0, 0, settings_.max_fragment_size, map);
+
+    for (auto& fragment : map)
+    {
+      for (size_t i = 1; i < addresses_.size(); ++i)
+      {
+        bytes_sent += send_buffer(addresses_[i], fragment.second.get(),
+            (size_t)transport::MessageHeader::get_size(fragment.second.get()));
+      }
+    }
+
+    transport::delete_fragments(map);
+
+    return bytes_sent;
+  }
+};
+
+void benchmark_send(void)
+{
+  std::cerr << "Benchmarking fragmented sends to 12 unicast hosts...\n";
+
+  madara::knowledge::KnowledgeBase kb;
+  transport::TransportSettings settings;
+  settings.type = transport::UDP;
+
+  // the first host is our own port, the rest are peers
+  for (int i = 0; i <= 12; ++i)
+  {
+    settings.hosts.push_back("127.0.0.1:" + std::to_string(40150 + i));
+  }
+
+  BenchmarkTransport udp("benchmark", kb.get_context(), settings);
+
+  const size_t size = 4000000;
+  std::vector<char> message(size, 'm');
+  const int iterations = 5;
+
+  long copied_bytes = 0, sliced_bytes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    copied_bytes += udp.send_copies(message.data(), size, i);
+  }
+  double copied_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    sliced_bytes += udp.send_message(message.data(), size, i);
+  }
+  double sliced_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::cerr << "  " << iterations << " x " << size << " byte messages: "
+            << "copied fragments " << copied_ms / iterations << " ms ("
+            << copied_bytes << " bytes), sliced fragments "
+            << sliced_ms / iterations << " ms (" << sliced_bytes
+            << " bytes)\n";
+
+  if (sliced_bytes == copied_bytes && sliced_bytes > 0)
+  {
+    std::cerr << "SUCCESS. both send paths sent the same bytes.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. send paths sent different bytes.\n";
+    ++madara_fails;
+  }
+
+  udp.close();
+}
+
 int main(int argc, char* argv[])
 {
   handle_arguments(argc, argv);
@@ -573,6 +744,8 @@ int main(int argc, char* argv[])
   test_add_frag();
   test_records_frag();
   test_ssl();
+  test_slices();
+  benchmark_send();
 
   if (madara_fails > 0)
   {
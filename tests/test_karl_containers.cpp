@@ -19,8 +19,22 @@
 #include "madara/knowledge/containers/CircularBuffer.h"
 #include "madara/knowledge/containers/NativeCircularBufferConsumer.h"
 #include "madara/knowledge/containers/CircularBufferConsumer.h"
+#include "madara/knowledge/containers/Counter.h"
+#include "madara/knowledge/containers/Aggregate.h"
+#include "madara/knowledge/containers/IntegerStaged.h"
+#include "madara/knowledge/containers/DoubleStaged.h"
+#include "madara/knowledge/containers/StringStaged.h"
+#include "madara/knowledge/containers/NativeDoubleVectorStaged.h"
+#include "madara/knowledge/containers/Transaction.h"
+#include "madara/knowledge/containers/View.h"
+#include "madara/knowledge/ContextGuard.h"
 #include "madara/knowledge/KnowledgeBase.h"
+#include "madara/exceptions/ContextException.h"
+#include "madara/utility/Utility.h"
+#include <atomic>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 namespace knowledge = madara::knowledge;
 namespace containers = knowledge::containers;
@@ -3490,6 +3504,501 @@ std::ostream& operator<<(std::ostream& output, const SpecialClass& value)
   return output;
 }
 
+void test_counter(void)
+{
+  std::cerr << "************* COUNTER: INCREMENTAL TOTALS*************\n";
+  knowledge::KnowledgeBase knowledge;
+  containers::Counter first("count", knowledge, 0, 3);
+  containers::Counter second("count", knowledge, 1, 3);
+
+  ++first;
+  ++first;
+  second += 5;
+
+  std::cerr << "Total after local changes: " << first.to_integer() << "\n";
+
+  if (first.to_integer() == 7 && second.to_integer() == 7)
+  {
+    std::cerr << "SUCCESS. Counters saw local changes.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Counters did not see local changes.\n";
+    ++madara_fails;
+  }
+
+  // a third counter updates from the network and through KaRL
+  KnowledgeRecord remote(KnowledgeRecord::Integer(10));
+  remote.clock = 5;
+  knowledge.get_context().update_record_from_external("count.2", remote);
+
+  knowledge.evaluate("count.0 = count.0 + 1");
+
+  std::cerr << "Total after remote changes: " << second.to_integer() << "\n";
+
+  if (second.to_integer() == 18 && second == 18 && second > 17)
+  {
+    std::cerr << "SUCCESS. Counters saw remote and KaRL changes.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Counters did not see remote and KaRL changes.\n";
+    ++madara_fails;
+  }
+
+  // copies share the total, and resizing rebuilds it
+  containers::Counter copy(first);
+  first.resize(0, 2);
+
+  if (copy.to_integer() == 18 && first.to_integer() == 8)
+  {
+    std::cerr << "SUCCESS. Counter copies and resizes were correct.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Counter copies and resizes were " << copy.to_integer()
+              << " and " << first.to_integer() << ".\n";
+    ++madara_fails;
+  }
+
+  knowledge.clear();
+
+  if (second.to_integer() == 0)
+  {
+    std::cerr << "SUCCESS. Counter total was reset by clear.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Counter total was " << second.to_integer()
+              << " after clear.\n";
+    ++madara_fails;
+  }
+}
+
+void test_aggregate(void)
+{
+  std::cerr << "************* AGGREGATE: SUM, MIN AND MAX*************\n";
+  knowledge::KnowledgeBase knowledge;
+
+  knowledge.set("agent.0", KnowledgeRecord::Integer(4));
+  knowledge.set("agent.1", KnowledgeRecord::Integer(-2));
+  knowledge.set("agent.2", KnowledgeRecord::Integer(9));
+
+  containers::Aggregate sum("agent", knowledge, 4);
+  containers::Aggregate min(
+      "agent", knowledge, 4, knowledge::RecordAggregate::MIN);
+  containers::Aggregate max(
+      "agent", knowledge, 4, knowledge::RecordAggregate::MAX);
+
+  std::cerr << sum.get_debug_info() << "\n";
+
+  if (sum.to_integer() == 11 && min.to_integer() == -2 &&
+      max.to_integer() == 9)
+  {
+    std::cerr << "SUCCESS. Aggregates of existing variables were correct.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregates were " << sum.to_integer() << ", "
+              << min.to_integer() << " and " << max.to_integer() << ".\n";
+    ++madara_fails;
+  }
+
+  // lower the maximum and raise the minimum, which needs the other values
+  knowledge.set("agent.2", KnowledgeRecord::Integer(1));
+  knowledge.set("agent.1", KnowledgeRecord::Integer(3));
+
+  if (sum.to_integer() == 8 && min.to_integer() == 1 &&
+      max.to_integer() == 4)
+  {
+    std::cerr << "SUCCESS. Aggregates followed changes.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregates were " << sum.to_integer() << ", "
+              << min.to_integer() << " and " << max.to_integer() << ".\n";
+    ++madara_fails;
+  }
+
+  knowledge.set("agent.3", 2.5);
+
+  if (sum.to_double() == 10.5 && min.to_double() == 1 &&
+      max.to_double() == 4 &&
+      sum.to_record().type() == KnowledgeRecord::DOUBLE)
+  {
+    std::cerr << "SUCCESS. Aggregates included a double.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregates were " << sum.to_double() << ", "
+              << min.to_double() << " and " << max.to_double() << ".\n";
+    ++madara_fails;
+  }
+
+  knowledge.get_context().delete_variable("agent.0");
+
+  if (sum.to_double() == 6.5 && max.to_double() == 3)
+  {
+    std::cerr << "SUCCESS. Deleted variables left the aggregates.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregates were " << sum.to_double() << " and "
+              << max.to_double() << " after a delete.\n";
+    ++madara_fails;
+  }
+
+  knowledge.clear(true);
+
+  if (sum.to_integer() == 0 && !max.to_record().exists())
+  {
+    std::cerr << "SUCCESS. Aggregates were reset by clear.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregates were " << sum.to_string() << " and "
+              << max.to_string() << " after clear.\n";
+    ++madara_fails;
+  }
+
+  // resizing reattaches to the new variables
+  knowledge.set("agent.0", KnowledgeRecord::Integer(7));
+  max.resize(2);
+
+  if (max.to_integer() == 7 && max.size() == 2)
+  {
+    std::cerr << "SUCCESS. Aggregate was rebuilt by resize.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Aggregate was " << max.to_string()
+              << " after resize.\n";
+    ++madara_fails;
+  }
+}
+
+void benchmark_counter(void)
+{
+  std::cerr << "************* COUNTER: READ BENCHMARK*************\n";
+  knowledge::KnowledgeBase knowledge;
+  const int counters = 500;
+  const int reads = 10000;
+
+  containers::Counter counter("swarm", knowledge, 0, counters);
+
+  std::stringstream buffer;
+  for (int i = 0; i < counters; ++i)
+  {
+    knowledge.set("swarm." + std::to_string(i), KnowledgeRecord::Integer(i));
+    buffer << (i == 0 ? "" : "+") << "swarm." << i;
+  }
+
+  // the previous implementation evaluated a sum of every counter per read
+  knowledge::CompiledExpression expression = knowledge.compile(buffer.str());
+
+  int64_t start = madara::utility::get_time();
+  KnowledgeRecord::Integer evaluated = 0;
+  for (int i = 0; i < reads; ++i)
+  {
+    evaluated = knowledge.evaluate(expression).to_integer();
+  }
+  int64_t middle = madara::utility::get_time();
+  KnowledgeRecord::Integer maintained = 0;
+  for (int i = 0; i < reads; ++i)
+  {
+    maintained = counter.to_integer();
+  }
+  int64_t end = madara::utility::get_time();
+
+  std::cerr << "  " << counters << " counters, evaluated: "
+            << (middle - start) / reads << " ns/read, maintained: "
+            << (end - middle) / reads << " ns/read\n";
+
+  if (evaluated == maintained && maintained == counters * (counters - 1) / 2)
+  {
+    std::cerr << "SUCCESS. Evaluated and maintained totals matched.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Evaluated total was " << evaluated
+              << " and maintained total was " << maintained << ".\n";
+    ++madara_fails;
+  }
+}
+
+void test_transaction(void)
+{
+  std::cerr << "************* TRANSACTION: STAGED CONTAINERS*************\n";
+  knowledge::KnowledgeBase knowledge;
+
+  containers::IntegerStaged count("tx.count", knowledge);
+  containers::DoubleStaged speed("tx.speed", knowledge);
+  containers::StringStaged mode("tx.mode", knowledge);
+  containers::NativeDoubleVectorStaged position("tx.position", knowledge, 3);
+
+  containers::Transaction transaction(knowledge);
+  transaction.add(count);
+  transaction.add(speed);
+  transaction.add(mode);
+  transaction.add(position);
+
+  count = 3;
+  speed = 2.5;
+  mode = "patrol";
+  position.set(2, 7.0);
+
+  bool staged = knowledge.get("tx.count").to_integer() == 0 &&
+                knowledge.get("tx.mode").to_string() != "patrol";
+
+  transaction.commit();
+
+  if (staged && transaction.size() == 4 &&
+      knowledge.get("tx.count").to_integer() == 3 &&
+      knowledge.get("tx.speed").to_double() == 2.5 &&
+      knowledge.get("tx.mode").to_string() == "patrol" &&
+      knowledge.get("tx.position").retrieve_index(2).to_double() == 7.0)
+  {
+    std::cerr << "SUCCESS. Transaction committed staged values.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Transaction did not commit staged values.\n";
+    knowledge.print();
+    ++madara_fails;
+  }
+
+  knowledge.set("tx.count", KnowledgeRecord::Integer(8));
+  knowledge.set("tx.mode", "return");
+
+  transaction.read();
+
+  if (*count == 8 && mode.to_string() == "return" && position[2] == 7.0)
+  {
+    std::cerr << "SUCCESS. Transaction read the knowledge base.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Transaction did not read the knowledge base.\n";
+    ++madara_fails;
+  }
+
+  // containers of another knowledge base are rejected, including those
+  // renamed into one after they were enlisted
+  knowledge::KnowledgeBase other;
+  containers::IntegerStaged foreign("tx.foreign", other);
+  containers::IntegerStaged moved("tx.moved", knowledge);
+  bool add_rejected = false;
+  bool commit_rejected = false;
+
+  try
+  {
+    transaction.add(foreign);
+  }
+  catch (madara::exceptions::ContextException&)
+  {
+    add_rejected = true;
+  }
+
+  transaction.add(moved);
+  moved.set_name("tx.moved", other);
+  moved = 5;
+  count = 9;
+
+  try
+  {
+    transaction.commit();
+  }
+  catch (madara::exceptions::ContextException&)
+  {
+    commit_rejected = true;
+  }
+
+  if (add_rejected && commit_rejected && transaction.size() == 5 &&
+      knowledge.get("tx.count").to_integer() == 8 &&
+      other.get("tx.moved").to_integer() == 0)
+  {
+    std::cerr << "SUCCESS. Transaction rejected foreign containers.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Transaction accepted foreign containers.\n";
+    ++madara_fails;
+  }
+
+  // a reader holding the context lock never sees half of a commit
+  containers::IntegerStaged first("tx.first", knowledge);
+  containers::IntegerStaged second("tx.second", knowledge);
+  containers::Transaction pair(knowledge);
+  pair.add(first);
+  pair.add(second);
+
+  std::atomic<bool> done(false);
+  std::atomic<int> split(0);
+
+  std::thread reader([&]() {
+    while (!done)
+    {
+      knowledge::ContextGuard guard(knowledge);
+
+      if (knowledge.get("tx.first").to_integer() !=
+          knowledge.get("tx.second").to_integer())
+      {
+        ++split;
+      }
+    }
+  });
+
+  for (KnowledgeRecord::Integer i = 1; i <= 20000; ++i)
+  {
+    first = i;
+    second = i;
+    pair.commit();
+  }
+
+  done = true;
+  reader.join();
+
+  if (split == 0)
+  {
+    std::cerr << "SUCCESS. Readers never saw a partial commit.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Readers saw " << split << " partial commits.\n";
+    ++madara_fails;
+  }
+}
+
+void benchmark_transaction(void)
+{
+  std::cerr << "************* TRANSACTION: COMMIT BENCHMARK*************\n";
+  knowledge::KnowledgeBase knowledge;
+  const int values = 30;
+  const int steps = 10000;
+
+  std::vector<containers::IntegerStaged> staged(values);
+  containers::Transaction transaction(knowledge);
+
+  for (int i = 0; i < values; ++i)
+  {
+    staged[i].set_name("control." + std::to_string(i), knowledge);
+    transaction.add(staged[i]);
+  }
+
+  int64_t start = madara::utility::get_time();
+  for (int step = 0; step < steps; ++step)
+  {
+    for (int i = 0; i < values; ++i)
+    {
+      staged[i] = step;
+      staged[i].write();
+    }
+    knowledge.send_modifieds();
+  }
+  int64_t middle = madara::utility::get_time();
+  for (int step = 0; step < steps; ++step)
+  {
+    for (int i = 0; i < values; ++i)
+    {
+      staged[i] = step;
+    }
+    transaction.commit();
+  }
+  int64_t end = madara::utility::get_time();
+
+  std::cerr << "  " << values << " staged values, separate writes and send: "
+            << (middle - start) / steps << " ns/step, one commit: "
+            << (end - middle) / steps << " ns/step\n";
+
+  if (knowledge.get("control.29").to_integer() == steps - 1)
+  {
+    std::cerr << "SUCCESS. Committed values were correct.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. Committed values were not correct.\n";
+    ++madara_fails;
+  }
+}
+
+void test_view(void)
+{
+  std::cerr << "************* VIEW: RELATED VARIABLES*************\n";
+  knowledge::KnowledgeBase knowledge;
+
+  knowledge.set("agent.0.x", 1.0);
+  knowledge.set("agent.0.y", 2.0);
+  knowledge.set("agent.0.battery", KnowledgeRecord::Integer(80));
+
+  containers::View pose(
+      {"agent.0.x", "agent.0.y", "agent.0.battery"}, knowledge);
+
+  if (pose.size() == 3 && pose[0].to_double() == 1.0 &&
+      pose[1].to_double() == 2.0 && pose[2].to_integer() == 80 &&
+      pose.is_true())
+  {
+    std::cerr << "SUCCESS. View read the variables.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. View did not read the variables.\n";
+    std::cerr << "  " << pose.get_debug_info() << "\n";
+    ++madara_fails;
+  }
+
+  pose.set(0, KnowledgeRecord(3.0));
+  pose.set(2, KnowledgeRecord(KnowledgeRecord::Integer(75)));
+
+  bool staged = knowledge.get("agent.0.x").to_double() == 1.0;
+
+  pose.write();
+
+  if (staged && knowledge.get("agent.0.x").to_double() == 3.0 &&
+      knowledge.get("agent.0.battery").to_integer() == 75)
+  {
+    std::cerr << "SUCCESS. View wrote staged values.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. View did not write staged values.\n";
+    knowledge.print();
+    ++madara_fails;
+  }
+
+  knowledge.set("agent.0.y", 5.0);
+  pose.read();
+
+  if (pose[1].to_double() == 5.0)
+  {
+    std::cerr << "SUCCESS. View read updated values.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. View did not read updated values.\n";
+    ++madara_fails;
+  }
+
+  containers::IntegerStaged mode("agent.0.mode", knowledge);
+  containers::Transaction transaction(knowledge);
+  transaction.add(pose);
+  transaction.add(mode);
+
+  pose.set(1, KnowledgeRecord(6.0));
+  mode = 2;
+  transaction.commit();
+
+  if (knowledge.get("agent.0.y").to_double() == 6.0 &&
+      knowledge.get("agent.0.mode").to_integer() == 2)
+  {
+    std::cerr << "SUCCESS. View joined a Transaction.\n";
+  }
+  else
+  {
+    std::cerr << "FAIL. View did not join a Transaction.\n";
+    ++madara_fails;
+  }
+}
+
 int main(int, char**)
 {
   test_vector();
@@ -3517,6 +4026,15 @@ int main(int, char**)
   test_circular_consumer();
   test_native_circular_consumer();  // TODO needs to be fixed
 
+  test_counter();
+  test_aggregate();
+  benchmark_counter();
+
+  test_transaction();
+  benchmark_transaction();
+
+  test_view();
+
   if (madara_fails > 0)
   {
     std::cerr << "OVERALL: FAIL. " << madara_fails << " tests failed.\n";
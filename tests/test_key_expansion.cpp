@@ -1,13 +1,20 @@
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <assert.h>
 
 #include "madara/knowledge/KnowledgeBase.h"
+#include "test.h"
+
+typedef madara::knowledge::KnowledgeRecord::Integer Integer;
+typedef std::chrono::steady_clock Clock;
 
 // test functions
 void test_expansion(madara::knowledge::KnowledgeBase& knowledge);
+void test_cached_expansion(void);
+void benchmark_expansion(void);
 
 int main(int, char**)
 {
@@ -18,10 +25,23 @@ int main(int, char**)
 
   knowledge.print();
 
-  // asserts will show failures
-  std::cerr << "OVERALL: SUCCESS.\n";
+#ifndef _MADARA_NO_KARL_
+  test_cached_expansion();
+  benchmark_expansion();
+#endif  // _MADARA_NO_KARL_
 
-  return 0;
+  // asserts will also show failures
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
 }
 
 /// tests key expansion
@@ -56,3 +76,116 @@ void test_expansion(madara::knowledge::KnowledgeBase& knowledge)
   std::cout << "This test is disabled due to karl feature being disabled.\n";
 #endif  // _MADARA_NO_KARL_
 }
+
+#ifndef _MADARA_NO_KARL_
+
+/// tests that repeated expansions follow changes to index variables
+void test_cached_expansion(void)
+{
+  log("Testing cached key expansions\n");
+
+  madara::knowledge::KnowledgeBase knowledge;
+  madara::knowledge::CompiledExpression write =
+      knowledge.compile("agent.{.id}.pos = .value");
+  madara::knowledge::CompiledExpression read =
+      knowledge.compile("agent.{.id}.pos");
+
+  knowledge.set(".id", Integer(1));
+  knowledge.set(".value", Integer(5));
+  knowledge.evaluate(write);
+
+  knowledge.set(".id", Integer(2));
+  knowledge.set(".value", Integer(7));
+  knowledge.evaluate(write);
+
+  TEST_EQ(knowledge.get("agent.1.pos").to_integer(), Integer(5));
+  TEST_EQ(knowledge.get("agent.2.pos").to_integer(), Integer(7));
+  TEST_EQ(knowledge.evaluate(read).to_integer(), Integer(7));
+
+  knowledge.set(".id", Integer(1));
+  TEST_EQ(knowledge.evaluate(read).to_integer(), Integer(5));
+
+  // reads of missing variables do not create them
+  knowledge.set(".id", Integer(3));
+  TEST_EQ(knowledge.evaluate(read).exists(), false);
+  TEST_EQ(knowledge.exists("agent.3.pos"), false);
+
+  // deleted variables are looked up again
+  knowledge.set(".id", Integer(1));
+  knowledge.evaluate(read);
+  knowledge.get_context().delete_variable("agent.1.pos");
+  TEST_EQ(knowledge.evaluate(read).exists(), false);
+  knowledge.set("agent.1.pos", Integer(9));
+  TEST_EQ(knowledge.evaluate(read).to_integer(), Integer(9));
+
+  // non-integer indices are expanded the slow way
+  knowledge.set(".id", "bob");
+  knowledge.evaluate(write);
+  TEST_EQ(knowledge.get("agent.bob.pos").to_integer(), Integer(7));
+
+  // loops, increments and arrays
+  knowledge.evaluate(".i[0->10)(a{.i} = .i * 2)");
+  knowledge.evaluate(".i[0->10)(++a{.i})");
+  TEST_EQ(knowledge.get("a0").to_integer(), Integer(1));
+  TEST_EQ(knowledge.get("a9").to_integer(), Integer(19));
+
+  knowledge.evaluate(".i[0->4)(pos{.i}[1] = .i + 10)");
+  knowledge.evaluate(".i[0->4)(--pos{.i}[1])");
+  TEST_EQ(knowledge.get("pos3").retrieve_index(1).to_integer(), Integer(12));
+
+  // multiple indices
+  knowledge.evaluate(".x[0->3)(.y[0->3)(grid.{.x}.{.y} = .x * 10 + .y))");
+  TEST_EQ(knowledge.get("grid.2.1").to_integer(), Integer(21));
+}
+
+double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+/// benchmarks expanded variables in swarm-indexed logic and loops
+void benchmark_expansion(void)
+{
+  log("Benchmarking key expansions\n");
+
+  madara::knowledge::KnowledgeBase knowledge;
+
+  const size_t num_agents = 100;
+  const size_t iterations = 20000;
+  const size_t loops = 200;
+
+  knowledge.set(".id", Integer(7));
+  madara::knowledge::CompiledExpression single = knowledge.compile(
+      "agent.{.id}.pos = agent.{.id}.pos + agent.{.id}.velocity");
+
+  knowledge.evaluate(".i[0->100)(agent.{.i}.velocity = 1)");
+  madara::knowledge::CompiledExpression swarm = knowledge.compile(
+      ".i[0->100)(agent.{.i}.pos = agent.{.i}.pos + agent.{.i}.velocity)");
+
+  auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+  {
+    knowledge.evaluate(single);
+  }
+  double single_ms = elapsed_ms(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < loops; ++i)
+  {
+    knowledge.evaluate(swarm);
+  }
+  double swarm_ms = elapsed_ms(start);
+
+  log("  %d evaluations with a fixed .id: %.2f ms (%.0f ns each)\n",
+      (int)iterations, single_ms, single_ms * 1000000 / iterations);
+  log("  %d loops over %d agents: %.2f ms (%.0f ns per agent)\n",
+      (int)loops, (int)num_agents, swarm_ms,
+      swarm_ms * 1000000 / (loops * num_agents));
+
+  TEST_EQ(knowledge.get("agent.7.pos").to_integer(),
+      Integer(iterations + loops));
+  TEST_EQ(knowledge.get("agent.99.pos").to_integer(), Integer(loops));
+}
+
+#endif  // _MADARA_NO_KARL_
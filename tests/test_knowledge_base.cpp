@@ -3,13 +3,365 @@
 #include "madara/transport/TransportSettings.h"
 #include "madara/logger/GlobalLogger.h"
 #include "madara/utility/Utility.h"
+#include "madara/exceptions/UninitializedException.h"
 #include "test.h"
 
+#include <functional>
 #include <sstream>
+#include <thread>
 
 namespace logger = madara::logger;
 namespace utility = madara::utility;
 
+typedef madara::knowledge::KnowledgeRecord::Integer Integer;
+
+void test_typed_accessors(void)
+{
+  std::cerr << "Testing typed get_as, set_as and get_many\n";
+
+  madara::knowledge::KnowledgeBase knowledge;
+
+  auto speed = knowledge.get_ref("speed");
+  auto count = knowledge.get_ref("count");
+  auto name = knowledge.get_ref("name");
+  auto position = knowledge.get_ref("position");
+
+  TEST_EQ(knowledge.set_as<double>(speed, 2.5), 0);
+  TEST_EQ(knowledge.set_as<int64_t>(count, 7), 0);
+  TEST_EQ(knowledge.set_as<std::string>(name, "agent.0"), 0);
+  TEST_EQ(knowledge.set_as<bool>("ready", true), 0);
+  TEST_EQ(knowledge.set_as(position, std::vector<double>{1.0, 2.0, 3.0}), 0);
+
+  TEST_EQ(knowledge.get_as<double>(speed), 2.5);
+  TEST_EQ(knowledge.get_as<int>(speed), 2);
+  TEST_EQ(knowledge.get_as<int64_t>(count), (int64_t)7);
+  TEST_EQ(knowledge.get_as<double>("count"), 7.0);
+  TEST_EQ(knowledge.get_as<std::string>(name), "agent.0");
+  TEST_EQ(knowledge.get_as<bool>("ready"), true);
+  TEST_EQ(knowledge.get_as<Integer>("ready"), (Integer)1);
+  TEST_EQ(knowledge.get_as<std::vector<double>>(position).size(), (size_t)3);
+  TEST_EQ(knowledge.get(count).type(),
+      (uint32_t)madara::knowledge::KnowledgeRecord::INTEGER);
+  TEST_EQ(knowledge.get(speed).type(),
+      (uint32_t)madara::knowledge::KnowledgeRecord::DOUBLE);
+
+  // missing variables read as empty records
+  TEST_EQ(knowledge.get_as<double>("missing"), 0.0);
+  TEST_EQ(knowledge.get_as<std::string>("missing"), "");
+  TEST_EQ(knowledge.exists("missing"), false);
+
+  // unless the settings ask for an exception, as get does
+  madara::knowledge::KnowledgeReferenceSettings strict;
+  strict.exception_on_unitialized = true;
+  auto unset = knowledge.get_ref("unset");
+  madara::knowledge::VariableReference invalid;
+
+  auto throws = [](const std::function<void()>& read) {
+    try
+    {
+      read();
+    }
+    catch (const madara::exceptions::UninitializedException&)
+    {
+      return true;
+    }
+
+    return false;
+  };
+
+  bool thrown[] = {
+      throws([&] { knowledge.get("missing", strict); }),
+      throws([&] { knowledge.get_as<double>("missing", strict); }),
+      throws([&] { knowledge.get_as<double>("unset", strict); }),
+      throws([&] { knowledge.get(unset, strict); }),
+      throws([&] { knowledge.get_as<double>(unset, strict); }),
+      throws([&] { knowledge.get_as<double>(invalid, strict); }),
+  };
+
+  for (bool read_threw : thrown)
+  {
+    TEST_EQ(read_threw, true);
+  }
+
+  bool set_threw = throws([&] { knowledge.get_as<double>(speed, strict); });
+
+  TEST_EQ(set_threw, false);
+  TEST_EQ(knowledge.get_as<double>(invalid), 0.0);
+
+  double s = 0;
+  int64_t c = 0;
+  std::string n;
+  bool r = false;
+  knowledge.get_many(
+      speed, s, count, c, name, n, knowledge.get_ref("ready"), r);
+
+  TEST_EQ(s, 2.5);
+  TEST_EQ(c, (int64_t)7);
+  TEST_EQ(n, "agent.0");
+  TEST_EQ(r, true);
+
+  // typed reads see the newest entry of records with history
+  knowledge.set_history_capacity("speed", 3);
+  knowledge.set_as(speed, 4.0);
+  knowledge.set_as(speed, 5.0);
+  TEST_EQ(knowledge.get_as<double>(speed), 5.0);
+}
+
+void benchmark_typed_accessors(void)
+{
+  std::cerr << "Benchmarking typed accessors against get and set\n";
+
+  madara::knowledge::KnowledgeBase knowledge;
+  const int iterations = 200000;
+
+  auto x = knowledge.get_ref("agent.0.x");
+  auto y = knowledge.get_ref("agent.0.y");
+  auto z = knowledge.get_ref("agent.0.z");
+  auto heading = knowledge.get_ref("agent.0.heading");
+  auto label = knowledge.get_ref("agent.0.label");
+
+  knowledge.set(x, 1.0);
+  knowledge.set(y, 2.0);
+  knowledge.set(z, 3.0);
+  knowledge.set(heading, 90.0);
+  knowledge.set(label, "an agent label long enough to be allocated");
+
+  double sum = 0;
+  size_t length = 0;
+
+  int64_t start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    sum += knowledge.get("agent.0.x").to_double();
+  }
+  int64_t by_name = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    sum += knowledge.get(x).to_double();
+  }
+  int64_t by_ref = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    sum += knowledge.get_as<double>(x);
+  }
+  int64_t typed = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    length += knowledge.get(label).to_string().size();
+  }
+  int64_t string_by_ref = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    length += knowledge.get_as<std::string>(label).size();
+  }
+  int64_t string_typed = utility::get_time() - start;
+
+  double vx = 0, vy = 0, vz = 0, vh = 0;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    vx = knowledge.get(x).to_double();
+    vy = knowledge.get(y).to_double();
+    vz = knowledge.get(z).to_double();
+    vh = knowledge.get(heading).to_double();
+    sum += vx + vy + vz + vh;
+  }
+  int64_t separate = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    knowledge.get_many(x, vx, y, vy, z, vz, heading, vh);
+    sum += vx + vy + vz + vh;
+  }
+  int64_t many = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    knowledge.set(x, (double)i);
+  }
+  int64_t set_by_ref = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    knowledge.set_as<double>(x, i);
+  }
+  int64_t set_typed = utility::get_time() - start;
+
+  std::cerr << "  get(name).to_double ():   " << by_name / iterations
+            << " ns\n";
+  std::cerr << "  get(ref).to_double ():    " << by_ref / iterations
+            << " ns\n";
+  std::cerr << "  get_as<double>(ref):      " << typed / iterations << " ns\n";
+  std::cerr << "  get(ref).to_string ():    " << string_by_ref / iterations
+            << " ns\n";
+  std::cerr << "  get_as<std::string>(ref): " << string_typed / iterations
+            << " ns\n";
+  std::cerr << "  4 x get(ref).to_double (): " << separate / iterations
+            << " ns\n";
+  std::cerr << "  get_many of 4 doubles:     " << many / iterations << " ns\n";
+  std::cerr << "  set(ref, double):         " << set_by_ref / iterations
+            << " ns\n";
+  std::cerr << "  set_as<double>(ref):      " << set_typed / iterations
+            << " ns\n";
+
+  TEST_EQ(knowledge.get_as<double>(x), (double)(iterations - 1));
+  TEST_GT(sum, 0.0);
+  TEST_GT(length, (size_t)0);
+}
+
+void test_bulk_access(void)
+{
+  std::cerr << "Testing get_refs, get_all and set_all\n";
+
+  madara::knowledge::KnowledgeBase knowledge;
+
+  std::vector<std::string> names = {"agent.0.x", "agent.0.y", "agent.0.z"};
+  std::vector<madara::knowledge::KnowledgeRecord> values = {
+      madara::knowledge::KnowledgeRecord(1.0),
+      madara::knowledge::KnowledgeRecord(Integer(2)),
+      madara::knowledge::KnowledgeRecord("three")};
+
+  TEST_EQ(knowledge.set_all(names, values), 0);
+  TEST_EQ(knowledge.get("agent.0.x").to_double(), 1.0);
+  TEST_EQ(knowledge.get("agent.0.y").to_integer(), (Integer)2);
+  TEST_EQ(knowledge.get("agent.0.z").to_string(), "three");
+
+  auto refs = knowledge.get_refs(names);
+  TEST_EQ(refs.size(), names.size());
+
+  values[0] = madara::knowledge::KnowledgeRecord(4.0);
+  TEST_EQ(knowledge.set_all(refs, values), 0);
+
+  std::vector<madara::knowledge::KnowledgeRecord> results;
+  knowledge.get_all(refs, results);
+  TEST_EQ(results.size(), names.size());
+  TEST_EQ(results[0].to_double(), 4.0);
+  TEST_EQ(results[2].to_string(), "three");
+
+  // missing variables are read as empty and are not created
+  names.push_back("agent.0.missing");
+  knowledge.get_all(names, results);
+  TEST_EQ(results.size(), names.size());
+  TEST_EQ(results[1].to_integer(), (Integer)2);
+  TEST_EQ(results[3].exists(), false);
+  TEST_EQ(knowledge.exists("agent.0.missing"), false);
+
+  // mismatched sizes are rejected
+  TEST_EQ(knowledge.set_all(names, values), -1);
+
+  // a reader never sees a partially applied set_all
+  const size_t count = 50;
+  std::vector<std::string> group;
+  for (size_t i = 0; i < count; ++i)
+  {
+    group.push_back("agent.1.var" + std::to_string(i));
+  }
+  auto group_refs = knowledge.get_refs(group);
+  std::vector<madara::knowledge::KnowledgeRecord> group_values(
+      count, madara::knowledge::KnowledgeRecord(Integer(0)));
+  knowledge.set_all(group_refs, group_values);
+
+  volatile bool done = false;
+  std::thread writer([&]() {
+    std::vector<madara::knowledge::KnowledgeRecord> next(count);
+    for (Integer step = 1; step <= 2000; ++step)
+    {
+      for (auto& value : next)
+      {
+        value = madara::knowledge::KnowledgeRecord(step);
+      }
+      knowledge.set_all(group_refs, next);
+    }
+    done = true;
+  });
+
+  size_t torn = 0;
+  std::vector<madara::knowledge::KnowledgeRecord> snapshot;
+  while (!done)
+  {
+    knowledge.get_all(group_refs, snapshot);
+    for (auto& value : snapshot)
+    {
+      if (value.to_integer() != snapshot[0].to_integer())
+      {
+        ++torn;
+        break;
+      }
+    }
+  }
+  writer.join();
+
+  TEST_EQ(torn, (size_t)0);
+  TEST_EQ(knowledge.get(group.back()).to_integer(), (Integer)2000);
+}
+
+void benchmark_bulk_access(void)
+{
+  std::cerr << "Benchmarking get_all against get per variable\n";
+
+  madara::knowledge::KnowledgeBase knowledge;
+  const size_t count = 50;
+  const int iterations = 20000;
+
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; ++i)
+  {
+    names.push_back("agent.0.var" + std::to_string(i));
+    knowledge.set(names.back(), (double)i);
+  }
+  auto refs = knowledge.get_refs(names);
+
+  std::vector<madara::knowledge::KnowledgeRecord> values(count);
+  double sum = 0;
+
+  int64_t start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    for (size_t j = 0; j < count; ++j)
+    {
+      values[j] = knowledge.get(refs[j]);
+    }
+    sum += values[count - 1].to_double();
+  }
+  int64_t separate = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    knowledge.get_all(refs, values);
+    sum += values[count - 1].to_double();
+  }
+  int64_t many = utility::get_time() - start;
+
+  start = utility::get_time();
+  for (int i = 0; i < iterations; ++i)
+  {
+    knowledge.get_all(names, values);
+    sum += values[count - 1].to_double();
+  }
+  int64_t many_by_name = utility::get_time() - start;
+
+  std::cerr << "  50 x get(ref):          " << separate / iterations
+            << " ns\n";
+  std::cerr << "  get_all of 50 refs:     " << many / iterations << " ns\n";
+  std::cerr << "  get_all of 50 names:    " << many_by_name / iterations
+            << " ns\n";
+
+  TEST_GT(sum, 0.0);
+}
+
 int main(int, char**)
 {
   // Create static and dynamic KnowledgeBase objects
@@ -145,6 +497,11 @@ int main(int, char**)
     });
   std::cerr << "Found " << kcount << " records" << std::endl;
 
+  test_typed_accessors();
+  benchmark_typed_accessors();
+  test_bulk_access();
+  benchmark_bulk_access();
+
   // Cleanup
   std::cerr << "KnowledgeBase Object Cleanup Started...\n\n";
   delete knowledge1;
@@ -0,0 +1,197 @@
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/containers/Map.h"
+#include "madara/filters/PeerTable.h"
+#include "madara/filters/PeerDiscovery.h"
+#include "madara/filters/EndpointDiscovery.h"
+#include "test.h"
+
+namespace knowledge = madara::knowledge;
+namespace containers = knowledge::containers;
+namespace filters = madara::filters;
+namespace transport = madara::transport;
+
+typedef knowledge::KnowledgeRecord::Integer Integer;
+
+const Integer second = 1000000000;
+
+/**
+ * Counts the peers the knowledge base has under a prefix
+ **/
+size_t count_peers(knowledge::KnowledgeBase& kb, const std::string& prefix)
+{
+  containers::Map peers(prefix, kb);
+
+  std::vector<std::string> keys;
+  peers.sync_keys();
+  peers.keys(keys);
+
+  return keys.size();
+}
+
+/**
+ * Sends a message from an originator through a discovery filter
+ **/
+void receive(filters::AggregateFilter& filter, knowledge::Variables& vars,
+    const std::string& originator, Integer time)
+{
+  knowledge::KnowledgeMap records;
+  transport::TransportContext context(
+      transport::TransportContext::RECEIVING_OPERATION);
+
+  context.set_originator(originator);
+  context.set_endpoint(originator);
+  context.set_current_time((uint64_t)time);
+
+  filter.filter(records, context, vars);
+}
+
+void test_peer_table(void)
+{
+  log("Testing the peer table\n");
+
+  filters::PeerTable table(10);
+  std::vector<std::string> expired;
+
+  TEST_EQ(table.touch("a", 0), true);
+  TEST_EQ(table.touch("b", 5), true);
+  TEST_EQ(table.touch("a", 8), false);
+  TEST_EQ(table.size(), (size_t)2);
+
+  // neither has been silent for more than 10
+  TEST_EQ(table.expire(12, expired), (size_t)0);
+
+  // a was heard from at 8, so only b expires
+  TEST_EQ(table.expire(16, expired), (size_t)1);
+  TEST_EQ(expired.size(), (size_t)1);
+  TEST_EQ(expired[0], "b");
+  TEST_EQ(table.get_last_seen("b"), -1);
+  TEST_EQ(table.get_last_seen("a"), 8);
+
+  TEST_EQ(table.expire(19, expired), (size_t)1);
+  TEST_EQ(table.size(), (size_t)0);
+
+  // peers rejoin after expiring
+  TEST_EQ(table.touch("b", 20), true);
+  TEST_EQ(table.expire(40, expired), (size_t)1);
+
+  // peers never expire without a heart beat
+  filters::PeerTable forever;
+  forever.touch("a", 0);
+  TEST_EQ(forever.expire(1000 * second, expired), (size_t)0);
+  TEST_EQ(forever.size(), (size_t)1);
+}
+
+void test_discovery_filters(void)
+{
+  log("Testing the peer and endpoint discovery filters\n");
+
+  knowledge::KnowledgeBase kb;
+  knowledge::Variables vars(&kb.get_context());
+  filters::PeerDiscovery peers(".peers", 2, 1.0);
+  filters::EndpointDiscovery endpoints(".endpoints", 2, -1);
+  filters::PeerDiscovery every(".every", 2);
+
+  receive(peers, vars, "agent0", 1 * second);
+  receive(peers, vars, "agent1", 1 * second);
+  receive(endpoints, vars, "host0:40000", 1 * second);
+
+  TEST_EQ(count_peers(kb, ".peers"), (size_t)2);
+  TEST_EQ(count_peers(kb, ".endpoints"), (size_t)1);
+
+  // agent1 keeps sending, and the publish interval copies its time
+  receive(peers, vars, "agent1", 1 * second + 5);
+  TEST_EQ(kb.get(".peers.agent1").to_integer(), 1 * second);
+  receive(peers, vars, "agent1", 2 * second + 1);
+  receive(peers, vars, "agent1", 3 * second + 2);
+  TEST_EQ(kb.get(".peers.agent1").to_integer(), 3 * second + 2);
+
+  // by default, every message copies the time of its sender
+  receive(every, vars, "agent1", 1 * second);
+  receive(every, vars, "agent1", 1 * second + 5);
+  TEST_EQ(kb.get(".every.agent1").to_integer(), 1 * second + 5);
+
+  // agent0 has been silent for more than 2 seconds
+  receive(peers, vars, "agent1", 3 * second + 3);
+  TEST_EQ(count_peers(kb, ".peers"), (size_t)1);
+  TEST_EQ(kb.exists(".peers.agent0"), false);
+
+  receive(endpoints, vars, "host1:40000", 4 * second);
+  TEST_EQ(count_peers(kb, ".endpoints"), (size_t)1);
+  TEST_EQ(kb.exists(".endpoints.host1:40000"), true);
+}
+
+void test_scale(void)
+{
+  log("Testing peer discovery with 1000 originators\n");
+
+  const int originators = 1000;
+  const int rounds = 20;
+
+  knowledge::KnowledgeBase kb;
+  knowledge::Variables vars(&kb.get_context());
+  filters::PeerDiscovery discovery(".peers", 1, 1.0);
+
+  std::vector<std::string> names;
+  for (int i = 0; i < originators; ++i)
+  {
+    names.push_back("agent" + std::to_string(i));
+  }
+
+  // every originator sends once per 10 ms round, 1 ns apart
+  Integer time = second;
+  int64_t start = madara::utility::get_time();
+
+  for (int round = 0; round < rounds; ++round)
+  {
+    for (int i = 0; i < originators; ++i)
+    {
+      receive(discovery, vars, names[i], ++time);
+    }
+
+    time += second / 100;
+  }
+
+  int64_t elapsed = madara::utility::get_time() - start;
+
+  log("  %d messages from %d originators: %.2f us/message\n",
+      rounds * originators, originators,
+      elapsed / 1000.0 / (rounds * originators));
+
+  TEST_EQ(count_peers(kb, ".peers"), (size_t)originators);
+
+  // half the swarm goes silent for longer than the heart beat
+  time += 2 * second;
+
+  for (int i = 0; i < originators / 2; ++i)
+  {
+    receive(discovery, vars, names[i], ++time);
+  }
+
+  TEST_EQ(count_peers(kb, ".peers"), (size_t)(originators / 2));
+  TEST_EQ(kb.exists(".peers.agent0"), true);
+  TEST_EQ(kb.exists(".peers.agent999"), false);
+}
+
+int main(int, char**)
+{
+  test_peer_table();
+  test_discovery_filters();
+  test_scale();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
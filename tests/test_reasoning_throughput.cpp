@@ -92,6 +92,10 @@ uint64_t test_normal_set(
     madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations);
 uint64_t test_var_ref_set(
     madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations);
+uint64_t test_global_ref_set(
+    madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations);
+uint64_t test_many_globals_set(
+    madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations);
 uint64_t test_get_ref(
     madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations);
 uint64_t test_get_expand_ref(
@@ -300,7 +304,7 @@ int main(int argc, char* argv[])
     exit(-1);
   }
 
-  const int num_test_types = 36;
+  const int num_test_types = 38;
 
   // make everything all pretty and for-loopy
   uint64_t results[num_test_types];
@@ -328,6 +332,8 @@ int main(int argc, char* argv[])
       "KaRL: Get Expanded Reference      ",
       "KaRL: Normal Set Operation        ",
       "KaRL: Variable Reference Set      ",
+      "KaRL: Global Reference Set        ",
+      "KaRL: Many Globals Set and Send   ",
       "KaRL: Variables Inc Var Ref       ",
       "KaRL container: Assignment        ",
       "KaRL container: Increments        ",
@@ -368,6 +374,8 @@ int main(int argc, char* argv[])
     GetExpandedReference,
     NormalSet,
     VariableReferenceSet,
+    GlobalReferenceSet,
+    ManyGlobalsSet,
     VariablesIncVarRef,
     ContainerAssignment,
     ContainerIncrement,
@@ -414,6 +422,8 @@ int main(int argc, char* argv[])
   test_functions[GetVariableReference] = test_get_ref;
   test_functions[NormalSet] = test_normal_set;
   test_functions[VariableReferenceSet] = test_var_ref_set;
+  test_functions[GlobalReferenceSet] = test_global_ref_set;
+  test_functions[ManyGlobalsSet] = test_many_globals_set;
   test_functions[VariablesIncVarRef] = test_variables_inc_var_ref;
 
   test_functions[ContainerAssignment] = test_container_assignment;
@@ -1250,6 +1260,78 @@ uint64_t test_var_ref_set(
   return measured;
 }
 
+uint64_t test_global_ref_set(
+    madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations)
+{
+  knowledge.clear();
+
+  // keep track of time
+  uint64_t measured(0);
+  madara::utility::Timer<Clock> timer;
+
+  timer.start();
+
+  // globals are marked for sending on every set
+  madara::knowledge::VariableReference variable = knowledge.get_ref("var1");
+
+  for (uint32_t i = 0; i < iterations; ++i)
+  {
+    knowledge.set(variable, i);
+  }
+
+  timer.stop();
+  measured = timer.duration_ns();
+
+  print(measured, knowledge.get("var1"), iterations, "Global Reference Set: ");
+
+  return measured;
+}
+
+uint64_t test_many_globals_set(
+    madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations)
+{
+  knowledge.clear();
+
+  // an agent updating 1,000 globals between sends
+  const uint32_t num_vars = 1000;
+  std::vector<madara::knowledge::VariableReference> variables;
+  variables.reserve(num_vars);
+
+  for (uint32_t i = 0; i < num_vars; ++i)
+  {
+    variables.push_back(knowledge.get_ref("agent.state." + std::to_string(i)));
+  }
+
+  madara::knowledge::ThreadSafeContext& context = knowledge.get_context();
+  const std::map<std::string, bool> send_all;
+  size_t sent = 0;
+
+  // keep track of time
+  uint64_t measured(0);
+  madara::utility::Timer<Clock> timer;
+
+  timer.start();
+
+  for (uint32_t i = 0; i < iterations; ++i)
+  {
+    knowledge.set(variables[i % num_vars], i);
+
+    // a send takes and resets the modifieds, like a transport would
+    if (i % num_vars == num_vars - 1)
+    {
+      sent += context.get_modifieds_current(send_all, true).size();
+    }
+  }
+
+  timer.stop();
+  measured = timer.duration_ns();
+
+  print(measured, madara::knowledge::KnowledgeRecord((Integer)sent),
+      iterations, "Many Globals Set and Send: ");
+
+  return measured;
+}
+
 uint64_t test_variables_inc_var_ref(
     madara::knowledge::KnowledgeBase& knowledge, uint32_t iterations)
 {
@@ -0,0 +1,462 @@
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "madara/transport/ReceivePipeline.h"
+#include "madara/filters/BufferFilter.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/logger/GlobalLogger.h"
+#include "test.h"
+
+namespace knowledge = madara::knowledge;
+namespace transport = madara::transport;
+namespace filters = madara::filters;
+
+typedef knowledge::KnowledgeRecord KnowledgeRecord;
+typedef KnowledgeRecord::Integer Integer;
+
+/**
+ * Buffer filter that takes as long to decode as decompressing or
+ * decrypting a large message might
+ **/
+class SlowDecodeFilter : public filters::BufferFilter
+{
+public:
+  int encode(char*, int size, int) const override
+  {
+    return size;
+  }
+
+  int decode(char*, int size, int) const override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return size;
+  }
+
+  std::string get_id(void) override
+  {
+    return "slow";
+  }
+
+  uint32_t get_version(void) override
+  {
+    return 1;
+  }
+};
+
+/**
+ * Transport that only encodes messages, for feeding receivers
+ **/
+class MessageBuilder : public transport::Base
+{
+public:
+  MessageBuilder(knowledge::ThreadSafeContext& context,
+      transport::TransportSettings& settings)
+    : transport::Base("sender", settings, context)
+  {
+    setup();
+  }
+
+  long send_data(const knowledge::KnowledgeMap& updates) override
+  {
+    long size = prep_send(updates, "MessageBuilder::send_data");
+
+    if (size > 0)
+    {
+      messages.emplace_back(buffer_.get_ptr(), buffer_.get_ptr() + size);
+    }
+
+    return size;
+  }
+
+  /// the encoded messages
+  std::vector<std::vector<char>> messages;
+};
+
+/**
+ * Encodes messages that each set x to the next integer
+ **/
+std::vector<std::vector<char>> build_messages(
+    size_t count, filters::BufferFilter* filter = 0)
+{
+  knowledge::KnowledgeBase kb;
+  transport::QoSTransportSettings settings;
+  settings.set_rebroadcast_ttl(2);
+
+  if (filter)
+  {
+    settings.add_filter(filter);
+  }
+
+  MessageBuilder builder(kb.get_context(), settings);
+
+  for (size_t i = 1; i <= count; ++i)
+  {
+    knowledge::KnowledgeMap updates;
+    updates["x"] = KnowledgeRecord(Integer(i));
+    builder.send_data(updates);
+  }
+
+  return builder.messages;
+}
+
+/**
+ * Waits for a pipeline to apply a number of messages
+ **/
+bool wait_for_applied(transport::ReceivePipeline& pipeline, uint64_t count)
+{
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (pipeline.get_stats().applied >= count)
+    {
+      return true;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  return false;
+}
+
+/**
+ * Pushes messages into a pipeline
+ **/
+void push_all(transport::ReceivePipeline& pipeline,
+    const std::vector<std::vector<char>>& messages)
+{
+  for (auto& message : messages)
+  {
+    std::vector<char> buffer = pipeline.acquire();
+    std::copy(message.begin(), message.end(), buffer.begin());
+    pipeline.push(std::move(buffer), (uint32_t)message.size(), "test:1");
+  }
+}
+
+void test_ordering(void)
+{
+  log("Testing that decoded messages are applied in arrival order\n");
+
+  const size_t count = 200;
+  std::vector<std::vector<char>> messages = build_messages(count);
+
+  knowledge::KnowledgeBase kb;
+  transport::QoSTransportSettings settings;
+  settings.add_read_domain(settings.write_domain);
+  settings.enable_participant_ttl(2);
+
+  transport::BandwidthMonitor send_monitor, receive_monitor;
+  transport::ReceivePipeline pipeline(
+      "receiver", kb.get_context(), settings, send_monitor, receive_monitor);
+  pipeline.debug_to_kb(".transport");
+
+  // the rebroadcast handler runs on the apply thread once per message
+  std::vector<Integer> order;
+  pipeline.start(4,
+      [&order](transport::MessageHeader*,
+          const knowledge::KnowledgeMap& records) {
+        order.push_back(records.find("x")->second.to_integer());
+      });
+
+  push_all(pipeline, messages);
+
+  TEST_EQ(wait_for_applied(pipeline, count), true);
+
+  pipeline.stop();
+
+  bool ordered = order.size() == count;
+
+  for (size_t i = 0; ordered && i < order.size(); ++i)
+  {
+    ordered = order[i] == (Integer)(i + 1);
+  }
+
+  transport::ReceivePipelineStats stats = pipeline.get_stats();
+
+  log("  %d messages in %d batches (max batch %d, max decode queue %d, "
+      "max apply queue %d)\n",
+      (int)stats.applied, (int)stats.batches, (int)stats.max_batch,
+      (int)stats.max_decode_queue, (int)stats.max_apply_queue);
+
+  TEST_EQ(ordered, true);
+  TEST_EQ(kb.get("x").to_integer(), (Integer)count);
+  TEST_EQ(stats.received, (uint64_t)count);
+  TEST_EQ(stats.dropped, (uint64_t)0);
+  TEST_GT(stats.max_decode_queue, (uint64_t)0);
+  TEST_GT(kb.get(".transport.pipeline_batches").to_integer(), (Integer)0);
+}
+
+void test_rejects_and_drops(void)
+{
+  log("Testing rejected and dropped messages\n");
+
+  knowledge::KnowledgeBase kb;
+  transport::QoSTransportSettings settings;
+  settings.add_read_domain("other");
+
+  transport::BandwidthMonitor send_monitor, receive_monitor;
+  transport::ReceivePipeline pipeline(
+      "receiver", kb.get_context(), settings, send_monitor, receive_monitor);
+
+  std::vector<std::vector<char>> messages = build_messages(3);
+
+  // nothing is queued before the pipeline starts
+  std::vector<char> buffer = pipeline.acquire();
+  TEST_EQ(pipeline.push(std::move(buffer), 10, "test:1"), false);
+  TEST_EQ(pipeline.get_stats().dropped, (uint64_t)1);
+
+  // messages from a domain we do not read are rejected, but do not
+  // hold up the messages behind them
+  pipeline.start(2);
+  push_all(pipeline, messages);
+
+  for (int i = 0; i < 1000 && pipeline.get_stats().rejected < 3; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  TEST_EQ(pipeline.get_stats().rejected, (uint64_t)3);
+  TEST_EQ(kb.exists("x"), false);
+}
+
+/**
+ * Decodes messages for applying as one batch
+ **/
+std::vector<std::unique_ptr<transport::ReceivedUpdate>> decode_all(
+    knowledge::KnowledgeBase& kb,
+    const transport::QoSTransportSettings& settings,
+    const std::vector<std::vector<char>>& messages)
+{
+  transport::BandwidthMonitor send_monitor, receive_monitor;
+  std::vector<std::unique_ptr<transport::ReceivedUpdate>> result;
+
+  for (auto message : messages)
+  {
+    std::unique_ptr<transport::ReceivedUpdate> received(
+        new transport::ReceivedUpdate());
+
+    if (transport::decode_received_update(message.data(),
+            (uint32_t)message.size(), "receiver", kb.get_context(), settings,
+            send_monitor, receive_monitor, "decode_all", "test:1",
+            *received) > 0)
+    {
+      result.push_back(std::move(received));
+    }
+  }
+
+  return result;
+}
+
+void test_coalescing(void)
+{
+  log("Testing coalescing of stale values in a received batch\n");
+
+  const size_t count = 50;
+  std::vector<std::vector<char>> messages = build_messages(count);
+
+  transport::QoSTransportSettings settings;
+  settings.add_read_domain(settings.write_domain);
+  settings.coalesce_receives = true;
+  settings.on_data_received_logic = "++.count";
+
+  knowledge::KnowledgeBase kb;
+  std::vector<std::unique_ptr<transport::ReceivedUpdate>> received =
+      decode_all(kb, settings, messages);
+  std::vector<transport::ReceivedUpdate*> batch;
+
+  for (auto& update : received)
+  {
+    batch.push_back(update.get());
+  }
+
+  std::vector<knowledge::KnowledgeMap> rebroadcast_records;
+  size_t coalesced = 0;
+#ifndef _MADARA_NO_KARL_
+  knowledge::CompiledExpression on_data_received =
+      kb.get_context().compile(settings.on_data_received_logic);
+#endif  // _MADARA_NO_KARL_
+
+  transport::apply_received_batch(kb.get_context(), settings, batch,
+      rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+      on_data_received,
+#endif  // _MADARA_NO_KARL_
+      "test_coalescing", &coalesced);
+
+  log("  %d messages, %d stale values coalesced\n", (int)batch.size(),
+      (int)coalesced);
+
+  TEST_EQ(batch.size(), count);
+  TEST_EQ(coalesced, count - 1);
+  TEST_EQ(rebroadcast_records.size(), count);
+  TEST_EQ(kb.get("x").to_integer(), (Integer)count);
+#ifndef _MADARA_NO_KARL_
+  TEST_EQ(kb.get(".count").to_integer(), (Integer)1);
+#endif  // _MADARA_NO_KARL_
+
+  log("Testing that variables with history are not coalesced\n");
+
+  knowledge::KnowledgeBase history_kb;
+  history_kb.set_history_capacity("x", count);
+
+  received = decode_all(history_kb, settings, messages);
+  batch.clear();
+
+  for (auto& update : received)
+  {
+    batch.push_back(update.get());
+  }
+
+  coalesced = 0;
+#ifndef _MADARA_NO_KARL_
+  on_data_received =
+      history_kb.get_context().compile(settings.on_data_received_logic);
+#endif  // _MADARA_NO_KARL_
+
+  transport::apply_received_batch(history_kb.get_context(), settings, batch,
+      rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+      on_data_received,
+#endif  // _MADARA_NO_KARL_
+      "test_coalescing", &coalesced);
+
+  TEST_EQ(coalesced, (size_t)0);
+  TEST_EQ(history_kb.get("x").to_integer(), (Integer)count);
+  TEST_EQ(history_kb.get_history_size("x"), count);
+
+  log("Testing that coalescing compares quality before clocks\n");
+
+  // applied in turn, the higher quality value rejects the later, lower
+  // quality one despite its newer clock, and ties go to the later arrival
+  const struct
+  {
+    uint32_t quality;
+    uint64_t clock;
+    Integer value;
+  } mixed[] = {{2, 1, 1}, {1, 5, 2}, {2, 1, 3}};
+
+  knowledge::KnowledgeBase quality_kb;
+  received.clear();
+  batch.clear();
+
+  for (auto& update : mixed)
+  {
+    std::unique_ptr<transport::ReceivedUpdate> message(
+        new transport::ReceivedUpdate());
+    message->header = new transport::MessageHeader();
+    message->header->quality = update.quality;
+    message->header->clock = update.clock;
+
+    KnowledgeRecord record(update.value);
+    record.quality = update.quality;
+    record.clock = update.clock;
+    message->updates["x"] = record;
+
+    batch.push_back(message.get());
+    received.push_back(std::move(message));
+  }
+
+  coalesced = 0;
+#ifndef _MADARA_NO_KARL_
+  on_data_received =
+      quality_kb.get_context().compile(settings.on_data_received_logic);
+#endif  // _MADARA_NO_KARL_
+
+  transport::apply_received_batch(quality_kb.get_context(), settings, batch,
+      rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+      on_data_received,
+#endif  // _MADARA_NO_KARL_
+      "test_coalescing", &coalesced);
+
+  TEST_EQ(coalesced, (size_t)2);
+  TEST_EQ(quality_kb.get("x").to_integer(), (Integer)3);
+  TEST_EQ(quality_kb.get("x").quality, (uint32_t)2);
+}
+
+void benchmark_decode(void)
+{
+  log("Benchmarking receives with a slow buffer filter\n");
+
+  const size_t count = 100;
+  SlowDecodeFilter filter;
+  std::vector<std::vector<char>> messages = build_messages(count, &filter);
+
+  transport::QoSTransportSettings settings;
+  settings.add_read_domain(settings.write_domain);
+  settings.add_filter(&filter);
+
+  transport::BandwidthMonitor send_monitor, receive_monitor;
+
+  // each message decoded and applied in turn, as a read thread does
+  knowledge::KnowledgeBase sequential_kb;
+  knowledge::KnowledgeMap rebroadcast_records;
+#ifndef _MADARA_NO_KARL_
+  knowledge::CompiledExpression on_data_received;
+#endif  // _MADARA_NO_KARL_
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (auto message : messages)
+  {
+    transport::MessageHeader* header = 0;
+
+    transport::process_received_update(message.data(),
+        (uint32_t)message.size(), "receiver", sequential_kb.get_context(),
+        settings, send_monitor, receive_monitor, rebroadcast_records,
+#ifndef _MADARA_NO_KARL_
+        on_data_received,
+#endif  // _MADARA_NO_KARL_
+        "benchmark_decode", "test:1", header);
+
+    delete header;
+  }
+
+  double sequential_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  // the same messages through a pipeline with four decode threads
+  knowledge::KnowledgeBase pipelined_kb;
+  transport::ReceivePipeline pipeline("receiver", pipelined_kb.get_context(),
+      settings, send_monitor, receive_monitor);
+  pipeline.start(4);
+
+  start = std::chrono::steady_clock::now();
+
+  push_all(pipeline, messages);
+  wait_for_applied(pipeline, count);
+
+  double pipelined_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  pipeline.stop();
+
+  log("  %d messages: sequential %.1f ms, pipelined %.1f ms\n", (int)count,
+      sequential_ms, pipelined_ms);
+
+  TEST_EQ(sequential_kb.get("x").to_integer(), (Integer)count);
+  TEST_EQ(pipelined_kb.get("x").to_integer(), (Integer)count);
+  TEST_GT(sequential_ms, pipelined_ms);
+}
+
+int main(int, char**)
+{
+  test_ordering();
+  test_rejects_and_drops();
+  test_coalescing();
+  benchmark_decode();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
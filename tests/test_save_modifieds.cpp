@@ -154,6 +154,84 @@ int main(int, char**)
   if (references.size() != 2)
     ++madara_fails;
 
+  knowledge.clear_modifieds();
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "  Testing modifieds after deletes and partial sends...\n");
+
+  knowledge::ThreadSafeContext& context = knowledge.get_context();
+
+  knowledge.set("agent.0.x", Integer(1));
+  knowledge.set("agent.0.y", Integer(2));
+  knowledge.set("agent.1.x", Integer(3));
+  knowledge.set("agent.1.x", Integer(4));
+  knowledge.set("other", Integer(5));
+
+  references = knowledge.save_modifieds();
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "    Repeated sets are only queued once (%d): %s\n",
+      (int)references.size(), references.size() == 4 ? "SUCCESS" : "FAIL");
+
+  if (references.size() != 4)
+    ++madara_fails;
+
+  context.delete_prefix("agent.0.");
+  context.delete_variable("other");
+
+  knowledge::KnowledgeMap current = context.get_modifieds_current({}, false);
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "    Deleted variables are not sent (%d): %s\n", (int)current.size(),
+      current.size() == 1 && current["agent.1.x"].to_integer() == 4
+          ? "SUCCESS"
+          : "FAIL");
+
+  if (current.size() != 1 || current["agent.1.x"].to_integer() != 4)
+    ++madara_fails;
+
+  knowledge.set("a", Integer(1));
+  knowledge.set("b", Integer(2));
+  knowledge.set("c", Integer(3));
+
+  std::map<std::string, bool> send_list;
+  send_list["b"] = true;
+
+  current = context.get_modifieds_current(send_list, true);
+  references = knowledge.save_modifieds();
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "    Send lists only reset sent variables (%d, %d): %s\n",
+      (int)current.size(), (int)references.size(),
+      current.size() == 1 && references.size() == 3 ? "SUCCESS" : "FAIL");
+
+  if (current.size() != 1 || references.size() != 3)
+    ++madara_fails;
+
+  const knowledge::VariableReferenceMap& sorted = context.get_modifieds();
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "    Sorted modifieds (%d, first %s): %s\n", (int)sorted.size(),
+      sorted.size() > 0 ? sorted.begin()->first : "none",
+      sorted.size() == 3 && std::string(sorted.begin()->first) == "a"
+          ? "SUCCESS"
+          : "FAIL");
+
+  if (sorted.size() != 3 || std::string(sorted.begin()->first) != "a")
+    ++madara_fails;
+
+  current = context.get_modifieds_current({}, true);
+  context.add_modifieds(references);
+  context.add_modifieds(references);
+
+  madara_logger_ptr_log(logger::global_logger.get(), logger::LOG_ALWAYS,
+      "    Resent modifieds are only queued once (%d): %s\n",
+      (int)knowledge.save_modifieds().size(),
+      knowledge.save_modifieds().size() == 3 ? "SUCCESS" : "FAIL");
+
+  if (knowledge.save_modifieds().size() != 3)
+    ++madara_fails;
+
   if (madara_fails > 0)
   {
     std::cerr << "OVERALL: FAIL. " << madara_fails << " tests failed.\n";
@@ -1,5 +1,9 @@
 #include <madara/utility/SimTime.h>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "test.h"
 
@@ -7,6 +11,119 @@ using SimTime = madara::utility::SimTime;
 
 int madara_fails = 0;
 
+/**
+ * Checks that readers never see parameters from two different
+ * notifications while a writer keeps changing them
+ **/
+void test_snapshot_consistency(void)
+{
+  log("Testing sim time snapshots while notifying\n");
+
+  std::atomic<bool> done(false);
+  std::atomic<int> torn(0);
+  std::atomic<int> reads(0);
+  std::vector<std::thread> readers;
+
+  for (int t = 0; t < 3; ++t)
+  {
+    readers.emplace_back([&]() {
+      while (!done)
+      {
+        uint64_t realtime, simtime;
+        double rate;
+
+        SimTime::snapshot(realtime, simtime, rate);
+
+        // every notification sets simtime to 1000 times its rate
+        if (simtime != (uint64_t)(rate * 1000))
+        {
+          ++torn;
+        }
+
+        SimTime::time();
+        ++reads;
+      }
+    });
+  }
+
+  for (int i = 1; i <= 100000; ++i)
+  {
+    madara::utility::sim_time_notify((uint64_t)i * 1000, (double)i);
+  }
+
+  done = true;
+
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  log("  %d reads during 100000 notifications\n", reads.load());
+
+  TEST_EQ(torn.load(), 0);
+  TEST_EQ(SimTime::last_simtime(), (uint64_t)100000000);
+  TEST_EQ(SimTime::last_rate(), 100000.0);
+}
+
+/**
+ * Compares reading sim time with the previous mutex-guarded reads
+ **/
+void benchmark_time(void)
+{
+  log("Benchmarking SimTime::time from multiple threads\n");
+
+  const int calls = 1000000;
+  std::mutex mutex;
+
+  madara::utility::sim_time_notify(56000000, 0.5);
+
+  for (int threads : {1, 2, 4, 8})
+  {
+    for (int locked = 0; locked < 2; ++locked)
+    {
+      std::atomic<uint64_t> checksum(0);
+      std::vector<std::thread> workers;
+
+      int64_t start = madara::utility::get_time();
+
+      for (int t = 0; t < threads; ++t)
+      {
+        workers.emplace_back([&]() {
+          uint64_t sum = 0;
+
+          for (int i = 0; i < calls / threads; ++i)
+          {
+            if (locked)
+            {
+              std::lock_guard<std::mutex> guard(mutex);
+              sum += SimTime::time();
+            }
+            else
+            {
+              sum += SimTime::time();
+            }
+          }
+
+          checksum += sum;
+        });
+      }
+
+      for (auto& worker : workers)
+      {
+        worker.join();
+      }
+
+      int64_t elapsed = madara::utility::get_time() - start;
+
+      log("  %d threads, %s: %.1f ns/call\n", threads,
+          locked ? "mutex (previous)" : "sequence lock",
+          (double)elapsed / calls);
+
+      TEST_NE(checksum.load(), (uint64_t)0);
+    }
+  }
+}
+
 int main()
 {
   VAL(SimTime::realtime());
@@ -27,7 +144,12 @@ int main()
     madara::utility::sleep(1);
   }
 
-  // test doesn't really check anything for success or failure
+  // the above doesn't really check anything for success or failure
+
+  test_snapshot_consistency();
+  benchmark_time();
+
+  madara_fails += madara_tests_fail_count;
 
   if (madara_fails > 0)
   {
@@ -0,0 +1,273 @@
+
+#include <string>
+
+#include "madara/transport/TrafficShaper.h"
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/logger/GlobalLogger.h"
+#include "test.h"
+
+namespace knowledge = madara::knowledge;
+namespace transport = madara::transport;
+
+typedef knowledge::KnowledgeRecord KnowledgeRecord;
+typedef KnowledgeRecord::Integer Integer;
+
+const uint64_t second = 1000000000;
+
+/**
+ * Creates a string record of a given length
+ **/
+KnowledgeRecord payload(size_t length, char fill = 'x')
+{
+  return KnowledgeRecord(std::string(length, fill));
+}
+
+void test_priorities(void)
+{
+  log("Testing send priorities\n");
+
+  transport::QoSTransportSettings settings;
+
+  KnowledgeRecord record(Integer(1));
+  record.quality = 3;
+  record.write_quality = 5;
+
+  TEST_EQ(settings.get_send_priority("agent.0.x", record), (uint32_t)5);
+
+  settings.set_send_priority("agent", 1);
+  settings.set_send_priority("agent.0", 7);
+
+  TEST_EQ(settings.get_send_priority("agent.0.x", record), (uint32_t)7);
+  TEST_EQ(settings.get_send_priority("agent.1.x", record), (uint32_t)1);
+  TEST_EQ(settings.get_send_priority("other", record), (uint32_t)5);
+
+  settings.remove_send_priority("agent.0");
+
+  TEST_EQ(settings.get_send_priority("agent.0.x", record), (uint32_t)1);
+
+  transport::QoSTransportSettings copy(settings);
+
+  TEST_EQ(copy.get_send_priority("agent.0.x", record), (uint32_t)1);
+
+  copy.clear_send_priorities();
+
+  TEST_EQ(copy.get_send_priority("agent.0.x", record), (uint32_t)5);
+}
+
+void test_unlimited(void)
+{
+  log("Testing shaping without a send bandwidth limit\n");
+
+  transport::QoSTransportSettings settings;
+  transport::TrafficShaper shaper(&settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["a"] = payload(1000);
+  updates["b"] = payload(1000);
+
+  TEST_EQ(shaper.enabled(), false);
+  TEST_EQ(shaper.shape(updates, second), (size_t)0);
+  TEST_EQ(updates.size(), (size_t)2);
+  TEST_EQ(shaper.has_delayed(), false);
+}
+
+void test_delay_and_coalesce(void)
+{
+  log("Testing delays, coalescing and refills\n");
+
+  transport::QoSTransportSettings settings;
+  settings.set_send_bandwidth_limit(1000);
+  settings.set_send_bandwidth_burst(260);
+  settings.set_send_priority("bulk", 1);
+  settings.set_send_priority("status", 10);
+
+  transport::TrafficShaper shaper(&settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["bulk.0"] = payload(100);
+  updates["bulk.1"] = payload(100);
+  updates["bulk.2"] = payload(100);
+  updates["status"] = payload(10);
+
+  uint64_t now = second;
+
+  // the bucket starts full: status and one bulk update fit in 260 bytes
+  TEST_EQ(shaper.shape(updates, now), (size_t)2);
+  TEST_EQ(updates.size(), (size_t)2);
+  TEST_EQ(updates.count("status"), (size_t)1);
+  TEST_EQ(updates.count("bulk.0"), (size_t)1);
+  TEST_EQ(shaper.has_delayed(), true);
+
+  transport::TrafficShaperStats stats = shaper.get_stats();
+
+  TEST_EQ(stats.sent, (uint64_t)2);
+  TEST_EQ(stats.delayed, (uint64_t)2);
+  TEST_EQ(stats.queued, (uint64_t)2);
+
+  // a newer value of a delayed variable replaces the delayed one, and
+  // with no time passing nothing else fits
+  updates.clear();
+  updates["bulk.1"] = payload(100, 'y');
+
+  TEST_EQ(shaper.shape(updates, now), (size_t)2);
+  TEST_EQ(updates.size(), (size_t)0);
+  TEST_EQ(shaper.get_stats().coalesced, (uint64_t)1);
+
+  // after a second the bucket is full again and fits two bulk updates
+  updates.clear();
+  now += second;
+
+  TEST_EQ(shaper.shape(updates, now), (size_t)0);
+  TEST_EQ(updates.size(), (size_t)2);
+  TEST_EQ(updates["bulk.1"].to_string(), std::string(100, 'y'));
+  TEST_EQ(shaper.was_delayed("bulk.1"), true);
+  TEST_EQ(shaper.was_delayed("status"), false);
+  TEST_EQ(shaper.has_delayed(), false);
+
+  // removing the limit flushes everything
+  updates.clear();
+  updates["bulk.0"] = payload(1000);
+  updates["bulk.1"] = payload(1000);
+  now += second;
+
+  TEST_EQ(shaper.shape(updates, now), (size_t)1);
+
+  settings.set_send_bandwidth_limit(-1);
+  updates.clear();
+
+  TEST_EQ(shaper.shape(updates, now), (size_t)0);
+  TEST_EQ(updates.size(), (size_t)1);
+}
+
+void test_critical_and_bounds(void)
+{
+  log("Testing critical priorities and the delay bound\n");
+
+  transport::QoSTransportSettings settings;
+  settings.set_send_bandwidth_limit(100);
+  settings.set_critical_send_priority(10);
+  settings.set_max_delayed_sends(2);
+  settings.set_send_priority("alarm", 10);
+  settings.set_send_priority("low", 1);
+  settings.set_send_priority("mid", 5);
+
+  transport::TrafficShaper shaper(&settings);
+
+  knowledge::KnowledgeMap updates;
+  updates["alarm"] = payload(500);
+  updates["mid.0"] = payload(50);
+  updates["mid.1"] = payload(50);
+  updates["low.0"] = payload(50);
+
+  // the alarm exceeds the bucket but is sent anyway, and only two of the
+  // remaining updates may wait
+  TEST_EQ(shaper.shape(updates, second), (size_t)3);
+  TEST_EQ(updates.size(), (size_t)1);
+  TEST_EQ(updates.count("alarm"), (size_t)1);
+
+  transport::TrafficShaperStats stats = shaper.get_stats();
+
+  TEST_EQ(stats.dropped, (uint64_t)1);
+  TEST_EQ(stats.queued, (uint64_t)2);
+  TEST_EQ(stats.tokens < 0, true);
+
+  // the lowest priority update was the one dropped
+  updates.clear();
+  settings.set_send_bandwidth_limit(-1);
+  shaper.shape(updates, second);
+
+  TEST_EQ(updates.count("low.0"), (size_t)0);
+  TEST_EQ(updates.count("mid.0"), (size_t)1);
+  TEST_EQ(updates.count("mid.1"), (size_t)1);
+}
+
+void test_debug_to_kb(void)
+{
+  log("Testing shaper statistics in the knowledge base\n");
+
+  knowledge::KnowledgeBase kb;
+
+  transport::QoSTransportSettings settings;
+  settings.set_send_bandwidth_limit(100);
+
+  transport::TrafficShaper shaper(&settings);
+  shaper.debug_to_kb(kb.get_context(), ".transport");
+
+  knowledge::KnowledgeMap updates;
+  updates["a"] = payload(80);
+  updates["b"] = payload(80);
+
+  shaper.shape(updates, second);
+
+  TEST_EQ(kb.get(".transport.shaper_sent").to_integer(), (Integer)1);
+  TEST_EQ(kb.get(".transport.shaper_delayed").to_integer(), (Integer)1);
+  TEST_EQ(kb.get(".transport.shaper_queued").to_integer(), (Integer)1);
+}
+
+void test_radio_link(void)
+{
+  log("Simulating a constrained link with bulky and critical updates\n");
+
+  // a 2 KB/s link, an agent publishing a 1 KB image at 10 Hz and a
+  // small critical heartbeat, which dropped along with images before
+  transport::QoSTransportSettings settings;
+  settings.set_send_bandwidth_limit(2000);
+  settings.set_send_priority("agent.0.heartbeat", 10);
+  settings.set_critical_send_priority(10);
+
+  transport::TrafficShaper shaper(&settings);
+
+  size_t heartbeats = 0, images = 0, bytes = 0;
+  const size_t sends = 100;
+
+  for (size_t i = 0; i < sends; ++i)
+  {
+    knowledge::KnowledgeMap updates;
+    updates["agent.0.heartbeat"] = KnowledgeRecord(Integer(i));
+    updates["agent.0.image"] = payload(1000);
+
+    shaper.shape(updates, second + i * second / 10);
+
+    heartbeats += updates.count("agent.0.heartbeat");
+    images += updates.count("agent.0.image");
+
+    if (updates.count("agent.0.image"))
+    {
+      bytes += updates["agent.0.image"].get_encoded_size("agent.0.image");
+    }
+  }
+
+  transport::TrafficShaperStats stats = shaper.get_stats();
+
+  log("  %d sends over 10s: %d heartbeats, %d images (%d bytes), "
+      "%d coalesced\n",
+      (int)sends, (int)heartbeats, (int)images, (int)bytes,
+      (int)stats.coalesced);
+
+  TEST_EQ(heartbeats, sends);
+  TEST_GT(images, (size_t)0);
+  TEST_EQ(bytes <= 2000 * 11, true);
+  TEST_GT(stats.coalesced, (uint64_t)0);
+}
+
+int main(int, char**)
+{
+  test_priorities();
+  test_unlimited();
+  test_delay_and_coalesce();
+  test_critical_and_bounds();
+  test_debug_to_kb();
+  test_radio_link();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
@@ -0,0 +1,612 @@
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+#include "madara/knowledge/KnowledgeBase.h"
+#include "madara/knowledge/containers/DoubleVector.h"
+#include "madara/knowledge/containers/NativeDoubleVector.h"
+#include "madara/knowledge/containers/NativeIntegerVector.h"
+#include "madara/transport/Transport.h"
+#include "madara/utility/Timer.h"
+#include "madara/logger/GlobalLogger.h"
+
+#include "test.h"
+
+/**
+ * Tests and benchmarks the two vector storage modes: one variable per
+ * element (DoubleVector) versus one contiguous array record with dirty
+ * range tracking and delta encoding (NativeDoubleVector).
+ *
+ * usage: test_vector_storage [-n elements] [-c changes] [-r rounds]
+ **/
+
+namespace knowledge = madara::knowledge;
+namespace containers = knowledge::containers;
+namespace transport = madara::transport;
+
+typedef std::chrono::steady_clock Clock;
+
+size_t num_elements = 10000;
+size_t num_changes = 16;
+size_t num_rounds = 100;
+
+/**
+ * A transport that encodes updates exactly as a network transport would
+ * and then decodes them into another context, without any sockets
+ **/
+class LoopbackTransport : public transport::Base
+{
+public:
+  LoopbackTransport(transport::TransportSettings& settings,
+      knowledge::KnowledgeBase& source, knowledge::KnowledgeBase& target)
+    : transport::Base("loopback", settings, source.get_context()),
+      target_(target.get_context())
+  {
+    setup();
+  }
+
+  long send_data(const knowledge::KnowledgeMap& updates) override
+  {
+    long size = prep_send(updates, "LoopbackTransport::send_data");
+
+    if (size > 0 && hold)
+    {
+      held.emplace_back(buffer_.get_ptr(), buffer_.get_ptr() + size);
+    }
+    else if (size > 0 && !drop)
+    {
+      bytes_sent += size;
+      ++messages_sent;
+
+      knowledge::KnowledgeMap rebroadcasts;
+      transport::MessageHeader* header = 0;
+
+#ifndef _MADARA_NO_KARL_
+      knowledge::CompiledExpression on_data_received;
+#endif
+
+      transport::process_received_update(buffer_.get_ptr(), (uint32_t)size,
+          "receiver", target_, settings_, send_monitor_, receive_monitor_,
+          rebroadcasts,
+#ifndef _MADARA_NO_KARL_
+          on_data_received,
+#endif
+          "LoopbackTransport::send_data", "loopback", header);
+
+      delete header;
+    }
+
+    return size;
+  }
+
+  /**
+   * Decodes every held message before applying any of them, as the
+   * decode threads of a receive pipeline may, and then applies them
+   **/
+  void release(void)
+  {
+    std::vector<std::unique_ptr<transport::ReceivedUpdate>> received;
+    std::vector<transport::ReceivedUpdate*> batch;
+
+    for (auto& message : held)
+    {
+      std::unique_ptr<transport::ReceivedUpdate> update(
+          new transport::ReceivedUpdate());
+
+      if (transport::decode_received_update(message.data(),
+              (uint32_t)message.size(), "receiver", target_, settings_,
+              send_monitor_, receive_monitor_, "LoopbackTransport::release",
+              "loopback", *update) > 0)
+      {
+        batch.push_back(update.get());
+        received.push_back(std::move(update));
+      }
+    }
+
+    std::vector<knowledge::KnowledgeMap> rebroadcasts;
+
+#ifndef _MADARA_NO_KARL_
+    knowledge::CompiledExpression on_data_received;
+#endif
+
+    transport::apply_received_batch(target_, settings_, batch, rebroadcasts,
+#ifndef _MADARA_NO_KARL_
+        on_data_received,
+#endif
+        "LoopbackTransport::release");
+
+    held.clear();
+  }
+
+  /// total bytes encoded
+  uint64_t bytes_sent = 0;
+
+  /// total messages encoded
+  uint64_t messages_sent = 0;
+
+  /// if true, messages are encoded but lost, as on a lossy network
+  bool drop = false;
+
+  /// if true, messages are held until release
+  bool hold = false;
+
+  /// the encoded messages that are held
+  std::vector<std::vector<char>> held;
+
+private:
+  knowledge::ThreadSafeContext& target_;
+};
+
+void test_dirty_ranges(void)
+{
+  std::cerr << "\n*************TEST DIRTY RANGES*************\n";
+
+  knowledge::DirtyRanges ranges;
+
+  ranges.add(10, 5);
+  ranges.add(15, 1);
+  ranges.add(2);
+  ranges.add(12, 2);
+
+  TEST_EQ(ranges.ranges().size(), (size_t)2);
+  TEST_EQ(ranges.count(), (size_t)7);
+  TEST_EQ(ranges.end(), (size_t)16);
+
+  ranges.add(3, 7);
+
+  TEST_EQ(ranges.ranges().size(), (size_t)1);
+  TEST_EQ(ranges.count(), (size_t)14);
+
+  ranges.clear();
+
+  for (size_t i = 0; i < knowledge::DirtyRanges::max_ranges * 4; ++i)
+  {
+    ranges.add(i * 10);
+  }
+
+  TEST_EQ(ranges.ranges().size(), knowledge::DirtyRanges::max_ranges);
+  TEST_EQ(ranges.end(), knowledge::DirtyRanges::max_ranges * 40 - 9);
+}
+
+void test_context_ranges(void)
+{
+  std::cerr << "\n*************TEST CONTEXT RANGES*************\n";
+
+  knowledge::KnowledgeBase kb;
+  knowledge::ThreadSafeContext& context = kb.get_context();
+  std::map<std::string, bool> send_all;
+
+  containers::NativeDoubleVector doubles("doubles", kb, 100);
+  containers::NativeIntegerVector integers("integers", kb, 100);
+
+  context.get_modifieds_current(send_all);
+
+  doubles.set(5, 1.5);
+  doubles.set(6, 2.5);
+  doubles.modify(50);
+  integers.set(99, 7);
+
+  auto modifieds = context.get_modifieds_current(send_all);
+  auto sent = context.share_sent_ranges();
+
+  TEST_EQ(modifieds.size(), (size_t)2);
+  TEST_NE(sent.get(), (void*)0);
+
+  if (sent)
+  {
+    TEST_EQ(sent->count("doubles"), (size_t)1);
+    TEST_EQ(sent->count("integers"), (size_t)1);
+
+    if (sent->count("doubles") == 1)
+    {
+      const knowledge::DirtyRanges& ranges = sent->at("doubles");
+      TEST_EQ(ranges.ranges().size(), (size_t)2);
+      TEST_EQ(ranges.count(), (size_t)3);
+      TEST_EQ(ranges.toi, modifieds["doubles"].toi());
+    }
+  }
+
+  // a whole-record change after a ranged change disables the delta
+  doubles.set(1, 1.0);
+  doubles.modify();
+  integers.set(0, 1);
+  kb.set("integers", std::vector<knowledge::KnowledgeRecord::Integer>(100, 2));
+
+  // so does a resize
+  doubles.set(2, 2.0);
+  doubles.resize(200);
+
+  modifieds = context.get_modifieds_current(send_all);
+  sent = context.share_sent_ranges();
+
+  TEST_EQ(modifieds.size(), (size_t)2);
+  TEST_EQ(sent.get(), (void*)0);
+
+  // locals are never sent, so their ranges are never tracked
+  containers::NativeDoubleVector local(".local", kb, 10);
+  local.set(1, 1.0);
+
+  context.get_modifieds_current(send_all);
+  TEST_EQ(context.share_sent_ranges().get(), (void*)0);
+}
+
+void test_delta_encoding(void)
+{
+  std::cerr << "\n*************TEST DELTA ENCODING*************\n";
+
+  knowledge::KnowledgeBase source, target;
+
+  std::vector<double> initial(1000);
+  for (size_t i = 0; i < initial.size(); ++i)
+    initial[i] = (double)i;
+
+  source.set("array", initial);
+  target.set("array", initial);
+
+  knowledge::KnowledgeRecord record(source.get("array"));
+  record.set_index(10, 100.0);
+  record.set_index(11, 110.0);
+  record.set_index(900, 9000.0);
+
+  knowledge::DirtyRanges ranges;
+  ranges.add(10, 2);
+  ranges.add(900);
+
+  std::vector<char> buffer(record.get_encoded_delta_size("array", ranges));
+  int64_t buffer_remaining = (int64_t)buffer.size();
+
+  // the target holds the array at the clock of the source's last send
+  uint64_t base_clock = target.get("array").clock;
+
+  char* end = record.write_delta(
+      buffer.data(), "array", ranges, base_clock, buffer_remaining);
+
+  TEST_EQ(buffer_remaining, (int64_t)0);
+  TEST_EQ(end, buffer.data() + buffer.size());
+  TEST_LT(buffer.size() * 10, (size_t)record.get_encoded_size("array"));
+
+  // decode against the target's copy of the array
+  std::string key;
+  knowledge::KnowledgeRecord decoded;
+  buffer_remaining = (int64_t)buffer.size();
+
+  const char* read_end = decoded.read(
+      buffer.data(), key, buffer_remaining, target.get_context());
+
+  TEST_EQ(key, "array");
+  TEST_EQ(buffer_remaining, (int64_t)0);
+  TEST_EQ(read_end, (const char*)buffer.data() + buffer.size());
+  TEST_EQ(decoded.type(), (uint32_t)knowledge::KnowledgeRecord::DOUBLE_ARRAY);
+  TEST_EQ(decoded.to_doubles() == record.to_doubles(), true);
+  TEST_EQ(decoded.toi(), record.toi());
+
+  // a delta cannot be applied to another version of the array
+  target.get_context().set_clock("array", base_clock + 1);
+  buffer_remaining = (int64_t)buffer.size();
+  decoded.read(buffer.data(), key, buffer_remaining, target.get_context());
+
+  TEST_EQ(buffer_remaining, (int64_t)0);
+  TEST_EQ(decoded.exists(), false);
+
+  // a delta cannot be applied to an array of a different size
+  target.set("array", std::vector<double>(10));
+  buffer_remaining = (int64_t)buffer.size();
+  decoded.read(buffer.data(), key, buffer_remaining, target.get_context());
+
+  TEST_EQ(buffer_remaining, (int64_t)0);
+  TEST_EQ(decoded.exists(), false);
+
+  // truncated deltas are rejected
+  buffer_remaining = (int64_t)buffer.size() - 1;
+  decoded.read(buffer.data(), key, buffer_remaining, target.get_context());
+  TEST_LT(buffer_remaining, (int64_t)0);
+
+  // whole records still decode through the context-aware read
+  buffer.resize(record.get_encoded_size("array"));
+  buffer_remaining = (int64_t)buffer.size();
+  record.write(buffer.data(), "array", buffer_remaining);
+  buffer_remaining = (int64_t)buffer.size();
+  decoded.read(buffer.data(), key, buffer_remaining, target.get_context());
+
+  TEST_EQ(buffer_remaining, (int64_t)0);
+  TEST_EQ(decoded.to_doubles() == record.to_doubles(), true);
+}
+
+void test_transport_deltas(void)
+{
+  std::cerr << "\n*************TEST TRANSPORT DELTAS*************\n";
+
+  knowledge::KnowledgeBase source, target;
+  transport::TransportSettings settings;
+  settings.send_array_deltas = true;
+  settings.array_delta_keyframe_interval = 4;
+
+  LoopbackTransport* loopback =
+      new LoopbackTransport(settings, source, target);
+  source.attach_transport(loopback);
+
+  containers::NativeDoubleVector vector("vector", source, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+    vector.set(i, (double)i);
+
+  // first send is whole, since the vector was resized
+  source.send_modifieds();
+  uint64_t full_bytes = loopback->bytes_sent;
+
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+
+  vector.set(3, -3.0);
+  vector.set(700, -700.0);
+  source.send_modifieds();
+
+  uint64_t delta_bytes = loopback->bytes_sent - full_bytes;
+
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+  TEST_LT(delta_bytes * 10, full_bytes);
+
+  // receivers with a stale base drop deltas and wait for a whole update
+  target.set("vector", std::vector<double>(5));
+  vector.set(4, -4.0);
+  source.send_modifieds();
+
+  TEST_EQ(target.get("vector").size(), (uint32_t)5);
+
+  vector.modify();
+  source.send_modifieds();
+
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+
+  // after a lost message, deltas against the lost version are dropped
+  loopback->drop = true;
+  vector.set(5, -5.0);
+  source.send_modifieds();
+  loopback->drop = false;
+
+  vector.set(6, -6.0);
+  source.send_modifieds();
+  vector.set(7, -7.0);
+  source.send_modifieds();
+
+  TEST_EQ(target.get("vector").retrieve_index(5).to_double(), 5.0);
+  TEST_EQ(target.get("vector").retrieve_index(6).to_double(), 6.0);
+  TEST_EQ(target.get("vector").retrieve_index(7).to_double(), 7.0);
+
+  // until the next keyframe resynchronizes the receiver
+  uint64_t before_keyframe = loopback->bytes_sent;
+  vector.set(8, -8.0);
+  source.send_modifieds();
+
+  TEST_GT(loopback->bytes_sent - before_keyframe, full_bytes / 2);
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+
+  // a delta decoded before the message of its base is applied still
+  // patches that base, since deltas are resolved in arrival order
+  loopback->hold = true;
+  vector.set(9, -9.0);
+  source.send_modifieds();
+  vector.set(10, -10.0);
+  source.send_modifieds();
+  loopback->hold = false;
+
+  TEST_EQ(loopback->held.size(), (size_t)2);
+
+  loopback->release();
+
+  TEST_EQ(target.get("vector").retrieve_index(9).to_double(), -9.0);
+  TEST_EQ(target.get("vector").retrieve_index(10).to_double(), -10.0);
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+}
+
+/// if true, blocking_filter drops every received update
+bool block_receives = false;
+
+/**
+ * Aggregate receive filter that drops every update while block_receives
+ * is set, as a whitelist that rejects a sender would
+ **/
+void blocking_filter(knowledge::KnowledgeMap& records,
+    const transport::TransportContext&, knowledge::Variables&)
+{
+  if (block_receives)
+  {
+    records.clear();
+  }
+}
+
+void test_aggregate_filtered_deltas(void)
+{
+  std::cerr << "\n*************TEST AGGREGATE FILTERED DELTAS*************\n";
+
+  knowledge::KnowledgeBase source, target;
+  transport::QoSTransportSettings settings;
+  settings.send_array_deltas = true;
+  settings.add_receive_filter(blocking_filter);
+
+  LoopbackTransport* loopback =
+      new LoopbackTransport(settings, source, target);
+  source.attach_transport(loopback);
+
+  containers::NativeDoubleVector vector("vector", source, 100);
+  for (size_t i = 0; i < 100; ++i)
+    vector.set(i, (double)i);
+
+  source.send_modifieds();
+
+  // deltas pass the aggregate receive filters once they are patched
+  vector.set(2, -2.0);
+  source.send_modifieds();
+
+  TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+
+  // and are dropped by them, as whole arrays are
+  block_receives = true;
+  vector.set(3, -3.0);
+  source.send_modifieds();
+
+  TEST_EQ(target.get("vector").retrieve_index(3).to_double(), 3.0);
+
+  // resynchronize the receiver and drop a delta applied in a batch
+  block_receives = false;
+  vector.modify();
+  source.send_modifieds();
+  block_receives = true;
+
+  loopback->hold = true;
+  vector.set(4, -4.0);
+  source.send_modifieds();
+  loopback->hold = false;
+  loopback->release();
+
+  TEST_EQ(target.get("vector").retrieve_index(4).to_double(), 4.0);
+
+  block_receives = false;
+}
+
+/**
+ * Runs rounds of changing a few elements and sending them, returning
+ * the average time and bytes per round
+ **/
+template<typename Vector>
+void benchmark(const char* name, Vector& vector, knowledge::KnowledgeBase& kb,
+    LoopbackTransport& loopback)
+{
+  madara::utility::Timer<Clock> timer;
+
+  // start from a fully synchronized vector
+  kb.send_modifieds();
+  uint64_t start_bytes = loopback.bytes_sent;
+
+  timer.start();
+
+  for (size_t round = 0; round < num_rounds; ++round)
+  {
+    // half the changes are contiguous, half are scattered
+    for (size_t i = 0; i < num_changes; ++i)
+    {
+      size_t index = i < num_changes / 2 ?
+                         (round * 7 + i) % num_elements :
+                         (round * 7919 + i * 104729) % num_elements;
+
+      vector.set(index, (double)(round + i));
+    }
+
+    kb.send_modifieds();
+  }
+
+  timer.stop();
+
+  uint64_t bytes = loopback.bytes_sent - start_bytes;
+
+  std::cerr << std::setw(28) << std::left << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(2)
+            << timer.duration_ns() / 1000.0 / num_rounds << " us/round"
+            << std::setw(12) << bytes / num_rounds << " B/round\n";
+}
+
+void benchmark_storage_modes(void)
+{
+  std::cerr << "\n*************BENCHMARK STORAGE MODES*************\n";
+  std::cerr << num_elements << " elements, " << num_changes
+            << " changes per round, " << num_rounds << " rounds\n\n";
+
+  {
+    knowledge::KnowledgeBase source, target;
+    transport::TransportSettings settings;
+    LoopbackTransport* loopback =
+        new LoopbackTransport(settings, source, target);
+    source.attach_transport(loopback);
+
+    containers::DoubleVector vector("vector", source, (int)num_elements);
+    benchmark("DoubleVector (per element)", vector, source, *loopback);
+
+    TEST_EQ(target.get("vector.5").to_double(), vector[5]);
+  }
+
+  {
+    knowledge::KnowledgeBase source, target;
+    transport::TransportSettings settings;
+    LoopbackTransport* loopback =
+        new LoopbackTransport(settings, source, target);
+    source.attach_transport(loopback);
+
+    containers::NativeDoubleVector vector(
+        "vector", source, (int)num_elements);
+    benchmark("NativeDoubleVector (whole)", vector, source, *loopback);
+
+    TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+  }
+
+  {
+    knowledge::KnowledgeBase source, target;
+    transport::TransportSettings settings;
+    settings.send_array_deltas = true;
+    LoopbackTransport* loopback =
+        new LoopbackTransport(settings, source, target);
+    source.attach_transport(loopback);
+
+    containers::NativeDoubleVector vector(
+        "vector", source, (int)num_elements);
+    benchmark("NativeDoubleVector (delta)", vector, source, *loopback);
+
+    TEST_EQ(target.get("vector").to_doubles() == vector.to_doubles(), true);
+  }
+}
+
+void handle_arguments(int argc, char** argv)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg1(argv[i]);
+
+    if (i + 1 < argc && arg1 == "-n")
+    {
+      num_elements = std::stoul(argv[++i]);
+    }
+    else if (i + 1 < argc && arg1 == "-c")
+    {
+      num_changes = std::stoul(argv[++i]);
+    }
+    else if (i + 1 < argc && arg1 == "-r")
+    {
+      num_rounds = std::stoul(argv[++i]);
+    }
+    else
+    {
+      std::cerr << "\nProgram summary for " << argv[0] << ":\n\n"
+                   "  Tests and benchmarks per-element and contiguous\n"
+                   "  vector storage.\n\n"
+                   " [-n elements]    number of vector elements\n"
+                   " [-c changes]     elements changed per round\n"
+                   " [-r rounds]      number of change/send rounds\n\n";
+      exit(0);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  handle_arguments(argc, argv);
+
+  test_dirty_ranges();
+  test_context_ranges();
+  test_delta_encoding();
+  test_transport_deltas();
+  test_aggregate_filtered_deltas();
+  benchmark_storage_modes();
+
+  if (madara_tests_fail_count > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_tests_fail_count
+              << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
+
+  return madara_tests_fail_count;
+}
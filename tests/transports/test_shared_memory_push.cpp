@@ -1,4 +1,6 @@
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 #include "madara/transport/SharedMemoryPush.h"
 #include "madara/knowledge/Hive.h"
 #include "madara/utility/Utility.h"
@@ -6,6 +8,7 @@
 namespace knowledge = madara::knowledge;
 namespace transport = madara::transport;
 namespace logger = madara::logger;
+namespace utility = madara::utility;
 
 int madara_fails = 0;
 
@@ -87,6 +90,207 @@ void test_hive(void)
 
 }
 
+void set_position(knowledge::KnowledgeBase& kb, size_t agent)
+{
+  std::string prefix = "agent." + std::to_string(agent);
+
+  kb.set(prefix + ".step",
+    kb.get(prefix + ".step").to_integer() + 1);
+}
+
+void test_stepped_hive(void)
+{
+  knowledge::Hive hive(knowledge::Hive::STEPPED, 4);
+  hive.resize(10);
+
+  hive.step(set_position);
+  hive.step(set_position);
+
+  std::vector<knowledge::KnowledgeBase>& kbs = hive.get_kbs();
+
+  std::cerr << "SteppedHive: Test 1: all agents see agent.9.step == 2: ";
+
+  bool seen = true;
+  for (auto kb : kbs)
+  {
+    seen = seen && kb.get("agent.9.step").to_integer() == 2 &&
+      kb.get("agent.0.step").to_integer() == 2;
+  }
+
+  if (seen && hive.get_steps() == 2 && hive.get_threads() == 4)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+  }
+
+  std::cerr << "SteppedHive: Test 2: update log holds each agent's update: ";
+
+  auto updates = hive.get_last_updates();
+
+  if (updates && updates->size() == 10 && (*updates)[3].size() == 1 &&
+      (*updates)[3].begin()->first == "agent.3.step")
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+  }
+
+  // a ring: each agent hears only from the agents beside it
+  for (size_t i = 0; i < kbs.size(); ++i)
+  {
+    hive.set_neighbors(i,
+      {(i + kbs.size() - 1) % kbs.size(), (i + 1) % kbs.size()});
+  }
+
+  hive.step(set_position);
+
+  std::cerr << "SteppedHive: Test 3: neighborhoods limit fan-out: ";
+
+  if (kbs[0].get("agent.1.step").to_integer() == 3 &&
+      kbs[0].get("agent.9.step").to_integer() == 3 &&
+      kbs[0].get("agent.5.step").to_integer() == 2)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+    kbs[0].print();
+  }
+
+  std::cerr << "SteppedHive: Test 4: agent exceptions reach the caller: ";
+
+  bool thrown = false;
+
+  try
+  {
+    hive.step([](knowledge::KnowledgeBase& kb, size_t agent) {
+      if (agent == 7)
+      {
+        throw std::runtime_error("agent 7 failed");
+      }
+
+      set_position(kb, agent);
+    });
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+
+  if (thrown)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+  }
+
+  std::cerr << "SteppedHive: Test 5: updates of a failed step still apply: ";
+
+  // agent 1 hears from agent 0, whose update was taken before agent 7
+  // threw
+  if (kbs[1].get("agent.0.step").to_integer() == 4 &&
+      kbs[8].get("agent.9.step").to_integer() == 4 &&
+      hive.get_steps() == 4)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+    kbs[1].print();
+  }
+
+  std::cerr << "SteppedHive: Test 6: logged arrays keep their values: ";
+
+  const std::vector<knowledge::KnowledgeRecord::Integer> ones(4, 1);
+
+  hive.step([&ones](knowledge::KnowledgeBase& kb, size_t agent) {
+    kb.set("agent." + std::to_string(agent) + ".path", ones);
+  });
+
+  auto logged = hive.get_last_updates();
+
+  // changing an array in place must not change the logged copy of it,
+  // which the other agents share
+  hive.step([](knowledge::KnowledgeBase& kb, size_t agent) {
+    kb.set_index("agent." + std::to_string(agent) + ".path", 0,
+      (knowledge::KnowledgeRecord::Integer)2);
+  });
+
+  if (logged && (*logged)[0].at("agent.0.path").to_integers() == ones &&
+      kbs[1].get("agent.0.path").retrieve_index(0).to_integer() == 2 &&
+      kbs[1].get("agent.0.path").retrieve_index(1).to_integer() == 1)
+  {
+    std::cerr << "SUCCESS\n";
+  }
+  else
+  {
+    std::cerr << "FAIL\n";
+    madara_fails++;
+    kbs[1].print();
+  }
+}
+
+void benchmark_hive(void)
+{
+  std::cerr << "Hive: steps/sec by agents (push, stepped with 1 and " <<
+    std::thread::hardware_concurrency() << " threads, stepped with 8 " <<
+    "neighbors):\n";
+
+  for (size_t agents : {50, 100, 250, 500})
+  {
+    const int steps = 5;
+    double rates[4];
+
+    for (int mode = 0; mode < 4; ++mode)
+    {
+      knowledge::Hive hive(
+        mode == 0 ? knowledge::Hive::PUSH : knowledge::Hive::STEPPED,
+        mode == 1 ? 1 : 0);
+      hive.resize(agents);
+
+      if (mode == 3)
+      {
+        for (size_t i = 0; i < agents; ++i)
+        {
+          std::vector<size_t> neighbors;
+          for (size_t j = 1; j <= 4; ++j)
+          {
+            neighbors.push_back((i + j) % agents);
+            neighbors.push_back((i + agents - j) % agents);
+          }
+          hive.set_neighbors(i, neighbors);
+        }
+      }
+
+      int64_t start = utility::get_time();
+      for (int step = 0; step < steps; ++step)
+      {
+        hive.step(set_position);
+      }
+      int64_t elapsed = utility::get_time() - start;
+
+      rates[mode] = steps * 1000000000.0 / (elapsed > 0 ? elapsed : 1);
+    }
+
+    std::cerr << "  " << agents << " agents: " << rates[0] << ", " <<
+      rates[1] << ", " << rates[2] << ", " << rates[3] << "\n";
+  }
+}
+
 int main(int, char**)
 {
   transport::QoSTransportSettings settings;
@@ -181,6 +385,17 @@ int main(int, char**)
   }
 
   test_hive();
+  test_stepped_hive();
+  benchmark_hive();
+
+  if (madara_fails > 0)
+  {
+    std::cerr << "OVERALL: FAIL. " << madara_fails << " tests failed.\n";
+  }
+  else
+  {
+    std::cerr << "OVERALL: SUCCESS.\n";
+  }
 
   return madara_fails;
 }
\ No newline at end of file
@@ -47,6 +47,10 @@ bool print_stats = false;
 std::vector<std::string> print_prefixes;
 std::string save_file;
 
+// compaction of the STK into keyframes
+std::string compact_file;
+uint64_t keyframe_interval = 10;
+
 bool summary = true;
 
 // default KaRL config file
@@ -620,6 +624,20 @@ void handle_arguments(int argc, const char** argv, size_t recursion_limit = 10)
       }
       ++i;
     }
+    else if(arg1 == "-co" || arg1 == "--compact")
+    {
+      if(i + 1 < argc)
+      {
+        compact_file = argv[i + 1];
+
+        if(debug)
+        {
+          std::cout << "  Compacting into " << argv[i + 1] << "\n";
+        }
+      }
+
+      ++i;
+    }
     else if(arg1 == "-f" || arg1 == "--logfile")
     {
       if(i + 1 < argc)
@@ -677,6 +695,27 @@ void handle_arguments(int argc, const char** argv, size_t recursion_limit = 10)
 
       ++i;
     }
+    else if(arg1 == "-ki" || arg1 == "--keyframe-interval")
+    {
+      if(i + 1 < argc)
+      {
+        std::stringstream buffer(argv[i + 1]);
+        buffer >> keyframe_interval;
+
+        if(keyframe_interval == 0)
+        {
+          keyframe_interval = 1;
+        }
+
+        if(debug)
+        {
+          std::cout << "  Setting keyframe interval to " <<
+            keyframe_interval << "\n";
+        }
+      }
+
+      ++i;
+    }
     else if(arg1 == "-ks" || arg1 == "--print-stats")
     {
       print_stats = true;
@@ -815,6 +854,9 @@ void handle_arguments(int argc, const char** argv, size_t recursion_limit = 10)
           "                             {var}.updates: total num updates\n"
           "  [-chf|--check-file file] KaRL file with check. See -c for "
           "options\n"
+          "  [-co|--compact file]     rewrite the STK into file as keyframes,\n"
+          "                           one per --keyframe-interval states of\n"
+          "                           the STK plus the final state\n"
           "  [-cf|--config-file]      Config file full path, file contains "
           "cmd line\n"
           "                           flags, also uses default config file\n"
@@ -828,6 +870,9 @@ void handle_arguments(int argc, const char** argv, size_t recursion_limit = 10)
           "                           new-line delimited prefix list that "
           "can be read\n"
           "                           by NamedVectorCombinator.\n"
+          "  [-ki|--keyframe-interval states] number of STK states merged\n"
+          "                           into each keyframe by --compact.\n"
+          "                           Default is 10.\n"
           "  [-ks|--print-stats]      print stats knowledge base contents\n"
           "  [-l|--level level]       the logger level(0+, higher is higher "
           "detail)\n"
@@ -1085,6 +1130,86 @@ void iterate_stk(
   stats_ooo =(int64_t)out_of_orders;
 }
 
+/**
+ * Replays the STK and rewrites it as keyframes, each holding the full
+ * knowledge as of every keyframe_interval-th state (and the last state).
+ * The result loads and seeks without replaying long delta chains.
+ **/
+void compact_stk(void)
+{
+  knowledge::CheckpointSettings settings(load_checkpoint_settings);
+  knowledge::CheckpointReader reader(settings);
+
+  reader.start();
+
+  if(!reader.is_open())
+  {
+    std::cout << "Unable to compact " << settings.filename << "\n";
+    return;
+  }
+
+  knowledge::KnowledgeBase kb;
+  knowledge::ThreadSafeContext& context = kb.get_context();
+
+  knowledge::CheckpointSettings save_settings;
+  save_settings.filename = compact_file;
+  save_settings.buffer_size = settings.buffer_size;
+  save_settings.max_buffer_size = settings.max_buffer_size;
+  save_settings.originator = settings.originator;
+  save_settings.override_timestamp = true;
+  save_settings.initial_timestamp = settings.initial_timestamp;
+  save_settings.last_timestamp = settings.last_timestamp;
+  save_settings.keyframe_interval = 1;
+
+  // keyframes are appended, so start from an empty file
+  std::remove(compact_file.c_str());
+
+  // the reader skips states without records, so count states by index
+  const knowledge::FileHeader* meta = reader.get_file_header();
+  uint64_t end = settings.last_state < meta->states ?
+    settings.last_state + 1 : meta->states;
+
+  uint64_t state = settings.initial_state;
+  uint64_t states = 0;
+  uint64_t keyframes = 0;
+
+  // completes the states before next. States without records change
+  // nothing, but still count toward the keyframe spacing
+  const auto complete = [&](uint64_t next, bool last)
+  {
+    for(; state < next; ++state)
+    {
+      ++states;
+
+      if(states % keyframe_interval == 0 || (last && state + 1 == next))
+      {
+        kb.save_checkpoint(save_settings);
+        ++keyframes;
+      }
+    }
+  };
+
+  for(;;)
+  {
+    auto cur = reader.next();
+
+    if(cur.first == "")
+    {
+      complete(end, true);
+      break;
+    }
+
+    complete(reader.get_state(), false);
+
+    cur.second.clock = context.get_clock();
+    context.update_record_from_external(
+      cur.first, cur.second, knowledge::EvalSettings::DELAY_NO_EXPAND);
+  }
+
+  std::cout << "Compacted " << states << " states into " << keyframes <<
+    " keyframes in " << compact_file << "\n";
+}
+
 void create_events(void)
 {
   std::vector<std::string> batch_lines = utility::string_to_vector(
@@ -1142,6 +1267,11 @@ int main(int argc, char** argv)
   create_events();
   iterate_stk(kb, stats, variables);
 
+  if(compact_file != "")
+  {
+    compact_stk();
+  }
+
   if(print_stats || summary || checkfile != "" || check != "")
   {
     if(save_file != "")